@@ -39,6 +39,13 @@
 #include <cmath>
 #include <cstring>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__AVX__)
+#include <immintrin.h>
+#endif
+
 #define GVX_NO_PROF
 #include "rutz/trace.h"
 #include "rutz/debug.h"
@@ -49,18 +56,116 @@ using geom::vec3d;
 
 namespace
 {
+  // Thin wrappers so that the batch kernels below can be written once
+  // for whichever vector width the compiler is targeting: four
+  // doubles per register with AVX, two with SSE2 (which every x86-64
+  // has).
+#if defined(__AVX__)
+  typedef __m256d vd;
+  const size_t VW = 4;
+  inline vd vload(const double* p)     { return _mm256_loadu_pd(p); }
+  inline void vstore(double* p, vd v)  { _mm256_storeu_pd(p, v); }
+  inline vd vset1(double d)            { return _mm256_set1_pd(d); }
+  inline vd vadd(vd a, vd b)           { return _mm256_add_pd(a, b); }
+  inline vd vmul(vd a, vd b)           { return _mm256_mul_pd(a, b); }
+  inline vd vnonzero(vd w)
+  { return _mm256_cmp_pd(w, _mm256_setzero_pd(), _CMP_NEQ_UQ); }
+  inline vd vdiv_or_zero(vd a, vd w, vd mask)
+  { return _mm256_and_pd(mask, _mm256_div_pd(a, w)); }
+#elif defined(__SSE2__)
+  typedef __m128d vd;
+  const size_t VW = 2;
+  inline vd vload(const double* p)     { return _mm_loadu_pd(p); }
+  inline void vstore(double* p, vd v)  { _mm_storeu_pd(p, v); }
+  inline vd vset1(double d)            { return _mm_set1_pd(d); }
+  inline vd vadd(vd a, vd b)           { return _mm_add_pd(a, b); }
+  inline vd vmul(vd a, vd b)           { return _mm_mul_pd(a, b); }
+  inline vd vnonzero(vd w)
+  { return _mm_cmpneq_pd(w, _mm_setzero_pd()); }
+  inline vd vdiv_or_zero(vd a, vd w, vd mask)
+  { return _mm_and_pd(mask, _mm_div_pd(a, w)); }
+#endif
+
   void mul_mtx_4x4(const double* m1, const double* m2, double* result)
   {
-    // Note we're using column-major order here
+    // Note we're using column-major order here. Each column of the
+    // result is a sum of the columns of m1 weighted by the entries of
+    // the corresponding column of m2; those entries are read before
+    // the result column is written, so m2 may be the same as result.
+#if defined(__AVX__)
+    const __m256d a0 = _mm256_loadu_pd(m1 + 0);
+    const __m256d a1 = _mm256_loadu_pd(m1 + 4);
+    const __m256d a2 = _mm256_loadu_pd(m1 + 8);
+    const __m256d a3 = _mm256_loadu_pd(m1 + 12);
+
     for (int result_col = 0; result_col < 4; ++result_col)
-      for (int result_row = 0; result_row < 4; ++result_row)
-        {
-          result[result_col * 4 + result_row] =
-              m1[0 * 4 + result_row] * m2[result_col * 4 + 0]
-            + m1[1 * 4 + result_row] * m2[result_col * 4 + 1]
-            + m1[2 * 4 + result_row] * m2[result_col * 4 + 2]
-            + m1[3 * 4 + result_row] * m2[result_col * 4 + 3];
-        }
+      {
+        const double* b = m2 + result_col * 4;
+        __m256d r = _mm256_mul_pd(a0, _mm256_set1_pd(b[0]));
+        r = _mm256_add_pd(r, _mm256_mul_pd(a1, _mm256_set1_pd(b[1])));
+        r = _mm256_add_pd(r, _mm256_mul_pd(a2, _mm256_set1_pd(b[2])));
+        r = _mm256_add_pd(r, _mm256_mul_pd(a3, _mm256_set1_pd(b[3])));
+        _mm256_storeu_pd(result + result_col * 4, r);
+      }
+#elif defined(__SSE2__)
+    const __m128d a0lo = _mm_loadu_pd(m1 + 0),  a0hi = _mm_loadu_pd(m1 + 2);
+    const __m128d a1lo = _mm_loadu_pd(m1 + 4),  a1hi = _mm_loadu_pd(m1 + 6);
+    const __m128d a2lo = _mm_loadu_pd(m1 + 8),  a2hi = _mm_loadu_pd(m1 + 10);
+    const __m128d a3lo = _mm_loadu_pd(m1 + 12), a3hi = _mm_loadu_pd(m1 + 14);
+
+    for (int result_col = 0; result_col < 4; ++result_col)
+      {
+        const double* b = m2 + result_col * 4;
+        const __m128d b0 = _mm_set1_pd(b[0]);
+        const __m128d b1 = _mm_set1_pd(b[1]);
+        const __m128d b2 = _mm_set1_pd(b[2]);
+        const __m128d b3 = _mm_set1_pd(b[3]);
+
+        __m128d lo = _mm_mul_pd(a0lo, b0);
+        __m128d hi = _mm_mul_pd(a0hi, b0);
+        lo = _mm_add_pd(lo, _mm_mul_pd(a1lo, b1));
+        hi = _mm_add_pd(hi, _mm_mul_pd(a1hi, b1));
+        lo = _mm_add_pd(lo, _mm_mul_pd(a2lo, b2));
+        hi = _mm_add_pd(hi, _mm_mul_pd(a2hi, b2));
+        lo = _mm_add_pd(lo, _mm_mul_pd(a3lo, b3));
+        hi = _mm_add_pd(hi, _mm_mul_pd(a3hi, b3));
+
+        _mm_storeu_pd(result + result_col * 4, lo);
+        _mm_storeu_pd(result + result_col * 4 + 2, hi);
+      }
+#else
+    for (int result_col = 0; result_col < 4; ++result_col)
+      {
+        const double b[4] = { m2[result_col * 4 + 0], m2[result_col * 4 + 1],
+                              m2[result_col * 4 + 2], m2[result_col * 4 + 3] };
+
+        for (int result_row = 0; result_row < 4; ++result_row)
+          {
+            result[result_col * 4 + result_row] =
+                m1[0 * 4 + result_row] * b[0]
+              + m1[1 * 4 + result_row] * b[1]
+              + m1[2 * 4 + result_row] * b[2]
+              + m1[3 * 4 + result_row] * b[3];
+          }
+      }
+#endif
+  }
+
+  // Compute a pair of 2x2 determinants in the form used by
+  // txform::inverted(): out[0] = a0*b0 - c0*d0, out[1] = a1*b1 - c1*d1.
+  inline void det2x2_pair(double* out,
+                          double a0, double b0, double c0, double d0,
+                          double a1, double b1, double c1, double d1)
+  {
+#if defined(__SSE2__)
+    _mm_storeu_pd(out, _mm_sub_pd(_mm_mul_pd(_mm_setr_pd(a0, a1),
+                                             _mm_setr_pd(b0, b1)),
+                                  _mm_mul_pd(_mm_setr_pd(c0, c1),
+                                             _mm_setr_pd(d0, d1))));
+#else
+    out[0] = (a0 * b0) - (c0 * d0);
+    out[1] = (a1 * b1) - (c1 * d1);
+#endif
   }
 }
 
@@ -240,12 +345,19 @@ GVX_TRACE("geom::txform::inverted");
     // This makes it easier to verify that we have all the correct +/-
     // signs in the 3x3 determinants (i.e. cofactors) below.
 
-    const double t8D_9C = (s8 * sD) - (s9 * sC);
-    const double t8E_AC = (s8 * sE) - (sA * sC);
-    const double t8F_BC = (s8 * sF) - (sB * sC);
-    const double t9E_AD = (s9 * sE) - (sA * sD);
-    const double t9F_BD = (s9 * sF) - (sB * sD);
-    const double tAF_BE = (sA * sF) - (sB * sE);
+    // The six determinants are computed two at a time.
+
+    double t[6];
+    det2x2_pair(t + 0, s8, sD, s9, sC,   s8, sE, sA, sC);
+    det2x2_pair(t + 2, s8, sF, sB, sC,   s9, sE, sA, sD);
+    det2x2_pair(t + 4, s9, sF, sB, sD,   sA, sF, sB, sE);
+
+    const double t8D_9C = t[0]; // (s8 * sD) - (s9 * sC)
+    const double t8E_AC = t[1]; // (s8 * sE) - (sA * sC)
+    const double t8F_BC = t[2]; // (s8 * sF) - (sB * sC)
+    const double t9E_AD = t[3]; // (s9 * sE) - (sA * sD)
+    const double t9F_BD = t[4]; // (s9 * sF) - (sB * sD)
+    const double tAF_BE = t[5]; // (sA * sF) - (sB * sE)
 
     cof[0]=    + tAF_BE*s5 - t9F_BD*s6 + t9E_AD*s7;
     cof[1]=    - tAF_BE*s4 + t8F_BC*s6 - t8E_AC*s7;
@@ -266,12 +378,17 @@ GVX_TRACE("geom::txform::inverted");
   */
 
   {
-    const double t05_14 = (s0 * s5) - (s1 * s4);
-    const double t06_24 = (s0 * s6) - (s2 * s4);
-    const double t07_34 = (s0 * s7) - (s3 * s4);
-    const double t16_25 = (s1 * s6) - (s2 * s5);
-    const double t17_35 = (s1 * s7) - (s3 * s5);
-    const double t27_36 = (s2 * s7) - (s3 * s6);
+    double t[6];
+    det2x2_pair(t + 0, s0, s5, s1, s4,   s0, s6, s2, s4);
+    det2x2_pair(t + 2, s0, s7, s3, s4,   s1, s6, s2, s5);
+    det2x2_pair(t + 4, s1, s7, s3, s5,   s2, s7, s3, s6);
+
+    const double t05_14 = t[0]; // (s0 * s5) - (s1 * s4)
+    const double t06_24 = t[1]; // (s0 * s6) - (s2 * s4)
+    const double t07_34 = t[2]; // (s0 * s7) - (s3 * s4)
+    const double t16_25 = t[3]; // (s1 * s6) - (s2 * s5)
+    const double t17_35 = t[4]; // (s1 * s7) - (s3 * s5)
+    const double t27_36 = t[5]; // (s2 * s7) - (s3 * s6)
 
     cof[8]=    + t27_36*sD - t17_35*sE + t16_25*sF;
     cof[9]=    - t27_36*sC + t07_34*sE - t06_24*sF;
@@ -324,7 +441,15 @@ GVX_TRACE("geom::txform::inverted");
 
   geom::txform inverse(true);
 
-  for (int i = 0; i < 16; ++i)
+  int i = 0;
+
+#if defined(__SSE2__)
+  const vd k = vset1(det_reciprocal);
+  for (; i < 16; i += int(VW))
+    vstore(inverse.m_mtx + i, vmul(vload(cof + i), k));
+#endif
+
+  for (; i < 16; ++i)
     {
       inverse.m_mtx[i] = cof[i] * det_reciprocal;
     }
@@ -520,6 +645,88 @@ GVX_TRACE("geom::txform::apply_to(vec3d)");
     : vec3d(0.0, 0.0, 0.0);
 }
 
+void geom::txform::apply_to(const double* x, const double* y,
+                            double* ox, double* oy, size_t n) const
+{
+GVX_TRACE("geom::txform::apply_to(x[], y[])");
+
+  size_t i = 0;
+
+#if defined(__SSE2__)
+  const vd m0 = vset1(m_mtx[0]), m4 = vset1(m_mtx[4]), m12 = vset1(m_mtx[12]);
+  const vd m1 = vset1(m_mtx[1]), m5 = vset1(m_mtx[5]), m13 = vset1(m_mtx[13]);
+  const vd m3 = vset1(m_mtx[3]), m7 = vset1(m_mtx[7]), m15 = vset1(m_mtx[15]);
+
+  for (; i + VW <= n; i += VW)
+    {
+      const vd vx = vload(x + i);
+      const vd vy = vload(y + i);
+
+      // same association order as the scalar apply_to()
+      const vd rx = vadd(vadd(vmul(m0, vx), vmul(m4, vy)), m12);
+      const vd ry = vadd(vadd(vmul(m1, vx), vmul(m5, vy)), m13);
+      const vd rw = vadd(vadd(vmul(m3, vx), vmul(m7, vy)), m15);
+
+      const vd ok = vnonzero(rw);
+      vstore(ox + i, vdiv_or_zero(rx, rw, ok));
+      vstore(oy + i, vdiv_or_zero(ry, rw, ok));
+    }
+#endif
+
+  for (; i < n; ++i)
+    {
+      const vec2d r = apply_to(vec2d(x[i], y[i]));
+      ox[i] = r.x();
+      oy[i] = r.y();
+    }
+}
+
+void geom::txform::apply_to(const double* x, const double* y, const double* z,
+                            double* ox, double* oy, double* oz,
+                            size_t n) const
+{
+GVX_TRACE("geom::txform::apply_to(x[], y[], z[])");
+
+  size_t i = 0;
+
+#if defined(__SSE2__)
+  const vd m0 = vset1(m_mtx[0]), m4 = vset1(m_mtx[4]);
+  const vd m8 = vset1(m_mtx[8]), m12 = vset1(m_mtx[12]);
+  const vd m1 = vset1(m_mtx[1]), m5 = vset1(m_mtx[5]);
+  const vd m9 = vset1(m_mtx[9]), m13 = vset1(m_mtx[13]);
+  const vd m2 = vset1(m_mtx[2]), m6 = vset1(m_mtx[6]);
+  const vd m10 = vset1(m_mtx[10]), m14 = vset1(m_mtx[14]);
+  const vd m3 = vset1(m_mtx[3]), m7 = vset1(m_mtx[7]);
+  const vd m11 = vset1(m_mtx[11]), m15 = vset1(m_mtx[15]);
+
+  for (; i + VW <= n; i += VW)
+    {
+      const vd vx = vload(x + i);
+      const vd vy = vload(y + i);
+      const vd vz = vload(z + i);
+
+      // same association order as the scalar apply_to()
+      const vd rx = vadd(vadd(vadd(vmul(m0, vx), vmul(m4, vy)), vmul(m8, vz)), m12);
+      const vd ry = vadd(vadd(vadd(vmul(m1, vx), vmul(m5, vy)), vmul(m9, vz)), m13);
+      const vd rz = vadd(vadd(vadd(vmul(m2, vx), vmul(m6, vy)), vmul(m10, vz)), m14);
+      const vd rw = vadd(vadd(vadd(vmul(m3, vx), vmul(m7, vy)), vmul(m11, vz)), m15);
+
+      const vd ok = vnonzero(rw);
+      vstore(ox + i, vdiv_or_zero(rx, rw, ok));
+      vstore(oy + i, vdiv_or_zero(ry, rw, ok));
+      vstore(oz + i, vdiv_or_zero(rz, rw, ok));
+    }
+#endif
+
+  for (; i < n; ++i)
+    {
+      const vec3d r = apply_to(vec3d(x[i], y[i], z[i]));
+      ox[i] = r.x();
+      oy[i] = r.y();
+      oz[i] = r.z();
+    }
+}
+
 void geom::txform::set_col_major_data(const double* data)
 {
 GVX_TRACE("geom::txform::set_col_major_data");
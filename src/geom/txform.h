@@ -92,6 +92,20 @@ namespace geom
     vec2<double> apply_to(const vec2<double>& input) const;
     vec3<double> apply_to(const vec3<double>& input) const;
 
+    /// Transform n 2-D points held in structure-of-arrays form.
+    /** Point i is (x[i], y[i]) and its result goes to (ox[i], oy[i]).
+        The output arrays may be the same as the input arrays. Each
+        result is computed with the same sequence of operations as
+        apply_to(vec2), but two or four points at a time where SSE2
+        or AVX is available. */
+    void apply_to(const double* x, const double* y,
+                  double* ox, double* oy, size_t n) const;
+
+    /// Transform n 3-D points held in structure-of-arrays form.
+    /** As above, but with (x[i], y[i], z[i]) -> (ox[i], oy[i], oz[i]). */
+    void apply_to(const double* x, const double* y, const double* z,
+                  double* ox, double* oy, double* oz, size_t n) const;
+
     const double* col_major_data() const { return &m_mtx[0]; }
 
     void set_col_major_data(const double* data);
@@ -36,6 +36,7 @@
 
 #include "gfx/canvas.h"
 
+#include <memory>
 #include <vector>
 
 #include "rutz/trace.h"
@@ -53,15 +54,17 @@ using geom::vec3d;
 
 struct Gfx::Bbox::Impl
 {
-  Impl(Canvas& c) : canvas(c), cube(), txforms(), first(true)
+  Impl(Canvas& c, std::shared_ptr<bool> sd) :
+    canvas(c), cube(), txforms(), first(true), screenDep(sd)
   {
     txforms.push_back(txform::identity());
   }
 
-  Canvas&             canvas;
-  geom::box<double>   cube;
-  std::vector<txform> txforms;
-  bool                first;
+  Canvas&               canvas;
+  geom::box<double>     cube;
+  std::vector<txform>   txforms;
+  bool                  first;
+  std::shared_ptr<bool> screenDep;
 
   vec3d screenFromWorld3(const vec3d& world_pos) const
   {
@@ -106,10 +109,46 @@ struct Gfx::Bbox::Impl
   {
     merge(vec3d(v.x(), v.y(), 0.0));
   }
+
+  // Points are gathered into these structure-of-arrays buffers, a
+  // chunk at a time, so that they can be transformed in a batch.
+  static const size_t CHUNK = 256;
+
+  // Transform the first n points of the chunk buffers in place and
+  // merge their bounds into the cube.
+  void mergeChunk(double* x, double* y, double* z, size_t n)
+  {
+    if (n == 0)
+      return;
+
+    txforms.back().apply_to(x, y, z, x, y, z, n);
+
+    double lo[3] = { x[0], y[0], z[0] };
+    double hi[3] = { x[0], y[0], z[0] };
+
+    for (size_t i = 1; i < n; ++i)
+      {
+        if (x[i] < lo[0]) lo[0] = x[i]; else if (x[i] > hi[0]) hi[0] = x[i];
+        if (y[i] < lo[1]) lo[1] = y[i]; else if (y[i] > hi[1]) hi[1] = y[i];
+        if (z[i] < lo[2]) lo[2] = z[i]; else if (z[i] > hi[2]) hi[2] = z[i];
+      }
+
+    if (first)
+      {
+        cube.set_corners(vec3d(lo[0], lo[1], lo[2]),
+                         vec3d(hi[0], hi[1], hi[2]));
+        first = false;
+      }
+    else
+      {
+        cube.merge(vec3d(lo[0], lo[1], lo[2]));
+        cube.merge(vec3d(hi[0], hi[1], hi[2]));
+      }
+  }
 };
 
 Gfx::Bbox::Bbox(Canvas& c) :
-  rep(new Impl(c))
+  rep(new Impl(c, std::make_shared<bool>(false)))
 {
 GVX_TRACE("Gfx::Bbox::Bbox");
 }
@@ -129,7 +168,9 @@ GVX_TRACE("Gfx::Bbox::~Bbox");
 Gfx::Bbox Gfx::Bbox::peer() const
 {
 GVX_TRACE("Gfx::Bbox::peer");
-  return Gfx::Bbox(rep->canvas);
+  Gfx::Bbox result(rep->canvas);
+  result.rep->screenDep = rep->screenDep;
+  return result;
 }
 
 void Gfx::Bbox::push()
@@ -178,6 +219,44 @@ GVX_TRACE("Gfx::Bbox::vertex3");
   rep->merge(v);
 }
 
+void Gfx::Bbox::vertices(const vec2d* pts, size_t n)
+{
+GVX_TRACE("Gfx::Bbox::vertices(vec2)");
+
+  double x[Impl::CHUNK], y[Impl::CHUNK], z[Impl::CHUNK];
+
+  for (size_t i = 0; i < n; i += Impl::CHUNK)
+    {
+      const size_t m = (n - i < Impl::CHUNK) ? n - i : Impl::CHUNK;
+      for (size_t k = 0; k < m; ++k)
+        {
+          x[k] = pts[i+k].x();
+          y[k] = pts[i+k].y();
+          z[k] = 0.0;
+        }
+      rep->mergeChunk(x, y, z, m);
+    }
+}
+
+void Gfx::Bbox::vertices(const vec3d* pts, size_t n)
+{
+GVX_TRACE("Gfx::Bbox::vertices(vec3)");
+
+  double x[Impl::CHUNK], y[Impl::CHUNK], z[Impl::CHUNK];
+
+  for (size_t i = 0; i < n; i += Impl::CHUNK)
+    {
+      const size_t m = (n - i < Impl::CHUNK) ? n - i : Impl::CHUNK;
+      for (size_t k = 0; k < m; ++k)
+        {
+          x[k] = pts[i+k].x();
+          y[k] = pts[i+k].y();
+          z[k] = pts[i+k].z();
+        }
+      rep->mergeChunk(x, y, z, m);
+    }
+}
+
 void Gfx::Bbox::drawRect(const rectd& rect)
 {
 GVX_TRACE("Gfx::Bbox::drawRect");
@@ -213,6 +292,8 @@ void Gfx::Bbox::drawScreenRect(const vec3d& lower_left,
                                const recti& screen_rect)
 {
 GVX_TRACE("Gfx::Bbox::drawScreenRect");
+  *rep->screenDep = true;
+
   const vec3d o = rep->screenFromWorld3(vec3d(lower_left));
 
   rep->mergeRaw(rep->worldFromScreen3(o+vec2d(screen_rect.bottom_left())));
@@ -232,3 +313,34 @@ rectd Gfx::Bbox::rect() const
 GVX_TRACE("Gfx::Bbox::rect");
   return rep->cube.rect();
 }
+
+Gfx::Canvas& Gfx::Bbox::canvas() const
+{
+  return rep->canvas;
+}
+
+const txform& Gfx::Bbox::currentTransform() const
+{
+  return rep->txforms.back();
+}
+
+bool Gfx::Bbox::isEmpty() const
+{
+  return rep->first;
+}
+
+bool Gfx::Bbox::isAxisAligned() const
+{
+  // column-major: the off-diagonal entries of the upper-left 3x3,
+  // plus the bottom row's perspective entries, must all be zero
+  const txform& m = rep->txforms.back();
+  return (m[1] == 0.0 && m[2] == 0.0 && m[3] == 0.0 &&
+          m[4] == 0.0 && m[6] == 0.0 && m[7] == 0.0 &&
+          m[8] == 0.0 && m[9] == 0.0 && m[11] == 0.0 &&
+          m[15] == 1.0);
+}
+
+bool Gfx::Bbox::isScreenDependent() const
+{
+  return *rep->screenDep;
+}
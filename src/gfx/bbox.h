@@ -72,6 +72,14 @@ public:
   void vertex2(const geom::vec2<double>& v);
   void vertex3(const geom::vec3<double>& v);
 
+  /// Merge n points at once; equivalent to calling vertex2() on each.
+  /** The points are transformed in batches with
+      geom::txform::apply_to() over structure-of-arrays buffers. */
+  void vertices(const geom::vec2<double>* pts, size_t n);
+
+  /// Merge n points at once; equivalent to calling vertex3() on each.
+  void vertices(const geom::vec3<double>* pts, size_t n);
+
   void drawRect(const geom::rect<double>& rect);
 
   void drawBox(const geom::box<double>& box);
@@ -86,6 +94,27 @@ public:
   geom::box<double> cube() const;
   geom::rect<double> rect() const;
 
+  /// Get the canvas used for screen-space queries.
+  Gfx::Canvas& canvas() const;
+
+  /// Get the current transform, relative to the box's initial coordinates.
+  const geom::txform& currentTransform() const;
+
+  /// Returns true if nothing has been merged into the box yet.
+  bool isEmpty() const;
+
+  /// Returns true if the current transform maps axis-aligned boxes to axis-aligned boxes.
+  /** That is, the transform has no rotation, shear or perspective
+      components, so that transforming the corners of a box gives
+      exactly the bounds of whatever was inside the box. */
+  bool isAxisAligned() const;
+
+  /// Returns true if any screen-space rect has been merged into the box.
+  /** If so, then the result depends on the canvas's current
+      projection and viewport, and not only on the geometry that was
+      drawn into the box. This state is shared with peer() boxes. */
+  bool isScreenDependent() const;
+
 private:
   Bbox& operator=(const Bbox&);
 
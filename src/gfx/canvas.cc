@@ -33,12 +33,15 @@
 
 #include "canvas.h"
 
+#include "gfx/curvecache.h"
 #include "gfx/rgbacolor.h"
 
-#include "geom/bezier4.h"
 #include "geom/box.h"
+#include "geom/rect.h"
 #include "geom/vec3.h"
 
+#include "media/bmapdata.h"
+
 #include "rutz/error.h"
 
 #include <vector>
@@ -54,17 +57,6 @@ using geom::vec2d;
 using geom::vec3i;
 using geom::vec3d;
 
-namespace
-{
-  struct BezData
-  {
-    vec3d pt0;
-    vec3d pt1;
-    vec3d pt2;
-    vec3d pt3;
-  };
-}
-
 Gfx::Canvas::~Canvas() noexcept {}
 
 vec2d Gfx::Canvas::screenFromWorld2(const vec2d& world_pos) const
@@ -143,6 +135,23 @@ void Gfx::Canvas::drawBox(const geom::box<double>& box)
   }
 }
 
+namespace
+{
+  unsigned int numSegments(const Gfx::Canvas& canvas,
+                           const vec3d& p1, const vec3d& p2,
+                           const vec3d& p3, const vec3d& p4,
+                           unsigned int subdivisions)
+  {
+    if (subdivisions == 0)
+      return Gfx::bezierSegments(p1, p2, p3, p4,
+                                 Gfx::pixelsPerUnit(canvas),
+                                 Gfx::curveTolerance());
+
+    // otherwise subdivisions is the number of points, as before
+    return subdivisions > 1 ? subdivisions - 1 : 1;
+  }
+}
+
 void Gfx::Canvas::drawBezier4(const vec3d& p1,
                               const vec3d& p2,
                               const vec3d& p3,
@@ -151,16 +160,10 @@ void Gfx::Canvas::drawBezier4(const vec3d& p1,
 {
 GVX_TRACE("Gfx::Canvas::drawBezier4");
 
-  geom::bezier4 xb(p1.x(), p2.x(), p3.x(), p4.x());
-  geom::bezier4 yb(p1.y(), p2.y(), p3.y(), p4.y());
-  geom::bezier4 zb(p1.z(), p2.z(), p3.z(), p4.z());
-
   beginLineStrip();
-  for (unsigned int i = 0; i < subdivisions; ++i)
-    {
-      double u = double(i) / double(subdivisions - 1);
-      vertex3(vec3d(xb.eval(u), yb.eval(u), zb.eval(u)));
-    }
+  Gfx::forEachBezierPoint(p1, p2, p3, p4,
+                          numSegments(*this, p1, p2, p3, p4, subdivisions),
+                          [this](const vec3d& v) { this->vertex3(v); });
   end();
 }
 
@@ -173,64 +176,35 @@ void Gfx::Canvas::drawBezierFill4(const vec3d& center,
 {
 GVX_TRACE("Gfx::Canvas::drawBezierFill4");
 
-  geom::bezier4 xb(p1.x(), p2.x(), p3.x(), p4.x());
-  geom::bezier4 yb(p1.y(), p2.y(), p3.y(), p4.y());
-  geom::bezier4 zb(p1.z(), p2.z(), p3.z(), p4.z());
-
   beginTriangleFan();
   vertex3(center);
-  for (unsigned int i = 0; i < subdivisions; ++i)
-    {
-      double u = double(i) / double(subdivisions - 1);
-      vertex3(vec3d(xb.eval(u), yb.eval(u), zb.eval(u)));
-    }
+  Gfx::forEachBezierPoint(p1, p2, p3, p4,
+                          numSegments(*this, p1, p2, p3, p4, subdivisions),
+                          [this](const vec3d& v) { this->vertex3(v); });
   end();
 }
 
+bool Gfx::Canvas::drawsCurvesNatively() const
+{
+  return false;
+}
+
+bool Gfx::Canvas::wantsLabels() const
+{
+  return false;
+}
+
 void Gfx::Canvas::drawNurbsCurve
  (const float* knots, const geom::vec3<float>* pts, const size_t npts)
 {
 GVX_TRACE("Gfx::Canvas::drawNurbsCurve");
 
-  const float* t = &knots[2];
-  // t points to { 0, 0, 0.17, 0.33, 0.5, 0.67, 0.83, 1, 1 }
-
-  GVX_ASSERT(npts > 4);
-
-  const size_t nbz = npts - 3;
-
-  std::vector<BezData> bz(nbz);
-
-  for (size_t k = 0; k < nbz; ++k)
-    {
-      float d1 = t[k+3] - t[k+2]; // == 0 when k == nbz-1 (last iteration)
-      float d2 = t[k+2] - t[k+1];
-      float d3 = t[k+1] - t[k];  // == 0 when k == 0 (first iteration)
-      float d = t[k+3] - t[k];
-
-      bz[k].pt1 = vec3d((pts[k+2] *  d3     + pts[k+1] * (d1+d2)) / d);
-      bz[k].pt2 = vec3d((pts[k+2] * (d2+d3) + pts[k+1] *  d1    ) / d);
-
-      if (k == 0)
-        {
-          bz[k].pt0 = vec3d(pts[k]);
-        }
-      else
-        {
-          bz[k-1].pt3 = (bz[k-1].pt2 * d2 + bz[k].pt1 * d3) / (d2+d3);
-          bz[k].pt0 = bz[k-1].pt3;
-        }
-
-      if (k == (nbz-1))
-        {
-          bz[k].pt3 = vec3d(pts[k+3]);
-        }
-
-    }
+  std::vector<vec3d> bz;
+  Gfx::splitNurbs(knots, pts, npts, bz);
 
-  for (unsigned int i = 0; i < bz.size(); ++i)
+  for (size_t i = 0; i + 3 < bz.size(); i += 4)
     {
-      drawBezier4(bz[i].pt0, bz[i].pt1, bz[i].pt2, bz[i].pt3, 20);
+      drawBezier4(bz[i], bz[i+1], bz[i+2], bz[i+3], 0);
     }
 }
 
@@ -251,6 +225,25 @@ void Gfx::Canvas::begin(Gfx::Canvas::VertexStyle s, const char* comment)
     }
 }
 
+media::bmap_data Gfx::Canvas::grabDrawnPixels(const geom::rect<int>& bounds)
+{
+GVX_TRACE("Gfx::Canvas::grabDrawnPixels");
+  return grabPixels(bounds);
+}
+
+void Gfx::Canvas::drawArrays(Gfx::Canvas::VertexStyle s,
+                             const geom::vec3<double>* pts,
+                             const geom::vec3<double>* /*normals*/,
+                             size_t n)
+{
+GVX_TRACE("Gfx::Canvas::drawArrays");
+
+  begin(s);
+  for (size_t i = 0; i < n; ++i)
+    vertex3(pts[i]);
+  end();
+}
+
 void Gfx::Canvas::finishDrawing()
 {
 GVX_TRACE("Gfx::Canvas::finishDrawing");
@@ -234,6 +234,14 @@ public:
   /// Turn on antialiasing if available.
   virtual void enableAntialiasing() = 0;
 
+  /// Restrict drawing (and clearing) to the screen rect \a screen_rect.
+  /** The scissor rect is part of the attrib set, so it is restored by
+      popAttribs(). */
+  virtual void setScissor(const geom::rect<int>& screen_rect) = 0;
+
+  /// Remove any scissor rect set with setScissor().
+  virtual void disableScissor() = 0;
+
   ///////////////////////////////////////////////////////////
   //
   // Viewport and projection
@@ -263,6 +271,11 @@ public:
   /// Restore the previously saved transformation matrix.
   virtual void popMatrix() = 0;
 
+  /// Query whether the canvas makes any use of the labels passed to pushMatrix().
+  /** If not, callers can skip a push that would only be there to
+      label the output. The default implementation returns false. */
+  virtual bool wantsLabels() const;
+
   /// Translate the coordinate system by the given vector.
   virtual void translate(const geom::vec3<double>& v) = 0;
   /// Scale/reflect the coordinate system by the given vector.
@@ -294,6 +307,13 @@ public:
   /// Read pixel data from the screen rect \a bounds into \a data_out.
   virtual media::bmap_data grabPixels(const geom::rect<int>& bounds) = 0;
 
+  /// Read pixel data from the buffer that is currently being drawn into.
+  /** This differs from grabPixels() for a double-buffered canvas that
+      is drawing on its back buffer: grabPixels() reads what is on
+      screen, whereas this reads what has been drawn but not yet
+      swapped. The default version just calls grabPixels(). */
+  virtual media::bmap_data grabDrawnPixels(const geom::rect<int>& bounds);
+
   /// Clear the color buffer to the clear color.
   virtual void clearColorBuffer() = 0;
 
@@ -323,6 +343,10 @@ public:
                           bool fill) = 0;
 
   /// Draw a Bezier curve with 4 control points.
+  /** The curve is drawn as a line strip through \a subdivisions
+      evenly-spaced points; if \a subdivisions is 0, then the number of
+      points is chosen so that the line strip stays within
+      Gfx::curveTolerance() pixels of the curve at the current scale. */
   virtual void drawBezier4(const geom::vec3<double>& p1,
                            const geom::vec3<double>& p2,
                            const geom::vec3<double>& p3,
@@ -330,6 +354,7 @@ public:
                            unsigned int subdivisions);
 
   /// Draw a filled Bezier curve with 4 control points.
+  /** \a subdivisions is as for drawBezier4(). */
   virtual void drawBezierFill4(const geom::vec3<double>& center,
                                const geom::vec3<double>& p1,
                                const geom::vec3<double>& p2,
@@ -337,10 +362,16 @@ public:
                                const geom::vec3<double>& p4,
                                unsigned int subdivisions);
 
+  /// Query whether the canvas draws curves exactly, without tessellating.
+  /** If so, then callers that would otherwise hand the canvas their
+      own (e.g. cached) polylines should call drawBezier4() and friends
+      instead. The default implementation returns false. */
+  virtual bool drawsCurvesNatively() const;
+
   /// Draw a NURBS curve.
   /** The default implementation splits the NURBS curve into 4-pt
       Bezier curve components, and then draws those with
-      drawBezier4(). */
+      drawBezier4(), with adaptive subdivision. */
   virtual void drawNurbsCurve
     (const float* knots,
      const geom::vec3<float>* pts, size_t npts);
@@ -384,6 +415,17 @@ public:
   /// End the current vertex-series.
   virtual void end() = 0;
 
+  /// Draw a complete vertex-series from arrays of \a n vertices.
+  /** Equivalent to begin(s), vertex3() for each of \a pts, then
+      end(), but subclasses can hand the whole array over at once
+      rather than taking one virtual call per vertex. \a normals may be
+      null; if not, it holds one normal per vertex, for canvases that
+      do lighting. */
+  virtual void drawArrays(VertexStyle s,
+                          const geom::vec3<double>* pts,
+                          const geom::vec3<double>* normals,
+                          size_t n);
+
   /// Render text with the given raster font.
   virtual void drawRasterText(const rutz::fstring& text,
                               const GxRasterFont& font) = 0;
@@ -0,0 +1,388 @@
+/** @file gfx/curvecache.cc adaptive tessellation of Bezier and NURBS
+    curves, with a per-node cache of the resulting polylines */
+
+///////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026-2026 Rob Peters
+// Rob Peters <https://github.com/rjpcal/>
+//
+// created: Mon Oct 19 11:02:37 2026
+//
+// --------------------------------------------------------------------
+//
+// This file is part of GroovX.
+//   [https://github.com/rjpcal/groovx]
+//
+// GroovX is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// GroovX is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GroovX; if not, write to the Free Software Foundation,
+// Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include "gfx/curvecache.h"
+
+#include "gfx/canvas.h"
+
+#include "rutz/error.h"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
+#include "rutz/trace.h"
+#include "rutz/debug.h"
+GVX_DBG_REGISTER
+
+using geom::vec3d;
+using geom::vec3f;
+
+namespace
+{
+  double g_tolerance = 0.5;
+
+  Gfx::CurveCache::Stats g_stats = { 0, 0, 0 };
+
+  bool g_caching = true;
+
+  // Used when the canvas scale is unknown (e.g. a degenerate
+  // transform); this matches the old fixed per-segment count.
+  const unsigned int FALLBACK_SEGMENTS = 20;
+
+  const unsigned int MAX_SEGMENTS = 512;
+
+  // Level used when the scale is unknown; real levels are much
+  // smaller in magnitude.
+  const int NO_LEVEL = INT_MIN;
+
+  double length2d(const vec3d& v)
+  {
+    return std::sqrt(v.x()*v.x() + v.y()*v.y());
+  }
+
+  double length3d(const vec3d& v)
+  {
+    return std::sqrt(v.x()*v.x() + v.y()*v.y() + v.z()*v.z());
+  }
+}
+
+double Gfx::pixelsPerUnit(const Gfx::Canvas& canvas)
+{
+GVX_TRACE("Gfx::pixelsPerUnit");
+
+  const vec3d o  = canvas.screenFromWorld3(vec3d(0.0, 0.0, 0.0));
+  const vec3d ex = canvas.screenFromWorld3(vec3d(1.0, 0.0, 0.0));
+  const vec3d ey = canvas.screenFromWorld3(vec3d(0.0, 1.0, 0.0));
+
+  return std::max(length2d(ex - o), length2d(ey - o));
+}
+
+double Gfx::curveTolerance()
+{
+  return g_tolerance;
+}
+
+void Gfx::setCurveTolerance(double pixels)
+{
+  if (!(pixels > 0.0))
+    throw rutz::error("curve tolerance must be positive", SRC_POS);
+
+  g_tolerance = pixels;
+}
+
+unsigned int Gfx::bezierSegments(const vec3d& p1, const vec3d& p2,
+                                 const vec3d& p3, const vec3d& p4,
+                                 double pixels_per_unit,
+                                 double tolerance)
+{
+  if (!(pixels_per_unit > 0.0) || !std::isfinite(pixels_per_unit)
+      || !(tolerance > 0.0))
+    return FALLBACK_SEGMENTS;
+
+  // Wang's formula: for a degree-n curve split into k uniform
+  // segments, the distance to the polyline is at most
+  // n(n-1)/(8 k^2) * max |P[i] - 2 P[i+1] + P[i+2]|.
+  const double m = std::max(length3d(p1 - p2 * 2.0 + p3),
+                            length3d(p2 - p3 * 2.0 + p4));
+
+  const double k = std::ceil(std::sqrt(0.75 * m * pixels_per_unit
+                                        / tolerance));
+
+  if (!(k >= 1.0))
+    return 1;
+
+  return (unsigned int)(std::min(k, double(MAX_SEGMENTS)));
+}
+
+void Gfx::tessellateBezier4(const vec3d& p1, const vec3d& p2,
+                            const vec3d& p3, const vec3d& p4,
+                            unsigned int nsegs,
+                            std::vector<vec3d>& result,
+                            bool skip_first)
+{
+  forEachBezierPoint(p1, p2, p3, p4, nsegs,
+                     [&result](const vec3d& v) { result.push_back(v); },
+                     skip_first);
+}
+
+void Gfx::splitNurbs(const float* knots, const vec3f* pts, size_t npts,
+                     std::vector<vec3d>& result)
+{
+GVX_TRACE("Gfx::splitNurbs");
+
+  const float* t = &knots[2];
+  // t points to { 0, 0, 0.17, 0.33, 0.5, 0.67, 0.83, 1, 1 }
+
+  GVX_ASSERT(npts > 4);
+
+  const size_t nbz = npts - 3;
+
+  const size_t first = result.size();
+
+  result.resize(first + 4*nbz);
+
+  vec3d* const bz = &result[first];
+
+  for (size_t k = 0; k < nbz; ++k)
+    {
+      float d1 = t[k+3] - t[k+2]; // == 0 when k == nbz-1 (last iteration)
+      float d2 = t[k+2] - t[k+1];
+      float d3 = t[k+1] - t[k];  // == 0 when k == 0 (first iteration)
+      float d = t[k+3] - t[k];
+
+      bz[4*k+1] = vec3d((pts[k+2] *  d3     + pts[k+1] * (d1+d2)) / d);
+      bz[4*k+2] = vec3d((pts[k+2] * (d2+d3) + pts[k+1] *  d1    ) / d);
+
+      if (k == 0)
+        {
+          bz[4*k+0] = vec3d(pts[k]);
+        }
+      else
+        {
+          bz[4*(k-1)+3] = (bz[4*(k-1)+2] * d2 + bz[4*k+1] * d3) / (d2+d3);
+          bz[4*k+0] = bz[4*(k-1)+3];
+        }
+
+      if (k == (nbz-1))
+        {
+          bz[4*k+3] = vec3d(pts[k+3]);
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////
+//
+// Gfx::CurveCache member definitions
+//
+///////////////////////////////////////////////////////////////////////
+
+struct Gfx::CurveCache::Entry
+{
+  std::vector<double> key;
+  int level;
+  std::vector<vec3d> pts;
+};
+
+Gfx::CurveCache::CurveCache() :
+  itsEntries(),
+  itsCursor(0),
+  itsLevel(NO_LEVEL),
+  itsScale(0.0),
+  itsKey(),
+  itsCtrl()
+{}
+
+Gfx::CurveCache::~CurveCache() noexcept
+{}
+
+void Gfx::CurveCache::begin(const Gfx::Canvas& canvas)
+{
+GVX_TRACE("Gfx::CurveCache::begin");
+
+  itsCursor = 0;
+
+  // A canvas with native curves (i.e. PSCanvas) has no pixel scale;
+  // any polylines requested from it get the fallback resolution.
+  const double ppu =
+    canvas.drawsCurvesNatively() ? 0.0 : Gfx::pixelsPerUnit(canvas);
+
+  if (ppu > 0.0 && std::isfinite(ppu))
+    {
+      // Round the scale up to the next half-octave, so that small
+      // changes in scale don't force re-tessellation, and the cached
+      // polylines are still fine enough at the actual scale.
+      itsLevel = int(std::ceil(2.0 * std::log2(ppu)));
+      itsScale = std::pow(2.0, 0.5 * itsLevel);
+    }
+  else
+    {
+      itsLevel = NO_LEVEL;
+      itsScale = 0.0;
+    }
+}
+
+Gfx::CurveCache::Entry& Gfx::CurveCache::lookup(bool& hit)
+{
+  if (itsCursor >= itsEntries.size())
+    itsEntries.resize(itsCursor + 1);
+
+  Entry& e = itsEntries[itsCursor++];
+
+  hit = g_caching && e.level == itsLevel && e.key == itsKey;
+
+  if (hit)
+    {
+      ++g_stats.hits;
+    }
+  else
+    {
+      ++g_stats.misses;
+      e.key = itsKey;
+      e.level = itsLevel;
+      e.pts.clear();
+    }
+
+  return e;
+}
+
+const std::vector<vec3d>&
+Gfx::CurveCache::bezier4(const vec3d& p1, const vec3d& p2,
+                         const vec3d& p3, const vec3d& p4)
+{
+  itsKey.clear();
+  for (const vec3d* p: {&p1, &p2, &p3, &p4})
+    itsKey.insert(itsKey.end(), p->data(), p->data() + 3);
+
+  bool hit = false;
+  Entry& e = lookup(hit);
+
+  if (!hit)
+    {
+      tessellateBezier4(p1, p2, p3, p4,
+                        bezierSegments(p1, p2, p3, p4, itsScale,
+                                       g_tolerance),
+                        e.pts);
+      g_stats.vertices += e.pts.size();
+    }
+
+  return e.pts;
+}
+
+const std::vector<vec3d>&
+Gfx::CurveCache::nurbs(const float* knots, const vec3f* pts, size_t npts)
+{
+  // Gfx::splitNurbs() reads knots[2] through knots[npts+1]
+  itsKey.assign(knots + 2, knots + npts + 2);
+  for (size_t i = 0; i < npts; ++i)
+    itsKey.insert(itsKey.end(), pts[i].data(), pts[i].data() + 3);
+
+  bool hit = false;
+  Entry& e = lookup(hit);
+
+  if (!hit)
+    {
+      itsCtrl.clear();
+      splitNurbs(knots, pts, npts, itsCtrl);
+
+      for (size_t i = 0; i + 3 < itsCtrl.size(); i += 4)
+        tessellateBezier4(itsCtrl[i], itsCtrl[i+1], itsCtrl[i+2], itsCtrl[i+3],
+                          bezierSegments(itsCtrl[i], itsCtrl[i+1],
+                                         itsCtrl[i+2], itsCtrl[i+3],
+                                         itsScale, g_tolerance),
+                          e.pts,
+                          i > 0 /* the previous segment ended here */);
+      g_stats.vertices += e.pts.size();
+    }
+
+  return e.pts;
+}
+
+void Gfx::CurveCache::drawBezier4(Gfx::Canvas& canvas,
+                                  const vec3d& p1, const vec3d& p2,
+                                  const vec3d& p3, const vec3d& p4)
+{
+  if (canvas.drawsCurvesNatively())
+    {
+      canvas.drawBezier4(p1, p2, p3, p4, 0);
+      return;
+    }
+
+  const std::vector<vec3d>& pts = bezier4(p1, p2, p3, p4);
+
+  canvas.beginLineStrip();
+  for (const vec3d& v: pts)
+    canvas.vertex3(v);
+  canvas.end();
+}
+
+void Gfx::CurveCache::drawBezierFill4(Gfx::Canvas& canvas,
+                                      const vec3d& center,
+                                      const vec3d& p1, const vec3d& p2,
+                                      const vec3d& p3, const vec3d& p4)
+{
+  if (canvas.drawsCurvesNatively())
+    {
+      canvas.drawBezierFill4(center, p1, p2, p3, p4, 0);
+      return;
+    }
+
+  const std::vector<vec3d>& pts = bezier4(p1, p2, p3, p4);
+
+  canvas.beginTriangleFan();
+  canvas.vertex3(center);
+  for (const vec3d& v: pts)
+    canvas.vertex3(v);
+  canvas.end();
+}
+
+void Gfx::CurveCache::drawNurbsCurve(Gfx::Canvas& canvas, const float* knots,
+                                     const vec3f* pts, size_t npts)
+{
+  if (canvas.drawsCurvesNatively())
+    {
+      canvas.drawNurbsCurve(knots, pts, npts);
+      return;
+    }
+
+  const std::vector<vec3d>& poly = nurbs(knots, pts, npts);
+
+  canvas.beginLineStrip();
+  for (const vec3d& v: poly)
+    canvas.vertex3(v);
+  canvas.end();
+}
+
+void Gfx::CurveCache::clear()
+{
+  itsEntries.clear();
+  itsCursor = 0;
+}
+
+Gfx::CurveCache::Stats Gfx::CurveCache::stats()
+{
+  return g_stats;
+}
+
+void Gfx::CurveCache::resetStats()
+{
+  g_stats = Stats{0, 0, 0};
+}
+
+void Gfx::CurveCache::setCaching(bool on)
+{
+  g_caching = on;
+}
+
+bool Gfx::CurveCache::isCaching()
+{
+  return g_caching;
+}
@@ -0,0 +1,243 @@
+/** @file gfx/curvecache.h adaptive tessellation of Bezier and NURBS
+    curves, with a per-node cache of the resulting polylines */
+
+///////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026-2026 Rob Peters
+// Rob Peters <https://github.com/rjpcal/>
+//
+// created: Mon Oct 19 11:02:37 2026
+//
+// --------------------------------------------------------------------
+//
+// This file is part of GroovX.
+//   [https://github.com/rjpcal/groovx]
+//
+// GroovX is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// GroovX is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GroovX; if not, write to the Free Software Foundation,
+// Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef GROOVX_GFX_CURVECACHE_H_UTC20261019110237_DEFINED
+#define GROOVX_GFX_CURVECACHE_H_UTC20261019110237_DEFINED
+
+#include "geom/vec3.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace Gfx
+{
+  class Canvas;
+  class CurveCache;
+
+  /// Estimate the canvas's current scale, in pixels per world unit.
+  /** This is the longest screen-space image of a unit vector along
+      the x or y axis under the canvas's current transform. */
+  double pixelsPerUnit(const Gfx::Canvas& canvas);
+
+  /// Get the screen-space error (in pixels) allowed when tessellating curves.
+  double curveTolerance();
+
+  /// Set the screen-space error (in pixels) allowed when tessellating curves.
+  void setCurveTolerance(double pixels);
+
+  /// Number of line segments needed to keep a cubic Bezier curve within tolerance.
+  /** Uses Wang's bound on the distance between the curve and its
+      uniformly-sampled polyline, given the curve's control points, the
+      scale at which it will be drawn (see pixelsPerUnit()), and the
+      allowed error in pixels (see curveTolerance()). */
+  unsigned int bezierSegments(const geom::vec3<double>& p1,
+                              const geom::vec3<double>& p2,
+                              const geom::vec3<double>& p3,
+                              const geom::vec3<double>& p4,
+                              double pixels_per_unit,
+                              double tolerance);
+
+  /// Call f() on nsegs+1 evenly-spaced points of a cubic Bezier curve.
+  /** The points are generated by forward differencing, so each one
+      costs three additions per coordinate. The last point is always
+      exactly \a p4. If \a skip_first is true, then \a p1 itself is
+      skipped (useful when joining curves end to end). */
+  template <class F>
+  void forEachBezierPoint(const geom::vec3<double>& p1,
+                          const geom::vec3<double>& p2,
+                          const geom::vec3<double>& p3,
+                          const geom::vec3<double>& p4,
+                          unsigned int nsegs, F f,
+                          bool skip_first = false)
+  {
+    if (nsegs < 1) nsegs = 1;
+
+    const double h = 1.0 / nsegs;
+    const double h2 = h * h;
+    const double h3 = h2 * h;
+
+    // per coordinate: the current point and its 1st, 2nd and 3rd
+    // forward differences, from p(u) = a*u^3 + b*u^2 + c*u + p1
+    double pt[3], d1[3], d2[3], d3[3];
+
+    const double* const q1 = p1.data();
+    const double* const q2 = p2.data();
+    const double* const q3 = p3.data();
+    const double* const q4 = p4.data();
+
+    for (int k = 0; k < 3; ++k)
+      {
+        const double a = (q4[k] - q1[k]) + 3.0 * (q2[k] - q3[k]);
+        const double b = 3.0 * (q1[k] + q3[k] - 2.0 * q2[k]);
+        const double c = 3.0 * (q2[k] - q1[k]);
+
+        pt[k] = q1[k];
+        d1[k] = a * h3 + b * h2 + c * h;
+        d2[k] = 6.0 * a * h3 + 2.0 * b * h2;
+        d3[k] = 6.0 * a * h3;
+      }
+
+    if (!skip_first)
+      f(p1);
+
+    for (unsigned int i = 1; i < nsegs; ++i)
+      {
+        for (int k = 0; k < 3; ++k)
+          {
+            pt[k] += d1[k];
+            d1[k] += d2[k];
+            d2[k] += d3[k];
+          }
+        f(geom::vec3<double>(pt[0], pt[1], pt[2]));
+      }
+
+    f(p4);
+  }
+
+  /// Append the points of forEachBezierPoint() to \a result.
+  void tessellateBezier4(const geom::vec3<double>& p1,
+                         const geom::vec3<double>& p2,
+                         const geom::vec3<double>& p3,
+                         const geom::vec3<double>& p4,
+                         unsigned int nsegs,
+                         std::vector<geom::vec3<double> >& result,
+                         bool skip_first = false);
+
+  /// Split a cubic NURBS curve into 4-point Bezier segments.
+  /** Appends four control points per Bezier segment to \a result;
+      this is the conversion used by Canvas::drawNurbsCurve(). */
+  void splitNurbs(const float* knots,
+                  const geom::vec3<float>* pts, size_t npts,
+                  std::vector<geom::vec3<double> >& result);
+}
+
+///////////////////////////////////////////////////////////////////////
+/**
+ *
+ * Gfx::CurveCache keeps the tessellated polylines of the curves that a
+ * node draws, so that redrawing an unchanged node just replays the
+ * cached vertices. Each entry is keyed on the curve's control points
+ * and on the drawing scale, rounded to half-octaves; the number of
+ * segments is chosen adaptively for that scale (see
+ * bezierSegments()). A node should call begin() at the start of each
+ * draw, and then request its curves in the same order each time.
+ *
+ **/
+///////////////////////////////////////////////////////////////////////
+
+class Gfx::CurveCache
+{
+public:
+  /// Construct an empty cache.
+  CurveCache();
+
+  /// Destructor.
+  ~CurveCache() noexcept;
+
+  /// Start a new draw on \a canvas, at the canvas's current scale.
+  void begin(const Gfx::Canvas& canvas);
+
+  /// Get the polyline for a cubic Bezier curve.
+  /** The returned reference is valid until the next request. */
+  const std::vector<geom::vec3<double> >&
+  bezier4(const geom::vec3<double>& p1,
+          const geom::vec3<double>& p2,
+          const geom::vec3<double>& p3,
+          const geom::vec3<double>& p4);
+
+  /// Get the polyline for a cubic NURBS curve (see Canvas::drawNurbsCurve()).
+  const std::vector<geom::vec3<double> >&
+  nurbs(const float* knots, const geom::vec3<float>* pts, size_t npts);
+
+  /// Draw a Bezier curve as a line strip.
+  /** This and the other draw functions bypass the cache, and call the
+      corresponding Canvas function, on a canvas that
+      drawsCurvesNatively(). */
+  void drawBezier4(Gfx::Canvas& canvas,
+                   const geom::vec3<double>& p1,
+                   const geom::vec3<double>& p2,
+                   const geom::vec3<double>& p3,
+                   const geom::vec3<double>& p4);
+
+  /// Draw a Bezier curve as a triangle fan around \a center.
+  void drawBezierFill4(Gfx::Canvas& canvas,
+                       const geom::vec3<double>& center,
+                       const geom::vec3<double>& p1,
+                       const geom::vec3<double>& p2,
+                       const geom::vec3<double>& p3,
+                       const geom::vec3<double>& p4);
+
+  /// Draw a NURBS curve as a line strip.
+  void drawNurbsCurve(Gfx::Canvas& canvas, const float* knots,
+                      const geom::vec3<float>* pts, size_t npts);
+
+  /// Forget all cached polylines.
+  void clear();
+
+  /// Counters describing how well curve caches are working.
+  struct Stats
+  {
+    unsigned long hits;     ///< a cached polyline was replayed
+    unsigned long misses;   ///< a curve had to be (re)tessellated
+    unsigned long vertices; ///< vertices generated by tessellation
+  };
+
+  /// Get the counters, summed over all curve caches.
+  static Stats stats();
+
+  /// Reset the counters to zero.
+  static void resetStats();
+
+  /// Globally enable or disable curve caching (enabled by default).
+  /** When disabled, every curve is re-tessellated on every draw (but
+      still adaptively). */
+  static void setCaching(bool on);
+
+  /// Query whether curve caching is enabled.
+  static bool isCaching();
+
+private:
+  CurveCache(const CurveCache&);
+  CurveCache& operator=(const CurveCache&);
+
+  struct Entry;
+
+  Entry& lookup(bool& hit);
+
+  std::vector<Entry> itsEntries;
+  size_t itsCursor;
+  int itsLevel;
+  double itsScale;
+  std::vector<double> itsKey;
+  std::vector<geom::vec3<double> > itsCtrl;
+};
+
+#endif // !GROOVX_GFX_CURVECACHE_H_UTC20261019110237_DEFINED
@@ -0,0 +1,280 @@
+/** @file gfx/eglwrapper.cc GlWindowInterface implementation that renders
+    into an offscreen EGL pbuffer, without any window system */
+
+///////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026-2026 Rob Peters
+// Rob Peters <https://github.com/rjpcal/>
+//
+// created: Mon Oct 19 11:02:17 2026
+//
+// --------------------------------------------------------------------
+//
+// This file is part of GroovX.
+//   [https://github.com/rjpcal/groovx]
+//
+// GroovX is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// GroovX is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GroovX; if not, write to the Free Software Foundation,
+// Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include "gfx/eglwrapper.h"
+
+#include "gfx/glxopts.h"
+
+#include "rutz/error.h"
+#include "rutz/sfmt.h"
+
+#ifdef GVX_HAVE_EGL
+#  include <EGL/egl.h>
+#  include <GL/gl.h>
+#endif
+
+#include "rutz/debug.h"
+GVX_DBG_REGISTER
+#include "rutz/trace.h"
+
+#ifdef GVX_HAVE_EGL
+
+namespace
+{
+  void throwEglError(const char* what, const rutz::file_pos& pos)
+  {
+    throw rutz::error(rutz::sfmt("%s failed (EGL error 0x%x)",
+                                 what, eglGetError()), pos);
+  }
+}
+
+class EglWrapper::Impl
+{
+private:
+  Impl(const Impl&);
+  Impl& operator=(const Impl&);
+
+public:
+  Impl(GlxOpts& opts, int w, int h) :
+    display(EGL_NO_DISPLAY),
+    config(nullptr),
+    surface(EGL_NO_SURFACE),
+    context(EGL_NO_CONTEXT),
+    width(0),
+    height(0)
+  {
+    if (!opts.rgbaFlag)
+      throw rutz::error("offscreen rendering requires RGBA mode", SRC_POS);
+
+    display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+
+    if (display == EGL_NO_DISPLAY)
+      throw rutz::error("couldn't open an EGL display", SRC_POS);
+
+    EGLint major = 0, minor = 0;
+    if (eglInitialize(display, &major, &minor) != EGL_TRUE)
+      throwEglError("eglInitialize", SRC_POS);
+
+    dbg_eval(3, major); dbg_eval_nl(3, minor);
+
+    try
+      {
+        const EGLint attribs[] =
+          {
+            EGL_SURFACE_TYPE,    EGL_PBUFFER_BIT,
+            EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+            EGL_RED_SIZE,        opts.rgbaRed,
+            EGL_GREEN_SIZE,      opts.rgbaGreen,
+            EGL_BLUE_SIZE,       opts.rgbaBlue,
+            EGL_ALPHA_SIZE,      opts.alphaFlag ? opts.alphaSize : 0,
+            EGL_DEPTH_SIZE,      opts.depthFlag ? opts.depthSize : 0,
+            EGL_STENCIL_SIZE,    opts.stencilFlag ? opts.stencilSize : 0,
+            EGL_NONE
+          };
+
+        EGLint nconfigs = 0;
+        if (eglChooseConfig(display, attribs, &config, 1, &nconfigs) != EGL_TRUE)
+          throwEglError("eglChooseConfig", SRC_POS);
+
+        if (nconfigs < 1)
+          throw rutz::error("couldn't find a matching EGL pbuffer config",
+                            SRC_POS);
+
+        if (eglBindAPI(EGL_OPENGL_API) != EGL_TRUE)
+          throwEglError("eglBindAPI", SRC_POS);
+
+        context = eglCreateContext(display, config, EGL_NO_CONTEXT, nullptr);
+
+        if (context == EGL_NO_CONTEXT)
+          throwEglError("eglCreateContext", SRC_POS);
+
+        resize(w, h);
+      }
+    catch (...)
+      {
+        release();
+        throw;
+      }
+  }
+
+  ~Impl() { release(); }
+
+  void release() noexcept
+  {
+    eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    if (surface != EGL_NO_SURFACE) eglDestroySurface(display, surface);
+    if (context != EGL_NO_CONTEXT) eglDestroyContext(display, context);
+    surface = EGL_NO_SURFACE;
+    context = EGL_NO_CONTEXT;
+    // NOTE: we don't eglTerminate() the display, since it is shared by
+    // every EglWrapper in the process.
+  }
+
+  void resize(int w, int h)
+  {
+    if (w < 1 || h < 1)
+      throw rutz::error(rutz::sfmt("invalid pbuffer size %dx%d", w, h),
+                        SRC_POS);
+
+    if (w == width && h == height && surface != EGL_NO_SURFACE)
+      return;
+
+    const EGLint attribs[] =
+      {
+        EGL_WIDTH,  w,
+        EGL_HEIGHT, h,
+        EGL_NONE
+      };
+
+    EGLSurface s = eglCreatePbufferSurface(display, config, attribs);
+
+    if (s == EGL_NO_SURFACE)
+      throwEglError("eglCreatePbufferSurface", SRC_POS);
+
+    if (surface != EGL_NO_SURFACE)
+      {
+        eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE,
+                       EGL_NO_CONTEXT);
+        eglDestroySurface(display, surface);
+      }
+
+    surface = s;
+    width = w;
+    height = h;
+  }
+
+  void makeCurrent()
+  {
+    // Ask EGL rather than caching, since the pbuffer may have been
+    // re-allocated since we were last made current.
+    if (eglGetCurrentContext() == context
+        && eglGetCurrentSurface(EGL_DRAW) == surface)
+      return;
+
+    if (eglMakeCurrent(display, surface, surface, context) != EGL_TRUE)
+      throwEglError("eglMakeCurrent", SRC_POS);
+  }
+
+  unsigned int bitsPerPixel() const
+  {
+    EGLint bits = 0;
+    eglGetConfigAttrib(display, config, EGL_BUFFER_SIZE, &bits);
+    return (unsigned int)(bits);
+  }
+
+  EGLDisplay display;
+  EGLConfig config;
+  EGLSurface surface;
+  EGLContext context;
+  int width;
+  int height;
+};
+
+#else // !GVX_HAVE_EGL
+
+class EglWrapper::Impl
+{
+public:
+  Impl(GlxOpts&, int, int)
+  {
+    throw rutz::error("offscreen rendering requires EGL, "
+                      "but GroovX was built without it", SRC_POS);
+  }
+
+  void resize(int, int) {}
+  void makeCurrent() {}
+  unsigned int bitsPerPixel() const { return 0; }
+
+  int width = 0;
+  int height = 0;
+};
+
+#endif // GVX_HAVE_EGL
+
+EglWrapper::EglWrapper(GlxOpts& opts, int width, int height) :
+  rep(new Impl(opts, width, height))
+{
+GVX_TRACE("EglWrapper::EglWrapper");
+}
+
+EglWrapper::~EglWrapper()
+{
+GVX_TRACE("EglWrapper::~EglWrapper");
+
+  delete rep;
+}
+
+EglWrapper* EglWrapper::make(GlxOpts& opts, int width, int height)
+{
+GVX_TRACE("EglWrapper::make");
+
+  opts.doubleFlag = false;
+  opts.indirect = false;
+
+  return new EglWrapper(opts, width, height);
+}
+
+unsigned int EglWrapper::bitsPerPixel() const
+{
+GVX_TRACE("EglWrapper::bitsPerPixel");
+  return rep->bitsPerPixel();
+}
+
+void EglWrapper::makeCurrent()
+{
+GVX_TRACE("EglWrapper::makeCurrent");
+
+  rep->makeCurrent();
+}
+
+void EglWrapper::onReshape(int width, int height)
+{
+GVX_TRACE("EglWrapper::onReshape");
+
+  rep->resize(width, height);
+}
+
+void EglWrapper::swapBuffers() const
+{
+#ifdef GVX_HAVE_EGL
+  glFlush();
+#endif
+}
+
+int EglWrapper::width() const
+{
+  return rep->width;
+}
+
+int EglWrapper::height() const
+{
+  return rep->height;
+}
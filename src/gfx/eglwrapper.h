@@ -0,0 +1,91 @@
+/** @file gfx/eglwrapper.h GlWindowInterface implementation that renders
+    into an offscreen EGL pbuffer, without any window system */
+
+///////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026-2026 Rob Peters
+// Rob Peters <https://github.com/rjpcal/>
+//
+// created: Mon Oct 19 11:02:17 2026
+//
+// --------------------------------------------------------------------
+//
+// This file is part of GroovX.
+//   [https://github.com/rjpcal/groovx]
+//
+// GroovX is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// GroovX is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GroovX; if not, write to the Free Software Foundation,
+// Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef GROOVX_GFX_EGLWRAPPER_H_UTC20261019110217_DEFINED
+#define GROOVX_GFX_EGLWRAPPER_H_UTC20261019110217_DEFINED
+
+#include "gfx/glwindowinterface.h"
+
+struct GlxOpts;
+
+/// Wraps an EGL pbuffer surface and its rendering context.
+/** This lets a GLCanvas be used without any X display, e.g. for batch
+    rendering of stimuli on a headless machine. Under Mesa, setting
+    EGL_PLATFORM=surfaceless in the environment gives a display that
+    needs neither X nor a GPU. If GroovX was built without EGL,
+    make() throws an exception. */
+class EglWrapper : public GlWindowInterface
+{
+private:
+  class Impl;
+  Impl* rep;
+
+  EglWrapper(const EglWrapper&);
+  EglWrapper& operator=(const EglWrapper&);
+
+  /// Construct.
+  EglWrapper(GlxOpts& opts, int width, int height);
+
+public:
+  /// Factory function.
+  /** The pbuffer is always single-buffered, so opts.doubleFlag is
+      reset to false. */
+  static EglWrapper* make(GlxOpts& opts, int width, int height);
+
+  /// Destructor.
+  virtual ~EglWrapper();
+
+  /// Query whether rendering context has direct access to the hardware.
+  virtual bool isDirect() const override { return true; }
+
+  /// Query whether the rendering context is double-buffered.
+  virtual bool isDoubleBuffered() const override { return false; }
+
+  /// Get the bit depth of the draw buffer(s).
+  virtual unsigned int bitsPerPixel() const override;
+
+  /// Make our rendering context the current active one.
+  virtual void makeCurrent() override;
+
+  /// Re-allocate the pbuffer surface if its size has changed.
+  virtual void onReshape(int width, int height) override;
+
+  /// Flush pending GL commands (there is no back buffer to swap).
+  virtual void swapBuffers() const override;
+
+  /// Get the width of the pbuffer surface.
+  int width() const;
+
+  /// Get the height of the pbuffer surface.
+  int height() const;
+};
+
+#endif // !GROOVX_GFX_EGLWRAPPER_H_UTC20261019110217_DEFINED
@@ -0,0 +1,178 @@
+/** @file gfx/framelog.cc ring buffer of per-frame render, swap and
+    present timestamps */
+
+///////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026-2026 Rob Peters
+// Rob Peters <https://github.com/rjpcal/>
+//
+// created: Mon Oct 19 16:20:37 2026
+//
+// --------------------------------------------------------------------
+//
+// This file is part of GroovX.
+//   [https://github.com/rjpcal/groovx]
+//
+// GroovX is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// GroovX is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GroovX; if not, write to the Free Software Foundation,
+// Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include "gfx/framelog.h"
+
+#include "rutz/error.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <ostream>
+
+#include "rutz/trace.h"
+
+namespace
+{
+  // Marker for timestamps that haven't been taken yet.
+  const double UNMARKED = -1.0;
+}
+
+Gfx::FrameLog::FrameLog() :
+  itsRing(),
+  itsHead(0),
+  itsCount(0),
+  itsTotal(0),
+  isItWaiting(false),
+  isItOpen(false),
+  itsFrame(),
+  itsClock()
+{}
+
+void Gfx::FrameLog::setCapacity(size_t n)
+{
+GVX_TRACE("Gfx::FrameLog::setCapacity");
+  std::vector<Times>(n).swap(itsRing);
+  clear();
+}
+
+void Gfx::FrameLog::clear()
+{
+GVX_TRACE("Gfx::FrameLog::clear");
+  itsHead = 0;
+  itsCount = 0;
+  itsTotal = 0;
+  isItOpen = false;
+  itsClock.restart();
+}
+
+const Gfx::FrameLog::Times& Gfx::FrameLog::at(size_t i) const
+{
+  if (i >= itsCount)
+    throw rutz::error("frame log index out of range", SRC_POS);
+
+  return itsRing[(itsHead + itsRing.size() - itsCount + i) % itsRing.size()];
+}
+
+void Gfx::FrameLog::openFrame()
+{
+  itsFrame.start = now();
+  itsFrame.rendered = UNMARKED;
+  itsFrame.swapped = UNMARKED;
+  itsFrame.presented = UNMARKED;
+  isItOpen = true;
+}
+
+void Gfx::FrameLog::commit()
+{
+GVX_TRACE("Gfx::FrameLog::commit");
+
+  if (!isEnabled())
+    return;
+
+  if (!isItOpen)
+    openFrame();
+
+  Times& f = itsFrame;
+  if (f.rendered == UNMARKED)  f.rendered = f.start;
+  if (f.swapped == UNMARKED)   f.swapped = f.rendered;
+  if (f.presented == UNMARKED) f.presented = f.swapped;
+
+  itsRing[itsHead] = f;
+  itsHead = (itsHead + 1) % itsRing.size();
+  if (itsCount < itsRing.size())
+    ++itsCount;
+  ++itsTotal;
+
+  isItOpen = false;
+}
+
+Gfx::FrameLog::Stats Gfx::FrameLog::stats() const
+{
+GVX_TRACE("Gfx::FrameLog::stats");
+
+  Stats s = Stats();
+  s.frames = itsTotal;
+  s.held = itsCount;
+
+  if (itsCount == 0)
+    return s;
+
+  for (size_t i = 0; i < itsCount; ++i)
+    {
+      const double r = at(i).rendered - at(i).start;
+      s.meanRender += r;
+      s.maxRender = std::max(s.maxRender, r);
+    }
+  s.meanRender /= double(itsCount);
+
+  if (itsCount < 2)
+    return s;
+
+  const size_t nint = itsCount - 1;
+
+  for (size_t i = 1; i < itsCount; ++i)
+    {
+      const double d = at(i).presented - at(i-1).presented;
+      s.meanInterval += d;
+      s.maxInterval = std::max(s.maxInterval, d);
+    }
+  s.meanInterval /= double(nint);
+
+  for (size_t i = 1; i < itsCount; ++i)
+    {
+      const double d =
+        at(i).presented - at(i-1).presented - s.meanInterval;
+      s.sdInterval += d*d;
+    }
+  s.sdInterval = std::sqrt(s.sdInterval / double(nint));
+
+  return s;
+}
+
+void Gfx::FrameLog::writeMtx(std::ostream& os) const
+{
+GVX_TRACE("Gfx::FrameLog::writeMtx");
+
+  const int precision = 3;
+
+  os << "mrows " << itsCount << " ncols 4";
+  for (size_t i = 0; i < itsCount; ++i)
+    {
+      const Times& f = at(i);
+      const double cols[4] = { f.start, f.rendered, f.swapped, f.presented };
+      os << '\n';
+      for (double c: cols)
+        os << ' ' << std::setw(precision+8) << std::fixed
+           << std::setprecision(precision) << c;
+    }
+  os << '\n';
+}
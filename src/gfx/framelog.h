@@ -0,0 +1,164 @@
+/** @file gfx/framelog.h ring buffer of per-frame render, swap and
+    present timestamps */
+
+///////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026-2026 Rob Peters
+// Rob Peters <https://github.com/rjpcal/>
+//
+// created: Mon Oct 19 16:20:37 2026
+//
+// --------------------------------------------------------------------
+//
+// This file is part of GroovX.
+//   [https://github.com/rjpcal/groovx]
+//
+// GroovX is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// GroovX is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GroovX; if not, write to the Free Software Foundation,
+// Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef GROOVX_GFX_FRAMELOG_H_UTC20261019162037_DEFINED
+#define GROOVX_GFX_FRAMELOG_H_UTC20261019162037_DEFINED
+
+#include "rutz/stopwatch.h"
+
+#include <cstddef>
+#include <iosfwd>
+#include <vector>
+
+namespace Gfx
+{
+  class FrameLog;
+}
+
+///////////////////////////////////////////////////////////////////////
+/**
+ *
+ * Gfx::FrameLog is a fixed-size ring buffer of per-frame timestamps,
+ * filled in by GxScene as it draws and presents frames. For each
+ * frame it holds the time at which rendering started, the time at
+ * which rendering was done, the time at which the buffer swap (or
+ * flush) returned, and an estimate of the time at which the frame
+ * actually reached the screen. The present time can only be observed
+ * by blocking until the swap has completed (with glFinish(), through
+ * Canvas::finishDrawing()), which stalls the pipeline; so that is
+ * only done if setWaitForPresent() is on, and otherwise the swap time
+ * is used as the estimate.
+ *
+ * All times are in milliseconds since the log was last cleared. When
+ * the buffer is full, the oldest frames are overwritten. Logging is
+ * off (capacity zero) by default.
+ *
+ **/
+///////////////////////////////////////////////////////////////////////
+
+class Gfx::FrameLog
+{
+public:
+  /// Timestamps for one frame, in msec since the log was cleared.
+  struct Times
+  {
+    double start;     ///< rendering started
+    double rendered;  ///< rendering done, before the swap
+    double swapped;   ///< buffer swap or flush returned
+    double presented; ///< frame reached the screen (estimated)
+  };
+
+  /// Summary statistics over the frames currently held.
+  struct Stats
+  {
+    unsigned long frames;  ///< all frames logged since the last clear()
+    unsigned long held;    ///< frames still held in the ring buffer
+    double meanRender;     ///< mean of (rendered - start)
+    double maxRender;      ///< max of (rendered - start)
+    double meanInterval;   ///< mean interval between presents
+    double maxInterval;    ///< max interval between presents
+    double sdInterval;     ///< standard deviation of present intervals
+  };
+
+  /// Construct a disabled log.
+  FrameLog();
+
+  /// Hold up to \a n frames; zero turns logging off.
+  /** Any frames already held are discarded. */
+  void setCapacity(size_t n);
+
+  /// Get the maximum number of frames held.
+  size_t capacity() const { return itsRing.size(); }
+
+  /// Query whether frames are being logged.
+  bool isEnabled() const { return !itsRing.empty(); }
+
+  /// Whether to block until each frame has been presented.
+  void setWaitForPresent(bool val) { isItWaiting = val; }
+
+  /// Query whether to block until each frame has been presented.
+  bool isWaitingForPresent() const { return isItWaiting; }
+
+  /// Forget all frames, and restart the clock.
+  void clear();
+
+  /// Get the number of frames held.
+  size_t size() const { return itsCount; }
+
+  /// Get the number of frames logged since the last clear().
+  unsigned long numFrames() const { return itsTotal; }
+
+  /// Get the i'th frame held, counting from the oldest.
+  const Times& at(size_t i) const;
+
+  /// Note the start of rendering, unless a frame is already open.
+  void markStart() { if (isEnabled() && !isItOpen) openFrame(); }
+
+  /// Note that rendering is done.
+  void markRendered() { if (isEnabled()) itsFrame.rendered = now(); }
+
+  /// Note that the swap or flush has returned.
+  void markSwapped() { if (isEnabled()) itsFrame.swapped = now(); }
+
+  /// Note that the frame is known to be on screen.
+  void markPresented() { if (isEnabled()) itsFrame.presented = now(); }
+
+  /// Close the open frame and add it to the ring buffer.
+  /** Any of the frame's timestamps that weren't marked are copied
+      from the one before. */
+  void commit();
+
+  /// Compute summary statistics over the frames held.
+  Stats stats() const;
+
+  /// Write the frames held, oldest first, as a text matrix.
+  /** The format is that of mtx::print() (an "mrows N ncols 4" header
+      followed by one row per frame, with columns start, rendered,
+      swapped, presented), so the result can be read back with
+      mtx::scan(). */
+  void writeMtx(std::ostream& os) const;
+
+private:
+  double now() const { return itsClock.elapsed().msec(); }
+
+  void openFrame();
+
+  std::vector<Times> itsRing;
+  size_t itsHead;           // where the next frame goes
+  size_t itsCount;
+  unsigned long itsTotal;
+  bool isItWaiting;
+  bool isItOpen;
+  Times itsFrame;
+  rutz::stopwatch itsClock;
+};
+
+#endif // !GROOVX_GFX_FRAMELOG_H_UTC20261019162037_DEFINED
@@ -42,8 +42,10 @@
 #include "geom/vec2.h"
 #include "geom/vec3.h"
 
+#include "gfx/curvecache.h"
 #include "gfx/glwindowinterface.h"
 #include "gfx/glxopts.h"
+#include "gfx/glyphatlas.h"
 #include "gfx/gxrasterfont.h"
 #include "gfx/gxvectorfont.h"
 #include "gfx/rgbacolor.h"
@@ -53,6 +55,7 @@
 #include "rutz/error.h"
 #include "rutz/sfmt.h"
 
+#include <cmath>
 #include <memory>
 #include <vector>
 
@@ -167,6 +170,37 @@ namespace
 
     return screen_pos;
   }
+
+  media::bmap_data readPixels(const recti& bounds, bool rgba, GLenum buf)
+  {
+    const int pixel_alignment = 1;
+
+    // NOTE: we can't just use GLCanvas::bitsPerPixel() here, since that
+    // won't work in the case of a 16-bit color buffer; in that case, we
+    // are still in RGBA mode, so glReadPixels() will return one byte
+    // per color component (i.e. 24 bits per pixel) regardless of the
+    // actual color buffer depth.
+    const unsigned int bmap_bits_per_pixel = rgba ? 24 : 8;
+
+    media::bmap_data result(vec2st(bounds.size()),
+                            bmap_bits_per_pixel, pixel_alignment);
+
+    glPixelStorei(GL_PACK_ALIGNMENT, pixel_alignment);
+
+    glPushAttrib(GL_PIXEL_MODE_BIT);
+    {
+      glReadBuffer(buf);
+      glReadPixels(bounds.left(), bounds.bottom(),
+                   bounds.width(), bounds.height(),
+                   (rgba ? GL_RGB : GL_COLOR_INDEX),
+                   GL_UNSIGNED_BYTE, result.bytes_ptr());
+    }
+    glPopAttrib();
+
+    result.specify_row_order(media::bmap_data::row_order::BOTTOM_FIRST);
+
+    return result;
+  }
 }
 
 class GLCanvas::Impl
@@ -298,6 +332,12 @@ GVX_TRACE("GLCanvas::drawBufferBack");
   glDrawBuffer(GL_BACK);
 }
 
+bool GLCanvas::setSwapInterval(int interval)
+{
+GVX_TRACE("GLCanvas::setSwapInterval");
+  return rep->glx->setSwapInterval(interval);
+}
+
 vec3d GLCanvas::screenFromWorld3(const vec3d& world_pos) const
 {
 GVX_TRACE("GLCanvas::screenFromWorld3");
@@ -543,6 +583,20 @@ GVX_TRACE("GLCanvas::enableAntialiasing");
     }
 }
 
+void GLCanvas::setScissor(const recti& screen_rect)
+{
+GVX_TRACE("GLCanvas::setScissor");
+  glEnable(GL_SCISSOR_TEST);
+  glScissor(screen_rect.left(), screen_rect.bottom(),
+            screen_rect.width(), screen_rect.height());
+}
+
+void GLCanvas::disableScissor()
+{
+GVX_TRACE("GLCanvas::disableScissor");
+  glDisable(GL_SCISSOR_TEST);
+}
+
 
 
 void GLCanvas::viewport(int x, int y, int w, int h)
@@ -836,33 +890,23 @@ media::bmap_data GLCanvas::grabPixels(const recti& bounds)
 {
 GVX_TRACE("GLCanvas::grabPixels");
 
-  const int pixel_alignment = 1;
-
-  // NOTE: we can't just use GLCanvas::bitsPerPixel() here, since that
-  // won't work in the case of a 16-bit color buffer; in that case, we
-  // are still in RGBA mode, so glReadPixels() will return one byte
-  // per color component (i.e. 24 bits per pixel) regardless of the
-  // actual color buffer depth.
-  const unsigned int bmap_bits_per_pixel = isRgba() ? 24 : 8;
+  // A single-buffered context may still be drawing into GL_BACK
+  // (e.g. an offscreen pbuffer has no front buffer at all), so in
+  // that case read from wherever we are currently drawing.
+  if (!rep->glx->isDoubleBuffered())
+    return grabDrawnPixels(bounds);
 
-  media::bmap_data result(vec2st(bounds.size()),
-                          bmap_bits_per_pixel, pixel_alignment);
-
-  glPixelStorei(GL_PACK_ALIGNMENT, pixel_alignment);
+  return readPixels(bounds, isRgba(), GL_FRONT);
+}
 
-  glPushAttrib(GL_PIXEL_MODE_BIT);
-  {
-    glReadBuffer(GL_FRONT);
-    glReadPixels(bounds.left(), bounds.bottom(),
-                 bounds.width(), bounds.height(),
-                 (isRgba() ? GL_RGB : GL_COLOR_INDEX),
-                 GL_UNSIGNED_BYTE, result.bytes_ptr());
-  }
-  glPopAttrib();
+media::bmap_data GLCanvas::grabDrawnPixels(const recti& bounds)
+{
+GVX_TRACE("GLCanvas::grabDrawnPixels");
 
-  result.specify_row_order(media::bmap_data::row_order::BOTTOM_FIRST);
+  GLint draw_buf = GL_BACK;
+  glGetIntegerv(GL_DRAW_BUFFER, &draw_buf);
 
-  return result;
+  return readPixels(bounds, isRgba(), GLenum(draw_buf));
 }
 
 void GLCanvas::clearColorBuffer()
@@ -988,6 +1032,11 @@ GVX_TRACE("GLCanvas::drawBezierFill4");
 #if 0
   Canvas::drawBezierFill4(center, p1, p2, p3, p4, subdivisions);
 #else
+  if (subdivisions == 0)
+    subdivisions = Gfx::bezierSegments(p1, p2, p3, p4,
+                                       Gfx::pixelsPerUnit(*this),
+                                       Gfx::curveTolerance());
+
   vec3d points[] =
   {
     p1, p2, p3, p4
@@ -1061,11 +1110,103 @@ GVX_TRACE("GLCanvas::end");
   glEnd();
 }
 
+void GLCanvas::drawArrays(VertexStyle s, const vec3d* pts,
+                          const vec3d* normals, size_t n)
+{
+GVX_TRACE("GLCanvas::drawArrays");
+
+  static_assert(sizeof(vec3d) == 3*sizeof(double),
+                "vec3d must be tightly packed for glVertexPointer()");
+
+  GLenum mode = GL_POINTS;
+  switch (s)
+    {
+    case VertexStyle::POINTS:         mode = GL_POINTS; break;
+    case VertexStyle::LINES:          mode = GL_LINES; break;
+    case VertexStyle::LINE_STRIP:     mode = GL_LINE_STRIP; break;
+    case VertexStyle::LINE_LOOP:      mode = GL_LINE_LOOP; break;
+    case VertexStyle::TRIANGLES:      mode = GL_TRIANGLES; break;
+    case VertexStyle::TRIANGLE_STRIP: mode = GL_TRIANGLE_STRIP; break;
+    case VertexStyle::TRIANGLE_FAN:   mode = GL_TRIANGLE_FAN; break;
+    case VertexStyle::QUADS:          mode = GL_QUADS; break;
+    case VertexStyle::QUAD_STRIP:     mode = GL_QUAD_STRIP; break;
+    case VertexStyle::POLYGON:        mode = GL_POLYGON; break;
+    }
+
+  glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
+
+  glEnableClientState(GL_VERTEX_ARRAY);
+  glVertexPointer(3, GL_DOUBLE, 0, pts);
+
+  if (normals != nullptr)
+    {
+      glEnableClientState(GL_NORMAL_ARRAY);
+      glNormalPointer(GL_DOUBLE, 0, normals);
+    }
+
+  glDrawArrays(mode, 0, GLsizei(n));
+
+  glPopClientAttrib();
+}
+
 void GLCanvas::drawRasterText(const rutz::fstring& text,
                               const GxRasterFont& font)
 {
 GVX_TRACE("GLCanvas::drawRasterText");
 
+  if (const Gfx::GlyphAtlas* atlas = font.glyphAtlas())
+    {
+      // Draw the whole string as one array of textured quads, in
+      // window coordinates anchored at the current raster position.
+      const Gfx::GlyphAtlas::Layout& layout = atlas->layout(text.c_str());
+
+      if (layout.verts.empty())
+        return;
+
+      const vec3d origin = screenFromWorld3(vec3d::zeros());
+      const recti viewport = getScreenViewport();
+
+      glPushAttrib(GL_ENABLE_BIT | GL_TEXTURE_BIT | GL_COLOR_BUFFER_BIT);
+      glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
+
+      glMatrixMode(GL_PROJECTION);
+      glPushMatrix();
+      glLoadIdentity();
+      glOrtho(viewport.left(), viewport.right(),
+              viewport.bottom(), viewport.top(), -1.0, 1.0);
+
+      glMatrixMode(GL_MODELVIEW);
+      glPushMatrix();
+      glLoadIdentity();
+      glTranslated(std::floor(origin.x()), std::floor(origin.y()), 0.0);
+
+      glDisable(GL_DEPTH_TEST);
+      glDisable(GL_LIGHTING);
+      glEnable(GL_TEXTURE_2D);
+      atlas->bindTexture();
+      glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
+
+      // glBitmap() draws only the set bits, so we do likewise
+      glEnable(GL_ALPHA_TEST);
+      glAlphaFunc(GL_GREATER, 0.5f);
+
+      glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+      glEnableClientState(GL_VERTEX_ARRAY);
+      glTexCoordPointer(2, GL_FLOAT, 4*sizeof(float), &layout.verts[0]);
+      glVertexPointer(2, GL_FLOAT, 4*sizeof(float), &layout.verts[2]);
+      glDrawArrays(GL_QUADS, 0, GLsizei(layout.verts.size() / 4));
+
+      glPopMatrix();
+      glMatrixMode(GL_PROJECTION);
+      glPopMatrix();
+      glMatrixMode(GL_MODELVIEW);
+
+      glPopClientAttrib();
+      glPopAttrib();
+
+      return;
+    }
+
   glListBase( font.listBase() );
 
   const char* p = text.c_str();
@@ -1110,42 +1251,18 @@ void GLCanvas::drawVectorText(const rutz::fstring& text,
 {
 GVX_TRACE("GLCanvas::drawVectorText");
 
-  glListBase( font.listBase() );
-
-  const char* p = text.c_str();
+  // All of the strokes go out in one GL_LINES array, rather than one
+  // display list call per glyph.
+  const std::vector<float>& segs = font.segmentsOf(text.c_str());
 
-  glMatrixMode(GL_MODELVIEW);
+  if (segs.empty())
+    return;
 
-  int line = 0;
-
-  while (1)
-    {
-      int len = 0;
-      while (p[len] != '\0' && p[len] != '\n')
-        ++len;
-
-      dbg_eval(3, len); dbg_eval_nl(3, p);
-
-      glPushMatrix();
-
-      if (line > 0)
-        glTranslated( 0.0,
-                      -1.0 * font.vectorHeight() * line,
-                      0.0 );
-
-      glCallLists( len, GL_BYTE, p );
-      glPopMatrix();
-
-      p += len;
-
-      if (*p == '\0')
-        break;
-
-      // else...
-      GVX_ASSERT(*p == '\n');
-      ++p;
-      ++line;
-    }
+  glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
+  glEnableClientState(GL_VERTEX_ARRAY);
+  glVertexPointer(2, GL_FLOAT, 0, &segs[0]);
+  glDrawArrays(GL_LINES, 0, GLsizei(segs.size() / 2));
+  glPopClientAttrib();
 }
 
 void GLCanvas::flushOutput()
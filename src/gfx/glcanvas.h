@@ -64,6 +64,11 @@ public:
   void drawBufferFront() noexcept;
   void drawBufferBack() noexcept;
 
+  /// Ask for buffer swaps to wait for \a interval vertical retraces.
+  /** Returns false if the window system doesn't support this (see
+      GlWindowInterface::setSwapInterval()). */
+  bool setSwapInterval(int interval);
+
   virtual geom::vec3<double> screenFromWorld3(const geom::vec3<double>& world_pos) const override;
   virtual geom::vec3<double> worldFromScreen3(const geom::vec3<double>& screen_pos) const override;
 
@@ -103,6 +108,9 @@ public:
 
   virtual void enableAntialiasing() override;
 
+  virtual void setScissor(const geom::rect<int>& screen_rect) override;
+  virtual void disableScissor() override;
+
 
 
   virtual void viewport(int x, int y, int w, int h) override;
@@ -138,6 +146,7 @@ public:
                           const geom::vec3<double>& world_pos) override;
 
   virtual media::bmap_data grabPixels(const geom::rect<int>& bounds) override;
+  virtual media::bmap_data grabDrawnPixels(const geom::rect<int>& bounds) override;
 
   virtual void clearColorBuffer() override;
   virtual void clearColorBuffer(const geom::rect<int>& screen_rect) override;
@@ -183,6 +192,11 @@ public:
 
   virtual void end() override;
 
+  virtual void drawArrays(VertexStyle s,
+                          const geom::vec3<double>* pts,
+                          const geom::vec3<double>* normals,
+                          size_t n) override;
+
   virtual void drawRasterText(const rutz::fstring& text,
                               const GxRasterFont& font) override;
   virtual void drawVectorText(const rutz::fstring& text,
@@ -37,3 +37,9 @@ GlWindowInterface::~GlWindowInterface()
 {
 GVX_TRACE("GlWindowInterface::~GlWindowInterface");
 }
+
+bool GlWindowInterface::setSwapInterval(int /*interval*/)
+{
+GVX_TRACE("GlWindowInterface::setSwapInterval");
+  return false;
+}
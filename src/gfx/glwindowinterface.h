@@ -61,6 +61,12 @@ public:
 
   /// Swaps buffers if in double-buffering mode.
   virtual void swapBuffers() const = 0;
+
+  /// Ask for buffer swaps to wait for \a interval vertical retraces.
+  /** An interval of 0 turns off synchronization with the vertical
+      retrace. Returns false if the window system has no way to set
+      the swap interval. The default version just returns false. */
+  virtual bool setSwapInterval(int interval);
 };
 
 #endif // !GROOVX_GFX_GLWINDOWINTERFACE_H_UTC20050626084024_DEFINED
@@ -38,16 +38,21 @@
 #include "gfx/bbox.h"
 #include "gfx/fontspec.h"
 #include "gfx/glcanvas.h"
+#include "gfx/glyphatlas.h"
 #include "gfx/gxrasterfont.h"
+#include "gfx/textcache.h"
 
 #include "rutz/error.h"
 #include "rutz/fstring.h"
 #include "rutz/sfmt.h"
 
+#include <algorithm>
 #include <cctype>
 #include <cstdio>
 #include <cstdlib> // for getenv()
 #include <cstring>
+#include <memory>
+#include <vector>
 #include <GL/gl.h>
 #include <GL/glx.h>
 #include <X11/Xlib.h>
@@ -75,18 +80,28 @@ public:
   /// Return the line height of the font in screen coords (i.e., pixels)
   virtual int rasterHeight() const override;
 
+  /// Get the X font's glyph bitmaps packed into an atlas.
+  /** The bitmaps are fetched from the X server on first use. */
+  virtual const Gfx::GlyphAtlas* glyphAtlas() const override;
+
 private:
+  Display* itsDisplay;
   XFontStruct* itsFontInfo;
   rutz::fstring itsFontName;
   unsigned int itsListBase;
   unsigned int itsListCount;
+  mutable std::unique_ptr<Gfx::GlyphAtlas> itsAtlas;
+  mutable Gfx::TextCache<geom::rect<int> > itsBboxCache;
 };
 
 GlxRasterFont::GlxRasterFont(const char* fontname) :
+  itsDisplay(nullptr),
   itsFontInfo(nullptr),
   itsFontName(fontname ? fontname : "fixed"),
   itsListBase(0),
-  itsListCount(0)
+  itsListCount(0),
+  itsAtlas(),
+  itsBboxCache()
 {
 GVX_TRACE("GlxRasterFont::GlxRasterFont");
 
@@ -99,6 +114,8 @@ GVX_TRACE("GlxRasterFont::GlxRasterFont");
         throw rutz::error("couldn't open X server connection", SRC_POS);
     }
 
+  itsDisplay = dpy;
+
   rutz::fstring xname = pickXFont(fontname);
 
   dbg_eval_nl(2, xname.c_str());
@@ -255,6 +272,14 @@ void GlxRasterFont::bboxOf(const char* text, Gfx::Bbox& bbox) const
 {
 GVX_TRACE("GlxRasterFont::bboxOf");
 
+  if (const geom::rect<int>* cached = itsBboxCache.find(text))
+    {
+      bbox.drawScreenRect(geom::vec3d::zeros(), *cached);
+      return;
+    }
+
+  const char* const start = text;
+
   const int asc = itsFontInfo->max_bounds.ascent;
   const int desc = itsFontInfo->max_bounds.descent;
 
@@ -299,7 +324,8 @@ GVX_TRACE("GlxRasterFont::bboxOf");
   GVX_ASSERT(t >= 0);
 
   bbox.drawScreenRect(geom::vec3d::zeros(),
-                      geom::rect<int>::ltrb(l,t,r,b));
+                      itsBboxCache.insert(start,
+                                          geom::rect<int>::ltrb(l,t,r,b)));
 }
 
 void GlxRasterFont::drawText(const char* text,
@@ -319,4 +345,90 @@ GVX_TRACE("GlxRasterFont::rasterHeight");
   return asc + desc;
 }
 
+const Gfx::GlyphAtlas* GlxRasterFont::glyphAtlas() const
+{
+GVX_TRACE("GlxRasterFont::glyphAtlas");
+
+  if (itsAtlas.get() != nullptr)
+    return itsAtlas.get();
+
+  const XFontStruct* const info = itsFontInfo;
+
+  // only single-byte fonts are supported, same as our display lists
+  if (info->min_byte1 != 0 || info->max_byte1 != 0)
+    return nullptr;
+
+  const unsigned int first = info->min_char_or_byte2;
+  const unsigned int last = std::min(info->max_char_or_byte2, 255u);
+
+  std::unique_ptr<Gfx::GlyphAtlas> atlas(new Gfx::GlyphAtlas(rasterHeight()));
+
+  // We draw each glyph into a 1-bit pixmap and read it back; this
+  // gives the same bitmaps (with the same origins and advances) as
+  // glXUseXFont().
+  const int pw = std::max(1, info->max_bounds.rbearing - info->min_bounds.lbearing);
+  const int ph = std::max(1, info->max_bounds.ascent + info->max_bounds.descent);
+
+  Pixmap pixmap = XCreatePixmap(itsDisplay, DefaultRootWindow(itsDisplay),
+                                (unsigned int)(pw), (unsigned int)(ph), 1);
+  GC gc = XCreateGC(itsDisplay, pixmap, 0, nullptr);
+  XSetFont(itsDisplay, gc, info->fid);
+
+  std::vector<unsigned char> bits;
+
+  for (unsigned int c = first; c <= last; ++c)
+    {
+      const XCharStruct* cs = (info->per_char != nullptr)
+        ? &info->per_char[c - first]
+        : &info->max_bounds;
+
+      // an all-zero XCharStruct marks a nonexistent glyph
+      if (cs->width == 0 && cs->lbearing == 0 && cs->rbearing == 0
+          && cs->ascent == 0 && cs->descent == 0)
+        continue;
+
+      const int w = std::max(0, cs->rbearing - cs->lbearing);
+      const int h = std::max(0, cs->ascent + cs->descent);
+
+      bits.assign(size_t(w) * size_t(h), 0);
+
+      if (w > 0 && h > 0)
+        {
+          XSetForeground(itsDisplay, gc, 0);
+          XFillRectangle(itsDisplay, pixmap, gc, 0, 0,
+                         (unsigned int)(pw), (unsigned int)(ph));
+          XSetForeground(itsDisplay, gc, 1);
+
+          const char ch = char(c);
+          XDrawString(itsDisplay, pixmap, gc,
+                      -cs->lbearing, cs->ascent, &ch, 1);
+
+          XImage* img = XGetImage(itsDisplay, pixmap, 0, 0,
+                                  (unsigned int)(w), (unsigned int)(h),
+                                  1, XYPixmap);
+          if (img == nullptr)
+            continue;
+
+          // XImage rows are top first; the atlas wants bottom first
+          for (int y = 0; y < h; ++y)
+            for (int x = 0; x < w; ++x)
+              bits[size_t((h-1-y)*w + x)] =
+                XGetPixel(img, x, y) ? 1 : 0;
+
+          XDestroyImage(img);
+        }
+
+      atlas->addGlyph((unsigned char)(c), w, h,
+                      -cs->lbearing, cs->descent, cs->width,
+                      bits.empty() ? nullptr : &bits[0]);
+    }
+
+  XFreeGC(itsDisplay, gc);
+  XFreePixmap(itsDisplay, pixmap);
+
+  itsAtlas = std::move(atlas);
+
+  return itsAtlas.get();
+}
+
 #endif // !GROOVX_GFX_GLXRASTERFONT_H_UTC20050626084025_DEFINED
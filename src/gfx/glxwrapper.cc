@@ -37,6 +37,7 @@
 
 #include "rutz/error.h"
 
+#include <cstring>
 #include <memory>
 
 #include "rutz/debug.h"
@@ -318,4 +319,57 @@ void GlxWrapper::swapBuffers() const
   glXSwapBuffers(itsDisplay, itsCurrentWin);
 }
 
+bool GlxWrapper::setSwapInterval(int interval)
+{
+GVX_TRACE("GlxWrapper::setSwapInterval");
+
+  makeCurrent();
+
+  // glXGetProcAddressARB() may return an entry point for any name at
+  // all, so we have to check the extension string first.
+  const char* exts =
+    glXQueryExtensionsString(itsDisplay, itsVisInfo->screen);
+
+  auto has_ext = [exts](const char* name)
+    {
+      const size_t len = std::strlen(name);
+      for (const char* p = exts; p && (p = std::strstr(p, name)) != nullptr; p += len)
+        if ((p == exts || p[-1] == ' ') && (p[len] == ' ' || p[len] == '\0'))
+          return true;
+      return false;
+    };
+
+  auto proc = [](const char* name)
+    {
+      return glXGetProcAddressARB(reinterpret_cast<const GLubyte*>(name));
+    };
+
+  if (has_ext("GLX_EXT_swap_control"))
+    {
+      typedef void (*func_t)(Display*, GLXDrawable, int);
+      if (func_t f = reinterpret_cast<func_t>(proc("glXSwapIntervalEXT")))
+        {
+          f(itsDisplay, itsCurrentWin, interval);
+          return true;
+        }
+    }
+
+  if (has_ext("GLX_MESA_swap_control"))
+    {
+      typedef int (*func_t)(unsigned int);
+      if (func_t f = reinterpret_cast<func_t>(proc("glXSwapIntervalMESA")))
+        return f((unsigned int)(interval)) == 0;
+    }
+
+  // NOTE: GLX_SGI_swap_control can't turn synchronization off
+  if (interval > 0 && has_ext("GLX_SGI_swap_control"))
+    {
+      typedef int (*func_t)(int);
+      if (func_t f = reinterpret_cast<func_t>(proc("glXSwapIntervalSGI")))
+        return f(interval) == 0;
+    }
+
+  return false;
+}
+
 #endif // GVX_GL_PLATFORM_GLX
@@ -83,6 +83,9 @@ public:
   /// Swaps buffers if in double-buffering mode.
   virtual void swapBuffers() const override;
 
+  /// Set the swap interval with GLX_EXT_swap_control (or MESA or SGI).
+  virtual bool setSwapInterval(int interval) override;
+
   // GLX-specific functions:
 
   /// Bind to a given X window
@@ -0,0 +1,336 @@
+/** @file gfx/glyphatlas.cc pack a raster font's glyphs into one
+    texture, and lay out strings as batched quads */
+
+///////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026-2026 Rob Peters
+// Rob Peters <https://github.com/rjpcal/>
+//
+// created: Mon Oct 19 15:02:18 2026
+//
+// --------------------------------------------------------------------
+//
+// This file is part of GroovX.
+//   [https://github.com/rjpcal/groovx]
+//
+// GroovX is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// GroovX is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GroovX; if not, write to the Free Software Foundation,
+// Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include "gfx/glyphatlas.h"
+
+#include "gfx/textcache.h"
+
+#include "rutz/error.h"
+
+#include <algorithm>
+
+#if defined(GVX_GL_PLATFORM_GLX)
+#  include <GL/gl.h>
+#elif defined(GVX_GL_PLATFORM_AGL)
+#  include <AGL/agl.h>
+#endif
+
+#include "rutz/trace.h"
+#include "rutz/debug.h"
+GVX_DBG_REGISTER
+
+namespace
+{
+  int nextPowerOf2(int n)
+  {
+    int p = 1;
+    while (p < n) p *= 2;
+    return p;
+  }
+
+  struct Glyph
+  {
+    Glyph() :
+      present(false), w(0), h(0), xorig(0), yorig(0), advance(0),
+      bits(), ax(0), ay(0)
+    {}
+
+    bool present;
+    int w, h;
+    int xorig, yorig;
+    int advance;
+    std::vector<unsigned char> bits; // bottom row first
+    int ax, ay;                      // position in the atlas
+  };
+}
+
+class Gfx::GlyphAtlas::Impl
+{
+private:
+  Impl(const Impl&);
+  Impl& operator=(const Impl&);
+
+public:
+  Impl(int line_height) :
+    lineHeight(line_height),
+    isPacked(false),
+    texWidth(0),
+    texHeight(0),
+    pixels(),
+    textureId(0),
+    needsUpload(true),
+    layouts()
+  {}
+
+  // Arrange the glyphs in rows ("shelves"), tallest first, with a
+  // one-pixel gap around each glyph so that neighbors never bleed
+  // into each other.
+  void pack()
+  {
+    GVX_TRACE("Gfx::GlyphAtlas::Impl::pack");
+
+    std::vector<int> order;
+    int maxw = 0;
+    for (int c = 0; c < 256; ++c)
+      if (glyphs[c].present && glyphs[c].w > 0 && glyphs[c].h > 0)
+        {
+          order.push_back(c);
+          maxw = std::max(maxw, glyphs[c].w);
+        }
+
+    std::stable_sort(order.begin(), order.end(),
+                     [this](int a, int b)
+                     { return glyphs[a].h > glyphs[b].h; });
+
+    texWidth = nextPowerOf2(std::max(256, maxw + 2));
+
+    int x = 1, y = 1, shelf = 0;
+    for (int c: order)
+      {
+        Glyph& g = glyphs[c];
+        if (x + g.w + 1 > texWidth)
+          {
+            x = 1;
+            y += shelf + 1;
+            shelf = 0;
+          }
+        g.ax = x;
+        g.ay = y;
+        x += g.w + 1;
+        shelf = std::max(shelf, g.h);
+      }
+
+    texHeight = nextPowerOf2(std::max(1, y + shelf + 1));
+
+    pixels.assign(size_t(texWidth) * size_t(texHeight), 0);
+
+    for (int c: order)
+      {
+        const Glyph& g = glyphs[c];
+        for (int j = 0; j < g.h; ++j)
+          for (int i = 0; i < g.w; ++i)
+            if (g.bits[size_t(j*g.w + i)])
+              pixels[size_t(g.ay + j) * size_t(texWidth) + size_t(g.ax + i)] = 255;
+      }
+
+    isPacked = true;
+    needsUpload = true;
+    layouts.clear();
+  }
+
+  Gfx::GlyphAtlas::Layout makeLayout(const char* text)
+  {
+    GVX_TRACE("Gfx::GlyphAtlas::Impl::makeLayout");
+
+    if (!isPacked)
+      pack();
+
+    Gfx::GlyphAtlas::Layout result;
+
+    const float sw = 1.0f / float(texWidth);
+    const float sh = 1.0f / float(texHeight);
+
+    bool first = true;
+    int l = 0, r = 0, b = 0, t = 0;
+
+    int penx = 0;
+    int line = 0;
+
+    for (const char* p = text; *p != '\0'; ++p)
+      {
+        if (*p == '\n')
+          {
+            penx = 0;
+            ++line;
+            continue;
+          }
+
+        const Glyph& g = glyphs[static_cast<unsigned char>(*p)];
+
+        // like glCallLists() on a missing list, an unknown glyph
+        // neither draws nor advances
+        if (!g.present)
+          continue;
+
+        if (g.w > 0 && g.h > 0)
+          {
+            const int x0 = penx - g.xorig;
+            const int y0 = -line * lineHeight - g.yorig;
+            const int x1 = x0 + g.w;
+            const int y1 = y0 + g.h;
+
+            const float s0 = float(g.ax) * sw;
+            const float t0 = float(g.ay) * sh;
+            const float s1 = float(g.ax + g.w) * sw;
+            const float t1 = float(g.ay + g.h) * sh;
+
+            const float v[16] =
+              {
+                s0, t0, float(x0), float(y0),
+                s1, t0, float(x1), float(y0),
+                s1, t1, float(x1), float(y1),
+                s0, t1, float(x0), float(y1)
+              };
+            result.verts.insert(result.verts.end(), v, v + 16);
+
+            if (first)
+              {
+                l = x0; r = x1; b = y0; t = y1;
+                first = false;
+              }
+            else
+              {
+                l = std::min(l, x0); r = std::max(r, x1);
+                b = std::min(b, y0); t = std::max(t, y1);
+              }
+          }
+
+        penx += g.advance;
+      }
+
+    result.bounds = geom::rect<int>::ltrb(l, t, r, b);
+
+    return result;
+  }
+
+  Glyph glyphs[256];
+  const int lineHeight;
+  bool isPacked;
+  int texWidth;
+  int texHeight;
+  std::vector<unsigned char> pixels;  // bottom row first
+  unsigned int textureId;
+  bool needsUpload;
+  Gfx::TextCache<Gfx::GlyphAtlas::Layout> layouts;
+};
+
+Gfx::GlyphAtlas::GlyphAtlas(int line_height) :
+  rep(new Impl(line_height))
+{
+GVX_TRACE("Gfx::GlyphAtlas::GlyphAtlas");
+}
+
+Gfx::GlyphAtlas::~GlyphAtlas() noexcept
+{
+GVX_TRACE("Gfx::GlyphAtlas::~GlyphAtlas");
+
+  if (rep->textureId != 0)
+    {
+      const GLuint id = rep->textureId;
+      glDeleteTextures(1, &id);
+    }
+
+  delete rep;
+}
+
+void Gfx::GlyphAtlas::addGlyph(unsigned char c, int w, int h,
+                               int xorig, int yorig, int advance,
+                               const unsigned char* bits)
+{
+GVX_TRACE("Gfx::GlyphAtlas::addGlyph");
+
+  if (w < 0 || h < 0)
+    throw rutz::error("invalid glyph size", SRC_POS);
+
+  Glyph& g = rep->glyphs[c];
+  g.present = true;
+  g.w = w;
+  g.h = h;
+  g.xorig = xorig;
+  g.yorig = yorig;
+  g.advance = advance;
+  g.bits.assign(bits, bits + size_t(w) * size_t(h));
+
+  rep->isPacked = false;
+  rep->layouts.clear();
+}
+
+int Gfx::GlyphAtlas::width() const
+{
+  if (!rep->isPacked) rep->pack();
+  return rep->texWidth;
+}
+
+int Gfx::GlyphAtlas::height() const
+{
+  if (!rep->isPacked) rep->pack();
+  return rep->texHeight;
+}
+
+const Gfx::GlyphAtlas::Layout& Gfx::GlyphAtlas::layout(const char* text) const
+{
+GVX_TRACE("Gfx::GlyphAtlas::layout");
+
+  if (!rep->isPacked)
+    rep->pack();
+
+  if (const Layout* cached = rep->layouts.find(text))
+    return *cached;
+
+  return rep->layouts.insert(text, rep->makeLayout(text));
+}
+
+void Gfx::GlyphAtlas::bindTexture() const
+{
+GVX_TRACE("Gfx::GlyphAtlas::bindTexture");
+
+  if (!rep->isPacked)
+    rep->pack();
+
+  if (rep->textureId == 0)
+    {
+      GLuint id = 0;
+      glGenTextures(1, &id);
+      if (id == 0)
+        throw rutz::error("couldn't allocate GL texture", SRC_POS);
+      rep->textureId = id;
+      rep->needsUpload = true;
+    }
+
+  glBindTexture(GL_TEXTURE_2D, rep->textureId);
+
+  if (rep->needsUpload)
+    {
+      glPushClientAttrib(GL_CLIENT_PIXEL_STORE_BIT);
+      glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+      glTexImage2D(GL_TEXTURE_2D, 0, GL_ALPHA8,
+                   rep->texWidth, rep->texHeight, 0,
+                   GL_ALPHA, GL_UNSIGNED_BYTE, &rep->pixels[0]);
+      glPopClientAttrib();
+
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP);
+
+      rep->needsUpload = false;
+    }
+}
@@ -0,0 +1,106 @@
+/** @file gfx/glyphatlas.h pack a raster font's glyphs into one
+    texture, and lay out strings as batched quads */
+
+///////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026-2026 Rob Peters
+// Rob Peters <https://github.com/rjpcal/>
+//
+// created: Mon Oct 19 15:02:18 2026
+//
+// --------------------------------------------------------------------
+//
+// This file is part of GroovX.
+//   [https://github.com/rjpcal/groovx]
+//
+// GroovX is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// GroovX is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GroovX; if not, write to the Free Software Foundation,
+// Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef GROOVX_GFX_GLYPHATLAS_H_UTC20261019150218_DEFINED
+#define GROOVX_GFX_GLYPHATLAS_H_UTC20261019150218_DEFINED
+
+#include "geom/rect.h"
+
+#include <vector>
+
+namespace Gfx
+{
+  class GlyphAtlas;
+}
+
+///////////////////////////////////////////////////////////////////////
+/**
+ *
+ * Gfx::GlyphAtlas holds the bitmaps of a raster font's glyphs, packed
+ * side-by-side into a single alpha texture. Glyphs are added once
+ * with addGlyph() (with the same metrics that glBitmap() uses), and
+ * then a whole string can be drawn as one array of textured quads
+ * from layout(), instead of one display list call per glyph.
+ *
+ **/
+///////////////////////////////////////////////////////////////////////
+
+class Gfx::GlyphAtlas
+{
+public:
+  /// Quads for one string, in pixels relative to the raster position.
+  struct Layout
+  {
+    /// Four vertices per glyph, each as (s, t, x, y).
+    std::vector<float> verts;
+
+    /// Bounding box in pixels relative to the raster position.
+    geom::rect<int> bounds;
+  };
+
+  /// Construct an empty atlas for a font with the given line height.
+  GlyphAtlas(int line_height);
+
+  /// Destructor; frees the texture, if one was created.
+  ~GlyphAtlas() noexcept;
+
+  /// Add the bitmap for glyph \a c.
+  /** \a bits holds w*h bytes, bottom row first, where non-zero means
+      ink. As with glBitmap(), (xorig,yorig) is the position of the
+      glyph's origin within the bitmap, and \a advance is how far the
+      pen moves after the glyph. */
+  void addGlyph(unsigned char c, int w, int h, int xorig, int yorig,
+                int advance, const unsigned char* bits);
+
+  /// Width of the packed texture, in pixels (a power of two).
+  int width() const;
+
+  /// Height of the packed texture, in pixels (a power of two).
+  int height() const;
+
+  /// Get the quads for \a text; lines are line_height pixels apart.
+  /** Layouts are cached per string. */
+  const Layout& layout(const char* text) const;
+
+  /// Bind the atlas texture on the current OpenGL context.
+  /** The texture is created (and the glyphs packed) on first use. */
+  void bindTexture() const;
+
+  class Impl;
+
+private:
+  GlyphAtlas(const GlyphAtlas&);
+  GlyphAtlas& operator=(const GlyphAtlas&);
+
+  Impl* const rep;
+};
+
+#endif // !GROOVX_GFX_GLYPHATLAS_H_UTC20261019150218_DEFINED
@@ -95,6 +95,8 @@ void GxAligner::read_from(io::reader& reader)
 GVX_TRACE("GxAligner::read_from");
   reader.read_value("mode", itsMode);
   reader.read_value_obj("center", itsCenter);
+
+  this->sigNodeChanged.emit();
 }
 
 void GxAligner::write_to(io::writer& writer) const
@@ -120,7 +122,7 @@ GVX_TRACE("GxAligner::getBoundingCube");
 
   Gfx::Bbox mybox = bbox.peer();
 
-  child()->getBoundingCube(mybox);
+  child()->getCachedBoundingCube(mybox);
 
   rectd bounds = mybox.rect();
 
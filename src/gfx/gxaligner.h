@@ -95,7 +95,11 @@ public:
   Mode getMode() const        { return itsMode; }
 
   /// Set the alignment mode.
-  void setMode(Mode new_mode) { itsMode = new_mode; }
+  void setMode(Mode new_mode)
+  {
+    if (itsMode != new_mode)
+      { itsMode = new_mode; this->sigNodeChanged.emit(); }
+  }
 
   virtual void read_from(io::reader& reader) override;
   virtual void write_to(io::writer& writer) const override;
@@ -62,6 +62,8 @@ GVX_TRACE("GxBounds::read_from");
   reader.read_value("isVisible", isItVisible);
   reader.read_value("isAnimated", isItAnimated);
   reader.read_value("percentBorder", itsPercentBorder);
+
+  this->sigNodeChanged.emit();
 }
 
 void GxBounds::write_to(io::writer& writer) const
@@ -83,7 +85,7 @@ GVX_TRACE("GxBounds::draw");
       Gfx::Bbox bbox(canvas);
       const double s = 1.0 + itsPercentBorder/100.0;
       bbox.scale(geom::vec3<double>(s,s,s));
-      child()->getBoundingCube(bbox);
+      child()->getCachedBoundingCube(bbox);
 
       geom::rect<double> bounds = bbox.rect();
 
@@ -129,7 +131,7 @@ GVX_TRACE("GxBounds::getBoundingCube");
 
   bbox.scale(geom::vec3<double>(s,s,s));
 
-  child()->getBoundingCube(bbox);
+  child()->getCachedBoundingCube(bbox);
 
   bbox.pop();
 
@@ -59,7 +59,11 @@ public:
   int percentBorder() const { return itsPercentBorder; }
 
   /// Change the gap between the child object and the boundary.
-  void setPercentBorder(int pixels) { itsPercentBorder = pixels; }
+  void setPercentBorder(int pixels)
+  {
+    if (itsPercentBorder != pixels)
+      { itsPercentBorder = pixels; this->sigNodeChanged.emit(); }
+  }
 
   virtual void read_from(io::reader& reader) override;
   virtual void write_to(io::writer& writer) const override;
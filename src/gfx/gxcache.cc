@@ -1,5 +1,5 @@
 /** @file gfx/gxcache.cc GxBin subclass that can cache its child node
-    in an OpenGL display list */
+    in an OpenGL display list or a retained command list */
 ///////////////////////////////////////////////////////////////////////
 //
 // Copyright (c) 2002-2004 California Institute of Technology
@@ -32,6 +32,7 @@
 #include "gxcache.h"
 
 #include "gfx/glcanvas.h"
+#include "gfx/recordcanvas.h"
 
 #include "io/reader.h"
 #include "io/writer.h"
@@ -51,7 +52,8 @@ GxCache::GxCache(nub::soft_ref<GxNode> child) :
   GxBin(child),
   itsMode(DIRECT),
   itsDisplayList(0),
-  itsCanvas()
+  itsCanvas(),
+  itsCmdList()
 {
 GVX_TRACE("GxCache::GxCache");
 }
@@ -88,6 +90,12 @@ GVX_TRACE("GxCache::write_to");
 void GxCache::draw(Gfx::Canvas& canvas) const
 {
 GVX_TRACE("GxCache::draw");
+  if (itsMode == RECORD)
+    {
+      drawRecorded(canvas);
+      return;
+    }
+
   GLCanvas* const glcanvas = dynamic_cast<GLCanvas*>(&canvas);
   if (itsMode != GLCOMPILE || glcanvas == 0)
     {
@@ -113,10 +121,40 @@ GVX_TRACE("GxCache::draw");
     }
 }
 
+void GxCache::drawRecorded(Gfx::Canvas& canvas) const
+{
+GVX_TRACE("GxCache::drawRecorded");
+
+  // If we are being recorded as part of an enclosing cache, then let
+  // the enclosing list refer to us by reference; that way only our
+  // own list needs to be re-recorded when our subtree changes.
+  Gfx::RecordCanvas* const reccanvas =
+    dynamic_cast<Gfx::RecordCanvas*>(&canvas);
+
+  if (reccanvas != 0)
+    {
+      reccanvas->callNode(*this);
+    }
+  else if (itsCmdList.get() != 0)
+    {
+      itsCmdList->replay(canvas);
+      dbg_eval_nl(3, itsCmdList->numCommands());
+    }
+  else
+    {
+      std::unique_ptr<Gfx::CmdList> cmds(new Gfx::CmdList);
+      {
+        Gfx::RecordCanvas recorder(*cmds, canvas);
+        child()->draw(recorder);
+      }
+      itsCmdList = std::move(cmds);
+    }
+}
+
 void GxCache::getBoundingCube(Gfx::Bbox& bbox) const
 {
 GVX_TRACE("GxCache::getBoundingCube");
-  child()->getBoundingCube(bbox);
+  child()->getCachedBoundingCube(bbox);
 }
 
 void GxCache::invalidate() noexcept
@@ -128,6 +166,8 @@ GVX_TRACE("GxCache::invalidate");
   // Now forget the display list and its owning canvas
   itsDisplayList = 0;
   itsCanvas = nub::soft_ref<GLCanvas>();
+
+  itsCmdList.reset();
 }
 
 void GxCache::setMode(Mode new_mode) noexcept
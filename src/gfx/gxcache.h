@@ -1,5 +1,5 @@
 /** @file gfx/gxcache.h GxBin subclass that can cache its child node
-    in an OpenGL display list */
+    in an OpenGL display list or a retained command list */
 
 ///////////////////////////////////////////////////////////////////////
 //
@@ -37,9 +37,16 @@
 
 #include "nub/ref.h"
 
+#include <memory>
+
 class GLCanvas;
 
-/// A node for caching with OpenGL display lists.
+namespace Gfx
+{
+  class CmdList;
+}
+
+/// A node for caching with OpenGL display lists or retained command lists.
 class GxCache : public GxBin
 {
 public:
@@ -68,6 +75,15 @@ public:
       not changed since the last draw. */
   static const Mode GLCOMPILE = 2;
 
+  /** In this mode, the first draw request records the child's Canvas
+      calls into a Gfx::CmdList, and subsequent draw requests replay
+      that list until the cache is invalidated. Unlike \c GLCOMPILE,
+      this works with any Canvas (e.g. GLCanvas or PSCanvas), and
+      does not depend on OpenGL display lists. A \c RECORD cache
+      nested within another \c RECORD cache is recorded by reference,
+      so invalidating the inner cache re-records only its subtree. */
+  static const Mode RECORD = 3;
+
 
   /// Construct with a given child object.
   GxCache(nub::soft_ref<GxNode> child);
@@ -95,10 +111,14 @@ public:
   void setMode(Mode new_mode) noexcept;
 
 private:
+  /// Draw in RECORD mode, recording the child's commands if needed.
+  void drawRecorded(Gfx::Canvas& canvas) const;
+
   Mode itsMode;
 
   mutable unsigned int itsDisplayList;
   mutable nub::soft_ref<GLCanvas> itsCanvas;
+  mutable std::unique_ptr<Gfx::CmdList> itsCmdList;
 };
 
 #endif // !GROOVX_GFX_GXCACHE_H_UTC20050626084023_DEFINED
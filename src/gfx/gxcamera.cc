@@ -80,7 +80,9 @@ GxPerspectiveCamera::GxPerspectiveCamera() :
   itsFovY(30),
   itsNearZ(1),
   itsFarZ(30)
-{}
+{
+  setFieldMap(GxPerspectiveCamera::classFields());
+}
 
 GxPerspectiveCamera::~GxPerspectiveCamera() noexcept {}
 
@@ -196,7 +198,9 @@ GxFixedScaleCamera::GxFixedScaleCamera() :
   GxCamera(),
   FieldContainer(&sigNodeChanged),
   itsPixelsPerUnit(100.0)
-{}
+{
+  setFieldMap(GxFixedScaleCamera::classFields());
+}
 
 GxFixedScaleCamera::~GxFixedScaleCamera() noexcept {}
 
@@ -273,7 +277,9 @@ GxPsyphyCamera::GxPsyphyCamera() :
   FieldContainer(&sigNodeChanged),
   itsDegreesPerUnit(2.05),
   itsViewingDistance(30.0)
-{}
+{
+  setFieldMap(GxPsyphyCamera::classFields());
+}
 
 GxPsyphyCamera::~GxPsyphyCamera() noexcept {}
 
@@ -79,9 +79,11 @@ GxCylinder::GxCylinder() :
   itsHeight(1.0),
   itsSlices(75),
   itsStacks(20),
-  itsFilled(true)
+  itsFilled(true),
+  itsMesh()
 {
 GVX_TRACE("GxCylinder::GxCylinder");
+  sigNodeChanged.connect([this]() { this->itsMesh.clear(); });
   setFieldMap(GxCylinder::classFields());
 }
 
@@ -131,6 +133,9 @@ void GxCylinder::draw(Gfx::Canvas& canvas) const
 {
 GVX_TRACE("GxCylinder::draw");
 
-  canvas.drawCylinder(itsBase, itsTop, itsHeight,
-                      itsSlices, itsStacks, itsFilled);
+  if (itsMesh.isEmpty())
+    itsMesh = Gfx::Mesh::cylinder(itsBase, itsTop, itsHeight,
+                                  itsSlices, itsStacks, itsFilled);
+
+  itsMesh.draw(canvas);
 }
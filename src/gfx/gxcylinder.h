@@ -33,6 +33,7 @@
 #define GROOVX_GFX_GXCYLINDER_H_UTC20050626084024_DEFINED
 
 #include "gfx/gxnode.h"
+#include "gfx/mesh.h"
 
 #include "io/fields.h"
 
@@ -70,6 +71,9 @@ private:
   int itsStacks;
   bool itsFilled;
 
+  /// Vertex arrays built from the fields; cleared whenever they change.
+  mutable Gfx::Mesh itsMesh;
+
 public:
   /// Get GxCylinder's FieldMap.
   static const FieldMap& classFields();
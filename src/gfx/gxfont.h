@@ -32,6 +32,8 @@
 #ifndef GROOVX_GFX_GXFONT_H_UTC20050626084023_DEFINED
 #define GROOVX_GFX_GXFONT_H_UTC20050626084023_DEFINED
 
+#include <memory>
+
 namespace geom
 {
   template <class V> class rect;
@@ -44,7 +46,10 @@ namespace Gfx
 }
 
 /// An abstract class for fonts.
-class GxFont
+/** Fonts are normally owned by a std::shared_ptr (see
+    GxFactory::makeFont()), so that retained drawing commands (see
+    Gfx::RecordCanvas) can keep them alive with shared_from_this(). */
+class GxFont : public std::enable_shared_from_this<GxFont>
 {
 public:
   /// Virtual destructor.
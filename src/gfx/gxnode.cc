@@ -32,6 +32,7 @@
 #include "gxnode.h"
 
 #include "geom/box.h"
+#include "geom/txform.h"
 
 #include "gfx/bbox.h"
 #include "gfx/canvas.h"
@@ -44,6 +45,34 @@
 
 using std::shared_ptr;
 
+struct GxNode::BoundsCache
+{
+  BoundsCache() :
+    cube(), net(geom::txform::identity()),
+    empty(true), netIsIdentity(true), screenDependent(false)
+  {}
+
+  geom::box<double> cube;   // bounds in the node's local coordinates
+  geom::txform      net;    // net transform the node leaves behind
+  bool              empty;
+  bool              netIsIdentity;
+  bool              screenDependent;
+};
+
+namespace
+{
+  GxNode::BoundsCacheStats g_bounds_stats = { 0, 0, 0 };
+  bool g_bounds_caching = true;
+
+  bool isIdentity(const geom::txform& m)
+  {
+    for (size_t i = 0; i < 16; ++i)
+      if (m[i] != ((i % 5 == 0) ? 1.0 : 0.0))
+        return false;
+    return true;
+  }
+}
+
 class GxNodeIter : public rutz::fwd_iter_ifx<const nub::ref<GxNode> >
 {
   nub::ref<GxNode> itsNode;
@@ -65,9 +94,22 @@ public:
   virtual void       next()       override { isItValid = false; }
 };
 
-GxNode::GxNode() : sigNodeChanged()
+GxNode::GxNode() :
+  sigNodeChanged(),
+  itsBounds(),
+  itsBoundsValid(false),
+  itsNumChanges(0)
 {
 GVX_TRACE("GxNode::GxNode");
+
+  // Our own slot is connected first, so that our cached bounds are
+  // gone (and our change count is bumped) by the time any parent node
+  // hears about the change.
+  sigNodeChanged.connect([this]()
+                         {
+                           this->itsBoundsValid = false;
+                           ++this->itsNumChanges;
+                         });
 }
 
 GxNode::~GxNode() noexcept
@@ -94,11 +136,87 @@ geom::rect<double> GxNode::getBoundingBox(Gfx::Canvas& canvas) const
 GVX_TRACE("GxNode::getBoundingBox");
 
   Gfx::Bbox bbox(canvas);
-  getBoundingCube(bbox);
+  getCachedBoundingCube(bbox);
 
   return bbox.rect();
 }
 
+void GxNode::getCachedBoundingCube(Gfx::Bbox& bbox) const
+{
+  // No GVX_TRACE here, since a cache hit should cost next to nothing
+
+  if (!g_bounds_caching || !bbox.isAxisAligned())
+    {
+      ++g_bounds_stats.uncached;
+      getBoundingCube(bbox);
+      return;
+    }
+
+  if (!itsBoundsValid)
+    {
+      ++g_bounds_stats.misses;
+
+      if (itsBounds.get() == nullptr)
+        itsBounds.reset(new BoundsCache);
+
+      // Compute our bounds starting from an identity transform, in a
+      // box of our own so that we can tell whether the result
+      // depends on the screen projection
+      Gfx::Bbox local(bbox.canvas());
+      getBoundingCube(local);
+
+      itsBounds->cube = local.cube();
+      itsBounds->net = local.currentTransform();
+      itsBounds->empty = local.isEmpty();
+      itsBounds->netIsIdentity = isIdentity(itsBounds->net);
+      itsBounds->screenDependent = local.isScreenDependent();
+      itsBoundsValid = true;
+
+      if (itsBounds->screenDependent)
+        {
+          getBoundingCube(bbox);
+          return;
+        }
+    }
+  else if (itsBounds->screenDependent)
+    {
+      ++g_bounds_stats.uncached;
+      getBoundingCube(bbox);
+      return;
+    }
+  else
+    {
+      ++g_bounds_stats.hits;
+    }
+
+  if (!itsBounds->empty)
+    bbox.drawBox(itsBounds->cube);
+
+  if (!itsBounds->netIsIdentity)
+    bbox.transform(itsBounds->net);
+}
+
+GxNode::BoundsCacheStats GxNode::boundsCacheStats()
+{
+  return g_bounds_stats;
+}
+
+void GxNode::resetBoundsCacheStats()
+{
+  g_bounds_stats = BoundsCacheStats{ 0, 0, 0 };
+}
+
+void GxNode::setBoundsCaching(bool on)
+{
+GVX_TRACE("GxNode::setBoundsCaching");
+  g_bounds_caching = on;
+}
+
+bool GxNode::isBoundsCaching()
+{
+  return g_bounds_caching;
+}
+
 void GxNode::undraw(Gfx::Canvas& canvas) const
 {
 GVX_TRACE("GxNode::undraw");
@@ -36,6 +36,8 @@
 
 #include "nub/signal.h"
 
+#include <memory>
+
 namespace rutz
 {
   template <class T> class fwd_iter;
@@ -83,6 +85,11 @@ public:
   /// Signal that will be triggered whenever the node changes state.
   nub::signal<> sigNodeChanged;
 
+  /// Get the number of times sigNodeChanged has been emitted.
+  /** Since composite nodes forward their children's sigNodeChanged,
+      this also counts changes anywhere in the node's subtree. */
+  unsigned long numNodeChanges() const { return itsNumChanges; }
+
   /** Returns true if \a other is contained within this node in the
       scene graph. The default implementation (for leaf nodes) returns
       true only if this == other. For composite nodes, the function
@@ -102,11 +109,51 @@ public:
       how that subclass is rendered. */
   virtual void getBoundingCube(Gfx::Bbox& bbox) const = 0;
 
+  /// Like getBoundingCube(), but reuse this node's cached local bounds if possible.
+  /** The node's bounds are computed once in its own local coordinates
+      and then kept until sigNodeChanged is emitted; since composite
+      nodes forward their children's sigNodeChanged, any change in a
+      subtree also invalidates the bounds of all its ancestors. The
+      cached bounds are used only when \a bbox's current transform is
+      axis-aligned (so that the result is exact), and never for
+      subtrees whose bounds depend on the canvas's projection (see
+      Gfx::Bbox::isScreenDependent()); in those cases this just calls
+      getBoundingCube(). Composite nodes should use this to collect
+      their children's bounds. */
+  void getCachedBoundingCube(Gfx::Bbox& bbox) const;
+
+  /// Counters describing how well the bounds cache is working.
+  struct BoundsCacheStats
+  {
+    unsigned long hits;     ///< cached bounds were reused
+    unsigned long misses;   ///< bounds had to be (re)computed and cached
+    unsigned long uncached; ///< bounds couldn't be cached and were computed directly
+  };
+
+  /// Get the bounds cache counters, summed over all nodes.
+  static BoundsCacheStats boundsCacheStats();
+
+  /// Reset the bounds cache counters to zero.
+  static void resetBoundsCacheStats();
+
+  /// Globally enable or disable the bounds cache (enabled by default).
+  static void setBoundsCaching(bool on);
+
+  /// Query whether the bounds cache is enabled.
+  static bool isBoundsCaching();
+
   /// Draw the object on \a canvas.
   virtual void draw(Gfx::Canvas& canvas) const = 0;
 
   /// Undraw the object from \a canvas by clearing the bounding box.
   void undraw(Gfx::Canvas& canvas) const;
+
+private:
+  struct BoundsCache;
+
+  mutable std::unique_ptr<BoundsCache> itsBounds;
+  mutable bool itsBoundsValid;
+  unsigned long itsNumChanges;
 };
 
 #endif // !GROOVX_GFX_GXNODE_H_UTC20050626084023_DEFINED
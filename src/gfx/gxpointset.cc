@@ -39,6 +39,8 @@
 #include "io/reader.h"
 #include "io/writer.h"
 
+#include <vector>
+
 #include "rutz/trace.h"
 
 namespace
@@ -107,8 +109,12 @@ void GxPointSet::getBoundingCube(Gfx::Bbox& bbox) const
 {
 GVX_TRACE("GxPointSet::getBoundingCube");
 
-  for (unsigned int i = 0; i < itsPoints.array_size(); ++i)
-    bbox.vertex3(itsPoints.array_at(i));
+  std::vector<geom::vec3<double> > pts(itsPoints.array_size());
+
+  for (unsigned int i = 0; i < pts.size(); ++i)
+    pts[i] = itsPoints.array_at(i);
+
+  bbox.vertices(pts.data(), pts.size());
 }
 
 void GxPointSet::draw(Gfx::Canvas& canvas) const
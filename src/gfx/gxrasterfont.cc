@@ -37,3 +37,8 @@ GxRasterFont::~GxRasterFont() noexcept
 {
 GVX_TRACE("GxRasterFont::~GxRasterFont");
 }
+
+const Gfx::GlyphAtlas* GxRasterFont::glyphAtlas() const
+{
+  return nullptr;
+}
@@ -35,6 +35,11 @@
 
 #include "gfx/gxfont.h"
 
+namespace Gfx
+{
+  class GlyphAtlas;
+}
+
 /// Builds an OpenGL raster font from an X11 font.
 class GxRasterFont : public GxFont
 {
@@ -51,6 +56,12 @@ public:
 
   /// Return the line height of the font, in screen coords (i.e., pixels).
   virtual int rasterHeight() const = 0;
+
+  /// Get the font's glyphs packed into a texture atlas.
+  /** Canvases can use this to draw whole strings at once, rather
+      than a glyph at a time. The default returns null, meaning that
+      the font has no atlas. */
+  virtual const Gfx::GlyphAtlas* glyphAtlas() const;
 };
 
 #endif // !GROOVX_GFX_GXRASTERFONT_H_UTC20050626084023_DEFINED
@@ -203,6 +203,8 @@ GVX_TRACE("GxScaler::read_from");
   reader.read_value("widthFactor", itsWidthFactor);
   reader.read_value("heightFactor", itsHeightFactor);
   reader.read_value("aspectRatio", itsAspectRatio);
+
+  this->sigNodeChanged.emit();
 }
 
 void GxScaler::write_to(io::writer& writer) const
@@ -241,7 +243,7 @@ GVX_TRACE("GxScaler::getBoundingCube");
                                   itsHeightFactor,
                                   1.0));
 
-  child()->getBoundingCube(bbox);
+  child()->getCachedBoundingCube(bbox);
 
   bbox.pop();
 
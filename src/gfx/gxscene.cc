@@ -31,14 +31,158 @@
 
 #include "gxscene.h"
 
+#include "geom/rect.h"
+#include "geom/txform.h"
+#include "geom/vec2.h"
+#include "geom/vec3.h"
+
+#include "gfx/bbox.h"
+#include "gfx/gxseparator.h"
+
+#include "media/bmapdata.h"
+
 #include "nub/scheduler.h"
 
+#include "rutz/error.h"
+
+#include <algorithm>
 #include <memory>
+#include <vector>
 
 #include "rutz/trace.h"
 #include "rutz/debug.h"
 GVX_DBG_REGISTER
 
+using geom::recti;
+
+namespace
+{
+  // Padding in pixels around each node's screen bounds, to cover
+  // antialiased edges and line widths that Gfx::Bbox doesn't see.
+  const int DAMAGE_PAD = 2;
+
+  // Beyond this many separate damage rects, just merge them into one.
+  const size_t MAX_DAMAGE_RECTS = 8;
+
+  bool overlaps(const recti& a, const recti& b)
+  {
+    return a.left() < b.right() && b.left() < a.right()
+      && a.bottom() < b.top() && b.bottom() < a.top();
+  }
+
+  long area(const recti& r, const recti& viewport)
+  {
+    const int w = std::min(r.right(), viewport.right())
+      - std::max(r.left(), viewport.left());
+    const int h = std::min(r.top(), viewport.top())
+      - std::max(r.bottom(), viewport.bottom());
+    return (w > 0 && h > 0) ? long(w) * long(h) : 0;
+  }
+
+  // Add r to rects, merging it with any rects that it overlaps.
+  void addDamage(std::vector<recti>& rects, recti r)
+  {
+    for (size_t i = 0; i < rects.size(); )
+      {
+        if (overlaps(rects[i], r))
+          {
+            r = r.union_with(rects[i]);
+            rects.erase(rects.begin() + long(i));
+            i = 0;
+          }
+        else
+          ++i;
+      }
+
+    rects.push_back(r);
+
+    if (rects.size() > MAX_DAMAGE_RECTS)
+      {
+        for (size_t i = 1; i < rects.size(); ++i)
+          rects[0] = rects[0].union_with(rects[i]);
+        rects.resize(1);
+      }
+  }
+}
+
+// What we know about the scene as it was last drawn on the canvas.
+struct GxScene::Damage
+{
+  // Screen bounds of one child of the drawable separator.
+  struct Item
+  {
+    const GxNode* node;
+    unsigned long changes;   // node->numNodeChanges() when last drawn
+    bool empty;              // true for children that draw nothing
+    recti bounds;
+  };
+
+  Damage() :
+    items(),
+    drawNode(nullptr),
+    drawChanges(0),
+    cameraChanges(0),
+    width(0),
+    height(0),
+    stats()
+  {}
+
+  // Compute the screen bounds of each of sep's children, as they will
+  // be drawn with canvas's current transform. Children that draw
+  // nothing are kept too, since they may set transforms or attribs
+  // for the children that follow them.
+  static void collect(Gfx::Canvas& canvas, const GxSeparator& sep,
+                      std::vector<Item>& result)
+  {
+    result.clear();
+
+    geom::txform net = geom::txform::identity();
+
+    for (size_t i = 0; i < sep.numChildren(); ++i)
+      {
+        const nub::ref<GxNode> child = sep.getChild(i);
+
+        Gfx::Bbox bbox(canvas);
+        bbox.transform(net);
+        child->getCachedBoundingCube(bbox);
+        net = bbox.currentTransform();
+
+        Item item;
+        item.node = child.get();
+        item.changes = child->numNodeChanges();
+        item.empty = bbox.isEmpty();
+        if (!item.empty)
+          {
+            item.bounds = canvas.screenBoundsFromWorldRect(bbox.rect());
+            item.bounds = recti::ltrb(item.bounds.left() - DAMAGE_PAD,
+                                      item.bounds.top() + DAMAGE_PAD,
+                                      item.bounds.right() + DAMAGE_PAD,
+                                      item.bounds.bottom() - DAMAGE_PAD);
+          }
+        result.push_back(item);
+      }
+  }
+
+  void invalidate() { drawNode = nullptr; }
+
+  void countFrame(long pixels, bool partial)
+  {
+    ++stats.frames;
+    if (partial) ++stats.partialFrames;
+    stats.lastPixels = (unsigned long)(pixels);
+    stats.pixels += (unsigned long long)(pixels);
+  }
+
+  std::vector<Item> items;
+  const GxNode* drawNode;      // nullptr if the baseline is unknown
+  unsigned long drawChanges;
+  unsigned long cameraChanges;
+  int width;
+  int height;
+
+  GxScene::DamageStats stats;
+};
+
 ///////////////////////////////////////////////////////////////////////
 //
 // GxScene member definitions
@@ -57,8 +201,12 @@ GxScene::GxScene(nub::soft_ref<Gfx::Canvas> canvas,
   isItHolding(false),
   isItRefreshing(true),
   isItRefreshed(false),
+  isItSwapPending(false),
   itsScheduler(sched),
-  itsTimer(100, true)
+  itsTimer(100, true),
+  isItDamageTracking(false),
+  itsDamage(new Damage),
+  itsFrameLog()
 {
 GVX_TRACE("GxScene::GxScene");
   itsTimer.sig_timeout.connect(this, &GxScene::fullRender);
@@ -74,6 +222,8 @@ void GxScene::render()
 {
 GVX_TRACE("GxScene::render");
 
+  itsFrameLog.markStart();
+
   try
     {
       Gfx::MatrixSaver msaver(*itsCanvas);
@@ -83,7 +233,13 @@ GVX_TRACE("GxScene::render");
       itsDrawNode->draw(*itsCanvas);
       itsUndrawNode = itsDrawNode;
 
+      itsFrameLog.markRendered();
+
+      if (isItDamageTracking)
+        recordDamageBaseline();
+
       isItRefreshed = true;
+      isItSwapPending = true;
     }
   catch (...)
     {
@@ -97,6 +253,8 @@ void GxScene::fullRender()
 {
 GVX_TRACE("GxScene::fullRender");
 
+  itsFrameLog.markStart();
+
   // (1) Clear the screen (but only if we are not "holding")
   if( !isItHolding )
     {
@@ -108,9 +266,306 @@ GVX_TRACE("GxScene::fullRender");
     {
       render();
     }
+  else
+    {
+      itsDamage->invalidate();
+    }
 
   // (3) Flush the graphics stream
+  flushOutput();
+
+  const recti viewport = itsCanvas->getScreenViewport();
+  itsDamage->countFrame(area(viewport, viewport), false);
+}
+
+void GxScene::flushOutput()
+{
+GVX_TRACE("GxScene::flushOutput");
+
+  isItSwapPending = false;
+
+  if (!itsFrameLog.isEnabled())
+    {
+      itsCanvas->flushOutput();
+      return;
+    }
+
+  itsFrameLog.markStart();
+
   itsCanvas->flushOutput();
+  itsFrameLog.markSwapped();
+
+  if (itsFrameLog.isWaitingForPresent())
+    {
+      itsCanvas->finishDrawing();
+      itsFrameLog.markPresented();
+    }
+
+  itsFrameLog.commit();
+}
+
+media::bmap_data GxScene::preRender(const GxNode& node)
+{
+GVX_TRACE("GxScene::preRender");
+
+  if (!itsCanvas->isDoubleBuffered())
+    throw rutz::error("can't pre-render frames on a "
+                      "single-buffered canvas", SRC_POS);
+
+  const recti viewport = itsCanvas->getScreenViewport();
+
+  // Save a frame that is waiting to be swapped to the screen (e.g. if
+  // a preload comes between a render and the swap that shows it).
+  std::unique_ptr<media::bmap_data> pending;
+  if (isItSwapPending)
+    pending.reset(new media::bmap_data
+                  (itsCanvas->grabDrawnPixels(viewport)));
+
+  itsCanvas->clearColorBuffer();
+
+  {
+    Gfx::MatrixSaver msaver(*itsCanvas);
+    Gfx::AttribSaver asaver(*itsCanvas);
+
+    itsCamera->draw(*itsCanvas);
+    node.draw(*itsCanvas);
+  }
+
+  media::bmap_data frame = itsCanvas->grabDrawnPixels(viewport);
+
+  itsCanvas->clearColorBuffer();
+
+  if (pending.get() != nullptr)
+    drawPixelsToViewport(*pending);
+
+  // The back buffer has been redrawn, so the next change must be a
+  // full redraw.
+  itsDamage->invalidate();
+
+  return frame;
+}
+
+void GxScene::renderFrame(const media::bmap_data& frame)
+{
+GVX_TRACE("GxScene::renderFrame");
+
+  itsFrameLog.markStart();
+
+  drawPixelsToViewport(frame);
+
+  itsFrameLog.markRendered();
+
+  itsUndrawNode = itsDrawNode;
+  isItRefreshed = true;
+  isItSwapPending = true;
+
+  // The frame doesn't tell us where the drawable's children are, so
+  // the next change must be a full redraw.
+  itsDamage->invalidate();
+}
+
+void GxScene::drawPixelsToViewport(const media::bmap_data& frame)
+{
+GVX_TRACE("GxScene::drawPixelsToViewport");
+
+  Gfx::MatrixSaver msaver(*itsCanvas);
+
+  itsCamera->draw(*itsCanvas);
+
+  // Nudge the raster position a quarter pixel inside the viewport,
+  // so that rounding in the round trip through the camera can't push
+  // it outside (which would make the whole draw a no-op).
+  const recti viewport = itsCanvas->getScreenViewport();
+  const geom::vec3<double> origin =
+    itsCanvas->worldFromScreen3
+    (geom::vec3<double>(viewport.left() + 0.25,
+                        viewport.bottom() + 0.25, 0.5));
+
+  itsCanvas->drawPixels(frame, origin, geom::vec2<double>(1.0, 1.0));
+}
+
+void GxScene::showFrame(const media::bmap_data& frame)
+{
+GVX_TRACE("GxScene::showFrame");
+
+  renderFrame(frame);
+
+  flushOutput();
+
+  const recti viewport = itsCanvas->getScreenViewport();
+  itsDamage->countFrame(area(viewport, viewport), false);
+}
+
+void GxScene::recordDamageBaseline()
+{
+GVX_TRACE("GxScene::recordDamageBaseline");
+
+  // NOTE: this is called from render() with the camera transform in
+  // effect, which is what we need to get the right screen bounds.
+
+  Damage& d = *itsDamage;
+
+  d.items.clear();
+
+  if (isItHolding)
+    {
+      d.invalidate();
+      return;
+    }
+
+  const GxSeparator* sep =
+    dynamic_cast<const GxSeparator*>(itsDrawNode.get());
+
+  if (sep != nullptr)
+    Damage::collect(*itsCanvas, *sep, d.items);
+
+  d.drawNode = itsDrawNode.get();
+  d.drawChanges = itsDrawNode->numNodeChanges();
+  d.cameraChanges = itsCamera->numNodeChanges();
+  d.width = itsWidth;
+  d.height = itsHeight;
+}
+
+bool GxScene::partialRender()
+{
+GVX_TRACE("GxScene::partialRender");
+
+  Damage& d = *itsDamage;
+
+  if (!isItVisible || isItHolding
+      || d.drawNode != itsDrawNode.get()
+      || d.cameraChanges != itsCamera->numNodeChanges()
+      || d.width != itsWidth || d.height != itsHeight)
+    return false;
+
+  const GxSeparator* sep =
+    dynamic_cast<const GxSeparator*>(itsDrawNode.get());
+
+  if (sep == nullptr || sep->getDebugMode()
+      || sep->numChildren() != d.items.size())
+    return false;
+
+  // Each change in a child is forwarded exactly once (per occurrence
+  // in the child list) to the separator, so if the separator has seen
+  // more changes than that, then the separator itself changed.
+  unsigned long forwarded = 0;
+
+  for (size_t i = 0; i < d.items.size(); ++i)
+    {
+      const nub::ref<GxNode> child = sep->getChild(i);
+      if (child.get() != d.items[i].node)
+        return false;
+      forwarded += child->numNodeChanges() - d.items[i].changes;
+    }
+
+  if (itsDrawNode->numNodeChanges() - d.drawChanges != forwarded)
+    return false;
+
+  Gfx::Canvas& canvas = *itsCanvas;
+
+  const recti viewport = canvas.getScreenViewport();
+
+  itsFrameLog.markStart();
+
+  try
+    {
+      Gfx::MatrixSaver msaver(canvas);
+      Gfx::AttribSaver asaver(canvas);
+
+      itsCamera->draw(canvas);
+
+      std::vector<Damage::Item> now;
+      Damage::collect(canvas, *sep, now);
+
+      // A child is damaged if it changed or moved; and a change in a
+      // child that draws nothing (e.g. a transform or a color) can
+      // affect every child after it.
+      std::vector<recti> rects;
+      bool stateChanged = false;
+
+      for (size_t i = 0; i < now.size(); ++i)
+        {
+          const Damage::Item& was = d.items[i];
+          const Damage::Item& is = now[i];
+
+          const bool changed = (is.changes != was.changes);
+
+          if (changed && is.empty)
+            stateChanged = true;
+
+          if (changed || stateChanged || is.empty != was.empty
+              || (!is.empty && (is.bounds.left() != was.bounds.left()
+                                || is.bounds.right() != was.bounds.right()
+                                || is.bounds.bottom() != was.bounds.bottom()
+                                || is.bounds.top() != was.bounds.top())))
+            {
+              if (!was.empty) addDamage(rects, was.bounds);
+              if (!is.empty)  addDamage(rects, is.bounds);
+            }
+        }
+
+      long pixels = 0;
+      for (const recti& r: rects)
+        pixels += area(r, viewport);
+
+      // If most of the canvas is damaged anyway, a full redraw is
+      // just as cheap and avoids the scissor overhead.
+      if (2 * pixels > area(viewport, viewport))
+        return false;
+
+      // With double-buffering, the back buffer doesn't hold the
+      // current frame, so we patch up the front buffer instead.
+      const bool front = canvas.isDoubleBuffered();
+
+      if (front)
+        canvas.drawOnFrontBuffer();
+
+      for (const recti& r: rects)
+        {
+          Gfx::MatrixSaver state(canvas);
+          Gfx::AttribSaver attribs(canvas);
+
+          canvas.setScissor(r);
+          canvas.clearColorBuffer(r);
+
+          for (size_t i = 0; i < now.size(); ++i)
+            if (now[i].empty || overlaps(now[i].bounds, r))
+              sep->getChild(i)->draw(canvas);
+        }
+
+      itsFrameLog.markRendered();
+
+      // Patching the front buffer involves no swap, so the frame is
+      // on screen as soon as finishDrawing() returns.
+      if (front)
+        {
+          canvas.finishDrawing();
+          canvas.drawOnBackBuffer();
+          itsFrameLog.markSwapped();
+          itsFrameLog.markPresented();
+          itsFrameLog.commit();
+        }
+      else
+        {
+          flushOutput();
+        }
+
+      d.items.swap(now);
+      d.drawChanges = itsDrawNode->numNodeChanges();
+
+      itsUndrawNode = itsDrawNode;
+      isItRefreshed = true;
+
+      d.countFrame(pixels, true);
+    }
+  catch (...)
+    {
+      // Here, something failed during rendering, so just go invisible
+      setVisibility(false);
+      throw;
+    }
+
+  return true;
 }
 
 void GxScene::undraw()
@@ -118,6 +573,7 @@ void GxScene::undraw()
 GVX_TRACE("GxScene::undraw");
   itsUndrawNode->undraw(*itsCanvas);
   itsCanvas->flushOutput();
+  itsDamage->invalidate();
 }
 
 void GxScene::clearscreen()
@@ -127,6 +583,7 @@ GVX_TRACE("GxScene::clearscreen");
   setDrawable(nub::ref<GxNode>(GxEmptyNode::make()));
   itsUndrawNode = nub::ref<GxNode>(GxEmptyNode::make());
   isItVisible = false;
+  itsDamage->invalidate();
 }
 
 void GxScene::fullClearscreen()
@@ -153,6 +610,8 @@ GVX_TRACE("GxScene::setCamera");
 
   itsCamera = cam;
 
+  itsDamage->invalidate();
+
   itsCamera->reshape(*itsCanvas, itsWidth, itsHeight);
 
   itsCamera->sigNodeChanged.connect(this, &GxScene::onNodeChange);
@@ -167,6 +626,8 @@ GVX_TRACE("GxScene::setDrawable");
 
   itsDrawNode = node;
 
+  itsDamage->invalidate();
+
   itsDrawNode->sigNodeChanged.connect(this, &GxScene::onNodeChange);
 }
 
@@ -176,7 +637,8 @@ GVX_TRACE("GxScene::flushChanges");
   if (isItRefreshing && !isItRefreshed)
     {
       itsCamera->reshape(*itsCanvas, itsWidth, itsHeight);
-      fullRender();
+      if (!isItDamageTracking || !partialRender())
+        fullRender();
     }
 }
 
@@ -208,3 +670,28 @@ GVX_TRACE("GxScene::animate");
       itsTimer.schedule(itsScheduler);
     }
 }
+
+void GxScene::setDamageTracking(bool val)
+{
+GVX_TRACE("GxScene::setDamageTracking");
+  isItDamageTracking = val;
+  itsDamage->invalidate();
+}
+
+bool GxScene::isDamageTracking() const
+{
+GVX_TRACE("GxScene::isDamageTracking");
+  return isItDamageTracking;
+}
+
+GxScene::DamageStats GxScene::damageStats() const
+{
+GVX_TRACE("GxScene::damageStats");
+  return itsDamage->stats;
+}
+
+void GxScene::resetDamageStats()
+{
+GVX_TRACE("GxScene::resetDamageStats");
+  itsDamage->stats = DamageStats();
+}
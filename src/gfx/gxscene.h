@@ -34,6 +34,7 @@
 #define GROOVX_GFX_GXSCENE_H_UTC20050626084024_DEFINED
 
 #include "gfx/canvas.h"
+#include "gfx/framelog.h"
 #include "gfx/gxcamera.h"
 #include "gfx/gxemptynode.h"
 #include "gfx/gxnode.h"
@@ -44,6 +45,11 @@
 
 #include <memory>
 
+namespace media
+{
+  class bmap_data;
+}
+
 namespace nub
 {
   class scheduler;
@@ -75,6 +81,35 @@ public:
       necessary. */
   void fullRender();
 
+  /// Flush the graphics stream and swap buffers if necessary.
+  /** Use this rather than Canvas::flushOutput() after render() or
+      renderFrame(), so that the frame is logged in frameLog(). */
+  void flushOutput();
+
+  /// Render \a node off-screen through the current camera, and return the pixels.
+  /** The node is drawn into the back buffer, read back with
+      Canvas::grabDrawnPixels(), and then the back buffer is restored,
+      so nothing appears on screen. If a frame was drawn with render()
+      or renderFrame() but not yet flushed, it is read back first and
+      redrawn afterwards, so that it is still the one that the next
+      flushOutput() swaps to the screen. Throws on a single-buffered
+      canvas, which has no buffer to spare. The result can later be
+      shown with showFrame(). */
+  media::bmap_data preRender(const GxNode& node);
+
+  /// "Bare-bones" drawing of a frame previously made by preRender().
+  /** The pixels are copied to the viewport; as with render(), the
+      caller is expected to flush the graphics stream afterwards. The
+      caller should also have installed the node from which the frame
+      was made with setDrawable(), so that any later redraw shows the
+      same thing. */
+  void renderFrame(const media::bmap_data& frame);
+
+  /// "Full-featured" drawing of a frame previously made by preRender().
+  /** Like renderFrame(), but then flushes the graphics stream and
+      swaps buffers if necessary. */
+  void showFrame(const media::bmap_data& frame);
+
   /// "Bare-bones clearscreen"
   /** Clears the color buffer and set the current object to empty, but
       don't flush the graphics stream. */
@@ -114,10 +149,51 @@ public:
   /// Redraw the scene at a given frame rate.
   void animate(unsigned int framesPerSecond);
 
+  /// Whether to redraw only the damaged parts of the scene on a change.
+  /** With damage tracking on, a change that can be traced to
+      particular children of a GxSeparator drawable is redrawn by
+      clearing just the union of the old and new screen bounds of
+      those children, and redrawing (under a scissor rect) only the
+      children that intersect that damage. Any other kind of change
+      (camera, window size, drawable, or a change to the separator
+      itself) still triggers a full redraw. */
+  void setDamageTracking(bool val);
+
+  /// Query whether damage tracking is on.
+  bool isDamageTracking() const;
+
+  /// Counters describing how much of the canvas was redrawn.
+  struct DamageStats
+  {
+    unsigned long frames;        ///< all frames drawn by fullRender() or on a change
+    unsigned long partialFrames; ///< frames that redrew only the damaged rects
+    unsigned long lastPixels;    ///< pixels redrawn in the most recent frame
+    unsigned long long pixels;   ///< pixels redrawn in all frames
+  };
+
+  /// Get the redraw counters.
+  DamageStats damageStats() const;
+
+  /// Reset the redraw counters to zero.
+  void resetDamageStats();
+
+  /// Get the log of frame render, swap and present times.
+  Gfx::FrameLog& frameLog() { return itsFrameLog; }
+
+  /// Get the log of frame render, swap and present times.
+  const Gfx::FrameLog& frameLog() const { return itsFrameLog; }
+
 private:
   void flushChanges();
   void onNodeChange();
 
+  struct Damage;
+
+  void recordDamageBaseline();
+  bool partialRender();
+
+  void drawPixelsToViewport(const media::bmap_data& frame);
+
   GxScene(const GxScene&);
   GxScene& operator=(const GxScene&);
 
@@ -132,9 +208,15 @@ private:
   bool isItHolding;
   bool isItRefreshing;
   bool isItRefreshed;
+  bool isItSwapPending; // a frame is in the back buffer, awaiting flushOutput()
 
   const std::shared_ptr<nub::scheduler> itsScheduler;
   nub::timer itsTimer;
+
+  bool isItDamageTracking;
+  std::unique_ptr<Damage> itsDamage;
+
+  Gfx::FrameLog itsFrameLog;
 };
 
 #endif // !GROOVX_GFX_GXSCENE_H_UTC20050626084024_DEFINED
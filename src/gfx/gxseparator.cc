@@ -291,7 +291,7 @@ GVX_TRACE("GxSeparator::getBoundingCube");
       bbox.push();
 
       for (const auto& noderef: rep->children)
-        noderef->getBoundingCube(bbox);
+        noderef->getCachedBoundingCube(bbox);
 
       bbox.pop();
     }
@@ -322,7 +322,7 @@ GVX_TRACE("GxSeparator::draw");
   if (rep->debugMode)
     {
       Gfx::Bbox bbox(canvas);
-      getBoundingCube(bbox);
+      getCachedBoundingCube(bbox);
       canvas.drawBox(bbox.cube());
     }
 
@@ -46,6 +46,8 @@
 
 #include "nub/volatileobject.h"
 
+#include "rutz/fstring.h"
+
 #define GVX_TRACE_EXPR GxShapeKit::tracer.status()
 #include "rutz/trace.h"
 #include "rutz/debug.h"
@@ -59,9 +61,10 @@ GVX_DBG_REGISTER
 class GxShapeKitNode : public GxBin
 {
   GxShapeKit* itsObj;
+  mutable rutz::fstring itsTypename;
 
 public:
-  GxShapeKitNode(GxShapeKit* obj) : GxBin(), itsObj(obj) {}
+  GxShapeKitNode(GxShapeKit* obj) : GxBin(), itsObj(obj), itsTypename() {}
 
   virtual ~GxShapeKitNode() noexcept {}
 
@@ -69,7 +72,24 @@ public:
   virtual void write_to(io::writer& /*writer*/) const override {}
 
   virtual void draw(Gfx::Canvas& canvas) const override
-  { itsObj->grRender(canvas); }
+  {
+    // Few canvases make any use of labels (Gfx::PSCanvas counts bytes
+    // per node type), so don't pay for a matrix push on the others.
+    if (!canvas.wantsLabels())
+      {
+        itsObj->grRender(canvas);
+        return;
+      }
+
+    // Label the output with the object's type. We can't get the type
+    // name in our constructor, since that runs while the GxShapeKit
+    // base is still under construction.
+    if (itsTypename.is_empty())
+      itsTypename = itsObj->obj_typename();
+
+    Gfx::MatrixSaver msaver(canvas, itsTypename.c_str());
+    itsObj->grRender(canvas);
+  }
 
   virtual void getBoundingCube(Gfx::Bbox& bbox) const override
   {
@@ -135,6 +155,11 @@ public:
   void invalidateCaches()
   {
     cache->invalidate();
+
+    // The native node's bounds come from the GxShapeKit itself, so
+    // they (and the bounds of the aligner, scaler, etc. above it)
+    // are stale now too.
+    nativeNode->sigNodeChanged.emit();
   }
 };
 
@@ -268,7 +293,7 @@ void GxShapeKit::getBoundingCube(Gfx::Bbox& bbox) const
 {
 GVX_TRACE("GxShapeKit::getBoundingCube");
 
-  rep->topNode->getBoundingCube(bbox);
+  rep->topNode->getCachedBoundingCube(bbox);
 }
 
 int GxShapeKit::getScalingMode() const
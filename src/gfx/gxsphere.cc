@@ -75,9 +75,11 @@ GxSphere::GxSphere() :
   itsRadius(1.0),
   itsSlices(50),
   itsStacks(50),
-  itsFilled(true)
+  itsFilled(true),
+  itsMesh()
 {
 GVX_TRACE("GxSphere::GxSphere");
+  sigNodeChanged.connect([this]() { this->itsMesh.clear(); });
   setFieldMap(GxSphere::classFields());
 }
 
@@ -125,5 +127,8 @@ void GxSphere::draw(Gfx::Canvas& canvas) const
 {
 GVX_TRACE("GxSphere::draw");
 
-  canvas.drawSphere(itsRadius, itsSlices, itsStacks, itsFilled);
+  if (itsMesh.isEmpty())
+    itsMesh = Gfx::Mesh::sphere(itsRadius, itsSlices, itsStacks, itsFilled);
+
+  itsMesh.draw(canvas);
 }
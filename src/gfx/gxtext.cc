@@ -78,6 +78,7 @@ GxText::GxText(const char* text) :
 {
 GVX_TRACE("GxText::GxText(const char*)");
 
+  setFieldMap(GxText::classFields());
   setAlignmentMode(GxAligner::CENTER_ON_CENTER);
   setScalingMode(GxScaler::MAINTAIN_ASPECT_SCALING);
   setRenderMode(GxCache::GLCOMPILE);
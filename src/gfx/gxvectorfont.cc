@@ -32,6 +32,8 @@
 #include "gxvectorfont.h"
 
 #include "geom/rect.h"
+#include "geom/vec2.h"
+#include "geom/vec3.h"
 
 #include "gfx/bbox.h"
 #include "gfx/canvas.h"
@@ -626,6 +628,125 @@ namespace
     {0.5, 5, PT}, {1.5, 6, PT}, {2.5, 5, PT}, {3.5, 6, END}
   };
 
+//---------------------------------------------------------------------
+//
+// glyphTable -- stroke data indexed by character code
+//
+//---------------------------------------------------------------------
+
+  struct GlyphTable
+  {
+    GlyphTable()
+    {
+      for (CP*& p: data)
+        p = nullptr;
+
+      data[int('A')] = Adata;
+      data[int('B')] = Bdata;
+      data[int('C')] = Cdata;
+      data[int('D')] = Ddata;
+      data[int('E')] = Edata;
+      data[int('F')] = Fdata;
+      data[int('G')] = Gdata;
+      data[int('H')] = Hdata;
+      data[int('I')] = Idata;
+      data[int('J')] = Jdata;
+      data[int('K')] = Kdata;
+      data[int('L')] = Ldata;
+      data[int('M')] = Mdata;
+      data[int('N')] = Ndata;
+      data[int('O')] = Odata;
+      data[int('P')] = Pdata;
+      data[int('Q')] = Qdata;
+      data[int('R')] = Rdata;
+      data[int('S')] = Sdata;
+      data[int('T')] = Tdata;
+      data[int('U')] = Udata;
+      data[int('V')] = Vdata;
+      data[int('W')] = Wdata;
+      data[int('X')] = Xdata;
+      data[int('Y')] = Ydata;
+      data[int('Z')] = Zdata;
+      data[int('a')] = adata;
+      data[int('b')] = bdata;
+      data[int('c')] = cdata;
+      data[int('d')] = ddata;
+      data[int('e')] = edata;
+      data[int('f')] = fdata;
+      data[int('g')] = gdata;
+      data[int('h')] = hdata;
+      data[int('i')] = idata;
+      data[int('j')] = jdata;
+      data[int('k')] = kdata;
+      data[int('l')] = ldata;
+      data[int('m')] = mdata;
+      data[int('n')] = ndata;
+      data[int('o')] = odata;
+      data[int('p')] = pdata;
+      data[int('q')] = qdata;
+      data[int('r')] = rdata;
+      data[int('s')] = sdata;
+      data[int('t')] = tdata;
+      data[int('u')] = udata;
+      data[int('v')] = vdata;
+      data[int('w')] = wdata;
+      data[int('x')] = xdata;
+      data[int('y')] = ydata;
+      data[int('z')] = zdata;
+      data[int('0')] = n0data;
+      data[int('1')] = n1data;
+      data[int('2')] = n2data;
+      data[int('3')] = n3data;
+      data[int('4')] = n4data;
+      data[int('5')] = n5data;
+      data[int('6')] = n6data;
+      data[int('7')] = n7data;
+      data[int('8')] = n8data;
+      data[int('9')] = n9data;
+      data[int(' ')] = space_data;
+      data[int('!')] = exclamation_data;
+      data[int('"')] = double_quote_data;
+      data[int('#')] = pound_sign_data;
+      data[int('$')] = dollar_sign_data;
+      data[int('%')] = percent_data;
+      data[int('&')] = ampersand_data;
+      data[int('\'')] = apostrophe_data;
+      data[int('(')] = left_paren_data;
+      data[int(')')] = right_paren_data;
+      data[int('*')] = asterisk_data;
+      data[int('+')] = plus_data;
+      data[int(',')] = comma_data;
+      data[int('-')] = hyphen_data;
+      data[int('.')] = period_data;
+      data[int('/')] = slash_data;
+      data[int(':')] = colon_data;
+      data[int(';')] = semicolon_data;
+      data[int('<')] = left_angle_data;
+      data[int('=')] = equal_data_data;
+      data[int('>')] = right_angle_data;
+      data[int('?')] = question_data;
+      data[int('@')] = at_data;
+      data[int('[')] = left_square_data;
+      data[int('\\')] = backslash_data;
+      data[int(']')] = right_square_data;
+      data[int('^')] = caret_data;
+      data[int('_')] = underscore_data;
+      data[int('`')] = backquote_data;
+      data[int('{')] = left_curly_data;
+      data[int('|')] = vertical_bar_data;
+      data[int('}')] = right_curly_data;
+      data[int('~')] = tilde_data;
+    }
+
+    CP* data[128];
+  };
+
+  const GlyphTable& glyphTable()
+  {
+    static const GlyphTable table;
+    return table;
+  }
+
 //---------------------------------------------------------------------
 //
 // drawLetter -- parses stroke data into OpenGL code
@@ -676,104 +797,21 @@ namespace
     // (for 'A') doesn't get compiled correctly.
     glNewList(listBase + 0, GL_COMPILE); glEndList();
 
-    glNewList(listBase + 'A', GL_COMPILE); drawLetter(Adata); glEndList();
-    glNewList(listBase + 'B', GL_COMPILE); drawLetter(Bdata); glEndList();
-    glNewList(listBase + 'C', GL_COMPILE); drawLetter(Cdata); glEndList();
-    glNewList(listBase + 'D', GL_COMPILE); drawLetter(Ddata); glEndList();
-    glNewList(listBase + 'E', GL_COMPILE); drawLetter(Edata); glEndList();
-    glNewList(listBase + 'F', GL_COMPILE); drawLetter(Fdata); glEndList();
-    glNewList(listBase + 'G', GL_COMPILE); drawLetter(Gdata); glEndList();
-    glNewList(listBase + 'H', GL_COMPILE); drawLetter(Hdata); glEndList();
-    glNewList(listBase + 'I', GL_COMPILE); drawLetter(Idata); glEndList();
-    glNewList(listBase + 'J', GL_COMPILE); drawLetter(Jdata); glEndList();
-    glNewList(listBase + 'K', GL_COMPILE); drawLetter(Kdata); glEndList();
-    glNewList(listBase + 'L', GL_COMPILE); drawLetter(Ldata); glEndList();
-    glNewList(listBase + 'M', GL_COMPILE); drawLetter(Mdata); glEndList();
-    glNewList(listBase + 'N', GL_COMPILE); drawLetter(Ndata); glEndList();
-    glNewList(listBase + 'O', GL_COMPILE); drawLetter(Odata); glEndList();
-    glNewList(listBase + 'P', GL_COMPILE); drawLetter(Pdata); glEndList();
-    glNewList(listBase + 'Q', GL_COMPILE); drawLetter(Qdata); glEndList();
-    glNewList(listBase + 'R', GL_COMPILE); drawLetter(Rdata); glEndList();
-    glNewList(listBase + 'S', GL_COMPILE); drawLetter(Sdata); glEndList();
-    glNewList(listBase + 'T', GL_COMPILE); drawLetter(Tdata); glEndList();
-    glNewList(listBase + 'U', GL_COMPILE); drawLetter(Udata); glEndList();
-    glNewList(listBase + 'V', GL_COMPILE); drawLetter(Vdata); glEndList();
-    glNewList(listBase + 'W', GL_COMPILE); drawLetter(Wdata); glEndList();
-    glNewList(listBase + 'X', GL_COMPILE); drawLetter(Xdata); glEndList();
-    glNewList(listBase + 'Y', GL_COMPILE); drawLetter(Ydata); glEndList();
-    glNewList(listBase + 'Z', GL_COMPILE); drawLetter(Zdata); glEndList();
-
-    glNewList(listBase + 'a', GL_COMPILE); drawLetter(adata); glEndList();
-    glNewList(listBase + 'b', GL_COMPILE); drawLetter(bdata); glEndList();
-    glNewList(listBase + 'c', GL_COMPILE); drawLetter(cdata); glEndList();
-    glNewList(listBase + 'd', GL_COMPILE); drawLetter(ddata); glEndList();
-    glNewList(listBase + 'e', GL_COMPILE); drawLetter(edata); glEndList();
-    glNewList(listBase + 'f', GL_COMPILE); drawLetter(fdata); glEndList();
-    glNewList(listBase + 'g', GL_COMPILE); drawLetter(gdata); glEndList();
-    glNewList(listBase + 'h', GL_COMPILE); drawLetter(hdata); glEndList();
-    glNewList(listBase + 'i', GL_COMPILE); drawLetter(idata); glEndList();
-    glNewList(listBase + 'j', GL_COMPILE); drawLetter(jdata); glEndList();
-    glNewList(listBase + 'k', GL_COMPILE); drawLetter(kdata); glEndList();
-    glNewList(listBase + 'l', GL_COMPILE); drawLetter(ldata); glEndList();
-    glNewList(listBase + 'm', GL_COMPILE); drawLetter(mdata); glEndList();
-    glNewList(listBase + 'n', GL_COMPILE); drawLetter(ndata); glEndList();
-    glNewList(listBase + 'o', GL_COMPILE); drawLetter(odata); glEndList();
-    glNewList(listBase + 'p', GL_COMPILE); drawLetter(pdata); glEndList();
-    glNewList(listBase + 'q', GL_COMPILE); drawLetter(qdata); glEndList();
-    glNewList(listBase + 'r', GL_COMPILE); drawLetter(rdata); glEndList();
-    glNewList(listBase + 's', GL_COMPILE); drawLetter(sdata); glEndList();
-    glNewList(listBase + 't', GL_COMPILE); drawLetter(tdata); glEndList();
-    glNewList(listBase + 'u', GL_COMPILE); drawLetter(udata); glEndList();
-    glNewList(listBase + 'v', GL_COMPILE); drawLetter(vdata); glEndList();
-    glNewList(listBase + 'w', GL_COMPILE); drawLetter(wdata); glEndList();
-    glNewList(listBase + 'x', GL_COMPILE); drawLetter(xdata); glEndList();
-    glNewList(listBase + 'y', GL_COMPILE); drawLetter(ydata); glEndList();
-    glNewList(listBase + 'z', GL_COMPILE); drawLetter(zdata); glEndList();
-
-    glNewList(listBase + '0', GL_COMPILE); drawLetter(n0data); glEndList();
-    glNewList(listBase + '1', GL_COMPILE); drawLetter(n1data); glEndList();
-    glNewList(listBase + '2', GL_COMPILE); drawLetter(n2data); glEndList();
-    glNewList(listBase + '3', GL_COMPILE); drawLetter(n3data); glEndList();
-    glNewList(listBase + '4', GL_COMPILE); drawLetter(n4data); glEndList();
-    glNewList(listBase + '5', GL_COMPILE); drawLetter(n5data); glEndList();
-    glNewList(listBase + '6', GL_COMPILE); drawLetter(n6data); glEndList();
-    glNewList(listBase + '7', GL_COMPILE); drawLetter(n7data); glEndList();
-    glNewList(listBase + '8', GL_COMPILE); drawLetter(n8data); glEndList();
-    glNewList(listBase + '9', GL_COMPILE); drawLetter(n9data); glEndList();
-
-    glNewList(listBase + ' ', GL_COMPILE); drawLetter(space_data); glEndList();
-    glNewList(listBase + '!', GL_COMPILE); drawLetter(exclamation_data); glEndList();
-    glNewList(listBase + '"', GL_COMPILE); drawLetter(double_quote_data); glEndList();
-    glNewList(listBase + '#', GL_COMPILE); drawLetter(pound_sign_data); glEndList();
-    glNewList(listBase + '$', GL_COMPILE); drawLetter(dollar_sign_data); glEndList();
-    glNewList(listBase + '%', GL_COMPILE); drawLetter(percent_data); glEndList();
-    glNewList(listBase + '&', GL_COMPILE); drawLetter(ampersand_data); glEndList();
-    glNewList(listBase + '\'', GL_COMPILE); drawLetter(apostrophe_data); glEndList();
-    glNewList(listBase + '(', GL_COMPILE); drawLetter(left_paren_data); glEndList();
-    glNewList(listBase + ')', GL_COMPILE); drawLetter(right_paren_data); glEndList();
-    glNewList(listBase + '*', GL_COMPILE); drawLetter(asterisk_data); glEndList();
-    glNewList(listBase + '+', GL_COMPILE); drawLetter(plus_data); glEndList();
-    glNewList(listBase + ',', GL_COMPILE); drawLetter(comma_data); glEndList();
-    glNewList(listBase + '-', GL_COMPILE); drawLetter(hyphen_data); glEndList();
-    glNewList(listBase + '.', GL_COMPILE); drawLetter(period_data); glEndList();
-    glNewList(listBase + '/', GL_COMPILE); drawLetter(slash_data); glEndList();
-    glNewList(listBase + ':', GL_COMPILE); drawLetter(colon_data); glEndList();
-    glNewList(listBase + ';', GL_COMPILE); drawLetter(semicolon_data); glEndList();
-    glNewList(listBase + '<', GL_COMPILE); drawLetter(left_angle_data); glEndList();
-    glNewList(listBase + '=', GL_COMPILE); drawLetter(equal_data_data); glEndList();
-    glNewList(listBase + '>', GL_COMPILE); drawLetter(right_angle_data); glEndList();
-    glNewList(listBase + '?', GL_COMPILE); drawLetter(question_data); glEndList();
-    glNewList(listBase + '@', GL_COMPILE); drawLetter(at_data); glEndList();
-    glNewList(listBase + '[', GL_COMPILE); drawLetter(left_square_data); glEndList();
-    glNewList(listBase + '\\', GL_COMPILE); drawLetter(backslash_data); glEndList();
-    glNewList(listBase + ']', GL_COMPILE); drawLetter(right_square_data); glEndList();
-    glNewList(listBase + '^', GL_COMPILE); drawLetter(caret_data); glEndList();
-    glNewList(listBase + '_', GL_COMPILE); drawLetter(underscore_data); glEndList();
-    glNewList(listBase + '`', GL_COMPILE); drawLetter(backquote_data); glEndList();
-    glNewList(listBase + '{', GL_COMPILE); drawLetter(left_curly_data); glEndList();
-    glNewList(listBase + '|', GL_COMPILE); drawLetter(vertical_bar_data); glEndList();
-    glNewList(listBase + '}', GL_COMPILE); drawLetter(right_curly_data); glEndList();
-    glNewList(listBase + '~', GL_COMPILE); drawLetter(tilde_data); glEndList();
+    const GlyphTable& glyphs = glyphTable();
+
+    for (int c = 1; c < 128; ++c)
+      {
+        if (glyphs.data[c] != nullptr)
+          {
+            glNewList(listBase + GLuint(c), GL_COMPILE);
+            drawLetter(glyphs.data[c]);
+            glEndList();
+          }
+      }
+
+
+
+
 
     return listBase;
   }
@@ -787,7 +825,8 @@ namespace
 ///////////////////////////////////////////////////////////////////////
 
 
-GxVectorFont::GxVectorFont()
+GxVectorFont::GxVectorFont() :
+  itsSegments()
 {
 GVX_TRACE("GxVectorFont::GxVectorFont");
 }
@@ -859,3 +898,65 @@ double GxVectorFont::vectorHeight() const
 GVX_TRACE("GxVectorFont::vectorHeight");
   return 8.0;
 }
+
+void GxVectorFont::drawStrokes(const char* text, Gfx::Canvas& canvas) const
+{
+GVX_TRACE("GxVectorFont::drawStrokes");
+
+  const std::vector<float>& segs = segmentsOf(text);
+
+  Gfx::LinesBlock block(canvas);
+
+  for (size_t i = 0; i + 1 < segs.size(); i += 2)
+    canvas.vertex2(geom::vec2<double>(segs[i], segs[i+1]));
+}
+
+const std::vector<float>& GxVectorFont::segmentsOf(const char* text) const
+{
+GVX_TRACE("GxVectorFont::segmentsOf");
+
+  if (const std::vector<float>* cached = itsSegments.find(text))
+    return *cached;
+
+  const GlyphTable& glyphs = glyphTable();
+
+  std::vector<float> segs;
+
+  float xoff = 0.0f;
+  float yoff = 0.0f;
+
+  for (const char* p = text; *p != '\0'; ++p)
+    {
+      if (*p == '\n')
+        {
+          xoff = 0.0f;
+          yoff -= float(vectorHeight());
+          continue;
+        }
+
+      const unsigned char c = static_cast<unsigned char>(*p);
+      if (c >= 128 || glyphs.data[c] == nullptr)
+        continue;
+
+      // Each point joins to the previous one, unless the previous one
+      // ended a stroke, just as with GL_LINE_STRIP in drawLetter().
+      bool connected = false;
+      for (const CP* cp = glyphs.data[c]; ; ++cp)
+        {
+          if (connected)
+            {
+              segs.push_back(xoff + cp[-1].x); segs.push_back(yoff + cp[-1].y);
+              segs.push_back(xoff + cp->x);    segs.push_back(yoff + cp->y);
+            }
+
+          if (cp->type == END)
+            break;
+
+          connected = (cp->type == PT);
+        }
+
+      xoff += 5.0f;
+    }
+
+  return itsSegments.insert(text, segs);
+}
@@ -33,6 +33,9 @@
 #define GROOVX_GFX_GXVECTORFONT_H_UTC20050626084023_DEFINED
 
 #include "gfx/gxfont.h"
+#include "gfx/textcache.h"
+
+#include <vector>
 
 /// A basic "blocky" vector-graphics font.
 class GxVectorFont : public GxFont
@@ -53,9 +56,22 @@ public:
   /// Return the vector height of the font, in world coords.
   double vectorHeight() const;
 
+  /// Draw \a text as line strips through the generic Canvas interface.
+  /** This is for canvases that can't use OpenGL display lists. Each
+      glyph advances 5 units, and lines are vectorHeight() apart. */
+  void drawStrokes(const char* text, Gfx::Canvas& canvas) const;
+
+  /// Get the strokes of \a text as independent line segments.
+  /** The result holds (x,y) pairs, two vertices per segment, laid out
+      the same way as drawStrokes(); it is suitable for a single
+      GL_LINES draw call. Results are cached per string. */
+  const std::vector<float>& segmentsOf(const char* text) const;
+
 private:
   GxVectorFont(const GxVectorFont&);
   GxVectorFont& operator=(const GxVectorFont&);
+
+  mutable Gfx::TextCache<std::vector<float> > itsSegments;
 };
 
 #endif // !GROOVX_GFX_GXVECTORFONT_H_UTC20050626084023_DEFINED
@@ -107,6 +107,14 @@ GVX_TRACE("Gfx::LineStrip::drawBezier4");
     }
 }
 
+void Gfx::LineStrip::vertices(const std::vector<vec3d>& curve,
+                              unsigned int start)
+{
+GVX_TRACE("Gfx::LineStrip::vertices");
+  for (size_t i = start; i < curve.size(); ++i)
+    this->vertex(vec2d(curve[i].x(), curve[i].y()));
+}
+
 void Gfx::LineStrip::end()
 {
 GVX_TRACE("Gfx::LineStrip::end");
@@ -76,6 +76,11 @@ namespace Gfx
                      unsigned int subdivisions,
                      unsigned int start = 0);
 
+    /// Generates a series of vertex() calls for precomputed curve points.
+    /** The z coordinates are ignored; points before \a start are skipped. */
+    void vertices(const std::vector<geom::vec3<double> >& curve,
+                  unsigned int start = 0);
+
     void end();
 
   private:
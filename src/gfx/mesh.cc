@@ -0,0 +1,218 @@
+/** @file gfx/mesh.cc retained vertex arrays for procedurally generated
+    primitives (spheres, cylinders, line patterns) */
+
+///////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026-2026 Rob Peters
+// Rob Peters <https://github.com/rjpcal/>
+//
+// created: Mon Oct 19 14:05:12 2026
+//
+// --------------------------------------------------------------------
+//
+// This file is part of GroovX.
+//   [https://github.com/rjpcal/groovx]
+//
+// GroovX is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// GroovX is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GroovX; if not, write to the Free Software Foundation,
+// Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include "gfx/mesh.h"
+
+#include <cmath>
+
+#include "rutz/trace.h"
+#include "rutz/debug.h"
+GVX_DBG_REGISTER
+
+using geom::vec3d;
+
+Gfx::Mesh::Mesh() :
+  itsVerts(),
+  itsNormals(),
+  itsParts()
+{}
+
+void Gfx::Mesh::begin(Gfx::Canvas::VertexStyle s)
+{
+  itsParts.push_back(Part{s, itsVerts.size(), 0});
+}
+
+void Gfx::Mesh::vertex(const vec3d& v)
+{
+  GVX_ASSERT(!itsParts.empty());
+  itsVerts.push_back(v);
+  ++itsParts.back().count;
+}
+
+void Gfx::Mesh::vertex(const vec3d& v, const vec3d& n)
+{
+  vertex(v);
+  itsNormals.push_back(n);
+}
+
+void Gfx::Mesh::clear() noexcept
+{
+  itsVerts.clear();
+  itsNormals.clear();
+  itsParts.clear();
+}
+
+void Gfx::Mesh::draw(Gfx::Canvas& canvas) const
+{
+GVX_TRACE("Gfx::Mesh::draw");
+
+  const bool normals = (itsNormals.size() == itsVerts.size());
+
+  for (const Part& p: itsParts)
+    canvas.drawArrays(p.style, &itsVerts[p.first],
+                      normals ? &itsNormals[p.first] : nullptr,
+                      p.count);
+}
+
+Gfx::Mesh Gfx::Mesh::cylinder(double base_radius, double top_radius,
+                              double height, int slices, int stacks,
+                              bool fill)
+{
+GVX_TRACE("Gfx::Mesh::cylinder");
+
+  Mesh m;
+
+  if (slices < 3 || stacks < 1)
+    return m;
+
+  // same vertex placement and normals as gluCylinder()
+
+  std::vector<double> sines(slices), cosines(slices);
+  for (int i = 0; i < slices; ++i)
+    {
+      const double a = 2.0 * M_PI * i / slices;
+      sines[i] = std::sin(a);
+      cosines[i] = std::cos(a);
+    }
+
+  const double nz = height != 0.0 ? (base_radius - top_radius) / height : 0.0;
+  const double nlen = std::sqrt(1.0 + nz*nz);
+
+  auto pt = [&](int i, int j)
+    {
+      const double r = base_radius + (top_radius - base_radius) * j / stacks;
+      return vec3d(r * sines[i % slices], r * cosines[i % slices],
+                   height * j / stacks);
+    };
+
+  auto nm = [&](int i)
+    {
+      return vec3d(sines[i % slices] / nlen, cosines[i % slices] / nlen,
+                   nz / nlen);
+    };
+
+  if (fill)
+    {
+      for (int j = 0; j < stacks; ++j)
+        {
+          m.begin(Gfx::Canvas::VertexStyle::QUAD_STRIP);
+          for (int i = 0; i <= slices; ++i)
+            {
+              m.vertex(pt(i, j), nm(i));
+              m.vertex(pt(i, j+1), nm(i));
+            }
+        }
+    }
+  else
+    {
+      for (int j = 0; j <= stacks; ++j)
+        {
+          m.begin(Gfx::Canvas::VertexStyle::LINE_LOOP);
+          for (int i = 0; i < slices; ++i)
+            m.vertex(pt(i, j), nm(i));
+        }
+
+      m.begin(Gfx::Canvas::VertexStyle::LINES);
+      for (int j = 0; j < stacks; ++j)
+        for (int i = 0; i < slices; ++i)
+          {
+            m.vertex(pt(i, j), nm(i));
+            m.vertex(pt(i, j+1), nm(i));
+          }
+    }
+
+  return m;
+}
+
+Gfx::Mesh Gfx::Mesh::sphere(double radius, int slices, int stacks,
+                            bool fill)
+{
+GVX_TRACE("Gfx::Mesh::sphere");
+
+  Mesh m;
+
+  if (slices < 3 || stacks < 2)
+    return m;
+
+  // same vertex placement and normals as gluSphere(), from the +z
+  // pole down; each ring's unit vectors are computed once and shared
+  // by the two quad strips that touch it
+
+  std::vector<vec3d> unit((slices + 1) * (stacks + 1));
+  for (int j = 0; j <= stacks; ++j)
+    {
+      const double rho = M_PI * j / stacks;
+      const double sr = std::sin(rho), cr = std::cos(rho);
+      for (int i = 0; i <= slices; ++i)
+        {
+          const double theta = 2.0 * M_PI * (i % slices) / slices;
+          unit[j * (slices + 1) + i] =
+            vec3d(sr * -std::sin(theta), sr * std::cos(theta), cr);
+        }
+    }
+
+  auto add = [&](int i, int j)
+    {
+      const vec3d& n = unit[j * (slices + 1) + i];
+      m.vertex(n * radius, n);
+    };
+
+  if (fill)
+    {
+      for (int j = 0; j < stacks; ++j)
+        {
+          m.begin(Gfx::Canvas::VertexStyle::QUAD_STRIP);
+          for (int i = 0; i <= slices; ++i)
+            {
+              add(i, j);
+              add(i, j+1);
+            }
+        }
+    }
+  else
+    {
+      for (int j = 1; j < stacks; ++j)
+        {
+          m.begin(Gfx::Canvas::VertexStyle::LINE_LOOP);
+          for (int i = 0; i < slices; ++i)
+            add(i, j);
+        }
+
+      for (int i = 0; i < slices; ++i)
+        {
+          m.begin(Gfx::Canvas::VertexStyle::LINE_STRIP);
+          for (int j = 0; j <= stacks; ++j)
+            add(i, j);
+        }
+    }
+
+  return m;
+}
@@ -0,0 +1,113 @@
+/** @file gfx/mesh.h retained vertex arrays for procedurally generated
+    primitives (spheres, cylinders, line patterns) */
+
+///////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026-2026 Rob Peters
+// Rob Peters <https://github.com/rjpcal/>
+//
+// created: Mon Oct 19 14:05:12 2026
+//
+// --------------------------------------------------------------------
+//
+// This file is part of GroovX.
+//   [https://github.com/rjpcal/groovx]
+//
+// GroovX is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// GroovX is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GroovX; if not, write to the Free Software Foundation,
+// Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef GROOVX_GFX_MESH_H_UTC20261019140512_DEFINED
+#define GROOVX_GFX_MESH_H_UTC20261019140512_DEFINED
+
+#include "geom/vec3.h"
+
+#include "gfx/canvas.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace Gfx
+{
+  class Mesh;
+}
+
+///////////////////////////////////////////////////////////////////////
+/**
+ *
+ * Gfx::Mesh holds a series of vertex-series "parts" (each with its
+ * own Canvas::VertexStyle) in a single contiguous vertex array, with
+ * an optional parallel array of normals. Nodes that draw procedural
+ * primitives build a Mesh once when their parameters change, and then
+ * draw it each frame with one Canvas::drawArrays() call per part,
+ * instead of re-tessellating and issuing one virtual vertex call per
+ * vertex.
+ *
+ **/
+///////////////////////////////////////////////////////////////////////
+
+class Gfx::Mesh
+{
+public:
+  /// Construct an empty mesh.
+  Mesh();
+
+  /// Start a new part with vertex style \a s.
+  void begin(Gfx::Canvas::VertexStyle s);
+
+  /// Add a vertex to the current part.
+  void vertex(const geom::vec3<double>& v);
+
+  /// Add a vertex with a normal to the current part.
+  /** Either all or none of a mesh's vertices should have normals. */
+  void vertex(const geom::vec3<double>& v, const geom::vec3<double>& n);
+
+  /// Forget all parts and vertices.
+  void clear() noexcept;
+
+  /// Query whether the mesh has no vertices.
+  bool isEmpty() const { return itsVerts.empty(); }
+
+  /// Get the total number of vertices in all parts.
+  size_t numVertices() const { return itsVerts.size(); }
+
+  /// Get the number of parts (i.e. drawArrays() calls per draw()).
+  size_t numParts() const { return itsParts.size(); }
+
+  /// Draw all parts to \a canvas.
+  void draw(Gfx::Canvas& canvas) const;
+
+  /// Build a cylinder (or cone) with the same vertex placement as gluCylinder().
+  static Mesh cylinder(double base_radius, double top_radius,
+                       double height, int slices, int stacks,
+                       bool fill);
+
+  /// Build a sphere with the same vertex placement as gluSphere().
+  static Mesh sphere(double radius, int slices, int stacks, bool fill);
+
+private:
+  struct Part
+  {
+    Gfx::Canvas::VertexStyle style;
+    size_t first;
+    size_t count;
+  };
+
+  std::vector<geom::vec3<double>> itsVerts;
+  std::vector<geom::vec3<double>> itsNormals;
+  std::vector<Part> itsParts;
+};
+
+#endif // !GROOVX_GFX_MESH_H_UTC20261019140512_DEFINED
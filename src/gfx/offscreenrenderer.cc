@@ -0,0 +1,330 @@
+/** @file gfx/offscreenrenderer.cc render GxNode objects into images
+    without a window, optionally spreading a batch over worker processes */
+
+///////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026-2026 Rob Peters
+// Rob Peters <https://github.com/rjpcal/>
+//
+// created: Mon Oct 19 11:25:03 2026
+//
+// --------------------------------------------------------------------
+//
+// This file is part of GroovX.
+//   [https://github.com/rjpcal/groovx]
+//
+// GroovX is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// GroovX is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GroovX; if not, write to the Free Software Foundation,
+// Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include "gfx/offscreenrenderer.h"
+
+#include "geom/rect.h"
+
+#include "gfx/canvas.h"
+#include "gfx/eglwrapper.h"
+#include "gfx/glcanvas.h"
+#include "gfx/glxopts.h"
+#include "gfx/gxcamera.h"
+#include "gfx/gxnode.h"
+
+#include "media/bmapdata.h"
+#include "media/imgfile.h"
+
+#include "rutz/error.h"
+#include "rutz/fstring.h"
+#include "rutz/pipe.h"
+#include "rutz/sfmt.h"
+
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <string>
+#include <unistd.h>
+
+#include "rutz/trace.h"
+#include "rutz/debug.h"
+GVX_DBG_REGISTER
+
+class OffscreenRenderer::Impl
+{
+private:
+  Impl(const Impl&);
+  Impl& operator=(const Impl&);
+
+public:
+  Impl(int w, int h) :
+    opts(new GlxOpts),
+    glx(EglWrapper::make(*opts, w, h)),
+    canvas(GLCanvas::make(opts, glx),
+           nub::ref_type::STRONG, nub::ref_vis_private()),
+    camera(GxFixedScaleCamera::make(), nub::ref_vis_private())
+  {}
+
+  ~Impl()
+  {
+    if (canvas.is_valid()) canvas->destroy();
+  }
+
+  std::shared_ptr<GlxOpts>      const opts;
+  std::shared_ptr<EglWrapper>   const glx;
+  nub::soft_ref<GLCanvas>       const canvas;
+  nub::ref<GxCamera>                  camera;
+};
+
+namespace
+{
+  // Render frames i, i+stride, i+2*stride, ... calling emit(i, hash)
+  // for each one.
+  template <class F>
+  void renderSlice(OffscreenRenderer& r,
+                   const std::vector<nub::ref<GxNode>>& nodes,
+                   const std::vector<rutz::fstring>& filenames,
+                   size_t first, size_t stride, F emit)
+  {
+    for (size_t i = first; i < nodes.size(); i += stride)
+      {
+        uint32_t hash = 0;
+
+        try
+          {
+            const media::bmap_data frame = r.render(*nodes[i]);
+
+            if (!filenames.empty())
+              media::save_image(filenames[i].c_str(), frame);
+
+            hash = frame.bkdr_hash();
+          }
+        catch (std::exception& e)
+          {
+            throw rutz::error(rutz::sfmt("error rendering frame %u (%s): %s",
+                                         unsigned(i),
+                                         nodes[i]->unique_name().c_str(),
+                                         e.what()), SRC_POS);
+          }
+
+        emit(i, hash);
+      }
+  }
+
+  bool writeAll(int fd, const char* buf, size_t len)
+  {
+    while (len > 0)
+      {
+        const ssize_t n = ::write(fd, buf, len);
+        if (n <= 0)
+          return false;
+        buf += n;
+        len -= size_t(n);
+      }
+    return true;
+  }
+
+  std::string readAll(int fd)
+  {
+    std::string result;
+    char buf[4096];
+    ssize_t n;
+    while ((n = ::read(fd, buf, sizeof(buf))) > 0)
+      result.append(buf, size_t(n));
+    return result;
+  }
+}
+
+OffscreenRenderer::OffscreenRenderer(int width, int height) :
+  rep(new Impl(width, height))
+{
+GVX_TRACE("OffscreenRenderer::OffscreenRenderer");
+
+  rep->canvas->makeCurrent();
+  rep->camera->reshape(*rep->canvas, width, height);
+}
+
+OffscreenRenderer::~OffscreenRenderer() noexcept
+{
+GVX_TRACE("OffscreenRenderer::~OffscreenRenderer");
+  delete rep;
+}
+
+GLCanvas& OffscreenRenderer::canvas() const
+{
+  return *rep->canvas;
+}
+
+const nub::ref<GxCamera>& OffscreenRenderer::getCamera() const
+{
+  return rep->camera;
+}
+
+void OffscreenRenderer::setCamera(const nub::ref<GxCamera>& cam)
+{
+GVX_TRACE("OffscreenRenderer::setCamera");
+
+  rep->camera = cam;
+  rep->canvas->makeCurrent();
+  rep->camera->reshape(*rep->canvas, rep->glx->width(), rep->glx->height());
+}
+
+media::bmap_data OffscreenRenderer::render(const GxNode& node)
+{
+GVX_TRACE("OffscreenRenderer::render");
+
+  GLCanvas& canvas = *rep->canvas;
+
+  canvas.makeCurrent();
+  canvas.clearColorBuffer();
+
+  {
+    Gfx::MatrixSaver msaver(canvas);
+    Gfx::AttribSaver asaver(canvas);
+
+    rep->camera->draw(canvas);
+    node.draw(canvas);
+  }
+
+  canvas.finishDrawing();
+
+  return canvas.grabPixels(canvas.getScreenViewport());
+}
+
+std::vector<uint32_t>
+OffscreenRenderer::renderBatch(int width, int height,
+                               const std::vector<nub::ref<GxNode>>& nodes,
+                               const std::vector<rutz::fstring>& filenames,
+                               unsigned int nworkers)
+{
+GVX_TRACE("OffscreenRenderer::renderBatch");
+
+  if (!filenames.empty() && filenames.size() != nodes.size())
+    throw rutz::error(rutz::sfmt("got %u nodes but %u filenames",
+                                 unsigned(nodes.size()),
+                                 unsigned(filenames.size())), SRC_POS);
+
+  std::vector<uint32_t> hashes(nodes.size());
+
+  if (nworkers > nodes.size())
+    nworkers = unsigned(nodes.size());
+
+  if (nworkers <= 1)
+    {
+      OffscreenRenderer r(width, height);
+      renderSlice(r, nodes, filenames, 0, 1,
+                  [&](size_t i, uint32_t h) { hashes[i] = h; });
+      return hashes;
+    }
+
+  // Fork the workers before creating any GL context in this process,
+  // so that each worker starts from a clean EGL state. Each worker
+  // reports "index hash" lines back through its own pipe, followed
+  // by an "error message" line if it fails.
+  std::vector<std::unique_ptr<rutz::pipe_fds>> pipes;
+  std::vector<std::unique_ptr<rutz::child_process>> workers;
+
+  for (unsigned int k = 0; k < nworkers; ++k)
+    {
+      pipes.emplace_back(new rutz::pipe_fds);
+      workers.emplace_back(new rutz::child_process);
+
+      if (!workers.back()->in_parent())
+        {
+          // In the child: never return or throw from here, and use
+          // _exit() so that we don't run the parent's atexit handlers
+          // or flush its stdio buffers a second time.
+          int status = 0;
+          pipes.back()->close_reader();
+          const int fd = pipes.back()->writer();
+          try
+            {
+              OffscreenRenderer r(width, height);
+              renderSlice(r, nodes, filenames, k, nworkers,
+                          [fd](size_t i, uint32_t h)
+                          {
+                            char buf[64];
+                            const int len =
+                              snprintf(buf, sizeof(buf), "%lu %lu\n",
+                                       (unsigned long) i,
+                                       (unsigned long) h);
+                            if (!writeAll(fd, buf, size_t(len)))
+                              throw rutz::error("pipe write failed",
+                                                SRC_POS);
+                          });
+            }
+          catch (std::exception& e)
+            {
+              status = 1;
+              std::string msg = std::string("error ") + e.what();
+              for (char& c: msg)
+                if (c == '\n') c = ' ';
+              msg += '\n';
+              writeAll(fd, msg.data(), msg.size());
+            }
+          catch (...)
+            {
+              status = 1;
+              const char msg[] = "error unknown exception\n";
+              writeAll(fd, msg, sizeof(msg) - 1);
+            }
+          _exit(status);
+        }
+
+      pipes.back()->close_writer();
+    }
+
+  std::vector<bool> done(nodes.size(), false);
+  int failures = 0;
+  std::string errors;
+
+  for (unsigned int k = 0; k < nworkers; ++k)
+    {
+      const std::string output = readAll(pipes[k]->reader());
+
+      const char* p = output.c_str();
+      unsigned long i = 0, h = 0;
+      int nread = 0;
+      while (sscanf(p, "%lu %lu\n%n", &i, &h, &nread) == 2)
+        {
+          if (i < hashes.size())
+            {
+              hashes[i] = uint32_t(h);
+              done[i] = true;
+            }
+          p += nread;
+        }
+
+      if (strncmp(p, "error ", 6) == 0)
+        {
+          std::string msg(p + 6);
+          while (!msg.empty() && msg.back() == '\n')
+            msg.pop_back();
+          errors += rutz::sfmt("\nworker %u: %s", k, msg.c_str()).c_str();
+        }
+
+      if (workers[k]->wait() != 0)
+        ++failures;
+    }
+
+  if (failures > 0)
+    throw rutz::error(rutz::sfmt("%d of %u offscreen render workers failed%s",
+                                 failures, nworkers, errors.c_str()),
+                      SRC_POS);
+
+  for (size_t i = 0; i < done.size(); ++i)
+    if (!done[i])
+      throw rutz::error(rutz::sfmt("no result for frame %u",
+                                   unsigned(i)), SRC_POS);
+
+  return hashes;
+}
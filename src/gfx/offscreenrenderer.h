@@ -0,0 +1,106 @@
+/** @file gfx/offscreenrenderer.h render GxNode objects into images
+    without a window, optionally spreading a batch over worker processes */
+
+///////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026-2026 Rob Peters
+// Rob Peters <https://github.com/rjpcal/>
+//
+// created: Mon Oct 19 11:25:03 2026
+//
+// --------------------------------------------------------------------
+//
+// This file is part of GroovX.
+//   [https://github.com/rjpcal/groovx]
+//
+// GroovX is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// GroovX is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GroovX; if not, write to the Free Software Foundation,
+// Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef GROOVX_GFX_OFFSCREENRENDERER_H_UTC20261019112503_DEFINED
+#define GROOVX_GFX_OFFSCREENRENDERER_H_UTC20261019112503_DEFINED
+
+#include "nub/ref.h"
+
+#include <cstdint>
+#include <vector>
+
+class GLCanvas;
+class GxCamera;
+class GxNode;
+
+namespace media
+{
+  class bmap_data;
+}
+
+namespace rutz
+{
+  class fstring;
+}
+
+/// Renders GxNode objects into an offscreen EGL pbuffer.
+/** Each OffscreenRenderer owns its own GL context and GLCanvas, so
+    rendering never touches (or needs) the X display. Frames are
+    returned as media::bmap_data objects in 24-bit RGB. */
+class OffscreenRenderer
+{
+public:
+  /// Construct with a pbuffer of the given size in pixels.
+  OffscreenRenderer(int width, int height);
+
+  /// Destructor.
+  ~OffscreenRenderer() noexcept;
+
+  /// Get the canvas that renders into the pbuffer.
+  GLCanvas& canvas() const;
+
+  /// Get the camera used to set up the projection for each frame.
+  const nub::ref<GxCamera>& getCamera() const;
+
+  /// Change the camera used to set up the projection for each frame.
+  void setCamera(const nub::ref<GxCamera>& cam);
+
+  /// Clear the pbuffer, draw \a node through the camera, and grab the result.
+  media::bmap_data render(const GxNode& node);
+
+  /// Render a batch of nodes, returning the bkdr_hash() of each frame.
+  /** If \a filenames is non-empty, it must be the same length as \a
+      nodes, and frame i is saved to filenames[i] with
+      media::save_image() (the file format is determined by the
+      extension, e.g. ".png" or ".pnm").
+
+      If \a nworkers is greater than one, the batch is split across
+      that many forked worker processes; each worker creates its own
+      GL context after the fork and renders every nworkers'th frame.
+      Since each worker holds a copy-on-write snapshot of the object
+      graph at the time of the call, the results are identical to an
+      in-process render. The returned hashes are always in the order
+      of \a nodes. */
+  static std::vector<uint32_t>
+  renderBatch(int width, int height,
+              const std::vector<nub::ref<GxNode>>& nodes,
+              const std::vector<rutz::fstring>& filenames,
+              unsigned int nworkers);
+
+private:
+  OffscreenRenderer(const OffscreenRenderer&);
+  OffscreenRenderer& operator=(const OffscreenRenderer&);
+
+  class Impl;
+  Impl* const rep;
+};
+
+#endif // !GROOVX_GFX_OFFSCREENRENDERER_H_UTC20261019112503_DEFINED
@@ -37,20 +37,31 @@
 #include "geom/vec2.h"
 #include "geom/vec3.h"
 
+#include "gfx/gxvectorfont.h"
+#include "gfx/mesh.h"
 #include "gfx/rgbacolor.h"
 
 #include "media/bmapdata.h"
 
+#include "rutz/ascii85.h"
 #include "rutz/error.h"
+#include "rutz/fstring.h"
 #include "rutz/sfmt.h"
 #include "rutz/time.h"
 #include "rutz/timeformat.h"
 
+#include <algorithm> // for std::copy()
 #include <cmath> // for floor() and ceil()
+#include <cstdio> // for snprintf()
 #include <cstdlib> // for getenv()
+#include <cstring> // for strlen()
 #include <fstream>
 #include <list>
+#include <map>
+#include <string>
+#include <utility> // for std::swap()
 #include <vector>
+#include <zlib.h>
 
 #include "rutz/trace.h"
 #include "rutz/debug.h"
@@ -63,6 +74,36 @@ using geom::vec2d;
 using geom::vec3i;
 using geom::vec3d;
 
+namespace
+{
+  // Buffered output is handed to the ofstream in chunks of this size.
+  const size_t FLUSH_SIZE = 64 * 1024;
+
+  // Merged stroke paths are flushed after this many segments, to stay
+  // well within the path-size limits of PostScript interpreters.
+  const unsigned int MAX_PATH_SEGMENTS = 1000;
+
+  // Label for output that isn't inside any labeled section.
+  const char* const OTHER_LABEL = "(other)";
+
+  // These short names are defined in our prolog, and used in place of
+  // the full operator names to keep the files small.
+  const char* const PROLOG =
+    "/GroovXDict 16 dict def\n"
+    "GroovXDict begin\n"
+    "/m {moveto} bind def\n"
+    "/l {lineto} bind def\n"
+    "/c {curveto} bind def\n"
+    "/h {closepath} bind def\n"
+    "/S {stroke} bind def\n"
+    "/f {fill} bind def\n"
+    "/w {setlinewidth} bind def\n"
+    "/d {setdash} bind def\n"
+    "/rg {setrgbcolor} bind def\n"
+    "end\n"
+    "GroovXDict begin\n";
+}
+
 class Gfx::PSCanvas::Impl
 {
   Impl(const Impl&);
@@ -72,30 +113,76 @@ public:
 
   struct Primitive;
 
+  // The requested graphics state, saved/restored by pushAttribs() and
+  // popAttribs(), and by pushMatrix() and popMatrix(). Since we apply
+  // our own coordinate transform to every point, the PostScript CTM
+  // never changes, so we never need gsave/grestore; instead we just
+  // issue whatever state changes are needed before we paint (see
+  // syncState()).
   struct State
   {
     State() :
       txform(geom::txform::identity()),
       lineWidth(1.0),
-      polygonFill(false)
+      polygonFill(false),
+      color(0.0, 0.0, 0.0, 1.0),
+      clearColor(1.0, 1.0, 1.0, 1.0),
+      dash(0xFFFF),
+      label()
     {}
 
     geom::txform txform;
     double lineWidth; // in points
     bool polygonFill;
+    RgbaColor color;
+    RgbaColor clearColor; // the paper, for swapForeBack()
+    unsigned short dash;
+    rutz::fstring label; // node type for byte counting
+  };
+
+  // The graphics state as last issued to the PostScript output
+  // (starting from the PostScript defaults).
+  struct DevState
+  {
+    DevState() : lineWidth(1.0), dash(0xFFFF)
+    { rgb[0] = rgb[1] = rgb[2] = "0"; }
+
+    std::string rgb[3];  // formatted, so we compare what's printed
+    double lineWidth;
+    unsigned short dash;
   };
 
   std::ofstream        itsFstream;
+  std::string          itsBuf;
+  size_t               itsFlushed;     // bytes handed to itsFstream
+  size_t               itsCounted;     // bytes assigned to a label
+  std::map<rutz::fstring, size_t> itsByteCounts;
   std::vector<State>   itsStates;
+  DevState             itsDev;
   Primitive*           itsPrimPtr;
+  bool                 itsStrokePending; // an unstroked path is open
+  unsigned int         itsPathSegments;
+  bool                 itsHaveCurrentPt;
+  double               itsCurrentX;    // as formatted
+  double               itsCurrentY;
   bool                 itsSpanFirst;
   geom::span<double>   itsSpanX;
   geom::span<double>   itsSpanY;
 
   Impl(const char* filename) :
     itsFstream(filename),
+    itsBuf(),
+    itsFlushed(0),
+    itsCounted(0),
+    itsByteCounts(),
     itsStates(),
+    itsDev(),
     itsPrimPtr(nullptr),
+    itsStrokePending(false),
+    itsPathSegments(0),
+    itsHaveCurrentPt(false),
+    itsCurrentX(0.0),
+    itsCurrentY(0.0),
     itsSpanFirst(true),
     itsSpanX(),
     itsSpanY()
@@ -104,46 +191,62 @@ public:
       raiseError(rutz::sfmt("couldn't open '%s' for writing", filename),
                  SRC_POS);
 
+    itsBuf.reserve(FLUSH_SIZE + 4096);
+
     itsStates.push_back(State());
 
     const rutz::fstring timestamp =
       rutz::format_time(rutz::time::wall_clock_now());
 
-    itsFstream << "%!PS-Adobe-2.0 EPSF-1.2\n"
-               << "%%Title: " << filename << "\n"
-               << "%%Creator: Gfx::PSCanvas $Revision$\n"
-               << "%%CreationDate: " << timestamp << "\n";
+    put("%!PS-Adobe-3.0 EPSF-3.0\n");
+    put("%%Title: "); put(filename); put("\n");
+    put("%%Creator: Gfx::PSCanvas $Revision$\n");
+    put("%%CreationDate: "); put(timestamp.c_str()); put("\n");
 
     const char* username = getenv("USER");
 
     if (username != nullptr)
-      itsFstream << "%%For: " << username << "\n";
-
-    itsFstream << "%%Pages: 1\n"
-               << "%%DocumentFonts:\n"
-               << "%%BoundingBox: (atend)\n"
-               << "%%EndComments\n"
-               << "\n"
-               << "%%Page: 1 1\n"
-               << "%%BeginDocument: " << filename << "\n"
-               << "%%DocumentFonts:\n"
-               << "\n";
+      {
+        put("%%For: "); put(username); put("\n");
+      }
+
+    put("%%LanguageLevel: 3\n"
+        "%%Pages: 1\n"
+        "%%DocumentFonts:\n"
+        "%%BoundingBox: (atend)\n"
+        "%%EndComments\n"
+        "%%BeginProlog\n");
+    put(PROLOG);
+    put("%%EndProlog\n"
+        "\n"
+        "%%Page: 1 1\n"
+        "%%BeginDocument: "); put(filename); put("\n");
+    put("%%DocumentFonts:\n"
+        "\n");
     translate(vec3d(306.0, 360.0, 0.0));
     scale(vec3d(72.0, 72.0, 1.0));
   }
 
   ~Impl()
   {
-    itsFstream << "showpage\n"
-               << "\n"
-               << "%%EndDocument\n"
-               << "\n"
-               << "%%Trailer\n"
-               << "%%BoundingBox: "
-               << floor(itsSpanX.lo) << ' ' << floor(itsSpanY.lo) << ' '
-               << ceil(itsSpanX.hi) << ' ' << ceil(itsSpanY.hi) << '\n'
-               << "%%EOF\n"
-               << std::flush;
+    endPath();
+
+    put("end\n"
+        "showpage\n"
+        "\n"
+        "%%EndDocument\n"
+        "\n"
+        "%%Trailer\n"
+        "%%BoundingBox: ");
+    char bbox[128];
+    snprintf(bbox, sizeof(bbox), "%g %g %g %g\n",
+             floor(itsSpanX.lo), floor(itsSpanY.lo),
+             ceil(itsSpanX.hi), ceil(itsSpanY.hi));
+    put(bbox);
+    put("%%EOF\n");
+
+    flushBuf();
+    itsFstream << std::flush;
   }
 
   State& current_state()
@@ -158,6 +261,79 @@ public:
     return itsStates.back();
   }
 
+  //
+  // Buffered output
+  //
+
+  void flushBuf()
+  {
+    itsFstream.write(itsBuf.data(), std::streamsize(itsBuf.size()));
+    itsFlushed += itsBuf.size();
+    itsBuf.clear();
+  }
+
+  void put(const char* s)
+  {
+    itsBuf += s;
+    if (itsBuf.size() >= FLUSH_SIZE)
+      flushBuf();
+  }
+
+  void put(const std::string& s)
+  {
+    itsBuf += s;
+    if (itsBuf.size() >= FLUSH_SIZE)
+      flushBuf();
+  }
+
+  // Format v with three decimals (i.e. a thousandth of a point, for
+  // coordinates), dropping trailing zeros, and a trailing space.
+  static void format(double v, char* buf, size_t len)
+  {
+    if (std::fabs(v) < 0.0005)
+      v = 0.0;
+
+    snprintf(buf, len, "%.3f", v);
+
+    char* p = buf + strlen(buf) - 1;
+    while (*p == '0') --p;
+    if (*p == '.') --p;
+    *++p = ' ';
+    *++p = '\0';
+  }
+
+  void put(double v)
+  {
+    char buf[64];
+    format(v, buf, sizeof(buf));
+    put(buf);
+  }
+
+  void put(int v)
+  {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%d ", v);
+    put(buf);
+  }
+
+  size_t bytesWritten() const
+  {
+    return itsFlushed + itsBuf.size();
+  }
+
+  // Assign any output since the last call to the current label.
+  void countBytes()
+  {
+    const size_t total = bytesWritten();
+    if (total > itsCounted)
+      {
+        const rutz::fstring& label = current_state().label;
+        itsByteCounts[label.is_empty() ? rutz::fstring(OTHER_LABEL) : label]
+          += total - itsCounted;
+        itsCounted = total;
+      }
+  }
+
   //
   // Graphics primitive definitions
   //
@@ -201,7 +377,7 @@ public:
 
     virtual void onVertex(PS* ps, const vec3d& v) override
     {
-      ps->newpath(); ps->moveto(v); ps->stroke();
+      ps->newpath(false); ps->moveto(v); ps->stroke();
     }
 
     virtual void onEnd(PS*) override {}
@@ -209,10 +385,7 @@ public:
 
   struct LinesPrim : public Primitive
   {
-    virtual void onBegin(PS* ps) override
-    {
-      ps->newpath();
-    }
+    virtual void onBegin(PS*) override {}
     virtual void onVertex(PS* ps, const vec3d& v) override
     {
       if (vcount() % 2)
@@ -221,7 +394,7 @@ public:
         }
       else
         {
-          ps->moveto(v);
+          ps->newpath(false); ps->moveto(v);
         }
     }
     virtual void onEnd(PS*) override {}
@@ -231,7 +404,7 @@ public:
   {
     virtual void onBegin(PS* ps) override
     {
-      ps->newpath();
+      ps->newpath(false);
     }
     virtual void onVertex(PS* ps, const vec3d& v) override
     {
@@ -257,7 +430,7 @@ public:
     {
       if (vcount() == 0)
         {
-          ps->newpath(); ps->moveto(v);
+          ps->newpath(filled(ps)); ps->moveto(v);
         }
       else
         {
@@ -266,21 +439,26 @@ public:
     }
     virtual void onEnd(PS* ps) override
     {
-      ps->closepath(); ps->stroke();
+      if (vcount() > 0)
+        {
+          ps->closepath(); paint(ps);
+        }
     }
+
+  private:
+    virtual bool filled(PS*) const { return false; }
+    virtual void paint(PS* ps) { ps->stroke(); }
   };
 
   struct TrianglesPrim : public Primitive
   {
-    virtual void onBegin(PS* ps) override
-    {
-      ps->newpath();
-    }
+    virtual void onBegin(PS*) override {}
     virtual void onVertex(PS* ps, const vec3d& v) override
     {
       switch(vcount() % 3)
         {
         case 0:
+          ps->newpath(ps->current_state().polygonFill);
           ps->moveto(v);
           break;
         case 1:
@@ -317,6 +495,7 @@ public:
       switch(vcount() % 4)
         {
         case 0:
+          ps->newpath(ps->current_state().polygonFill);
           ps->moveto(v);
           break;
         case 1:
@@ -354,9 +533,13 @@ public:
 
     virtual void onEnd(PS* ps) override
     {
-      ps->newpath();
+      if (itsEvenPts.empty())
+        return;
+
+      ps->newpath(ps->current_state().polygonFill);
 
       ps->moveto(itsEvenPts.front());
+      itsEvenPts.pop_front();
 
       while (!itsEvenPts.empty())
         {
@@ -378,36 +561,47 @@ public:
 
   struct PolygonPrim : public LineLoopPrim
   {
-    virtual void onEnd(PS* ps) override
-    {
-      ps->closepath(); ps->renderpolygon();
-    }
-  };
+  private:
+    virtual bool filled(PS* ps) const override
+    { return ps->current_state().polygonFill; }
 
+    virtual void paint(PS* ps) override { ps->renderpolygon(); }
+  };
 
 
 
-  void indent()
+  void pushState(const char* comment)
   {
-    for (unsigned int i = 1; i < itsStates.size(); ++i)
+    if (comment != nullptr && comment[0] != '\0')
       {
-        itsFstream << '\t';
+        put("% "); put(comment); put("\n");
       }
-  }
 
-  void gsave(const char* comment)
-  {
-    indent(); itsFstream << "gsave";
-    if (comment != nullptr && comment[0] != '\0')
-      itsFstream << " % " << comment;
-    itsFstream << '\n';
     itsStates.push_back(current_state());
+
+    // The outermost labeled section gets the credit for all the
+    // output within it.
+    if (comment != nullptr && comment[0] != '\0'
+        && current_state().label.is_empty())
+      {
+        endPath();
+        countBytes();
+        current_state().label = comment;
+      }
   }
 
-  void grestore()
+  void popState()
   {
+    if (itsStates.size() <= 1)
+      raiseError("state stack underflow", SRC_POS);
+
+    if (current_state().label != itsStates[itsStates.size()-2].label)
+      {
+        endPath();
+        countBytes();
+      }
+
     itsStates.pop_back();
-    indent(); itsFstream << "grestore\n";
   }
 
   void translate(const vec3d& v)
@@ -425,37 +619,147 @@ public:
     current_state().txform.rotate(axis, angle);
   }
 
+  // Issue whatever commands are needed to bring the PostScript state
+  // in line with the requested state.
+  void syncState(bool stroking)
+  {
+    const State& st = current_state();
+
+    char r[64], g[64], b[64];
+    format(st.color.r(), r, sizeof(r));
+    format(st.color.g(), g, sizeof(g));
+    format(st.color.b(), b, sizeof(b));
+
+    if (itsDev.rgb[0] != r || itsDev.rgb[1] != g || itsDev.rgb[2] != b)
+      {
+        put(r); put(g); put(b); put("rg\n");
+        itsDev.rgb[0] = r; itsDev.rgb[1] = g; itsDev.rgb[2] = b;
+      }
+
+    if (!stroking)
+      return;
+
+    if (itsDev.lineWidth != st.lineWidth)
+      {
+        put(st.lineWidth); put("w\n");
+        itsDev.lineWidth = st.lineWidth;
+      }
+
+    if (itsDev.dash != st.dash)
+      {
+        setdash(st.dash);
+        itsDev.dash = st.dash;
+      }
+  }
+
+  bool stateMatches(bool stroking) const
+  {
+    const State& st = current_state();
+
+    char r[64], g[64], b[64];
+    format(st.color.r(), r, sizeof(r));
+    format(st.color.g(), g, sizeof(g));
+    format(st.color.b(), b, sizeof(b));
+
+    return itsDev.rgb[0] == r && itsDev.rgb[1] == g && itsDev.rgb[2] == b
+      && (!stroking
+          || (itsDev.lineWidth == st.lineWidth && itsDev.dash == st.dash));
+  }
+
+  // Finish off any pending merged stroke path.
+  void endPath()
+  {
+    if (itsStrokePending)
+      {
+        put("S\n");
+        itsStrokePending = false;
+        itsPathSegments = 0;
+      }
+    itsHaveCurrentPt = false;
+  }
+
+  // Start a new subpath that will be filled, or stroked. Consecutive
+  // stroked subpaths are merged into a single path (with a single
+  // "stroke"), as long as the graphics state stays the same.
+  void newpath(bool fill)
+  {
+    if (fill || (itsStrokePending && !stateMatches(true))
+        || itsPathSegments >= MAX_PATH_SEGMENTS)
+      endPath();
+
+    syncState(!fill);
+  }
+
   // NOTE: these next four functions must be non-templates in order to avoid
   // "internal compiler errors" with g++-2.96 on Mac OS X.
 
   void moveto(const vec2d& v)
   {
-    indent(); pushxy(v); itsFstream << "moveto\n";
+    moveto(vec3d(v.x(), v.y(), 0.0));
   }
 
   void moveto(const vec3d& v)
   {
-    indent(); pushxy(v); itsFstream << "moveto\n";
+    const vec3d t = current_state().txform.apply_to(v);
+
+    char x[64], y[64];
+    format(t.x(), x, sizeof(x));
+    format(t.y(), y, sizeof(y));
+
+    const double fx = atof(x), fy = atof(y);
+
+    // A moveto to the current point would just break up a polyline;
+    // skip it unless it would restart the dash pattern.
+    if (itsHaveCurrentPt && fx == itsCurrentX && fy == itsCurrentY
+        && current_state().dash == 0xFFFF)
+      return;
+
+    this->mergespan(t.x(), t.y());
+    put(x); put(y); put("m\n");
+    itsHaveCurrentPt = true; itsCurrentX = fx; itsCurrentY = fy;
   }
 
   void lineto(const vec2d& v)
   {
-    indent(); pushxy(v); itsFstream << "lineto\n";
+    lineto(vec3d(v.x(), v.y(), 0.0));
   }
 
   void lineto(const vec3d& v)
   {
-    indent(); pushxy(v); itsFstream << "lineto\n";
+    const vec3d t = current_state().txform.apply_to(v);
+
+    char x[64], y[64];
+    format(t.x(), x, sizeof(x));
+    format(t.y(), y, sizeof(y));
+
+    this->mergespan(t.x(), t.y());
+    put(x); put(y); put("l\n");
+    itsHaveCurrentPt = true; itsCurrentX = atof(x); itsCurrentY = atof(y);
+    ++itsPathSegments;
   }
 
-  void newpath()
+  void curveto(const vec3d& p1, const vec3d& p2, const vec3d& p3)
   {
-    itsFstream << "\n"; indent(); itsFstream << "newpath\n";
+    pushxy(p1); pushxy(p2);
+
+    const vec3d t = current_state().txform.apply_to(p3);
+
+    char x[64], y[64];
+    format(t.x(), x, sizeof(x));
+    format(t.y(), y, sizeof(y));
+
+    this->mergespan(t.x(), t.y());
+    put(x); put(y); put("c\n");
+    itsHaveCurrentPt = true; itsCurrentX = atof(x); itsCurrentY = atof(y);
+    ++itsPathSegments;
   }
 
   void closepath()
   {
-    indent(); itsFstream << "closepath\n";
+    put("h\n");
+    // the current point after closepath is the subpath's start, which
+    // we don't track
+    itsHaveCurrentPt = false;
   }
 
   void renderpolygon()
@@ -466,26 +770,6 @@ public:
       stroke();
   }
 
-#if 0
-  // WARNING! The arc() and arcn() functions won't work properly with
-  // maintaining our own 3-D coordinate transformation.
-  void arc(double x, double y, double r, double start, double end,
-           bool reverse=false)
-  {
-    indent(); push1(x); push1(y); push1(r); push1(start); push1(end);
-    if (reverse)
-      itsFstream << "arcn\n";
-    else
-      itsFstream << "arc\n";
-    //      indent(); itsFstream << "4 { pop } repeat\n";
-  }
-
-  void arcn(double x, double y, double r, double start, double end)
-  {
-    arc(x, y, r, start, end, true);
-  }
-#endif
-
   void circle(double x, double y, double r, bool reverse=false)
   {
     // A good cubic Bezier approximation for a radius-r 90 degree arc is:
@@ -512,18 +796,18 @@ public:
     if (!reverse)
       {
         moveto(pt1);
-        indent(); pushxy(pt2); pushxy(pt3); pushxy(pt4); itsFstream << "curveto\n";
-        indent(); pushxy(pt5); pushxy(pt6); pushxy(pt7); itsFstream << "curveto\n";
-        indent(); pushxy(pt8); pushxy(pt9); pushxy(pt10); itsFstream << "curveto\n";
-        indent(); pushxy(pt11); pushxy(pt12); pushxy(pt1); itsFstream << "curveto\n";
+        curveto(pt2, pt3, pt4);
+        curveto(pt5, pt6, pt7);
+        curveto(pt8, pt9, pt10);
+        curveto(pt11, pt12, pt1);
       }
     else
       {
         moveto(pt1);
-        indent(); pushxy(pt12); pushxy(pt11); pushxy(pt10); itsFstream << "curveto\n";
-        indent(); pushxy(pt9); pushxy(pt8); pushxy(pt7); itsFstream << "curveto\n";
-        indent(); pushxy(pt6); pushxy(pt5); pushxy(pt4); itsFstream << "curveto\n";
-        indent(); pushxy(pt3); pushxy(pt2); pushxy(pt1); itsFstream << "curveto\n";
+        curveto(pt12, pt11, pt10);
+        curveto(pt9, pt8, pt7);
+        curveto(pt6, pt5, pt4);
+        curveto(pt3, pt2, pt1);
       }
   }
 
@@ -532,34 +816,35 @@ public:
               const vec3d& p3,
               const vec3d& p4)
   {
-    newpath();
+    newpath(false);
     moveto(p1);
-    indent(); pushxy(p2); pushxy(p3); pushxy(p4);
-    itsFstream << "curveto\n";
+    curveto(p2, p3, p4);
     stroke();
   }
 
   void fill()
   {
-    indent(); itsFstream << "fill\n\n";
+    put("f\n");
+    itsHaveCurrentPt = false;
   }
 
+  // The actual "stroke" is deferred until the path is finished by
+  // endPath().
   void stroke()
   {
-    indent(); itsFstream << "stroke\n\n";
-  }
-
-  void setlinewidth(double w)
-  {
-    current_state().lineWidth = w;
-
-    indent(); push1(w); itsFstream << "setlinewidth\n";
+    itsStrokePending = true;
   }
 
   void setdash(unsigned short bit_pattern)
   {
     dbg_eval_nl(3, reinterpret_cast<void*>(int(bit_pattern)));
 
+    if (bit_pattern == 0xFFFF)
+      {
+        put("[] 0 d\n");
+        return;
+      }
+
     bool prev_bit = (0x8000 & bit_pattern);
 
     // will hold the lengths of the individual bit runs
@@ -591,40 +876,14 @@ public:
         lengths[0] += offset;
       }
 
-    indent();
-
-    push1("[");
+    put("[ ");
     for (int i = 0; i < pos; ++i)
       {
-        push1(lengths[i]);
+        put(lengths[i]);
       }
-    push1("]");
+    put("] ");
 
-    push1(offset); itsFstream << "setdash\n";
-  }
-
-  void setrgbcolor(const RgbaColor& col)
-  {
-    indent(); push1(col.r()); push1(col.g()); push1(col.b());
-    itsFstream << "setrgbcolor\n";
-  }
-
-  // The push1() and pushxy() functions must be non-templates to placate
-  // g++-2.96 on Mac OS X.
-
-  void push1(double v)
-  {
-    itsFstream << v << " ";
-  }
-
-  void push1(int v)
-  {
-    itsFstream << v << " ";
-  }
-
-  void push1(const char* v)
-  {
-    itsFstream << v << " ";
+    put(offset); put("d\n");
   }
 
   void mergespan(const double x, const double y)
@@ -642,18 +901,97 @@ public:
       }
   }
 
-  void pushxy(const vec2d& v)
+  void pushxy(const vec3d& v)
   {
-    vec2d t = current_state().txform.apply_to(v);
+    vec3d t = current_state().txform.apply_to(v);
     this->mergespan(t.x(), t.y());
-    itsFstream << t.x() << " " << t.y() << " ";
+    put(t.x()); put(t.y());
   }
 
-  void pushxy(const vec3d& v)
+  // Draw an image (or, with \a mask, a bitmap in the current color)
+  // with its lower left corner at world_pos, with one image pixel per
+  // zoom points. The image data are Flate-compressed and then ASCII85
+  // encoded.
+  void image(const media::bmap_data& data, const vec3d& world_pos,
+             const vec2d& zoom, bool mask)
   {
-    vec3d t = current_state().txform.apply_to(v);
+    const int w = int(data.width());
+    const int h = int(data.height());
+
+    if (w <= 0 || h <= 0)
+      return;
+
+    const unsigned int bpp = data.bits_per_pixel();
+
+    if (mask && bpp != 1)
+      raiseError(rutz::sfmt("bitmaps must have 1 bit per pixel "
+                            "(got %u)", bpp), SRC_POS);
+
+    if (bpp != 32 && bpp != 24 && bpp != 8 && bpp != 1)
+      raiseError(rutz::sfmt("unsupported bits per pixel (%u)", bpp),
+                 SRC_POS);
+
+    endPath();
+
+    if (mask)
+      syncState(false);
+
+    data.set_row_order(media::bmap_data::row_order::BOTTOM_FIRST);
+
+    // PostScript has no alpha, so 32-bit images lose their alpha
+    // channel, and each row is padded only to a byte boundary.
+    const unsigned int ncomp = (bpp >= 24) ? 3 : 1;
+    const size_t rowbytes = (bpp == 1) ? size_t((w+7)/8) : size_t(w) * ncomp;
+
+    std::vector<unsigned char> raw(rowbytes * size_t(h));
+
+    for (int j = 0; j < h; ++j)
+      {
+        const unsigned char* src = data.bytes_ptr() + size_t(j) * data.bytes_per_row();
+        unsigned char* dst = &raw[size_t(j) * rowbytes];
+
+        if (bpp == 32)
+          for (int i = 0; i < w; ++i)
+            {
+              *dst++ = src[4*i]; *dst++ = src[4*i+1]; *dst++ = src[4*i+2];
+            }
+        else
+          std::copy(src, src + rowbytes, dst);
+      }
+
+    uLongf zlen = compressBound(uLong(raw.size()));
+    std::vector<unsigned char> zdata(zlen);
+    if (compress2(&zdata[0], &zlen, &raw[0], uLong(raw.size()),
+                  Z_DEFAULT_COMPRESSION) != Z_OK)
+      raiseError("couldn't compress image data", SRC_POS);
+
+    const vec3d t = current_state().txform.apply_to(world_pos);
+    const double sx = w * zoom.x();
+    const double sy = h * zoom.y();
+
     this->mergespan(t.x(), t.y());
-    itsFstream << t.x() << " " << t.y() << " ";
+    this->mergespan(t.x() + sx, t.y() + sy);
+
+    put("gsave\n");
+    put(t.x()); put(t.y()); put("translate\n");
+    put(sx); put(sy); put("scale\n");
+    if (!mask)
+      put(ncomp == 3 ? "/DeviceRGB setcolorspace\n"
+                     : "/DeviceGray setcolorspace\n");
+    put("<< /ImageType 1 /Width "); put(w); put("/Height "); put(h);
+    if (mask)
+      put("/BitsPerComponent 1 /Decode [1 0]");
+    else if (bpp == 1)
+      put("/BitsPerComponent 1 /Decode [0 1]");
+    else if (ncomp == 3)
+      put("/BitsPerComponent 8 /Decode [0 1 0 1 0 1]");
+    else
+      put("/BitsPerComponent 8 /Decode [0 1]");
+    put("\n/ImageMatrix [ "); put(w); put("0 0 "); put(h); put("0 0 ]");
+    put("\n/DataSource currentfile /ASCII85Decode filter /FlateDecode filter\n>> ");
+    put(mask ? "imagemask\n" : "image\n");
+    put(rutz::ascii85_encode(&zdata[0], zlen, 72));
+    put("\ngrestore\n");
   }
 
   [[noreturn]] void raiseError(const rutz::fstring& msg, const rutz::file_pos& pos)
@@ -669,7 +1007,7 @@ public:
 
     if (comment != nullptr && comment[0] != '\0')
       {
-        indent(); itsFstream << "% " << comment << " (begin)\n";
+        put("% "); put(comment); put(" (begin)\n");
       }
 
     itsPrimPtr = ptr;
@@ -688,7 +1026,6 @@ public:
     itsPrimPtr = nullptr;
   }
 };
-
 namespace
 {
   Gfx::PSCanvas::Impl::PointsPrim        thePointsPrim;
@@ -774,13 +1111,13 @@ GVX_TRACE("Gfx::PSCanvas::throwIfError");
 void Gfx::PSCanvas::pushAttribs(const char* comment)
 {
 GVX_TRACE("Gfx::PSCanvas::pushAttribs");
-  rep->gsave(comment);
+  rep->pushState(comment);
 }
 
 void Gfx::PSCanvas::popAttribs()
 {
 GVX_TRACE("Gfx::PSCanvas::popAttribs");
-  rep->grestore();
+  rep->popState();
 }
 
 void Gfx::PSCanvas::drawOnFrontBuffer()
@@ -798,13 +1135,13 @@ GVX_TRACE("Gfx::PSCanvas::drawOnBackBuffer");
 void Gfx::PSCanvas::setColor(const RgbaColor& col)
 {
 GVX_TRACE("Gfx::PSCanvas::setColor");
-  rep->setrgbcolor(col);
+  rep->current_state().color = col;
 }
 
-void Gfx::PSCanvas::setClearColor(const RgbaColor&)
+void Gfx::PSCanvas::setClearColor(const RgbaColor& col)
 {
 GVX_TRACE("Gfx::PSCanvas::setClearColor");
-  ;//nothing
+  rep->current_state().clearColor = col;
 }
 
 void Gfx::PSCanvas::setColorIndex(unsigned int /*index*/)
@@ -824,8 +1161,7 @@ GVX_TRACE("Gfx::PSCanvas::setClearColorIndex");
 void Gfx::PSCanvas::swapForeBack()
 {
 GVX_TRACE("Gfx::PSCanvas::swapForeBack");
-// FIXME
-  rep->raiseError("not implemented", SRC_POS);
+  std::swap(rep->current_state().color, rep->current_state().clearColor);
 }
 
 void Gfx::PSCanvas::setPolygonFill(bool on)
@@ -847,14 +1183,14 @@ void Gfx::PSCanvas::setLineWidth(double width)
 {
 GVX_TRACE("Gfx::PSCanvas::setLineWidth");
 
-  rep->setlinewidth(width);
+  rep->current_state().lineWidth = width;
 }
 
 void Gfx::PSCanvas::setLineStipple(unsigned short bit_pattern)
 {
 GVX_TRACE("Gfx::PSCanvas::setLineStipple");
 
-  rep->setdash(bit_pattern);
+  rep->current_state().dash = bit_pattern;
 }
 
 void Gfx::PSCanvas::enableAntialiasing()
@@ -863,6 +1199,19 @@ GVX_TRACE("Gfx::PSCanvas::enableAntialiasing");
   // nothing, antialiasing is default in postscript
 }
 
+void Gfx::PSCanvas::setScissor(const recti& /*screen_rect*/)
+{
+GVX_TRACE("Gfx::PSCanvas::setScissor");
+  // nothing; as with clearColorBuffer(recti), partial redraws aren't
+  // meaningful for a page description
+}
+
+void Gfx::PSCanvas::disableScissor()
+{
+GVX_TRACE("Gfx::PSCanvas::disableScissor");
+  // nothing
+}
+
 
 
 void Gfx::PSCanvas::viewport(int /*x*/, int /*y*/, int /*w*/, int /*h*/)
@@ -890,13 +1239,13 @@ GVX_TRACE("Gfx::PSCanvas::perspective");
 void Gfx::PSCanvas::pushMatrix(const char* comment)
 {
 GVX_TRACE("Gfx::PSCanvas::pushMatrix");
-  rep->gsave(comment);
+  rep->pushState(comment);
 }
 
 void Gfx::PSCanvas::popMatrix()
 {
 GVX_TRACE("Gfx::PSCanvas::popMatrix");
-  rep->grestore();
+  rep->popState();
 }
 
 void Gfx::PSCanvas::translate(const vec3d& v)
@@ -930,21 +1279,19 @@ GVX_TRACE("Gfx::PSCanvas::loadMatrix");
 }
 
 
-void Gfx::PSCanvas::drawPixels(const media::bmap_data& /*data*/,
-                               const vec3d& /*world_pos*/,
-                               const vec2d& /*zoom*/)
+void Gfx::PSCanvas::drawPixels(const media::bmap_data& data,
+                               const vec3d& world_pos,
+                               const vec2d& zoom)
 {
 GVX_TRACE("Gfx::PSCanvas::drawPixels");
-// FIXME
-  rep->raiseError("not implemented", SRC_POS);
+  rep->image(data, world_pos, zoom, false);
 }
 
-void Gfx::PSCanvas::drawBitmap(const media::bmap_data& /*data*/,
-                               const vec3d& /*world_pos*/)
+void Gfx::PSCanvas::drawBitmap(const media::bmap_data& data,
+                               const vec3d& world_pos)
 {
 GVX_TRACE("Gfx::PSCanvas::drawBitmap");
-// FIXME
-  rep->raiseError("not implemented", SRC_POS);
+  rep->image(data, world_pos, vec2d::ones(), true);
 }
 
 media::bmap_data Gfx::PSCanvas::grabPixels(const recti&)
@@ -972,16 +1319,13 @@ void Gfx::PSCanvas::drawRect(const rectd& r)
 {
 GVX_TRACE("Gfx::PSCanvas::drawRect");
 
-  rep->newpath();
+  rep->newpath(rep->current_state().polygonFill);
   rep->moveto(r.bottom_left());
   rep->lineto(r.bottom_right());
   rep->lineto(r.top_right());
   rep->lineto(r.top_left());
   rep->closepath();
-  if (rep->current_state().polygonFill)
-    rep->fill();
-  else
-    rep->stroke();
+  rep->renderpolygon();
 }
 
 void Gfx::PSCanvas::drawCircle(double inner_radius, double outer_radius,
@@ -989,7 +1333,7 @@ void Gfx::PSCanvas::drawCircle(double inner_radius, double outer_radius,
 {
 GVX_TRACE("Gfx::PSCanvas::drawCircle");
 
-  rep->newpath();
+  rep->newpath(fill);
   rep->circle(0.0, 0.0, outer_radius);
   if (fill)
     {
@@ -1003,19 +1347,23 @@ GVX_TRACE("Gfx::PSCanvas::drawCircle");
     }
 }
 
-void Gfx::PSCanvas::drawCylinder(double /*base_radius*/, double /*top_radius*/,
-                                 double /*height*/, int /*slices*/, int /*stacks*/,
-                                 bool /*fill*/)
+void Gfx::PSCanvas::drawCylinder(double base_radius, double top_radius,
+                                 double height, int slices, int stacks,
+                                 bool fill)
 {
-  // FIXME
-  rep->raiseError("not implemented", SRC_POS);
+GVX_TRACE("Gfx::PSCanvas::drawCylinder");
+
+  // no hidden-surface removal, so faces are simply painted in order
+  Gfx::Mesh::cylinder(base_radius, top_radius, height,
+                      slices, stacks, fill).draw(*this);
 }
 
-void Gfx::PSCanvas::drawSphere(double /*radius*/, int /*slices*/, int /*stacks*/,
-                               bool /*fill*/)
+void Gfx::PSCanvas::drawSphere(double radius, int slices, int stacks,
+                               bool fill)
 {
-  // FIXME
-  rep->raiseError("not implemented", SRC_POS);
+GVX_TRACE("Gfx::PSCanvas::drawSphere");
+
+  Gfx::Mesh::sphere(radius, slices, stacks, fill).draw(*this);
 }
 
 void Gfx::PSCanvas::drawBezier4(const vec3d& p1,
@@ -1028,16 +1376,32 @@ GVX_TRACE("Gfx::PSCanvas::drawBezier4");
   rep->bezier(p1, p2, p3, p4);
 }
 
-void Gfx::PSCanvas::drawBezierFill4(const vec3d& /*center*/,
-                                    const vec3d& /*p1*/,
-                                    const vec3d& /*p2*/,
-                                    const vec3d& /*p3*/,
-                                    const vec3d& /*p4*/,
+void Gfx::PSCanvas::drawBezierFill4(const vec3d& center,
+                                    const vec3d& p1,
+                                    const vec3d& p2,
+                                    const vec3d& p3,
+                                    const vec3d& p4,
                                     unsigned int /*subdivisions*/)
 {
 GVX_TRACE("Gfx::PSCanvas::drawBezierFill4");
-  // FIXME
-  rep->raiseError("not implemented", SRC_POS);
+
+  // The region swept out by a triangle fan from center to the curve
+  rep->newpath(true);
+  rep->moveto(center);
+  rep->lineto(p1);
+  rep->curveto(p2, p3, p4);
+  rep->closepath();
+  rep->fill();
+}
+
+bool Gfx::PSCanvas::drawsCurvesNatively() const
+{
+  return true;
+}
+
+bool Gfx::PSCanvas::wantsLabels() const
+{
+  return true;
 }
 
 void Gfx::PSCanvas::beginPoints(const char* comment)
@@ -1125,6 +1489,17 @@ GVX_TRACE("Gfx::PSCanvas::end");
   rep->endPrimitive();
 }
 
+void Gfx::PSCanvas::drawArrays(VertexStyle s, const vec3d* pts,
+                               const vec3d* /*normals*/, size_t n)
+{
+GVX_TRACE("Gfx::PSCanvas::drawArrays");
+
+  begin(s);
+  for (size_t i = 0; i < n; ++i)
+    rep->itsPrimPtr->vertex(rep, pts[i]);
+  rep->endPrimitive();
+}
+
 void Gfx::PSCanvas::drawRasterText(const rutz::fstring& /*text*/,
                                    const GxRasterFont& /*font*/)
 {
@@ -1132,15 +1507,34 @@ GVX_TRACE("Gfx::PSCanvas::drawRasterText");
   throw rutz::error("PSCanvas::drawRasterText not implemented", SRC_POS);
 }
 
-void Gfx::PSCanvas::drawVectorText(const rutz::fstring& /*text*/,
-                                   const GxVectorFont& /*font*/)
+void Gfx::PSCanvas::drawVectorText(const rutz::fstring& text,
+                                   const GxVectorFont& font)
 {
 GVX_TRACE("Gfx::PSCanvas::drawVectorText");
-  throw rutz::error("PSCanvas::drawVectorText not implemented", SRC_POS);
+  font.drawStrokes(text.c_str(), *this);
 }
 
 void Gfx::PSCanvas::flushOutput()
 {
 GVX_TRACE("Gfx::PSCanvas::flushOutput");
+  rep->endPath();
+  rep->flushBuf();
   rep->itsFstream << std::flush;
 }
+
+size_t Gfx::PSCanvas::bytesWritten() const
+{
+GVX_TRACE("Gfx::PSCanvas::bytesWritten");
+  return rep->bytesWritten();
+}
+
+std::vector<std::pair<rutz::fstring, size_t>>
+Gfx::PSCanvas::bytesPerLabel() const
+{
+GVX_TRACE("Gfx::PSCanvas::bytesPerLabel");
+
+  rep->countBytes();
+
+  return std::vector<std::pair<rutz::fstring, size_t>>
+    (rep->itsByteCounts.begin(), rep->itsByteCounts.end());
+}
@@ -35,12 +35,22 @@
 
 #include "gfx/canvas.h"
 
+#include "rutz/fstring.h"
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
 namespace Gfx
 {
   class PSCanvas;
 }
 
 /// Gfx::PSCanvas implements Gfx::Canvas using PostScript commands.
+/** Output is buffered and kept compact: graphics state changes are
+    only written when they actually change what gets painted,
+    consecutive stroked lines are merged into a single path, and image
+    data are Flate-compressed and ASCII85-encoded. */
 class Gfx::PSCanvas : public Gfx::Canvas
 {
 public:
@@ -48,6 +58,17 @@ public:
 
   virtual ~PSCanvas() noexcept;
 
+  /// Get the number of bytes of PostScript generated so far.
+  size_t bytesWritten() const;
+
+  /// Get the number of bytes generated for each labeled section.
+  /** Sections are labeled by the comment given to pushMatrix() or
+      pushAttribs(); all output within the outermost labeled section
+      is counted under its label (GxShapeKit objects label themselves
+      with their type name). Unlabeled output is counted as
+      "(other)". */
+  std::vector<std::pair<rutz::fstring, size_t>> bytesPerLabel() const;
+
   virtual geom::vec3<double> screenFromWorld3(const geom::vec3<double>& world_pos) const override;
   virtual geom::vec3<double> worldFromScreen3(const geom::vec3<double>& screen_pos) const override;
 
@@ -87,6 +108,9 @@ public:
 
   virtual void enableAntialiasing() override;
 
+  virtual void setScissor(const geom::rect<int>& screen_rect) override;
+  virtual void disableScissor() override;
+
 
 
   virtual void viewport(int x, int y, int w, int h) override;
@@ -147,6 +171,12 @@ public:
                                const geom::vec3<double>& p4,
                                unsigned int subdivisions) override;
 
+  /// Returns true, since PostScript has its own Bezier curves.
+  virtual bool drawsCurvesNatively() const override;
+
+  /// Returns true, since labels are used to count bytes per node type.
+  virtual bool wantsLabels() const override;
+
   virtual void beginPoints(const char* comment="") override;
   virtual void beginLines(const char* comment="") override;
   virtual void beginLineStrip(const char* comment="") override;
@@ -163,6 +193,11 @@ public:
 
   virtual void end() override;
 
+  virtual void drawArrays(VertexStyle s,
+                          const geom::vec3<double>* pts,
+                          const geom::vec3<double>* normals,
+                          size_t n) override;
+
   virtual void drawRasterText(const rutz::fstring& text,
                               const GxRasterFont& font) override;
   virtual void drawVectorText(const rutz::fstring& text,
@@ -0,0 +1,858 @@
+/** @file gfx/recordcanvas.cc Gfx::Canvas subclass that records drawing
+    commands into a retained, canvas-independent command buffer */
+
+///////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026-2026 Rob Peters
+// Rob Peters <https://github.com/rjpcal/>
+//
+// created: Mon Oct 19 09:12:40 2026
+//
+// --------------------------------------------------------------------
+//
+// This file is part of GroovX.
+//   [https://github.com/rjpcal/groovx]
+//
+// GroovX is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// GroovX is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GroovX; if not, write to the Free Software Foundation,
+// Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include "recordcanvas.h"
+
+#include "geom/rect.h"
+#include "geom/txform.h"
+#include "geom/vec2.h"
+#include "geom/vec3.h"
+
+#include "gfx/gxnode.h"
+#include "gfx/gxrasterfont.h"
+#include "gfx/gxvectorfont.h"
+#include "gfx/rgbacolor.h"
+
+#include "media/bmapdata.h"
+
+#include "nub/ref.h"
+
+#include "rutz/error.h"
+#include "rutz/fstring.h"
+#include "rutz/sfmt.h"
+
+#include <memory>
+#include <vector>
+
+#include "rutz/trace.h"
+#include "rutz/debug.h"
+GVX_DBG_REGISTER
+
+using geom::recti;
+using geom::rectd;
+using geom::txform;
+using geom::vec2d;
+using geom::vec3d;
+
+///////////////////////////////////////////////////////////////////////
+//
+// Gfx::CmdList::Impl
+//
+///////////////////////////////////////////////////////////////////////
+
+class Gfx::CmdList::Impl
+{
+public:
+  enum class Op
+    {
+      PUSH_ATTRIBS,
+      POP_ATTRIBS,
+      FRONT_BUFFER,
+      BACK_BUFFER,
+      COLOR,            // colors[i]
+      CLEAR_COLOR,      // colors[i]
+      COLOR_INDEX,      // n
+      CLEAR_COLOR_INDEX,// n
+      SWAP_FORE_BACK,
+      POLYGON_FILL,     // n
+      POINT_SIZE,       // nums[i]
+      LINE_WIDTH,       // nums[i]
+      LINE_STIPPLE,     // n
+      ANTIALIASING,
+      SCISSOR,          // nums[i..i+3]
+      NO_SCISSOR,
+      VIEWPORT,         // nums[i..i+3]
+      ORTHOGRAPHIC,     // nums[i..i+5]
+      PERSPECTIVE,      // nums[i..i+3]
+      PUSH_MATRIX,
+      POP_MATRIX,
+      TRANSLATE,        // verts[i]
+      SCALE,            // verts[i]
+      ROTATE,           // verts[i], nums[n]
+      TRANSFORM,        // txforms[i]
+      LOAD_MATRIX,      // txforms[i]
+      DRAW_PIXELS,      // images[n], nums[i..i+4]
+      DRAW_BITMAP,      // images[n], nums[i..i+2]
+      CLEAR,
+      CLEAR_RECT,       // nums[i..i+3]
+      DRAW_RECT,        // nums[i..i+3]
+      CIRCLE,           // nums[i..i+4]
+      CYLINDER,         // nums[i..i+5]
+      SPHERE,           // nums[i..i+3]
+      BEZIER4,          // verts[i..i+3], n subdivisions
+      BEZIER_FILL4,     // verts[i..i+4], n subdivisions
+      BEGIN,            // n == VertexStyle
+      VERTICES2,        // verts[i..i+n]
+      VERTICES3,        // verts[i..i+n]
+      END,
+      ARRAYS,           // nums[i..i+2] == {VertexStyle, first vertex,
+                        // has normals}, n vertices (then n normals)
+      RASTER_TEXT,      // strings[i], rfonts[n]
+      VECTOR_TEXT,      // strings[i], vfonts[n]
+      CALL_NODE         // nodes[i]
+    };
+
+  struct Cmd
+  {
+    Cmd(Op o, size_t i_, size_t n_) : op(o), i(i_), n(n_) {}
+
+    Op op;
+    size_t i;
+    size_t n;
+  };
+
+  Impl() {}
+
+  void clear() noexcept
+  {
+    cmds.clear();
+    verts.clear();
+    nums.clear();
+    colors.clear();
+    txforms.clear();
+    images.clear();
+    strings.clear();
+    rfonts.clear();
+    vfonts.clear();
+    nodes.clear();
+  }
+
+  void add(Op op, size_t i = 0, size_t n = 0)
+  {
+    cmds.push_back(Cmd(op, i, n));
+  }
+
+  size_t addNums(std::initializer_list<double> vals)
+  {
+    const size_t i = nums.size();
+    nums.insert(nums.end(), vals);
+    return i;
+  }
+
+  size_t addVert(const vec3d& v)
+  {
+    verts.push_back(v);
+    return verts.size() - 1;
+  }
+
+  // Consecutive vertices of the same dimensionality are coalesced
+  // into a single VERTICES2 or VERTICES3 run over the vertex buffer.
+  void addVertex(Op op, const vec3d& v)
+  {
+    if (!cmds.empty() && cmds.back().op == op
+        && cmds.back().i + cmds.back().n == verts.size())
+      {
+        ++cmds.back().n;
+      }
+    else
+      {
+        add(op, verts.size(), 1);
+      }
+    verts.push_back(v);
+  }
+
+  void replay(Gfx::Canvas& canvas) const;
+
+  std::vector<Cmd>                      cmds;
+  std::vector<vec3d>                    verts;
+  std::vector<double>                   nums;
+  std::vector<Gfx::RgbaColor>           colors;
+  std::vector<txform>                   txforms;
+  std::vector<std::unique_ptr<media::bmap_data>> images;
+  std::vector<rutz::fstring>            strings;
+  std::vector<std::shared_ptr<const GxRasterFont>> rfonts;
+  std::vector<std::shared_ptr<const GxVectorFont>> vfonts;
+  std::vector<nub::soft_ref<const GxNode>> nodes;
+};
+
+void Gfx::CmdList::Impl::replay(Gfx::Canvas& canvas) const
+{
+GVX_TRACE("Gfx::CmdList::Impl::replay");
+
+  const double* const d = nums.data();
+
+  for (const Cmd& c: cmds)
+    {
+      switch (c.op)
+        {
+        case Op::PUSH_ATTRIBS:      canvas.pushAttribs(); break;
+        case Op::POP_ATTRIBS:       canvas.popAttribs(); break;
+        case Op::FRONT_BUFFER:      canvas.drawOnFrontBuffer(); break;
+        case Op::BACK_BUFFER:       canvas.drawOnBackBuffer(); break;
+        case Op::COLOR:             canvas.setColor(colors[c.i]); break;
+        case Op::CLEAR_COLOR:       canvas.setClearColor(colors[c.i]); break;
+        case Op::COLOR_INDEX:       canvas.setColorIndex(c.n); break;
+        case Op::CLEAR_COLOR_INDEX: canvas.setClearColorIndex(c.n); break;
+        case Op::SWAP_FORE_BACK:    canvas.swapForeBack(); break;
+        case Op::POLYGON_FILL:      canvas.setPolygonFill(c.n != 0); break;
+        case Op::POINT_SIZE:        canvas.setPointSize(d[c.i]); break;
+        case Op::LINE_WIDTH:        canvas.setLineWidth(d[c.i]); break;
+        case Op::LINE_STIPPLE:
+          canvas.setLineStipple(static_cast<unsigned short>(c.n));
+          break;
+        case Op::ANTIALIASING:      canvas.enableAntialiasing(); break;
+        case Op::SCISSOR:
+          canvas.setScissor(recti::ltrb(int(d[c.i]), int(d[c.i+1]),
+                                        int(d[c.i+2]), int(d[c.i+3])));
+          break;
+        case Op::NO_SCISSOR:        canvas.disableScissor(); break;
+        case Op::VIEWPORT:
+          canvas.viewport(int(d[c.i]), int(d[c.i+1]),
+                          int(d[c.i+2]), int(d[c.i+3]));
+          break;
+        case Op::ORTHOGRAPHIC:
+          canvas.orthographic(rectd::ltrb(d[c.i], d[c.i+1],
+                                          d[c.i+2], d[c.i+3]),
+                              d[c.i+4], d[c.i+5]);
+          break;
+        case Op::PERSPECTIVE:
+          canvas.perspective(d[c.i], d[c.i+1], d[c.i+2], d[c.i+3]);
+          break;
+        case Op::PUSH_MATRIX:       canvas.pushMatrix(); break;
+        case Op::POP_MATRIX:        canvas.popMatrix(); break;
+        case Op::TRANSLATE:         canvas.translate(verts[c.i]); break;
+        case Op::SCALE:             canvas.scale(verts[c.i]); break;
+        case Op::ROTATE:            canvas.rotate(verts[c.i], d[c.n]); break;
+        case Op::TRANSFORM:         canvas.transform(txforms[c.i]); break;
+        case Op::LOAD_MATRIX:       canvas.loadMatrix(txforms[c.i]); break;
+        case Op::DRAW_PIXELS:
+          canvas.drawPixels(*images[c.n],
+                            vec3d(d[c.i], d[c.i+1], d[c.i+2]),
+                            vec2d(d[c.i+3], d[c.i+4]));
+          break;
+        case Op::DRAW_BITMAP:
+          canvas.drawBitmap(*images[c.n],
+                            vec3d(d[c.i], d[c.i+1], d[c.i+2]));
+          break;
+        case Op::CLEAR:             canvas.clearColorBuffer(); break;
+        case Op::CLEAR_RECT:
+          canvas.clearColorBuffer(recti::ltrb(int(d[c.i]), int(d[c.i+1]),
+                                              int(d[c.i+2]), int(d[c.i+3])));
+          break;
+        case Op::DRAW_RECT:
+          canvas.drawRect(rectd::ltrb(d[c.i], d[c.i+1],
+                                      d[c.i+2], d[c.i+3]));
+          break;
+        case Op::CIRCLE:
+          canvas.drawCircle(d[c.i], d[c.i+1], d[c.i+2] != 0.0,
+                            (unsigned int)(d[c.i+3]),
+                            (unsigned int)(d[c.i+4]));
+          break;
+        case Op::CYLINDER:
+          canvas.drawCylinder(d[c.i], d[c.i+1], d[c.i+2],
+                              int(d[c.i+3]), int(d[c.i+4]),
+                              d[c.i+5] != 0.0);
+          break;
+        case Op::SPHERE:
+          canvas.drawSphere(d[c.i], int(d[c.i+1]), int(d[c.i+2]),
+                            d[c.i+3] != 0.0);
+          break;
+        case Op::BEZIER4:
+          canvas.drawBezier4(verts[c.i], verts[c.i+1],
+                             verts[c.i+2], verts[c.i+3],
+                             (unsigned int)(c.n));
+          break;
+        case Op::BEZIER_FILL4:
+          canvas.drawBezierFill4(verts[c.i], verts[c.i+1], verts[c.i+2],
+                                 verts[c.i+3], verts[c.i+4],
+                                 (unsigned int)(c.n));
+          break;
+        case Op::BEGIN:
+          canvas.begin(Gfx::Canvas::VertexStyle(c.n));
+          break;
+        case Op::VERTICES2:
+          for (size_t k = c.i; k < c.i + c.n; ++k)
+            canvas.vertex2(verts[k].as_vec2());
+          break;
+        case Op::VERTICES3:
+          for (size_t k = c.i; k < c.i + c.n; ++k)
+            canvas.vertex3(verts[k]);
+          break;
+        case Op::END:               canvas.end(); break;
+        case Op::ARRAYS:
+          {
+            const vec3d* p = &verts[size_t(d[c.i+1])];
+            canvas.drawArrays(Gfx::Canvas::VertexStyle(int(d[c.i])), p,
+                              d[c.i+2] != 0.0 ? p + c.n : nullptr, c.n);
+          }
+          break;
+        case Op::RASTER_TEXT:
+          canvas.drawRasterText(strings[c.i], *rfonts[c.n]);
+          break;
+        case Op::VECTOR_TEXT:
+          canvas.drawVectorText(strings[c.i], *vfonts[c.n]);
+          break;
+        case Op::CALL_NODE:
+          if (nodes[c.i].is_valid())
+            nodes[c.i]->draw(canvas);
+          break;
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////
+//
+// Gfx::CmdList member definitions
+//
+///////////////////////////////////////////////////////////////////////
+
+Gfx::CmdList::CmdList() :
+  rep(new Impl)
+{
+GVX_TRACE("Gfx::CmdList::CmdList");
+}
+
+Gfx::CmdList::~CmdList() noexcept
+{
+GVX_TRACE("Gfx::CmdList::~CmdList");
+  delete rep;
+}
+
+void Gfx::CmdList::clear() noexcept
+{
+GVX_TRACE("Gfx::CmdList::clear");
+  rep->clear();
+}
+
+size_t Gfx::CmdList::numCommands() const
+{
+  return rep->cmds.size();
+}
+
+size_t Gfx::CmdList::numVertices() const
+{
+  return rep->verts.size();
+}
+
+size_t Gfx::CmdList::numNodeCalls() const
+{
+  return rep->nodes.size();
+}
+
+void Gfx::CmdList::replay(Gfx::Canvas& canvas) const
+{
+GVX_TRACE("Gfx::CmdList::replay");
+  rep->replay(canvas);
+}
+
+///////////////////////////////////////////////////////////////////////
+//
+// Gfx::RecordCanvas member definitions
+//
+///////////////////////////////////////////////////////////////////////
+
+namespace
+{
+  typedef Gfx::CmdList::Impl::Op Op;
+
+  // Get a shared reference to a font, so that the font outlives the
+  // recorded commands that draw with it.
+  template <class F>
+  std::shared_ptr<const F> holdFont(const F& font)
+  {
+    try
+      {
+        return std::static_pointer_cast<const F>(font.shared_from_this());
+      }
+    catch (std::bad_weak_ptr&)
+      {
+        throw rutz::error(rutz::sfmt("can't record text drawn with font "
+                                     "'%s', which is not owned by a "
+                                     "shared_ptr", font.fontName()),
+                          SRC_POS);
+      }
+  }
+}
+
+Gfx::RecordCanvas::RecordCanvas(Gfx::CmdList& list, Gfx::Canvas& target) :
+  itsList(*list.rep),
+  itsTarget(target)
+{
+GVX_TRACE("Gfx::RecordCanvas::RecordCanvas");
+  itsList.clear();
+}
+
+Gfx::RecordCanvas::~RecordCanvas() noexcept
+{
+GVX_TRACE("Gfx::RecordCanvas::~RecordCanvas");
+}
+
+void Gfx::RecordCanvas::callNode(const GxNode& node)
+{
+GVX_TRACE("Gfx::RecordCanvas::callNode");
+  itsList.nodes.push_back(nub::soft_ref<const GxNode>
+                          (&node, nub::ref_type::WEAK,
+                           nub::ref_vis_private()));
+  itsList.add(Op::CALL_NODE, itsList.nodes.size() - 1);
+  node.draw(itsTarget);
+}
+
+vec3d Gfx::RecordCanvas::screenFromWorld3(const vec3d& world_pos) const
+{
+  return itsTarget.screenFromWorld3(world_pos);
+}
+
+vec3d Gfx::RecordCanvas::worldFromScreen3(const vec3d& screen_pos) const
+{
+  return itsTarget.worldFromScreen3(screen_pos);
+}
+
+recti Gfx::RecordCanvas::getScreenViewport() const
+{
+  return itsTarget.getScreenViewport();
+}
+
+bool Gfx::RecordCanvas::isRgba() const
+{
+  return itsTarget.isRgba();
+}
+
+bool Gfx::RecordCanvas::isColorIndex() const
+{
+  return itsTarget.isColorIndex();
+}
+
+bool Gfx::RecordCanvas::isDoubleBuffered() const
+{
+  return itsTarget.isDoubleBuffered();
+}
+
+unsigned int Gfx::RecordCanvas::bitsPerPixel() const
+{
+  return itsTarget.bitsPerPixel();
+}
+
+void Gfx::RecordCanvas::throwIfError(const char* where,
+                                     const rutz::file_pos& pos) const
+{
+  itsTarget.throwIfError(where, pos);
+}
+
+void Gfx::RecordCanvas::pushAttribs(const char* comment)
+{
+  itsList.add(Op::PUSH_ATTRIBS);
+  itsTarget.pushAttribs(comment);
+}
+
+void Gfx::RecordCanvas::popAttribs()
+{
+  itsList.add(Op::POP_ATTRIBS);
+  itsTarget.popAttribs();
+}
+
+void Gfx::RecordCanvas::drawOnFrontBuffer()
+{
+  itsList.add(Op::FRONT_BUFFER);
+  itsTarget.drawOnFrontBuffer();
+}
+
+void Gfx::RecordCanvas::drawOnBackBuffer()
+{
+  itsList.add(Op::BACK_BUFFER);
+  itsTarget.drawOnBackBuffer();
+}
+
+void Gfx::RecordCanvas::setColor(const Gfx::RgbaColor& rgba)
+{
+  itsList.colors.push_back(rgba);
+  itsList.add(Op::COLOR, itsList.colors.size() - 1);
+  itsTarget.setColor(rgba);
+}
+
+void Gfx::RecordCanvas::setClearColor(const Gfx::RgbaColor& rgba)
+{
+  itsList.colors.push_back(rgba);
+  itsList.add(Op::CLEAR_COLOR, itsList.colors.size() - 1);
+  itsTarget.setClearColor(rgba);
+}
+
+void Gfx::RecordCanvas::setColorIndex(unsigned int index)
+{
+  itsList.add(Op::COLOR_INDEX, 0, index);
+  itsTarget.setColorIndex(index);
+}
+
+void Gfx::RecordCanvas::setClearColorIndex(unsigned int index)
+{
+  itsList.add(Op::CLEAR_COLOR_INDEX, 0, index);
+  itsTarget.setClearColorIndex(index);
+}
+
+void Gfx::RecordCanvas::swapForeBack()
+{
+  itsList.add(Op::SWAP_FORE_BACK);
+  itsTarget.swapForeBack();
+}
+
+void Gfx::RecordCanvas::setPolygonFill(bool on)
+{
+  itsList.add(Op::POLYGON_FILL, 0, on ? 1 : 0);
+  itsTarget.setPolygonFill(on);
+}
+
+void Gfx::RecordCanvas::setPointSize(double size)
+{
+  itsList.add(Op::POINT_SIZE, itsList.addNums({size}));
+  itsTarget.setPointSize(size);
+}
+
+void Gfx::RecordCanvas::setLineWidth(double width)
+{
+  itsList.add(Op::LINE_WIDTH, itsList.addNums({width}));
+  itsTarget.setLineWidth(width);
+}
+
+void Gfx::RecordCanvas::setLineStipple(unsigned short bit_pattern)
+{
+  itsList.add(Op::LINE_STIPPLE, 0, bit_pattern);
+  itsTarget.setLineStipple(bit_pattern);
+}
+
+void Gfx::RecordCanvas::enableAntialiasing()
+{
+  itsList.add(Op::ANTIALIASING);
+  itsTarget.enableAntialiasing();
+}
+
+void Gfx::RecordCanvas::setScissor(const recti& screen_rect)
+{
+  itsList.add(Op::SCISSOR,
+              itsList.addNums({double(screen_rect.left()),
+                               double(screen_rect.top()),
+                               double(screen_rect.right()),
+                               double(screen_rect.bottom())}));
+  itsTarget.setScissor(screen_rect);
+}
+
+void Gfx::RecordCanvas::disableScissor()
+{
+  itsList.add(Op::NO_SCISSOR);
+  itsTarget.disableScissor();
+}
+
+void Gfx::RecordCanvas::viewport(int x, int y, int w, int h)
+{
+  itsList.add(Op::VIEWPORT, itsList.addNums({double(x), double(y),
+                                             double(w), double(h)}));
+  itsTarget.viewport(x, y, w, h);
+}
+
+void Gfx::RecordCanvas::orthographic(const rectd& bounds,
+                                     double zNear, double zFar)
+{
+  itsList.add(Op::ORTHOGRAPHIC,
+              itsList.addNums({bounds.left(), bounds.top(),
+                               bounds.right(), bounds.bottom(),
+                               zNear, zFar}));
+  itsTarget.orthographic(bounds, zNear, zFar);
+}
+
+void Gfx::RecordCanvas::perspective(double fovy, double aspect,
+                                    double zNear, double zFar)
+{
+  itsList.add(Op::PERSPECTIVE,
+              itsList.addNums({fovy, aspect, zNear, zFar}));
+  itsTarget.perspective(fovy, aspect, zNear, zFar);
+}
+
+void Gfx::RecordCanvas::pushMatrix(const char* comment)
+{
+  itsList.add(Op::PUSH_MATRIX);
+  itsTarget.pushMatrix(comment);
+}
+
+void Gfx::RecordCanvas::popMatrix()
+{
+  itsList.add(Op::POP_MATRIX);
+  itsTarget.popMatrix();
+}
+
+void Gfx::RecordCanvas::translate(const vec3d& v)
+{
+  itsList.add(Op::TRANSLATE, itsList.addVert(v));
+  itsTarget.translate(v);
+}
+
+void Gfx::RecordCanvas::scale(const vec3d& v)
+{
+  itsList.add(Op::SCALE, itsList.addVert(v));
+  itsTarget.scale(v);
+}
+
+void Gfx::RecordCanvas::rotate(const vec3d& v, double degrees)
+{
+  const size_t i = itsList.addVert(v);
+  itsList.add(Op::ROTATE, i, itsList.addNums({degrees}));
+  itsTarget.rotate(v, degrees);
+}
+
+void Gfx::RecordCanvas::transform(const txform& tx)
+{
+  itsList.txforms.push_back(tx);
+  itsList.add(Op::TRANSFORM, itsList.txforms.size() - 1);
+  itsTarget.transform(tx);
+}
+
+void Gfx::RecordCanvas::loadMatrix(const txform& tx)
+{
+  itsList.txforms.push_back(tx);
+  itsList.add(Op::LOAD_MATRIX, itsList.txforms.size() - 1);
+  itsTarget.loadMatrix(tx);
+}
+
+void Gfx::RecordCanvas::drawPixels(const media::bmap_data& data,
+                                   const vec3d& world_pos,
+                                   const vec2d& zoom)
+{
+  itsList.images.push_back
+    (std::make_unique<media::bmap_data>(data));
+  itsList.add(Op::DRAW_PIXELS,
+              itsList.addNums({world_pos.x(), world_pos.y(), world_pos.z(),
+                               zoom.x(), zoom.y()}),
+              itsList.images.size() - 1);
+  itsTarget.drawPixels(data, world_pos, zoom);
+}
+
+void Gfx::RecordCanvas::drawBitmap(const media::bmap_data& data,
+                                   const vec3d& world_pos)
+{
+  itsList.images.push_back
+    (std::make_unique<media::bmap_data>(data));
+  itsList.add(Op::DRAW_BITMAP,
+              itsList.addNums({world_pos.x(), world_pos.y(), world_pos.z()}),
+              itsList.images.size() - 1);
+  itsTarget.drawBitmap(data, world_pos);
+}
+
+media::bmap_data Gfx::RecordCanvas::grabPixels(const recti& bounds)
+{
+  return itsTarget.grabPixels(bounds);
+}
+
+media::bmap_data Gfx::RecordCanvas::grabDrawnPixels(const recti& bounds)
+{
+  return itsTarget.grabDrawnPixels(bounds);
+}
+
+void Gfx::RecordCanvas::clearColorBuffer()
+{
+  itsList.add(Op::CLEAR);
+  itsTarget.clearColorBuffer();
+}
+
+void Gfx::RecordCanvas::clearColorBuffer(const recti& screen_rect)
+{
+  itsList.add(Op::CLEAR_RECT,
+              itsList.addNums({double(screen_rect.left()),
+                               double(screen_rect.top()),
+                               double(screen_rect.right()),
+                               double(screen_rect.bottom())}));
+  itsTarget.clearColorBuffer(screen_rect);
+}
+
+void Gfx::RecordCanvas::drawRect(const rectd& rect)
+{
+  itsList.add(Op::DRAW_RECT,
+              itsList.addNums({rect.left(), rect.top(),
+                               rect.right(), rect.bottom()}));
+  itsTarget.drawRect(rect);
+}
+
+void Gfx::RecordCanvas::drawCircle(double inner_radius, double outer_radius,
+                                   bool fill, unsigned int slices,
+                                   unsigned int loops)
+{
+  itsList.add(Op::CIRCLE,
+              itsList.addNums({inner_radius, outer_radius,
+                               fill ? 1.0 : 0.0,
+                               double(slices), double(loops)}));
+  itsTarget.drawCircle(inner_radius, outer_radius, fill, slices, loops);
+}
+
+void Gfx::RecordCanvas::drawCylinder(double base_radius, double top_radius,
+                                     double height, int slices, int stacks,
+                                     bool fill)
+{
+  itsList.add(Op::CYLINDER,
+              itsList.addNums({base_radius, top_radius, height,
+                               double(slices), double(stacks),
+                               fill ? 1.0 : 0.0}));
+  itsTarget.drawCylinder(base_radius, top_radius, height,
+                         slices, stacks, fill);
+}
+
+void Gfx::RecordCanvas::drawSphere(double radius, int slices, int stacks,
+                                   bool fill)
+{
+  itsList.add(Op::SPHERE,
+              itsList.addNums({radius, double(slices), double(stacks),
+                               fill ? 1.0 : 0.0}));
+  itsTarget.drawSphere(radius, slices, stacks, fill);
+}
+
+void Gfx::RecordCanvas::drawBezier4(const vec3d& p1,
+                                    const vec3d& p2,
+                                    const vec3d& p3,
+                                    const vec3d& p4,
+                                    unsigned int subdivisions)
+{
+  const size_t i = itsList.addVert(p1);
+  itsList.addVert(p2);
+  itsList.addVert(p3);
+  itsList.addVert(p4);
+  itsList.add(Op::BEZIER4, i, subdivisions);
+  itsTarget.drawBezier4(p1, p2, p3, p4, subdivisions);
+}
+
+void Gfx::RecordCanvas::drawBezierFill4(const vec3d& center,
+                                        const vec3d& p1,
+                                        const vec3d& p2,
+                                        const vec3d& p3,
+                                        const vec3d& p4,
+                                        unsigned int subdivisions)
+{
+  const size_t i = itsList.addVert(center);
+  itsList.addVert(p1);
+  itsList.addVert(p2);
+  itsList.addVert(p3);
+  itsList.addVert(p4);
+  itsList.add(Op::BEZIER_FILL4, i, subdivisions);
+  itsTarget.drawBezierFill4(center, p1, p2, p3, p4, subdivisions);
+}
+
+bool Gfx::RecordCanvas::drawsCurvesNatively() const
+{
+  return itsTarget.drawsCurvesNatively();
+}
+
+bool Gfx::RecordCanvas::wantsLabels() const
+{
+  return itsTarget.wantsLabels();
+}
+
+void Gfx::RecordCanvas::beginSeries(Gfx::Canvas::VertexStyle s,
+                                    const char* comment)
+{
+  itsList.add(Op::BEGIN, 0, size_t(s));
+  itsTarget.begin(s, comment);
+}
+
+void Gfx::RecordCanvas::beginPoints(const char* comment)
+{ beginSeries(VertexStyle::POINTS, comment); }
+
+void Gfx::RecordCanvas::beginLines(const char* comment)
+{ beginSeries(VertexStyle::LINES, comment); }
+
+void Gfx::RecordCanvas::beginLineStrip(const char* comment)
+{ beginSeries(VertexStyle::LINE_STRIP, comment); }
+
+void Gfx::RecordCanvas::beginLineLoop(const char* comment)
+{ beginSeries(VertexStyle::LINE_LOOP, comment); }
+
+void Gfx::RecordCanvas::beginTriangles(const char* comment)
+{ beginSeries(VertexStyle::TRIANGLES, comment); }
+
+void Gfx::RecordCanvas::beginTriangleStrip(const char* comment)
+{ beginSeries(VertexStyle::TRIANGLE_STRIP, comment); }
+
+void Gfx::RecordCanvas::beginTriangleFan(const char* comment)
+{ beginSeries(VertexStyle::TRIANGLE_FAN, comment); }
+
+void Gfx::RecordCanvas::beginQuads(const char* comment)
+{ beginSeries(VertexStyle::QUADS, comment); }
+
+void Gfx::RecordCanvas::beginQuadStrip(const char* comment)
+{ beginSeries(VertexStyle::QUAD_STRIP, comment); }
+
+void Gfx::RecordCanvas::beginPolygon(const char* comment)
+{ beginSeries(VertexStyle::POLYGON, comment); }
+
+void Gfx::RecordCanvas::vertex2(const vec2d& v)
+{
+  itsList.addVertex(Op::VERTICES2, vec3d(v.x(), v.y(), 0.0));
+  itsTarget.vertex2(v);
+}
+
+void Gfx::RecordCanvas::vertex3(const vec3d& v)
+{
+  itsList.addVertex(Op::VERTICES3, v);
+  itsTarget.vertex3(v);
+}
+
+void Gfx::RecordCanvas::end()
+{
+  itsList.add(Op::END);
+  itsTarget.end();
+}
+
+void Gfx::RecordCanvas::drawArrays(VertexStyle s, const vec3d* pts,
+                                   const vec3d* normals, size_t n)
+{
+  const size_t first = itsList.verts.size();
+  itsList.verts.insert(itsList.verts.end(), pts, pts + n);
+  if (normals != nullptr)
+    itsList.verts.insert(itsList.verts.end(), normals, normals + n);
+  itsList.add(Op::ARRAYS,
+              itsList.addNums({double(int(s)), double(first),
+                               normals != nullptr ? 1.0 : 0.0}),
+              n);
+  itsTarget.drawArrays(s, pts, normals, n);
+}
+
+void Gfx::RecordCanvas::drawRasterText(const rutz::fstring& text,
+                                       const GxRasterFont& font)
+{
+  itsList.strings.push_back(text);
+  itsList.rfonts.push_back(holdFont(font));
+  itsList.add(Op::RASTER_TEXT, itsList.strings.size() - 1,
+              itsList.rfonts.size() - 1);
+  itsTarget.drawRasterText(text, font);
+}
+
+void Gfx::RecordCanvas::drawVectorText(const rutz::fstring& text,
+                                       const GxVectorFont& font)
+{
+  itsList.strings.push_back(text);
+  itsList.vfonts.push_back(holdFont(font));
+  itsList.add(Op::VECTOR_TEXT, itsList.strings.size() - 1,
+              itsList.vfonts.size() - 1);
+  itsTarget.drawVectorText(text, font);
+}
+
+void Gfx::RecordCanvas::flushOutput()
+{
+  itsTarget.flushOutput();
+}
+
+void Gfx::RecordCanvas::finishDrawing()
+{
+  itsTarget.finishDrawing();
+}
@@ -0,0 +1,272 @@
+/** @file gfx/recordcanvas.h Gfx::Canvas subclass that records drawing
+    commands into a retained, canvas-independent command buffer */
+
+///////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026-2026 Rob Peters
+// Rob Peters <https://github.com/rjpcal/>
+//
+// created: Mon Oct 19 09:12:40 2026
+//
+// --------------------------------------------------------------------
+//
+// This file is part of GroovX.
+//   [https://github.com/rjpcal/groovx]
+//
+// GroovX is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// GroovX is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GroovX; if not, write to the Free Software Foundation,
+// Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef GROOVX_GFX_RECORDCANVAS_H_UTC20261019091240_DEFINED
+#define GROOVX_GFX_RECORDCANVAS_H_UTC20261019091240_DEFINED
+
+#include "gfx/canvas.h"
+
+#include <cstddef>
+
+class GxNode;
+
+namespace Gfx
+{
+  class CmdList;
+  class RecordCanvas;
+}
+
+///////////////////////////////////////////////////////////////////////
+/**
+ *
+ * Gfx::CmdList is a retained buffer of Canvas commands. Vertices are
+ * stored contiguously in a single vertex buffer, and state changes,
+ * primitives and text are stored as compact commands that refer into
+ * that buffer. A CmdList is filled by a Gfx::RecordCanvas, and can
+ * later be replayed onto any Gfx::Canvas (GLCanvas, PSCanvas, etc.).
+ *
+ **/
+///////////////////////////////////////////////////////////////////////
+
+class Gfx::CmdList
+{
+public:
+  /// Construct an empty command list.
+  CmdList();
+
+  /// Destructor.
+  ~CmdList() noexcept;
+
+  /// Forget all recorded commands.
+  void clear() noexcept;
+
+  /// Get the number of recorded commands.
+  size_t numCommands() const;
+
+  /// Get the number of vertices held in the retained vertex buffer.
+  size_t numVertices() const;
+
+  /// Get the number of nested nodes that are replayed by reference.
+  size_t numNodeCalls() const;
+
+  /// Issue all of the recorded commands to \a canvas.
+  void replay(Gfx::Canvas& canvas) const;
+
+  class Impl;
+
+private:
+  CmdList(const CmdList&);
+  CmdList& operator=(const CmdList&);
+
+  friend class Gfx::RecordCanvas;
+
+  Impl* const rep;
+};
+
+///////////////////////////////////////////////////////////////////////
+/**
+ *
+ * Gfx::RecordCanvas forwards every Canvas call to a target canvas,
+ * and at the same time records the call into a Gfx::CmdList (like
+ * OpenGL's GL_COMPILE_AND_EXECUTE). Queries (viewport, projections,
+ * pixel format) are answered by the target canvas and are not
+ * recorded; nor are flushOutput(), grabPixels() or grabDrawnPixels().
+ *
+ * Nodes that maintain their own recordings can call callNode() so
+ * that the enclosing recording refers to them by reference rather
+ * than inlining their commands; that way a change in the nested node
+ * requires only the nested node to be re-recorded.
+ *
+ **/
+///////////////////////////////////////////////////////////////////////
+
+class Gfx::RecordCanvas : public Gfx::Canvas
+{
+public:
+  /// Record into \a list while drawing onto \a target.
+  /** Any commands previously held in \a list are discarded. */
+  RecordCanvas(Gfx::CmdList& list, Gfx::Canvas& target);
+
+  virtual ~RecordCanvas() noexcept;
+
+  /// Draw \a node now, and record a by-reference call to it.
+  /** On replay, node.draw() is called again if the node still
+      exists; otherwise the call is skipped. */
+  void callNode(const GxNode& node);
+
+  virtual geom::vec3<double> screenFromWorld3(const geom::vec3<double>& world_pos) const override;
+  virtual geom::vec3<double> worldFromScreen3(const geom::vec3<double>& screen_pos) const override;
+
+  virtual geom::rect<int> getScreenViewport() const override;
+
+
+  virtual bool isRgba() const override;
+  virtual bool isColorIndex() const override;
+  virtual bool isDoubleBuffered() const override;
+
+  virtual unsigned int bitsPerPixel() const override;
+
+  virtual void throwIfError(const char* where,
+                            const rutz::file_pos& pos) const override;
+
+
+  virtual void pushAttribs(const char* comment="") override;
+  virtual void popAttribs() override;
+
+  virtual void drawOnFrontBuffer() override;
+  virtual void drawOnBackBuffer() override;
+
+  virtual void setColor(const Gfx::RgbaColor& rgba) override;
+  virtual void setClearColor(const Gfx::RgbaColor& rgba) override;
+
+  virtual void setColorIndex(unsigned int index) override;
+  virtual void setClearColorIndex(unsigned int index) override;
+
+  virtual void swapForeBack() override;
+
+  virtual void setPolygonFill(bool on) override;
+  virtual void setPointSize(double size) override;
+  virtual void setLineWidth(double width) override;
+  virtual void setLineStipple(unsigned short bit_pattern) override;
+
+  virtual void enableAntialiasing() override;
+
+  virtual void setScissor(const geom::rect<int>& screen_rect) override;
+  virtual void disableScissor() override;
+
+
+
+  virtual void viewport(int x, int y, int w, int h) override;
+
+  virtual void orthographic(const geom::rect<double>& bounds,
+                            double zNear, double zFar) override;
+
+  virtual void perspective(double fovy, double aspect,
+                           double zNear, double zFar) override;
+
+
+  virtual void pushMatrix(const char* comment="") override;
+  virtual void popMatrix() override;
+
+  virtual void translate(const geom::vec3<double>& v) override;
+  virtual void scale(const geom::vec3<double>& v) override;
+  virtual void rotate(const geom::vec3<double>& v, double degrees) override;
+
+  virtual void transform(const geom::txform& tx) override;
+  virtual void loadMatrix(const geom::txform& tx) override;
+
+
+
+  virtual void drawPixels(const media::bmap_data& data,
+                          const geom::vec3<double>& world_pos,
+                          const geom::vec2<double>& zoom) override;
+
+  virtual void drawBitmap(const media::bmap_data& data,
+                          const geom::vec3<double>& world_pos) override;
+
+  virtual media::bmap_data grabPixels(const geom::rect<int>& bounds) override;
+  virtual media::bmap_data grabDrawnPixels(const geom::rect<int>& bounds) override;
+
+  virtual void clearColorBuffer() override;
+  virtual void clearColorBuffer(const geom::rect<int>& screen_rect) override;
+
+  virtual void drawRect(const geom::rect<double>& rect) override;
+
+  virtual void drawCircle(double inner_radius, double outer_radius, bool fill,
+                          unsigned int slices, unsigned int loops) override;
+
+  virtual void drawCylinder(double base_radius, double top_radius,
+                            double height, int slices, int stacks,
+                            bool fill) override;
+
+  virtual void drawSphere(double radius, int slices, int stacks,
+                          bool fill) override;
+
+  virtual void drawBezier4(const geom::vec3<double>& p1,
+                           const geom::vec3<double>& p2,
+                           const geom::vec3<double>& p3,
+                           const geom::vec3<double>& p4,
+                           unsigned int subdivisions) override;
+
+  virtual void drawBezierFill4(const geom::vec3<double>& center,
+                               const geom::vec3<double>& p1,
+                               const geom::vec3<double>& p2,
+                               const geom::vec3<double>& p3,
+                               const geom::vec3<double>& p4,
+                               unsigned int subdivisions) override;
+
+  /// Returns whatever the target canvas returns.
+  virtual bool drawsCurvesNatively() const override;
+
+  /// Returns whatever the target canvas returns.
+  virtual bool wantsLabels() const override;
+
+  virtual void beginPoints(const char* comment="") override;
+  virtual void beginLines(const char* comment="") override;
+  virtual void beginLineStrip(const char* comment="") override;
+  virtual void beginLineLoop(const char* comment="") override;
+  virtual void beginTriangles(const char* comment="") override;
+  virtual void beginTriangleStrip(const char* comment="") override;
+  virtual void beginTriangleFan(const char* comment="") override;
+  virtual void beginQuads(const char* comment="") override;
+  virtual void beginQuadStrip(const char* comment="") override;
+  virtual void beginPolygon(const char* comment="") override;
+
+  virtual void vertex2(const geom::vec2<double>& v) override;
+  virtual void vertex3(const geom::vec3<double>& v) override;
+
+  virtual void end() override;
+
+  virtual void drawArrays(VertexStyle s,
+                          const geom::vec3<double>* pts,
+                          const geom::vec3<double>* normals,
+                          size_t n) override;
+
+  virtual void drawRasterText(const rutz::fstring& text,
+                              const GxRasterFont& font) override;
+  virtual void drawVectorText(const rutz::fstring& text,
+                              const GxVectorFont& font) override;
+
+  virtual void flushOutput() override;
+
+  virtual void finishDrawing() override;
+
+private:
+  RecordCanvas(const RecordCanvas&);
+  RecordCanvas& operator=(const RecordCanvas&);
+
+  void beginSeries(Gfx::Canvas::VertexStyle s, const char* comment);
+
+  Gfx::CmdList::Impl& itsList;
+  Gfx::Canvas& itsTarget;
+};
+
+#endif // !GROOVX_GFX_RECORDCANVAS_H_UTC20261019091240_DEFINED
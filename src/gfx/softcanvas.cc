@@ -0,0 +1,1529 @@
+/** @file gfx/softcanvas.cc Gfx::Canvas subclass that rasterizes on the
+    CPU into an in-memory RGBA frame buffer */
+
+///////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026-2026 Rob Peters
+// Rob Peters <https://github.com/rjpcal/>
+//
+// created: Mon Oct 19 13:40:52 2026
+//
+// --------------------------------------------------------------------
+//
+// This file is part of GroovX.
+//   [https://github.com/rjpcal/groovx]
+//
+// GroovX is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// GroovX is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GroovX; if not, write to the Free Software Foundation,
+// Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include "gfx/softcanvas.h"
+
+#include "geom/projection.h"
+#include "geom/rect.h"
+#include "geom/txform.h"
+#include "geom/vec2.h"
+#include "geom/vec3.h"
+
+#include "gfx/gxrasterfont.h"
+#include "gfx/gxvectorfont.h"
+#include "gfx/rgbacolor.h"
+
+#include "media/bmapdata.h"
+
+#include "rutz/error.h"
+#include "rutz/fstring.h"
+#include "rutz/sfmt.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <thread>
+#include <vector>
+
+#include "rutz/trace.h"
+#include "rutz/debug.h"
+GVX_DBG_REGISTER
+
+using geom::recti;
+using geom::rectd;
+using geom::txform;
+using geom::vec2d;
+using geom::vec2st;
+using geom::vec3d;
+
+namespace
+{
+  // Pixels are packed as r | g<<8 | b<<16 | a<<24, so that a span of
+  // constant color can be filled with plain 32-bit stores (which the
+  // compiler turns into vector stores).
+  typedef uint32_t pixel;
+
+  uint32_t toByte(float c)
+  {
+    if (!(c > 0.0f)) return 0;
+    if (c >= 1.0f) return 255;
+    return uint32_t(std::lround(c * 255.0f));
+  }
+
+  pixel packColor(const Gfx::RgbaColor& c)
+  {
+    return toByte(c.r()) | (toByte(c.g()) << 8)
+      | (toByte(c.b()) << 16) | (toByte(c.a()) << 24);
+  }
+
+  // Blend src over dst with (SRC_ALPHA, ONE_MINUS_SRC_ALPHA), rounding
+  // to nearest; this is exact integer arithmetic so results don't
+  // depend on the platform.
+  pixel blendPixel(pixel dst, pixel src)
+  {
+    const uint32_t a = src >> 24;
+    const uint32_t na = 255 - a;
+    pixel out = 0;
+    for (int shift = 0; shift < 32; shift += 8)
+      {
+        const uint32_t s = (src >> shift) & 0xff;
+        const uint32_t d = (dst >> shift) & 0xff;
+        const uint32_t v = s * a + d * na + 127;
+        out |= ((v + (v >> 8)) >> 8) << shift;
+      }
+    return out;
+  }
+
+  void fillSpan(pixel* row, int x0, int x1, pixel c, bool blend)
+  {
+    if (!blend || (c >> 24) == 255)
+      std::fill(row + x0, row + x1, c);
+    else
+      for (int x = x0; x < x1; ++x)
+        row[x] = blendPixel(row[x], c);
+  }
+
+  // Clamp a double to [lo,hi] before converting to int, so that
+  // wildly offscreen coordinates can't overflow.
+  int clampToInt(double v, int lo, int hi)
+  {
+    if (!(v > lo)) return lo;
+    if (v > hi) return hi;
+    return int(v);
+  }
+
+  // Vertex in homogeneous clip coordinates.
+  struct vec4
+  {
+    double x, y, z, w;
+  };
+
+  // Vertices closer than this to the eye plane are clipped away.
+  const double MIN_W = 1e-9;
+
+  vec4 lerp(const vec4& a, const vec4& b, double t)
+  {
+    return vec4{a.x + t*(b.x-a.x), a.y + t*(b.y-a.y),
+                a.z + t*(b.z-a.z), a.w + t*(b.w-a.w)};
+  }
+
+  // Polygon edge in window coordinates, with ya < yb.
+  struct Edge
+  {
+    double xa, ya, xb, yb;
+  };
+
+  // Axis-aligned run of pixels produced by a line or point.
+  struct Stamp
+  {
+    int x, y, w, h;
+  };
+
+  struct Image
+  {
+    std::vector<pixel> pixels;        // bottom-first rows; empty for bitmaps
+    std::vector<unsigned char> mask;  // bottom-first rows; empty for pixmaps
+    int w;
+    int h;
+    double x;                         // window position of the lower-left corner
+    double y;
+    double zx;
+    double zy;
+  };
+
+  enum class OpKind
+    {
+      CLEAR,
+      POLYGON,
+      STAMPS,
+      IMAGE
+    };
+
+  struct Op
+  {
+    OpKind kind;
+    pixel color;
+    bool blend;
+    size_t first;     // index into edges, stamps or images
+    size_t count;
+    int x0, y0;       // pixel bounds, half-open, clipped to the frame
+    int x1, y1;
+  };
+
+  // Number of pending ops after which we rasterize right away, to
+  // keep the retained geometry bounded.
+  const size_t MAX_PENDING_OPS = 16384;
+}
+
+class Gfx::SoftCanvas::Impl
+{
+private:
+  Impl(const Impl&);
+  Impl& operator=(const Impl&);
+
+public:
+  struct Attribs
+  {
+    Gfx::RgbaColor color;
+    Gfx::RgbaColor clearColor;
+    bool polygonFill;
+    double pointSize;
+    double lineWidth;
+    unsigned short stipple;
+    bool blend;
+    recti viewport;
+    recti scissor;
+    bool scissored;
+  };
+
+  Impl(int w, int h) :
+    width(w),
+    height(h),
+    frame(size_t(w) * size_t(h), 0),
+    nthreads(1),
+    attribs(),
+    projection(txform::identity()),
+    modelview(1, txform::identity()),
+    projModel(txform::identity()),
+    isProjModelValid(true),
+    inPrimitive(false),
+    style(Gfx::Canvas::VertexStyle::POINTS),
+    verts(),
+    ops(),
+    edges(),
+    stamps(),
+    images(),
+    scratch(),
+    curOp(),
+    curMinX(0.0), curMinY(0.0), curMaxX(0.0), curMaxY(0.0)
+  {
+    if (w < 1 || h < 1)
+      throw rutz::error(rutz::sfmt("invalid SoftCanvas size %dx%d", w, h),
+                        SRC_POS);
+
+    Attribs a;
+    a.color = Gfx::RgbaColor(1.0, 1.0, 1.0, 1.0);
+    a.clearColor = Gfx::RgbaColor(0.0, 0.0, 0.0, 0.0);
+    a.polygonFill = true;
+    a.pointSize = 1.0;
+    a.lineWidth = 1.0;
+    a.stipple = 0xFFFF;
+    a.blend = false;
+    a.viewport = recti::lbwh(0, 0, w, h);
+    a.scissor = recti::lbwh(0, 0, w, h);
+    a.scissored = false;
+    attribs.push_back(a);
+  }
+
+  Attribs& current() { return attribs.back(); }
+  const Attribs& current() const { return attribs.back(); }
+
+  const txform& projModelMatrix()
+  {
+    if (!isProjModelValid)
+      {
+        projModel = projection.mtx_mul(modelview.back());
+        isProjModelValid = true;
+      }
+    return projModel;
+  }
+
+  vec4 toClip(const vec3d& v)
+  {
+    const double* m = projModelMatrix().col_major_data();
+    return vec4{m[0]*v.x() + m[4]*v.y() + m[8]*v.z()  + m[12],
+                m[1]*v.x() + m[5]*v.y() + m[9]*v.z()  + m[13],
+                m[2]*v.x() + m[6]*v.y() + m[10]*v.z() + m[14],
+                m[3]*v.x() + m[7]*v.y() + m[11]*v.z() + m[15]};
+  }
+
+  // Map a clip-space vertex (with w > 0) to window coordinates.
+  vec2d toWindow(const vec4& c) const
+  {
+    const recti& vp = current().viewport;
+    return vec2d(vp.left()   + 0.5 * (c.x/c.w + 1.0) * vp.width(),
+                 vp.bottom() + 0.5 * (c.y/c.w + 1.0) * vp.height());
+  }
+
+  //
+  // Op construction
+  //
+
+  void beginOp(OpKind kind, size_t first)
+  {
+    curOp.kind = kind;
+    curOp.color = packColor(current().color);
+    curOp.blend = current().blend;
+    curOp.first = first;
+    curOp.count = 0;
+    curMinX = curMinY = std::numeric_limits<double>::max();
+    curMaxX = curMaxY = -std::numeric_limits<double>::max();
+  }
+
+  void includeBounds(double x0, double y0, double x1, double y1)
+  {
+    curMinX = std::min(curMinX, x0);
+    curMinY = std::min(curMinY, y0);
+    curMaxX = std::max(curMaxX, x1);
+    curMaxY = std::max(curMaxY, y1);
+  }
+
+  // Shrink the op's pixel bounds to the current scissor rect, if any;
+  // rasterizeBand() never touches pixels outside an op's bounds.
+  void clipToScissor(Op& op) const
+  {
+    if (!current().scissored)
+      return;
+
+    const recti& s = current().scissor;
+    op.x0 = std::max(op.x0, s.left());
+    op.y0 = std::max(op.y0, s.bottom());
+    op.x1 = std::min(op.x1, s.left() + s.width());
+    op.y1 = std::min(op.y1, s.bottom() + s.height());
+  }
+
+  void endOp(size_t count)
+  {
+    if (count == 0)
+      return;
+
+    curOp.count = count;
+    curOp.x0 = clampToInt(std::floor(curMinX), 0, width);
+    curOp.y0 = clampToInt(std::floor(curMinY), 0, height);
+    curOp.x1 = clampToInt(std::ceil(curMaxX) + 1.0, 0, width);
+    curOp.y1 = clampToInt(std::ceil(curMaxY) + 1.0, 0, height);
+    clipToScissor(curOp);
+
+    if (curOp.x0 < curOp.x1 && curOp.y0 < curOp.y1)
+      {
+        ops.push_back(curOp);
+        if (ops.size() >= MAX_PENDING_OPS)
+          rasterize();
+      }
+    else
+      {
+        // nothing visible, so drop the geometry we just added
+        switch (curOp.kind)
+          {
+          case OpKind::POLYGON: edges.resize(curOp.first); break;
+          case OpKind::STAMPS:  stamps.resize(curOp.first); break;
+          case OpKind::IMAGE:   images.resize(curOp.first); break;
+          case OpKind::CLEAR:   break;
+          }
+      }
+  }
+
+  void addClear(const recti& r)
+  {
+    Op op;
+    op.kind = OpKind::CLEAR;
+    op.color = packColor(current().clearColor);
+    op.blend = false;
+    op.first = op.count = 0;
+    op.x0 = std::max(r.left(), 0);
+    op.y0 = std::max(r.bottom(), 0);
+    op.x1 = std::min(r.left() + r.width(), width);
+    op.y1 = std::min(r.bottom() + r.height(), height);
+    clipToScissor(op);
+
+    if (op.x0 >= op.x1 || op.y0 >= op.y1)
+      return;
+
+    // A full-frame clear hides everything drawn before it.
+    if (op.x0 == 0 && op.y0 == 0 && op.x1 == width && op.y1 == height)
+      discardPending();
+
+    ops.push_back(op);
+  }
+
+  //
+  // Polygons
+  //
+
+  // Clip the polygon against the w = MIN_W plane, leaving the result
+  // in scratch.
+  void clipNear(const vec4* v, size_t n)
+  {
+    scratch.clear();
+    for (size_t i = 0; i < n; ++i)
+      {
+        const vec4& a = v[i];
+        const vec4& b = v[(i+1) % n];
+        const bool ina = a.w > MIN_W;
+        const bool inb = b.w > MIN_W;
+        if (ina)
+          scratch.push_back(a);
+        if (ina != inb)
+          scratch.push_back(lerp(a, b, (MIN_W - a.w) / (b.w - a.w)));
+      }
+  }
+
+  void addContour(const vec4* v, size_t n)
+  {
+    clipNear(v, n);
+
+    const size_t m = scratch.size();
+    if (m < 3)
+      return;
+
+    vec2d prev = toWindow(scratch[m-1]);
+    for (size_t i = 0; i < m; ++i)
+      {
+        const vec2d cur = toWindow(scratch[i]);
+        includeBounds(cur.x(), cur.y(), cur.x(), cur.y());
+        if (cur.y() < prev.y())
+          edges.push_back(Edge{cur.x(), cur.y(), prev.x(), prev.y()});
+        else if (cur.y() > prev.y())
+          edges.push_back(Edge{prev.x(), prev.y(), cur.x(), cur.y()});
+        prev = cur;
+      }
+  }
+
+  void polygon(const vec4* v, size_t n)
+  {
+    if (n < 3)
+      return;
+
+    if (current().polygonFill)
+      {
+        beginOp(OpKind::POLYGON, edges.size());
+        addContour(v, n);
+        endOp(edges.size() - curOp.first);
+      }
+    else
+      {
+        beginOp(OpKind::STAMPS, stamps.size());
+        int counter = 0;
+        for (size_t i = 0; i < n; ++i)
+          line(v[i], v[(i+1) % n], counter);
+        endOp(stamps.size() - curOp.first);
+      }
+  }
+
+  //
+  // Lines and points
+  //
+
+  void addStamp(int x, int y, int w, int h)
+  {
+    // merge with the previous stamp where possible, so that e.g. a
+    // horizontal line becomes a single run
+    if (stamps.size() > curOp.first)
+      {
+        Stamp& s = stamps.back();
+        if (s.y == y && s.h == h)
+          {
+            if (s.x + s.w == x)   { s.w += w; return; }
+            if (x + w == s.x)     { s.x = x; s.w += w; return; }
+          }
+        if (s.x == x && s.w == w)
+          {
+            if (s.y + s.h == y)   { s.h += h; return; }
+            if (y + h == s.y)     { s.y = y; s.h += h; return; }
+          }
+      }
+    stamps.push_back(Stamp{x, y, w, h});
+  }
+
+  // Produce one fragment per major-axis pixel center in the half-open
+  // segment [p0,p1), each widened along the minor axis by the line
+  // width; the stipple counter carries across segments of a strip.
+  void line(const vec4& a0, const vec4& b0, int& counter)
+  {
+    vec4 a = a0, b = b0;
+    if (a.w <= MIN_W && b.w <= MIN_W)
+      return;
+    if (a.w <= MIN_W)
+      a = lerp(a, b, (MIN_W - a.w) / (b.w - a.w));
+    else if (b.w <= MIN_W)
+      b = lerp(a, b, (MIN_W - a.w) / (b.w - a.w));
+
+    const vec2d p0 = toWindow(a);
+    const vec2d p1 = toWindow(b);
+
+    const double dx = p1.x() - p0.x();
+    const double dy = p1.y() - p0.y();
+
+    if (dx == 0.0 && dy == 0.0)
+      return;
+
+    const bool xmajor = std::fabs(dx) >= std::fabs(dy);
+
+    // major/minor coordinates
+    const double u0 = xmajor ? p0.x() : p0.y();
+    const double u1 = xmajor ? p1.x() : p1.y();
+    const double v0 = xmajor ? p0.y() : p0.x();
+    const double du = xmajor ? dx : dy;
+    const double dv = xmajor ? dy : dx;
+    const int ulimit = xmajor ? width : height;
+    const int vlimit = xmajor ? height : width;
+
+    const int wi = std::max(1, int(std::lround(std::min(current().lineWidth,
+                                                        1024.0))));
+    const unsigned short stipple = current().stipple;
+
+    const int lo = clampToInt(std::ceil(std::min(u0, u1) - 0.5),
+                              -1, ulimit + 1);
+    const int hi = clampToInt(std::ceil(std::max(u0, u1) - 0.5),
+                              -1, ulimit + 1);
+
+    includeBounds(xmajor ? lo : std::min(p0.x(), p1.x()) - wi,
+                  xmajor ? std::min(p0.y(), p1.y()) - wi : lo,
+                  xmajor ? hi : std::max(p0.x(), p1.x()) + wi,
+                  xmajor ? std::max(p0.y(), p1.y()) + wi : hi);
+
+    const int n = hi - lo;
+    for (int k = 0; k < n; ++k)
+      {
+        const int iu = (du > 0) ? lo + k : hi - 1 - k;
+        const bool on = (stipple >> (counter & 15)) & 1;
+        ++counter;
+        if (!on)
+          continue;
+
+        const double vc = v0 + (iu + 0.5 - u0) * dv / du;
+        const int iv = clampToInt(std::floor(vc), -wi - 1, vlimit + 1)
+          - (wi - 1) / 2;
+
+        if (xmajor) addStamp(iu, iv, 1, wi);
+        else        addStamp(iv, iu, wi, 1);
+      }
+  }
+
+  void point(const vec4& c)
+  {
+    if (c.w <= MIN_W)
+      return;
+
+    const vec2d p = toWindow(c);
+    const int wi = std::max(1, int(std::lround(std::min(current().pointSize,
+                                                        1024.0))));
+    const int x = clampToInt(std::floor(p.x() + 0.5 - 0.5*wi), -wi - 1, width + 1);
+    const int y = clampToInt(std::floor(p.y() + 0.5 - 0.5*wi), -wi - 1, height + 1);
+
+    includeBounds(x, y, x + wi, y + wi);
+    stamps.push_back(Stamp{x, y, wi, wi});
+  }
+
+  //
+  // Primitive assembly
+  //
+
+  void assemble()
+  {
+    const size_t n = verts.size();
+    const vec4* v = verts.data();
+
+    switch (style)
+      {
+      case Gfx::Canvas::VertexStyle::POINTS:
+        beginOp(OpKind::STAMPS, stamps.size());
+        for (size_t i = 0; i < n; ++i)
+          point(v[i]);
+        endOp(stamps.size() - curOp.first);
+        break;
+
+      case Gfx::Canvas::VertexStyle::LINES:
+        beginOp(OpKind::STAMPS, stamps.size());
+        for (size_t i = 0; i + 1 < n; i += 2)
+          {
+            int counter = 0;
+            line(v[i], v[i+1], counter);
+          }
+        endOp(stamps.size() - curOp.first);
+        break;
+
+      case Gfx::Canvas::VertexStyle::LINE_STRIP:
+      case Gfx::Canvas::VertexStyle::LINE_LOOP:
+        {
+          beginOp(OpKind::STAMPS, stamps.size());
+          int counter = 0;
+          for (size_t i = 0; i + 1 < n; ++i)
+            line(v[i], v[i+1], counter);
+          if (style == Gfx::Canvas::VertexStyle::LINE_LOOP && n > 2)
+            line(v[n-1], v[0], counter);
+          endOp(stamps.size() - curOp.first);
+        }
+        break;
+
+      case Gfx::Canvas::VertexStyle::TRIANGLES:
+        for (size_t i = 0; i + 2 < n; i += 3)
+          polygon(v + i, 3);
+        break;
+
+      case Gfx::Canvas::VertexStyle::TRIANGLE_STRIP:
+        for (size_t i = 0; i + 2 < n; ++i)
+          polygon(v + i, 3);
+        break;
+
+      case Gfx::Canvas::VertexStyle::TRIANGLE_FAN:
+        for (size_t i = 1; i + 1 < n; ++i)
+          {
+            const vec4 tri[3] = { v[0], v[i], v[i+1] };
+            polygon(tri, 3);
+          }
+        break;
+
+      case Gfx::Canvas::VertexStyle::QUADS:
+        for (size_t i = 0; i + 3 < n; i += 4)
+          polygon(v + i, 4);
+        break;
+
+      case Gfx::Canvas::VertexStyle::QUAD_STRIP:
+        for (size_t i = 0; i + 3 < n; i += 2)
+          {
+            const vec4 quad[4] = { v[i], v[i+1], v[i+3], v[i+2] };
+            polygon(quad, 4);
+          }
+        break;
+
+      case Gfx::Canvas::VertexStyle::POLYGON:
+        polygon(v, n);
+        break;
+      }
+  }
+
+  void beginPrimitive(Gfx::Canvas::VertexStyle s)
+  {
+    if (inPrimitive)
+      throw rutz::error("SoftCanvas: already in a graphics primitive",
+                        SRC_POS);
+    inPrimitive = true;
+    style = s;
+    verts.clear();
+  }
+
+  //
+  // Rasterization
+  //
+
+  void discardPending()
+  {
+    ops.clear();
+    edges.clear();
+    stamps.clear();
+    images.clear();
+  }
+
+  // NOTE: this runs on worker threads, so it must not use GVX_TRACE
+  // or anything else that touches shared state besides our own rows
+  // of the frame buffer.
+  void rasterizeBand(int ylo, int yhi) const
+  {
+    std::vector<double> xs;
+
+    pixel* const fb = const_cast<pixel*>(frame.data());
+
+    for (const Op& op: ops)
+      {
+        const int y0 = std::max(op.y0, ylo);
+        const int y1 = std::min(op.y1, yhi);
+        if (y0 >= y1)
+          continue;
+
+        switch (op.kind)
+          {
+          case OpKind::CLEAR:
+            for (int y = y0; y < y1; ++y)
+              fillSpan(fb + size_t(y)*size_t(width), op.x0, op.x1,
+                       op.color, false);
+            break;
+
+          case OpKind::POLYGON:
+            {
+              const Edge* const e0 = edges.data() + op.first;
+              const Edge* const e1 = e0 + op.count;
+              for (int y = y0; y < y1; ++y)
+                {
+                  const double yc = y + 0.5;
+                  xs.clear();
+                  for (const Edge* e = e0; e != e1; ++e)
+                    if (e->ya <= yc && yc < e->yb)
+                      xs.push_back(e->xa + (yc - e->ya)
+                                   * (e->xb - e->xa) / (e->yb - e->ya));
+
+                  std::sort(xs.begin(), xs.end());
+
+                  pixel* const row = fb + size_t(y)*size_t(width);
+
+                  // even-odd rule; pixel centers in [xs[k], xs[k+1])
+                  for (size_t k = 0; k + 1 < xs.size(); k += 2)
+                    {
+                      const int xa = clampToInt(std::ceil(xs[k] - 0.5),
+                                                op.x0, op.x1);
+                      const int xb = clampToInt(std::ceil(xs[k+1] - 0.5),
+                                                op.x0, op.x1);
+                      if (xa < xb)
+                        fillSpan(row, xa, xb, op.color, op.blend);
+                    }
+                }
+            }
+            break;
+
+          case OpKind::STAMPS:
+            for (size_t i = op.first; i < op.first + op.count; ++i)
+              {
+                const Stamp& s = stamps[i];
+                const int sx0 = std::max(s.x, op.x0);
+                const int sx1 = std::min(s.x + s.w, op.x1);
+                const int sy0 = std::max(s.y, y0);
+                const int sy1 = std::min(s.y + s.h, y1);
+                for (int y = sy0; y < sy1; ++y)
+                  if (sx0 < sx1)
+                    fillSpan(fb + size_t(y)*size_t(width), sx0, sx1,
+                             op.color, op.blend);
+              }
+            break;
+
+          case OpKind::IMAGE:
+            {
+              const Image& img = images[op.first];
+              for (int y = y0; y < y1; ++y)
+                {
+                  const double fj = std::floor((y + 0.5 - img.y) / img.zy);
+                  if (!(fj >= 0.0 && fj < img.h))
+                    continue;
+                  const size_t j = size_t(fj);
+
+                  pixel* const row = fb + size_t(y)*size_t(width);
+
+                  for (int x = op.x0; x < op.x1; ++x)
+                    {
+                      const double fi = std::floor((x + 0.5 - img.x) / img.zx);
+                      if (!(fi >= 0.0 && fi < img.w))
+                        continue;
+                      const size_t k = j*size_t(img.w) + size_t(fi);
+
+                      pixel p;
+                      if (img.mask.empty())
+                        p = img.pixels[k];
+                      else if (img.mask[k])
+                        p = op.color;
+                      else
+                        continue;
+
+                      row[x] = op.blend ? blendPixel(row[x], p) : p;
+                    }
+                }
+            }
+            break;
+          }
+      }
+  }
+
+  void rasterize()
+  {
+    if (ops.empty())
+      return;
+
+    const int nbands = int(std::min(nthreads, (unsigned int)(height)));
+
+    if (nbands <= 1)
+      {
+        rasterizeBand(0, height);
+      }
+    else
+      {
+        std::vector<std::thread> workers;
+        for (int b = 0; b < nbands - 1; ++b)
+          workers.emplace_back(&Impl::rasterizeBand, this,
+                               (height * b) / nbands,
+                               (height * (b+1)) / nbands);
+
+        rasterizeBand((height * (nbands-1)) / nbands, height);
+
+        for (std::thread& t: workers)
+          t.join();
+      }
+
+    discardPending();
+  }
+
+  int width;
+  int height;
+  std::vector<pixel> frame;      // bottom-first rows
+  unsigned int nthreads;
+
+  std::vector<Attribs> attribs;  // back() is the current state
+
+  txform projection;
+  std::vector<txform> modelview; // back() is the current matrix
+  txform projModel;
+  bool isProjModelValid;
+
+  bool inPrimitive;
+  Gfx::Canvas::VertexStyle style;
+  std::vector<vec4> verts;
+
+  std::vector<Op> ops;           // pending, not yet rasterized
+  std::vector<Edge> edges;
+  std::vector<Stamp> stamps;
+  std::vector<Image> images;
+
+  std::vector<vec4> scratch;
+  Op curOp;
+  double curMinX, curMinY, curMaxX, curMaxY;
+};
+
+///////////////////////////////////////////////////////////////////////
+//
+// Gfx::SoftCanvas member definitions
+//
+///////////////////////////////////////////////////////////////////////
+
+Gfx::SoftCanvas::SoftCanvas(int width, int height) :
+  rep(new Impl(width, height))
+{
+GVX_TRACE("Gfx::SoftCanvas::SoftCanvas");
+}
+
+Gfx::SoftCanvas::~SoftCanvas() noexcept
+{
+GVX_TRACE("Gfx::SoftCanvas::~SoftCanvas");
+  delete rep;
+}
+
+int Gfx::SoftCanvas::width() const
+{
+  return rep->width;
+}
+
+int Gfx::SoftCanvas::height() const
+{
+  return rep->height;
+}
+
+void Gfx::SoftCanvas::setNumThreads(unsigned int n)
+{
+GVX_TRACE("Gfx::SoftCanvas::setNumThreads");
+  rep->nthreads = std::max(n, 1u);
+}
+
+unsigned int Gfx::SoftCanvas::getNumThreads() const
+{
+  return rep->nthreads;
+}
+
+vec3d Gfx::SoftCanvas::screenFromWorld3(const vec3d& world_pos) const
+{
+GVX_TRACE("Gfx::SoftCanvas::screenFromWorld3");
+  return geom::project(rep->modelview.back(), rep->projection,
+                       rep->current().viewport, world_pos);
+}
+
+vec3d Gfx::SoftCanvas::worldFromScreen3(const vec3d& screen_pos) const
+{
+GVX_TRACE("Gfx::SoftCanvas::worldFromScreen3");
+  return geom::unproject(rep->modelview.back(), rep->projection,
+                         rep->current().viewport, screen_pos);
+}
+
+recti Gfx::SoftCanvas::getScreenViewport() const
+{
+GVX_TRACE("Gfx::SoftCanvas::getScreenViewport");
+  return rep->current().viewport;
+}
+
+bool Gfx::SoftCanvas::isRgba() const
+{
+  return true;
+}
+
+bool Gfx::SoftCanvas::isColorIndex() const
+{
+  return false;
+}
+
+bool Gfx::SoftCanvas::isDoubleBuffered() const
+{
+  return false;
+}
+
+unsigned int Gfx::SoftCanvas::bitsPerPixel() const
+{
+  return 32;
+}
+
+void Gfx::SoftCanvas::throwIfError(const char* /*where*/,
+                                   const rutz::file_pos& /*pos*/) const
+{
+  // nothing; errors are reported by exceptions as they happen
+}
+
+void Gfx::SoftCanvas::pushAttribs(const char* /*comment*/)
+{
+GVX_TRACE("Gfx::SoftCanvas::pushAttribs");
+  rep->attribs.push_back(rep->current());
+}
+
+void Gfx::SoftCanvas::popAttribs()
+{
+GVX_TRACE("Gfx::SoftCanvas::popAttribs");
+  if (rep->attribs.size() <= 1)
+    throw rutz::error("SoftCanvas: attrib stack underflow", SRC_POS);
+  rep->attribs.pop_back();
+}
+
+void Gfx::SoftCanvas::drawOnFrontBuffer()
+{
+  // nothing; there is only one buffer
+}
+
+void Gfx::SoftCanvas::drawOnBackBuffer()
+{
+  // nothing; there is only one buffer
+}
+
+void Gfx::SoftCanvas::setColor(const Gfx::RgbaColor& rgba)
+{
+GVX_TRACE("Gfx::SoftCanvas::setColor");
+  rep->current().color = rgba;
+}
+
+void Gfx::SoftCanvas::setClearColor(const Gfx::RgbaColor& rgba)
+{
+GVX_TRACE("Gfx::SoftCanvas::setClearColor");
+  rep->current().clearColor = rgba;
+}
+
+void Gfx::SoftCanvas::setColorIndex(unsigned int /*index*/)
+{
+GVX_TRACE("Gfx::SoftCanvas::setColorIndex");
+  throw rutz::error("SoftCanvas doesn't support color-index mode", SRC_POS);
+}
+
+void Gfx::SoftCanvas::setClearColorIndex(unsigned int /*index*/)
+{
+GVX_TRACE("Gfx::SoftCanvas::setClearColorIndex");
+  throw rutz::error("SoftCanvas doesn't support color-index mode", SRC_POS);
+}
+
+void Gfx::SoftCanvas::swapForeBack()
+{
+GVX_TRACE("Gfx::SoftCanvas::swapForeBack");
+
+  Impl::Attribs& a = rep->current();
+  const Gfx::RgbaColor fore = a.color;
+  const Gfx::RgbaColor back = a.clearColor;
+
+  // like GLCanvas, keep the foreground and background alpha values
+  a.color = Gfx::RgbaColor(back.r(), back.g(), back.b(), fore.a());
+  a.clearColor = Gfx::RgbaColor(fore.r(), fore.g(), fore.b(), back.a());
+}
+
+void Gfx::SoftCanvas::setPolygonFill(bool on)
+{
+GVX_TRACE("Gfx::SoftCanvas::setPolygonFill");
+  rep->current().polygonFill = on;
+}
+
+void Gfx::SoftCanvas::setPointSize(double size)
+{
+GVX_TRACE("Gfx::SoftCanvas::setPointSize");
+  rep->current().pointSize = size;
+}
+
+void Gfx::SoftCanvas::setLineWidth(double width)
+{
+GVX_TRACE("Gfx::SoftCanvas::setLineWidth");
+  rep->current().lineWidth = width;
+}
+
+void Gfx::SoftCanvas::setLineStipple(unsigned short bit_pattern)
+{
+GVX_TRACE("Gfx::SoftCanvas::setLineStipple");
+  rep->current().stipple = bit_pattern;
+}
+
+void Gfx::SoftCanvas::enableAntialiasing()
+{
+GVX_TRACE("Gfx::SoftCanvas::enableAntialiasing");
+  rep->current().blend = true;
+}
+
+void Gfx::SoftCanvas::setScissor(const recti& screen_rect)
+{
+GVX_TRACE("Gfx::SoftCanvas::setScissor");
+  rep->current().scissor = screen_rect;
+  rep->current().scissored = true;
+}
+
+void Gfx::SoftCanvas::disableScissor()
+{
+GVX_TRACE("Gfx::SoftCanvas::disableScissor");
+  rep->current().scissored = false;
+}
+
+void Gfx::SoftCanvas::viewport(int x, int y, int w, int h)
+{
+GVX_TRACE("Gfx::SoftCanvas::viewport");
+  rep->current().viewport = recti::lbwh(x, y, w, h);
+}
+
+void Gfx::SoftCanvas::orthographic(const rectd& bounds,
+                                   double zNear, double zFar)
+{
+GVX_TRACE("Gfx::SoftCanvas::orthographic");
+  rep->projection = txform::orthographic(bounds, zNear, zFar);
+  rep->isProjModelValid = false;
+}
+
+void Gfx::SoftCanvas::perspective(double fovy, double aspect,
+                                  double zNear, double zFar)
+{
+GVX_TRACE("Gfx::SoftCanvas::perspective");
+
+  // same matrix as gluPerspective()
+  const double f = 1.0 / std::tan(fovy * M_PI / 360.0);
+
+  double m[16] = { 0.0 };
+  m[0] = f / aspect;
+  m[5] = f;
+  m[10] = (zFar + zNear) / (zNear - zFar);
+  m[11] = -1.0;
+  m[14] = (2.0 * zFar * zNear) / (zNear - zFar);
+
+  rep->projection = txform::copy_of(&m[0]);
+  rep->isProjModelValid = false;
+}
+
+void Gfx::SoftCanvas::pushMatrix(const char* /*comment*/)
+{
+GVX_TRACE("Gfx::SoftCanvas::pushMatrix");
+  rep->modelview.push_back(rep->modelview.back());
+}
+
+void Gfx::SoftCanvas::popMatrix()
+{
+GVX_TRACE("Gfx::SoftCanvas::popMatrix");
+  if (rep->modelview.size() <= 1)
+    throw rutz::error("SoftCanvas: matrix stack underflow", SRC_POS);
+  rep->modelview.pop_back();
+  rep->isProjModelValid = false;
+}
+
+void Gfx::SoftCanvas::translate(const vec3d& v)
+{
+GVX_TRACE("Gfx::SoftCanvas::translate");
+  rep->modelview.back().translate(v);
+  rep->isProjModelValid = false;
+}
+
+void Gfx::SoftCanvas::scale(const vec3d& v)
+{
+GVX_TRACE("Gfx::SoftCanvas::scale");
+  rep->modelview.back().scale(v);
+  rep->isProjModelValid = false;
+}
+
+void Gfx::SoftCanvas::rotate(const vec3d& v, double degrees)
+{
+GVX_TRACE("Gfx::SoftCanvas::rotate");
+  rep->modelview.back().rotate(v, degrees);
+  rep->isProjModelValid = false;
+}
+
+void Gfx::SoftCanvas::transform(const geom::txform& tx)
+{
+GVX_TRACE("Gfx::SoftCanvas::transform");
+  rep->modelview.back().transform(tx);
+  rep->isProjModelValid = false;
+}
+
+void Gfx::SoftCanvas::loadMatrix(const geom::txform& tx)
+{
+GVX_TRACE("Gfx::SoftCanvas::loadMatrix");
+  rep->modelview.back() = tx;
+  rep->isProjModelValid = false;
+}
+
+void Gfx::SoftCanvas::drawPixels(const media::bmap_data& data,
+                                 const vec3d& world_pos,
+                                 const vec2d& zoom)
+{
+GVX_TRACE("Gfx::SoftCanvas::drawPixels");
+
+  const vec4 c = rep->toClip(world_pos);
+  if (c.w <= MIN_W || zoom.x() == 0.0 || zoom.y() == 0.0
+      || data.width() == 0 || data.height() == 0)
+    return;
+
+  const unsigned int bpp = data.bits_per_pixel();
+  if (bpp != 32 && bpp != 24 && bpp != 8 && bpp != 1)
+    throw rutz::error(rutz::sfmt("SoftCanvas::drawPixels: unsupported "
+                                 "bits per pixel (%u)", bpp), SRC_POS);
+
+  data.set_row_order(media::bmap_data::row_order::BOTTOM_FIRST);
+
+  const vec2d pos = rep->toWindow(c);
+
+  Image img;
+  img.w = int(data.width());
+  img.h = int(data.height());
+  img.x = pos.x();
+  img.y = pos.y();
+  img.zx = zoom.x();
+  img.zy = zoom.y();
+  img.pixels.resize(size_t(img.w) * size_t(img.h));
+
+  for (int j = 0; j < img.h; ++j)
+    {
+      const unsigned char* src = data.bytes_ptr() + size_t(j) * data.bytes_per_row();
+      pixel* dst = &img.pixels[size_t(j) * size_t(img.w)];
+
+      for (int i = 0; i < img.w; ++i)
+        {
+          switch (bpp)
+            {
+            case 32:
+              dst[i] = pixel(src[4*i]) | (pixel(src[4*i+1]) << 8)
+                | (pixel(src[4*i+2]) << 16) | (pixel(src[4*i+3]) << 24);
+              break;
+            case 24:
+              dst[i] = pixel(src[3*i]) | (pixel(src[3*i+1]) << 8)
+                | (pixel(src[3*i+2]) << 16) | 0xff000000u;
+              break;
+            case 8:
+              dst[i] = pixel(src[i]) * 0x010101u | 0xff000000u;
+              break;
+            case 1:
+              dst[i] = (src[i/8] & (0x80 >> (i%8))) ? 0xffffffffu : 0xff000000u;
+              break;
+            }
+        }
+    }
+
+  rep->beginOp(OpKind::IMAGE, rep->images.size());
+  rep->includeBounds(std::min(img.x, img.x + img.w * img.zx),
+                     std::min(img.y, img.y + img.h * img.zy),
+                     std::max(img.x, img.x + img.w * img.zx),
+                     std::max(img.y, img.y + img.h * img.zy));
+  rep->images.push_back(std::move(img));
+  rep->endOp(1);
+}
+
+void Gfx::SoftCanvas::drawBitmap(const media::bmap_data& data,
+                                 const vec3d& world_pos)
+{
+GVX_TRACE("Gfx::SoftCanvas::drawBitmap");
+
+  const vec4 c = rep->toClip(world_pos);
+  if (c.w <= MIN_W || data.width() == 0 || data.height() == 0)
+    return;
+
+  data.set_row_order(media::bmap_data::row_order::BOTTOM_FIRST);
+
+  const vec2d pos = rep->toWindow(c);
+
+  Image img;
+  img.w = int(data.width());
+  img.h = int(data.height());
+  // like glBitmap(), the bitmap origin snaps to a whole pixel
+  img.x = std::floor(pos.x());
+  img.y = std::floor(pos.y());
+  img.zx = 1.0;
+  img.zy = 1.0;
+  img.mask.resize(size_t(img.w) * size_t(img.h));
+
+  for (int j = 0; j < img.h; ++j)
+    {
+      const unsigned char* src = data.bytes_ptr() + size_t(j) * data.bytes_per_row();
+      unsigned char* dst = &img.mask[size_t(j) * size_t(img.w)];
+      for (int i = 0; i < img.w; ++i)
+        dst[i] = (src[i/8] & (0x80 >> (i%8))) ? 1 : 0;
+    }
+
+  rep->beginOp(OpKind::IMAGE, rep->images.size());
+  rep->includeBounds(img.x, img.y, img.x + img.w, img.y + img.h);
+  rep->images.push_back(std::move(img));
+  rep->endOp(1);
+}
+
+media::bmap_data Gfx::SoftCanvas::grabPixels(const recti& bounds)
+{
+GVX_TRACE("Gfx::SoftCanvas::grabPixels");
+
+  rep->rasterize();
+
+  media::bmap_data result(vec2st(bounds.size()), 24, 1);
+
+  for (int r = 0; r < bounds.height(); ++r)
+    {
+      const int y = bounds.bottom() + r;
+      unsigned char* dst = result.bytes_ptr() + size_t(r) * result.bytes_per_row();
+
+      for (int c = 0; c < bounds.width(); ++c)
+        {
+          const int x = bounds.left() + c;
+          pixel p = 0;
+          if (x >= 0 && x < rep->width && y >= 0 && y < rep->height)
+            p = rep->frame[size_t(y) * size_t(rep->width) + size_t(x)];
+          *dst++ = (unsigned char)(p & 0xff);
+          *dst++ = (unsigned char)((p >> 8) & 0xff);
+          *dst++ = (unsigned char)((p >> 16) & 0xff);
+        }
+    }
+
+  result.specify_row_order(media::bmap_data::row_order::BOTTOM_FIRST);
+
+  return result;
+}
+
+void Gfx::SoftCanvas::clearColorBuffer()
+{
+GVX_TRACE("Gfx::SoftCanvas::clearColorBuffer");
+  rep->addClear(recti::lbwh(0, 0, rep->width, rep->height));
+}
+
+void Gfx::SoftCanvas::clearColorBuffer(const recti& screen_rect)
+{
+GVX_TRACE("Gfx::SoftCanvas::clearColorBuffer(geom::recti)");
+  rep->addClear(screen_rect);
+}
+
+void Gfx::SoftCanvas::drawRect(const rectd& r)
+{
+GVX_TRACE("Gfx::SoftCanvas::drawRect");
+
+  const vec4 v[4] =
+    {
+      rep->toClip(vec3d(r.left(), r.bottom(), 0.0)),
+      rep->toClip(vec3d(r.right(), r.bottom(), 0.0)),
+      rep->toClip(vec3d(r.right(), r.top(), 0.0)),
+      rep->toClip(vec3d(r.left(), r.top(), 0.0))
+    };
+
+  rep->polygon(v, 4);
+}
+
+void Gfx::SoftCanvas::drawCircle(double inner_radius, double outer_radius,
+                                 bool fill, unsigned int slices,
+                                 unsigned int /*loops*/)
+{
+GVX_TRACE("Gfx::SoftCanvas::drawCircle");
+
+  if (slices < 3)
+    return;
+
+  // same vertex placement as gluDisk()
+  std::vector<vec4> outer(slices), inner(slices);
+  for (unsigned int i = 0; i < slices; ++i)
+    {
+      const double a = 2.0 * M_PI * i / slices;
+      const double s = std::sin(a);
+      const double c = std::cos(a);
+      outer[i] = rep->toClip(vec3d(outer_radius * s, outer_radius * c, 0.0));
+      inner[i] = rep->toClip(vec3d(inner_radius * s, inner_radius * c, 0.0));
+    }
+
+  if (fill)
+    {
+      // the two contours of an annulus are filled with the even-odd
+      // rule, which leaves the hole empty
+      rep->beginOp(OpKind::POLYGON, rep->edges.size());
+      rep->addContour(outer.data(), slices);
+      if (inner_radius > 0.0)
+        rep->addContour(inner.data(), slices);
+      rep->endOp(rep->edges.size() - rep->curOp.first);
+    }
+  else
+    {
+      rep->beginOp(OpKind::STAMPS, rep->stamps.size());
+      int counter = 0;
+      for (unsigned int i = 0; i < slices; ++i)
+        rep->line(outer[i], outer[(i+1) % slices], counter);
+      if (inner_radius > 0.0)
+        {
+          counter = 0;
+          for (unsigned int i = 0; i < slices; ++i)
+            rep->line(inner[i], inner[(i+1) % slices], counter);
+        }
+      rep->endOp(rep->stamps.size() - rep->curOp.first);
+    }
+}
+
+void Gfx::SoftCanvas::drawCylinder(double base_radius, double top_radius,
+                                   double height, int slices, int stacks,
+                                   bool fill)
+{
+GVX_TRACE("Gfx::SoftCanvas::drawCylinder");
+
+  if (slices < 3 || stacks < 1)
+    return;
+
+  // same vertex placement as gluCylinder(); there is no depth buffer,
+  // so faces are simply painted in order
+
+  auto pt = [&](int i, int j)
+    {
+      const double a = 2.0 * M_PI * (i % slices) / slices;
+      const double r = base_radius + (top_radius - base_radius) * j / stacks;
+      return vec3d(r * std::sin(a), r * std::cos(a), height * j / stacks);
+    };
+
+  Gfx::AttribSaver saver(*this);
+  setPolygonFill(true);
+
+  for (int j = 0; j < stacks; ++j)
+    {
+      if (fill)
+        {
+          beginQuadStrip();
+          for (int i = 0; i <= slices; ++i)
+            {
+              vertex3(pt(i, j));
+              vertex3(pt(i, j+1));
+            }
+          end();
+        }
+      else
+        {
+          beginLineLoop();
+          for (int i = 0; i < slices; ++i)
+            vertex3(pt(i, j));
+          end();
+
+          beginLines();
+          for (int i = 0; i < slices; ++i)
+            {
+              vertex3(pt(i, j));
+              vertex3(pt(i, j+1));
+            }
+          end();
+        }
+    }
+
+  if (!fill)
+    {
+      beginLineLoop();
+      for (int i = 0; i < slices; ++i)
+        vertex3(pt(i, stacks));
+      end();
+    }
+}
+
+void Gfx::SoftCanvas::drawSphere(double radius, int slices, int stacks,
+                                 bool fill)
+{
+GVX_TRACE("Gfx::SoftCanvas::drawSphere");
+
+  if (slices < 3 || stacks < 2)
+    return;
+
+  // same vertex placement as gluSphere(), from the +z pole down
+
+  auto pt = [&](int i, int j)
+    {
+      const double theta = 2.0 * M_PI * (i % slices) / slices;
+      const double rho = M_PI * j / stacks;
+      return vec3d(radius * std::sin(rho) * -std::sin(theta),
+                   radius * std::sin(rho) * std::cos(theta),
+                   radius * std::cos(rho));
+    };
+
+  Gfx::AttribSaver saver(*this);
+  setPolygonFill(true);
+
+  if (fill)
+    {
+      for (int j = 0; j < stacks; ++j)
+        {
+          beginQuadStrip();
+          for (int i = 0; i <= slices; ++i)
+            {
+              vertex3(pt(i, j));
+              vertex3(pt(i, j+1));
+            }
+          end();
+        }
+    }
+  else
+    {
+      for (int j = 1; j < stacks; ++j)
+        {
+          beginLineLoop();
+          for (int i = 0; i < slices; ++i)
+            vertex3(pt(i, j));
+          end();
+        }
+
+      for (int i = 0; i < slices; ++i)
+        {
+          beginLineStrip();
+          for (int j = 0; j <= stacks; ++j)
+            vertex3(pt(i, j));
+          end();
+        }
+    }
+}
+
+void Gfx::SoftCanvas::beginPoints(const char* /*comment*/)
+{ GVX_TRACE("Gfx::SoftCanvas::beginPoints"); rep->beginPrimitive(VertexStyle::POINTS); }
+
+void Gfx::SoftCanvas::beginLines(const char* /*comment*/)
+{ GVX_TRACE("Gfx::SoftCanvas::beginLines"); rep->beginPrimitive(VertexStyle::LINES); }
+
+void Gfx::SoftCanvas::beginLineStrip(const char* /*comment*/)
+{ GVX_TRACE("Gfx::SoftCanvas::beginLineStrip"); rep->beginPrimitive(VertexStyle::LINE_STRIP); }
+
+void Gfx::SoftCanvas::beginLineLoop(const char* /*comment*/)
+{ GVX_TRACE("Gfx::SoftCanvas::beginLineLoop"); rep->beginPrimitive(VertexStyle::LINE_LOOP); }
+
+void Gfx::SoftCanvas::beginTriangles(const char* /*comment*/)
+{ GVX_TRACE("Gfx::SoftCanvas::beginTriangles"); rep->beginPrimitive(VertexStyle::TRIANGLES); }
+
+void Gfx::SoftCanvas::beginTriangleStrip(const char* /*comment*/)
+{ GVX_TRACE("Gfx::SoftCanvas::beginTriangleStrip"); rep->beginPrimitive(VertexStyle::TRIANGLE_STRIP); }
+
+void Gfx::SoftCanvas::beginTriangleFan(const char* /*comment*/)
+{ GVX_TRACE("Gfx::SoftCanvas::beginTriangleFan"); rep->beginPrimitive(VertexStyle::TRIANGLE_FAN); }
+
+void Gfx::SoftCanvas::beginQuads(const char* /*comment*/)
+{ GVX_TRACE("Gfx::SoftCanvas::beginQuads"); rep->beginPrimitive(VertexStyle::QUADS); }
+
+void Gfx::SoftCanvas::beginQuadStrip(const char* /*comment*/)
+{ GVX_TRACE("Gfx::SoftCanvas::beginQuadStrip"); rep->beginPrimitive(VertexStyle::QUAD_STRIP); }
+
+void Gfx::SoftCanvas::beginPolygon(const char* /*comment*/)
+{ GVX_TRACE("Gfx::SoftCanvas::beginPolygon"); rep->beginPrimitive(VertexStyle::POLYGON); }
+
+void Gfx::SoftCanvas::vertex2(const vec2d& v)
+{
+GVX_TRACE("Gfx::SoftCanvas::vertex2");
+  vertex3(vec3d(v.x(), v.y(), 0.0));
+}
+
+void Gfx::SoftCanvas::vertex3(const vec3d& v)
+{
+GVX_TRACE("Gfx::SoftCanvas::vertex3");
+
+  if (!rep->inPrimitive)
+    throw rutz::error("SoftCanvas: called vertex() outside graphics "
+                      "primitive", SRC_POS);
+
+  rep->verts.push_back(rep->toClip(v));
+}
+
+void Gfx::SoftCanvas::end()
+{
+GVX_TRACE("Gfx::SoftCanvas::end");
+
+  if (!rep->inPrimitive)
+    throw rutz::error("SoftCanvas: called end() outside graphics "
+                      "primitive", SRC_POS);
+
+  rep->inPrimitive = false;
+  rep->assemble();
+}
+
+void Gfx::SoftCanvas::drawArrays(VertexStyle s, const vec3d* pts,
+                                 const vec3d* /*normals*/, size_t n)
+{
+GVX_TRACE("Gfx::SoftCanvas::drawArrays");
+
+  rep->beginPrimitive(s);
+  rep->verts.reserve(rep->verts.size() + n);
+  for (size_t i = 0; i < n; ++i)
+    rep->verts.push_back(rep->toClip(pts[i]));
+  rep->inPrimitive = false;
+  rep->assemble();
+}
+
+void Gfx::SoftCanvas::drawRasterText(const rutz::fstring& text,
+                                     const GxRasterFont& font)
+{
+GVX_TRACE("Gfx::SoftCanvas::drawRasterText");
+
+  // We have no access to the X font's glyph bitmaps, so draw the
+  // vector font's strokes instead, in window coordinates, scaled so
+  // that one line of text is rasterHeight() pixels tall.
+
+  const vec4 c = rep->toClip(vec3d::zeros());
+  if (c.w <= MIN_W)
+    return;
+
+  const vec2d pos = rep->toWindow(c);
+
+  GxVectorFont vfont;
+
+  const double s = font.rasterHeight() / vfont.vectorHeight();
+
+  const recti vp = rep->current().viewport;
+
+  Gfx::AttribSaver asaver(*this);
+  Gfx::MatrixSaver msaver(*this);
+
+  const txform saved_projection = rep->projection;
+
+  try
+    {
+      // identity projection + a modelview that maps window
+      // coordinates into normalized device coordinates
+      rep->projection = txform::identity();
+      loadMatrix(txform::identity());
+      translate(vec3d(-1.0, -1.0, 0.0));
+      scale(vec3d(2.0 / vp.width(), 2.0 / vp.height(), 1.0));
+      translate(vec3d(std::floor(pos.x()) - vp.left(),
+                      std::floor(pos.y()) - vp.bottom(), 0.0));
+      scale(vec3d(s, s, 1.0));
+
+      vfont.drawStrokes(text.c_str(), *this);
+    }
+  catch (...)
+    {
+      rep->projection = saved_projection;
+      rep->isProjModelValid = false;
+      throw;
+    }
+
+  rep->projection = saved_projection;
+  rep->isProjModelValid = false;
+}
+
+void Gfx::SoftCanvas::drawVectorText(const rutz::fstring& text,
+                                     const GxVectorFont& font)
+{
+GVX_TRACE("Gfx::SoftCanvas::drawVectorText");
+  font.drawStrokes(text.c_str(), *this);
+}
+
+void Gfx::SoftCanvas::flushOutput()
+{
+GVX_TRACE("Gfx::SoftCanvas::flushOutput");
+  rep->rasterize();
+}
+
+void Gfx::SoftCanvas::finishDrawing()
+{
+GVX_TRACE("Gfx::SoftCanvas::finishDrawing");
+  rep->rasterize();
+}
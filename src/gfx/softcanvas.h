@@ -0,0 +1,218 @@
+/** @file gfx/softcanvas.h Gfx::Canvas subclass that rasterizes on the
+    CPU into an in-memory RGBA frame buffer */
+
+///////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026-2026 Rob Peters
+// Rob Peters <https://github.com/rjpcal/>
+//
+// created: Mon Oct 19 13:40:52 2026
+//
+// --------------------------------------------------------------------
+//
+// This file is part of GroovX.
+//   [https://github.com/rjpcal/groovx]
+//
+// GroovX is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// GroovX is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GroovX; if not, write to the Free Software Foundation,
+// Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef GROOVX_GFX_SOFTCANVAS_H_UTC20261019134052_DEFINED
+#define GROOVX_GFX_SOFTCANVAS_H_UTC20261019134052_DEFINED
+
+#include "gfx/canvas.h"
+
+namespace Gfx
+{
+  class SoftCanvas;
+}
+
+///////////////////////////////////////////////////////////////////////
+/**
+ *
+ * Gfx::SoftCanvas implements Gfx::Canvas entirely in software,
+ * rendering into a width x height RGBA frame buffer held in
+ * memory. It needs no GL context or display, and its output depends
+ * only on the sequence of drawing calls, so it is bit-exact across
+ * machines; grabPixels() returns the same 24-bit bottom-first
+ * media::bmap_data layout as GLCanvas.
+ *
+ * Rasterization follows the OpenGL rules closely (pixel-center
+ * sampling for polygons, one fragment per major-axis step for lines,
+ * square points, glPixelZoom-style image zoom), but there is no depth
+ * buffer or lighting, and raster-font text is drawn with the vector
+ * font's strokes scaled to the raster font's pixel height.
+ *
+ * Drawing calls are transformed to screen space immediately, but the
+ * pixel work is deferred until the image is needed (grabPixels(),
+ * flushOutput(), finishDrawing()). At that point the frame is split
+ * into horizontal bands that can be filled by several threads; since
+ * each band replays the same primitives in the same order, the
+ * result doesn't depend on the number of threads.
+ *
+ **/
+///////////////////////////////////////////////////////////////////////
+
+class Gfx::SoftCanvas : public Gfx::Canvas
+{
+public:
+  /// Construct with a frame buffer of the given size in pixels.
+  SoftCanvas(int width, int height);
+
+  virtual ~SoftCanvas() noexcept;
+
+  /// Get the width of the frame buffer in pixels.
+  int width() const;
+
+  /// Get the height of the frame buffer in pixels.
+  int height() const;
+
+  /// Set the number of threads used to rasterize (default is 1).
+  void setNumThreads(unsigned int n);
+
+  /// Get the number of threads used to rasterize.
+  unsigned int getNumThreads() const;
+
+  virtual geom::vec3<double> screenFromWorld3(const geom::vec3<double>& world_pos) const override;
+  virtual geom::vec3<double> worldFromScreen3(const geom::vec3<double>& screen_pos) const override;
+
+  virtual geom::rect<int> getScreenViewport() const override;
+
+
+  virtual bool isRgba() const override;
+  virtual bool isColorIndex() const override;
+  virtual bool isDoubleBuffered() const override;
+
+  virtual unsigned int bitsPerPixel() const override;
+
+  virtual void throwIfError(const char* where,
+                            const rutz::file_pos& pos) const override;
+
+
+  virtual void pushAttribs(const char* comment="") override;
+  virtual void popAttribs() override;
+
+  virtual void drawOnFrontBuffer() override;
+  virtual void drawOnBackBuffer() override;
+
+  virtual void setColor(const Gfx::RgbaColor& rgba) override;
+  virtual void setClearColor(const Gfx::RgbaColor& rgba) override;
+
+  virtual void setColorIndex(unsigned int index) override;
+  virtual void setClearColorIndex(unsigned int index) override;
+
+  virtual void swapForeBack() override;
+
+  virtual void setPolygonFill(bool on) override;
+  virtual void setPointSize(double size) override;
+  virtual void setLineWidth(double width) override;
+  virtual void setLineStipple(unsigned short bit_pattern) override;
+
+  /** Turns on alpha blending (there is no coverage-based
+      antialiasing, so as to keep the output exact). */
+  virtual void enableAntialiasing() override;
+
+  virtual void setScissor(const geom::rect<int>& screen_rect) override;
+  virtual void disableScissor() override;
+
+
+
+  virtual void viewport(int x, int y, int w, int h) override;
+
+  virtual void orthographic(const geom::rect<double>& bounds,
+                            double zNear, double zFar) override;
+
+  virtual void perspective(double fovy, double aspect,
+                           double zNear, double zFar) override;
+
+
+  virtual void pushMatrix(const char* comment="") override;
+  virtual void popMatrix() override;
+
+  virtual void translate(const geom::vec3<double>& v) override;
+  virtual void scale(const geom::vec3<double>& v) override;
+  virtual void rotate(const geom::vec3<double>& v, double degrees) override;
+
+  virtual void transform(const geom::txform& tx) override;
+  virtual void loadMatrix(const geom::txform& tx) override;
+
+
+
+  virtual void drawPixels(const media::bmap_data& data,
+                          const geom::vec3<double>& world_pos,
+                          const geom::vec2<double>& zoom) override;
+
+  virtual void drawBitmap(const media::bmap_data& data,
+                          const geom::vec3<double>& world_pos) override;
+
+  virtual media::bmap_data grabPixels(const geom::rect<int>& bounds) override;
+
+  virtual void clearColorBuffer() override;
+  virtual void clearColorBuffer(const geom::rect<int>& screen_rect) override;
+
+  virtual void drawRect(const geom::rect<double>& rect) override;
+
+  virtual void drawCircle(double inner_radius, double outer_radius, bool fill,
+                          unsigned int slices, unsigned int loops) override;
+
+  virtual void drawCylinder(double base_radius, double top_radius,
+                            double height, int slices, int stacks,
+                            bool fill) override;
+
+  virtual void drawSphere(double radius, int slices, int stacks,
+                          bool fill) override;
+
+  virtual void beginPoints(const char* comment="") override;
+  virtual void beginLines(const char* comment="") override;
+  virtual void beginLineStrip(const char* comment="") override;
+  virtual void beginLineLoop(const char* comment="") override;
+  virtual void beginTriangles(const char* comment="") override;
+  virtual void beginTriangleStrip(const char* comment="") override;
+  virtual void beginTriangleFan(const char* comment="") override;
+  virtual void beginQuads(const char* comment="") override;
+  virtual void beginQuadStrip(const char* comment="") override;
+  virtual void beginPolygon(const char* comment="") override;
+
+  virtual void vertex2(const geom::vec2<double>& v) override;
+  virtual void vertex3(const geom::vec3<double>& v) override;
+
+  virtual void end() override;
+
+  virtual void drawArrays(VertexStyle s,
+                          const geom::vec3<double>* pts,
+                          const geom::vec3<double>* normals,
+                          size_t n) override;
+
+  virtual void drawRasterText(const rutz::fstring& text,
+                              const GxRasterFont& font) override;
+  virtual void drawVectorText(const rutz::fstring& text,
+                              const GxVectorFont& font) override;
+
+  /// Rasterize all pending drawing into the frame buffer.
+  virtual void flushOutput() override;
+
+  /// Rasterize all pending drawing into the frame buffer.
+  virtual void finishDrawing() override;
+
+  class Impl;
+
+private:
+  SoftCanvas(const SoftCanvas&);
+  SoftCanvas& operator=(const SoftCanvas&);
+
+  Impl* rep;
+};
+
+#endif // !GROOVX_GFX_SOFTCANVAS_H_UTC20261019134052_DEFINED
@@ -0,0 +1,104 @@
+/** @file gfx/textcache.h bounded per-string cache for text layout and
+    metrics */
+
+///////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026-2026 Rob Peters
+// Rob Peters <https://github.com/rjpcal/>
+//
+// created: Mon Oct 19 15:02:18 2026
+//
+// --------------------------------------------------------------------
+//
+// This file is part of GroovX.
+//   [https://github.com/rjpcal/groovx]
+//
+// GroovX is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// GroovX is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GroovX; if not, write to the Free Software Foundation,
+// Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef GROOVX_GFX_TEXTCACHE_H_UTC20261019150218_DEFINED
+#define GROOVX_GFX_TEXTCACHE_H_UTC20261019150218_DEFINED
+
+#include "rutz/fstring.h"
+#include "rutz/istring.h"
+
+#include <cstddef>
+
+namespace Gfx
+{
+  template <class T> class TextCache;
+}
+
+/// Gfx::TextCache maps strings to some computed value (bbox, layout).
+/** Fonts use this to avoid recomputing metrics and layouts for the
+    same strings frame after frame. The cache holds at most maxsize
+    strings; when it fills up, it is simply emptied, which is cheap
+    and good enough for the handful of strings a typical screen
+    shows. */
+template <class T>
+class Gfx::TextCache
+{
+public:
+  explicit TextCache(size_t maxsize = 256) :
+    itsMap(), itsMaxSize(maxsize), itsHits(0), itsMisses(0)
+  {}
+
+  /// Return the entry for \a text, or null if there is none.
+  const T* find(const char* text) const
+  {
+    typename MapType::const_iterator itr = itsMap.find(rutz::fstring(text));
+    if (itr == itsMap.end())
+      {
+        ++itsMisses;
+        return nullptr;
+      }
+    ++itsHits;
+    return &(itr->second);
+  }
+
+  /// Store \a value as the entry for \a text, and return the stored copy.
+  const T& insert(const char* text, const T& value)
+  {
+    if (itsMap.size() >= itsMaxSize)
+      itsMap.clear();
+    T& entry = itsMap[rutz::fstring(text)];
+    entry = value;
+    return entry;
+  }
+
+  /// Forget all entries.
+  void clear() { itsMap.clear(); }
+
+  /// Number of strings currently cached.
+  size_t size() const { return itsMap.size(); }
+
+  /// Number of successful lookups.
+  size_t hits() const { return itsHits; }
+
+  /// Number of failed lookups.
+  size_t misses() const { return itsMisses; }
+
+private:
+  // displayed text is arbitrary, so it's hashed rather than interned
+  typedef rutz::fstring_hash_map<T> MapType;
+
+  MapType itsMap;
+  size_t itsMaxSize;
+  mutable size_t itsHits;
+  mutable size_t itsMisses;
+};
+
+#endif // !GROOVX_GFX_TEXTCACHE_H_UTC20261019150218_DEFINED
@@ -40,6 +40,7 @@
 
 #include "tcl-gfx/tclpkg-canvas.h"               // for Canvas_Init(), Glcanvas_Init(),
 #include "tcl-gfx/tclpkg-gx.h"                   // for Gx_Init(), Gxnode_Init(), Gxseparator_Init(), Gxcolor_Init(), Gxdrawstyle_Init(), Gxline_Init(), Gxcylinder_Init(), Gxsphere_Init(), Gxlighting_Init(), Gxmaterial_Init(), Gxpointset_Init(), Gxscaler_Init(), Gxemptynode_Init(), Gxtransform_Init(), Gxshapekit_Init(), Gxpixmap_Init(), Gxtext_Init(), Gxfixedscalecamera_Init(), Gxpsyphycamera_Init(), Gxperspectivecamera_Init(), Gxdisk_Init(),
+#include "tcl-gfx/tclpkg-offscreen.h"            // for Offscreen_Init(),
 #include "tcl-gfx/tclpkg-toglet.h"               // for Toglet_Init(),
 #include "tcl-io/tclpkg-io.h"                    // for Io_Init(), Outputfile_Init(),
 #include "tcl/tclpkg-dlist.h"                    // for Dlist_Init(),
@@ -128,6 +129,7 @@ static tcl::package_info GROOVX_PKGS[] =
     { "Nulltrialevent",      Nulltrialevent_Init,      "4.0", false },
     { "Obj",                 Obj_Init,                 "4.0", false },
     { "Objectdb",            Objectdb_Init,            "4.0", false },
+    { "Offscreen",           Offscreen_Init,           "4.0", false },
     { "Outputfile",          Outputfile_Init,          "4.0", false },
     { "Prof",                Prof_Init,                "4.0", false },
     { "Responsehandler",     Responsehandler_Init,     "4.0", false },
@@ -282,6 +282,10 @@ namespace
                           SRC_POS);
       }
 
+    // the result is kept by the object being read, so it shouldn't
+    // come from (and pin) the arena in read_root()
+    rutz::string_arena::suspend heap_only;
+
     fstring new_string;
     new_string.readsome(ist, static_cast<unsigned int>(len));
 
@@ -363,6 +367,9 @@ namespace
   {
   GVX_TRACE("asw_reader::read_root");
 
+    // all the tokens and attribute values that we read are temporary
+    rutz::string_arena arena;
+
     m_objects.clear();
 
     bool got_root = false;
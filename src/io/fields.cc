@@ -41,7 +41,7 @@
 #include "rutz/iter.h"
 #include "rutz/sfmt.h"
 
-#include <map>
+#include <vector>
 
 #include "rutz/trace.h"
 #include "rutz/debug.h"
@@ -56,14 +56,57 @@ void FieldAux::throwNotAllowed(const char* what,
                                "for that field", what), pos);
 }
 
+void FieldAux::throwOutOfRange(double val, const rutz::file_pos& pos)
+{
+  throw rutz::error(rutz::sfmt("value %g is out of range "
+                               "for that field", val), pos);
+}
+
+void FieldAux::throwNotIntegral(double val, const rutz::file_pos& pos)
+{
+  throw rutz::error(rutz::sfmt("value %g is not an integer, "
+                               "as that field requires", val), pos);
+}
+
 FieldImpl::~FieldImpl() {}
 
+bool FieldImpl::getNumeric(const FieldContainer*, double&) const
+{
+  return false;
+}
+
+bool FieldImpl::setNumeric(FieldContainer*, double) const
+{
+  return false;
+}
+
+bool FieldImpl::checkNumeric(double) const
+{
+  return false;
+}
+
 ///////////////////////////////////////////////////////////////////////
 //
 // FieldMap
 //
 ///////////////////////////////////////////////////////////////////////
 
+namespace
+{
+  // FNV-1a, with the basis perturbed by a seed so that we can search
+  // for a seed that gives no collisions.
+  unsigned int hashName(const char* name, unsigned int seed)
+  {
+    unsigned int h = 2166136261u ^ (seed * 0x9e3779b9u);
+    for (const char* p = name; *p != '\0'; ++p)
+      {
+        h ^= static_cast<unsigned char>(*p);
+        h *= 16777619u;
+      }
+    return h ^ (h >> 15);
+  }
+}
+
 class FieldMap::Impl
 {
 private:
@@ -71,26 +114,91 @@ private:
   Impl& operator=(const Impl&);
 
 public:
-  typedef std::map<fstring, const Field*> MapType;
-  MapType nameMap;
   const Field* const ioBegin;
   const Field* const ioEnd;
 
   const FieldMap* parent;
 
+  /// Our own fields followed by the parent's, minus hidden names.
+  std::vector<const Field*> flat;
+
+  /// Perfect hash table: each slot is empty (0) or 1+index into flat.
+  std::vector<unsigned int> slots;
+  unsigned int seed;
+
   Impl(const Field* begin, const Field* end,
        const FieldMap* par) :
-    nameMap(),
     ioBegin(begin),
     ioEnd(end),
-    parent(par)
+    parent(par),
+    flat(),
+    slots(),
+    seed(0)
+  {
+    for (const Field* f = begin; f != end; ++f)
+      if (findFlat(f->name()) == nullptr)
+        flat.push_back(f);
+
+    if (parent != nullptr)
+      for (const Field* f : parent->rep->flat)
+        if (findFlat(f->name()) == nullptr)
+          flat.push_back(f);
+
+    buildTable();
+  }
+
+  // only used while building
+  const Field* findFlat(const fstring& name) const
+  {
+    for (const Field* f : flat)
+      if (f->name() == name)
+        return f;
+    return nullptr;
+  }
+
+  bool tryTable(size_t nslots, unsigned int s)
+  {
+    slots.assign(nslots, 0);
+    for (size_t i = 0; i < flat.size(); ++i)
+      {
+        unsigned int& slot =
+          slots[hashName(flat[i]->name().c_str(), s) & (nslots - 1)];
+        if (slot != 0)
+          return false;
+        slot = static_cast<unsigned int>(i + 1);
+      }
+    seed = s;
+    return true;
+  }
+
+  // Find a seed that places every name in its own slot; if that
+  // takes too many tries, double the table size and keep looking.
+  void buildTable()
   {
-    while (begin != end)
+    size_t nslots = 8;
+    while (nslots < 2 * flat.size())
+      nslots *= 2;
+
+    for (;;)
       {
-        nameMap.insert(MapType::value_type(begin->name(), begin));
-        ++begin;
+        for (unsigned int s = 0; s < 64; ++s)
+          if (tryTable(nslots, s))
+            return;
+        nslots *= 2;
       }
   }
+
+  const Field* find(const fstring& name) const noexcept
+  {
+    const unsigned int slot =
+      slots[hashName(name.c_str(), seed) & (slots.size() - 1)];
+
+    if (slot == 0)
+      return nullptr;
+
+    const Field* f = flat[slot - 1];
+    return (f->name() == name) ? f : nullptr;
+  }
 };
 
 void FieldMap::init(const Field* begin, const Field* end,
@@ -127,20 +235,32 @@ const FieldMap* FieldMap::parent() const noexcept
 
 const Field& FieldMap::field(const fstring& name) const
 {
-  Impl::MapType::const_iterator itr = rep->nameMap.find(name);
+  const Field* f = rep->find(name);
 
-  if (itr != rep->nameMap.end())
-    return *((*itr).second);
+  if (f == nullptr)
+    throw rutz::error(rutz::sfmt("no such field: '%s'", name.c_str()),
+                      SRC_POS);
 
-  if (hasParent())
-    {
-      return parent()->field(name);
-    }
-  else
-    {
-      throw rutz::error(rutz::sfmt("no such field: '%s'", name.c_str()),
-                        SRC_POS);
-    }
+  return *f;
+}
+
+const Field* FieldMap::findField(const fstring& name) const noexcept
+{
+  return rep->find(name);
+}
+
+unsigned int FieldMap::numAllFields() const noexcept
+{
+  return static_cast<unsigned int>(rep->flat.size());
+}
+
+const Field& FieldMap::allFieldAt(unsigned int i) const
+{
+  if (i >= rep->flat.size())
+    throw rutz::error(rutz::sfmt("field index %u out of range", i),
+                      SRC_POS);
+
+  return *(rep->flat[i]);
 }
 
 FieldMap::Iterator FieldMap::ioFields() const
@@ -179,6 +299,83 @@ void FieldContainer::touch() const
     itsSignal->emit();
 }
 
+namespace
+{
+  // Successive objects are usually of the same class, so only look up
+  // the Field again when the FieldMap changes.
+  struct FieldFinder
+  {
+    const rutz::fstring& name;
+    const FieldMap* lastMap;
+    const Field* lastField;
+
+    FieldFinder(const rutz::fstring& n) :
+      name(n), lastMap(nullptr), lastField(nullptr) {}
+
+    const Field& get(const FieldContainer* obj)
+    {
+      if (&(obj->fields()) != lastMap)
+        {
+          lastMap = &(obj->fields());
+          lastField = &(lastMap->field(name));
+        }
+      return *lastField;
+    }
+  };
+
+  [[noreturn]] void throwNotNumeric(const rutz::fstring& name,
+                                    const rutz::file_pos& pos)
+  {
+    throw rutz::error(rutz::sfmt("field '%s' is not numeric",
+                                 name.c_str()), pos);
+  }
+}
+
+void FieldContainer::getNumericField(const rutz::fstring& name,
+                                     const FieldContainer* const* objs,
+                                     size_t n, double* result)
+{
+GVX_TRACE("FieldContainer::getNumericField");
+
+  FieldFinder finder(name);
+
+  for (size_t i = 0; i < n; ++i)
+    {
+      if (!finder.get(objs[i]).getNumeric(objs[i], result[i]))
+        throwNotNumeric(name, SRC_POS);
+    }
+}
+
+void FieldContainer::setNumericField(const rutz::fstring& name,
+                                     FieldContainer* const* objs,
+                                     size_t n, const double* vals,
+                                     size_t nvals)
+{
+GVX_TRACE("FieldContainer::setNumericField");
+
+  if (nvals != 1 && nvals != n)
+    throw rutz::error(rutz::sfmt("expected 1 or %u values, got %u",
+                                 unsigned(n), unsigned(nvals)), SRC_POS);
+
+  FieldFinder finder(name);
+
+  // Check every value before setting any, so that a bad value doesn't
+  // leave some of the objects changed and the rest not.
+  for (size_t i = 0; i < n; ++i)
+    {
+      if (!finder.get(objs[i]).checkNumeric(vals[nvals == 1 ? 0 : i]))
+        throwNotNumeric(name, SRC_POS);
+    }
+
+  for (size_t i = 0; i < n; ++i)
+    {
+      if (!finder.get(objs[i]).setNumeric(objs[i], vals[nvals == 1 ? 0 : i]))
+        throwNotNumeric(name, SRC_POS);
+
+      objs[i]->touch(); // emit a signal saying that the object has changed
+    }
+}
+
 void FieldContainer::readFieldsFrom(io::reader& reader,
                                     const FieldMap& fields)
 {
@@ -44,6 +44,7 @@
 #include "rutz/stderror.h"
 #include "rutz/value.h"
 
+#include <cmath>
 #include <limits>
 #include <memory>
 #include <type_traits>
@@ -76,6 +77,106 @@ namespace FieldAux
   inline C& cast(F& p);
 
   [[noreturn]] void throwNotAllowed(const char* what, const rutz::file_pos& pos);
+
+  [[noreturn]] void throwOutOfRange(double val, const rutz::file_pos& pos);
+
+  [[noreturn]] void throwNotIntegral(double val, const rutz::file_pos& pos);
+
+  /// The arithmetic type held by a field member of type M, or void.
+  /** Besides plain arithmetic types, this recognizes wrappers that
+      have an arithmetic value_type and convert to value_type&. */
+  template <class M, class = void>
+  struct NumericType
+  {
+    typedef typename std::conditional<std::is_arithmetic<M>::value,
+                                      M, void>::type type;
+  };
+
+  template <class M>
+  struct NumericType<M, typename std::enable_if<
+    std::is_arithmetic<typename M::value_type>::value &&
+    std::is_convertible<M&, typename M::value_type&>::value>::type>
+  {
+    typedef typename M::value_type type;
+  };
+
+  /// Whether fields of type M can be moved to/from a double directly.
+  template <class M>
+  struct IsNumeric :
+    public std::is_arithmetic<typename NumericType<std::decay_t<M> >::type>
+  {};
+
+  /// Convert a double to a numeric value.
+  /** Integral values must be whole numbers in N's range; bool values
+      are true for any non-zero input. */
+  template <class N>
+  inline N numericCast(double x, std::true_type /* is_integral */)
+  {
+    // N's range is [min, 2^digits), and both ends are exact in a
+    // double, whereas double(max) may round up out of range.
+    if (!(x >= double(std::numeric_limits<N>::min()) &&
+          x < std::ldexp(1.0, std::numeric_limits<N>::digits)))
+      throwOutOfRange(x, SRC_POS);
+    if (x != std::floor(x))
+      throwNotIntegral(x, SRC_POS);
+    return static_cast<N>(x);
+  }
+
+  template <>
+  inline bool numericCast<bool>(double x, std::true_type /* is_integral */)
+  { return x != 0.0; }
+
+  template <class N>
+  inline N numericCast(double x, std::false_type /* is_integral */)
+  { return static_cast<N>(x); }
+
+  template <class N, class M>
+  inline bool toDouble(const M& m, double& result, std::true_type)
+  { result = static_cast<double>(static_cast<const N&>(m)); return true; }
+
+  template <class N, class M>
+  inline bool toDouble(const M&, double&, std::false_type)
+  { return false; }
+
+  template <class N, class M>
+  inline bool fromDouble(double x, M& m, std::true_type)
+  { static_cast<N&>(m) = numericCast<N>(x, std::is_integral<N>()); return true; }
+
+  template <class N, class M>
+  inline bool fromDouble(double, M&, std::false_type)
+  { return false; }
+
+  template <class N>
+  inline bool checkDouble(double x, std::true_type)
+  { numericCast<N>(x, std::is_integral<N>()); return true; }
+
+  template <class N>
+  inline bool checkDouble(double, std::false_type)
+  { return false; }
+
+  /// Get a numeric field value as a double; false if not numeric.
+  template <class M>
+  inline bool toDouble(const M& m, double& result)
+  {
+    typedef typename NumericType<M>::type N;
+    return toDouble<N>(m, result, IsNumeric<M>());
+  }
+
+  /// Set a numeric field value from a double; false if not numeric.
+  template <class M>
+  inline bool fromDouble(double x, M& m)
+  {
+    typedef typename NumericType<M>::type N;
+    return fromDouble<N>(x, m, IsNumeric<M>());
+  }
+
+  /// Check that fromDouble() would accept x for an M; false if not numeric.
+  template <class M>
+  inline bool checkDouble(double x)
+  {
+    typedef typename NumericType<M>::type N;
+    return checkDouble<N>(x, IsNumeric<M>());
+  }
 }
 
 ///////////////////////////////////////////////////////////////////////
@@ -101,6 +202,19 @@ public:
   virtual void writeValueTo(const FieldContainer* obj,
                             io::writer& writer,
                             const rutz::fstring& name) const = 0;
+
+  /// Get the given object's field as a double, without string conversion.
+  /** Returns false if the field is not numeric. Default returns false. */
+  virtual bool getNumeric(const FieldContainer* obj, double& result) const;
+
+  /// Set the given object's field from a double, without string conversion.
+  /** Returns false if the field is not numeric. Default returns false. */
+  virtual bool setNumeric(FieldContainer* obj, double val) const;
+
+  /// Check whether setNumeric() would accept \a val, without setting it.
+  /** Returns false if the field is not numeric, and throws if \a val
+      can't be converted to the field's type. Default returns false. */
+  virtual bool checkNumeric(double val) const;
 };
 
 namespace
@@ -198,6 +312,26 @@ public:
     writer.write_value(name.c_str(), const_dereference(cobj, itsDataMember));
   }
 
+  virtual bool getNumeric(const FieldContainer* obj,
+                          double& result) const override
+  {
+    const C& cobj = FieldAux::cast<const C>(*obj);
+
+    return FieldAux::toDouble(const_dereference(cobj, itsDataMember), result);
+  }
+
+  virtual bool setNumeric(FieldContainer* obj, double val) const override
+  {
+    C& cobj = FieldAux::cast<C>(*obj);
+
+    return FieldAux::fromDouble(val, dereference(cobj, itsDataMember));
+  }
+
+  virtual bool checkNumeric(double val) const override
+  {
+    return FieldAux::checkDouble<typename Deref<C,T>::Type>(val);
+  }
+
 private:
   DataMemberFieldImpl& operator=(const DataMemberFieldImpl&);
   DataMemberFieldImpl(const DataMemberFieldImpl&);
@@ -253,6 +387,31 @@ public:
     writer.write_value(name.c_str(), const_dereference(cobj, itsDataMember));
   }
 
+  virtual bool getNumeric(const FieldContainer* obj,
+                          double& result) const override
+  {
+    const C& cobj = FieldAux::cast<const C>(*obj);
+
+    return FieldAux::toDouble(const_dereference(cobj, itsDataMember), result);
+  }
+
+  virtual bool setNumeric(FieldContainer* obj, double val) const override
+  {
+    C& cobj = FieldAux::cast<C>(*obj);
+
+    ValType temp;
+    if (!FieldAux::fromDouble(val, temp))
+      return false;
+
+    dereference(cobj, itsDataMember) = this->limit(temp);
+    return true;
+  }
+
+  virtual bool checkNumeric(double val) const override
+  {
+    return FieldAux::checkDouble<ValType>(val);
+  }
+
 private:
   CheckedDataMemberFieldImpl(const CheckedDataMemberFieldImpl&);
   CheckedDataMemberFieldImpl& operator=(const CheckedDataMemberFieldImpl&);
@@ -340,6 +499,38 @@ public:
 
     writer.write_value(name.c_str(), (cobj.*itsGetter)());
   }
+
+  virtual bool getNumeric(const FieldContainer* obj,
+                          double& result) const override
+  {
+    if (!FieldAux::IsNumeric<T>::value) return false;
+    if (itsGetter == nullptr) FieldAux::throwNotAllowed("get", SRC_POS);
+
+    const C& cobj = FieldAux::cast<const C>(*obj);
+
+    return FieldAux::toDouble((cobj.*itsGetter)(), result);
+  }
+
+  virtual bool setNumeric(FieldContainer* obj, double val) const override
+  {
+    if (!FieldAux::IsNumeric<T>::value) return false;
+    if (itsSetter == nullptr) FieldAux::throwNotAllowed("set", SRC_POS);
+
+    C& cobj = FieldAux::cast<C>(*obj);
+
+    std::decay_t<T> temp;
+    FieldAux::fromDouble(val, temp);
+    (cobj.*itsSetter)(temp);
+    return true;
+  }
+
+  virtual bool checkNumeric(double val) const override
+  {
+    if (!FieldAux::IsNumeric<T>::value) return false;
+    if (itsSetter == nullptr) FieldAux::throwNotAllowed("set", SRC_POS);
+
+    return FieldAux::checkDouble<std::decay_t<T>>(val);
+  }
 };
 
 ///////////////////////////////////////////////////////////////////////
@@ -521,6 +712,24 @@ public:
   {
     itsFieldImpl->writeValueTo(obj, writer, itsName);
   }
+
+  /// Get this field for \a obj as a double; false if not numeric.
+  bool getNumeric(const FieldContainer* obj, double& result) const
+  {
+    return itsFieldImpl->getNumeric(obj, result);
+  }
+
+  /// Set this field for \a obj from a double; false if not numeric.
+  bool setNumeric(FieldContainer* obj, double val) const
+  {
+    return itsFieldImpl->setNumeric(obj, val);
+  }
+
+  /// Check whether setNumeric() would accept \a val; false if not numeric.
+  bool checkNumeric(double val) const
+  {
+    return itsFieldImpl->checkNumeric(val);
+  }
 };
 
 ///////////////////////////////////////////////////////////////////////
@@ -575,10 +784,25 @@ public:
   const FieldMap* parent() const noexcept;
 
   /// Look up the field associated with the given name.
-  /** Parent FieldMap objects will be searched recursively. An exception
+  /** Parent FieldMap objects are included in the search. An exception
       will be thrown if the named field is not found. */
   const Field& field(const rutz::fstring& name) const;
 
+  /// Like field(), but return null if the named field is not found.
+  /** Names are found with a single probe of a perfect hash table that
+      is built when the FieldMap is constructed, and which covers the
+      whole inheritance chain. */
+  const Field* findField(const rutz::fstring& name) const noexcept;
+
+  /// Get the number of fields, including those of parent FieldMap's.
+  unsigned int numAllFields() const noexcept;
+
+  /// Get field \a i from the flattened field table.
+  /** The table has this FieldMap's fields in their native order,
+      followed by the flattened table of the parent, minus any fields
+      hidden by a same-named field in a derived FieldMap. */
+  const Field& allFieldAt(unsigned int i) const;
+
   /// Iterator type
   typedef rutz::fwd_iter<const Field> Iterator;
 
@@ -629,6 +853,22 @@ public:
   /// Emit a signal saying that one of our values has changed.
   void touch() const;
 
+  /// Get the numeric field \a name of each of \a n objects into \a result.
+  /** Values are copied straight out of the objects, with no rutz::value
+      or string conversion. An exception is thrown if the field is not
+      found or is not numeric. */
+  static void getNumericField(const rutz::fstring& name,
+                              const FieldContainer* const* objs, size_t n,
+                              double* result);
+
+  /// Set the numeric field \a name of each of \a n objects from \a vals.
+  /** If \a nvals is 1, that value is given to every object; otherwise
+      \a nvals must equal \a n. Each object is touch()'ed after being
+      changed. Integral fields are rounded and range-checked. */
+  static void setNumericField(const rutz::fstring& name,
+                              FieldContainer* const* objs, size_t n,
+                              const double* vals, size_t nvals);
+
   /// Read all fields from the io::reader.
   void readFieldsFrom(io::reader& reader, const FieldMap& fields);
   /// Write all fields to the io::writer.
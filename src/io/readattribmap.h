@@ -36,6 +36,7 @@
 #include "io/io.h"
 
 #include "rutz/fstring.h"
+#include "rutz/istring.h"
 #include "rutz/sfmt.h"
 
 #include <algorithm>
@@ -63,7 +64,7 @@ namespace io
     };
 
   private:
-    typedef std::pair<rutz::fstring, attrib>  value_type;
+    typedef std::pair<rutz::istring, attrib>  value_type;
     typedef std::vector<value_type>           list_type;
 
     rutz::fstring   m_obj_tag;
@@ -114,8 +115,14 @@ void io::attrib_map::set_version_id(io::version_id id)
 inline
 io::attrib_map::attrib io::attrib_map::get(const rutz::fstring& attr_name)
 {
-  auto itr = std::find_if(m_attribs.begin(), m_attribs.end(),
-                          [&](auto x){ return x.first == attr_name; });
+  // attribute names are interned as they are read, so each candidate
+  // is checked with a pointer comparison rather than a strcmp
+  rutz::istring key;
+  auto itr = m_attribs.end();
+  if (rutz::istring::find(rutz::char_range(attr_name.c_str(),
+                                           attr_name.length()), key))
+    itr = std::find_if(m_attribs.begin(), m_attribs.end(),
+                       [&](const value_type& x){ return x.first == key; });
   if (itr != m_attribs.end())
     {
       attrib result = (*itr).second;
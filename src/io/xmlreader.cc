@@ -42,14 +42,15 @@
 #include "rutz/demangle.h"
 #include "rutz/error.h"
 #include "rutz/fstring.h"
+#include "rutz/istring.h"
 #include "rutz/sfmt.h"
 #include "rutz/value.h"
 
+#include <algorithm>         // for sort() in group_element::trace()
 #include <cstdio>            // for sscanf()
 #include <cstring>           // for strcmp()
 #include <iostream>          // for cout in xml_debug()
 #include <istream>           // for tree_builder constructor
-#include <map>               // for group_element
 #include <memory>            // for shared_ptr
 #include <ostream>           // for xml_element::trace()
 #include <string>            // for string_element implementation
@@ -315,8 +316,17 @@ namespace
     {
       for (int i = 0; i < depth; ++i) os << "  ";
       os << name << "(object:" << m_type << "):\n";
+
+      std::vector<const map_type::value_type*> elems;
       for (const auto& elem: m_elems)
-        elem.second->trace(os, depth+1, elem.first.c_str());
+        elems.push_back(&elem);
+      std::sort(elems.begin(), elems.end(),
+                [](const map_type::value_type* a,
+                   const map_type::value_type* b)
+                { return a->first < b->first; });
+
+      for (const map_type::value_type* elem: elems)
+        elem->second->trace(os, depth+1, elem->first.c_str());
     }
 
     virtual io::version_id input_version_id() override
@@ -328,28 +338,28 @@ namespace
 
     virtual int read_int(const fstring& name) override
     {
-      el_ptr el = m_elems[name];
+      el_ptr el = find_elem(name);
       int_element& ilp = element_cast<int_element>(el.get(), name, SRC_POS);
       return ilp.m_value;
     }
 
     virtual bool read_bool(const fstring& name) override
     {
-      el_ptr el = m_elems[name];
+      el_ptr el = find_elem(name);
       bool_element& blp = element_cast<bool_element>(el.get(), name, SRC_POS);
       return blp.m_value;
     }
 
     virtual double read_double(const fstring& name) override
     {
-      el_ptr el = m_elems[name];
+      el_ptr el = find_elem(name);
       double_element& dlp = element_cast<double_element>(el.get(), name, SRC_POS);
       return dlp.m_value;
     }
 
     virtual void read_value_obj(const fstring& name, rutz::value& v) override
     {
-      el_ptr el = m_elems[name];
+      el_ptr el = find_elem(name);
       value_element& vlp = element_cast<value_element>(el.get(), name, SRC_POS);
       v.set_string(vlp.m_value);
     }
@@ -369,7 +379,7 @@ namespace
     virtual void read_owned_object(const fstring& name,
                                  ref<io::serializable> obj) override
     {
-      el_ptr el = m_elems[name];
+      el_ptr el = find_elem(name);
       group_element& glp = element_cast<group_element>(el.get(), name, SRC_POS);
       glp.inflate(*obj);
     }
@@ -377,7 +387,7 @@ namespace
     virtual void read_base_class(const fstring& name,
                                  ref<io::serializable> base_part) override
     {
-      el_ptr el = m_elems[name];
+      el_ptr el = find_elem(name);
       group_element& glp = element_cast<group_element>(el.get(), name, SRC_POS);
       glp.inflate(*base_part);
     }
@@ -395,14 +405,31 @@ namespace
   protected:
     virtual fstring read_string_impl(const fstring& name) override
     {
-      el_ptr el = m_elems[name];
+      el_ptr el = find_elem(name);
       string_element& slp = element_cast<string_element>(el.get(), name, SRC_POS);
+      // the result is kept by the object being read, so it shouldn't
+      // come from (and pin) the arena in load_gvx()
+      rutz::string_arena::suspend heap_only;
       return fstring(slp.m_value.c_str());
     }
 
+    // Look up a child element; returns null if there is none. Element
+    // names are interned as they are parsed, so a name that was never
+    // interned can't be a child.
+    el_ptr find_elem(const fstring& name) const
+    {
+      rutz::istring key;
+      if (!rutz::istring::find(rutz::char_range(name.c_str(),
+                                                name.length()), key))
+        return el_ptr();
+
+      map_type::const_iterator itr = m_elems.find(key);
+      return itr == m_elems.end() ? el_ptr() : (*itr).second;
+    }
+
   public:
     int m_version;
-    typedef std::map<fstring, el_ptr> map_type;
+    typedef rutz::istring_map<el_ptr> map_type;
     map_type m_elems;
   };
 
@@ -429,7 +456,7 @@ namespace
 
   soft_ref<io::serializable> group_element::read_weak_object(const fstring& name)
   {
-    el_ptr el = m_elems[name];
+    el_ptr el = find_elem(name);
     objref_element& olp = element_cast<objref_element>(el.get(), name, SRC_POS);
     return olp.get_object();
   }
@@ -579,6 +606,8 @@ namespace
 nub::ref<io::serializable> io::load_gvx(const char* filename)
 {
 GVX_TRACE("io::load_gvx");
+  // the strings made while building the element tree are temporary
+  rutz::string_arena arena;
   unique_ptr<std::istream> ifs(rutz::icompressopen(filename));
   tree_builder x(*ifs);
   x.parse();
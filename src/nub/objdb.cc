@@ -176,6 +176,32 @@ public:
       return (*itr).second.get();
     }
 
+  void lookup_objs(const nub::uid* ids, size_t n,
+                   nub::object** result) noexcept
+    {
+      map_type::iterator itr = m_obj_map.end();
+
+      for (size_t i = 0; i < n; ++i)
+        {
+          // try the successor of the previous match before searching
+          if (itr != m_obj_map.end())
+            ++itr;
+
+          if (itr == m_obj_map.end() || (*itr).first != ids[i])
+            itr = m_obj_map.find(ids[i]);
+
+          if (itr != m_obj_map.end() && (*itr).second.is_valid())
+            {
+              result[i] = (*itr).second.get();
+            }
+          else
+            {
+              result[i] = nullptr;
+              itr = m_obj_map.end();
+            }
+        }
+    }
+
   void insert_obj(nub::object* ptr, bool strong)
     {
       GVX_PRECONDITION(ptr != nullptr);
@@ -360,6 +386,13 @@ GVX_TRACE("nub::objectdb::get_checked_obj");
   return rep->get_checked_obj(id);
 }
 
+void nub::objectdb::lookup_objs(const nub::uid* ids, size_t n,
+                                nub::object** result) noexcept
+{
+GVX_TRACE("nub::objectdb::lookup_objs");
+  rep->lookup_objs(ids, n, result);
+}
+
 void nub::objectdb::insert_obj(nub::object* obj)
 {
 GVX_TRACE("nub::objectdb::insert_obj");
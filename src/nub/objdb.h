@@ -163,6 +163,14 @@ public:
       nub::invalid_uid_error if it is not. */
   nub::object* get_checked_obj(nub::uid id);
 
+  /// Look up the objects for the \a n uids in \a ids, all at once.
+  /** On return, \a result[i] holds the object whose uid is \a ids[i],
+      or null if \a ids[i] is not a valid uid. Runs of increasing
+      uids (such as lists of objects in creation order) are resolved
+      without a full search for each uid. */
+  void lookup_objs(const nub::uid* ids, size_t n,
+                   nub::object** result) noexcept;
+
   /// Insert a strong reference to obj into the database.
   void insert_obj(nub::object* obj);
 
@@ -50,6 +50,17 @@ nub::object* nub::detail::get_checked_item(nub::uid id)
   return nub::objectdb::instance().get_checked_obj(id);
 }
 
+void nub::detail::get_items(const nub::uid* ids, size_t n,
+                            nub::object** result, bool checked)
+{
+  nub::objectdb::instance().lookup_objs(ids, n, result);
+
+  if (checked)
+    for (size_t i = 0; i < n; ++i)
+      if (result[i] == nullptr)
+        throw nub::invalid_uid_error(ids[i], SRC_POS);
+}
+
 void nub::detail::insert_item_public(nub::object* obj)
 {
   nub::objectdb::instance().insert_obj(obj);
@@ -40,6 +40,7 @@
 #include "rutz/fileposition.h" // for SRC_POS macro
 #include "rutz/stderror.h"     // for rutz::throw_bad_cast()
 
+#include <cstddef>
 #include <typeinfo>
 
 namespace nub
@@ -53,6 +54,12 @@ namespace nub
     bool is_valid_uid(nub::uid id) noexcept;
     nub::object* get_checked_item(nub::uid id);
 
+    /// Fill \a result with the objects for \a n uids.
+    /** Invalid uids give null entries if \a checked is false, and
+        throw an exception otherwise. */
+    void get_items(const nub::uid* ids, size_t n,
+                   nub::object** result, bool checked);
+
     void insert_item_public(nub::object* obj);
     void insert_item_protected(nub::object* obj);
 
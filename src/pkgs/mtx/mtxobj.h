@@ -59,6 +59,8 @@ public:
 
   static MtxObj* make() { return new MtxObj(mtx::empty_mtx()); }
 
+  static MtxObj* make(const mtx& m) { return new MtxObj(m); }
+
   virtual rutz::fstring obj_typename() const override { return "mtx"; }
 };
 
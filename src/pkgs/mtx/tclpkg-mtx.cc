@@ -35,9 +35,16 @@
 
 #include "nub/objfactory.h"
 
+#include "tcl/list.h"
 #include "tcl/objpkg.h"
 #include "tcl/pkg.h"
 
+#include "tcl-io/fieldpkg.h"
+
+#include "rutz/fstring.h"
+
+#include <vector>
+
 #include "rutz/trace.h"
 
 namespace tcl
@@ -62,6 +69,33 @@ namespace tcl
   };
 }
 
+namespace
+{
+  // Gather a numeric field from many objects into a column vector.
+  nub::ref<MtxObj> fromField(const tcl::list& objrefs,
+                             const rutz::fstring& name)
+  {
+    const std::vector<double> vals = tcl::getNumericField(objrefs, name);
+
+    return nub::ref<MtxObj>
+      (MtxObj::make(mtx::colmaj_copy_of(vals.data(), vals.size(), 1)));
+  }
+
+  // Scatter the elements of m (in column-major order) to a numeric
+  // field of many objects.
+  void toField(nub::ref<MtxObj> m, const tcl::list& objrefs,
+               const rutz::fstring& name)
+  {
+    std::vector<double> vals;
+    vals.reserve(m->nelems());
+    for (mtx::const_colmaj_iter itr = m->colmaj_begin(),
+           end = m->colmaj_end(); itr != end; ++itr)
+      vals.push_back(*itr);
+
+    tcl::setNumericField(objrefs, name, vals.data(), vals.size());
+  }
+}
+
 extern "C"
 int Mtx_Init(Tcl_Interp* interp)
 {
@@ -80,6 +114,9 @@ GVX_TRACE("Mtx_Init");
       pkg->def_getter("ncols", &mtx::ncols, SRC_POS);
       pkg->def_getter("nelems", &mtx::nelems, SRC_POS);
 
+      pkg->def("fromField", "objrefs field_name", &fromField, SRC_POS);
+      pkg->def("toField", "mtx objrefs field_name", &toField, SRC_POS);
+
       nub::obj_factory::instance().register_creator(&MtxObj::make);
       nub::obj_factory::instance().register_alias("MtxObj", "mtx");
     });
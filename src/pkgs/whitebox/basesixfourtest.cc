@@ -30,6 +30,7 @@
 
 #include "pkgs/whitebox/basesixfourtest.h"
 
+#include "rutz/ascii85.h"
 #include "rutz/base64.h"
 #include "rutz/bytearray.h"
 #include "rutz/fstring.h"
@@ -184,6 +185,29 @@ namespace
     TEST_REQUIRE_EQ(buf2.vec.size(), SZ);
     TEST_REQUIRE_EQ(memcmp(&buf2.vec[0], &decoded5.vec[0], SZ), 0);
   }
+
+  void testAscii85Encode()
+  {
+    // Test ASCII85 encoding of whole groups, of an all-zero group
+    // (which becomes 'z'), and of a trailing partial group
+
+    const char* decoded1 = "Man is distinguished, and a Dog?";
+    const std::string buf1 =
+      rutz::ascii85_encode
+      (reinterpret_cast<const unsigned char*>(decoded1), 32, 0);
+    TEST_REQUIRE_EQ(rutz::fstring(buf1.c_str()),
+                    "9jqo^BlbD-BleB1DJ+*+F(f,q/0JA=A0>;'6uQ^&~>");
+
+    const unsigned char decoded2[6] = { 0, 0, 0, 0, 'a', 'b' };
+    const std::string buf2 = rutz::ascii85_encode(&decoded2[0], 6, 0);
+    TEST_REQUIRE_EQ(rutz::fstring(buf2.c_str()), "z@:B~>");
+
+    const std::string buf3 =
+      rutz::ascii85_encode
+      (reinterpret_cast<const unsigned char*>(decoded1), 32, 10);
+    TEST_REQUIRE_EQ(rutz::fstring(buf3.c_str()),
+                    "9jqo^BlbD-\nBleB1DJ+*+\nF(f,q/0JA=\nA0>;'6uQ^&\n~>");
+  }
 }
 
 extern "C"
@@ -200,5 +224,6 @@ GVX_TRACE("Basesixfourtest_Init");
       DEF_TEST(pkg, testBase64EncodeDecode3);
       DEF_TEST(pkg, testBase64EncodeDecode4);
       DEF_TEST(pkg, testBase64EncodeDecode5);
+      DEF_TEST(pkg, testAscii85Encode);
     });
 }
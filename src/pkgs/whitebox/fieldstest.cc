@@ -0,0 +1,234 @@
+/** @file pkgs/whitebox/fieldstest.cc tcl interface package for testing
+    and timing FieldMap lookups and bulk field access */
+
+///////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026-2026 Rob Peters
+// Rob Peters <https://github.com/rjpcal/>
+//
+// created: Mon Oct 19 16:10:42 2026
+//
+// --------------------------------------------------------------------
+//
+// This file is part of GroovX.
+//   [https://github.com/rjpcal/groovx]
+//
+// GroovX is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// GroovX is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GroovX; if not, write to the Free Software Foundation,
+// Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include "pkgs/whitebox/fieldstest.h"
+
+#include "io/fields.h"
+
+#include "nub/ref.h"
+
+#include "tcl/conversions.h"
+#include "tcl/pkg.h"
+
+#include "tcl-io/objreader.h"
+#include "tcl-io/objwriter.h"
+
+#include "visx/face.h"
+#include "visx/gaborarray.h"
+#include "visx/trial.h"
+
+#include "rutz/error.h"
+#include "rutz/fstring.h"
+#include "rutz/iter.h"
+#include "rutz/unittest.h"
+
+#include <limits>
+#include <set>
+
+#include "rutz/trace.h"
+
+namespace
+{
+  // Count the distinct field names along the FieldMap's parent chain.
+  unsigned int countChainFields(const FieldMap& fields)
+  {
+    std::set<rutz::fstring> names;
+    for (const FieldMap* fmap = &fields; fmap != nullptr; fmap = fmap->parent())
+      for (FieldMap::Iterator itr(fmap->ioFields()); itr.is_valid(); ++itr)
+        names.insert(itr->name());
+    return static_cast<unsigned int>(names.size());
+  }
+
+  void testFieldLookup()
+  {
+    const FieldMap& fields = GaborArray::classFields();
+
+    TEST_REQUIRE(fields.hasParent());
+    TEST_REQUIRE_EQ(fields.numAllFields(), countChainFields(fields));
+
+    // every field in the flattened table is found under its own name
+    for (unsigned int i = 0; i < fields.numAllFields(); ++i)
+      {
+        const Field& f = fields.allFieldAt(i);
+        TEST_REQUIRE(fields.findField(f.name()) == &f);
+        TEST_REQUIRE(&(fields.field(f.name())) == &f);
+      }
+
+    // our own fields come first, in their native order
+    FieldMap::Iterator itr(fields.ioFields());
+    TEST_REQUIRE(&(fields.allFieldAt(0)) == &(*itr));
+
+    TEST_REQUIRE(fields.findField("foregSeed") != nullptr);
+    TEST_REQUIRE(fields.findField("category") != nullptr); // inherited
+    TEST_REQUIRE(fields.findField("noSuchField") == nullptr);
+    TEST_REQUIRE(fields.findField("") == nullptr);
+
+    bool caught = false;
+    try { fields.field("noSuchField"); }
+    catch (rutz::error&) { caught = true; }
+    TEST_REQUIRE(caught);
+
+    TEST_REQUIRE_EQ(FieldMap::emptyFieldMap()->numAllFields(), 0u);
+    TEST_REQUIRE(FieldMap::emptyFieldMap()->findField("category") == nullptr);
+  }
+
+  void testNumericField()
+  {
+    nub::ref<GaborArray> ga1(GaborArray::make());
+    nub::ref<GaborArray> ga2(GaborArray::make());
+    nub::ref<Face> face(Face::make());
+
+    FieldContainer* objs[] = { ga1.get(), ga2.get() };
+    double vals[2] = { 0.0, 0.0 };
+
+    // Cached<unsigned long> data member
+    const double seeds[] = { 17.0, 5.0 };
+    FieldContainer::setNumericField("thetaSeed", objs, 2, seeds, 2);
+    FieldContainer::getNumericField("thetaSeed", objs, 2, vals);
+    TEST_REQUIRE_EQ(vals[0], 17.0);
+    TEST_REQUIRE_EQ(vals[1], 5.0);
+
+    // a non-integral value is an error, and leaves all objects unchanged
+    const double fractional[] = { 18.0, 4.6 };
+    bool caught = false;
+    try { FieldContainer::setNumericField("thetaSeed", objs, 2, fractional, 2); }
+    catch (rutz::error&) { caught = true; }
+    TEST_REQUIRE(caught);
+    FieldContainer::getNumericField("thetaSeed", objs, 2, vals);
+    TEST_REQUIRE_EQ(vals[0], 17.0);
+    TEST_REQUIRE_EQ(vals[1], 5.0);
+
+    // one value for all objects, through an inherited getter/setter
+    const double cat = 3.0;
+    FieldContainer::setNumericField("category", objs, 2, &cat, 1);
+    TEST_REQUIRE_EQ(ga1->category(), 3);
+    TEST_REQUIRE_EQ(ga2->category(), 3);
+
+    // the field is looked up again when the class changes (Face has
+    // its own "category" data member)
+    FieldContainer* mixed[] = { ga1.get(), face.get() };
+    const double cats[] = { 4.0, 7.0 };
+    FieldContainer::setNumericField("category", mixed, 2, cats, 2);
+    FieldContainer::getNumericField("category", mixed, 2, vals);
+    TEST_REQUIRE_EQ(vals[0], 4.0);
+    TEST_REQUIRE_EQ(vals[1], 7.0);
+
+    // the bulk path agrees with the string path
+    tcl::obj_writer w;
+    ga1->field("gaborSigma").writeValueTo(ga1.get(), w);
+    FieldContainer::getNumericField("gaborSigma", objs, 1, vals);
+    TEST_REQUIRE_EQ(vals[0], tcl::convert_to<double>(w.get_obj()));
+
+    const double bad = -1.0;
+    caught = false;
+    try { FieldContainer::setNumericField("thetaSeed", objs, 2, &bad, 1); }
+    catch (rutz::error&) { caught = true; }
+    TEST_REQUIRE(caught);
+
+    // double(ULONG_MAX) rounds up to 2^64, which is out of range
+    const double toobig = double(std::numeric_limits<unsigned long>::max());
+    caught = false;
+    try { FieldContainer::setNumericField("thetaSeed", objs, 2, &toobig, 1); }
+    catch (rutz::error&) { caught = true; }
+    TEST_REQUIRE(caught);
+
+    caught = false;
+    try { FieldContainer::setNumericField("thetaSeed", objs, 2, seeds, 3); }
+    catch (rutz::error&) { caught = true; }
+    TEST_REQUIRE(caught);
+  }
+
+  // Get and then set (to the same value) every gettable, settable
+  // field of obj, the way the Tcl field commands do.
+  void getSetAllFields(FieldContainer* obj, int reps)
+  {
+    const FieldMap& fields = obj->fields();
+
+    for (int r = 0; r < reps; ++r)
+      for (unsigned int i = 0; i < fields.numAllFields(); ++i)
+        {
+          const Field& f = fields.allFieldAt(i);
+          if (!f.allowGet() || !f.allowSet())
+            continue;
+
+          tcl::obj_writer w;
+          f.writeValueTo(obj, w);
+          tcl::obj_reader rd(w.get_obj());
+          f.readValueFrom(obj, rd);
+        }
+  }
+
+  void testFieldBenchmark()
+  {
+    static rutz::prof p1("testprof/fields/lookup", __FILE__, __LINE__);
+    static rutz::prof p2("testprof/fields/GaborArray/get+set", __FILE__, __LINE__);
+    static rutz::prof p3("testprof/fields/Trial/get+set", __FILE__, __LINE__);
+
+    {
+      const FieldMap& fields = GaborArray::classFields();
+      const rutz::fstring names[] =
+        { "foregSeed", "gaborSigma", "category", "renderMode", "noSuchField" };
+
+      rutz::trace t(p1, false);
+      unsigned int found = 0;
+      for (int i = 0; i < 200000; ++i)
+        if (fields.findField(names[i % 5]) != nullptr)
+          ++found;
+      TEST_REQUIRE_EQ(found, 160000u);
+    }
+
+    {
+      nub::ref<GaborArray> ga(GaborArray::make());
+      rutz::trace t(p2, false);
+      getSetAllFields(ga.get(), 200);
+    }
+
+    {
+      nub::ref<Trial> tr(Trial::make());
+      rutz::trace t(p3, false);
+      getSetAllFields(tr.get(), 2000);
+    }
+  }
+}
+
+extern "C"
+int Fieldstest_Init(Tcl_Interp* interp)
+{
+GVX_TRACE("Fieldstest_Init");
+
+  return tcl::pkg::init
+    (interp, "Fieldstest", "4.0",
+     [](tcl::pkg* pkg) {
+      DEF_TEST(pkg, testFieldLookup);
+      DEF_TEST(pkg, testNumericField);
+      DEF_TEST(pkg, testFieldBenchmark);
+    });
+}
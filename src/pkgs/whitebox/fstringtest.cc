@@ -33,17 +33,23 @@
 
 #include "tcl/pkg.h"
 
+#include "rutz/assocarray.h"
 #include "rutz/fstring.h"
+#include "rutz/istring.h"
 #include "rutz/sfmt.h"
 #include "rutz/unittest.h"
 
 #include <cstring>
+#include <map>
 #include <sstream>
+#include <string>
+#include <vector>
 
 #include "rutz/trace.h"
 
 using rutz::char_range;
 using rutz::fstring;
+using rutz::istring;
 
 namespace
 {
@@ -248,6 +254,269 @@ namespace
 
     TEST_REQUIRE_EQ(out.str().c_str(), fstring("blue\ncrayon\n\tskies"));
   }
+
+  // number of string_rep allocations, from the heap or an arena
+  unsigned long repCount()
+  {
+    const rutz::fstring_alloc_counts c = rutz::get_fstring_alloc_counts();
+    return c.heap_reps + c.arena_reps;
+  }
+
+  void testInlineStorage()
+  {
+    const unsigned long n0 = repCount();
+
+    fstring empty;
+    fstring shortest("");
+    fstring s14("fourteen chars");
+    fstring copy(s14);
+    fstring assigned;
+    assigned = copy;
+
+    TEST_REQUIRE_EQ(repCount(), n0); // no allocations so far
+    TEST_REQUIRE_EQ(s14.length(), fstring::max_inline);
+    TEST_REQUIRE(copy == "fourteen chars");
+    TEST_REQUIRE(copy.c_str() != s14.c_str()); // each has its own copy
+    TEST_REQUIRE(assigned == s14);
+
+    fstring s15("fifteen chars!!");
+    TEST_REQUIRE_EQ(repCount(), n0 + 1);
+
+    fstring copy15(s15);
+    TEST_REQUIRE_EQ(repCount(), n0 + 1); // long strings are shared
+    TEST_REQUIRE(copy15.c_str() == s15.c_str());
+
+    // swap across the inline/shared boundary
+    s14.swap(s15);
+    TEST_REQUIRE(s14 == "fifteen chars!!");
+    TEST_REQUIRE(s15 == "fourteen chars");
+    TEST_REQUIRE(s15 != s14);
+    TEST_REQUIRE(s14 == copy15);
+    TEST_REQUIRE(fstring("abc") < fstring("abd"));
+    TEST_REQUIRE(fstring("fifteen chars!!").ends_with("chars!!"));
+  }
+
+  void testArena()
+  {
+    fstring survivor;
+
+    {
+      rutz::string_arena arena;
+      TEST_REQUIRE(rutz::string_arena::current() == &arena);
+
+      const rutz::fstring_alloc_counts c0 = rutz::get_fstring_alloc_counts();
+
+      for (int i = 0; i < 1000; ++i)
+        {
+          fstring tmp = rutz::sfmt("a temporary string number %d", i);
+          if (i == 500)
+            survivor = tmp;
+        }
+
+      fstring heap_str;
+      {
+        rutz::string_arena::suspend heap_only;
+        TEST_REQUIRE(rutz::string_arena::current() == nullptr);
+        heap_str = "allocated on the heap anyway";
+      }
+      TEST_REQUIRE(rutz::string_arena::current() == &arena);
+
+      const rutz::fstring_alloc_counts c1 = rutz::get_fstring_alloc_counts();
+      TEST_REQUIRE(c1.arena_reps - c0.arena_reps >= 1000);
+      TEST_REQUIRE_EQ(c1.heap_reps - c0.heap_reps, 1ul);
+      TEST_REQUIRE(c1.arena_blocks - c0.arena_blocks < 10);
+
+      // long strings outside the arena size limit come from the heap
+      std::string big(100000, 'x');
+      fstring bigstr(char_range(big.data(), big.size()));
+      TEST_REQUIRE_EQ(rutz::get_fstring_alloc_counts().heap_reps,
+                      c1.heap_reps + 1);
+    }
+
+    TEST_REQUIRE(rutz::string_arena::current() == nullptr);
+
+    // a string that escapes the arena's scope stays valid
+    TEST_REQUIRE_EQ(survivor, fstring("a temporary string number 500"));
+  }
+
+  void testAllocBenchmark()
+  {
+    static rutz::prof p1("testprof/fstring/parse/heap", __FILE__, __LINE__);
+    static rutz::prof p2("testprof/fstring/parse/arena", __FILE__, __LINE__);
+
+    // ASW-like input: short type and name tokens, and longer values
+    std::ostringstream oss;
+    for (int i = 0; i < 20000; ++i)
+      oss << "double itsParameter" << (i % 50) << " = "
+          << "0.123456789012345678901234567890" << i << "\n";
+    const std::string input = oss.str();
+    const unsigned long ntokens = 4 * 20000;
+
+    rutz::fstring_alloc_counts c[3];
+
+    c[0] = rutz::get_fstring_alloc_counts();
+    {
+      rutz::trace t(p1, false);
+      std::istringstream in(input);
+      fstring type, name, equal, value;
+      while (in >> type >> name >> equal >> value)
+        {}
+    }
+    c[1] = rutz::get_fstring_alloc_counts();
+    {
+      rutz::trace t(p2, false);
+      rutz::string_arena arena;
+      std::istringstream in(input);
+      fstring type, name, equal, value;
+      while (in >> type >> name >> equal >> value)
+        {}
+    }
+    c[2] = rutz::get_fstring_alloc_counts();
+
+    // before inline storage, every token took two allocations (rep
+    // plus text); now only the long ones take one
+    const unsigned long heap1 = c[1].heap_reps - c[0].heap_reps;
+    TEST_REQUIRE(heap1 <= 2 * ntokens / 4 + 10);
+
+    // with an arena, the long ones are carved from a few blocks
+    TEST_REQUIRE_EQ(c[2].heap_reps - c[1].heap_reps, 0ul);
+    TEST_REQUIRE(c[2].arena_blocks - c[1].arena_blocks < 100);
+  }
+
+  void testIstring()
+  {
+    istring a("frobnicate");
+    istring b(fstring("frobnicate"));
+    istring c(char_range("frobnicated", 10));
+    istring d("frobnicated");
+
+    TEST_REQUIRE(a == b);
+    TEST_REQUIRE(a == c);
+    TEST_REQUIRE(a != d);
+    TEST_REQUIRE(a.c_str() == c.c_str()); // same interned copy
+    TEST_REQUIRE(a == "frobnicate");
+    TEST_REQUIRE(a.length() == 10);
+    TEST_REQUIRE(a.hash() == rutz::string_hash("frobnicate", 10));
+    TEST_REQUIRE(a < d);
+    TEST_REQUIRE(!(d < a));
+    TEST_REQUIRE(!(a < b));
+
+    istring e;
+    TEST_REQUIRE(e.empty());
+    TEST_REQUIRE(e == istring(""));
+    TEST_REQUIRE(e == istring(static_cast<const char*>(nullptr)));
+
+    // find() doesn't intern anything
+    const size_t n = istring::num_interned();
+    istring f;
+    TEST_REQUIRE(!istring::find(char_range("no such string, ever", 20), f));
+    TEST_REQUIRE(f.empty());
+    TEST_REQUIRE(istring::num_interned() == n);
+    TEST_REQUIRE(istring::find(char_range("frobnicated", 11), f));
+    TEST_REQUIRE(f == d);
+
+    rutz::istring_map<int> m;
+    m["x"] = 1;
+    m[fstring("y")] = 2;
+    TEST_REQUIRE_EQ(m.size(), 2u);
+    TEST_REQUIRE_EQ(m[istring("x")], 1);
+    TEST_REQUIRE_EQ(m.at("y"), 2);
+
+    rutz::fstring_hash_map<int> fm;
+    fm["p"] = 3;
+    TEST_REQUIRE_EQ(fm[fstring("p")], 3);
+    TEST_REQUIRE(fm.find(fstring("q")) == fm.end());
+  }
+
+  void testAssocArray()
+  {
+    rutz::assoc_array<int> arr("frobnicator");
+    arr.set_ptr_for_key("beta", new int(2));
+    arr.set_ptr_for_key("alpha", new int(1));
+    arr.set_ptr_for_key("gamma", new int(3));
+    arr.set_ptr_for_key("beta", new int(22)); // replaces (and deletes) 2
+
+    TEST_REQUIRE_EQ(*arr.get_ptr_for_key("alpha"), 1);
+    TEST_REQUIRE_EQ(*arr.get_ptr_for_key(fstring("beta")), 22);
+    TEST_REQUIRE(arr.get_ptr_for_key("Alpha") == nullptr);
+    TEST_REQUIRE(arr.get_ptr_for_key("delta") == nullptr);
+    TEST_REQUIRE_EQ(arr.get_known_keys(" "), fstring("alpha beta gamma"));
+
+    rutz::assoc_array<int> nc("frobnicator", true);
+    nc.set_ptr_for_key("Beta", new int(2));
+    nc.set_ptr_for_key("alpha", new int(1));
+    TEST_REQUIRE_EQ(*nc.get_ptr_for_key("ALPHA"), 1);
+    TEST_REQUIRE_EQ(*nc.get_ptr_for_key("beta"), 2);
+    TEST_REQUIRE_EQ(nc.get_known_keys(","), fstring("alpha,Beta"));
+  }
+
+  void testIstringBenchmark()
+  {
+    static rutz::prof p1("testprof/istring/std::map<fstring>", __FILE__, __LINE__);
+    static rutz::prof p2("testprof/istring/fstring_hash_map", __FILE__, __LINE__);
+    static rutz::prof p3("testprof/istring/istring_map+intern", __FILE__, __LINE__);
+    static rutz::prof p4("testprof/istring/istring_map", __FILE__, __LINE__);
+    static rutz::prof p5("testprof/istring/assoc_array", __FILE__, __LINE__);
+
+    // a vocabulary about the size of the object factory
+    std::vector<fstring> names;
+    for (int i = 0; i < 200; ++i)
+      names.push_back(rutz::sfmt("GxObjectType%03d", (i * 37) % 200));
+
+    std::map<fstring, int> smap;
+    rutz::fstring_hash_map<int> hmap;
+    rutz::istring_map<int> imap;
+    rutz::assoc_array<int> arr("object type");
+    std::vector<istring> inames;
+
+    for (size_t i = 0; i < names.size(); ++i)
+      {
+        smap[names[i]] = int(i);
+        hmap[names[i]] = int(i);
+        imap[names[i]] = int(i);
+        arr.set_ptr_for_key(names[i].c_str(), new int(int(i)));
+        inames.push_back(istring(names[i]));
+      }
+
+    const int N = 1000000;
+
+    long sum1 = 0, sum2 = 0, sum3 = 0, sum4 = 0, sum5 = 0;
+
+    {
+      rutz::trace t(p1, false);
+      for (int i = 0; i < N; ++i)
+        sum1 += smap.find(names[size_t(i) % names.size()])->second;
+    }
+
+    {
+      rutz::trace t(p2, false);
+      for (int i = 0; i < N; ++i)
+        sum2 += hmap.find(names[size_t(i) % names.size()])->second;
+    }
+
+    {
+      rutz::trace t(p3, false);
+      for (int i = 0; i < N; ++i)
+        sum3 += imap.find(istring(names[size_t(i) % names.size()]))->second;
+    }
+
+    {
+      rutz::trace t(p4, false);
+      for (int i = 0; i < N; ++i)
+        sum4 += imap.find(inames[size_t(i) % inames.size()])->second;
+    }
+
+    {
+      rutz::trace t(p5, false);
+      for (int i = 0; i < N; ++i)
+        sum5 += *arr.get_ptr_for_key(names[size_t(i) % names.size()]);
+    }
+
+    TEST_REQUIRE_EQ(sum2, sum1);
+    TEST_REQUIRE_EQ(sum3, sum1);
+    TEST_REQUIRE_EQ(sum4, sum1);
+    TEST_REQUIRE_EQ(sum5, sum1);
+  }
 }
 
 extern "C"
@@ -275,5 +544,11 @@ GVX_TRACE("Fstringtest_Init");
       DEF_TEST(pkg, testReadline1);
       DEF_TEST(pkg, testReadline2);
       DEF_TEST(pkg, testWrite);
+      DEF_TEST(pkg, testInlineStorage);
+      DEF_TEST(pkg, testArena);
+      DEF_TEST(pkg, testAllocBenchmark);
+      DEF_TEST(pkg, testIstring);
+      DEF_TEST(pkg, testAssocArray);
+      DEF_TEST(pkg, testIstringBenchmark);
     });
 }
@@ -31,11 +31,16 @@
 #include "pkgs/whitebox/geomtest.h"
 
 #include "geom/txform.h"
+#include "geom/vec2.h"
+#include "geom/vec3.h"
 
 #include "tcl/pkg.h"
 
+#include "rutz/rand.h"
 #include "rutz/unittest.h"
 
+#include <vector>
+
 #include "rutz/trace.h"
 #include "rutz/debug.h"
 GVX_DBG_REGISTER
@@ -79,6 +84,134 @@ namespace
         TEST_REQUIRE_APPROX(sum_square(M2 - I), 0.0, 1e-20);
       }
   }
+
+  void testMtxMulAliased()
+  {
+    for (int i = 0; i < 100; ++i)
+      {
+        const txform T = txform::random();
+        const txform TT = T.mtx_mul(T);
+
+        txform A = T;
+        A.transform(A);
+
+        TEST_REQUIRE_APPROX(sum_square(A - TT), 0.0, 1e-20);
+      }
+  }
+
+  void testBatchApply()
+  {
+    rutz::urand u(17);
+
+    // odd sizes, so that the scalar tail gets exercised too
+    const size_t N = 1001;
+
+    std::vector<double> x(N), y(N), z(N), ox(N), oy(N), oz(N);
+
+    for (int trial = 0; trial < 20; ++trial)
+      {
+        txform T = txform::random();
+
+        // make sure we hit the w == 0 case at least once
+        if (trial == 0)
+          {
+            T[3] = 0.0; T[7] = 0.0; T[11] = 0.0; T[15] = 0.0;
+          }
+
+        for (size_t i = 0; i < N; ++i)
+          {
+            x[i] = u.fdraw_range(-10.0, 10.0);
+            y[i] = u.fdraw_range(-10.0, 10.0);
+            z[i] = u.fdraw_range(-10.0, 10.0);
+          }
+
+        T.apply_to(x.data(), y.data(), z.data(),
+                   ox.data(), oy.data(), oz.data(), N);
+
+        for (size_t i = 0; i < N; ++i)
+          {
+            const geom::vec3d r = T.apply_to(geom::vec3d(x[i], y[i], z[i]));
+            TEST_REQUIRE_APPROX(ox[i], r.x(), 1e-12);
+            TEST_REQUIRE_APPROX(oy[i], r.y(), 1e-12);
+            TEST_REQUIRE_APPROX(oz[i], r.z(), 1e-12);
+          }
+
+        T.apply_to(x.data(), y.data(), ox.data(), oy.data(), N);
+
+        for (size_t i = 0; i < N; ++i)
+          {
+            const geom::vec2d r = T.apply_to(geom::vec2d(x[i], y[i]));
+            TEST_REQUIRE_APPROX(ox[i], r.x(), 1e-12);
+            TEST_REQUIRE_APPROX(oy[i], r.y(), 1e-12);
+          }
+
+        // in-place
+        T.apply_to(x.data(), y.data(), z.data(),
+                   x.data(), y.data(), z.data(), N);
+        T.apply_to(ox.data(), oy.data(), oz.data(),
+                   ox.data(), oy.data(), oz.data(), 0);
+      }
+  }
+
+  void testBatchApplyBenchmark()
+  {
+    static rutz::prof p1("testprof/txform/per-vertex/apply_to", __FILE__, __LINE__);
+    static rutz::prof p2("testprof/txform/batched/apply_to", __FILE__, __LINE__);
+    static rutz::prof p3("testprof/txform/mtx_mul", __FILE__, __LINE__);
+    static rutz::prof p4("testprof/txform/inverted", __FILE__, __LINE__);
+
+    const size_t N = 1000000;
+
+    const txform T = txform::random();
+
+    std::vector<geom::vec3d> pts(N);
+    std::vector<double> x(N), y(N), z(N);
+    for (size_t i = 0; i < N; ++i)
+      {
+        x[i] = double(i % 1000);
+        y[i] = double(i / 1000);
+        z[i] = 0.5;
+        pts[i] = geom::vec3d(x[i], y[i], z[i]);
+      }
+
+    double s1 = 0.0;
+    {
+      rutz::trace t(p1, false);
+      for (size_t i = 0; i < N; ++i)
+        {
+          pts[i] = T.apply_to(pts[i]);
+          s1 += pts[i].x();
+        }
+    }
+
+    double s2 = 0.0;
+    {
+      rutz::trace t(p2, false);
+      T.apply_to(x.data(), y.data(), z.data(),
+                 x.data(), y.data(), z.data(), N);
+      for (size_t i = 0; i < N; ++i)
+        s2 += x[i];
+    }
+
+    TEST_REQUIRE_APPROX(s1, s2, 1e-6 * (s1 < 0 ? -s1 : s1) + 1e-6);
+
+    const txform U = txform::random();
+    double s3 = 0.0;
+    {
+      rutz::trace t(p3, false);
+      for (size_t i = 0; i < N / 10; ++i)
+        s3 += T.mtx_mul(U)[0];
+    }
+
+    double s4 = 0.0;
+    {
+      rutz::trace t(p4, false);
+      for (size_t i = 0; i < N / 10; ++i)
+        s4 += T.inverted()[0];
+    }
+
+    TEST_REQUIRE(s3 == s3 && s4 == s4); // i.e. not NaN
+  }
 }
 
 extern "C"
@@ -90,5 +223,8 @@ GVX_TRACE("Geomtest_Init");
     (interp, "Geomtest", "4.0",
      [](tcl::pkg* pkg) {
       DEF_TEST(pkg, testInvert);
+      DEF_TEST(pkg, testMtxMulAliased);
+      DEF_TEST(pkg, testBatchApply);
+      DEF_TEST(pkg, testBatchApplyBenchmark);
     });
 }
@@ -0,0 +1,262 @@
+/** @file pkgs/whitebox/numvectest.cc tcl interface package for testing
+    and timing packed numeric vectors */
+
+///////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026-2026 Rob Peters
+// Rob Peters <https://github.com/rjpcal/>
+//
+// created: Mon Oct 19 10:48:27 2026
+//
+// --------------------------------------------------------------------
+//
+// This file is part of GroovX.
+//   [https://github.com/rjpcal/groovx]
+//
+// GroovX is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// GroovX is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GroovX; if not, write to the Free Software Foundation,
+// Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include "pkgs/whitebox/numvectest.h"
+
+#include "tcl/list.h"
+#include "tcl/numvec.h"
+#include "tcl/pkg.h"
+
+#include "rutz/error.h"
+#include "rutz/fstring.h"
+#include "rutz/unittest.h"
+
+#include <cstring>
+#include <tcl.h>
+#include <vector>
+
+#include "rutz/trace.h"
+
+namespace
+{
+  typedef tcl::numvec::int_type int_type;
+
+  void testNumvecKernels()
+  {
+    // odd lengths exercise both the vector loops and the scalar tails
+    for (size_t n = 0; n < 12; ++n)
+      {
+        tcl::numvec r = tcl::numvec::ints(n);
+        tcl::packed_range(r.int_data(), n, 7, -3);
+
+        std::vector<double> d(n);
+        std::vector<int_type> flags(n);
+        int_type isum = 0;
+        for (size_t i = 0; i < n; ++i)
+          {
+            TEST_REQUIRE(r.int_data()[i] == 7 - 3*int_type(i));
+            isum += r.int_data()[i];
+            d[i] = 0.5 * double(i);
+            flags[i] = (i % 3 == 1) ? 0 : int_type(i) - 5;
+          }
+
+        TEST_REQUIRE(tcl::packed_sum(r.int_data(), n) == isum);
+        TEST_REQUIRE_EQ(tcl::packed_sum(d.data(), n), 0.25 * double(n * (n-1)));
+
+        std::vector<double> sel(n);
+        const size_t nsel = tcl::packed_select(d.data(), flags.data(), n,
+                                               sel.data());
+        size_t k = 0;
+        for (size_t i = 0; i < n; ++i)
+          if (flags[i] != 0)
+            TEST_REQUIRE_EQ(sel[k++], d[i]);
+        TEST_REQUIRE_EQ(nsel, k);
+
+        std::vector<int_type> idx(n);
+        for (size_t i = 0; i < n; ++i)
+          idx[i] = int_type((i * 7) % (n == 0 ? 1 : n));
+
+        std::vector<int_type> chosen(n);
+        TEST_REQUIRE(tcl::packed_choose(r.int_data(), n, idx.data(), n,
+                                        chosen.data()));
+        for (size_t i = 0; i < n; ++i)
+          TEST_REQUIRE(chosen[i] == r.int_data()[idx[i]]);
+
+        if (n > 0)
+          {
+            idx[n-1] = int_type(n);
+            TEST_REQUIRE(!tcl::packed_choose(r.int_data(), n, idx.data(), n,
+                                             chosen.data()));
+            idx[n-1] = -1;
+            TEST_REQUIRE(!tcl::packed_choose(r.int_data(), n, idx.data(), n,
+                                             chosen.data()));
+          }
+      }
+
+    // compensated summation doesn't lose the small terms
+    const double vals[] = { 1e16, 1.0, -1e16, 1.0, 0.5, 0.25 };
+    TEST_REQUIRE_EQ(tcl::packed_sum(vals, 6), 2.75);
+  }
+
+  void testNumvecObj()
+  {
+    tcl::numvec v = tcl::numvec::ints(4);
+    tcl::packed_range(v.int_data(), 4, 3, 2);
+
+    // the string rep is only built on demand
+    tcl::obj obj = v.as_obj();
+    TEST_REQUIRE(tcl::numvec::is_packed(obj.get()));
+    TEST_REQUIRE(obj.get()->bytes == nullptr);
+    TEST_REQUIRE_EQ(rutz::fstring(Tcl_GetString(obj.get())),
+                    rutz::fstring("3 5 7 9"));
+    TEST_REQUIRE(tcl::numvec::is_packed(obj.get()));
+
+    // the Tcl object and the numvec share data, but writes are private
+    tcl::numvec v2 = tcl::numvec::from_obj(obj.get());
+    TEST_REQUIRE(v2.int_data() != v.int_data()); // copied on write
+    v2.int_data()[0] = 42;
+    TEST_REQUIRE(tcl::numvec::from_obj(obj.get()).int_data()[0] == 3);
+
+    // generic lists are parsed, as integers if possible
+    tcl::obj ilist(Tcl_NewStringObj("4 -2 0x10", -1));
+    tcl::numvec iv = tcl::numvec::from_obj(ilist.get());
+    TEST_REQUIRE(iv.is_int());
+    TEST_REQUIRE_EQ(iv.size(), 3u);
+    TEST_REQUIRE(iv.int_data()[2] == 16);
+    TEST_REQUIRE(!tcl::numvec::is_packed(ilist.get()));
+
+    tcl::obj dlist(Tcl_NewStringObj("4 2.5 -1", -1));
+    tcl::numvec dv = tcl::numvec::from_obj(dlist.get());
+    TEST_REQUIRE(!dv.is_int());
+    TEST_REQUIRE_EQ(dv.double_data()[1], 2.5);
+    TEST_REQUIRE_EQ(dv.get_double(2), -1.0);
+
+    tcl::numvec d = tcl::numvec::doubles(2);
+    d.double_data()[0] = 0.5;
+    d.double_data()[1] = 3.0;
+    TEST_REQUIRE_EQ(rutz::fstring(Tcl_GetString(d.as_obj().get())),
+                    rutz::fstring("0.5 3.0"));
+
+    bool caught = false;
+    try { tcl::numvec::ints_from_obj(d.as_obj().get()); }
+    catch (rutz::error&) { caught = true; }
+    TEST_REQUIRE(caught);
+
+    d.double_data()[0] = -2.0;
+    tcl::numvec di = tcl::numvec::ints_from_obj(d.as_obj().get());
+    TEST_REQUIRE(di.is_int());
+    TEST_REQUIRE(di.int_data()[0] == -2);
+
+    caught = false;
+    tcl::obj junk(Tcl_NewStringObj("1 junk", -1));
+    try { tcl::numvec::from_obj(junk.get()); }
+    catch (rutz::error&) { caught = true; }
+    TEST_REQUIRE(caught);
+  }
+
+  void testNumvecBenchmark()
+  {
+    static rutz::prof p1("testprof/numvec/boxed/range", __FILE__, __LINE__);
+    static rutz::prof p2("testprof/numvec/packed/range", __FILE__, __LINE__);
+    static rutz::prof p3("testprof/numvec/boxed/sum", __FILE__, __LINE__);
+    static rutz::prof p4("testprof/numvec/packed/sum", __FILE__, __LINE__);
+    static rutz::prof p5("testprof/numvec/boxed/select", __FILE__, __LINE__);
+    static rutz::prof p6("testprof/numvec/packed/select", __FILE__, __LINE__);
+    static rutz::prof p7("testprof/numvec/boxed/choose", __FILE__, __LINE__);
+    static rutz::prof p8("testprof/numvec/packed/choose", __FILE__, __LINE__);
+
+    const unsigned int N = 1000000;
+
+    // the "boxed" versions do what dlist used to do, one Tcl_Obj per
+    // element; the "packed" versions are what dlist does now
+
+    tcl::list boxed;
+    {
+      rutz::trace t(p1, false);
+      for (unsigned int i = 0; i < N; ++i)
+        boxed.append(int(i));
+    }
+
+    tcl::numvec packed = tcl::numvec::ints(N);
+    {
+      rutz::trace t(p2, false);
+      tcl::packed_range(packed.int_data(), N, 0, 1);
+    }
+
+    int_type bsum = 0;
+    {
+      rutz::trace t(p3, false);
+      for (unsigned int i = 0; i < N; ++i)
+        bsum += boxed.get<int_type>(i);
+    }
+
+    {
+      rutz::trace t(p4, false);
+      TEST_REQUIRE(tcl::packed_sum(packed.int_data(), N) == bsum);
+    }
+
+    tcl::numvec flags = tcl::numvec::ints(N);
+    for (unsigned int i = 0; i < N; ++i)
+      flags.int_data()[i] = (i % 3 == 0);
+
+    {
+      rutz::trace t(p5, false);
+      tcl::list result;
+      for (unsigned int i = 0; i < N; ++i)
+        if (flags.int_data()[i])
+          result.append(boxed.at(i));
+      TEST_REQUIRE_EQ(result.length(), (N + 2) / 3);
+    }
+
+    {
+      rutz::trace t(p6, false);
+      tcl::numvec result = tcl::numvec::ints(N);
+      const size_t n = tcl::packed_select(packed.int_data(),
+                                          flags.int_data(), N,
+                                          result.int_data());
+      TEST_REQUIRE_EQ(n, size_t((N + 2) / 3));
+    }
+
+    tcl::numvec index = tcl::numvec::ints(N);
+    tcl::packed_range(index.int_data(), N, N - 1, -1);
+
+    {
+      rutz::trace t(p7, false);
+      tcl::list result;
+      for (unsigned int i = 0; i < N; ++i)
+        result.append(boxed.at(unsigned(index.int_data()[i])));
+      TEST_REQUIRE_EQ(result.length(), N);
+    }
+
+    {
+      rutz::trace t(p8, false);
+      tcl::numvec result = tcl::numvec::ints(N);
+      TEST_REQUIRE(tcl::packed_choose(packed.int_data(), N,
+                                      index.int_data(), N,
+                                      result.int_data()));
+      TEST_REQUIRE(result.int_data()[0] == int_type(N - 1));
+    }
+  }
+}
+
+extern "C"
+int Numvectest_Init(Tcl_Interp* interp)
+{
+GVX_TRACE("Numvectest_Init");
+
+  return tcl::pkg::init
+    (interp, "Numvectest", "4.0",
+     [](tcl::pkg* pkg) {
+      DEF_TEST(pkg, testNumvecKernels);
+      DEF_TEST(pkg, testNumvecObj);
+      DEF_TEST(pkg, testNumvecBenchmark);
+    });
+}
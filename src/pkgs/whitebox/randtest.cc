@@ -0,0 +1,227 @@
+/** @file pkgs/whitebox/randtest.cc tcl interface package for testing
+    and timing random-number generators */
+
+///////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026-2026 Rob Peters
+// Rob Peters <https://github.com/rjpcal/>
+//
+// created: Mon Oct 19 11:20:36 2026
+//
+// --------------------------------------------------------------------
+//
+// This file is part of GroovX.
+//   [https://github.com/rjpcal/groovx]
+//
+// GroovX is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// GroovX is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GroovX; if not, write to the Free Software Foundation,
+// Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include "pkgs/whitebox/randtest.h"
+
+#include "tcl/pkg.h"
+
+#include "rutz/rand.h"
+#include "rutz/unittest.h"
+
+#include <cstdint>
+#include <vector>
+
+#include "rutz/trace.h"
+
+namespace
+{
+  void testPhiloxKnownAnswers()
+  {
+    // test vectors from the Random123 distribution (kat_vectors)
+    uint32_t out[4];
+
+    const uint32_t k1[2] = { 0, 0 };
+    rutz::philox::block(k1, 0, 0, out);
+    TEST_REQUIRE(out[0] == 0x6627e8d5u && out[1] == 0xe169c58du &&
+                 out[2] == 0xbc57ac4cu && out[3] == 0x9b00dbd8u);
+
+    const uint32_t k2[2] = { 0xffffffffu, 0xffffffffu };
+    rutz::philox::block(k2, ~uint64_t(0), ~uint64_t(0), out);
+    TEST_REQUIRE(out[0] == 0x408f276du && out[1] == 0x41c83b0eu &&
+                 out[2] == 0xa20bc7c6u && out[3] == 0x6d5451fdu);
+
+    const uint32_t k3[2] = { 0xa4093822u, 0x299f31d0u };
+    rutz::philox::block(k3, 0x85a308d3243f6a88ull, 0x0370734413198a2eull,
+                        out);
+    TEST_REQUIRE(out[0] == 0xd16cfe09u && out[1] == 0x94fdccebu &&
+                 out[2] == 0x5001e420u && out[3] == 0x24126ea1u);
+  }
+
+  void testLegacySequence()
+  {
+    // the LEGACY engine must reproduce rutz::urand exactly
+    for (unsigned long seed: { 0ul, 1ul, 12345ul, 4000000000ul })
+      {
+        rutz::urand u(seed);
+        rutz::rng r(seed, rutz::rand_engine::LEGACY);
+
+        for (int i = 0; i < 1000; ++i)
+          {
+            switch (i % 4)
+              {
+              case 0: TEST_REQUIRE_EQ(r.fdraw(), u.fdraw()); break;
+              case 1: TEST_REQUIRE_EQ(r.idraw(37), u.idraw(37)); break;
+              case 2: TEST_REQUIRE_EQ(r.booldraw(), u.booldraw()); break;
+              case 3: TEST_REQUIRE_EQ(r.fdraw_range(-2.0, 5.0),
+                                      u.fdraw_range(-2.0, 5.0)); break;
+              }
+          }
+
+        std::vector<double> v(100);
+        r.fill_fdraw_range(v.data(), v.size(), 1.0, 3.0, 4);
+        for (double x: v)
+          TEST_REQUIRE_EQ(x, u.fdraw_range(1.0, 3.0));
+      }
+  }
+
+  void testPhiloxFill()
+  {
+    // bulk fills must match single draws, whatever the alignment and
+    // the number of threads
+    const size_t n = 100003;
+
+    for (unsigned int offset: { 0u, 1u, 2u, 3u })
+      for (unsigned int nthreads: { 1u, 3u, 8u })
+        {
+          rutz::philox single(42, 7);
+          rutz::philox bulk(42, 7);
+
+          single.discard(offset);
+          bulk.discard(offset);
+
+          std::vector<uint32_t> u(n);
+          bulk.fill_u32(u.data(), n, nthreads);
+          for (size_t i = 0; i < n; ++i)
+            TEST_REQUIRE(u[i] == single.u32draw());
+
+          std::vector<double> d(n);
+          bulk.fill_fdraw_range(d.data(), n, -1.0, 1.0, nthreads);
+          for (size_t i = 0; i < n; ++i)
+            TEST_REQUIRE_EQ(d[i], single.fdraw_range(-1.0, 1.0));
+
+          std::vector<int> k(n);
+          bulk.fill_idraw(k.data(), n, 17, nthreads);
+          for (size_t i = 0; i < n; ++i)
+            TEST_REQUIRE_EQ(k[i], single.idraw(17));
+
+          TEST_REQUIRE(bulk.position() == single.position());
+          TEST_REQUIRE(bulk.u32draw() == single.u32draw());
+        }
+  }
+
+  void testPhiloxStreams()
+  {
+    rutz::philox a(99);
+    rutz::philox b(99);
+
+    // discard() jumps ahead without drawing
+    for (int i = 0; i < 1001; ++i)
+      a.u32draw();
+    b.discard(1001);
+    TEST_REQUIRE(a.u32draw() == b.u32draw());
+
+    // substreams restart at zero, and differ from each other
+    rutz::philox s0 = a.substream(0);
+    rutz::philox s1 = a.substream(1);
+    rutz::philox fresh(99);
+    TEST_REQUIRE(s0.u32draw() == fresh.u32draw());
+
+    int same = 0;
+    for (int i = 0; i < 64; ++i)
+      if (s0.u32draw() == s1.u32draw())
+        ++same;
+    TEST_REQUIRE(same < 4);
+
+    rutz::rng p(5, rutz::rand_engine::PHILOX);
+    rutz::rng q = p.substream(3);
+    rutz::philox ref = rutz::philox(5).substream(3);
+    TEST_REQUIRE_EQ(q.fdraw(), ref.fdraw());
+
+    // crude uniformity check
+    rutz::philox g(2026);
+    std::vector<double> v(1 << 16);
+    g.fill_fdraw(v.data(), v.size());
+    double sum = 0.0;
+    int bins[8] = { 0 };
+    for (double x: v)
+      {
+        TEST_REQUIRE(x >= 0.0 && x < 1.0);
+        sum += x;
+        ++bins[int(x * 8)];
+      }
+    TEST_REQUIRE_APPROX(sum / double(v.size()), 0.5, 0.01);
+    for (int b: bins)
+      TEST_REQUIRE(b > 7800 && b < 8600);
+  }
+
+  void testRandBenchmark()
+  {
+    static rutz::prof p1("testprof/rand/legacy/fdraw", __FILE__, __LINE__);
+    static rutz::prof p2("testprof/rand/philox/fdraw", __FILE__, __LINE__);
+    static rutz::prof p3("testprof/rand/philox/fill", __FILE__, __LINE__);
+    static rutz::prof p4("testprof/rand/philox/fill-4threads", __FILE__, __LINE__);
+
+    const size_t N = 1000000;
+    std::vector<double> v(N);
+
+    {
+      rutz::trace t(p1, false);
+      rutz::urand u(1);
+      for (size_t i = 0; i < N; ++i)
+        v[i] = u.fdraw();
+    }
+
+    {
+      rutz::trace t(p2, false);
+      rutz::philox g(1);
+      for (size_t i = 0; i < N; ++i)
+        v[i] = g.fdraw();
+    }
+
+    {
+      rutz::trace t(p3, false);
+      rutz::philox g(1);
+      g.fill_fdraw(v.data(), N);
+    }
+
+    {
+      rutz::trace t(p4, false);
+      rutz::philox g(1);
+      g.fill_fdraw(v.data(), N, 4);
+    }
+  }
+}
+
+extern "C"
+int Randtest_Init(Tcl_Interp* interp)
+{
+GVX_TRACE("Randtest_Init");
+
+  return tcl::pkg::init
+    (interp, "Randtest", "4.0",
+     [](tcl::pkg* pkg) {
+      DEF_TEST(pkg, testPhiloxKnownAnswers);
+      DEF_TEST(pkg, testLegacySequence);
+      DEF_TEST(pkg, testPhiloxFill);
+      DEF_TEST(pkg, testPhiloxStreams);
+      DEF_TEST(pkg, testRandBenchmark);
+    });
+}
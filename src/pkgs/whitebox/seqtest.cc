@@ -0,0 +1,428 @@
+/** @file pkgs/whitebox/seqtest.cc tcl interface package for testing
+    and timing ElementContainer sequencing */
+
+///////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026-2026 Rob Peters
+// Rob Peters <https://github.com/rjpcal/>
+//
+// created: Mon Oct 19 17:02:15 2026
+//
+// --------------------------------------------------------------------
+//
+// This file is part of GroovX.
+//   [https://github.com/rjpcal/groovx]
+//
+// GroovX is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// GroovX is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GroovX; if not, write to the Free Software Foundation,
+// Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include "pkgs/whitebox/seqtest.h"
+
+#include "io/ioutil.h"
+#include "io/reader.h"
+#include "io/writer.h"
+
+#include "nub/log.h"
+#include "nub/objfactory.h"
+#include "nub/ref.h"
+
+#include "tcl/pkg.h"
+
+#include "tcl-gfx/toglet.h"
+
+#include "visx/elementcontainer.h"
+
+#include "rutz/error.h"
+#include "rutz/fstring.h"
+#include "rutz/iter.h"
+#include "rutz/rand.h"
+#include "rutz/unittest.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "rutz/trace.h"
+
+using nub::ref;
+
+namespace
+{
+  // A leaf element that does nothing when run, and that reports a
+  // tag as its trial type, so that tests can see the sequence order.
+  class TagElement : public Element
+  {
+  public:
+    static TagElement* make(int tag) { return new TagElement(tag); }
+    static TagElement* makeBlank() { return new TagElement(-1); }
+
+    virtual void read_from(io::reader& reader) override
+    { reader.read_value("tag", itsTag); }
+
+    virtual void write_to(io::writer& writer) const override
+    { writer.write_value("tag", itsTag); }
+
+    // The demangled name of a class in an anonymous namespace has
+    // spaces in it, which the ascii stream format can't handle.
+    virtual rutz::fstring obj_typename() const override
+    { return "SeqtestTagElement"; }
+
+    virtual const nub::soft_ref<Toglet>& getWidget() const override
+    { static nub::soft_ref<Toglet> w; return w; }
+
+    virtual int trialType() const override { return itsTag; }
+    virtual int lastResponse() const override { return -1; }
+    virtual rutz::fstring vxInfo() const override { return "tag"; }
+    virtual void vxRun(Element&) override {}
+    virtual void vxHalt() const override {}
+    virtual void vxReturn(ChildStatus) override {}
+    virtual void vxUndo() override {}
+    virtual void vxReset() override {}
+
+  private:
+    TagElement(int tag) : itsTag(tag) {}
+
+    int itsTag;
+  };
+
+  class TestContainer : public ElementContainer
+  {
+  public:
+    static TestContainer* make() { return new TestContainer; }
+
+    virtual const nub::soft_ref<Toglet>& getWidget() const override
+    { static nub::soft_ref<Toglet> w; return w; }
+
+    virtual void vxRun(Element&) override {}
+
+    // See TagElement::obj_typename().
+    virtual rutz::fstring obj_typename() const override
+    { return "SeqtestContainer"; }
+
+    bool isFinished() const { return itsFinished; }
+
+  protected:
+    virtual void vxAllChildrenFinished() override { itsFinished = true; }
+
+  private:
+    TestContainer() : itsFinished(false) {}
+
+    bool itsFinished;
+  };
+
+  ref<TestContainer> makeContainer(int n)
+  {
+    ref<TestContainer> c(TestContainer::make());
+    for (int i = 0; i < n; ++i)
+      c->addElement(ref<Element>(TagElement::make(i)));
+    return c;
+  }
+
+  std::vector<int> tags(const ElementContainer& c)
+  {
+    std::vector<int> result;
+    for (rutz::fwd_iter<const ref<Element> > e(c.getElements());
+         !e.at_end(); e.next())
+      result.push_back((*e)->trialType());
+    return result;
+  }
+
+  // Run c to completion, returning each child with status s if
+  // pick(n) is true for the n'th return, and with OK otherwise.
+  template <class Pred>
+  unsigned int runAll(ElementContainer& c, Element::ChildStatus s, Pred pick)
+  {
+    unsigned int n = 0;
+    while (!c.isComplete())
+      c.vxReturn(pick(n++) ? s : Element::ChildStatus::OK);
+    return n;
+  }
+
+  void testShuffle()
+  {
+    // a given seed must give the same order that std::random_shuffle
+    // gave with a rutz::rng of that seed
+    for (unsigned long seed: { 0ul, 1ul, 4321ul })
+      {
+        ref<TestContainer> c = makeContainer(50);
+        c->shuffle(seed);
+
+        std::vector<int> expected(50);
+        for (int i = 0; i < 50; ++i) expected[size_t(i)] = i;
+        rutz::rng generator(seed);
+        std::random_shuffle(expected.begin(), expected.end(), generator);
+
+        TEST_REQUIRE(tags(*c) == expected);
+        TEST_REQUIRE_EQ(c->getRandSeed(), seed);
+      }
+  }
+
+  void testRepeat()
+  {
+    nub::logging::copy_to_stdout(false);
+
+    ref<TestContainer> c = makeContainer(20);
+    c->shuffle(7);
+    const unsigned int changes = c->numSequenceChanges();
+
+    // repeat every third trial
+    const unsigned int nreturns =
+      runAll(*c, Element::ChildStatus::REPEAT,
+             [](unsigned int n) { return n % 3 == 0 && n < 30; });
+
+    nub::logging::copy_to_stdout(true);
+
+    TEST_REQUIRE(c->isFinished());
+    TEST_REQUIRE_EQ(c->numElements(), size_t(nreturns));
+    TEST_REQUIRE(c->numSequenceChanges() > changes);
+
+    // every original element ran at least once, and the repeats are
+    // extra copies of elements that had already run
+    std::vector<int> seq = tags(*c);
+    std::vector<int> counts(20, 0);
+    for (int t: seq) ++counts[size_t(t)];
+    for (int n: counts) TEST_REQUIRE(n >= 1);
+    TEST_REQUIRE_EQ(seq.size(), size_t(20 + 10));
+
+    // the same seed gives the same session
+    ref<TestContainer> c2 = makeContainer(20);
+    c2->shuffle(7);
+    nub::logging::copy_to_stdout(false);
+    runAll(*c2, Element::ChildStatus::REPEAT,
+           [](unsigned int n) { return n % 3 == 0 && n < 30; });
+    nub::logging::copy_to_stdout(true);
+    TEST_REQUIRE(tags(*c2) == seq);
+  }
+
+  void testAbort()
+  {
+    nub::logging::copy_to_stdout(false);
+
+    ref<TestContainer> c = makeContainer(10);
+
+    // the first trial is aborted, so it goes to the back of the
+    // sequence and the rest keep their order
+    c->vxReturn(Element::ChildStatus::ABORTED);
+    TEST_REQUIRE_EQ(c->currentElement()->trialType(), 1);
+    TEST_REQUIRE_EQ(c->numCompleted(), 0u);
+    {
+      const std::vector<int> seq = tags(*c);
+      for (int i = 0; i < 10; ++i)
+        TEST_REQUIRE_EQ(seq[size_t(i)], (i + 1) % 10);
+    }
+
+    runAll(*c, Element::ChildStatus::ABORTED,
+           [](unsigned int n) { return n % 4 == 1; });
+
+    nub::logging::copy_to_stdout(true);
+
+    TEST_REQUIRE(c->isFinished());
+    TEST_REQUIRE_EQ(c->numElements(), size_t(10));
+
+    std::vector<int> seq = tags(*c);
+    std::sort(seq.begin(), seq.end());
+    for (int i = 0; i < 10; ++i)
+      TEST_REQUIRE_EQ(seq[size_t(i)], i);
+
+    // aborting the last remaining trial just runs it again
+    ref<TestContainer> c2 = makeContainer(1);
+    nub::logging::copy_to_stdout(false);
+    c2->vxReturn(Element::ChildStatus::ABORTED);
+    nub::logging::copy_to_stdout(true);
+    TEST_REQUIRE(!c2->isComplete());
+    TEST_REQUIRE_EQ(c2->currentElement()->trialType(), 0);
+  }
+
+  void testResume()
+  {
+    // so that the elements can be read back in
+    nub::obj_factory::instance().register_creator(&TagElement::makeBlank,
+                                                  "SeqtestTagElement");
+
+    auto pick = [](unsigned int n) { return n % 2 == 0; };
+
+    nub::logging::copy_to_stdout(false);
+
+    ref<TestContainer> c = makeContainer(20);
+    c->shuffle(11);
+    for (unsigned int n = 0; n < 6; ++n)
+      c->vxReturn(pick(n) ? Element::ChildStatus::REPEAT
+                  : Element::ChildStatus::OK);
+
+    // a saved session picks up the random stream where it left off,
+    // so resuming it gives the same sequence as running straight on
+    const rutz::fstring saved = io::write_asw(c);
+
+    ref<TestContainer> c2(TestContainer::make());
+    io::read_asw(c2, saved.c_str());
+    TEST_REQUIRE_EQ(c2->numCompleted(), c->numCompleted());
+    TEST_REQUIRE(tags(*c2) == tags(*c));
+
+    for (unsigned int n = 6; n < 20; ++n)
+      {
+        c->vxReturn(pick(n) ? Element::ChildStatus::REPEAT
+                    : Element::ChildStatus::OK);
+        c2->vxReturn(pick(n) ? Element::ChildStatus::REPEAT
+                     : Element::ChildStatus::OK);
+      }
+
+    nub::logging::copy_to_stdout(true);
+
+    TEST_REQUIRE(tags(*c2) == tags(*c));
+  }
+
+  void testSequenceEdits()
+  {
+    // replaying each lastSequenceEdit() on a copy of the original
+    // sequence, as the autosave journal does, keeps the copy in step
+    ref<TestContainer> c = makeContainer(12);
+    ref<TestContainer> mirror = makeContainer(12);
+    c->shuffle(5);
+    mirror->shuffle(5);
+
+    nub::logging::copy_to_stdout(false);
+
+    auto status = [](unsigned int n)
+      {
+        return (n % 5 == 1 && n < 30) ? Element::ChildStatus::ABORTED
+          : (n % 3 == 0 && n < 30) ? Element::ChildStatus::REPEAT
+          : Element::ChildStatus::OK;
+      };
+
+    unsigned int n = 0;
+    for (; n < 7; ++n)
+      {
+        const unsigned int changes = c->numSequenceChanges();
+        c->vxReturn(status(n));
+
+        if (c->numSequenceChanges() != changes)
+          {
+            TEST_REQUIRE_EQ(c->numSequenceChanges(), changes + 1);
+            const ElementContainer::SequenceEdit e = c->lastSequenceEdit();
+            TEST_REQUIRE(e.kind != ElementContainer::SequenceEdit::NONE);
+            mirror->applySequenceEdit(e);
+          }
+        mirror->setSequencePos(c->numCompleted());
+
+        TEST_REQUIRE(tags(*mirror) == tags(*c));
+      }
+
+    // applying the edits doesn't draw from the generator...
+    TEST_REQUIRE(mirror->numRandDraws() < c->numRandDraws());
+
+    // ...so it has to be restored separately; after that, carrying on
+    // from the mirror gives the same sequence as the original run
+    mirror->setRandDraws(c->numRandDraws());
+    TEST_REQUIRE_EQ(mirror->numRandDraws(), c->numRandDraws());
+
+    for (; !c->isComplete(); ++n)
+      {
+        c->vxReturn(status(n));
+        mirror->vxReturn(status(n));
+      }
+
+    nub::logging::copy_to_stdout(true);
+
+    TEST_REQUIRE(mirror->isComplete());
+    TEST_REQUIRE(tags(*mirror) == tags(*c));
+
+    // going backwards restarts the generator from the seed
+    ref<TestContainer> c2 = makeContainer(12);
+    ref<TestContainer> c3 = makeContainer(12);
+    c2->shuffle(5);
+    c3->shuffle(5);
+    c2->setRandDraws(c->numRandDraws());
+    c2->setRandDraws(3);
+    c3->setRandDraws(3);
+    TEST_REQUIRE_EQ(c2->numRandDraws(), 3ul);
+
+    nub::logging::copy_to_stdout(false);
+    c2->vxReturn(Element::ChildStatus::REPEAT);
+    c3->vxReturn(Element::ChildStatus::REPEAT);
+    nub::logging::copy_to_stdout(true);
+
+    TEST_REQUIRE_EQ(c2->lastSequenceEdit().to, c3->lastSequenceEdit().to);
+    TEST_REQUIRE(tags(*c2) == tags(*c3));
+
+    // a shuffle isn't a single edit
+    c->shuffle(6);
+    TEST_REQUIRE(c->lastSequenceEdit().kind ==
+                 ElementContainer::SequenceEdit::NONE);
+
+    // out-of-range edits are rejected
+    const ElementContainer::SequenceEdit bad =
+      { ElementContainer::SequenceEdit::RETRY, 1000, 0 };
+    bool caught = false;
+    try { c->applySequenceEdit(bad); }
+    catch (rutz::error&) { caught = true; }
+    TEST_REQUIRE(caught);
+  }
+
+  void testSequenceBenchmark()
+  {
+    static rutz::prof p1("testprof/seq/shuffle", __FILE__, __LINE__);
+    static rutz::prof p2("testprof/seq/run-repeat", __FILE__, __LINE__);
+    static rutz::prof p3("testprof/seq/run-abort", __FILE__, __LINE__);
+
+    const int N = 100000;
+
+    nub::logging::copy_to_stdout(false);
+
+    {
+      ref<TestContainer> c = makeContainer(N);
+      rutz::trace t(p1, false);
+      c->shuffle(1);
+    }
+
+    {
+      // one trial in ten is repeated (as if the response was invalid)
+      ref<TestContainer> c = makeContainer(N);
+      c->shuffle(2);
+      rutz::trace t(p2, false);
+      runAll(*c, Element::ChildStatus::REPEAT,
+             [](unsigned int n) { return n % 10 == 0; });
+      TEST_REQUIRE(c->numCompleted() > unsigned(N + N/10));
+    }
+
+    {
+      // one trial in ten is aborted (as if it timed out)
+      ref<TestContainer> c = makeContainer(N);
+      c->shuffle(3);
+      rutz::trace t(p3, false);
+      runAll(*c, Element::ChildStatus::ABORTED,
+             [](unsigned int n) { return n % 10 == 0; });
+      TEST_REQUIRE_EQ(c->numCompleted(), unsigned(N));
+    }
+
+    nub::logging::copy_to_stdout(true);
+  }
+}
+
+extern "C"
+int Seqtest_Init(Tcl_Interp* interp)
+{
+GVX_TRACE("Seqtest_Init");
+
+  return tcl::pkg::init
+    (interp, "Seqtest", "4.0",
+     [](tcl::pkg* pkg) {
+      DEF_TEST(pkg, testShuffle);
+      DEF_TEST(pkg, testRepeat);
+      DEF_TEST(pkg, testAbort);
+      DEF_TEST(pkg, testResume);
+      DEF_TEST(pkg, testSequenceEdits);
+      DEF_TEST(pkg, testSequenceBenchmark);
+    });
+}
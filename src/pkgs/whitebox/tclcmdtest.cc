@@ -0,0 +1,204 @@
+/** @file pkgs/whitebox/tclcmdtest.cc tcl interface package for testing
+    and timing tcl::command dispatch */
+
+///////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026-2026 Rob Peters
+// Rob Peters <https://github.com/rjpcal/>
+//
+// created: Mon Oct 19 12:06:31 2026
+//
+// --------------------------------------------------------------------
+//
+// This file is part of GroovX.
+//   [https://github.com/rjpcal/groovx]
+//
+// GroovX is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// GroovX is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GroovX; if not, write to the Free Software Foundation,
+// Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include "pkgs/whitebox/tclcmdtest.h"
+
+#include "tcl/commandgroup.h"
+#include "tcl/interp.h"
+#include "tcl/makecmd.h"
+#include "tcl/pkg.h"
+
+#include "rutz/error.h"
+#include "rutz/fstring.h"
+#include "rutz/unittest.h"
+
+#include <cstring>
+#include <tcl.h>
+
+#include "rutz/trace.h"
+#include "rutz/debug.h"
+GVX_DBG_REGISTER
+
+namespace
+{
+  Tcl_Interp* g_interp = nullptr;
+
+  int g_value = 42;
+
+  int get_value() { return g_value; }
+
+  void set_value(int v) { g_value = v; }
+
+  double add3(int a, double b, long c) { return a + b + c; }
+
+  int throws_error(int) { throw rutz::error("fast path error", SRC_POS); }
+
+  bool uses_fast_path(tcl::interpreter& interp, const char* name)
+  {
+    tcl::command_group* g = tcl::command_group::lookup(interp, name);
+    return g != nullptr && g->fast_target() != nullptr;
+  }
+
+  void testFastPathResults()
+  {
+    tcl::interpreter interp(g_interp);
+
+    tcl::make_command(interp, &get_value, "::Tclcmdtest::getValue",
+                      "", SRC_POS);
+    tcl::make_command(interp, &set_value, "::Tclcmdtest::setValue",
+                      "value", SRC_POS);
+    tcl::make_command(interp, &add3, "::Tclcmdtest::add3",
+                      "a b c", SRC_POS);
+
+    TEST_REQUIRE(uses_fast_path(interp, "::Tclcmdtest::getValue"));
+    TEST_REQUIRE(uses_fast_path(interp, "::Tclcmdtest::setValue"));
+    TEST_REQUIRE(uses_fast_path(interp, "::Tclcmdtest::add3"));
+
+    interp.eval("::Tclcmdtest::setValue 17");
+    TEST_REQUIRE_EQ(g_value, 17);
+
+    interp.eval("::Tclcmdtest::getValue");
+    TEST_REQUIRE_EQ(interp.get_result<int>(), 17);
+
+    interp.eval("::Tclcmdtest::add3 1 2.5 3");
+    TEST_REQUIRE_EQ(interp.get_result<double>(), 6.5);
+
+    g_value = 42;
+  }
+
+  void testFastPathErrors()
+  {
+    tcl::interpreter interp(g_interp);
+
+    tcl::make_command(interp, &throws_error, "::Tclcmdtest::throwsError",
+                      "x", SRC_POS);
+
+    // wrong # args goes through the generic usage message
+    TEST_REQUIRE(!interp.eval("::Tclcmdtest::add3 1 2",
+                              tcl::error_strategy::IGNORE));
+    TEST_REQUIRE(std::strstr(interp.get_result<const char*>(),
+                             "wrong # args") != nullptr);
+
+    // argument conversion errors
+    TEST_REQUIRE(!interp.eval("::Tclcmdtest::add3 1 2 notanumber",
+                              tcl::error_strategy::IGNORE));
+
+    // exceptions thrown by the function itself
+    TEST_REQUIRE(!interp.eval("::Tclcmdtest::throwsError 0",
+                              tcl::error_strategy::IGNORE));
+    TEST_REQUIRE(std::strstr(interp.get_result<const char*>(),
+                             "fast path error") != nullptr);
+
+    interp.reset_result();
+  }
+
+  void testOverloadDropsFastPath()
+  {
+    tcl::interpreter interp(g_interp);
+
+    tcl::make_command(interp, &get_value, "::Tclcmdtest::value",
+                      "", SRC_POS);
+    TEST_REQUIRE(uses_fast_path(interp, "::Tclcmdtest::value"));
+
+    tcl::make_command(interp, &set_value, "::Tclcmdtest::value",
+                      "value", SRC_POS);
+    TEST_REQUIRE(!uses_fast_path(interp, "::Tclcmdtest::value"));
+
+    interp.eval("::Tclcmdtest::value 5");
+    interp.eval("::Tclcmdtest::value");
+    TEST_REQUIRE_EQ(interp.get_result<int>(), 5);
+
+    g_value = 42;
+  }
+
+  void testFastPathBenchmark()
+  {
+    static rutz::prof p1("testprof/tclcmd/generic/getter", __FILE__, __LINE__);
+    static rutz::prof p2("testprof/tclcmd/fast/getter", __FILE__, __LINE__);
+
+    tcl::interpreter interp(g_interp);
+
+    // the generic path is what make_command() used to build: a
+    // std::function callback, arg_dispatcher and call_context
+    tcl::command_group::make(interp, tcl::build_tcl_callable(&get_value),
+                             "::Tclcmdtest::genericGetter", "",
+                             tcl::arg_spec(1, 1, false), SRC_POS);
+    tcl::make_command(interp, &get_value, "::Tclcmdtest::fastGetter",
+                      "", SRC_POS);
+
+    const int N = 1000000;
+
+    tcl::obj generic_cmd = tcl::convert_from("::Tclcmdtest::genericGetter");
+    tcl::obj fast_cmd = tcl::convert_from("::Tclcmdtest::fastGetter");
+
+    long sum1 = 0;
+    {
+      rutz::trace t(p1, false);
+      Tcl_Obj* objv[1] = { generic_cmd.get() };
+      for (int i = 0; i < N; ++i)
+        {
+          Tcl_EvalObjv(interp.intp(), 1, objv, 0);
+          sum1 += tcl::convert_to<int>(Tcl_GetObjResult(interp.intp()));
+        }
+    }
+
+    long sum2 = 0;
+    {
+      rutz::trace t(p2, false);
+      Tcl_Obj* objv[1] = { fast_cmd.get() };
+      for (int i = 0; i < N; ++i)
+        {
+          Tcl_EvalObjv(interp.intp(), 1, objv, 0);
+          sum2 += tcl::convert_to<int>(Tcl_GetObjResult(interp.intp()));
+        }
+    }
+
+    TEST_REQUIRE(sum1 == long(N) * g_value);
+    TEST_REQUIRE(sum2 == sum1);
+  }
+}
+
+extern "C"
+int Tclcmdtest_Init(Tcl_Interp* interp)
+{
+GVX_TRACE("Tclcmdtest_Init");
+
+  g_interp = interp;
+
+  return tcl::pkg::init
+    (interp, "Tclcmdtest", "4.0",
+     [](tcl::pkg* pkg) {
+      DEF_TEST(pkg, testFastPathResults);
+      DEF_TEST(pkg, testFastPathErrors);
+      DEF_TEST(pkg, testOverloadDropsFastPath);
+      DEF_TEST(pkg, testFastPathBenchmark);
+    });
+}
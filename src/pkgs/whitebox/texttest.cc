@@ -0,0 +1,243 @@
+/** @file pkgs/whitebox/texttest.cc tcl interface package for testing
+    the text caches, glyph atlas and vector font strokes */
+
+///////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026-2026 Rob Peters
+// Rob Peters <https://github.com/rjpcal/>
+//
+// created: Mon Oct 19 18:04:37 2026
+//
+// --------------------------------------------------------------------
+//
+// This file is part of GroovX.
+//   [https://github.com/rjpcal/groovx]
+//
+// GroovX is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// GroovX is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GroovX; if not, write to the Free Software Foundation,
+// Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include "pkgs/whitebox/texttest.h"
+
+#include "gfx/glyphatlas.h"
+#include "gfx/gxvectorfont.h"
+#include "gfx/pscanvas.h"
+#include "gfx/textcache.h"
+
+#include "tcl/pkg.h"
+
+#include "rutz/sfmt.h"
+#include "rutz/unittest.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include "rutz/trace.h"
+#include "rutz/debug.h"
+GVX_DBG_REGISTER
+
+namespace
+{
+  void testTextCacheHits()
+  {
+    Gfx::TextCache<int> cache(3);
+
+    TEST_REQUIRE(cache.find("a") == nullptr);
+    TEST_REQUIRE_EQ(cache.misses(), size_t(1));
+
+    TEST_REQUIRE_EQ(cache.insert("a", 1), 1);
+    TEST_REQUIRE(cache.find("a") != nullptr);
+    TEST_REQUIRE_EQ(*cache.find("a"), 1);
+    TEST_REQUIRE_EQ(cache.hits(), size_t(2));
+    TEST_REQUIRE_EQ(cache.misses(), size_t(1));
+
+    // re-inserting replaces the entry
+    cache.insert("a", 2);
+    TEST_REQUIRE_EQ(*cache.find("a"), 2);
+    TEST_REQUIRE_EQ(cache.size(), size_t(1));
+  }
+
+  void testTextCacheEviction()
+  {
+    Gfx::TextCache<int> cache(3);
+
+    cache.insert("a", 1);
+    cache.insert("b", 2);
+    cache.insert("c", 3);
+    TEST_REQUIRE_EQ(cache.size(), size_t(3));
+
+    // a full cache is emptied before the next insert
+    cache.insert("d", 4);
+    TEST_REQUIRE_EQ(cache.size(), size_t(1));
+    TEST_REQUIRE(cache.find("a") == nullptr);
+    TEST_REQUIRE(cache.find("c") == nullptr);
+    TEST_REQUIRE_EQ(*cache.find("d"), 4);
+
+    cache.clear();
+    TEST_REQUIRE_EQ(cache.size(), size_t(0));
+    TEST_REQUIRE(cache.find("d") == nullptr);
+  }
+
+  std::vector<unsigned char> ink(int w, int h)
+  {
+    return std::vector<unsigned char>(size_t(w * h), 1);
+  }
+
+  void testGlyphAtlasPacking()
+  {
+    Gfx::GlyphAtlas atlas(10);
+
+    atlas.addGlyph('B', 4, 2, 0, 0, 5, &ink(4, 2)[0]);
+    atlas.addGlyph('A', 3, 5, 0, 0, 4, &ink(3, 5)[0]);
+
+    // one shelf, as tall as the tallest glyph, plus a one-pixel gap
+    // on either side
+    TEST_REQUIRE_EQ(atlas.width(), 256);
+    TEST_REQUIRE_EQ(atlas.height(), 8);
+
+    const Gfx::GlyphAtlas::Layout& ab = atlas.layout("AB");
+    TEST_REQUIRE_EQ(ab.verts.size(), size_t(32));
+
+    // the taller glyph is packed first; each vertex is (s, t, x, y)
+    TEST_REQUIRE_EQ(ab.verts[0], 1.0f / 256);
+    TEST_REQUIRE_EQ(ab.verts[16], 5.0f / 256);
+    TEST_REQUIRE_EQ(ab.verts[18], 4.0f);
+
+    TEST_REQUIRE_EQ(ab.bounds.left(), 0);
+    TEST_REQUIRE_EQ(ab.bounds.right(), 8);
+    TEST_REQUIRE_EQ(ab.bounds.bottom(), 0);
+    TEST_REQUIRE_EQ(ab.bounds.top(), 5);
+
+    // layouts are cached per string
+    TEST_REQUIRE(&atlas.layout("AB") == &ab);
+
+    // lines are line_height pixels apart
+    const Gfx::GlyphAtlas::Layout& two = atlas.layout("A\nA");
+    TEST_REQUIRE_EQ(two.verts.size(), size_t(32));
+    TEST_REQUIRE_EQ(two.bounds.bottom(), -10);
+
+    // an unknown glyph neither draws nor advances, until it is added
+    TEST_REQUIRE_EQ(atlas.layout("AZ").verts.size(), size_t(16));
+    atlas.addGlyph('Z', 300, 1, 0, 0, 300, &ink(300, 1)[0]);
+    TEST_REQUIRE_EQ(atlas.layout("AZ").verts.size(), size_t(32));
+
+    // a glyph wider than the default texture widens it
+    TEST_REQUIRE_EQ(atlas.width(), 512);
+  }
+
+  void testVectorFontSegments()
+  {
+    GxVectorFont font;
+
+    TEST_REQUIRE(font.segmentsOf("").empty());
+
+    const std::vector<float> a = font.segmentsOf("A");
+    TEST_REQUIRE(!a.empty());
+    TEST_REQUIRE_EQ(a.size() % 4, size_t(0));
+
+    // results are cached per string
+    TEST_REQUIRE(&font.segmentsOf("A") == &font.segmentsOf("A"));
+
+    // each glyph advances 5 units
+    const std::vector<float>& aa = font.segmentsOf("AA");
+    TEST_REQUIRE_EQ(aa.size(), 2 * a.size());
+    for (size_t i = 0; i < a.size(); i += 2)
+      {
+        TEST_REQUIRE_EQ(aa[a.size() + i], a[i] + 5.0f);
+        TEST_REQUIRE_EQ(aa[a.size() + i + 1], a[i + 1]);
+      }
+
+    // and lines are vectorHeight() apart
+    const std::vector<float>& a_a = font.segmentsOf("A\nA");
+    TEST_REQUIRE_EQ(a_a.size(), 2 * a.size());
+    for (size_t i = 0; i < a.size(); i += 2)
+      {
+        TEST_REQUIRE_EQ(a_a[a.size() + i], a[i]);
+        TEST_REQUIRE_EQ(a_a[a.size() + i + 1],
+                        a[i + 1] - float(font.vectorHeight()));
+      }
+  }
+
+  // Draw \a text to a fresh PostScript file, and return the file
+  // contents along with the number of bytes labeled as "text".
+  std::string vectorTextPS(const GxVectorFont& font, const char* text,
+                           size_t& nbytes)
+  {
+    const std::string fname =
+      rutz::sfmt("/tmp/texttest.%d.eps", int(getpid())).c_str();
+
+    nbytes = 0;
+    {
+      Gfx::PSCanvas canvas(fname.c_str());
+      {
+        Gfx::MatrixSaver msaver(canvas, "text");
+        font.drawText(text, canvas);
+      }
+      for (const auto& p: canvas.bytesPerLabel())
+        if (p.first == "text")
+          nbytes = p.second;
+    }
+
+    std::ifstream ifs(fname.c_str());
+    std::ostringstream oss;
+    oss << ifs.rdbuf();
+    remove(fname.c_str());
+    return oss.str();
+  }
+
+  unsigned int linetoCount(const std::string& ps)
+  {
+    unsigned int n = 0;
+    for (size_t pos = ps.find(" l\n"); pos != std::string::npos;
+         pos = ps.find(" l\n", pos + 1))
+      ++n;
+    return n;
+  }
+
+  void testVectorTextPS()
+  {
+    GxVectorFont font;
+
+    size_t n1 = 0, n4 = 0;
+    const std::string ps1 = vectorTextPS(font, "A", n1);
+    const std::string ps4 = vectorTextPS(font, "AAAA", n4);
+
+    // PSCanvas::drawVectorText() strokes each segment of segmentsOf()
+    TEST_REQUIRE(linetoCount(ps1) > 0);
+    TEST_REQUIRE_EQ(linetoCount(ps4), 4 * linetoCount(ps1));
+    TEST_REQUIRE(n1 > 0);
+    TEST_REQUIRE(n4 > 3 * n1);
+  }
+}
+
+extern "C"
+int Texttest_Init(Tcl_Interp* interp)
+{
+GVX_TRACE("Texttest_Init");
+
+  return tcl::pkg::init
+    (interp, "Texttest", "4.0",
+     [](tcl::pkg* pkg) {
+      DEF_TEST(pkg, testTextCacheHits);
+      DEF_TEST(pkg, testTextCacheEviction);
+      DEF_TEST(pkg, testGlyphAtlasPacking);
+      DEF_TEST(pkg, testVectorFontSegments);
+      DEF_TEST(pkg, testVectorTextPS);
+    });
+}
@@ -0,0 +1,209 @@
+/** @file pkgs/whitebox/tracetest.cc tcl interface package for testing
+    and timing rutz::trace recording */
+
+///////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026-2026 Rob Peters
+// Rob Peters <https://github.com/rjpcal/>
+//
+// created: Mon Oct 19 13:58:14 2026
+//
+// --------------------------------------------------------------------
+//
+// This file is part of GroovX.
+//   [https://github.com/rjpcal/groovx]
+//
+// GroovX is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// GroovX is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GroovX; if not, write to the Free Software Foundation,
+// Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include "pkgs/whitebox/tracetest.h"
+
+#include "tcl/pkg.h"
+
+#include "rutz/prof.h"
+#include "rutz/sfmt.h"
+#include "rutz/tracerecorder.h"
+#include "rutz/unittest.h"
+
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+#include "rutz/trace.h"
+#include "rutz/debug.h"
+GVX_DBG_REGISTER
+
+namespace
+{
+  volatile int g_sink = 0;
+
+  void __attribute__((noinline)) traced_func(int i)
+  {
+GVX_TRACE("tracetest::traced_func");
+    g_sink += i;
+  }
+
+  void __attribute__((noinline)) untraced_func(int i)
+  {
+    g_sink += i;
+  }
+
+  void traced_loop(int n)
+  {
+    for (int i = 0; i < n; ++i)
+      traced_func(i);
+  }
+
+  std::string temp_name(const char* suffix)
+  {
+    return rutz::sfmt("/tmp/tracetest.%d.%s", int(getpid()), suffix).c_str();
+  }
+
+  unsigned int count_of(const std::string& text, const std::string& pat)
+  {
+    unsigned int n = 0;
+    for (size_t pos = text.find(pat); pos != std::string::npos;
+         pos = text.find(pat, pos + pat.length()))
+      ++n;
+    return n;
+  }
+
+  void testRecorderRoundTrip()
+  {
+    const std::string fname = temp_name("trace");
+
+    const int N = 10000;
+
+    rutz::trace_recorder::start(fname.c_str());
+    TEST_REQUIRE(rutz::trace_recorder::is_recording());
+
+    traced_loop(N);
+    std::thread other(&traced_loop, N);
+    other.join();
+
+    rutz::trace_recorder::stop();
+    TEST_REQUIRE(!rutz::trace_recorder::is_recording());
+
+    TEST_REQUIRE(rutz::trace_recorder::num_dropped() == 0);
+    TEST_REQUIRE(rutz::trace_recorder::num_written() >= 4ull * N);
+
+    std::ostringstream oss;
+    rutz::trace_recorder::write_chrome_trace(fname.c_str(), oss);
+    remove(fname.c_str());
+
+    const std::string json = oss.str();
+
+    TEST_REQUIRE_EQ(count_of(json, "{\"name\":\"tracetest::traced_func\",\"ph\":\"B\""),
+                    2u * N);
+    TEST_REQUIRE_EQ(count_of(json, "{\"name\":\"tracetest::traced_func\",\"ph\":\"E\""),
+                    2u * N);
+    TEST_REQUIRE_EQ(count_of(json, "\"name\":\"thread_name\""), 2u);
+  }
+
+  void testRecorderTimingMode()
+  {
+    // While recording, traces must still time against the configured
+    // clock: a sleep costs (nearly) no rusage, but its full wall time
+    static rutz::prof p1("testprof/trace/sleep-rusage", __FILE__, __LINE__);
+    static rutz::prof p2("testprof/trace/sleep-wallclock", __FILE__, __LINE__);
+
+    const rutz::prof::timing_mode old_mode = rutz::prof::get_timing_mode();
+
+    const std::string fname = temp_name("trace");
+    rutz::trace_recorder::start(fname.c_str());
+
+    rutz::prof::set_timing_mode(rutz::prof::timing_mode::RUSAGE);
+    p1.reset();
+    {
+      rutz::trace t(p1, false);
+      usleep(200000);
+    }
+
+    rutz::prof::set_timing_mode(rutz::prof::timing_mode::WALLCLOCK);
+    p2.reset();
+    {
+      rutz::trace t(p2, false);
+      usleep(200000);
+    }
+
+    rutz::trace_recorder::stop();
+    remove(fname.c_str());
+
+    rutz::prof::set_timing_mode(old_mode);
+
+    TEST_REQUIRE_EQ(p1.count(), 1u);
+    TEST_REQUIRE_EQ(p2.count(), 1u);
+    TEST_REQUIRE(p1.total_time() < 100000.0);
+    TEST_REQUIRE(p2.total_time() >= 150000.0);
+  }
+
+  void testRecorderBenchmark()
+  {
+    static rutz::prof p1("testprof/trace/untraced", __FILE__, __LINE__);
+    static rutz::prof p2("testprof/trace/rusage", __FILE__, __LINE__);
+    static rutz::prof p3("testprof/trace/wallclock", __FILE__, __LINE__);
+    static rutz::prof p4("testprof/trace/recording", __FILE__, __LINE__);
+
+    const int N = 1000000;
+
+    const rutz::prof::timing_mode old_mode = rutz::prof::get_timing_mode();
+
+    {
+      rutz::trace t(p1, false);
+      for (int i = 0; i < N; ++i)
+        untraced_func(i);
+    }
+
+    rutz::prof::set_timing_mode(rutz::prof::timing_mode::RUSAGE);
+    {
+      rutz::trace t(p2, false);
+      traced_loop(N);
+    }
+
+    rutz::prof::set_timing_mode(rutz::prof::timing_mode::WALLCLOCK);
+    {
+      rutz::trace t(p3, false);
+      traced_loop(N);
+    }
+
+    const std::string fname = temp_name("trace");
+    rutz::trace_recorder::start(fname.c_str());
+    {
+      rutz::trace t(p4, false);
+      traced_loop(N);
+    }
+    rutz::trace_recorder::stop();
+    remove(fname.c_str());
+
+    rutz::prof::set_timing_mode(old_mode);
+  }
+}
+
+extern "C"
+int Tracetest_Init(Tcl_Interp* interp)
+{
+GVX_TRACE("Tracetest_Init");
+
+  return tcl::pkg::init
+    (interp, "Tracetest", "4.0",
+     [](tcl::pkg* pkg) {
+      DEF_TEST(pkg, testRecorderRoundTrip);
+      DEF_TEST(pkg, testRecorderTimingMode);
+      DEF_TEST(pkg, testRecorderBenchmark);
+    });
+}
@@ -0,0 +1,111 @@
+/** @file rutz/ascii85.cc ASCII85 (base-85) encoding */
+
+///////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026-2026 Rob Peters
+// Rob Peters <https://github.com/rjpcal/>
+//
+// created: Mon Oct 19 14:21:07 2026
+//
+// --------------------------------------------------------------------
+//
+// This file is part of GroovX.
+//   [https://github.com/rjpcal/groovx]
+//
+// GroovX is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// GroovX is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GroovX; if not, write to the Free Software Foundation,
+// Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include "rutz/ascii85.h"
+
+#include <cstdint> // for uint32_t
+
+#include "rutz/trace.h"
+
+std::string rutz::ascii85_encode(const unsigned char* src,
+                                 size_t src_len,
+                                 unsigned int line_width)
+{
+GVX_TRACE("rutz::ascii85_encode");
+
+  std::string result;
+
+  // five output chars for every four input bytes, plus newlines and
+  // the "~>" terminator
+  size_t reserve_size = ((src_len+3)/4) * 5 + 3;
+  if (line_width > 0)
+    reserve_size += reserve_size/line_width + 1;
+  result.reserve(reserve_size);
+
+  unsigned int col = 0;
+
+  auto put = [&](char c)
+    {
+      result += c;
+      if (line_width > 0 && ++col == line_width)
+        {
+          result += '\n';
+          col = 0;
+        }
+    };
+
+  size_t i = 0;
+
+  for (; i + 4 <= src_len; i += 4)
+    {
+      const uint32_t v =
+        (uint32_t(src[i]) << 24) | (uint32_t(src[i+1]) << 16)
+        | (uint32_t(src[i+2]) << 8) | uint32_t(src[i+3]);
+
+      if (v == 0)
+        {
+          put('z');
+          continue;
+        }
+
+      char enc5[5];
+      uint32_t x = v;
+      for (int k = 4; k >= 0; --k)
+        {
+          enc5[k] = char('!' + x % 85);
+          x /= 85;
+        }
+      for (int k = 0; k < 5; ++k)
+        put(enc5[k]);
+    }
+
+  // A final partial group of n bytes is zero-padded, encoded, and
+  // written as its first n+1 chars (never as 'z').
+  const size_t n = src_len - i;
+  if (n > 0)
+    {
+      uint32_t v = 0;
+      for (size_t k = 0; k < 4; ++k)
+        v = (v << 8) | (k < n ? uint32_t(src[i+k]) : 0u);
+
+      char enc5[5];
+      for (int k = 4; k >= 0; --k)
+        {
+          enc5[k] = char('!' + v % 85);
+          v /= 85;
+        }
+      for (size_t k = 0; k < n+1; ++k)
+        put(enc5[k]);
+    }
+
+  result += "~>";
+
+  return result;
+}
@@ -0,0 +1,50 @@
+/** @file rutz/ascii85.h ASCII85 (base-85) encoding, as used by the
+    PostScript ASCII85Decode filter */
+
+///////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026-2026 Rob Peters
+// Rob Peters <https://github.com/rjpcal/>
+//
+// created: Mon Oct 19 14:21:07 2026
+//
+// --------------------------------------------------------------------
+//
+// This file is part of GroovX.
+//   [https://github.com/rjpcal/groovx]
+//
+// GroovX is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// GroovX is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GroovX; if not, write to the Free Software Foundation,
+// Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef GROOVX_RUTZ_ASCII85_H_UTC20261019142107_DEFINED
+#define GROOVX_RUTZ_ASCII85_H_UTC20261019142107_DEFINED
+
+#include <cstddef>
+#include <string>
+
+namespace rutz
+{
+  /// Encode \a src_len bytes from \a src in ASCII85.
+  /** Groups of four zero bytes are written as 'z', and the result is
+      terminated with the "~>" end-of-data marker. If line_width is
+      non-zero, a newline is inserted after every line_width output
+      characters. */
+  std::string ascii85_encode(const unsigned char* src,
+                             size_t src_len,
+                             unsigned int line_width = 0);
+}
+
+#endif // !GROOVX_RUTZ_ASCII85_H_UTC20261019142107_DEFINED
@@ -1,5 +1,5 @@
 /** @file rutz/assocarray.cc generic associative arrays, implemented as
-    a thin wrapper around std::map<rutz::fstring, void*> */
+    a thin wrapper around a hashed map of interned strings */
 ///////////////////////////////////////////////////////////////////////
 //
 // Copyright (c) 2004-2007 University of Southern California
@@ -32,21 +32,25 @@
 
 #include "rutz/error.h"
 #include "rutz/fstring.h"
+#include "rutz/istring.h"
 #include "rutz/sfmt.h"
 
-#include <algorithm> // for lexicographical_compare()
-#include <map>
+#include <algorithm> // for lexicographical_compare(), sort()
+#include <cctype>
 #include <sstream>
+#include <string>
+#include <vector>
 
 #include "rutz/trace.h"
 
 struct rutz::assoc_array_base::impl
 {
-  impl(kill_func_t* f, const char* descr, bool nocase)
+  impl(kill_func_t* f, const char* descr, bool nocase_)
     :
-    values(fstring_cmp(nocase)),
+    values(),
     kill_func(f),
-    key_description(descr)
+    key_description(descr),
+    nocase(nocase_)
   {}
 
   static bool nocase_char_cmp(char c1, char c2)
@@ -54,33 +58,45 @@ struct rutz::assoc_array_base::impl
     return toupper(c1) < toupper(c2);
   }
 
-  struct fstring_cmp
+  // Entries are filed under their interned key (upper-cased if
+  // nocase), so that a lookup is one hash of the query text plus a
+  // pointer-keyed probe; the original spelling is kept for listings.
+  struct slot
   {
-    fstring_cmp(bool nocase_) : nocase(nocase_) {}
+    rutz::fstring name;
+    void* value;
+  };
 
-    const bool nocase;
+  typedef rutz::istring_map<slot> map_t;
 
-    bool operator()(const rutz::fstring& s1,
-                    const rutz::fstring& s2) const
-    {
-      if (nocase)
-        {
-          return std::lexicographical_compare
-            (s1.c_str(), s1.c_str() + s1.length(),
-             s2.c_str(), s2.c_str() + s2.length(),
-             nocase_char_cmp);
-        }
-
-      // else...
-      return (s1 < s2);
-    }
-  };
+  // Get the key under which name is filed. Returns false if no such
+  // key could be in the map, without interning anything.
+  bool find_key(const char* name, size_t len, rutz::istring& key) const
+  {
+    if (!nocase)
+      return rutz::istring::find(rutz::char_range(name, len), key);
+
+    std::string up(name, len);
+    for (char& c: up)
+      c = char(toupper(c));
+    return rutz::istring::find(rutz::char_range(up.data(), up.size()), key);
+  }
 
-  typedef std::map<rutz::fstring, void*, fstring_cmp> map_t;
+  rutz::istring make_key(const char* name, size_t len) const
+  {
+    if (!nocase)
+      return rutz::istring(rutz::char_range(name, len));
+
+    std::string up(name, len);
+    for (char& c: up)
+      c = char(toupper(c));
+    return rutz::istring(rutz::char_range(up.data(), up.size()));
+  }
 
   map_t         values;
   kill_func_t*  kill_func;
   rutz::fstring key_description;
+  const bool    nocase;
 };
 
 rutz::assoc_array_base::assoc_array_base(kill_func_t* f,
@@ -100,18 +116,34 @@ GVX_TRACE("rutz::assoc_array_base::~assoc_array_base");
 rutz::fstring rutz::assoc_array_base::
 get_known_keys(const char* sep) const
 {
+  std::vector<rutz::fstring> names;
+
+  for (const auto& val: rep->values)
+    if (val.second.value != nullptr)
+      names.push_back(val.second.name);
+
+  const bool nocase = rep->nocase;
+
+  std::sort(names.begin(), names.end(),
+            [nocase](const rutz::fstring& s1, const rutz::fstring& s2)
+            {
+              if (nocase)
+                return std::lexicographical_compare
+                  (s1.c_str(), s1.c_str() + s1.length(),
+                   s2.c_str(), s2.c_str() + s2.length(),
+                   impl::nocase_char_cmp);
+              return s1 < s2;
+            });
+
   std::ostringstream result;
 
   bool first = true;
 
-  for (const auto& val: rep->values)
+  for (const rutz::fstring& name: names)
     {
-      if (val.second != nullptr)
-        {
-          if (!first) result << sep;
-          result << val.first;
-          first = false;
-        }
+      if (!first) result << sep;
+      result << name;
+      first = false;
     }
 
   return rutz::fstring(result.str().c_str());
@@ -138,8 +170,8 @@ void rutz::assoc_array_base::clear()
 GVX_TRACE("rutz::assoc_array_base::clear");
   for (auto& val: rep->values)
     {
-      if (rep->kill_func != nullptr) rep->kill_func(val.second);
-      val.second = nullptr;
+      if (rep->kill_func != nullptr) rep->kill_func(val.second.value);
+      val.second.value = nullptr;
     }
 
   delete rep;
@@ -147,20 +179,31 @@ GVX_TRACE("rutz::assoc_array_base::clear");
 
 void* rutz::assoc_array_base::get_value_for_key(const rutz::fstring& key) const
 {
-GVX_TRACE("rutz::assoc_array_base::get_value_for_key");
-  return rep->values[key];
+  // no GVX_TRACE here: this is on the path of every factory lookup,
+  // and tracing would cost far more than the lookup itself
+  rutz::istring k;
+  if (!rep->find_key(key.c_str(), key.length(), k))
+    return nullptr;
+
+  impl::map_t::const_iterator itr = rep->values.find(k);
+  return itr == rep->values.end() ? nullptr : (*itr).second.value;
 }
 
 void* rutz::assoc_array_base::get_value_for_key(const char* key) const
 {
-  return get_value_for_key(rutz::fstring(key));
+  rutz::istring k;
+  if (!rep->find_key(key, strlen(key), k))
+    return nullptr;
+
+  impl::map_t::const_iterator itr = rep->values.find(k);
+  return itr == rep->values.end() ? nullptr : (*itr).second.value;
 }
 
 void rutz::assoc_array_base::set_value_for_key(const char* key, void* ptr)
 {
 GVX_TRACE("rutz::assoc_array_base::set_value_for_key");
-  rutz::fstring skey(key);
-  void*& ptr_slot = rep->values[skey];
-  if (rep->kill_func != nullptr) rep->kill_func(ptr_slot);
-  ptr_slot = ptr;
+  impl::slot& s = rep->values[rep->make_key(key, strlen(key))];
+  if (rep->kill_func != nullptr && s.value != nullptr) rep->kill_func(s.value);
+  s.name = key;
+  s.value = ptr;
 }
@@ -1,5 +1,5 @@
 /** @file rutz/assocarray.h generic associative arrays, implemented as
-    a thin wrapper around std::map<rutz::fstring, void*> */
+    a thin wrapper around a hashed map of interned strings */
 
 ///////////////////////////////////////////////////////////////////////
 //
@@ -38,7 +38,7 @@ namespace rutz
 {
   struct file_pos;
 
-  /// A non-typesafe wrapper around std::map<string, void*>.
+  /// A non-typesafe wrapper around a hashed map<string, void*>.
   /** The use must provide a pointer to a function that knows how to
       properly destroy the actual contained objects according to their
       true type. */
@@ -32,15 +32,18 @@
 
 #include "fstring.h"
 
-#include "rutz/freelist.h"
-#include "rutz/mutex.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cctype>
 #include <cstdio>
 #include <cstring>
 #include <istream>
+#include <new>
 #include <ostream>
+#include <string>
 #include <utility>
+#include <vector>
 
 #ifndef GVX_NO_PROF
 #define GVX_NO_PROF
@@ -52,176 +55,192 @@ GVX_DBG_REGISTER
 
 //---------------------------------------------------------------------
 //
-// rutz::string_rep member definitions
+// allocation counters
 //
 //---------------------------------------------------------------------
 
 namespace
 {
-  rutz::free_list<rutz::string_rep>* g_rep_list;
-  std::mutex g_rep_list_mutex;
+  std::atomic<unsigned long> g_heap_reps(0);
+  std::atomic<unsigned long> g_arena_reps(0);
+  std::atomic<unsigned long> g_arena_blocks(0);
 }
 
-void* rutz::string_rep::operator new(size_t bytes)
+rutz::fstring_alloc_counts rutz::get_fstring_alloc_counts() noexcept
 {
-  GVX_MUTEX_LOCK(g_rep_list_mutex);
-  if (g_rep_list == nullptr) g_rep_list = new rutz::free_list<rutz::string_rep>;
-  return g_rep_list->allocate(bytes);
+  fstring_alloc_counts result;
+  result.heap_reps = g_heap_reps.load(std::memory_order_relaxed);
+  result.arena_reps = g_arena_reps.load(std::memory_order_relaxed);
+  result.arena_blocks = g_arena_blocks.load(std::memory_order_relaxed);
+  return result;
 }
 
-void rutz::string_rep::operator delete(void* space)
+void rutz::reset_fstring_alloc_counts() noexcept
 {
-  GVX_MUTEX_LOCK(g_rep_list_mutex);
-  g_rep_list->deallocate(space);
+  g_heap_reps.store(0, std::memory_order_relaxed);
+  g_arena_reps.store(0, std::memory_order_relaxed);
+  g_arena_blocks.store(0, std::memory_order_relaxed);
 }
 
-rutz::string_rep::string_rep(std::size_t len, const char* txt,
-                             std::size_t capac) :
-  m_refcount(0),
-  m_capacity(std::max(len+1, capac)),
-  m_length(0),
-  m_text(new char[m_capacity])
+//---------------------------------------------------------------------
+//
+// rutz::string_arena member definitions
+//
+//---------------------------------------------------------------------
+
+struct rutz::string_arena::pool
+{
+  explicit pool(std::size_t bsize) :
+    refs(1), blocks(), next(nullptr), end(nullptr), block_size(bsize)
+  {}
+
+  ~pool() noexcept
+  {
+    for (char* b: blocks)
+      delete [] b;
+  }
+
+  // Get space for a rep, or null if the request is too big to be
+  // worth putting in the arena. Only the thread that owns the arena
+  // allocates, so only the reference count needs to be atomic.
+  void* allocate(std::size_t bytes)
+  {
+    const std::size_t align = alignof(string_rep);
+    bytes = (bytes + align - 1) & ~(align - 1);
+
+    if (bytes > block_size / 4)
+      return nullptr;
+
+    if (next == nullptr || bytes > std::size_t(end - next))
+      {
+        blocks.push_back(new char[block_size]);
+        next = blocks.back();
+        end = next + block_size;
+        g_arena_blocks.fetch_add(1, std::memory_order_relaxed);
+      }
+
+    void* result = next;
+    next += bytes;
+    refs.fetch_add(1, std::memory_order_relaxed);
+    return result;
+  }
+
+  // Drop one reference, held either by the arena or by a rep; the
+  // last one out frees all the blocks.
+  void release() noexcept
+  {
+    if (refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+      delete this;
+  }
+
+  std::atomic<long> refs;
+  std::vector<char*> blocks;
+  char* next;
+  char* end;
+  const std::size_t block_size;
+};
+
+namespace
 {
-  if (txt)
-    uniq_append(len, txt);
-  else
-    add_terminator();
+  thread_local rutz::string_arena* t_current_arena = nullptr;
 }
 
-rutz::string_rep::~string_rep() noexcept
+rutz::string_arena::string_arena(std::size_t block_size) :
+  m_pool(new pool(std::max(block_size, std::size_t(1024)))),
+  m_prev(t_current_arena)
 {
-GVX_TRACE("rutz::string_rep::~string_rep");
-
-  delete [] m_text;
-  m_text = reinterpret_cast<char*>(0xdeadbeef);
+  t_current_arena = this;
 }
 
-rutz::string_rep* rutz::string_rep::make(std::size_t length,
-                                         const char* text,
-                                         std::size_t capacity)
+rutz::string_arena::~string_arena() noexcept
 {
-  return new rutz::string_rep(length, text, capacity);
+  GVX_ASSERT(t_current_arena == this);
+  t_current_arena = m_prev;
+  m_pool->release();
 }
 
-rutz::string_rep* rutz::string_rep::read_from_stream(std::istream& is)
+rutz::string_arena* rutz::string_arena::current() noexcept
 {
-  rutz::string_rep* result = rutz::string_rep::make(0, 0, 32);
-  is >> std::ws;
-  while ( true )
-    {
-      int c = is.get();
-      if (c == EOF || isspace(c))
-        {
-          is.unget();
-          break;
-        }
-      result->uniq_append_no_terminate(char(c));
-    }
-  result->add_terminator();
+  return t_current_arena;
+}
 
-  return result;
+rutz::string_arena::suspend::suspend() noexcept :
+  m_saved(t_current_arena)
+{
+  t_current_arena = nullptr;
 }
 
-rutz::string_rep* rutz::string_rep::readsome_from_stream(std::istream& is, unsigned int count)
+rutz::string_arena::suspend::~suspend() noexcept
 {
-  rutz::string_rep* result = rutz::string_rep::make(0, 0, count+2);
+  t_current_arena = m_saved;
+}
 
-  if (count > 0)
-    {
-      std::streamsize numread = is.readsome(result->m_text, count);
-      result->uniq_set_length(size_t(numread)); // includes add_terminator()
-    }
+//---------------------------------------------------------------------
+//
+// rutz::string_rep member definitions
+//
+//---------------------------------------------------------------------
 
-  return result;
-}
+rutz::string_rep::string_rep(std::size_t len,
+                             rutz::string_arena::pool* p) noexcept :
+  m_refcount(0),
+  m_length(len),
+  m_pool(p)
+{}
 
-rutz::string_rep* rutz::string_rep::readline_from_stream(std::istream& is, char eol)
+rutz::string_rep* rutz::string_rep::make(std::size_t length,
+                                         const char* text)
 {
-  rutz::string_rep* result = rutz::string_rep::make(0, 0, 32);
+  // m_text[1] already provides room for the null terminator
+  const std::size_t bytes = sizeof(string_rep) + length;
 
-  while ( true )
-    {
-      int c = is.get();
-      if (c == EOF || c == eol)
-        break;
-      result->uniq_append_no_terminate(char(c));
-    }
+  string_arena* arena = string_arena::current();
 
-  result->add_terminator();
+  void* space = arena ? arena->get_pool()->allocate(bytes) : nullptr;
 
-  return result;
-}
+  string_rep* result = nullptr;
 
-void rutz::string_rep::debug_dump() const noexcept
-{
-  dbg_eval_nl(0, (const void*)this);
-  dbg_eval_nl(0, m_refcount.load());
-  dbg_eval_nl(0, m_length);
-  dbg_eval_nl(0, (void*)m_text);
-  dbg_eval_nl(0, m_text);
-  for (unsigned int i = 0; i < m_length; ++i)
-    dbg_print(0, (void*)(size_t)m_text[i]);
-  dbg_print_nl(0, "");
-}
-
-void rutz::string_rep::uniq_append_no_terminate(char c)
-{
-  if (m_length + 2 <= m_capacity)
+  if (space != nullptr)
     {
-      m_text[m_length++] = c;
+      result = new (space) string_rep(length, arena->get_pool());
+      g_arena_reps.fetch_add(1, std::memory_order_relaxed);
     }
   else
     {
-      uniq_realloc(m_length + 2);
-      m_text[m_length++] = c;
+      space = ::operator new(bytes);
+      result = new (space) string_rep(length, nullptr);
+      g_heap_reps.fetch_add(1, std::memory_order_relaxed);
     }
-}
 
-void rutz::string_rep::add_terminator() noexcept
-{
-  m_text[m_length] = '\0';
-}
+  if (length > 0)
+    memcpy(result->m_text, text, length);
+  result->m_text[length] = '\0';
 
-void rutz::string_rep::uniq_set_length(std::size_t len) noexcept
-{
-  GVX_PRECONDITION(m_refcount.load() <= 1);
-  GVX_PRECONDITION(len+1 < m_capacity);
-  m_length = len;
-  add_terminator();
+  return result;
 }
 
-void rutz::string_rep::uniq_append(std::size_t len, const char* txt)
+void rutz::string_rep::destroy() noexcept
 {
-  GVX_PRECONDITION(m_refcount.load() <= 1);
-  GVX_PRECONDITION(txt != nullptr);
+  string_arena::pool* p = m_pool;
 
-  if (m_length + len + 1 <= m_capacity)
-    {
-      memcpy(m_text+m_length, txt, len);
-      m_length += len;
-      add_terminator();
-    }
-  else
-    {
-      uniq_realloc(m_length + len + 1);
-      uniq_append(len, txt);
-    }
+  this->~string_rep();
 
-  GVX_POSTCONDITION(m_length+1 <= m_capacity);
-  GVX_POSTCONDITION(m_text[m_length] == '\0');
+  if (p != nullptr)
+    p->release();
+  else
+    ::operator delete(static_cast<void*>(this));
 }
 
-void rutz::string_rep::uniq_realloc(std::size_t capac)
+void rutz::string_rep::debug_dump() const noexcept
 {
-  GVX_PRECONDITION(m_refcount.load() <= 1);
-
-  rutz::string_rep new_rep(std::max(m_capacity*2 + 32, capac), 0);
-
-  new_rep.uniq_append(this->m_length, this->m_text);
-
-  std::swap(m_capacity, new_rep.m_capacity);
-  std::swap(m_length, new_rep.m_length);
-  std::swap(m_text, new_rep.m_text);
+  dbg_eval_nl(0, (const void*)this);
+  dbg_eval_nl(0, m_refcount.load());
+  dbg_eval_nl(0, m_length);
+  dbg_eval_nl(0, (const void*)m_pool);
+  dbg_eval_nl(0, m_text);
+  for (unsigned int i = 0; i < m_length; ++i)
+    dbg_print(0, (void*)(size_t)m_text[i]);
+  dbg_print_nl(0, "");
 }
 
 //---------------------------------------------------------------------
@@ -230,64 +249,37 @@ void rutz::string_rep::uniq_realloc(std::size_t capac)
 //
 //---------------------------------------------------------------------
 
-void rutz::fstring::init_empty()
-{
-GVX_TRACE("rutz::fstring::init_empty");
-  GVX_PRECONDITION(m_rep == nullptr);
-
-  m_rep = string_rep::make(0, 0);
-
-  m_rep->incr_ref_count();
-}
+const std::size_t rutz::fstring::max_inline;
+const std::size_t rutz::fstring::tag_pos;
+const char rutz::fstring::heap_tag;
 
 void rutz::fstring::init_range(char_range r)
 {
 GVX_TRACE("rutz::fstring::init_range");
-  GVX_PRECONDITION(m_rep == nullptr);
-
-  m_rep = string_rep::make(r.len, r.text);
-
-  m_rep->incr_ref_count();
-}
-
-rutz::fstring::fstring(rutz::string_rep* r)
-  :
-  m_rep(r)
-{
-GVX_TRACE("rutz::fstring::fstring(string_rep*)");
-  m_rep->incr_ref_count();
-}
 
-rutz::fstring::fstring() :
-  m_rep(string_rep::make(0,0))
-{
-GVX_TRACE("rutz::fstring::fstring");
-
-  m_rep->incr_ref_count();
-}
-
-rutz::fstring::fstring(const rutz::fstring& other) noexcept :
-  m_rep(other.m_rep)
-{
-GVX_TRACE("rutz::fstring::fstring(const fstring&)");
-  m_rep->incr_ref_count();
-}
-
-rutz::fstring::~fstring() noexcept
-{
-GVX_TRACE("rutz::fstring::~fstring");
-
-  dbg_dump(7, *this);
-
-  if (m_rep->decr_ref_count() == 0)
-    m_rep = (string_rep*)0xdeadbeef;
+  if (r.len <= max_inline)
+    {
+      if (r.len > 0)
+        memcpy(m_buf, r.text, r.len);
+      m_buf[r.len] = '\0';
+      m_buf[tag_pos] = char(r.len);
+    }
+  else
+    {
+      m_rep = string_rep::make(r.len, r.text);
+      m_rep->incr_ref_count();
+      m_buf[tag_pos] = heap_tag;
+    }
 }
 
 void rutz::fstring::swap(rutz::fstring& other) noexcept
 {
 GVX_TRACE("rutz::fstring::swap");
 
-  std::swap(m_rep, other.m_rep);
+  char tmp[sizeof(m_buf)];
+  memcpy(tmp, m_buf, sizeof(m_buf));
+  memcpy(m_buf, other.m_buf, sizeof(m_buf));
+  memcpy(other.m_buf, tmp, sizeof(m_buf));
 }
 
 rutz::fstring& rutz::fstring::operator=(const char* text)
@@ -337,9 +329,11 @@ bool rutz::fstring::equals(const fstring& other) const noexcept
 {
 GVX_TRACE("rutz::fstring::equals(const fstring&)");
 
-  return c_str() == other.c_str() ||
-    ( length() == other.length() &&
-      strcmp(c_str(), other.c_str()) == 0 );
+  const std::size_t len = length();
+
+  return len == other.length() &&
+    ( c_str() == other.c_str() ||
+      memcmp(c_str(), other.c_str(), len) == 0 );
 }
 
 bool rutz::fstring::operator<(const char* other) const noexcept
@@ -369,13 +363,32 @@ GVX_TRACE("rutz::fstring::operator>");
 void rutz::fstring::read(std::istream& is)
 {
 GVX_TRACE("rutz::fstring::read");
-  rutz::fstring(string_rep::read_from_stream(is)).swap(*this);
+  std::string buf;
+  is >> std::ws;
+  while ( true )
+    {
+      int c = is.get();
+      if (c == EOF || isspace(c))
+        {
+          is.unget();
+          break;
+        }
+      buf.push_back(char(c));
+    }
+
+  rutz::fstring(char_range(buf.data(), buf.size())).swap(*this);
 }
 
 void rutz::fstring::readsome(std::istream& is, unsigned int count)
 {
 GVX_TRACE("rutz::fstring::readsome");
-  rutz::fstring(string_rep::readsome_from_stream(is, count)).swap(*this);
+  std::vector<char> buf(count + 1);
+  std::streamsize numread = 0;
+
+  if (count > 0)
+    numread = is.readsome(&buf[0], count);
+
+  rutz::fstring(char_range(&buf[0], size_t(numread))).swap(*this);
 }
 
 void rutz::fstring::write(std::ostream& os) const
@@ -387,13 +400,28 @@ GVX_TRACE("rutz::fstring::write");
 void rutz::fstring::readline(std::istream& is, char eol)
 {
 GVX_TRACE("rutz::fstring::readline");
-  rutz::fstring(string_rep::readline_from_stream(is, eol)).swap(*this);
+  std::string buf;
+  while ( true )
+    {
+      int c = is.get();
+      if (c == EOF || c == eol)
+        break;
+      buf.push_back(char(c));
+    }
+
+  rutz::fstring(char_range(buf.data(), buf.size())).swap(*this);
 }
 
 void rutz::fstring::debug_dump() const noexcept
 {
   dbg_eval_nl(0, (const void*)this);
-  m_rep->debug_dump();
+  if (is_inline())
+    {
+      dbg_eval_nl(0, length());
+      dbg_eval_nl(0, m_buf);
+    }
+  else
+    m_rep->debug_dump();
 }
 
 using rutz::fstring;
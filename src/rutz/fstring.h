@@ -45,24 +45,95 @@ namespace rutz
   ///////////////////////////////////////////////////////////
   /**
    *
-   * \c string_rep is a helper class for fstring that handles memory
-   * management and reference-counting. \c string_rep should not be
-   * used by public clients.
+   * \c string_arena is a scoped allocator for fstring text. While a
+   * string_arena exists, fstring objects created on the same thread
+   * that are too long to be stored inline take their memory from the
+   * arena's blocks, by bumping a pointer, instead of from operator
+   * new. Destroying such a string costs almost nothing; the arena's
+   * blocks are all released together, once the arena has gone out
+   * of scope and the last string allocated from it is gone.
+   *
+   * This suits bulk parsing (e.g. loading ASW or XML files), which
+   * makes and discards many temporary strings. Strings that outlive
+   * the arena remain valid, but they keep the arena's blocks alive,
+   * so code that returns long-lived strings from inside an arena
+   * scope should build them under a string_arena::suspend.
+   *
+   * Arenas on a thread must be destroyed in the reverse order of
+   * their construction (which is automatic for local variables).
    *
    **/
   ///////////////////////////////////////////////////////////
 
-  class string_rep
+  class string_arena
   {
   public:
-    static string_rep* make(std::size_t length, const char* text,
-                            std::size_t capacity=0);
+    /// Make this the current arena for the calling thread.
+    explicit string_arena(std::size_t block_size = 32*1024);
+
+    /// Restore the previous arena (if any) for the calling thread.
+    ~string_arena() noexcept;
+
+    /// Get the innermost live arena on the calling thread, or null.
+    static string_arena* current() noexcept;
+
+    /// Scoped guard that allocates from the heap despite any arena.
+    class suspend
+    {
+    public:
+      suspend() noexcept;
+      ~suspend() noexcept;
+
+    private:
+      suspend(const suspend&);
+      suspend& operator=(const suspend&);
+
+      string_arena* const m_saved;
+    };
+
+    struct pool;
+
+    pool* get_pool() const noexcept { return m_pool; }
 
-    static string_rep* read_from_stream(std::istream& is);
+  private:
+    string_arena(const string_arena&);
+    string_arena& operator=(const string_arena&);
+
+    pool* const m_pool;
+    string_arena* const m_prev;
+  };
+
+  /// Counts of fstring text allocations since the last reset.
+  struct fstring_alloc_counts
+  {
+    unsigned long heap_reps;    ///< reps allocated with operator new
+    unsigned long arena_reps;   ///< reps allocated from a string_arena
+    unsigned long arena_blocks; ///< blocks allocated by string_arena objects
+  };
 
-    static string_rep* readsome_from_stream(std::istream& is, unsigned int count);
+  /// Get the counts of fstring text allocations so far.
+  fstring_alloc_counts get_fstring_alloc_counts() noexcept;
 
-    static string_rep* readline_from_stream(std::istream& is, char eol = '\n');
+  /// Reset the counts of fstring text allocations to zero.
+  void reset_fstring_alloc_counts() noexcept;
+
+  ///////////////////////////////////////////////////////////
+  /**
+   *
+   * \c string_rep is a helper class for fstring that holds the text
+   * of strings that are too long to be stored inline in the fstring
+   * itself. The reference count, length and text are all held in a
+   * single allocation. \c string_rep should not be used by public
+   * clients.
+   *
+   **/
+  ///////////////////////////////////////////////////////////
+
+  class string_rep
+  {
+  public:
+    /// Make a rep holding a copy of text[0..length[, with refcount 0.
+    static string_rep* make(std::size_t length, const char* text);
 
     void incr_ref_count() noexcept { ++m_refcount; }
 
@@ -70,52 +141,34 @@ namespace rutz
     {
       const int c = --m_refcount;
       if (c <= 0)
-        delete this;
+        destroy();
       return c;
     }
 
     std::size_t length() const noexcept { return m_length; }
-    std::size_t capacity() const noexcept { return m_capacity; }
     const char* text() const noexcept { return m_text; }
 
     void debug_dump() const noexcept;
 
   private:
-    // Class-specific operator new.
-    void* operator new(std::size_t bytes);
+    string_rep(std::size_t length, string_arena::pool* pool) noexcept;
 
-    // Class-specific operator delete.
-    void operator delete(void* space);
+    ~string_rep() = default;
 
-    // Constructor builds a string_rep with ref-count 0. 'length' here
-    // does NOT need to "+1" for a null-terminator
-    string_rep(std::size_t length, const char* text, std::size_t capacity=0);
-
-    ~string_rep() noexcept;
-
-    // To be called once via std::call_once()
-    static void initialize_empty_rep();
-
-    // Member functions whose names are prefixed with "uniq_" require
-    // as a precondition that the string_rep object be unshared. In
-    // order to ensure thread safety, such mutating calls are private
-    // and can be made only during the process of construction of a
-    // string_rep object.
-
-    void uniq_append_no_terminate(char c);
-    void add_terminator() noexcept;
-    void uniq_set_length(std::size_t length) noexcept;
-    void uniq_append(std::size_t length, const char* text);
-    void uniq_realloc(std::size_t capacity);
+    // Run the destructor and release the memory to wherever it came
+    // from.
+    void destroy() noexcept;
 
     string_rep(const string_rep& other); // not implemented
     string_rep& operator=(const string_rep& other); // not implemented
 
     std::atomic<int> m_refcount;
-
-    std::size_t m_capacity;
     std::size_t m_length;
-    char* m_text;
+    string_arena::pool* m_pool; // owner of our memory, or null for the heap
+
+    // The text, including the null terminator, continues past the end
+    // of the object; make() allocates the extra space.
+    char m_text[1];
   };
 
   struct char_range
@@ -131,13 +184,13 @@ namespace rutz
   ///////////////////////////////////////////////////////////
   /**
    *
-   * \c fstring is a simple string class that holds a pointer to a
-   * dynamically-allocated char array. The initializer does not have
-   * to reside in permanent storage, since a copy is made when the \c
-   * fstring is constructed. Assignment is allowed, with copy
-   * semantics. Also, a \c swap() operation is provided. The internal
-   * implementation uses reference counting to allow for efficient
-   * copies; however, to allow safe multi-threaded access to fstring,
+   * \c fstring is a simple string class. The initializer does not
+   * have to reside in permanent storage, since a copy is made when
+   * the \c fstring is constructed. Assignment is allowed, with copy
+   * semantics. Also, a \c swap() operation is provided. Strings of
+   * up to 14 chars are stored inline, without any allocation; longer
+   * strings are held in a reference-counted string_rep to allow for
+   * efficient copies; however, to allow safe multi-threaded access to fstring,
    * fstring's interface is read-only, except for a few functions
    * (assignment operator, swap(), clear() read(), readline(),
    * readsome()) which safely replace the entire string.
@@ -149,24 +202,35 @@ namespace rutz
   {
   public:
     /// Construct an empty string.
-    fstring();
+    fstring() noexcept
+    {
+      m_buf[0] = '\0';
+      m_buf[tag_pos] = 0;
+    }
 
     /// Copy constructor.
-    fstring(const fstring& other) noexcept;
+    fstring(const fstring& other) noexcept
+    {
+      memcpy(m_buf, other.m_buf, sizeof(m_buf));
+      if (!is_inline())
+        m_rep->incr_ref_count();
+    }
 
     /// Destructory.
-    ~fstring() noexcept;
+    ~fstring() noexcept
+    {
+      if (!is_inline())
+        m_rep->decr_ref_count();
+    }
 
     /// Construct by copying from a C-style null-terminated char array.
-    fstring(const char* s) :
-      m_rep(nullptr)
+    fstring(const char* s)
     {
       init_range(char_range(s, s ? strlen(s) : 0));
     }
 
     /// Construct from a character range (pointer plus length).
-    explicit fstring(char_range r) :
-      m_rep(nullptr)
+    explicit fstring(char_range r)
     {
       init_range(r);
     }
@@ -181,10 +245,12 @@ namespace rutz
     fstring& operator=(const fstring& other) noexcept;
 
     /// Get a pointer to the const underlying data array.
-    const char* c_str() const noexcept { return m_rep->text(); }
+    const char* c_str() const noexcept
+    { return is_inline() ? m_buf : m_rep->text(); }
 
     /// Get the number of characters in the string (NOT INCLUDING the null terminator).
-    std::size_t length() const noexcept { return m_rep->length(); }
+    std::size_t length() const noexcept
+    { return is_inline() ? std::size_t(m_buf[tag_pos]) : m_rep->length(); }
 
     /// Query whether the length of the string is 0.
     bool is_empty() const noexcept { return (length() == 0); }
@@ -193,7 +259,7 @@ namespace rutz
     bool empty() const noexcept { return is_empty(); }
 
     /// Return the character at position i.
-    char operator[](unsigned int i) const { return m_rep->text()[i]; }
+    char operator[](unsigned int i) const { return c_str()[i]; }
 
     /// Reset to an empty string.
     void clear();
@@ -267,16 +333,29 @@ namespace rutz
     /// Dump contents for debugging.
     void debug_dump() const noexcept;
 
+    /// Maximum length of strings that are stored inline.
+    static const std::size_t max_inline = 14;
+
   private:
-    void init_empty();
+    static const std::size_t tag_pos = max_inline + 1;
+    static const char heap_tag = 0x7f;
+
+    bool is_inline() const noexcept { return m_buf[tag_pos] != heap_tag; }
 
     void init_range(char_range r);
 
-    /// Construct from an existing string_rep object
-    /** The string_rep should have refcount==0 on entry. */
-    fstring(string_rep* r);
+    // Strings of up to max_inline chars are stored in m_buf itself,
+    // followed by a null terminator, with their length in
+    // m_buf[tag_pos]; longer strings are held in a string_rep, and
+    // m_buf[tag_pos] is heap_tag.
+    union
+    {
+      string_rep* m_rep;
+      char        m_buf[max_inline + 2];
+    };
 
-    string_rep* m_rep;
+    static_assert(sizeof(string_rep*) < tag_pos,
+                  "string_rep* must not overlap the tag byte");
   };
 
 
@@ -0,0 +1,163 @@
+/** @file rutz/istring.cc interned strings with O(1) equality and cached
+    hashes, plus hashed container aliases */
+
+///////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026-2026 Rob Peters
+// Rob Peters <https://github.com/rjpcal/>
+//
+// created: Mon Oct 19 11:52:08 2026
+//
+// --------------------------------------------------------------------
+//
+// This file is part of GroovX.
+//   [https://github.com/rjpcal/groovx]
+//
+// GroovX is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// GroovX is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GroovX; if not, write to the Free Software Foundation,
+// Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include "istring.h"
+
+#include "rutz/mutex.h"
+
+#include <vector>
+
+#ifndef GVX_NO_PROF
+#define GVX_NO_PROF
+#endif
+
+#include "rutz/trace.h"
+
+namespace
+{
+  // Open-addressed (linear probing) set of interned entries, kept at
+  // most half full. Entries are never removed.
+  struct intern_table
+  {
+    std::vector<const rutz::istring::entry*> slots;
+    std::size_t count;
+
+    intern_table() : slots(256, nullptr), count(0) {}
+
+    const rutz::istring::entry* find(const char* text, std::size_t len,
+                                     std::size_t h) const
+    {
+      const std::size_t mask = slots.size() - 1;
+
+      for (std::size_t i = h & mask; ; i = (i + 1) & mask)
+        {
+          const rutz::istring::entry* e = slots[i];
+
+          if (e == nullptr)
+            return nullptr;
+
+          if (e->hash == h && e->text.length() == len
+              && memcmp(e->text.c_str(), text, len) == 0)
+            return e;
+        }
+    }
+
+    const rutz::istring::entry* find_or_insert(const char* text,
+                                               std::size_t len,
+                                               std::size_t h)
+    {
+      if (const rutz::istring::entry* found = find(text, len, h))
+        return found;
+
+      // interned text lives forever, so it mustn't pin an arena
+      rutz::string_arena::suspend heap_only;
+
+      const rutz::istring::entry* e =
+        new rutz::istring::entry{h, rutz::fstring(rutz::char_range(text, len))};
+
+      if (2 * (count + 1) > slots.size())
+        grow();
+
+      const std::size_t mask = slots.size() - 1;
+      std::size_t i = h & mask;
+      while (slots[i] != nullptr)
+        i = (i + 1) & mask;
+      slots[i] = e;
+      ++count;
+
+      return e;
+    }
+
+    void grow()
+    {
+      std::vector<const rutz::istring::entry*> old(2 * slots.size(), nullptr);
+      old.swap(slots);
+
+      const std::size_t mask = slots.size() - 1;
+      for (const rutz::istring::entry* e: old)
+        if (e != nullptr)
+          {
+            std::size_t i = e->hash & mask;
+            while (slots[i] != nullptr)
+              i = (i + 1) & mask;
+            slots[i] = e;
+          }
+    }
+  };
+
+  std::mutex g_intern_mutex;
+
+  intern_table& the_table()
+  {
+    static intern_table* t = new intern_table;
+    return *t;
+  }
+}
+
+rutz::istring::istring() :
+  m_entry(nullptr)
+{
+  static const entry* const e = intern("", 0);
+  m_entry = e;
+}
+
+const rutz::istring::entry* rutz::istring::intern(const char* text,
+                                                  std::size_t len)
+{
+  if (text == nullptr)
+    {
+      text = "";
+      len = 0;
+    }
+
+  const std::size_t h = rutz::string_hash(text, len);
+
+  GVX_MUTEX_LOCK(g_intern_mutex);
+  return the_table().find_or_insert(text, len, h);
+}
+
+bool rutz::istring::find(rutz::char_range r, istring& result)
+{
+  const std::size_t h = rutz::string_hash(r.text, r.len);
+
+  GVX_MUTEX_LOCK(g_intern_mutex);
+  const entry* e = the_table().find(r.text, r.len, h);
+  if (e == nullptr)
+    return false;
+  result = istring(e);
+  return true;
+}
+
+std::size_t rutz::istring::num_interned()
+{
+  GVX_MUTEX_LOCK(g_intern_mutex);
+  return the_table().count;
+}
@@ -0,0 +1,208 @@
+/** @file rutz/istring.h interned strings with O(1) equality and cached
+    hashes, plus hashed container aliases */
+
+///////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026-2026 Rob Peters
+// Rob Peters <https://github.com/rjpcal/>
+//
+// created: Mon Oct 19 11:52:08 2026
+//
+// --------------------------------------------------------------------
+//
+// This file is part of GroovX.
+//   [https://github.com/rjpcal/groovx]
+//
+// GroovX is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// GroovX is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GroovX; if not, write to the Free Software Foundation,
+// Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef GROOVX_RUTZ_ISTRING_H_UTC20261019115208_DEFINED
+#define GROOVX_RUTZ_ISTRING_H_UTC20261019115208_DEFINED
+
+#include "rutz/fstring.h"
+
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <unordered_map>
+
+namespace rutz
+{
+  class istring;
+
+  /// Hash a character range (64-bit FNV-1a, truncated to size_t).
+  inline std::size_t string_hash(const char* text, std::size_t len) noexcept
+  {
+    unsigned long long h = 14695981039346656037ull;
+    for (std::size_t i = 0; i < len; ++i)
+      {
+        h ^= static_cast<unsigned char>(text[i]);
+        h *= 1099511628211ull;
+      }
+    return std::size_t(h);
+  }
+
+  ///////////////////////////////////////////////////////////
+  /**
+   *
+   * \c istring is an interned, immutable string. All istring objects
+   * with the same text share a single canonical entry in a global
+   * table, which also holds the string's precomputed hash. Therefore
+   * equality comparison between istring objects is a single pointer
+   * comparison, and hashing is a single load; the cost of hashing
+   * and comparing the text is paid once, when an istring is
+   * constructed from a char array or an fstring.
+   *
+   * Interned entries are never freed, so istring is meant for keys
+   * drawn from a bounded vocabulary (class names, field names, XML
+   * element names, etc.), not for arbitrary data. Construction is
+   * thread-safe.
+   *
+   **/
+  ///////////////////////////////////////////////////////////
+
+  class istring
+  {
+  public:
+    struct entry;
+
+    /// Construct the empty string.
+    istring();
+
+    /// Construct by interning a C-style null-terminated char array.
+    istring(const char* s) :
+      m_entry(intern(s, s ? strlen(s) : 0))
+    {}
+
+    /// Construct by interning the contents of an fstring.
+    istring(const rutz::fstring& s) :
+      m_entry(intern(s.c_str(), s.length()))
+    {}
+
+    /// Construct by interning a character range.
+    explicit istring(rutz::char_range r) :
+      m_entry(intern(r.text, r.len))
+    {}
+
+    // default copy, dtor, assignment OK
+
+    /// Get a pointer to the const underlying (null-terminated) data array.
+    inline const char* c_str() const noexcept;
+
+    /// Get the number of characters in the string.
+    inline std::size_t length() const noexcept;
+
+    /// Query whether the length of the string is 0.
+    bool empty() const noexcept { return length() == 0; }
+
+    /// Get the precomputed string_hash() of the string's text.
+    inline std::size_t hash() const noexcept;
+
+    /// Get the text as an fstring (shares the interned copy).
+    inline const rutz::fstring& str() const noexcept;
+
+    /// Identity comparison, which is equivalent to text comparison.
+    bool operator==(const istring& other) const noexcept
+    { return m_entry == other.m_entry; }
+
+    bool operator!=(const istring& other) const noexcept
+    { return m_entry != other.m_entry; }
+
+    /// Text comparison with a C-style string.
+    bool operator==(const char* other) const noexcept
+    { return strcmp(c_str(), other) == 0; }
+
+    bool operator!=(const char* other) const noexcept
+    { return !operator==(other); }
+
+    /// Lexicographic ordering, for use in ordered containers.
+    bool operator<(const istring& other) const noexcept
+    {
+      return m_entry != other.m_entry && strcmp(c_str(), other.c_str()) < 0;
+    }
+
+    /// Look up an already-interned string, without interning it.
+    /** Returns false (and leaves \a result alone) if no istring with
+        the given text has been constructed yet. This is useful for
+        querying a map of istring keys with arbitrary text, since text
+        that was never interned can't be one of the keys. */
+    static bool find(rutz::char_range r, istring& result);
+
+    /// Get the number of distinct strings interned so far.
+    static std::size_t num_interned();
+
+  private:
+    explicit istring(const entry* e) noexcept : m_entry(e) {}
+
+    static const entry* intern(const char* text, std::size_t len);
+
+    const entry* m_entry;
+  };
+
+  struct istring::entry
+  {
+    std::size_t    hash;
+    rutz::fstring  text;
+  };
+
+  inline const char* istring::c_str() const noexcept
+  { return m_entry->text.c_str(); }
+
+  inline std::size_t istring::length() const noexcept
+  { return m_entry->text.length(); }
+
+  inline std::size_t istring::hash() const noexcept
+  { return m_entry->hash; }
+
+  inline const rutz::fstring& istring::str() const noexcept
+  { return m_entry->text; }
+
+  inline std::ostream& operator<<(std::ostream& os, const istring& s)
+  {
+    return os << s.str();
+  }
+
+  /// Hash functor for istring keys; just returns the cached hash.
+  struct istring_hash
+  {
+    std::size_t operator()(const rutz::istring& s) const noexcept
+    { return s.hash(); }
+  };
+
+  /// Hash functor for fstring keys.
+  struct fstring_hash
+  {
+    std::size_t operator()(const rutz::fstring& s) const noexcept
+    { return string_hash(s.c_str(), s.length()); }
+  };
+
+  /// Hashed map with interned-string keys.
+  template <class T>
+  using istring_map = std::unordered_map<rutz::istring, T, istring_hash>;
+
+  /// Hashed map with fstring keys, for keys that aren't worth interning.
+  template <class T>
+  using fstring_hash_map =
+    std::unordered_map<rutz::fstring, T, fstring_hash>;
+}
+
+namespace std
+{
+  template <>
+  struct hash<rutz::istring> : public rutz::istring_hash {};
+}
+
+#endif // !GROOVX_RUTZ_ISTRING_H_UTC20261019115208_DEFINED
@@ -33,9 +33,11 @@
 
 #include "rutz/abort.h"
 #include "rutz/mutex.h"
+#include "rutz/profgraph.h"
 #include "rutz/staticstack.h"
 
 #include <algorithm> // for std::stable_sort()
+#include <atomic>
 #include <cstdio>
 #include <functional>
 #include <iomanip>
@@ -105,6 +107,8 @@ namespace
     return *g_prof_list;
   }
 
+  std::atomic<unsigned int> g_next_prof_id(0);
+
   //
   // data and thread info for a global start time
   //
@@ -129,7 +133,8 @@ rutz::prof::timing_mode rutz::prof::s_timing_mode = rutz::prof::timing_mode::RUS
 rutz::prof::prof(const char* s, const char* fname, int lineno)  noexcept:
   m_context_name(s),
   m_src_file_name(fname),
-  m_src_line_no(lineno)
+  m_src_line_no(lineno),
+  m_id(g_next_prof_id++)
 {
   reset();
 
@@ -273,6 +278,23 @@ void rutz::prof::reset_all_prof_data() noexcept
   GVX_MUTEX_LOCK(g_prof_list_mutex);
   std::for_each(all_profs().begin(), all_profs().end(),
                 std::mem_fun(&rutz::prof::reset));
+
+  rutz::call_graph::reset();
+}
+
+double rutz::prof::elapsed_usec() noexcept
+{
+  std::call_once(g_start_once, initialize_start_time);
+
+  return (rutz::prof::get_now_time(s_timing_mode) - g_start).usec();
+}
+
+void rutz::prof::for_each_prof(const std::function<void(const rutz::prof&)>& func)
+{
+  GVX_MUTEX_LOCK(g_prof_list_mutex);
+
+  for (const rutz::prof* p: all_profs())
+    func(*p);
 }
 
 namespace
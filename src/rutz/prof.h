@@ -34,6 +34,7 @@
 
 #include "rutz/time.h"
 
+#include <functional>
 #include <iosfwd>
 
 namespace rutz
@@ -135,6 +136,11 @@ public:
 
   int src_line_no() const noexcept;
 
+  /// Get a small integer that uniquely identifies this rutz::prof.
+  /** Ids are handed out sequentially starting from 0, in order of
+      construction. */
+  unsigned int id() const noexcept { return m_id; }
+
   /// Get the total elapsed time in microsecs since the last reset().
   double total_time() const noexcept;
 
@@ -157,8 +163,15 @@ public:
   static void prof_summary_file_name(const char* fname);
 
   /// Reset all call counts and elapsed times to zero.
+  /** This includes the rutz::call_graph. */
   static void reset_all_prof_data() noexcept;
 
+  /// Get the time in microsecs since the first rutz::prof was created.
+  static double elapsed_usec() noexcept;
+
+  /// Call \a func on each rutz::prof object, while holding the list lock.
+  static void for_each_prof(const std::function<void(const rutz::prof&)>& func);
+
   /// Print all profile data to the given file.
   static void print_all_prof_data(FILE* f) noexcept;
 
@@ -172,6 +185,7 @@ private:
   const char*  const m_context_name;
   const char*  const m_src_file_name;
   int          const m_src_line_no;
+  unsigned int const m_id;
   unsigned int       m_call_count;
   rutz::time         m_total_time;
   rutz::time         m_children_time;
@@ -0,0 +1,571 @@
+/** @file rutz/profgraph.cc call-graph collection for rutz::prof, plus
+    snapshots that can be diffed and exported */
+
+///////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026-2026 Rob Peters
+// Rob Peters <https://github.com/rjpcal/>
+//
+// created: Mon Oct 19 12:41:09 2026
+//
+// --------------------------------------------------------------------
+//
+// This file is part of GroovX.
+//   [https://github.com/rjpcal/groovx]
+//
+// GroovX is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// GroovX is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GroovX; if not, write to the Free Software Foundation,
+// Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include "rutz/profgraph.h"
+
+#include "rutz/mutex.h"
+#include "rutz/prof.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <map>
+#include <new> // for std::nothrow
+#include <ostream>
+#include <utility>
+
+///////////////////////////////////////////////////////////////////////
+//
+// rutz::call_node
+//
+///////////////////////////////////////////////////////////////////////
+
+/// A node of a thread's calling-context tree.
+/** Only the owning thread ever adds nodes to its tree; other threads
+    (taking snapshots) may read it concurrently, so first_child is
+    atomic and a new node is fully built before it is published. */
+struct rutz::call_node
+{
+  call_node(rutz::prof* p, call_node* par, call_node* sib) noexcept :
+    prof(p), parent(par), first_child(nullptr), next_sibling(sib),
+    count(0), total()
+  {}
+
+  rutz::prof* const              prof;
+  call_node* const               parent;
+  std::atomic<call_node*>        first_child;
+  call_node* const               next_sibling;
+  unsigned int                   count;
+  rutz::time                     total;
+};
+
+namespace
+{
+  // Like g_prof_list in prof.cc, the roots and their nodes are never
+  // freed, so that the trees stay valid during program shutdown.
+  std::vector<rutz::call_node*>* g_roots = nullptr;
+  std::mutex                     g_roots_mutex;
+
+  thread_local rutz::call_node*  t_root = nullptr;
+  thread_local rutz::call_node*  t_current = nullptr;
+
+  rutz::call_node* thread_root() noexcept
+  {
+    if (t_root == nullptr)
+      {
+        rutz::call_node* root =
+          new (std::nothrow) rutz::call_node(nullptr, nullptr, nullptr);
+
+        if (root == nullptr)
+          return nullptr;
+
+        GVX_MUTEX_LOCK(g_roots_mutex);
+
+        if (g_roots == nullptr)
+          g_roots = new (std::nothrow) std::vector<rutz::call_node*>;
+
+        if (g_roots == nullptr)
+          {
+            delete root;
+            return nullptr;
+          }
+
+        try
+          {
+            g_roots->push_back(root);
+          }
+        catch (...)
+          {
+            delete root;
+            return nullptr;
+          }
+
+        t_root = root;
+      }
+
+    return t_root;
+  }
+
+  void reset_tree(rutz::call_node* n) noexcept
+  {
+    n->count = 0;
+    n->total.reset();
+
+    for (rutz::call_node* c = n->first_child.load(std::memory_order_acquire);
+         c != nullptr; c = c->next_sibling)
+      reset_tree(c);
+  }
+}
+
+///////////////////////////////////////////////////////////////////////
+//
+// rutz::call_graph member definitions
+//
+///////////////////////////////////////////////////////////////////////
+
+bool rutz::call_graph::s_enabled = false;
+
+rutz::call_node* rutz::call_graph::enter(rutz::prof& p,
+                                         call_node*& prev) noexcept
+{
+  prev = t_current;
+
+  call_node* parent = prev ? prev : thread_root();
+
+  if (parent == nullptr)
+    return nullptr;
+
+  call_node* const head = parent->first_child.load(std::memory_order_relaxed);
+
+  for (call_node* c = head; c != nullptr; c = c->next_sibling)
+    {
+      if (c->prof == &p)
+        return (t_current = c);
+    }
+
+  call_node* n = new (std::nothrow) call_node(&p, parent, head);
+
+  if (n == nullptr)
+    return nullptr;
+
+  parent->first_child.store(n, std::memory_order_release);
+
+  return (t_current = n);
+}
+
+void rutz::call_graph::leave(call_node* node, call_node* prev,
+                             const rutz::time& elapsed) noexcept
+{
+  ++node->count;
+  node->total += elapsed;
+  t_current = prev;
+}
+
+void rutz::call_graph::reset() noexcept
+{
+  GVX_MUTEX_LOCK(g_roots_mutex);
+
+  if (g_roots == nullptr)
+    return;
+
+  for (call_node* root: *g_roots)
+    reset_tree(root);
+}
+
+///////////////////////////////////////////////////////////////////////
+//
+// rutz::prof_snapshot helpers
+//
+///////////////////////////////////////////////////////////////////////
+
+namespace
+{
+  typedef std::map<std::pair<int, const void*>, int> node_index;
+
+  // Merge the subtree under n into nodes (as children of parent).
+  void merge_tree(const rutz::call_node* n, int parent,
+                  std::vector<rutz::prof_snapshot::node>& nodes,
+                  node_index& index)
+  {
+    for (const rutz::call_node* c = n->first_child.load(std::memory_order_acquire);
+         c != nullptr; c = c->next_sibling)
+      {
+        const auto key = std::make_pair(parent, static_cast<const void*>(c->prof));
+
+        auto itr = index.find(key);
+
+        int i;
+        if (itr != index.end())
+          i = itr->second;
+        else
+          {
+            i = int(nodes.size());
+            index.insert(std::make_pair(key, i));
+            rutz::prof_snapshot::node nd;
+            nd.id = c->prof;
+            nd.name = c->prof->context_name();
+            nd.parent = parent;
+            nd.count = 0;
+            nd.self_usec = 0.0;
+            nd.total_usec = 0.0;
+            nodes.push_back(nd);
+          }
+
+        nodes[i].count += c->count;
+        nodes[i].total_usec += c->total.usec();
+
+        merge_tree(c, i, nodes, index);
+      }
+  }
+
+  // Put nodes into preorder.
+  std::vector<rutz::prof_snapshot::node>
+  preorder_nodes(const std::vector<rutz::prof_snapshot::node>& nodes)
+  {
+    // merge_tree() may append a child to an earlier parent after
+    // nodes from other threads' trees, so re-sort into a proper
+    // preorder here
+    std::vector<std::vector<int> > children(nodes.size() + 1);
+    for (size_t i = 0; i < nodes.size(); ++i)
+      children[size_t(nodes[i].parent + 1)].push_back(int(i));
+
+    std::vector<rutz::prof_snapshot::node> result;
+    result.reserve(nodes.size());
+    std::vector<int> newpos(nodes.size(), -1);
+
+    std::vector<int> stack(children[0].rbegin(), children[0].rend());
+    while (!stack.empty())
+      {
+        const int i = stack.back();
+        stack.pop_back();
+
+        newpos[size_t(i)] = int(result.size());
+        result.push_back(nodes[size_t(i)]);
+        if (nodes[size_t(i)].parent >= 0)
+          result.back().parent = newpos[size_t(nodes[size_t(i)].parent)];
+
+        const std::vector<int>& kids = children[size_t(i + 1)];
+        stack.insert(stack.end(), kids.rbegin(), kids.rend());
+      }
+
+    return result;
+  }
+
+  // Drop subtrees without any calls, and fill in self times. A frame
+  // that is still running (e.g. the one that is taking the snapshot)
+  // has no count or time of its own yet, but may have children with
+  // calls; so it is kept, and its total time is taken to be at least
+  // the sum of its children's.
+  std::vector<rutz::prof_snapshot::node>
+  tidy_nodes(std::vector<rutz::prof_snapshot::node> nodes)
+  {
+    std::vector<unsigned long> active(nodes.size(), 0);
+    std::vector<double> child_total(nodes.size(), 0.0);
+
+    for (size_t i = nodes.size(); i-- > 0; )
+      {
+        rutz::prof_snapshot::node& nd = nodes[i];
+        active[i] += nd.count;
+        nd.total_usec = std::max(nd.total_usec, child_total[i]);
+        nd.self_usec = nd.total_usec - child_total[i];
+        if (nd.parent >= 0)
+          {
+            active[size_t(nd.parent)] += active[i];
+            child_total[size_t(nd.parent)] += nd.total_usec;
+          }
+      }
+
+    std::vector<rutz::prof_snapshot::node> result;
+    std::vector<int> newpos(nodes.size(), -1);
+
+    for (size_t i = 0; i < nodes.size(); ++i)
+      {
+        if (active[i] == 0)
+          continue;
+
+        newpos[i] = int(result.size());
+        result.push_back(nodes[i]);
+        if (nodes[i].parent >= 0)
+          result.back().parent = newpos[size_t(nodes[i].parent)];
+      }
+
+    return result;
+  }
+
+  bool compare_entry_total(const rutz::prof_snapshot::entry& e1,
+                           const rutz::prof_snapshot::entry& e2)
+  {
+    return e1.total_usec < e2.total_usec;
+  }
+
+  void json_string(std::ostream& os, const std::string& s)
+  {
+    os << '"';
+    for (char c: s)
+      {
+        switch (c)
+          {
+          case '"':  os << "\\\""; break;
+          case '\\': os << "\\\\"; break;
+          case '\n': os << "\\n"; break;
+          case '\t': os << "\\t"; break;
+          default:
+            if (static_cast<unsigned char>(c) < 0x20)
+              {
+                char buf[8];
+                snprintf(buf, sizeof(buf), "\\u%04x", unsigned(c));
+                os << buf;
+              }
+            else
+              os << c;
+          }
+      }
+    os << '"';
+  }
+}
+
+///////////////////////////////////////////////////////////////////////
+//
+// rutz::prof_snapshot member definitions
+//
+///////////////////////////////////////////////////////////////////////
+
+rutz::prof_snapshot::prof_snapshot() :
+  m_entries(),
+  m_nodes(),
+  m_elapsed_usec(0.0)
+{}
+
+rutz::prof_snapshot rutz::prof_snapshot::take()
+{
+  prof_snapshot result;
+
+  result.m_elapsed_usec = rutz::prof::elapsed_usec();
+
+  rutz::prof::for_each_prof
+    ([&result](const rutz::prof& p)
+     {
+       if (p.count() == 0)
+         return;
+
+       entry e;
+       e.id = &p;
+       e.name = p.context_name();
+       e.file = p.src_file_name();
+       e.line = p.src_line_no();
+       e.count = p.count();
+       e.self_usec = p.self_time();
+       e.total_usec = p.total_time();
+       result.m_entries.push_back(e);
+     });
+
+  std::stable_sort(result.m_entries.begin(), result.m_entries.end(),
+                   compare_entry_total);
+
+  std::vector<node> nodes;
+  node_index index;
+
+  {
+    GVX_MUTEX_LOCK(g_roots_mutex);
+
+    if (g_roots != nullptr)
+      for (const call_node* root: *g_roots)
+        merge_tree(root, -1, nodes, index);
+  }
+
+  result.m_nodes = tidy_nodes(preorder_nodes(nodes));
+
+  return result;
+}
+
+rutz::prof_snapshot rutz::prof_snapshot::diff(const prof_snapshot& earlier) const
+{
+  prof_snapshot result;
+
+  result.m_elapsed_usec = m_elapsed_usec - earlier.m_elapsed_usec;
+
+  std::map<const void*, const entry*> old_entries;
+  for (const entry& e: earlier.m_entries)
+    old_entries[e.id] = &e;
+
+  for (const entry& e: m_entries)
+    {
+      entry d = e;
+      auto itr = old_entries.find(e.id);
+      if (itr != old_entries.end())
+        {
+          d.count -= itr->second->count;
+          d.self_usec -= itr->second->self_usec;
+          d.total_usec -= itr->second->total_usec;
+        }
+      if (d.count > 0)
+        result.m_entries.push_back(d);
+    }
+
+  std::stable_sort(result.m_entries.begin(), result.m_entries.end(),
+                   compare_entry_total);
+
+  // Match up nodes by their position in the tree: the earlier parent
+  // of a node must be the match of this node's parent.
+  node_index old_index;
+  for (size_t i = 0; i < earlier.m_nodes.size(); ++i)
+    old_index[std::make_pair(earlier.m_nodes[i].parent,
+                             earlier.m_nodes[i].id)] = int(i);
+
+  std::vector<int> match(m_nodes.size(), -1);
+  std::vector<node> nodes(m_nodes);
+
+  for (size_t i = 0; i < m_nodes.size(); ++i)
+    {
+      const node& n = m_nodes[i];
+      const int old_parent = (n.parent < 0) ? -1 : match[size_t(n.parent)];
+
+      if (n.parent < 0 || old_parent >= 0)
+        {
+          auto itr = old_index.find(std::make_pair(old_parent, n.id));
+          if (itr != old_index.end())
+            match[i] = itr->second;
+        }
+
+      if (match[i] >= 0)
+        {
+          const node& o = earlier.m_nodes[size_t(match[i])];
+          nodes[i].count -= o.count;
+          nodes[i].total_usec -= o.total_usec;
+        }
+    }
+
+  // nodes that weren't entered in between drop out here
+  result.m_nodes = tidy_nodes(nodes);
+
+  return result;
+}
+
+std::vector<rutz::prof_snapshot::edge> rutz::prof_snapshot::edges() const
+{
+  std::map<std::pair<const void*, const void*>, edge> agg;
+
+  for (const node& n: m_nodes)
+    {
+      const void* parent_id = nullptr;
+      std::string parent_name;
+      if (n.parent >= 0)
+        {
+          parent_id = m_nodes[size_t(n.parent)].id;
+          parent_name = m_nodes[size_t(n.parent)].name;
+        }
+
+      edge& e = agg[std::make_pair(parent_id, n.id)];
+      if (e.count == 0)
+        {
+          e.parent = parent_name;
+          e.child = n.name;
+          e.total_usec = 0.0;
+        }
+      e.count += n.count;
+      e.total_usec += n.total_usec;
+    }
+
+  std::vector<edge> result;
+  result.reserve(agg.size());
+  for (const auto& p: agg)
+    result.push_back(p.second);
+
+  std::stable_sort(result.begin(), result.end(),
+                   [](const edge& e1, const edge& e2)
+                   { return e1.total_usec > e2.total_usec; });
+
+  return result;
+}
+
+std::string rutz::prof_snapshot::stack_of(int i) const
+{
+  std::vector<int> path;
+  for (int k = i; k >= 0; k = m_nodes[size_t(k)].parent)
+    path.push_back(k);
+
+  std::string result;
+  for (auto itr = path.rbegin(); itr != path.rend(); ++itr)
+    {
+      if (!result.empty())
+        result += ';';
+      // semicolons are the stack separator, so they can't appear
+      // inside a frame name
+      std::string name = m_nodes[size_t(*itr)].name;
+      std::replace(name.begin(), name.end(), ';', ':');
+      result += name;
+    }
+  return result;
+}
+
+void rutz::prof_snapshot::print(std::ostream& os) const
+{
+  const double elapsed = m_elapsed_usec > 0.0 ? m_elapsed_usec : 1.0;
+
+  char buf[64];
+
+  for (const entry& e: m_entries)
+    {
+      snprintf(buf, sizeof(buf), "%10.0f %6u %10.0f %4.1f%% %10.0f %4.1f%% ",
+               e.count > 0 ? e.total_usec / e.count : 0.0, e.count,
+               e.self_usec, (100.0 * e.self_usec) / elapsed,
+               e.total_usec, (100.0 * e.total_usec) / elapsed);
+      os << buf << e.name << '\n';
+    }
+}
+
+void rutz::prof_snapshot::write_collapsed(std::ostream& os) const
+{
+  for (size_t i = 0; i < m_nodes.size(); ++i)
+    {
+      const long long self = (long long)(m_nodes[i].self_usec + 0.5);
+      if (self > 0)
+        os << stack_of(int(i)) << ' ' << self << '\n';
+    }
+}
+
+void rutz::prof_snapshot::write_chrome_trace(std::ostream& os) const
+{
+  // start[i] is where node i begins; cursor[i] is where its next
+  // child begins
+  std::vector<double> start(m_nodes.size(), 0.0);
+  std::vector<double> cursor(m_nodes.size(), 0.0);
+  double top_cursor = 0.0;
+
+  char buf[128];
+
+  os << "{\"traceEvents\":[";
+
+  for (size_t i = 0; i < m_nodes.size(); ++i)
+    {
+      const node& n = m_nodes[i];
+      const double dur = std::max(n.total_usec, 0.0);
+
+      double& c = (n.parent < 0) ? top_cursor : cursor[size_t(n.parent)];
+      start[i] = c;
+      cursor[i] = c;
+      c += dur;
+
+      os << (i == 0 ? "\n" : ",\n") << "{\"name\":";
+      json_string(os, n.name);
+      snprintf(buf, sizeof(buf),
+               ",\"cat\":\"prof\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,"
+               "\"pid\":1,\"tid\":1,",
+               start[i], dur);
+      os << buf;
+      snprintf(buf, sizeof(buf),
+               "\"args\":{\"calls\":%u,\"self_us\":%.3f}}",
+               n.count, n.self_usec);
+      os << buf;
+    }
+
+  os << "\n],\n\"displayTimeUnit\":\"ms\"}\n";
+}
@@ -0,0 +1,168 @@
+/** @file rutz/profgraph.h call-graph collection for rutz::prof, plus
+    snapshots that can be diffed and exported */
+
+///////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026-2026 Rob Peters
+// Rob Peters <https://github.com/rjpcal/>
+//
+// created: Mon Oct 19 12:41:09 2026
+//
+// --------------------------------------------------------------------
+//
+// This file is part of GroovX.
+//   [https://github.com/rjpcal/groovx]
+//
+// GroovX is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// GroovX is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GroovX; if not, write to the Free Software Foundation,
+// Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef GROOVX_RUTZ_PROFGRAPH_H_UTC20261019124109_DEFINED
+#define GROOVX_RUTZ_PROFGRAPH_H_UTC20261019124109_DEFINED
+
+#include "rutz/time.h"
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace rutz
+{
+  class prof;
+  struct call_node;
+  class call_graph;
+  class prof_snapshot;
+}
+
+/// Collects a calling-context tree alongside rutz::backtrace.
+/** When enabled, each rutz::trace finds (or creates) the tree node for
+    its rutz::prof underneath the node of the enclosing rutz::trace, and
+    on exit adds its elapsed time to that node. So unlike the flat
+    rutz::prof totals, the tree keeps separate timings for each call
+    path, from which both parent/child edges and full stacks can be
+    recovered (see rutz::prof_snapshot). Each thread gets its own tree;
+    nodes are never freed, only reset. Collection is off by default,
+    and can be switched on and off at any time. */
+class rutz::call_graph
+{
+public:
+  /// Query whether call-graph collection is on.
+  static bool is_enabled() noexcept { return s_enabled; }
+
+  /// Switch call-graph collection on or off.
+  static void set_enabled(bool on_off) noexcept { s_enabled = on_off; }
+
+  /// Called by rutz::trace on entry.
+  /** Returns the node for \a p, or null if no node could be
+      allocated. \a prev receives the node that was current on entry,
+      which must be passed back to leave(). */
+  static call_node* enter(rutz::prof& p, call_node*& prev) noexcept;
+
+  /// Called by rutz::trace on exit.
+  static void leave(call_node* node, call_node* prev,
+                    const rutz::time& elapsed) noexcept;
+
+  /// Reset the counts and times in all threads' trees to zero.
+  static void reset() noexcept;
+
+private:
+  static bool s_enabled;
+};
+
+/// A copy of all rutz::prof data (and the call graph) at one moment.
+/** Snapshots are plain values, so they stay valid no matter what
+    happens to the live profiling data afterwards. Subtracting an
+    earlier snapshot with diff() gives the activity in between. */
+class rutz::prof_snapshot
+{
+public:
+  /// Flat profile data for one rutz::prof.
+  struct entry
+  {
+    const void*  id;
+    std::string  name;
+    std::string  file;
+    int          line;
+    unsigned int count;
+    double       self_usec;
+    double       total_usec;
+  };
+
+  /// One node of the call graph, merged across threads.
+  /** Nodes are stored in preorder, so parents come before their
+      children; parent is -1 for top-level nodes. */
+  struct node
+  {
+    const void*  id;
+    std::string  name;
+    int          parent;
+    unsigned int count;
+    double       self_usec;
+    double       total_usec;
+  };
+
+  /// Aggregated caller/callee edge of the call graph.
+  struct edge
+  {
+    std::string  parent;
+    std::string  child;
+    unsigned int count;
+    double       total_usec;
+  };
+
+  /// Construct an empty snapshot.
+  prof_snapshot();
+
+  /// Capture the current profiling data.
+  static prof_snapshot take();
+
+  /// Get the change in profiling data since \a earlier.
+  prof_snapshot diff(const prof_snapshot& earlier) const;
+
+  /// Flat entries with a non-zero count, sorted by increasing total time.
+  const std::vector<entry>& entries() const noexcept { return m_entries; }
+
+  /// Call-graph nodes with a non-zero count, in preorder.
+  const std::vector<node>& nodes() const noexcept { return m_nodes; }
+
+  /// Aggregate the call graph into caller/callee edges.
+  /** Edges are sorted by decreasing total time. */
+  std::vector<edge> edges() const;
+
+  /// Get the semicolon-separated stack of names that leads to node \a i.
+  std::string stack_of(int i) const;
+
+  /// Print the flat entries in the same format as rutz::prof::print_all_prof_data().
+  void print(std::ostream& os) const;
+
+  /// Write the call graph in the collapsed-stack format used by flamegraph tools.
+  /** Each line is a semicolon-separated stack followed by the self
+      time of that stack in microseconds. */
+  void write_collapsed(std::ostream& os) const;
+
+  /// Write the call graph as Chrome trace-event JSON.
+  /** Since the call graph holds aggregate times rather than individual
+      calls, each node becomes a single complete ("X") event whose
+      duration is the node's total time, with its children laid out
+      back to back inside it, as in a flame chart. */
+  void write_chrome_trace(std::ostream& os) const;
+
+private:
+  std::vector<entry> m_entries;
+  std::vector<node>  m_nodes;
+  double             m_elapsed_usec;
+};
+
+#endif // !GROOVX_RUTZ_PROFGRAPH_H_UTC20261019124109_DEFINED
@@ -30,4 +30,315 @@
 
 #include "rand.h"
 
+#include "rutz/error.h"
+#include "rutz/sfmt.h"
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 unsigned long rutz::default_rand_seed = 0;
+
+rutz::rand_engine rutz::default_rand_engine = rutz::rand_engine::LEGACY;
+
+const char* rutz::rand_engine_name(rutz::rand_engine e) noexcept
+{
+  return e == rutz::rand_engine::LEGACY ? "legacy" : "philox";
+}
+
+rutz::rand_engine rutz::rand_engine_from_name(const char* name)
+{
+  if (strcmp(name, "legacy") == 0)
+    return rutz::rand_engine::LEGACY;
+  else if (strcmp(name, "philox") == 0)
+    return rutz::rand_engine::PHILOX;
+
+  throw rutz::error(rutz::sfmt("unknown random engine '%s' "
+                               "(expected legacy or philox)", name),
+                    SRC_POS);
+}
+
+namespace
+{
+  // Run f(begin, end) over [0,n[, split into contiguous chunks across
+  // up to nthreads threads. Small jobs aren't worth a thread.
+  template <class F>
+  void split_work(size_t n, unsigned int nthreads, F f)
+  {
+    const size_t min_chunk = 1 << 14;
+
+    const size_t nchunks =
+      std::max(size_t(1), std::min(size_t(nthreads), n / min_chunk));
+
+    if (nchunks <= 1)
+      {
+        f(size_t(0), n);
+        return;
+      }
+
+    std::vector<std::thread> workers;
+    for (size_t c = 0; c + 1 < nchunks; ++c)
+      workers.emplace_back(f, (n * c) / nchunks, (n * (c+1)) / nchunks);
+
+    f((n * (nchunks-1)) / nchunks, n);
+
+    for (std::thread& t: workers)
+      t.join();
+  }
+
+  // Fill out[0..n[ with the 32-bit outputs that start at position pos
+  // of the given stream.
+  void raw_fill(const uint32_t key[2], uint64_t stream,
+                uint64_t pos, uint32_t* out, size_t n)
+  {
+    uint32_t buf[4];
+
+    if ((pos & 3) != 0)
+      {
+        rutz::philox::block(key, pos >> 2, stream, buf);
+        while ((pos & 3) != 0 && n > 0)
+          {
+            *out++ = buf[pos & 3];
+            ++pos;
+            --n;
+          }
+      }
+
+#if defined(__SSE2__)
+    // four blocks at a time, one block per 32-bit lane, then
+    // transposed back to block order
+    const __m128i m0 = _mm_set1_epi32(int(0xD2511F53u));
+    const __m128i m1 = _mm_set1_epi32(int(0xCD9E8D57u));
+    const __m128i lo64 = _mm_set_epi32(0, -1, 0, -1);
+    const __m128i hi64 = _mm_set_epi32(-1, 0, -1, 0);
+
+    for ( ; n >= 16; n -= 16, pos += 16, out += 16)
+      {
+        const uint64_t ctr = pos >> 2;
+        __m128i c0 = _mm_set_epi32(int(uint32_t(ctr+3)), int(uint32_t(ctr+2)),
+                                   int(uint32_t(ctr+1)), int(uint32_t(ctr)));
+        __m128i c1 = _mm_set_epi32(int(uint32_t((ctr+3) >> 32)),
+                                   int(uint32_t((ctr+2) >> 32)),
+                                   int(uint32_t((ctr+1) >> 32)),
+                                   int(uint32_t(ctr >> 32)));
+        __m128i c2 = _mm_set1_epi32(int(uint32_t(stream)));
+        __m128i c3 = _mm_set1_epi32(int(uint32_t(stream >> 32)));
+
+        uint32_t k0 = key[0];
+        uint32_t k1 = key[1];
+
+        for (int r = 0; r < 10; ++r)
+          {
+            const __m128i e0 = _mm_mul_epu32(c0, m0);
+            const __m128i o0 = _mm_mul_epu32(_mm_srli_epi64(c0, 32), m0);
+            const __m128i e1 = _mm_mul_epu32(c2, m1);
+            const __m128i o1 = _mm_mul_epu32(_mm_srli_epi64(c2, 32), m1);
+
+            const __m128i lo0 = _mm_or_si128(_mm_and_si128(e0, lo64),
+                                             _mm_slli_epi64(o0, 32));
+            const __m128i hi0 = _mm_or_si128(_mm_srli_epi64(e0, 32),
+                                             _mm_and_si128(o0, hi64));
+            const __m128i lo1 = _mm_or_si128(_mm_and_si128(e1, lo64),
+                                             _mm_slli_epi64(o1, 32));
+            const __m128i hi1 = _mm_or_si128(_mm_srli_epi64(e1, 32),
+                                             _mm_and_si128(o1, hi64));
+
+            c0 = _mm_xor_si128(_mm_xor_si128(hi1, c1),
+                               _mm_set1_epi32(int(k0)));
+            c1 = lo1;
+            c2 = _mm_xor_si128(_mm_xor_si128(hi0, c3),
+                               _mm_set1_epi32(int(k1)));
+            c3 = lo0;
+
+            k0 += 0x9E3779B9u;
+            k1 += 0xBB67AE85u;
+          }
+
+        // transpose (c0,c1,c2,c3) x (block 0..3) into block order
+        const __m128i t0 = _mm_unpacklo_epi32(c0, c1);
+        const __m128i t1 = _mm_unpacklo_epi32(c2, c3);
+        const __m128i t2 = _mm_unpackhi_epi32(c0, c1);
+        const __m128i t3 = _mm_unpackhi_epi32(c2, c3);
+
+        __m128i* dst = reinterpret_cast<__m128i*>(out);
+        _mm_storeu_si128(dst + 0, _mm_unpacklo_epi64(t0, t1));
+        _mm_storeu_si128(dst + 1, _mm_unpackhi_epi64(t0, t1));
+        _mm_storeu_si128(dst + 2, _mm_unpacklo_epi64(t2, t3));
+        _mm_storeu_si128(dst + 3, _mm_unpackhi_epi64(t2, t3));
+      }
+#endif
+
+    for ( ; n >= 4; n -= 4, pos += 4, out += 4)
+      rutz::philox::block(key, pos >> 2, stream, out);
+
+    if (n > 0)
+      {
+        rutz::philox::block(key, pos >> 2, stream, buf);
+        std::copy(buf, buf + n, out);
+      }
+  }
+
+  // Fill p[0..n[ with conv(x) where x is the fdraw() value made from
+  // each consecutive pair of 32-bit outputs starting at pos.
+  template <class T, class F>
+  void fill_from_doubles(const uint32_t key[2], uint64_t stream,
+                         uint64_t pos, T* p, size_t n, F conv)
+  {
+    const size_t chunk = 256;
+    uint32_t words[2*chunk];
+
+    while (n > 0)
+      {
+        const size_t k = std::min(n, chunk);
+        raw_fill(key, stream, pos, words, 2*k);
+        for (size_t i = 0; i < k; ++i)
+          {
+            const uint64_t bits =
+              (uint64_t(words[2*i]) << 32) | uint64_t(words[2*i+1]);
+            p[i] = conv(double(bits >> 11) * (1.0 / 9007199254740992.0));
+          }
+        p += k;
+        pos += 2*k;
+        n -= k;
+      }
+  }
+
+  inline int scale_index(double x, int range)
+  {
+    int r = int(range*x); return (r==range) ? range-1 : r;
+  }
+}
+
+void rutz::philox::block(const uint32_t key[2],
+                         uint64_t ctr_lo, uint64_t ctr_hi,
+                         uint32_t out[4]) noexcept
+{
+  uint32_t c0 = uint32_t(ctr_lo);
+  uint32_t c1 = uint32_t(ctr_lo >> 32);
+  uint32_t c2 = uint32_t(ctr_hi);
+  uint32_t c3 = uint32_t(ctr_hi >> 32);
+  uint32_t k0 = key[0];
+  uint32_t k1 = key[1];
+
+  for (int r = 0; r < 10; ++r)
+    {
+      const uint64_t p0 = uint64_t(0xD2511F53u) * c0;
+      const uint64_t p1 = uint64_t(0xCD9E8D57u) * c2;
+      c0 = uint32_t(p1 >> 32) ^ c1 ^ k0;
+      c1 = uint32_t(p1);
+      c2 = uint32_t(p0 >> 32) ^ c3 ^ k1;
+      c3 = uint32_t(p0);
+      k0 += 0x9E3779B9u;
+      k1 += 0xBB67AE85u;
+    }
+
+  out[0] = c0; out[1] = c1; out[2] = c2; out[3] = c3;
+}
+
+void rutz::philox::refill(uint64_t b) noexcept
+{
+  block(m_key, b, m_stream, m_buf);
+  m_buf_block = b;
+}
+
+void rutz::philox::fill_u32(uint32_t* p, size_t n, unsigned int nthreads)
+{
+  const uint32_t* key = m_key;
+  const uint64_t stream = m_stream;
+  const uint64_t pos = m_pos;
+
+  split_work(n, nthreads,
+             [=](size_t begin, size_t end)
+             { raw_fill(key, stream, pos + begin, p + begin, end - begin); });
+
+  m_pos += n;
+}
+
+void rutz::philox::fill_fdraw(double* p, size_t n, unsigned int nthreads)
+{
+  fill_fdraw_range(p, n, 0.0, 1.0, nthreads);
+}
+
+void rutz::philox::fill_fdraw_range(double* p, size_t n,
+                                    double min, double max,
+                                    unsigned int nthreads)
+{
+  const uint32_t* key = m_key;
+  const uint64_t stream = m_stream;
+  const uint64_t pos = m_pos;
+
+  split_work(n, nthreads,
+             [=](size_t begin, size_t end)
+             {
+               fill_from_doubles(key, stream, pos + 2*begin, p + begin,
+                                 end - begin,
+                                 [=](double x) { return min + x * (max-min); });
+             });
+
+  m_pos += 2*n;
+}
+
+void rutz::philox::fill_idraw(int* p, size_t n, int range,
+                              unsigned int nthreads)
+{
+  const uint32_t* key = m_key;
+  const uint64_t stream = m_stream;
+  const uint64_t pos = m_pos;
+
+  split_work(n, nthreads,
+             [=](size_t begin, size_t end)
+             {
+               fill_from_doubles(key, stream, pos + 2*begin, p + begin,
+                                 end - begin,
+                                 [=](double x) { return scale_index(x, range); });
+             });
+
+  m_pos += 2*n;
+}
+
+rutz::rng rutz::rng::substream(unsigned long stream) const noexcept
+{
+  rng result(*this);
+
+  if (m_engine == rutz::rand_engine::LEGACY)
+    result.seed(m_seed + stream * 0x9E3779B97F4A7C15ul, m_engine);
+  else
+    result.m_philox = m_philox.substream(stream);
+
+  return result;
+}
+
+void rutz::rng::fill_fdraw(double* p, size_t n, unsigned int nthreads)
+{
+  fill_fdraw_range(p, n, 0.0, 1.0, nthreads);
+}
+
+void rutz::rng::fill_fdraw_range(double* p, size_t n,
+                                 double min, double max,
+                                 unsigned int nthreads)
+{
+  if (m_engine == rutz::rand_engine::LEGACY)
+    {
+      for (size_t i = 0; i < n; ++i)
+        p[i] = m_legacy.fdraw_range(min, max);
+    }
+  else
+    m_philox.fill_fdraw_range(p, n, min, max, nthreads);
+}
+
+void rutz::rng::fill_idraw(int* p, size_t n, int range,
+                           unsigned int nthreads)
+{
+  if (m_engine == rutz::rand_engine::LEGACY)
+    {
+      for (size_t i = 0; i < n; ++i)
+        p[i] = m_legacy.idraw(range);
+    }
+  else
+    m_philox.fill_idraw(p, n, range, nthreads);
+}
@@ -35,6 +35,8 @@
 #ifndef GROOVX_RUTZ_RAND_H_UTC20050626084020_DEFINED
 #define GROOVX_RUTZ_RAND_H_UTC20050626084020_DEFINED
 
+#include <cstddef>
+#include <cstdint>
 #include <cstdlib> // for rand()
 
 namespace rutz
@@ -42,6 +44,15 @@ namespace rutz
   class urand;
   class urand_irange;
   class urand_frange;
+  class philox;
+  class rng;
+
+  /// Available random-number engines for rutz::rng.
+  enum class rand_engine
+    {
+      LEGACY, ///< The 32-bit LCG of rutz::urand.
+      PHILOX  ///< The counter-based rutz::philox generator.
+    };
 
   template <class T>
   inline T rand_range(const T& min, const T& max)
@@ -57,6 +68,22 @@ namespace rutz
       setting this value just once, at or near the beginning of
       program execution. */
   extern unsigned long default_rand_seed;
+
+  /// The engine that rutz::rng binds to when it is seeded.
+  /** This is read when a rutz::rng is constructed or seeded without
+      an explicit engine; changing it doesn't affect generators that
+      are already seeded. Code that saves a seed should save the
+      engine along with it (see rand_engine_name()). Initial value is
+      rand_engine::LEGACY, so that existing seeds continue to produce
+      the same sequences as before; set this to rand_engine::PHILOX to
+      opt in to the counter-based generator. */
+  extern rand_engine default_rand_engine;
+
+  /// Get the name of an engine, either "legacy" or "philox".
+  const char* rand_engine_name(rand_engine e) noexcept;
+
+  /// Get the engine with the given name; throws if there isn't one.
+  rand_engine rand_engine_from_name(const char* name);
 }
 
 /// Uniform random distribution
@@ -149,4 +176,237 @@ public:
   double operator()() { return draw(); }
 };
 
+/// Counter-based random-number generator (Philox4x32-10).
+/** The n'th 32-bit output of a stream is a pure function of (seed,
+    stream, n), computed by a 10-round bijection of the counter
+    n/4. This means that discard() is O(1), that distinct streams of
+    the same seed are statistically independent, and that the bulk
+    fill functions can split their work across threads while still
+    producing exactly the values that the corresponding sequence of
+    single draws would have produced.
+
+    See Salmon et al. (2011), "Parallel random numbers: as easy as 1,
+    2, 3", Proc. SC'11. */
+class rutz::philox
+{
+private:
+  uint32_t m_key[2];
+  uint64_t m_stream;
+  uint64_t m_pos;       // index of the next 32-bit output
+  uint64_t m_buf_block; // counter of the block held in m_buf
+  uint32_t m_buf[4];
+
+  void refill(uint64_t block) noexcept;
+
+public:
+  /// Compute one output block for the given key and 128-bit counter.
+  static void block(const uint32_t key[2], uint64_t ctr_lo, uint64_t ctr_hi,
+                    uint32_t out[4]) noexcept;
+
+  /// Construct with a given seed and stream number.
+  philox(unsigned long s = 0, unsigned long stream = 0) noexcept
+  { seed(s, stream); }
+
+  /// Restart at the beginning of the given seed and stream.
+  void seed(unsigned long s, unsigned long stream = 0) noexcept
+  {
+    m_key[0] = uint32_t(uint64_t(s));
+    m_key[1] = uint32_t(uint64_t(s) >> 32);
+    m_stream = stream;
+    m_pos = 0;
+    m_buf_block = ~uint64_t(0);
+  }
+
+  /// Get a fresh generator for another stream from the same seed.
+  /** Different streams never overlap; a typical use is one stream
+      per worker thread, or per generated object. */
+  philox substream(unsigned long stream) const noexcept
+  {
+    philox result(*this);
+    result.m_stream = stream;
+    result.m_pos = 0;
+    result.m_buf_block = ~uint64_t(0);
+    return result;
+  }
+
+  /// Skip ahead by n 32-bit draws, in constant time.
+  void discard(uint64_t n) noexcept { m_pos += n; }
+
+  /// Get the number of 32-bit draws made so far in this stream.
+  uint64_t position() const noexcept { return m_pos; }
+
+  /// Uniform random 32-bit integer.
+  uint32_t u32draw() noexcept
+  {
+    const uint64_t b = m_pos >> 2;
+    if (b != m_buf_block)
+      refill(b);
+    return m_buf[m_pos++ & 3];
+  }
+
+  /// Uniform random distribution in the interval [0.0:1.0[
+  /** Uses 53 random bits, taken from two consecutive 32-bit draws. */
+  double fdraw() noexcept
+  {
+    const uint64_t hi = u32draw();
+    const uint64_t lo = u32draw();
+    return double(((hi << 32) | lo) >> 11) * (1.0 / 9007199254740992.0);
+  }
+
+  /// Uniform random distribution in the interval [min:max[
+  double fdraw_range(double min, double max) noexcept
+  {
+    return min + fdraw() * (max-min);
+  }
+
+  /// Uniform random distribution between true:false
+  bool booldraw() noexcept { return (u32draw() & 0x80000000u) != 0; }
+
+  /// Uniform random distribution in the interval [0:n[
+  int idraw(int n) noexcept
+  {
+    int r = int(n*fdraw()); return (r==n) ? n-1 : r;
+  }
+
+  /// Uniform random distribution in the interval [lo:hi[
+  int idraw_range(int lo, int hi) noexcept
+  {
+    return lo + idraw(hi - lo);
+  }
+
+  /// Uniform random distribution in the interval [0:n[
+  int operator()(int n) noexcept { return idraw(n); }
+
+  /** @name Bulk fills
+
+      Each fill produces exactly the values that n consecutive single
+      draws would produce, and advances the stream by the same amount,
+      regardless of the number of threads used.
+  */
+  //@{
+
+  /// Fill \a p[0..n[ with u32draw() values.
+  void fill_u32(uint32_t* p, size_t n, unsigned int nthreads = 1);
+
+  /// Fill \a p[0..n[ with fdraw() values.
+  void fill_fdraw(double* p, size_t n, unsigned int nthreads = 1);
+
+  /// Fill \a p[0..n[ with fdraw_range(min, max) values.
+  void fill_fdraw_range(double* p, size_t n, double min, double max,
+                        unsigned int nthreads = 1);
+
+  /// Fill \a p[0..n[ with idraw(range) values.
+  void fill_idraw(int* p, size_t n, int range, unsigned int nthreads = 1);
+
+  //@}
+};
+
+/// Uniform random generator that runs on either of the rutz engines.
+/** rutz::rng has the same drawing interface as rutz::urand (so it can
+    be passed to std::random_shuffle etc.), plus bulk fills and
+    substreams. With rand_engine::LEGACY it produces bit-for-bit the
+    same sequences as a rutz::urand with the same seed. */
+class rutz::rng
+{
+private:
+  rutz::rand_engine  m_engine;
+  unsigned long      m_seed;
+  rutz::urand        m_legacy;
+  rutz::philox       m_philox;
+
+public:
+  /// Construct with an initial seed and engine.
+  rng(unsigned long s = 0,
+      rutz::rand_engine e = rutz::default_rand_engine) noexcept
+    : m_engine(e), m_seed(s), m_legacy(s), m_philox(s)
+  {}
+
+  /// Restart with a new seed, on the given engine.
+  void seed(unsigned long s,
+            rutz::rand_engine e = rutz::default_rand_engine) noexcept
+  { m_engine = e; m_seed = s; m_legacy.seed(s); m_philox.seed(s); }
+
+  /// Get the engine that was bound by the most recent seed.
+  rutz::rand_engine engine() const noexcept { return m_engine; }
+
+  /// Get the most recent seed.
+  unsigned long current_seed() const noexcept { return m_seed; }
+
+  /// Pick up a change to rutz::default_rand_engine.
+  /** For long-lived generators that aren't tied to a saved seed (such
+      as the one behind the Tcl rand command): if the default engine
+      has changed since this generator was seeded, restart from the
+      same seed on the new engine. */
+  void follow_default_engine() noexcept
+  {
+    if (m_engine != rutz::default_rand_engine)
+      seed(m_seed, rutz::default_rand_engine);
+  }
+
+  /// Get a generator for an independent stream from the same seed.
+  /** With the PHILOX engine this is a genuinely non-overlapping
+      stream. The LEGACY engine has no streams, so it is instead
+      re-seeded with a seed derived from (seed, stream); that is
+      reproducible, but carries no independence guarantee. */
+  rng substream(unsigned long stream) const noexcept;
+
+  /// Uniform random distribution in the interval [0.0:1.0[
+  double fdraw() noexcept
+  {
+    return m_engine == rutz::rand_engine::LEGACY
+      ? m_legacy.fdraw() : m_philox.fdraw();
+  }
+
+  /// Uniform random distribution in the interval [min:max[
+  double fdraw_range(double min, double max) noexcept
+  {
+    return min + fdraw() * (max-min);
+  }
+
+  /// Uniform random distribution between true:false
+  bool booldraw() noexcept
+  {
+    return m_engine == rutz::rand_engine::LEGACY
+      ? m_legacy.booldraw() : m_philox.booldraw();
+  }
+
+  /// Uniform random distribution in the interval [0:n[
+  int idraw(int n) noexcept
+  {
+    int r = int(n*fdraw()); return (r==n) ? n-1 : r;
+  }
+
+  /// Uniform random distribution in the interval [lo:hi[
+  int idraw_range(int lo, int hi) noexcept
+  {
+    return lo + idraw(hi - lo);
+  }
+
+  /// Uniform random distribution in the interval [0:n[
+  int operator()(int n) noexcept { return idraw(n); }
+
+  /// Skip ahead past \a n calls of fdraw() (or idraw(), etc.).
+  /** This lets a saved (seed, engine, draw count) triple restore a
+      generator's position. It takes constant time with PHILOX, and
+      time proportional to \a n with LEGACY. */
+  void discard_fdraws(unsigned long n) noexcept
+  {
+    if (m_engine == rutz::rand_engine::LEGACY)
+      { while (n-- > 0) m_legacy.fdraw(); }
+    else
+      m_philox.discard(2 * uint64_t(n));
+  }
+
+  /// Fill \a p[0..n[ with fdraw() values.
+  /** Only the PHILOX engine uses \a nthreads; LEGACY draws serially. */
+  void fill_fdraw(double* p, size_t n, unsigned int nthreads = 1);
+
+  /// Fill \a p[0..n[ with fdraw_range(min, max) values.
+  void fill_fdraw_range(double* p, size_t n, double min, double max,
+                        unsigned int nthreads = 1);
+
+  /// Fill \a p[0..n[ with idraw(range) values.
+  void fill_idraw(int* p, size_t n, int range, unsigned int nthreads = 1);
+};
+
 #endif // !GROOVX_RUTZ_RAND_H_UTC20050626084020_DEFINED
@@ -33,6 +33,8 @@
 #include "rutz/trace.h"
 
 #include "rutz/backtrace.h"
+#include "rutz/profgraph.h"
+#include "rutz/tracerecorder.h"
 
 #include <iostream>
 
@@ -121,15 +123,32 @@ rutz::trace::trace(prof& p, bool use_msg) noexcept
   m_start(),
   m_timing_mode(rutz::prof::get_timing_mode()),
   m_should_print_msg(g_do_global_trace || use_msg),
-  m_should_pop(rutz::backtrace::current().push(&p))
+  m_should_pop(rutz::backtrace::current().push(&p)),
+  m_node(nullptr),
+  m_prev_node(nullptr),
+  m_recorded(rutz::trace_recorder::is_recording())
 {
   if (this->m_should_print_msg)
     print_in(this->m_prof.context_name());
 
+  if (rutz::call_graph::is_enabled())
+    this->m_node = rutz::call_graph::enter(p, this->m_prev_node);
+
   // We want this to be the last thing in the constructor, so that we
   // don't include the rest of the constructor runtime in our elapsed
-  // time measurement:
-  this->m_start = rutz::prof::get_now_time(this->m_timing_mode);
+  // time measurement. While recording in WALLCLOCK mode, the begin
+  // event's timestamp serves as the start time, to save a second
+  // clock read; other timing modes still need their own clock:
+  if (this->m_recorded)
+    {
+      const rutz::time t = rutz::trace_recorder::record_begin(this->m_prof);
+      this->m_start =
+        (this->m_timing_mode == rutz::prof::timing_mode::WALLCLOCK)
+        ? t
+        : rutz::prof::get_now_time(this->m_timing_mode);
+    }
+  else
+    this->m_start = rutz::prof::get_now_time(this->m_timing_mode);
 }
 
 rutz::trace::~trace() noexcept
@@ -137,11 +156,23 @@ rutz::trace::~trace() noexcept
   // We want this to be the first thing in the destructor, so that we
   // don't include the rest of the destructor runtime in our elapsed
   // time measurement:
-  const rutz::time finish = rutz::prof::get_now_time(this->m_timing_mode);
+  const bool reuse_end =
+    this->m_recorded
+    && this->m_timing_mode == rutz::prof::timing_mode::WALLCLOCK;
+
+  const rutz::time finish = reuse_end
+    ? rutz::trace_recorder::record_end(this->m_prof)
+    : rutz::prof::get_now_time(this->m_timing_mode);
+
+  if (this->m_recorded && !reuse_end)
+    rutz::trace_recorder::record_end(this->m_prof);
   const rutz::time elapsed = finish - this->m_start;
 
   this->m_prof.add_time(elapsed);
 
+  if (this->m_node != nullptr)
+    rutz::call_graph::leave(this->m_node, this->m_prev_node, elapsed);
+
   // Do a backtrace::pop() only if the corresponding backtrace::push()
   // succeeeded in the constructor (it could have failed due to memory
   // exhaustion, etc.):
@@ -63,6 +63,7 @@
 namespace rutz
 {
   class trace;
+  struct call_node;
 }
 
 /// Times and traces execution in and out of a lexical scope.
@@ -104,6 +105,9 @@ private:
   rutz::prof::timing_mode  m_timing_mode; ///< Store this in case somebody changes the timing mode before we finish
   const bool   m_should_print_msg;
   const bool   m_should_pop;
+  rutz::call_node* m_node;      ///< Our rutz::call_graph node, if call-graph collection was on at entry
+  rutz::call_node* m_prev_node;
+  const bool   m_recorded;      ///< Whether we recorded a begin event with rutz::trace_recorder
 };
 
 #ifndef GVX_TRACE_EXPR
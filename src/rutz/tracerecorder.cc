@@ -0,0 +1,612 @@
+/** @file rutz/tracerecorder.cc record rutz::trace begin/end events into
+    per-thread ring buffers, drained to a binary trace file */
+
+///////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026-2026 Rob Peters
+// Rob Peters <https://github.com/rjpcal/>
+//
+// created: Mon Oct 19 13:27:52 2026
+//
+// --------------------------------------------------------------------
+//
+// This file is part of GroovX.
+//   [https://github.com/rjpcal/groovx]
+//
+// GroovX is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// GroovX is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GroovX; if not, write to the Free Software Foundation,
+// Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include "rutz/tracerecorder.h"
+
+#include "rutz/error.h"
+#include "rutz/mutex.h"
+#include "rutz/prof.h"
+#include "rutz/sfmt.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <new> // for std::nothrow
+#include <ostream>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
+#include "rutz/debug.h"
+GVX_DBG_REGISTER
+
+namespace
+{
+  enum : uint32_t
+    {
+      TAG_NAME    = 'N',
+      TAG_THREAD  = 'T',
+      TAG_EVENTS  = 'E',
+      TAG_DROPPED = 'D'
+    };
+
+  const uint32_t FILE_VERSION = 1;
+
+  struct event
+  {
+    uint64_t ns;
+    uint32_t prof_id;
+    uint16_t thread;
+    uint16_t kind;
+  };
+
+  static_assert(sizeof(event) == 16, "trace events must be packed in 16 bytes");
+
+  const uint32_t RING_MASK = rutz::trace_recorder::ring_size - 1;
+
+  static_assert((rutz::trace_recorder::ring_size & RING_MASK) == 0,
+                "ring_size must be a power of 2");
+
+  /// One thread's ring of events.
+  /** head is only written by the owning thread, and tail only by the
+      drainer; the padding keeps them on separate cache lines. */
+  struct ring
+  {
+    ring(uint16_t idx, int64_t tid) noexcept :
+      head(0), tail(0), dropped(0), index(idx), os_tid(tid), announced(false)
+    {}
+
+    event                 buf[rutz::trace_recorder::ring_size];
+    std::atomic<uint32_t> head;
+    char                  pad1[60];
+    std::atomic<uint32_t> tail;
+    char                  pad2[60];
+    std::atomic<uint64_t> dropped;
+    const uint16_t        index;
+    const int64_t         os_tid;
+    bool                  announced; // touched only by the drainer
+  };
+
+  // As with rutz::backtrace, the rings are never freed, so that a
+  // thread can still safely record while the program is shutting
+  // down.
+  std::vector<ring*>*   g_rings = nullptr;
+  std::mutex            g_rings_mutex;
+
+  thread_local ring*    t_ring = nullptr;
+  thread_local bool     t_ring_failed = false;
+
+  int64_t current_os_tid() noexcept
+  {
+#if defined(__linux__) && defined(SYS_gettid)
+    return int64_t(syscall(SYS_gettid));
+#else
+    return int64_t(getpid());
+#endif
+  }
+
+  ring* thread_ring() noexcept
+  {
+    if (t_ring != nullptr || t_ring_failed)
+      return t_ring;
+
+    GVX_MUTEX_LOCK(g_rings_mutex);
+
+    if (g_rings == nullptr)
+      g_rings = new (std::nothrow) std::vector<ring*>;
+
+    if (g_rings == nullptr || g_rings->size() > 0xffff)
+      {
+        t_ring_failed = true;
+        return nullptr;
+      }
+
+    ring* r = new (std::nothrow) ring(uint16_t(g_rings->size()),
+                                      current_os_tid());
+
+    if (r == nullptr)
+      {
+        t_ring_failed = true;
+        return nullptr;
+      }
+
+    try
+      {
+        g_rings->push_back(r);
+      }
+    catch (...)
+      {
+        delete r;
+        t_ring_failed = true;
+        return nullptr;
+      }
+
+    return (t_ring = r);
+  }
+
+  uint64_t now_ns() noexcept
+  {
+    return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>
+                    (std::chrono::steady_clock::now().time_since_epoch()).count());
+  }
+
+  rutz::time time_from_ns(uint64_t ns) noexcept
+  {
+    return rutz::time(time_t(ns / 1000000000ull),
+                      suseconds_t((ns % 1000000000ull) / 1000ull));
+  }
+
+  void push_event(uint32_t prof_id, uint16_t kind, uint64_t ns) noexcept
+  {
+    ring* r = thread_ring();
+
+    if (r == nullptr)
+      return;
+
+    const uint32_t h = r->head.load(std::memory_order_relaxed);
+
+    if (h - r->tail.load(std::memory_order_acquire) >= rutz::trace_recorder::ring_size)
+      {
+        r->dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+      }
+
+    event& e = r->buf[h & RING_MASK];
+    e.ns = ns;
+    e.prof_id = prof_id;
+    e.thread = r->index;
+    e.kind = kind;
+
+    r->head.store(h + 1, std::memory_order_release);
+  }
+
+  //
+  // the drainer
+  //
+
+  struct drainer
+  {
+    explicit drainer(FILE* f) :
+      file(f), thread(), mutex(), cv(), stop(false), named(), buf()
+    {}
+
+    FILE*                   file;
+    std::thread             thread;
+    std::mutex              mutex;
+    std::condition_variable cv;
+    bool                    stop;
+    std::vector<bool>       named;
+    std::vector<event>      buf;
+  };
+
+  drainer*                g_drainer = nullptr;
+  std::mutex              g_control_mutex;
+  std::once_flag          g_atexit_once;
+  std::atomic<uint64_t>   g_written(0);
+  uint64_t                g_final_dropped = 0;
+
+  template <class T>
+  void put(FILE* f, const T& val)
+  {
+    fwrite(&val, sizeof(T), 1, f);
+  }
+
+  void write_names(drainer& d)
+  {
+    // collect the ids in this batch that haven't been named yet
+    std::vector<uint32_t> missing;
+    for (const event& e: d.buf)
+      {
+        if (e.prof_id >= d.named.size())
+          d.named.resize(e.prof_id + 1, false);
+        if (!d.named[e.prof_id])
+          {
+            missing.push_back(e.prof_id);
+            d.named[e.prof_id] = true;
+          }
+      }
+
+    if (missing.empty())
+      return;
+
+    std::sort(missing.begin(), missing.end());
+
+    rutz::prof::for_each_prof
+      ([&d, &missing](const rutz::prof& p)
+       {
+         if (!std::binary_search(missing.begin(), missing.end(), p.id()))
+           return;
+
+         const char* name = p.context_name();
+         const uint32_t len = uint32_t(strlen(name));
+         put(d.file, uint32_t(TAG_NAME));
+         put(d.file, uint32_t(p.id()));
+         put(d.file, len);
+         fwrite(name, 1, len, d.file);
+       });
+  }
+
+  void drain_once(drainer& d)
+  {
+    std::vector<ring*> rings;
+
+    {
+      GVX_MUTEX_LOCK(g_rings_mutex);
+      if (g_rings != nullptr)
+        rings = *g_rings;
+    }
+
+    for (ring* r: rings)
+      {
+        const uint32_t h = r->head.load(std::memory_order_acquire);
+        const uint32_t t = r->tail.load(std::memory_order_relaxed);
+
+        if (h == t)
+          continue;
+
+        d.buf.clear();
+        for (uint32_t i = t; i != h; ++i)
+          d.buf.push_back(r->buf[i & RING_MASK]);
+
+        r->tail.store(h, std::memory_order_release);
+
+        if (!r->announced)
+          {
+            put(d.file, uint32_t(TAG_THREAD));
+            put(d.file, uint32_t(r->index));
+            put(d.file, int64_t(r->os_tid));
+            r->announced = true;
+          }
+
+        write_names(d);
+
+        put(d.file, uint32_t(TAG_EVENTS));
+        put(d.file, uint32_t(d.buf.size()));
+        fwrite(&d.buf[0], sizeof(event), d.buf.size(), d.file);
+
+        g_written.fetch_add(d.buf.size(), std::memory_order_relaxed);
+      }
+
+    fflush(d.file);
+  }
+
+  void drain_loop(drainer* d)
+  {
+    std::unique_lock<std::mutex> lock(d->mutex);
+
+    while (!d->stop)
+      {
+        d->cv.wait_for(lock, std::chrono::milliseconds(10));
+        lock.unlock();
+        drain_once(*d);
+        lock.lock();
+      }
+
+    lock.unlock();
+    drain_once(*d);
+  }
+
+  uint64_t total_dropped() noexcept
+  {
+    GVX_MUTEX_LOCK(g_rings_mutex);
+
+    uint64_t n = 0;
+    if (g_rings != nullptr)
+      for (const ring* r: *g_rings)
+        n += r->dropped.load(std::memory_order_relaxed);
+    return n;
+  }
+
+  // So that a recording that is still running at exit isn't cut
+  // short.
+  void stop_at_exit()
+  {
+    rutz::trace_recorder::stop();
+  }
+
+  void json_string(std::ostream& os, const std::string& s)
+  {
+    os << '"';
+    for (char c: s)
+      {
+        if (c == '"' || c == '\\')
+          os << '\\' << c;
+        else if (static_cast<unsigned char>(c) < 0x20)
+          os << ' ';
+        else
+          os << c;
+      }
+    os << '"';
+  }
+}
+
+///////////////////////////////////////////////////////////////////////
+//
+// rutz::trace_recorder member definitions
+//
+///////////////////////////////////////////////////////////////////////
+
+std::atomic<bool> rutz::trace_recorder::s_recording(false);
+
+void rutz::trace_recorder::start(const char* fname)
+{
+  GVX_MUTEX_LOCK(g_control_mutex);
+
+  if (g_drainer != nullptr)
+    throw rutz::error("trace recording is already in progress", SRC_POS);
+
+  FILE* f = fopen(fname, "wb");
+
+  if (f == nullptr)
+    throw rutz::error(rutz::sfmt("couldn't open trace file '%s' "
+                                 "for writing", fname), SRC_POS);
+
+  fwrite("GVXTRACE", 1, 8, f);
+  put(f, FILE_VERSION);
+  put(f, uint32_t(0));
+
+  // forget anything left over in the rings from a previous recording
+  {
+    GVX_MUTEX_LOCK(g_rings_mutex);
+    if (g_rings != nullptr)
+      for (ring* r: *g_rings)
+        {
+          r->tail.store(r->head.load(std::memory_order_acquire),
+                        std::memory_order_release);
+          r->dropped.store(0, std::memory_order_relaxed);
+          r->announced = false;
+        }
+  }
+
+  g_written.store(0);
+
+  drainer* d = new drainer(f);
+
+  try
+    {
+      d->thread = std::thread(&drain_loop, d);
+    }
+  catch (...)
+    {
+      fclose(f);
+      delete d;
+      throw;
+    }
+
+  g_drainer = d;
+  s_recording.store(true);
+
+  std::call_once(g_atexit_once, [](){ atexit(&stop_at_exit); });
+}
+
+void rutz::trace_recorder::stop() noexcept
+{
+  GVX_MUTEX_LOCK(g_control_mutex);
+
+  if (g_drainer == nullptr)
+    return;
+
+  s_recording.store(false);
+
+  drainer* d = g_drainer;
+  g_drainer = nullptr;
+
+  {
+    GVX_MUTEX_LOCK(d->mutex);
+    d->stop = true;
+  }
+  d->cv.notify_one();
+  d->thread.join();
+
+  g_final_dropped = total_dropped();
+
+  put(d->file, uint32_t(TAG_DROPPED));
+  put(d->file, uint64_t(g_final_dropped));
+  fclose(d->file);
+
+  delete d;
+}
+
+rutz::time rutz::trace_recorder::record_begin(const rutz::prof& p) noexcept
+{
+  const uint64_t ns = now_ns();
+  push_event(p.id(), 0, ns);
+  return time_from_ns(ns);
+}
+
+rutz::time rutz::trace_recorder::record_end(const rutz::prof& p) noexcept
+{
+  const uint64_t ns = now_ns();
+  push_event(p.id(), 1, ns);
+  return time_from_ns(ns);
+}
+
+unsigned long long rutz::trace_recorder::num_written() noexcept
+{
+  return g_written.load();
+}
+
+unsigned long long rutz::trace_recorder::num_dropped() noexcept
+{
+  GVX_MUTEX_LOCK(g_control_mutex);
+
+  return g_drainer != nullptr ? total_dropped() : g_final_dropped;
+}
+
+void rutz::trace_recorder::write_chrome_trace(const char* fname,
+                                              std::ostream& os)
+{
+  FILE* f = fopen(fname, "rb");
+
+  if (f == nullptr)
+    throw rutz::error(rutz::sfmt("couldn't open trace file '%s'", fname),
+                      SRC_POS);
+
+  std::vector<char> data;
+  char buf[65536];
+  size_t n;
+  while ((n = fread(buf, 1, sizeof(buf), f)) > 0)
+    data.insert(data.end(), buf, buf + n);
+  fclose(f);
+
+  size_t pos = 0;
+
+  auto get = [&](void* dst, size_t len)
+    {
+      if (pos + len > data.size())
+        throw rutz::error(rutz::sfmt("truncated trace file '%s'", fname),
+                          SRC_POS);
+      memcpy(dst, &data[pos], len);
+      pos += len;
+    };
+
+  char magic[8];
+  uint32_t version = 0, padding = 0;
+  if (data.size() < 16)
+    throw rutz::error(rutz::sfmt("'%s' is not a trace file", fname), SRC_POS);
+  get(magic, 8);
+  get(&version, 4);
+  get(&padding, 4);
+  if (memcmp(magic, "GVXTRACE", 8) != 0 || version != FILE_VERSION)
+    throw rutz::error(rutz::sfmt("'%s' is not a trace file", fname), SRC_POS);
+
+  std::map<uint32_t, std::string> names;
+  std::map<uint32_t, int64_t> threads;
+  std::vector<event> events;
+
+  while (pos < data.size())
+    {
+      uint32_t tag;
+      get(&tag, 4);
+
+      switch (tag)
+        {
+        case TAG_NAME:
+          {
+            uint32_t id, len;
+            get(&id, 4);
+            get(&len, 4);
+            std::string name(len, '\0');
+            if (len > 0)
+              get(&name[0], len);
+            names[id] = name;
+          }
+          break;
+        case TAG_THREAD:
+          {
+            uint32_t index;
+            int64_t tid;
+            get(&index, 4);
+            get(&tid, 8);
+            threads[index] = tid;
+          }
+          break;
+        case TAG_EVENTS:
+          {
+            uint32_t count;
+            get(&count, 4);
+            const size_t first = events.size();
+            events.resize(first + count);
+            if (count > 0)
+              get(&events[first], count * sizeof(event));
+          }
+          break;
+        case TAG_DROPPED:
+          {
+            uint64_t dropped;
+            get(&dropped, 8);
+          }
+          break;
+        default:
+          throw rutz::error(rutz::sfmt("bad record in trace file '%s'",
+                                       fname), SRC_POS);
+        }
+    }
+
+  uint64_t t0 = ~uint64_t(0);
+  for (const event& e: events)
+    t0 = std::min(t0, e.ns);
+
+  char line[128];
+
+  os << "{\"traceEvents\":[";
+
+  bool first = true;
+
+  for (const auto& t: threads)
+    {
+      snprintf(line, sizeof(line),
+               "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,"
+               "\"args\":{\"name\":\"thread %u (tid %lld)\"}}",
+               first ? "" : ",", t.first, t.first, (long long) t.second);
+      os << line;
+      first = false;
+    }
+
+  std::map<uint16_t, unsigned int> depth;
+
+  for (const event& e: events)
+    {
+      unsigned int& dep = depth[e.thread];
+
+      if (e.kind == 1)
+        {
+          if (dep == 0)
+            continue;
+          --dep;
+        }
+      else
+        ++dep;
+
+      os << (first ? "\n" : ",\n") << "{\"name\":";
+      first = false;
+      auto itr = names.find(e.prof_id);
+      json_string(os, itr != names.end()
+                  ? itr->second
+                  : std::string(rutz::sfmt("prof#%u", e.prof_id).c_str()));
+      snprintf(line, sizeof(line),
+               ",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":1,\"tid\":%u}",
+               e.kind == 0 ? 'B' : 'E', double(e.ns - t0) / 1000.0,
+               unsigned(e.thread));
+      os << line;
+    }
+
+  os << "\n],\n\"displayTimeUnit\":\"ms\"}\n";
+}
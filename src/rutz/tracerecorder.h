@@ -0,0 +1,119 @@
+/** @file rutz/tracerecorder.h record rutz::trace begin/end events into
+    per-thread ring buffers, drained to a binary trace file */
+
+///////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026-2026 Rob Peters
+// Rob Peters <https://github.com/rjpcal/>
+//
+// created: Mon Oct 19 13:27:52 2026
+//
+// --------------------------------------------------------------------
+//
+// This file is part of GroovX.
+//   [https://github.com/rjpcal/groovx]
+//
+// GroovX is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// GroovX is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GroovX; if not, write to the Free Software Foundation,
+// Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef GROOVX_RUTZ_TRACERECORDER_H_UTC20261019132752_DEFINED
+#define GROOVX_RUTZ_TRACERECORDER_H_UTC20261019132752_DEFINED
+
+#include "rutz/time.h"
+
+#include <atomic>
+#include <iosfwd>
+
+namespace rutz
+{
+  class prof;
+  class trace_recorder;
+}
+
+/// Low-overhead recording of every rutz::trace scope, for always-on tracing.
+/** While recording, each rutz::trace stores a begin and an end event
+    (steady_clock timestamp in nanoseconds, rutz::prof::id(), and
+    thread) into a lock-free single-producer/single-consumer ring
+    buffer owned by the calling thread. A background drainer thread
+    empties all rings every few milliseconds and appends the events to
+    a binary trace file. Nothing on the recording path blocks,
+    allocates (except once per thread) or makes a system call; if a
+    ring fills up faster than it is drained, events are dropped and
+    counted.
+
+    The recorded timestamps also supply the elapsed times that
+    rutz::trace adds into each rutz::prof, so while recording the prof
+    data holds steady-clock wall time whatever the timing_mode.
+
+    The file holds native-endian binary records. It begins with the
+    8-byte magic "GVXTRACE" and a uint32 version (1) plus a uint32 of
+    padding. Each record after that starts with a uint32 tag:
+
+    - 'N': uint32 prof id, uint32 length, then that many bytes of the
+      prof's context name. Written once per id, before any events for
+      that id.
+    - 'T': uint32 thread index, int64 OS thread id. Written once per
+      thread, before any of its events.
+    - 'E': uint32 count, then count events of 16 bytes each: uint64
+      nanoseconds, uint32 prof id, uint16 thread index, uint16 kind (0
+      = begin, 1 = end).
+    - 'D': uint64 number of dropped events. Written once, at the end.
+
+    Use write_chrome_trace() to convert a trace file into Chrome
+    trace-event JSON.
+ */
+class rutz::trace_recorder
+{
+public:
+  /// Capacity of each thread's ring buffer, in events.
+  static const unsigned int ring_size = 1u << 16;
+
+  /// Query whether events are currently being recorded.
+  static bool is_recording() noexcept
+  { return s_recording.load(std::memory_order_relaxed); }
+
+  /// Start recording into the named file, replacing its contents.
+  /** Throws a rutz::error if already recording, or if the file can't
+      be opened. */
+  static void start(const char* fname);
+
+  /// Stop recording, write out all pending events, and close the file.
+  /** Does nothing if not recording. */
+  static void stop() noexcept;
+
+  /// Record a begin event for \a p; returns the event timestamp.
+  static rutz::time record_begin(const rutz::prof& p) noexcept;
+
+  /// Record an end event for \a p; returns the event timestamp.
+  static rutz::time record_end(const rutz::prof& p) noexcept;
+
+  /// Number of events written to the file since start().
+  static unsigned long long num_written() noexcept;
+
+  /// Number of events dropped (due to full rings) since start().
+  static unsigned long long num_dropped() noexcept;
+
+  /// Convert the binary trace file \a fname into Chrome trace-event JSON.
+  /** End events without a matching begin (from scopes that were
+      already running when recording started) are skipped. Throws a
+      rutz::error if the file can't be read or isn't a trace file. */
+  static void write_chrome_trace(const char* fname, std::ostream& os);
+
+private:
+  static std::atomic<bool> s_recording;
+};
+
+#endif // !GROOVX_RUTZ_TRACERECORDER_H_UTC20261019132752_DEFINED
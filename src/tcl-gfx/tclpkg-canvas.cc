@@ -31,10 +31,12 @@
 #include "tcl-gfx/tclpkg-canvas.h"
 
 #include "gfx/canvas.h"
+#include "gfx/curvecache.h"
 #include "gfx/glcanvas.h"
 
 #include "media/bmapdata.h"
 
+#include "tcl/list.h"
 #include "tcl/objpkg.h"
 #include "tcl/pkg.h"
 
@@ -85,6 +87,19 @@ namespace
     const geom::vec2i tl = vp.top_left();
     return canvas->worldFromScreen3(geom::vec3d(tl.x(), tl.y(), 0.5));
   }
+
+  // Returns the curve cache counters as a {hits N misses N vertices N}
+  // dict.
+  tcl::list curveCacheStats()
+  {
+    const Gfx::CurveCache::Stats stats = Gfx::CurveCache::stats();
+
+    tcl::list result;
+    result.append("hits");     result.append(stats.hits);
+    result.append("misses");   result.append(stats.misses);
+    result.append("vertices"); result.append(stats.vertices);
+    return result;
+  }
 }
 
 extern "C"
@@ -103,6 +118,13 @@ GVX_TRACE("Canvas_Init");
 
       pkg->def("throwIfError", "",
                [](nub::ref<Gfx::Canvas> c){c->throwIfError("", SRC_POS);}, SRC_POS);
+
+      pkg->def("curveTolerance", "", &Gfx::curveTolerance, SRC_POS);
+      pkg->def("curveTolerance", "pixels", &Gfx::setCurveTolerance, SRC_POS);
+      pkg->def("curveCacheStats", "", &curveCacheStats, SRC_POS);
+      pkg->def("resetCurveCacheStats", "", &Gfx::CurveCache::resetStats, SRC_POS);
+      pkg->def("curveCaching", "", &Gfx::CurveCache::isCaching, SRC_POS);
+      pkg->def("curveCaching", "on_off", &Gfx::CurveCache::setCaching, SRC_POS);
     });
 }
 
@@ -119,5 +141,6 @@ GVX_TRACE("Glcanvas_Init");
 
       pkg->def( "pixelCheckSum", "glcanvas x y w h", &pixelCheckSum, SRC_POS );
       pkg->def( "pixelCheckSum", "glcanvas", &pixelCheckSumAll, SRC_POS );
+      pkg->def( "swapInterval", "glcanvas interval", &GLCanvas::setSwapInterval, SRC_POS );
     });
 }
@@ -80,11 +80,23 @@ namespace
     return item->contains(other.get());
   }
 
-  void gxtcl_savePS(nub::ref<GxNode> item, const char* filename)
+  // Returns a list of {label nbytes} pairs, giving the amount of
+  // PostScript written for each type of node.
+  tcl::list gxtcl_savePS(nub::ref<GxNode> item, const char* filename)
   {
     Gfx::PSCanvas canvas(filename);
 
     item->draw(canvas);
+
+    tcl::list result;
+    for (const auto& p: canvas.bytesPerLabel())
+      {
+        tcl::list pair;
+        pair.append(p.first);
+        pair.append(static_cast<unsigned long>(p.second));
+        result.append(pair);
+      }
+    return result;
   }
 
   void gxtcl_addChildren(nub::ref<GxSeparator> sep, const tcl::list& objs)
@@ -105,6 +117,19 @@ namespace
     return obj->getBoundingBox(*canvas);
   }
 
+  // Returns the bounds cache counters as a {hits N misses N uncached N}
+  // dict.
+  tcl::list gxtcl_boundsCacheStats()
+  {
+    const GxNode::BoundsCacheStats stats = GxNode::boundsCacheStats();
+
+    tcl::list result;
+    result.append("hits");     result.append(stats.hits);
+    result.append("misses");   result.append(stats.misses);
+    result.append("uncached"); result.append(stats.uncached);
+    return result;
+  }
+
   rutz::fstring gxtcl_gxsepFields()
   {
     static rutz::fstring result =
@@ -177,6 +202,10 @@ GVX_TRACE("Gxnode_Init");
       pkg->def_vec("deepChildren", "objref(s)", &GxNode::deepChildren, 1, SRC_POS);
       pkg->def_vec("boundingBox", "objref(s) canvas", &gxtcl_boundingBox, 1, SRC_POS);
       pkg->def( "savePS", "objref filename", &gxtcl_savePS, SRC_POS );
+      pkg->def( "boundsCacheStats", "", &gxtcl_boundsCacheStats, SRC_POS );
+      pkg->def( "resetBoundsCacheStats", "", &GxNode::resetBoundsCacheStats, SRC_POS );
+      pkg->def( "boundsCaching", "", &GxNode::isBoundsCaching, SRC_POS );
+      pkg->def( "boundsCaching", "on_off", &GxNode::setBoundsCaching, SRC_POS );
     });
 }
 
@@ -393,6 +422,7 @@ GVX_TRACE("Gxshapekit_Init");
 
       pkg->link_var_copy("GxShapeKit::DIRECT", GxCache::DIRECT);
       pkg->link_var_copy("GxShapeKit::GLCOMPILE", GxCache::GLCOMPILE);
+      pkg->link_var_copy("GxShapeKit::RECORD", GxCache::RECORD);
 
       pkg->link_var_copy("GxShapeKit::NATIVE_SCALING", GxScaler::NATIVE_SCALING);
       pkg->link_var_copy("GxShapeKit::MAINTAIN_ASPECT_SCALING", GxScaler::MAINTAIN_ASPECT_SCALING);
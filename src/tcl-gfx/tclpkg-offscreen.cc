@@ -0,0 +1,156 @@
+/** @file tcl-gfx/tclpkg-offscreen.cc tcl interface package for rendering
+    GxNode objects offscreen, without a window */
+
+///////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026-2026 Rob Peters
+// Rob Peters <https://github.com/rjpcal/>
+//
+// created: Mon Oct 19 11:51:36 2026
+//
+// --------------------------------------------------------------------
+//
+// This file is part of GroovX.
+//   [https://github.com/rjpcal/groovx]
+//
+// GroovX is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// GroovX is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GroovX; if not, write to the Free Software Foundation,
+// Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include "tcl-gfx/tclpkg-offscreen.h"
+
+#include "geom/rect.h"
+
+#include "gfx/gxcamera.h"
+#include "gfx/gxnode.h"
+#include "gfx/offscreenrenderer.h"
+#include "gfx/softcanvas.h"
+
+#include "media/bmapdata.h"
+#include "media/imgfile.h"
+
+#include "tcl/list.h"
+#include "tcl/pkg.h"
+
+#include "rutz/fstring.h"
+
+#include <vector>
+
+#include "rutz/trace.h"
+
+namespace
+{
+  //--------------------------------------------------------------------
+  //
+  // renderBatch --
+  //
+  // Renders each of a list of GxNode objects into a width x height
+  // offscreen buffer, saving frame i to the i'th of a list of
+  // filenames (or nowhere, if the filename list is empty), and
+  // returns a list of the image hashes of the frames. With nworkers
+  // greater than one, the frames are rendered in parallel by forked
+  // worker processes; the results are the same either way.
+  //
+  //--------------------------------------------------------------------
+
+  tcl::list renderBatch(const tcl::list& objs, const tcl::list& names,
+                        int width, int height, unsigned int nworkers)
+  {
+    std::vector<nub::ref<GxNode>> nodes;
+    for (const auto& noderef: objs.view_of<nub::ref<GxNode>>())
+      nodes.push_back(noderef);
+
+    std::vector<rutz::fstring> filenames;
+    for (const auto& name: names.view_of<rutz::fstring>())
+      filenames.push_back(name);
+
+    const std::vector<uint32_t> hashes =
+      OffscreenRenderer::renderBatch(width, height, nodes, filenames,
+                                     nworkers);
+
+    tcl::list result;
+    for (uint32_t h: hashes)
+      result.append(static_cast<unsigned long>(h));
+    return result;
+  }
+
+  unsigned long render(nub::ref<GxNode> node, const char* filename,
+                       int width, int height)
+  {
+    std::vector<nub::ref<GxNode>> nodes(1, node);
+    std::vector<rutz::fstring> filenames(1, rutz::fstring(filename));
+
+    return OffscreenRenderer::renderBatch(width, height, nodes,
+                                          filenames, 1).at(0);
+  }
+
+  //--------------------------------------------------------------------
+  //
+  // softRender --
+  //
+  // Like render, but rasterizes on the CPU with a Gfx::SoftCanvas
+  // (using nthreads threads), so no OpenGL is needed at all. The
+  // image hash doesn't depend on nthreads.
+  //
+  //--------------------------------------------------------------------
+
+  unsigned long softRender(nub::ref<GxNode> node, const char* filename,
+                           int width, int height, unsigned int nthreads)
+  {
+    Gfx::SoftCanvas canvas(width, height);
+    canvas.setNumThreads(nthreads);
+
+    nub::ref<GxCamera> camera(GxFixedScaleCamera::make(),
+                              nub::ref_vis_private());
+    camera->reshape(canvas, width, height);
+
+    canvas.clearColorBuffer();
+
+    {
+      Gfx::MatrixSaver msaver(canvas);
+      Gfx::AttribSaver asaver(canvas);
+
+      camera->draw(canvas);
+      node->draw(canvas);
+    }
+
+    canvas.finishDrawing();
+
+    const media::bmap_data frame =
+      canvas.grabPixels(canvas.getScreenViewport());
+
+    if (filename != nullptr && filename[0] != '\0')
+      media::save_image(filename, frame);
+
+    return frame.bkdr_hash();
+  }
+}
+
+extern "C"
+int Offscreen_Init(Tcl_Interp* interp)
+{
+GVX_TRACE("Offscreen_Init");
+
+  return tcl::pkg::init
+    (interp, "Offscreen", "4.0",
+     [](tcl::pkg* pkg) {
+      pkg->def("render", "objref filename width height",
+               &render, SRC_POS);
+      pkg->def("renderBatch", "objrefs filenames width height nworkers",
+               &renderBatch, SRC_POS);
+      pkg->def("softRender", "objref filename width height nthreads",
+               &softRender, SRC_POS);
+    });
+}
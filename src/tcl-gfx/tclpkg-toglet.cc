@@ -34,6 +34,7 @@
 #include "gfx/glcanvas.h"
 #include "gfx/gxcamera.h"
 #include "gfx/gxnode.h"
+#include "gfx/gxscene.h"
 
 #include "nub/objfactory.h"
 #include "nub/ref.h"
@@ -46,6 +47,11 @@
 #include "tcl-gfx/vectcl.h"
 
 #include "rutz/error.h"
+#include "rutz/fstring.h"
+#include "rutz/sfmt.h"
+
+#include <fstream>
+#include <sstream>
 
 #include "rutz/trace.h"
 
@@ -61,6 +67,86 @@ namespace
     return item->id();
   }
 
+  // Returns the widget's redraw counters as a
+  // {frames N partialFrames N lastPixels N pixels N} dict.
+  tcl::list damageStats(nub::soft_ref<Toglet> widg)
+  {
+    const GxScene::DamageStats stats = widg->scene().damageStats();
+
+    tcl::list result;
+    result.append("frames");        result.append(stats.frames);
+    result.append("partialFrames"); result.append(stats.partialFrames);
+    result.append("lastPixels");    result.append(stats.lastPixels);
+    result.append("pixels");        result.append((long long)(stats.pixels));
+    return result;
+  }
+
+  void resetDamageStats(nub::soft_ref<Toglet> widg)
+  {
+    widg->scene().resetDamageStats();
+  }
+
+  // Returns the frames in the widget's frame log, oldest first, as a
+  // list of {start rendered swapped presented} msec timestamps.
+  tcl::list frameLog(nub::soft_ref<Toglet> widg)
+  {
+    const Gfx::FrameLog& log = widg->scene().frameLog();
+
+    tcl::list result;
+    for (size_t i = 0; i < log.size(); ++i)
+      {
+        const Gfx::FrameLog::Times& f = log.at(i);
+        tcl::list row;
+        row.append(f.start);
+        row.append(f.rendered);
+        row.append(f.swapped);
+        row.append(f.presented);
+        result.append(row);
+      }
+    return result;
+  }
+
+  // Returns a summary of the widget's frame log as a dict.
+  tcl::list frameLogStats(nub::soft_ref<Toglet> widg)
+  {
+    const Gfx::FrameLog::Stats stats = widg->scene().frameLog().stats();
+
+    tcl::list result;
+    result.append("frames");       result.append(stats.frames);
+    result.append("held");         result.append(stats.held);
+    result.append("meanRender");   result.append(stats.meanRender);
+    result.append("maxRender");    result.append(stats.maxRender);
+    result.append("meanInterval"); result.append(stats.meanInterval);
+    result.append("maxInterval");  result.append(stats.maxInterval);
+    result.append("sdInterval");   result.append(stats.sdInterval);
+    return result;
+  }
+
+  void clearFrameLog(nub::soft_ref<Toglet> widg)
+  {
+    widg->scene().frameLog().clear();
+  }
+
+  // Returns the frame log in the text format read by mtx::scan.
+  rutz::fstring frameLogMtx(nub::soft_ref<Toglet> widg)
+  {
+    std::ostringstream oss;
+    widg->scene().frameLog().writeMtx(oss);
+    return rutz::fstring(oss.str().c_str());
+  }
+
+  void saveFrameLog(nub::soft_ref<Toglet> widg, const char* filename)
+  {
+    std::ofstream ofs(filename);
+    if (ofs.fail())
+      {
+        throw rutz::error(rutz::sfmt("error opening file: %s",
+                                     filename), SRC_POS);
+      }
+
+    widg->scene().frameLog().writeMtx(ofs);
+  }
+
   // We need to eagerly drop references to objects at shutdown time,
   // because Tcl tends to prematurely unload dynamically-loaded
   // packages... so we need to make sure we don't have any references
@@ -109,6 +195,16 @@ GVX_TRACE("Toglet_Init");
       pkg->def("animate", "objref(s) frames_per_second", &Toglet::animate, SRC_POS);
       pkg->def_get_set("camera", &Toglet::getCamera, &Toglet::setCamera, SRC_POS);
       pkg->def_getter("canvas", &Toglet::getCanvas, SRC_POS);
+      pkg->def_get_set("damageTracking", &Toglet::isDamageTracking, &Toglet::setDamageTracking, SRC_POS);
+      pkg->def("damageStats", "objref", &damageStats, SRC_POS);
+      pkg->def("resetDamageStats", "objref", &resetDamageStats, SRC_POS);
+      pkg->def_get_set("frameLogSize", &Toglet::frameLogSize, &Toglet::setFrameLogSize, SRC_POS);
+      pkg->def_get_set("frameLogWaitPresent", &Toglet::isFrameLogWaitPresent, &Toglet::setFrameLogWaitPresent, SRC_POS);
+      pkg->def("frameLog", "objref", &frameLog, SRC_POS);
+      pkg->def("frameLogStats", "objref", &frameLogStats, SRC_POS);
+      pkg->def("frameLogMtx", "objref", &frameLogMtx, SRC_POS);
+      pkg->def("clearFrameLog", "objref", &clearFrameLog, SRC_POS);
+      pkg->def("saveFrameLog", "objref filename", &saveFrameLog, SRC_POS);
       pkg->def_action("clearscreen", &Toglet::fullClearscreen, SRC_POS);
       pkg->def("hold", "objref(s) hold_on", &Toglet::setHold, SRC_POS);
       pkg->def("setVisible", "objref(s) visibility", &Toglet::setVisibility, SRC_POS);
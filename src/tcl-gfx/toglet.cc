@@ -331,7 +331,7 @@ void Toglet::swapBuffers()
 {
 GVX_TRACE("Toglet::swapBuffers");
   makeCurrent();
-  rep->canvas->flushOutput();
+  rep->scene->flushOutput();
 }
 
 GxScene& Toglet::scene()
@@ -411,3 +411,34 @@ void Toglet::animate(unsigned int framesPerSecond)
   makeCurrent();
   rep->scene->animate(framesPerSecond);
 }
+
+void Toglet::setDamageTracking(bool val)
+{
+  makeCurrent();
+  rep->scene->setDamageTracking(val);
+}
+
+bool Toglet::isDamageTracking() const
+{
+  return rep->scene->isDamageTracking();
+}
+
+void Toglet::setFrameLogSize(unsigned int n)
+{
+  rep->scene->frameLog().setCapacity(n);
+}
+
+unsigned int Toglet::frameLogSize() const
+{
+  return (unsigned int)(rep->scene->frameLog().capacity());
+}
+
+void Toglet::setFrameLogWaitPresent(bool val)
+{
+  rep->scene->frameLog().setWaitForPresent(val);
+}
+
+bool Toglet::isFrameLogWaitPresent() const
+{
+  return rep->scene->frameLog().isWaitingForPresent();
+}
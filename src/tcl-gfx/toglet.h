@@ -111,6 +111,12 @@ public:
   void setCamera(const nub::ref<GxCamera>& cam);
   void setDrawable(const nub::ref<GxNode>& node);
   void animate(unsigned int framesPerSecond);
+  void setDamageTracking(bool val);
+  bool isDamageTracking() const;
+  void setFrameLogSize(unsigned int n);
+  unsigned int frameLogSize() const;
+  void setFrameLogWaitPresent(bool val);
+  bool isFrameLogWaitPresent() const;
 
 
 private:
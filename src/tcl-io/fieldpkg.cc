@@ -35,12 +35,18 @@
 
 #include "nub/ref.h"
 
+#include "tcl/conversions.h"
 #include "tcl/list.h"
 
 #include "tcl-io/objreader.h"
 #include "tcl-io/objwriter.h"
 
+#include "rutz/error.h"
 #include "rutz/iter.h"
+#include "rutz/sfmt.h"
+
+#include <cstring>
+#include <tcl.h>
 
 #include "rutz/trace.h"
 #include "rutz/debug.h"
@@ -64,44 +70,50 @@ namespace
 
     typedef void retn_t;
 
+    void appendField(const Field& field);
+
     void operator()(tcl::call_context& ctx);
   };
 
+  void FieldsLister::appendField(const Field& field)
+  {
+    tcl::list sub_list;
+
+    sub_list.append(field.name());           // property name
+    sub_list.append(field.min());            // min value
+    sub_list.append(field.max());            // max value
+    sub_list.append(field.res());            // resolution value
+
+    tcl::list flags;
+    if (field.startsNewGroup()) flags.append("NEW_GROUP");
+    if (field.isTransient())    flags.append("TRANSIENT");
+    if (field.isString())       flags.append("STRING");
+    if (field.isMultiValued())  flags.append("MULTI");
+    if (field.isChecked())      flags.append("CHECKED");
+    if (!field.allowGet())      flags.append("NO_GET");
+    if (!field.allowSet())      flags.append("NO_SET");
+    if (field.isPrivate())      flags.append("PRIVATE");
+    if (field.isBoolean())      flags.append("BOOLEAN");
+
+    sub_list.append(flags);
+
+    itsFieldList.append(sub_list);
+  }
+
   void FieldsLister::operator()(tcl::call_context& ctx)
   {
   GVX_TRACE("tcl::FieldsLister::operator()");
     if (!isItInited)
     {
-      for (const FieldMap* fmap = &itsFields;
-           fmap != nullptr;
-           fmap = isItRecursive ? fmap->parent() : 0)
+      if (isItRecursive)
         {
-          for (FieldMap::Iterator itr(fmap->ioFields()); itr.is_valid(); ++itr)
-            {
-              const Field& field = *itr;
-
-              tcl::list sub_list;
-
-              sub_list.append(field.name());           // property name
-              sub_list.append(field.min());            // min value
-              sub_list.append(field.max());            // max value
-              sub_list.append(field.res());            // resolution value
-
-              tcl::list flags;
-              if (field.startsNewGroup()) flags.append("NEW_GROUP");
-              if (field.isTransient())    flags.append("TRANSIENT");
-              if (field.isString())       flags.append("STRING");
-              if (field.isMultiValued())  flags.append("MULTI");
-              if (field.isChecked())      flags.append("CHECKED");
-              if (!field.allowGet())      flags.append("NO_GET");
-              if (!field.allowSet())      flags.append("NO_SET");
-              if (field.isPrivate())      flags.append("PRIVATE");
-              if (field.isBoolean())      flags.append("BOOLEAN");
-
-              sub_list.append(flags);
-
-              itsFieldList.append(sub_list);
-            }
+          for (unsigned int i = 0; i < itsFields.numAllFields(); ++i)
+            appendField(itsFields.allFieldAt(i));
+        }
+      else
+        {
+          for (FieldMap::Iterator itr(itsFields.ioFields()); itr.is_valid(); ++itr)
+            appendField(*itr);
         }
 
       isItInited = true;
@@ -109,6 +121,66 @@ namespace
 
     ctx.set_result(itsFieldList);
   }
+
+  // Resolve all the objrefs in one objectdb pass.
+  std::vector<FieldContainer*> getContainers(const tcl::list& objrefs)
+  {
+    const unsigned int n = objrefs.length();
+
+    std::vector<FieldContainer*> result(n);
+
+    if (n == 0)
+      return result;
+
+    std::vector<nub::uid> ids(n);
+    tcl::convert_array(objrefs.elements(), n, &ids[0]);
+
+    std::vector<nub::object*> items(n);
+    nub::detail::get_items(&ids[0], n, &items[0], true);
+
+    for (unsigned int i = 0; i < n; ++i)
+      {
+        result[i] = dynamic_cast<FieldContainer*>(items[i]);
+        if (result[i] == nullptr)
+          rutz::throw_bad_cast(typeid(FieldContainer), typeid(nub::object),
+                               SRC_POS);
+      }
+
+    return result;
+  }
+
+  // The byte array holds the values as packed native-endian doubles,
+  // i.e. the same layout as [binary format d* $values].
+  tcl::obj getFieldBytes(const tcl::list& objrefs,
+                         const rutz::fstring& name)
+  {
+    const std::vector<double> vals = tcl::getNumericField(objrefs, name);
+
+    return Tcl_NewByteArrayObj
+      (reinterpret_cast<const unsigned char*>(vals.data()),
+       int(vals.size() * sizeof(double)));
+  }
+
+  void setFieldBytes(const tcl::list& objrefs,
+                     const rutz::fstring& name,
+                     const tcl::obj& bytes)
+  {
+    int len = 0;
+    const unsigned char* data =
+      Tcl_GetByteArrayFromObj(bytes.get(), &len);
+
+    if (len % sizeof(double) != 0)
+      throw rutz::error(rutz::sfmt("byte array length %d is not a "
+                                   "multiple of %u", len,
+                                   unsigned(sizeof(double))), SRC_POS);
+
+    // copy out in case the bytes aren't suitably aligned for double
+    std::vector<double> vals(len / sizeof(double));
+    if (!vals.empty())
+      std::memcpy(&vals[0], data, len);
+
+    tcl::setNumericField(objrefs, name, vals.data(), vals.size());
+  }
 }
 
 ///////////////////////////////////////////////////////////////////////
@@ -117,6 +189,33 @@ namespace
 //
 ///////////////////////////////////////////////////////////////////////
 
+std::vector<double> tcl::getNumericField(const tcl::list& objrefs,
+                                         const rutz::fstring& name)
+{
+GVX_TRACE("tcl::getNumericField");
+
+  const std::vector<FieldContainer*> objs = getContainers(objrefs);
+
+  std::vector<double> result(objs.size());
+
+  FieldContainer::getNumericField(name, objs.data(), objs.size(),
+                                  result.data());
+
+  return result;
+}
+
+void tcl::setNumericField(const tcl::list& objrefs,
+                          const rutz::fstring& name,
+                          const double* vals, size_t nvals)
+{
+GVX_TRACE("tcl::setNumericField");
+
+  const std::vector<FieldContainer*> objs = getContainers(objrefs);
+
+  FieldContainer::setNumericField(name, objs.data(), objs.size(),
+                                  vals, nvals);
+}
+
 void tcl::defField(tcl::pkg* pkg, const Field& field,
                    const rutz::file_pos& src_pos)
 {
@@ -143,12 +242,9 @@ void tcl::defAllFields(tcl::pkg* pkg, const FieldMap& fieldmap,
 {
 GVX_TRACE("tcl::defAllFields");
 
-  for (const FieldMap* fmap = &fieldmap; fmap != nullptr; fmap = fmap->parent())
+  for (unsigned int i = 0; i < fieldmap.numAllFields(); ++i)
     {
-      for (FieldMap::Iterator itr(fmap->ioFields()); itr.is_valid(); ++itr)
-        {
-          defField(pkg, *itr, src_pos);
-        }
+      defField(pkg, fieldmap.allFieldAt(i), src_pos);
     }
 
   pkg->def_raw("fields", tcl::arg_spec(1), "",
@@ -156,4 +252,7 @@ GVX_TRACE("tcl::defAllFields");
 
   pkg->def_raw("allFields", tcl::arg_spec(1), "",
                FieldsLister(fieldmap, true), src_pos);
+
+  pkg->def("getFieldBytes", "objrefs field_name", &getFieldBytes, src_pos);
+  pkg->def("setFieldBytes", "objrefs field_name bytes", &setFieldBytes, src_pos);
 }
@@ -36,8 +36,12 @@
 #include "tcl/objpkg.h"
 #include "tcl/pkg.h"
 
+#include <cstddef>
+#include <vector>
+
 namespace rutz
 {
+  class fstring;
   struct file_pos;
 }
 
@@ -46,8 +50,22 @@ class FieldMap;
 
 namespace tcl
 {
+  class list;
   class pkg;
 
+  /// Get numeric field \a name from each object in \a objrefs.
+  /** No per-element string conversion is done; see
+      FieldContainer::getNumericField(). */
+  std::vector<double> getNumericField(const tcl::list& objrefs,
+                                      const rutz::fstring& name);
+
+  /// Set numeric field \a name in each object in \a objrefs.
+  /** \a nvals must be 1 or the length of \a objrefs; see
+      FieldContainer::setNumericField(). */
+  void setNumericField(const tcl::list& objrefs,
+                       const rutz::fstring& name,
+                       const double* vals, size_t nvals);
+
   void defField(pkg* pkg, const Field& field,
                 const rutz::file_pos& src_pos);
   void defAllFields(pkg* pkg, const FieldMap& fmap,
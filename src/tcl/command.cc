@@ -95,6 +95,8 @@ public:
     :
     callback(std::move(cback)),
     dispatcher(g_default_dispatcher),
+    fproc(nullptr),
+    ftarget(nullptr),
     usage(usg ? usg : ""),
     argspec(spec)
   {}
@@ -104,6 +106,8 @@ public:
   // These are set once per command object
   std::function<void(tcl::call_context&)> callback;
   shared_ptr<tcl::arg_dispatcher>       dispatcher;
+  tcl::command::fast_proc*              fproc;
+  tcl::command::fast_target*            ftarget;
   rutz::fstring                   const usage;
   arg_spec                        const argspec;
 };
@@ -170,6 +174,26 @@ void tcl::command::set_dispatcher(shared_ptr<tcl::arg_dispatcher> dpx)
 {
 GVX_TRACE("tcl::command::set_dispatcher");
   rep->dispatcher = dpx;
+  rep->fproc = nullptr;
+  rep->ftarget = nullptr;
+}
+
+void tcl::command::set_fast_path(fast_proc* proc, fast_target* target)
+{
+GVX_TRACE("tcl::command::set_fast_path");
+  GVX_ASSERT((proc == nullptr) == (target == nullptr));
+  rep->fproc = proc;
+  rep->ftarget = target;
+}
+
+tcl::command::fast_proc* tcl::command::get_fast_proc() const noexcept
+{
+  return rep->fproc;
+}
+
+void* tcl::command::get_fast_target() const
+{
+  return rep->ftarget ? rep->ftarget(rep->callback) : nullptr;
 }
 
 
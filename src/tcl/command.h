@@ -41,6 +41,7 @@
 #include <memory>
 
 typedef struct Tcl_Obj Tcl_Obj;
+struct Tcl_Interp;
 
 namespace rutz
 {
@@ -138,8 +139,28 @@ public:
   std::shared_ptr<arg_dispatcher> get_dispatcher() const;
 
   /// Change the tcl::arg_dispatcher for this command.
+  /** This also drops any fast path, since the fast path bypasses the
+      dispatcher. */
   void set_dispatcher(std::shared_ptr<arg_dispatcher> dpx);
 
+  /// A Tcl_ObjCmdProc-compatible function that calls the callback directly.
+  /** The clientdata passed to a fast_proc is the owning
+      tcl::command_group. */
+  typedef int (fast_proc)(void* clientdata, Tcl_Interp* interp,
+                          int objc, Tcl_Obj* const objv[]);
+
+  /// Locates the concrete callable held inside a callback.
+  typedef void* (fast_target)(std::function<void(tcl::call_context&)>& callback);
+
+  /// Give this command a direct fast path (see tcl::make_command()).
+  void set_fast_path(fast_proc* proc, fast_target* target);
+
+  /// Get the fast path proc, or null if the command has none.
+  fast_proc* get_fast_proc() const noexcept;
+
+  /// Get the callable that the fast path proc should invoke.
+  void* get_fast_target() const;
+
 private:
 
   class impl;
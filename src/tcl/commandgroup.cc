@@ -118,6 +118,8 @@ public:
 
   static void c_delete_callback(void* clientdata) noexcept;
 
+  void install_proc(command_group* owner);
+
   static void c_exit_callback(void* clientdata) noexcept;
 
   static tcl::command_group* lookup_helper(tcl::interpreter& interp,
@@ -239,9 +241,11 @@ GVX_TRACE("tcl::command_group::impl::lookup_helper");
   Tcl_CmdInfo info;
   const int result = Tcl_GetCommandInfo(interp.intp(), name, &info);
 
+  // Don't check info.objProc here, since it may be a fast path proc
+  // (see install_proc()); c_delete_callback is enough to identify
+  // our own commands.
   if (result == 1 &&
       info.isNativeObjectProc == 1 &&
-      info.objProc == &impl::c_invoke_callback &&
       info.deleteProc == &impl::c_delete_callback)
     {
       return static_cast<command_group*>(info.objClientData);
@@ -249,11 +253,40 @@ GVX_TRACE("tcl::command_group::impl::lookup_helper");
   return 0;
 }
 
+void tcl::command_group::impl::install_proc(command_group* owner)
+{
+GVX_TRACE("tcl::command_group::impl::install_proc");
+
+  // A fast path is only usable when there is no overloading to
+  // resolve; the fast proc itself re-checks the argument count and
+  // defers to invoke_raw() for the usage error.
+  tcl::command::fast_proc* proc = nullptr;
+  void* target = nullptr;
+
+  if (cmd_list.size() == 1)
+    {
+      proc = cmd_list.front().get_fast_proc();
+      if (proc != nullptr)
+        target = cmd_list.front().get_fast_target();
+      if (target == nullptr)
+        proc = nullptr;
+    }
+
+  Tcl_CmdInfo info;
+  const int result = Tcl_GetCommandInfoFromToken(cmd_token, &info);
+  GVX_ASSERT(result == 1);
+  info.objProc = proc ? proc : &impl::c_invoke_callback;
+  Tcl_SetCommandInfoFromToken(cmd_token, &info);
+
+  owner->m_fast_target = target;
+}
+
 tcl::command_group::command_group(tcl::interpreter& interp,
                                 const fstring& cmd_name,
                                 const rutz::file_pos& src_pos)
   :
-  rep(new impl(interp, cmd_name, src_pos))
+  rep(new impl(interp, cmd_name, src_pos)),
+  m_fast_target(nullptr)
 {
 GVX_TRACE("tcl::command_group::command_group");
 
@@ -331,19 +364,14 @@ GVX_TRACE("tcl::command_group::lookup_original");
   return impl::lookup_helper(interp, original.c_str());
 }
 
-void tcl::command_group::make(tcl::interpreter& interp,
-                              std::function<void(tcl::call_context&)>&& callback,
-                              const char* cmd_name,
-                              const char* usage,
-                              const arg_spec& spec,
-                              const rutz::file_pos& src_pos,
-                              std::unique_ptr<tcl::arg_dispatcher> dispatcher)
+tcl::command_group* tcl::command_group::find_or_make(tcl::interpreter& interp,
+                                                    const char* cmd_name,
+                                                    const rutz::file_pos& src_pos)
 {
-GVX_TRACE("tcl::command_group::make");
+GVX_TRACE("tcl::command_group::find_or_make");
 
   // Here we want to find the command_group that corresponds to the
-  // given command name, creating it anew if necessary. Then, we
-  // create a new tcl::command object and add it to the group. The
+  // given command name, creating it anew if necessary. The
   // command_group object handles the actual interface with tcl, and
   // when the command_group gets callback from tcl, it selects among
   // its various tcl::command overloads by checking which one matches
@@ -358,6 +386,21 @@ GVX_TRACE("tcl::command_group::make");
 
   GVX_ASSERT(group != nullptr);
 
+  return group;
+}
+
+void tcl::command_group::make(tcl::interpreter& interp,
+                              std::function<void(tcl::call_context&)>&& callback,
+                              const char* cmd_name,
+                              const char* usage,
+                              const arg_spec& spec,
+                              const rutz::file_pos& src_pos,
+                              std::unique_ptr<tcl::arg_dispatcher> dispatcher)
+{
+GVX_TRACE("tcl::command_group::make");
+
+  command_group* group = find_or_make(interp, cmd_name, src_pos);
+
   tcl::command cmd(std::move(callback), usage, spec);
 
   if (dispatcher)
@@ -374,10 +417,31 @@ GVX_TRACE("tcl::command_group::make");
   group->add(std::move(cmd));
 }
 
+void tcl::command_group::make_fast(tcl::interpreter& interp,
+                                   std::function<void(tcl::call_context&)>&& callback,
+                                   int (*proc)(void*, Tcl_Interp*, int, Tcl_Obj* const*),
+                                   void* (*target)(std::function<void(tcl::call_context&)>&),
+                                   const char* cmd_name,
+                                   const char* usage,
+                                   const arg_spec& spec,
+                                   const rutz::file_pos& src_pos)
+{
+GVX_TRACE("tcl::command_group::make_fast");
+
+  command_group* group = find_or_make(interp, cmd_name, src_pos);
+
+  tcl::command cmd(std::move(callback), usage, spec);
+
+  cmd.set_fast_path(proc, target);
+
+  group->add(std::move(cmd));
+}
+
 void tcl::command_group::add(tcl::command&& p)
 {
 GVX_TRACE("tcl::command_group::add");
   rep->cmd_list.push_back(std::move(p));
+  rep->install_proc(this);
 }
 
 fstring tcl::command_group::resolved_name() const
@@ -469,3 +533,31 @@ GVX_TRACE("tcl::command_group::invoke_raw");
 
   return TCL_ERROR;
 }
+
+static_assert(tcl::command_group::fast_ok == TCL_OK,
+              "fast_ok must match TCL_OK");
+
+int tcl::command_group::fast_result(Tcl_Interp* interp,
+                                    const tcl::obj& result) noexcept
+{
+  Tcl_SetObjResult(interp, result.get());
+  return TCL_OK;
+}
+
+int tcl::command_group::fast_error(Tcl_Obj* const objv[]) noexcept
+{
+  rep->interp.handle_live_exception(Tcl_GetString(objv[0]), SRC_POS);
+  return TCL_ERROR;
+}
+
+int tcl::command_group::fast_traced(int (*call)(command_group*, Tcl_Interp*,
+                                                Tcl_Obj* const*),
+                                    Tcl_Interp* interp,
+                                    Tcl_Obj* const objv[]) noexcept
+{
+  // Skip the GVX_TRACE of invoke_raw() itself, but keep the trace of
+  // this group's own rutz::prof so that the command still shows up
+  // in profiles.
+  rutz::trace tracer(rep->prof, GVX_TRACE_EXPR);
+  return call(this, interp, objv);
+}
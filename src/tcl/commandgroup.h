@@ -47,6 +47,7 @@ namespace rutz
 
 namespace tcl
 {
+  class obj;
   class arg_dispatcher;
   class arg_spec;
   class call_context;
@@ -86,6 +87,19 @@ public:
                    const rutz::file_pos& src_pos,
                    std::unique_ptr<tcl::arg_dispatcher> dispatcher = std::unique_ptr<tcl::arg_dispatcher>());
 
+  /// Like make(), but also give the new tcl::command a direct fast path.
+  /** As long as the command is the only overload in its group, Tcl
+      will call \a proc directly instead of going through
+      invoke_raw(). */
+  static void make_fast(tcl::interpreter& interp,
+                        std::function<void(tcl::call_context&)>&& callback,
+                        int (*proc)(void*, Tcl_Interp*, int, Tcl_Obj* const*),
+                        void* (*target)(std::function<void(tcl::call_context&)>&),
+                        const char* cmd_name,
+                        const char* usage,
+                        const tcl::arg_spec& spec,
+                        const rutz::file_pos& src_pos);
+
   /// Add the given tcl::command to this group's overload list.
   void add(tcl::command&& p);
 
@@ -97,10 +111,35 @@ public:
 
   int invoke_raw(int s_objc, Tcl_Obj *const objv[]) noexcept;
 
+  /// Return value of a successful fast path call (same as TCL_OK).
+  static const int fast_ok = 0;
+
+  /// The callable that the installed fast path proc should invoke.
+  void* fast_target() const noexcept { return m_fast_target; }
+
+  /// Set \a result as the interpreter's result; returns fast_ok.
+  static int fast_result(Tcl_Interp* interp, const tcl::obj& result) noexcept;
+
+  /// Report the exception that is currently being handled; returns TCL_ERROR.
+  /** Must be called from within a catch block. */
+  int fast_error(Tcl_Obj* const objv[]) noexcept;
+
+  /// Return \a call(this, interp, objv), timed against this group's rutz::prof.
+  /** This gives fast path calls the same profiling, call-graph and
+      trace-recording coverage that invoke_raw() gives. */
+  int fast_traced(int (*call)(command_group*, Tcl_Interp*, Tcl_Obj* const*),
+                  Tcl_Interp* interp, Tcl_Obj* const objv[]) noexcept;
+
 private:
   class impl;
   friend class impl;
   impl* const rep;
+  void* m_fast_target;
+
+  /// Find the named tcl::command_group, or create it if it doesn't exist.
+  static command_group* find_or_make(tcl::interpreter& interp,
+                                     const char* cmd_name,
+                                     const rutz::file_pos& src_pos);
 
   /// Private constructor; clients shouldn't manipulate tcl::command_group objects directly.
   command_group(tcl::interpreter& interp,
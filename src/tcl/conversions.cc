@@ -38,6 +38,7 @@
 
 #include <limits>
 #include <tcl.h>
+#include <vector>
 
 #include "rutz/trace.h"
 #include "rutz/debug.h"
@@ -82,192 +83,258 @@ namespace
         Tcl_DecrRefCount(m_obj);
     }
   };
-}
 
-///////////////////////////////////////////////////////////////////////
-//
-// (Tcl --> C++) help_convert<>::from_tcl specializations
-//
-///////////////////////////////////////////////////////////////////////
+  // These do the actual conversions, without a GVX_TRACE, so that
+  // both single and array conversions can use them. The single
+  // conversions don't have a GVX_TRACE either, since they run for
+  // each argument of each command call; the array conversions have
+  // one per batch.
 
-int tcl::help_convert<int>::from_tcl(Tcl_Obj* obj)
-{
-GVX_TRACE("tcl::help_convert<int>::from_tcl");
+  int get_int(Tcl_Obj* obj)
+  {
+    int val;
 
-  int val;
+    static const Tcl_ObjType* const int_type = Tcl_GetObjType("int");
 
-  static const Tcl_ObjType* const int_type = Tcl_GetObjType("int");
+    GVX_ASSERT(int_type != nullptr);
 
-  GVX_ASSERT(int_type != nullptr);
+    safe_unshared_obj safeobj(obj, int_type);
 
-  safe_unshared_obj safeobj(obj, int_type);
+    if ( Tcl_GetIntFromObj(0, safeobj.get(), &val) != TCL_OK )
+      {
+        throw rutz::error(rutz::sfmt("expected integer but got \"%s\"",
+                                     Tcl_GetString(obj)), SRC_POS);
+      }
 
-  if ( Tcl_GetIntFromObj(0, safeobj.get(), &val) != TCL_OK )
-    {
-      throw rutz::error(rutz::sfmt("expected integer but got \"%s\"",
-                                   Tcl_GetString(obj)), SRC_POS);
-    }
+    return val;
+  }
 
-  return val;
-}
+  unsigned int get_uint(Tcl_Obj* obj)
+  {
+    int sval = get_int(obj);
 
-unsigned int tcl::help_convert<unsigned int>::from_tcl(Tcl_Obj* obj)
-{
-GVX_TRACE("tcl::help_convert<unsigned int>::from_tcl");
+    if (sval < 0)
+      {
+        throw rutz::error(rutz::sfmt("expected integer but got \"%s\" "
+                                     "(value was negative)",
+                                     Tcl_GetString(obj)), SRC_POS);
+      }
 
-  int sval = help_convert<int>::from_tcl(obj);
+    return static_cast<unsigned int>(sval);
+  }
 
-  if (sval < 0)
-    {
-      throw rutz::error(rutz::sfmt("expected integer but got \"%s\" "
-                                   "(value was negative)",
-                                   Tcl_GetString(obj)), SRC_POS);
-    }
+  long get_long(Tcl_Obj* obj)
+  {
+    long val;
 
-  return static_cast<unsigned int>(sval);
-}
+    static const Tcl_ObjType* const int_type = Tcl_GetObjType("int");
 
-long tcl::help_convert<long>::from_tcl(Tcl_Obj* obj)
-{
-GVX_TRACE("tcl::help_convert<long>::from_tcl");
+    GVX_ASSERT(int_type != nullptr);
 
-  long val;
+    safe_unshared_obj safeobj(obj, int_type);
 
-  static const Tcl_ObjType* const int_type = Tcl_GetObjType("int");
+    if ( Tcl_GetLongFromObj(0, safeobj.get(), &val) != TCL_OK )
+      {
+        throw rutz::error(rutz::sfmt("expected integer but got \"%s\"",
+                                     Tcl_GetString(obj)), SRC_POS);
+      }
 
-  GVX_ASSERT(int_type != nullptr);
+    return val;
+  }
 
-  safe_unshared_obj safeobj(obj, int_type);
+  long long get_longlong(Tcl_Obj* obj)
+  {
+#ifdef TCL_WIDE_INT_IS_LONG
 
-  if ( Tcl_GetLongFromObj(0, safeobj.get(), &val) != TCL_OK )
-    {
-      throw rutz::error(rutz::sfmt("expected integer but got \"%s\"",
-                                   Tcl_GetString(obj)), SRC_POS);
-    }
+    return get_long(obj);
 
-  return val;
-}
+#else
 
-unsigned long tcl::help_convert<unsigned long>::from_tcl(Tcl_Obj* obj)
-{
-GVX_TRACE("tcl::help_convert<unsigned long>::from_tcl");
+    static const Tcl_ObjType* const wide_int_type = Tcl_GetObjType("wideInt");
 
-  long long wideval = help_convert<long long>::from_tcl(obj);
+    GVX_ASSERT(wide_int_type != nullptr);
 
-  const unsigned long ulongmax = std::numeric_limits<unsigned long>::max();
+    safe_unshared_obj safeobj(obj, wide_int_type);
 
-  if (wideval < 0)
-    {
-      throw rutz::error(rutz::sfmt("expected unsigned long value "
-                                   "but got \"%s\" (value was negative)",
-                                   Tcl_GetString(obj)), SRC_POS);
-    }
-  // OK, now we know our wideval is non-negative, so we can safely
-  // cast it to an unsigned type (Tcl_WideUInt) for comparison against
-  // ulongmax (note: don't try to do this comparison by casting
-  // ulongmax to a signed type like Tcl_WideInt, since the result of
-  // the cast will be a negative number, leading to a bogus
-  // comparison)
-  else if (static_cast<Tcl_WideUInt>(wideval) > ulongmax)
-    {
-      throw rutz::error(rutz::sfmt("expected unsigned long value "
-                                   "but got \"%s\" "
-                                   "(value too large, max is %lu)",
-                                   Tcl_GetString(obj), ulongmax),
-                        SRC_POS);
-    }
+    Tcl_WideInt wideval;
 
-  return static_cast<unsigned long>(wideval);
-}
+    if ( Tcl_GetWideIntFromObj(0, safeobj.get(), &wideval) != TCL_OK )
+      {
+        throw rutz::error(rutz::sfmt("expected long value but got \"%s\"",
+                                     Tcl_GetString(obj)), SRC_POS);
+      }
 
-long long tcl::help_convert<long long>::from_tcl(Tcl_Obj* obj)
-{
-GVX_TRACE("tcl::help_convert<longlong>::from_tcl");
+    return wideval;
 
-#ifdef TCL_WIDE_INT_IS_LONG
+#endif
+  }
 
-  return help_convert<long>::from_tcl(obj);
+  unsigned long get_ulong(Tcl_Obj* obj)
+  {
+    long long wideval = get_longlong(obj);
+
+    const unsigned long ulongmax = std::numeric_limits<unsigned long>::max();
+
+    if (wideval < 0)
+      {
+        throw rutz::error(rutz::sfmt("expected unsigned long value "
+                                     "but got \"%s\" (value was negative)",
+                                     Tcl_GetString(obj)), SRC_POS);
+      }
+    // OK, now we know our wideval is non-negative, so we can safely
+    // cast it to an unsigned type (Tcl_WideUInt) for comparison against
+    // ulongmax (note: don't try to do this comparison by casting
+    // ulongmax to a signed type like Tcl_WideInt, since the result of
+    // the cast will be a negative number, leading to a bogus
+    // comparison)
+    else if (static_cast<Tcl_WideUInt>(wideval) > ulongmax)
+      {
+        throw rutz::error(rutz::sfmt("expected unsigned long value "
+                                     "but got \"%s\" "
+                                     "(value too large, max is %lu)",
+                                     Tcl_GetString(obj), ulongmax),
+                          SRC_POS);
+      }
+
+    return static_cast<unsigned long>(wideval);
+  }
+
+  bool get_bool(Tcl_Obj* obj)
+  {
+    int int_val;
 
-#else
+    static const Tcl_ObjType* const boolean_type = Tcl_GetObjType("boolean");
 
-  static const Tcl_ObjType* const wide_int_type = Tcl_GetObjType("wideInt");
+    GVX_ASSERT(boolean_type != nullptr);
 
-  GVX_ASSERT(wide_int_type != nullptr);
+    safe_unshared_obj safeobj(obj, boolean_type);
 
-  safe_unshared_obj safeobj(obj, wide_int_type);
+    if ( Tcl_GetBooleanFromObj(0, safeobj.get(), &int_val) != TCL_OK )
+      {
+        throw rutz::error(rutz::sfmt("expected boolean value but got \"%s\"",
+                                     Tcl_GetString(obj)), SRC_POS);
+      }
+    return bool(int_val);
+  }
 
-  Tcl_WideInt wideval;
+  double get_double(Tcl_Obj* obj)
+  {
+    double val;
 
-  if ( Tcl_GetWideIntFromObj(0, safeobj.get(), &wideval) != TCL_OK )
-    {
-      throw rutz::error(rutz::sfmt("expected long value but got \"%s\"",
-                                   Tcl_GetString(obj)), SRC_POS);
-    }
+    static const Tcl_ObjType* const double_type = Tcl_GetObjType("double");
 
-  return wideval;
+    GVX_ASSERT(double_type != nullptr);
 
-#endif
+    safe_unshared_obj safeobj(obj, double_type);
+
+    if ( Tcl_GetDoubleFromObj(0, safeobj.get(), &val) != TCL_OK )
+      {
+        throw rutz::error(rutz::sfmt("expected floating-point number "
+                                     "but got \"%s\"",
+                                     Tcl_GetString(obj)), SRC_POS);
+      }
+    return val;
+  }
 }
 
-bool tcl::help_convert<bool>::from_tcl(Tcl_Obj* obj)
+///////////////////////////////////////////////////////////////////////
+//
+// (Tcl --> C++) help_convert<>::from_tcl specializations
+//
+///////////////////////////////////////////////////////////////////////
+
+int tcl::help_convert<int>::from_tcl(Tcl_Obj* obj)
 {
-GVX_TRACE("tcl::help_convert<bool>::from_tcl");
+  return get_int(obj);
+}
 
-  int int_val;
+unsigned int tcl::help_convert<unsigned int>::from_tcl(Tcl_Obj* obj)
+{
+  return get_uint(obj);
+}
 
-  static const Tcl_ObjType* const boolean_type = Tcl_GetObjType("boolean");
+long tcl::help_convert<long>::from_tcl(Tcl_Obj* obj)
+{
+  return get_long(obj);
+}
 
-  GVX_ASSERT(boolean_type != nullptr);
+unsigned long tcl::help_convert<unsigned long>::from_tcl(Tcl_Obj* obj)
+{
+  return get_ulong(obj);
+}
 
-  safe_unshared_obj safeobj(obj, boolean_type);
+long long tcl::help_convert<long long>::from_tcl(Tcl_Obj* obj)
+{
+  return get_longlong(obj);
+}
 
-  if ( Tcl_GetBooleanFromObj(0, safeobj.get(), &int_val) != TCL_OK )
-    {
-      throw rutz::error(rutz::sfmt("expected boolean value but got \"%s\"",
-                                   Tcl_GetString(obj)), SRC_POS);
-    }
-  return bool(int_val);
+bool tcl::help_convert<bool>::from_tcl(Tcl_Obj* obj)
+{
+  return get_bool(obj);
 }
 
 double tcl::help_convert<double>::from_tcl(Tcl_Obj* obj)
 {
-GVX_TRACE("tcl::help_convert<double>::from_tcl");
+  return get_double(obj);
+}
 
-  double val;
+void tcl::convert_array(Tcl_Obj* const* objs, unsigned int n,
+                        int* result)
+{
+GVX_TRACE("tcl::convert_array(int)");
 
-  static const Tcl_ObjType* const double_type = Tcl_GetObjType("double");
+  for (unsigned int i = 0; i < n; ++i)
+    result[i] = get_int(objs[i]);
+}
 
-  GVX_ASSERT(double_type != nullptr);
+void tcl::convert_array(Tcl_Obj* const* objs, unsigned int n,
+                        unsigned int* result)
+{
+GVX_TRACE("tcl::convert_array(unsigned int)");
 
-  safe_unshared_obj safeobj(obj, double_type);
+  for (unsigned int i = 0; i < n; ++i)
+    result[i] = get_uint(objs[i]);
+}
 
-  if ( Tcl_GetDoubleFromObj(0, safeobj.get(), &val) != TCL_OK )
-    {
-      throw rutz::error(rutz::sfmt("expected floating-point number "
-                                   "but got \"%s\"",
-                                   Tcl_GetString(obj)), SRC_POS);
-    }
-  return val;
+void tcl::convert_array(Tcl_Obj* const* objs, unsigned int n,
+                        long* result)
+{
+GVX_TRACE("tcl::convert_array(long)");
+
+  for (unsigned int i = 0; i < n; ++i)
+    result[i] = get_long(objs[i]);
 }
 
-float tcl::help_convert<float>::from_tcl(Tcl_Obj* obj)
+void tcl::convert_array(Tcl_Obj* const* objs, unsigned int n,
+                        unsigned long* result)
 {
-GVX_TRACE("tcl::help_convert<float>::from_tcl");
+GVX_TRACE("tcl::convert_array(unsigned long)");
 
+  for (unsigned int i = 0; i < n; ++i)
+    result[i] = get_ulong(objs[i]);
+}
+
+void tcl::convert_array(Tcl_Obj* const* objs, unsigned int n,
+                        double* result)
+{
+GVX_TRACE("tcl::convert_array(double)");
+
+  for (unsigned int i = 0; i < n; ++i)
+    result[i] = get_double(objs[i]);
+}
+
+float tcl::help_convert<float>::from_tcl(Tcl_Obj* obj)
+{
   return float(help_convert<double>::from_tcl(obj));
 }
 
 const char* tcl::help_convert<const char*>::from_tcl(Tcl_Obj* obj)
 {
-GVX_TRACE("tcl::help_convert<const char*>::from_tcl");
-
   return Tcl_GetString(obj);
 }
 
 fstring tcl::help_convert<fstring>::from_tcl(Tcl_Obj* obj)
 {
-GVX_TRACE("tcl::help_convert<fstring>::from_tcl");
-
   int length;
 
   char* text = Tcl_GetStringFromObj(obj, &length);
@@ -286,22 +353,16 @@ GVX_TRACE("tcl::help_convert<fstring>::from_tcl");
 
 tcl::obj tcl::help_convert<long long>::to_tcl(long long val)
 {
-GVX_TRACE("tcl::convert_from(long long)");
-
   return Tcl_NewWideIntObj(val);
 }
 
 tcl::obj tcl::help_convert<long>::to_tcl(long val)
 {
-GVX_TRACE("tcl::convert_from(long)");
-
   return Tcl_NewLongObj(val);
 }
 
 tcl::obj tcl::help_convert<unsigned long>::to_tcl(unsigned long val)
 {
-GVX_TRACE("tcl::convert_from(unsigned long)");
-
   const long sval = long(val);
 
   if (sval < 0)
@@ -312,15 +373,11 @@ GVX_TRACE("tcl::convert_from(unsigned long)");
 
 tcl::obj tcl::help_convert<int>::to_tcl(int val)
 {
-GVX_TRACE("tcl::convert_from(int)");
-
   return Tcl_NewIntObj(val);
 }
 
 tcl::obj tcl::help_convert<unsigned int>::to_tcl(unsigned int val)
 {
-GVX_TRACE("tcl::convert_from(unsigned int)");
-
   const long sval = long(val);
 
   if (sval < 0)
@@ -331,43 +388,31 @@ GVX_TRACE("tcl::convert_from(unsigned int)");
 
 tcl::obj tcl::help_convert<unsigned char>::to_tcl(unsigned char val)
 {
-GVX_TRACE("tcl::convert_from(unsigne char)");
-
   return Tcl_NewIntObj(val);
 }
 
 tcl::obj tcl::help_convert<bool>::to_tcl(bool val)
 {
-GVX_TRACE("tcl::convert_from(bool)");
-
   return Tcl_NewBooleanObj(val);
 }
 
 tcl::obj tcl::help_convert<double>::to_tcl(double val)
 {
-GVX_TRACE("tcl::convert_from(double)");
-
   return Tcl_NewDoubleObj(val);
 }
 
 tcl::obj tcl::help_convert<float>::to_tcl(float val)
 {
-GVX_TRACE("tcl::convert_from(float)");
-
   return Tcl_NewDoubleObj(double(val));
 }
 
 tcl::obj tcl::help_convert<const char*>::to_tcl(const char* val)
 {
-GVX_TRACE("tcl::convert_from(const char*)");
-
   return Tcl_NewStringObj(val, -1);
 }
 
 tcl::obj tcl::help_convert<rutz::fstring>::to_tcl(const rutz::fstring& val)
 {
-GVX_TRACE("tcl::convert_from(const fstring&)");
-
   if (val.length() > std::numeric_limits<int>::max())
     throw rutz::error("string too long to store in tcl string object", SRC_POS);
 
@@ -380,3 +425,61 @@ GVX_TRACE("tcl::convert_from(const rutz::value&)");
 
   return Tcl_NewStringObj(val.get_string().c_str(), -1);
 }
+
+namespace
+{
+  template <class T, class F>
+  tcl::obj new_list_obj(const T* vals, unsigned int n, F new_obj)
+  {
+    std::vector<Tcl_Obj*> objs(n);
+    for (unsigned int i = 0; i < n; ++i)
+      objs[i] = new_obj(vals[i]);
+
+    return Tcl_NewListObj(int(n), n > 0 ? &objs[0] : nullptr);
+  }
+
+  template <class T>
+  void check_signed_range(const T* vals, unsigned int n)
+  {
+    for (unsigned int i = 0; i < n; ++i)
+      if (long(vals[i]) < 0)
+        throw rutz::error("signed/unsigned conversion failed", SRC_POS);
+  }
+}
+
+tcl::obj tcl::convert_array_from(const int* vals, unsigned int n)
+{
+GVX_TRACE("tcl::convert_array_from(int)");
+
+  return new_list_obj(vals, n, [](int v) { return Tcl_NewIntObj(v); });
+}
+
+tcl::obj tcl::convert_array_from(const unsigned int* vals, unsigned int n)
+{
+GVX_TRACE("tcl::convert_array_from(unsigned int)");
+
+  check_signed_range(vals, n);
+  return new_list_obj(vals, n, [](unsigned int v) { return Tcl_NewLongObj(long(v)); });
+}
+
+tcl::obj tcl::convert_array_from(const long* vals, unsigned int n)
+{
+GVX_TRACE("tcl::convert_array_from(long)");
+
+  return new_list_obj(vals, n, [](long v) { return Tcl_NewLongObj(v); });
+}
+
+tcl::obj tcl::convert_array_from(const unsigned long* vals, unsigned int n)
+{
+GVX_TRACE("tcl::convert_array_from(unsigned long)");
+
+  check_signed_range(vals, n);
+  return new_list_obj(vals, n, [](unsigned long v) { return Tcl_NewLongObj(long(v)); });
+}
+
+tcl::obj tcl::convert_array_from(const double* vals, unsigned int n)
+{
+GVX_TRACE("tcl::convert_array_from(double)");
+
+  return new_list_obj(vals, n, [](double v) { return Tcl_NewDoubleObj(v); });
+}
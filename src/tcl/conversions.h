@@ -114,6 +114,22 @@ namespace tcl
     static tcl::obj to_tcl(const tcl::obj& val) { return val; }
   };
 
+  /// Convert \a n Tcl objects into the array \a result, in one pass.
+  /** Equivalent to calling convert_to() on each element, but without
+      the per-call overhead; used for batched vectorized commands. */
+  void convert_array(Tcl_Obj* const* objs, unsigned int n, int* result);
+  void convert_array(Tcl_Obj* const* objs, unsigned int n, unsigned int* result);
+  void convert_array(Tcl_Obj* const* objs, unsigned int n, long* result);
+  void convert_array(Tcl_Obj* const* objs, unsigned int n, unsigned long* result);
+  void convert_array(Tcl_Obj* const* objs, unsigned int n, double* result);
+
+  /// Make a Tcl list of the \a n values in \a vals, in one pass.
+  tcl::obj convert_array_from(const int* vals, unsigned int n);
+  tcl::obj convert_array_from(const unsigned int* vals, unsigned int n);
+  tcl::obj convert_array_from(const long* vals, unsigned int n);
+  tcl::obj convert_array_from(const unsigned long* vals, unsigned int n);
+  tcl::obj convert_array_from(const double* vals, unsigned int n);
+
   /// Convert a native c++ object to a tcl::obj.
   /** Will select a matching help_convert<T>::to_tcl() specialization. */
   template <class T>
@@ -44,7 +44,12 @@
 
 #include "rutz/functors.h"
 
+#include <cstddef>
 #include <memory>
+#include <tuple>
+#include <type_traits>
+#include <typeinfo>
+#include <vector>
 
 namespace rutz
 {
@@ -97,6 +102,170 @@ namespace tcl
     }
   };
 
+// ########################################################
+/// Convert a whole array of Tcl_Obj's at once, for batched vectorized calls.
+/** The default just converts each element with tcl::convert_to(). */
+
+  template <class T>
+  struct batch_convert_each
+  {
+    typedef decltype(tcl::convert_to<T>(static_cast<Tcl_Obj*>(nullptr))) value_type;
+
+    static std::vector<value_type> from_tcl(Tcl_Obj* const* objs,
+                                            unsigned int n)
+    {
+      std::vector<value_type> result;
+      result.reserve(n);
+      for (unsigned int i = 0; i < n; ++i)
+        result.push_back(tcl::convert_to<T>(objs[i]));
+      return result;
+    }
+  };
+
+  template <class T>
+  struct batch_convert : public batch_convert_each<T> {};
+
+  /// Numeric types are converted by tcl::convert_array().
+  template <class T>
+  struct batch_convert_numeric
+  {
+    static std::vector<T> from_tcl(Tcl_Obj* const* objs, unsigned int n)
+    {
+      std::vector<T> result(n);
+      tcl::convert_array(objs, n, &result[0]);
+      return result;
+    }
+  };
+
+  template <> struct batch_convert<int>           : public batch_convert_numeric<int> {};
+  template <> struct batch_convert<unsigned int>  : public batch_convert_numeric<unsigned int> {};
+  template <> struct batch_convert<long>          : public batch_convert_numeric<long> {};
+  template <> struct batch_convert<unsigned long> : public batch_convert_numeric<unsigned long> {};
+  template <> struct batch_convert<double>        : public batch_convert_numeric<double> {};
+
+  /// Resolve the uids for a whole array of nub::ref's in one objectdb call.
+  template <class T>
+  struct batch_convert<nub::ref<T> >
+  {
+    static std::vector<nub::ref<T> > from_tcl(Tcl_Obj* const* objs,
+                                              unsigned int n)
+    {
+      std::vector<nub::uid> ids(n);
+      tcl::convert_array(objs, n, &ids[0]);
+
+      std::vector<nub::object*> items(n);
+      nub::detail::get_items(&ids[0], n, &items[0], true);
+
+      std::vector<nub::ref<T> > result;
+      result.reserve(n);
+      for (unsigned int i = 0; i < n; ++i)
+        {
+          T* t = dynamic_cast<T*>(items[i]);
+          if (t == nullptr)
+            rutz::throw_bad_cast(typeid(T), typeid(nub::object), SRC_POS);
+          // the object is already in the objectdb, so don't re-insert it
+          result.push_back(nub::ref<T>(t, nub::ref_vis_private()));
+        }
+      return result;
+    }
+  };
+
+  /// Resolve the uids for a whole array of nub::soft_ref's in one objectdb call.
+  /** This only applies when T is a nub::object; other types that are
+      wrapped in soft_ref's (such as mtx, via MtxObj) are converted one
+      at a time, through whatever help_convert they have. */
+  template <class T,
+            bool is_object = std::is_base_of<nub::object, T>::value>
+  struct batch_convert_soft_ref
+    : public batch_convert_each<nub::soft_ref<T> >
+  {};
+
+  template <class T>
+  struct batch_convert_soft_ref<T, true>
+  {
+    static std::vector<nub::soft_ref<T> > from_tcl(Tcl_Obj* const* objs,
+                                                   unsigned int n)
+    {
+      std::vector<nub::uid> ids(n);
+      tcl::convert_array(objs, n, &ids[0]);
+
+      std::vector<nub::object*> items(n);
+      nub::detail::get_items(&ids[0], n, &items[0], false);
+
+      std::vector<nub::soft_ref<T> > result;
+      result.reserve(n);
+      for (unsigned int i = 0; i < n; ++i)
+        {
+          T* t = nullptr;
+          if (items[i] != nullptr)
+            {
+              t = dynamic_cast<T*>(items[i]);
+              if (t == nullptr)
+                rutz::throw_bad_cast(typeid(T), typeid(nub::object), SRC_POS);
+            }
+          result.push_back(nub::soft_ref<T>(t, nub::ref_type::STRONG,
+                                            nub::ref_vis_private()));
+        }
+      return result;
+    }
+  };
+
+  template <class T>
+  struct batch_convert<nub::soft_ref<T> >
+    : public batch_convert_soft_ref<T>
+  {};
+
+  template <class T>
+  struct batch_convert<rutz::this_pointer<T> >
+    : public std::conditional_t<std::is_base_of<nub::object, T>::value,
+                                batch_convert_soft_ref<T, true>,
+                                batch_convert_each<rutz::this_pointer<T> > >
+  {};
+
+  /// Collect the results of a batched vectorized call.
+  template <class T>
+  struct batch_results
+  {
+    std::vector<tcl::obj> vals;
+
+    void reserve(unsigned int n) { vals.reserve(n); }
+
+    template <class U>
+    void add(U&& v) { vals.push_back(tcl::convert_from(std::forward<U>(v))); }
+
+    void set_result(tcl::batch_context& bx) { bx.set_results(vals); }
+  };
+
+  /// Numeric results are kept as a native array until the end.
+  template <class T>
+  struct batch_numeric_results
+  {
+    std::vector<T> vals;
+
+    void reserve(unsigned int n) { vals.reserve(n); }
+
+    void add(T v) { vals.push_back(v); }
+
+    void set_result(tcl::batch_context& bx)
+    {
+      bx.set_result(tcl::convert_array_from(vals.empty() ? nullptr : &vals[0],
+                                            static_cast<unsigned int>(vals.size())));
+    }
+  };
+
+  template <> struct batch_results<int>           : public batch_numeric_results<int> {};
+  template <> struct batch_results<unsigned int>  : public batch_numeric_results<unsigned int> {};
+  template <> struct batch_results<long>          : public batch_numeric_results<long> {};
+  template <> struct batch_results<unsigned long> : public batch_numeric_results<unsigned long> {};
+  template <> struct batch_results<double>        : public batch_numeric_results<double> {};
+
+  /// Get element \a i of a batched argument, repeating the last element as needed.
+  template <class V>
+  inline decltype(auto) batch_elem(V& v, size_t i)
+  {
+    return v[i < v.size() ? i : v.size() - 1];
+  }
+
 // ########################################################
 /// Factory function for tcl::command's from void(tcl::call_context&) callables.
 
@@ -163,6 +332,27 @@ namespace tcl
         return extract<I>(ctx, std::true_type());
     }
 
+    /// Convert the whole vector of values for parameter I at once
+    template <size_t I>
+    auto column(tcl::batch_context& bx, std::true_type)
+    {
+      typedef typename rutz::func_traits<Func>::template arg<I>::type type;
+      unsigned int n = 0;
+      Tcl_Obj* const* objs = bx.elements(I+1, n);
+      return batch_convert<std::decay_t<type> >::from_tcl(objs, n);
+    }
+
+    /// Convert the values for parameter I, or use the stored default arg
+    template <size_t I>
+    auto column(tcl::batch_context& bx, std::false_type)
+    {
+      typedef decltype(column<I>(bx, std::true_type())) column_type;
+      if (I+1 >= bx.objc())
+        return column_type(1, std::get<I - (N - sizeof...(DefaultArgs))>(m_default_args));
+      else
+        return column<I>(bx, std::true_type());
+    }
+
   protected:
     template <std::size_t... I>
     auto helper(tcl::call_context& ctx, std::index_sequence<I...>)
@@ -172,6 +362,27 @@ namespace tcl
                                     std::true_type, std::false_type>())...);
     }
 
+    template <std::size_t... I>
+    auto columns(tcl::batch_context& bx, std::index_sequence<I...>)
+    {
+      return std::make_tuple(column<I>(bx,
+                                       std::conditional_t<(I < N - sizeof...(DefaultArgs)),
+                                       std::true_type, std::false_type>())...);
+    }
+
+    /// Convert each parameter straight from the raw objv array.
+    template <std::size_t... I>
+    auto direct(Tcl_Obj* const objv[], std::index_sequence<I...>)
+    {
+      return m_held_func(tcl::convert_to<typename rutz::func_traits<Func>::template arg<I>::type>(objv[I+1])...);
+    }
+
+    template <class Columns, std::size_t... I>
+    auto call_at(Columns& cols, size_t i, std::index_sequence<I...>)
+    {
+      return m_held_func(batch_elem(std::get<I>(cols), i)...);
+    }
+
   public:
     tcl_callable_base(Func f, DefaultArgs&&... args)
       : m_held_func(f), m_default_args(args...)
@@ -203,6 +414,42 @@ namespace tcl
       R res(this->helper(ctx, std::make_index_sequence<N>()));
       ctx.set_result(std::move(res));
     }
+
+    /// Tcl_ObjCmdProc used as the fast path for fixed-arity commands.
+    static int fast_proc(void* clientdata, Tcl_Interp* interp,
+                         int objc, Tcl_Obj* const objv[]) noexcept
+    {
+      tcl::command_group* g = static_cast<tcl::command_group*>(clientdata);
+      if (objc != int(N + 1))
+        return g->invoke_raw(objc, objv);
+      return g->fast_traced(&fast_call, interp, objv);
+    }
+
+    static int fast_call(tcl::command_group* g, Tcl_Interp* interp,
+                         Tcl_Obj* const objv[]) noexcept
+    {
+      try
+        {
+          tcl_callable* self = static_cast<tcl_callable*>(g->fast_target());
+          R res(self->direct(objv, std::make_index_sequence<N>()));
+          return tcl::command_group::fast_result(interp, tcl::convert_from(std::move(res)));
+        }
+      catch (...)
+        {
+          return g->fast_error(objv);
+        }
+    }
+
+    /// Convert all arguments up front, then call over the whole batch.
+    void operator()(tcl::batch_context& bx)
+    {
+      auto cols = this->columns(bx, std::make_index_sequence<N>());
+      batch_results<std::decay_t<R> > results;
+      results.reserve(bx.ncalls());
+      for (unsigned int i = 0; i < bx.ncalls(); ++i)
+        results.add(this->call_at(cols, i, std::make_index_sequence<N>()));
+      results.set_result(bx);
+    }
   };
 
   template <size_t N, class Func, class... DefaultArgs>
@@ -217,6 +464,39 @@ namespace tcl
     {
       this->helper(ctx, std::make_index_sequence<N>());
     }
+
+    /// Tcl_ObjCmdProc used as the fast path for fixed-arity commands.
+    static int fast_proc(void* clientdata, Tcl_Interp* interp,
+                         int objc, Tcl_Obj* const objv[]) noexcept
+    {
+      tcl::command_group* g = static_cast<tcl::command_group*>(clientdata);
+      if (objc != int(N + 1))
+        return g->invoke_raw(objc, objv);
+      return g->fast_traced(&fast_call, interp, objv);
+    }
+
+    static int fast_call(tcl::command_group* g, Tcl_Interp* /*interp*/,
+                         Tcl_Obj* const objv[]) noexcept
+    {
+      try
+        {
+          tcl_callable* self = static_cast<tcl_callable*>(g->fast_target());
+          self->direct(objv, std::make_index_sequence<N>());
+          return tcl::command_group::fast_ok;
+        }
+      catch (...)
+        {
+          return g->fast_error(objv);
+        }
+    }
+
+    /// Convert all arguments up front, then call over the whole batch.
+    void operator()(tcl::batch_context& bx)
+    {
+      auto cols = this->columns(bx, std::make_index_sequence<N>());
+      for (unsigned int i = 0; i < bx.ncalls(); ++i)
+        this->call_at(cols, i, std::make_index_sequence<N>());
+    }
   };
 
 // ########################################################
@@ -233,6 +513,13 @@ namespace tcl
       (rutz::build_functor(f), std::forward<DefaultArgs>(args)...);
   }
 
+/// Locate the \a Callable held inside a type-erased command callback.
+  template <class Callable>
+  inline void* fast_target_of(std::function<void(tcl::call_context&)>& f)
+  {
+    return f.template target<Callable>();
+  }
+
 ///////////////////////////////////////////////////////////////////////
 //
 // And finally... make_command
@@ -242,6 +529,36 @@ namespace tcl
 
 // ########################################################
 /// Factory function for tcl::command's from function pointers.
+/** This overload is chosen for fixed-arity commands (no default
+    args). Such a command gets a direct Tcl_ObjCmdProc that converts
+    each Tcl_Obj straight into the parameter type and calls \a f,
+    without building a tcl::call_context or going through the
+    arg_dispatcher and overload resolution. The fast path is in effect
+    only while the command has no other overloads; like the generic
+    path, it times each call in the command's rutz::prof. */
+
+  template <class Func>
+  inline void
+  make_command(tcl::interpreter& interp,
+               Func f,
+               const char* cmd_name,
+               const char* usage,
+               const rutz::file_pos& src_pos)
+  {
+    auto callable = build_tcl_callable(f);
+    typedef decltype(callable) callable_t;
+
+    tcl::command_group::make_fast
+      (interp, std::move(callable),
+       &callable_t::fast_proc, &fast_target_of<callable_t>,
+       cmd_name, usage,
+       arg_spec(rutz::func_traits<Func>::num_args + 1,
+                rutz::func_traits<Func>::num_args + 1, false),
+       src_pos);
+  }
+
+// ########################################################
+/// Factory function for tcl::command's with trailing default args.
 
   template <class Func, class... DefaultArgs>
   inline void
@@ -262,6 +579,9 @@ namespace tcl
 
 // ########################################################
 /// Factory function for vectorized tcl::command's from function pointers.
+/** Since the parameter types are known here, the command is given a
+    batched dispatcher: a vector of calls converts each argument list
+    into a C++ array once, and then calls \a f in a plain loop. */
 
   template <class Func, class... DefaultArgs>
   inline void
@@ -273,12 +593,16 @@ namespace tcl
                    const rutz::file_pos& src_pos,
                    DefaultArgs&&... args)
   {
-    make_generic_vec_command
-      (interp, build_tcl_callable(f, std::forward<DefaultArgs>(args)...),
-       cmd_name, usage,
-       arg_spec(rutz::func_traits<Func>::num_args + 1 - sizeof...(DefaultArgs),
-                rutz::func_traits<Func>::num_args + 1, false),
-       keyarg, src_pos);
+    auto callable = build_tcl_callable(f, std::forward<DefaultArgs>(args)...);
+
+    std::function<void(tcl::batch_context&)> batch = callable;
+
+    tcl::command_group::make(interp, callable,
+                             cmd_name, usage,
+                             arg_spec(rutz::func_traits<Func>::num_args + 1 - sizeof...(DefaultArgs),
+                                      rutz::func_traits<Func>::num_args + 1, false),
+                             src_pos,
+                             tcl::get_batch_vec_dispatcher(keyarg, std::move(batch)));
   }
 
 } // end namespace tcl
@@ -0,0 +1,616 @@
+/** @file tcl/numvec.cc packed numeric vectors held directly in Tcl objects */
+
+///////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026-2026 Rob Peters
+// Rob Peters <https://github.com/rjpcal/>
+//
+// created: Mon Oct 19 10:02:11 2026
+//
+// --------------------------------------------------------------------
+//
+// This file is part of GroovX.
+//   [https://github.com/rjpcal/groovx]
+//
+// GroovX is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// GroovX is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GroovX; if not, write to the Free Software Foundation,
+// Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include "tcl/numvec.h"
+
+#include "rutz/error.h"
+#include "rutz/sfmt.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <tcl.h>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "rutz/trace.h"
+#include "rutz/debug.h"
+GVX_DBG_REGISTER
+
+struct tcl::numvec::rep
+{
+  rep(bool i, size_t n) :
+    refcount(0), is_int(i), ints(i ? n : 0), doubles(i ? 0 : n)
+  {}
+
+  size_t size() const { return is_int ? ints.size() : doubles.size(); }
+
+  unsigned int refcount;
+  bool is_int;
+  std::vector<int_type> ints;
+  std::vector<double> doubles;
+};
+
+namespace
+{
+  typedef tcl::numvec::int_type int_type;
+
+  void numvec_free_int_rep(Tcl_Obj* obj);
+  void numvec_dup_int_rep(Tcl_Obj* src, Tcl_Obj* dup);
+  void numvec_update_string(Tcl_Obj* obj);
+  int numvec_set_from_any(Tcl_Interp* interp, Tcl_Obj* obj);
+
+  Tcl_ObjType numvec_type =
+    {
+      const_cast<char*>("numvec"),
+      numvec_free_int_rep,
+      numvec_dup_int_rep,
+      numvec_update_string,
+      numvec_set_from_any
+    };
+
+  tcl::numvec::rep* get_rep(Tcl_Obj* obj)
+  {
+    GVX_ASSERT(obj->typePtr == &numvec_type);
+    return static_cast<tcl::numvec::rep*>
+      (obj->internalRep.twoPtrValue.ptr1);
+  }
+
+  void release(tcl::numvec::rep* r)
+  {
+    GVX_ASSERT(r->refcount > 0);
+    if (--(r->refcount) == 0)
+      delete r;
+  }
+
+  void numvec_free_int_rep(Tcl_Obj* obj)
+  {
+    release(get_rep(obj));
+    obj->internalRep.twoPtrValue.ptr1 = nullptr;
+  }
+
+  void numvec_dup_int_rep(Tcl_Obj* src, Tcl_Obj* dup)
+  {
+    tcl::numvec::rep* r = get_rep(src);
+    ++(r->refcount);
+    dup->internalRep.twoPtrValue.ptr1 = r;
+    dup->internalRep.twoPtrValue.ptr2 = nullptr;
+    dup->typePtr = &numvec_type;
+  }
+
+  void numvec_update_string(Tcl_Obj* obj)
+  {
+  GVX_TRACE("numvec_update_string");
+
+    const tcl::numvec::rep* r = get_rep(obj);
+    const size_t n = r->size();
+
+    // room for the longest element plus a separator each
+    const size_t maxlen = r->is_int ? 21 : TCL_DOUBLE_SPACE + 1;
+
+    char* buf = Tcl_Alloc(static_cast<unsigned int>(n * maxlen + 1));
+    char* p = buf;
+
+    for (size_t i = 0; i < n; ++i)
+      {
+        if (i > 0) *p++ = ' ';
+
+        if (r->is_int)
+          p += snprintf(p, maxlen, "%lld", r->ints[i]);
+        else
+          {
+            Tcl_PrintDouble(nullptr, r->doubles[i], p);
+            p += strlen(p);
+          }
+      }
+
+    *p = '\0';
+
+    obj->bytes = buf;
+    obj->length = int(p - buf);
+  }
+
+  int numvec_set_from_any(Tcl_Interp* interp, Tcl_Obj* /*obj*/)
+  {
+    if (interp != nullptr)
+      Tcl_AppendResult(interp, "can't convert to numvec type",
+                       static_cast<char*>(nullptr));
+    return TCL_ERROR;
+  }
+
+  [[noreturn]] void throw_not_int(const char* str)
+  {
+    throw rutz::error(rutz::sfmt("expected integer but got \"%s\"", str),
+                      SRC_POS);
+  }
+
+  [[noreturn]] void throw_not_double(const char* str)
+  {
+    throw rutz::error(rutz::sfmt("expected floating-point number "
+                                 "but got \"%s\"", str), SRC_POS);
+  }
+}
+
+///////////////////////////////////////////////////////////////////////
+//
+// tcl::numvec member definitions
+//
+///////////////////////////////////////////////////////////////////////
+
+tcl::numvec::numvec(rep* r) : m_rep(r) { ++(m_rep->refcount); }
+
+tcl::numvec::numvec(const numvec& other) :
+  m_rep(other.m_rep)
+{
+  ++(m_rep->refcount);
+}
+
+tcl::numvec& tcl::numvec::operator=(const numvec& other)
+{
+  ++(other.m_rep->refcount);
+  release(m_rep);
+  m_rep = other.m_rep;
+  return *this;
+}
+
+tcl::numvec::~numvec() noexcept
+{
+  release(m_rep);
+}
+
+tcl::numvec tcl::numvec::ints(size_t n)
+{
+  return numvec(new rep(true, n));
+}
+
+tcl::numvec tcl::numvec::doubles(size_t n)
+{
+  return numvec(new rep(false, n));
+}
+
+bool tcl::numvec::is_packed(Tcl_Obj* obj)
+{
+  return obj->typePtr == &numvec_type;
+}
+
+tcl::numvec tcl::numvec::from_obj(Tcl_Obj* obj)
+{
+GVX_TRACE("tcl::numvec::from_obj");
+
+  if (obj->typePtr == &numvec_type)
+    return numvec(get_rep(obj));
+
+  int count = 0;
+  Tcl_Obj** elements = nullptr;
+  if (Tcl_ListObjGetElements(0, obj, &count, &elements) != TCL_OK)
+    throw rutz::error("couldn't split Tcl list", SRC_POS);
+
+  const size_t n = size_t(count);
+
+  // try for all-integers first, and fall back to doubles at the first
+  // element that isn't an integer
+  numvec result = numvec::ints(n);
+  int_type* ip = result.int_data();
+
+  size_t i = 0;
+  for (; i < n; ++i)
+    {
+      Tcl_WideInt w;
+      if (Tcl_GetWideIntFromObj(0, elements[i], &w) != TCL_OK)
+        break;
+      ip[i] = w;
+    }
+
+  if (i == n)
+    return result;
+
+  numvec dresult = numvec::doubles(n);
+  double* dp = dresult.double_data();
+
+  for (size_t k = 0; k < i; ++k)
+    dp[k] = double(ip[k]);
+
+  for (; i < n; ++i)
+    {
+      if (Tcl_GetDoubleFromObj(0, elements[i], &dp[i]) != TCL_OK)
+        throw_not_double(Tcl_GetString(elements[i]));
+    }
+
+  return dresult;
+}
+
+tcl::numvec tcl::numvec::ints_from_obj(Tcl_Obj* obj)
+{
+GVX_TRACE("tcl::numvec::ints_from_obj");
+
+  if (obj->typePtr != &numvec_type)
+    {
+      int count = 0;
+      Tcl_Obj** elements = nullptr;
+      if (Tcl_ListObjGetElements(0, obj, &count, &elements) != TCL_OK)
+        throw rutz::error("couldn't split Tcl list", SRC_POS);
+
+      numvec result = numvec::ints(size_t(count));
+      int_type* ip = result.int_data();
+
+      for (int i = 0; i < count; ++i)
+        {
+          Tcl_WideInt w;
+          if (Tcl_GetWideIntFromObj(0, elements[i], &w) != TCL_OK)
+            throw_not_int(Tcl_GetString(elements[i]));
+          ip[i] = w;
+        }
+
+      return result;
+    }
+
+  numvec src(get_rep(obj));
+
+  if (src.is_int())
+    return src;
+
+  const size_t n = src.size();
+  numvec result = numvec::ints(n);
+  const double* dp = src.double_data();
+  int_type* ip = result.int_data();
+
+  for (size_t i = 0; i < n; ++i)
+    {
+      if (!(std::floor(dp[i]) == dp[i] &&
+            std::fabs(dp[i]) <= double(std::numeric_limits<int_type>::max())))
+        {
+          char buf[TCL_DOUBLE_SPACE];
+          Tcl_PrintDouble(nullptr, dp[i], buf);
+          throw_not_int(buf);
+        }
+      ip[i] = int_type(dp[i]);
+    }
+
+  return result;
+}
+
+bool tcl::numvec::is_int() const { return m_rep->is_int; }
+
+size_t tcl::numvec::size() const { return m_rep->size(); }
+
+void tcl::numvec::make_unique()
+{
+  if (m_rep->refcount > 1)
+    {
+      rep* r = new rep(*m_rep);
+      r->refcount = 0;
+      *this = numvec(r);
+    }
+}
+
+void tcl::numvec::resize(size_t n)
+{
+  make_unique();
+  if (m_rep->is_int) m_rep->ints.resize(n, 0);
+  else               m_rep->doubles.resize(n, 0.0);
+}
+
+const tcl::numvec::int_type* tcl::numvec::int_data() const
+{
+  GVX_ASSERT(m_rep->is_int);
+  return m_rep->ints.data();
+}
+
+tcl::numvec::int_type* tcl::numvec::int_data()
+{
+  GVX_ASSERT(m_rep->is_int);
+  make_unique();
+  return m_rep->ints.data();
+}
+
+const double* tcl::numvec::double_data() const
+{
+  GVX_ASSERT(!m_rep->is_int);
+  return m_rep->doubles.data();
+}
+
+double* tcl::numvec::double_data()
+{
+  GVX_ASSERT(!m_rep->is_int);
+  make_unique();
+  return m_rep->doubles.data();
+}
+
+tcl::obj tcl::numvec::as_obj() const
+{
+GVX_TRACE("tcl::numvec::as_obj");
+
+  Tcl_Obj* obj = Tcl_NewObj();
+  Tcl_InvalidateStringRep(obj);
+
+  ++(m_rep->refcount);
+  obj->internalRep.twoPtrValue.ptr1 = m_rep;
+  obj->internalRep.twoPtrValue.ptr2 = nullptr;
+  obj->typePtr = &numvec_type;
+
+  return tcl::obj(obj);
+}
+
+tcl::numvec tcl::help_convert<tcl::numvec>::from_tcl(Tcl_Obj* obj)
+{
+GVX_TRACE("tcl::help_convert<tcl::numvec>::from_tcl");
+
+  return tcl::numvec::from_obj(obj);
+}
+
+tcl::obj tcl::help_convert<tcl::numvec>::to_tcl(const tcl::numvec& v)
+{
+GVX_TRACE("tcl::help_convert<tcl::numvec>::to_tcl");
+
+  return v.as_obj();
+}
+
+///////////////////////////////////////////////////////////////////////
+//
+// Packed-array kernels. These use SSE2 (which every x86-64 has) where
+// it is available; the AVX2 gather in packed_choose() is only compiled
+// in when the compiler is targeting AVX2 (e.g. -mavx2). There is no
+// runtime dispatch, so a default build never uses AVX2.
+//
+///////////////////////////////////////////////////////////////////////
+
+int_type tcl::packed_sum(const int_type* p, size_t n)
+{
+GVX_TRACE("tcl::packed_sum(int)");
+
+  size_t i = 0;
+  int_type result = 0;
+
+#if defined(__SSE2__)
+  __m128i acc0 = _mm_setzero_si128();
+  __m128i acc1 = _mm_setzero_si128();
+
+  for (; i + 4 <= n; i += 4)
+    {
+      acc0 = _mm_add_epi64(acc0, _mm_loadu_si128((const __m128i*)(p + i)));
+      acc1 = _mm_add_epi64(acc1, _mm_loadu_si128((const __m128i*)(p + i + 2)));
+    }
+
+  int_type lanes[2];
+  _mm_storeu_si128((__m128i*)lanes, _mm_add_epi64(acc0, acc1));
+  result = lanes[0] + lanes[1];
+#endif
+
+  for (; i < n; ++i)
+    result += p[i];
+
+  return result;
+}
+
+namespace
+{
+  // Add x into the running sum s, keeping the rounding error in c
+  // (Neumaier's variant of Kahan summation).
+  inline void neumaier_add(double& s, double& c, double x)
+  {
+    const double t = s + x;
+    if (std::fabs(s) >= std::fabs(x)) c += (s - t) + x;
+    else                              c += (x - t) + s;
+    s = t;
+  }
+
+#if defined(__SSE2__)
+  inline void neumaier_add(__m128d& s, __m128d& c, __m128d x)
+  {
+    const __m128d signbit = _mm_set1_pd(-0.0);
+    const __m128d t = _mm_add_pd(s, x);
+    const __m128d s_bigger = _mm_cmpge_pd(_mm_andnot_pd(signbit, s),
+                                          _mm_andnot_pd(signbit, x));
+    const __m128d big = _mm_or_pd(_mm_and_pd(s_bigger, s),
+                                  _mm_andnot_pd(s_bigger, x));
+    const __m128d small = _mm_or_pd(_mm_and_pd(s_bigger, x),
+                                    _mm_andnot_pd(s_bigger, s));
+    c = _mm_add_pd(c, _mm_add_pd(_mm_sub_pd(big, t), small));
+    s = t;
+  }
+#endif
+}
+
+double tcl::packed_sum(const double* p, size_t n)
+{
+GVX_TRACE("tcl::packed_sum(double)");
+
+  // Compensated summation, so that the result doesn't depend (beyond
+  // the last bit or so) on how the vector lanes split up the terms.
+  size_t i = 0;
+  double s = 0.0;
+  double c = 0.0;
+
+#if defined(__SSE2__)
+  __m128d s0 = _mm_setzero_pd(), c0 = _mm_setzero_pd();
+  __m128d s1 = _mm_setzero_pd(), c1 = _mm_setzero_pd();
+
+  for (; i + 4 <= n; i += 4)
+    {
+      neumaier_add(s0, c0, _mm_loadu_pd(p + i));
+      neumaier_add(s1, c1, _mm_loadu_pd(p + i + 2));
+    }
+
+  double lanes[8];
+  _mm_storeu_pd(lanes,     s0);
+  _mm_storeu_pd(lanes + 2, s1);
+  _mm_storeu_pd(lanes + 4, c0);
+  _mm_storeu_pd(lanes + 6, c1);
+  for (int k = 0; k < 4; ++k)
+    neumaier_add(s, c, lanes[k]);
+  c += (lanes[4] + lanes[5]) + (lanes[6] + lanes[7]);
+#endif
+
+  for (; i < n; ++i)
+    neumaier_add(s, c, p[i]);
+
+  return s + c;
+}
+
+void tcl::packed_range(int_type* p, size_t n, int_type begin, int_type step)
+{
+GVX_TRACE("tcl::packed_range");
+
+  size_t i = 0;
+
+#if defined(__SSE2__)
+  __m128i v0 = _mm_set_epi64x(begin + step, begin);
+  __m128i v1 = _mm_set_epi64x(begin + 3*step, begin + 2*step);
+  const __m128i inc = _mm_set1_epi64x(4*step);
+
+  for (; i + 4 <= n; i += 4)
+    {
+      _mm_storeu_si128((__m128i*)(p + i), v0);
+      _mm_storeu_si128((__m128i*)(p + i + 2), v1);
+      v0 = _mm_add_epi64(v0, inc);
+      v1 = _mm_add_epi64(v1, inc);
+    }
+#endif
+
+  for (; i < n; ++i)
+    p[i] = begin + int_type(i) * step;
+}
+
+namespace
+{
+  // Works on the raw 64-bit words, so it serves for both int_type and
+  // double elements.
+  template <class T>
+  size_t select_impl(const T* src, const int_type* flags, size_t n, T* dst)
+  {
+    static_assert(sizeof(T) == 8, "select_impl needs 64-bit elements");
+
+    size_t i = 0;
+    size_t k = 0;
+
+#if defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128();
+
+    for (; i + 2 <= n; i += 2)
+      {
+        // a 64-bit flag is zero iff both of its 32-bit halves are
+        __m128i z = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(flags + i)),
+                                    zero);
+        z = _mm_and_si128(z, _mm_shuffle_epi32(z, _MM_SHUFFLE(2,3,0,1)));
+        const int keep = ~_mm_movemask_pd(_mm_castsi128_pd(z)) & 3;
+
+        // if only the second element is kept, move it into the first
+        // lane; then store both lanes and advance by the number kept
+        __m128i v = _mm_loadu_si128((const __m128i*)(src + i));
+        if (keep == 2)
+          v = _mm_shuffle_epi32(v, _MM_SHUFFLE(1,0,3,2));
+        _mm_storeu_si128((__m128i*)(dst + k), v);
+        k += size_t((keep & 1) + (keep >> 1));
+      }
+#endif
+
+    for (; i < n; ++i)
+      {
+        dst[k] = src[i];
+        k += (flags[i] != 0);
+      }
+
+    return k;
+  }
+
+  template <class T>
+  bool choose_impl(const T* src, size_t nsrc,
+                   const int_type* idx, size_t n, T* dst)
+  {
+    // check all the indices up front, in a loop that the compiler can
+    // vectorize, so that the gather loop is branch-free
+    int_type bad = 0;
+    for (size_t i = 0; i < n; ++i)
+      bad |= int_type(static_cast<unsigned long long>(idx[i]) >= nsrc);
+
+    if (bad)
+      return false;
+
+    size_t i = 0;
+
+#if defined(__AVX2__)
+    for (; i + 4 <= n; i += 4)
+      {
+        const __m256i ix = _mm256_loadu_si256((const __m256i*)(idx + i));
+        _mm256_storeu_si256
+          ((__m256i*)(dst + i),
+           _mm256_i64gather_epi64((const long long*)src, ix, 8));
+      }
+#endif
+
+    for (; i + 4 <= n; i += 4)
+      {
+        dst[i]   = src[idx[i]];
+        dst[i+1] = src[idx[i+1]];
+        dst[i+2] = src[idx[i+2]];
+        dst[i+3] = src[idx[i+3]];
+      }
+
+    for (; i < n; ++i)
+      dst[i] = src[idx[i]];
+
+    return true;
+  }
+}
+
+size_t tcl::packed_select(const int_type* src, const int_type* flags,
+                          size_t n, int_type* dst)
+{
+GVX_TRACE("tcl::packed_select(int)");
+  return select_impl(src, flags, n, dst);
+}
+
+size_t tcl::packed_select(const double* src, const int_type* flags,
+                          size_t n, double* dst)
+{
+GVX_TRACE("tcl::packed_select(double)");
+  return select_impl(src, flags, n, dst);
+}
+
+bool tcl::packed_choose(const int_type* src, size_t nsrc,
+                        const int_type* idx, size_t n, int_type* dst)
+{
+GVX_TRACE("tcl::packed_choose(int)");
+  return choose_impl(src, nsrc, idx, n, dst);
+}
+
+bool tcl::packed_choose(const double* src, size_t nsrc,
+                        const int_type* idx, size_t n, double* dst)
+{
+GVX_TRACE("tcl::packed_choose(double)");
+  return choose_impl(src, nsrc, idx, n, dst);
+}
@@ -0,0 +1,161 @@
+/** @file tcl/numvec.h packed numeric vectors held directly in Tcl objects */
+
+///////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026-2026 Rob Peters
+// Rob Peters <https://github.com/rjpcal/>
+//
+// created: Mon Oct 19 10:02:11 2026
+//
+// --------------------------------------------------------------------
+//
+// This file is part of GroovX.
+//   [https://github.com/rjpcal/groovx]
+//
+// GroovX is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// GroovX is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GroovX; if not, write to the Free Software Foundation,
+// Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef GROOVX_TCL_NUMVEC_H_UTC20261019100211_DEFINED
+#define GROOVX_TCL_NUMVEC_H_UTC20261019100211_DEFINED
+
+#include "tcl/conversions.h"
+#include "tcl/obj.h"
+
+#include <cstddef>
+
+namespace tcl
+{
+  class numvec;
+
+  template <>
+  struct help_convert<tcl::numvec>
+  {
+    static tcl::numvec from_tcl(Tcl_Obj* obj);
+    static tcl::obj to_tcl(const tcl::numvec& v);
+  };
+}
+
+///////////////////////////////////////////////////////////////////////
+/**
+ *
+ * tcl::numvec is a packed array of 64-bit integers or of doubles. It
+ * has its own Tcl_ObjType, so a numvec can travel through Tcl scripts
+ * without being boxed into a list of Tcl_Obj's; the string rep (an
+ * ordinary list of numbers) is only generated if somebody asks for
+ * it. Copies share the packed data, which is copied on write.
+ *
+ **/
+///////////////////////////////////////////////////////////////////////
+
+class tcl::numvec
+{
+public:
+  typedef long long int_type;
+
+  /// Make an uninitialized vector of \a n integers.
+  static numvec ints(size_t n);
+
+  /// Make an uninitialized vector of \a n doubles.
+  static numvec doubles(size_t n);
+
+  /// Get the numbers held in \a obj.
+  /** If \a obj holds a packed vector, its data are shared without
+      copying. Otherwise \a obj is split as a Tcl list, giving integers
+      if every element is an integer, or else doubles. An exception is
+      thrown if an element is not a number. */
+  static numvec from_obj(Tcl_Obj* obj);
+
+  /// Like from_obj(), but the result always holds integers.
+  /** An exception is thrown if any value is not an integer. */
+  static numvec ints_from_obj(Tcl_Obj* obj);
+
+  /// Query whether \a obj currently holds a packed vector.
+  static bool is_packed(Tcl_Obj* obj);
+
+  numvec(const numvec& other);
+  numvec& operator=(const numvec& other);
+  ~numvec() noexcept;
+
+  /// Query whether the elements are integers (otherwise, doubles).
+  bool is_int() const;
+
+  /// Get the number of elements.
+  size_t size() const;
+
+  /// Shrink or grow to \a n elements; new elements are zero.
+  void resize(size_t n);
+
+  /// Get the element data; only valid if is_int().
+  const int_type* int_data() const;
+  int_type* int_data();
+
+  /// Get the element data; only valid if !is_int().
+  const double* double_data() const;
+  double* double_data();
+
+  /// Get element \a i as a double, whatever the element type.
+  double get_double(size_t i) const
+  { return is_int() ? double(int_data()[i]) : double_data()[i]; }
+
+  /// Make a Tcl object that holds (and shares) this vector.
+  tcl::obj as_obj() const;
+
+  struct rep;
+
+private:
+  explicit numvec(rep* r);
+
+  void make_unique();
+
+  rep* m_rep;
+};
+
+namespace tcl
+{
+  /// Sum the \a n values in \a p.
+  /** The integer sum wraps around on 64-bit overflow. The double sum
+      is compensated (Neumaier) summation, so it is usually more
+      accurate than adding the values in order: {1e16 1 -1e16} sums to
+      1, not 0. */
+  numvec::int_type packed_sum(const numvec::int_type* p, size_t n);
+  double packed_sum(const double* p, size_t n);
+
+  /// Fill \a p with \a begin, \a begin + \a step, \a begin + 2*\a step, ...
+  void packed_range(numvec::int_type* p, size_t n,
+                    numvec::int_type begin, numvec::int_type step);
+
+  /// Copy each src[i] whose flags[i] is non-zero into \a dst.
+  /** \a dst must have room for \a n elements. Returns the number of
+      elements copied. */
+  size_t packed_select(const numvec::int_type* src,
+                       const numvec::int_type* flags, size_t n,
+                       numvec::int_type* dst);
+  size_t packed_select(const double* src,
+                       const numvec::int_type* flags, size_t n,
+                       double* dst);
+
+  /// Set dst[i] = src[idx[i]] for each of the \a n indices.
+  /** Returns false, leaving \a dst unspecified, if any index is
+      outside [0, \a nsrc). */
+  bool packed_choose(const numvec::int_type* src, size_t nsrc,
+                     const numvec::int_type* idx, size_t n,
+                     numvec::int_type* dst);
+  bool packed_choose(const double* src, size_t nsrc,
+                     const numvec::int_type* idx, size_t n,
+                     double* dst);
+}
+
+#endif // !GROOVX_TCL_NUMVEC_H_UTC20261019100211_DEFINED
@@ -36,10 +36,12 @@
 // This file implements additional Tcl list manipulation functions
 
 #include "tcl/list.h"
+#include "tcl/numvec.h"
 #include "tcl/pkg.h"
 
 #include "rutz/error.h"
 #include "rutz/rand.h"
+#include "rutz/sfmt.h"
 
 #include "rutz/trace.h"
 #include "rutz/debug.h"
@@ -47,6 +49,7 @@ GVX_DBG_REGISTER
 
 #include <algorithm> // for std::random_shuffle
 #include <cmath>
+#include <numeric> // for std::iota
 #include <utility>
 #include <vector>
 
@@ -96,34 +99,102 @@ namespace
   //
   //---------------------------------------------------------
 
-  tcl::list dlist_choose(const tcl::list& source_list, const tcl::list& index_list)
+  tcl::obj choose_aux(const tcl::obj& source, const tcl::numvec& index)
   {
+    const size_t n = index.size();
+    const tcl::numvec::int_type* ip = index.int_data();
+
+    for (size_t i = 0; i < n; ++i)
+      if (ip[i] < 0)
+        throw rutz::error(rutz::sfmt("expected integer but got \"%lld\" "
+                                     "(value was negative)", ip[i]),
+                          SRC_POS);
+
+    if (tcl::numvec::is_packed(source.get()))
+      {
+        // packed source: gather straight from the packed array
+        const tcl::numvec src = tcl::numvec::from_obj(source.get());
+
+        bool ok = false;
+        tcl::numvec result = src.is_int()
+          ? tcl::numvec::ints(n) : tcl::numvec::doubles(n);
+
+        if (src.is_int())
+          ok = tcl::packed_choose(src.int_data(), src.size(),
+                                  ip, n, result.int_data());
+        else
+          ok = tcl::packed_choose(src.double_data(), src.size(),
+                                  ip, n, result.double_data());
+
+        if (!ok)
+          throw rutz::error("index was out of range in Tcl list access",
+                            SRC_POS);
+
+        return result.as_obj();
+      }
+
+    const tcl::list source_list(source);
     tcl::list result;
 
-    for (const unsigned int index: index_list.view_of<unsigned int>())
+    for (size_t i = 0; i < n; ++i)
       {
         // use that int as an index into source list, getting the
         // corresponding list element and appending it to the output list
-        result.append(source_list.at(index));
+        result.append(source_list.at(static_cast<unsigned int>(ip[i])));
       }
 
-    GVX_ASSERT(result.length() == index_list.length());
+    GVX_ASSERT(result.length() == n);
 
+    return result.as_obj();
+  }
+
+  // Make the index vector {begin, begin+1, ..., begin+n-1}.
+  tcl::numvec iota_ints(size_t n, tcl::numvec::int_type begin = 0)
+  {
+    tcl::numvec result = tcl::numvec::ints(n);
+    tcl::packed_range(result.int_data(), n, begin, 1);
     return result;
   }
 
+  tcl::obj dlist_choose(const tcl::obj& source_list, const tcl::obj& index_list)
+  {
+    return choose_aux(source_list, tcl::numvec::ints_from_obj(index_list.get()));
+  }
+
+  // Get the length of a list, without unpacking it if it is packed.
+  size_t length_of(const tcl::obj& x)
+  {
+    if (tcl::numvec::is_packed(x.get()))
+      return tcl::numvec::from_obj(x.get()).size();
+
+    return tcl::list::get_obj_list_length(x.get());
+  }
+
   //---------------------------------------------------------
   //
   // Cyclically shift the elements of the list leftward by n steps.
   //
   //---------------------------------------------------------
 
-  tcl::list dlist_cycle_left(tcl::list source_list, unsigned int n)
+  tcl::obj dlist_cycle_left(const tcl::obj& source, unsigned int n)
   {
-    n = n % source_list.length();
+    const size_t len = length_of(source);
+
+    n = n % len;
 
     if (n == 0)
-      return source_list;
+      return source;
+
+    if (tcl::numvec::is_packed(source.get()))
+      {
+        tcl::numvec index = iota_ints(len, n);
+        tcl::numvec::int_type* ip = index.int_data();
+        for (size_t i = len - n; i < len; ++i)
+          ip[i] -= len;
+        return choose_aux(source, index);
+      }
+
+    const tcl::list source_list(source);
 
     tcl::list result;
 
@@ -137,7 +208,7 @@ namespace
         result.append(source_list.at(i));
       }
 
-    return result;
+    return result.as_obj();
   }
 
   //---------------------------------------------------------
@@ -146,14 +217,16 @@ namespace
   //
   //---------------------------------------------------------
 
-  tcl::list dlist_cycle_right(tcl::list source_list, unsigned int n)
+  tcl::obj dlist_cycle_right(const tcl::obj& source, unsigned int n)
   {
-    n = n % source_list.length();
+    const size_t len = length_of(source);
+
+    n = n % len;
 
     if (n == 0)
-      return source_list;
+      return source;
 
-    return dlist_cycle_left(source_list, source_list.length() - n);
+    return dlist_cycle_left(source, static_cast<unsigned int>(len - n));
   }
 
   //---------------------------------------------------------
@@ -163,9 +236,20 @@ namespace
   //
   //---------------------------------------------------------
 
-  tcl::obj dlist_index(const tcl::list& source_list, unsigned int n)
+  tcl::obj dlist_index(const tcl::obj& source, unsigned int n)
   {
-    return source_list.at(n);
+    if (tcl::numvec::is_packed(source.get()))
+      {
+        const tcl::numvec src = tcl::numvec::from_obj(source.get());
+        if (n >= src.size())
+          throw rutz::error("index was out of range in Tcl list access",
+                            SRC_POS);
+        return src.is_int()
+          ? tcl::convert_from(src.int_data()[n])
+          : tcl::convert_from(src.double_data()[n]);
+      }
+
+    return tcl::list(source).at(n);
   }
 
   //---------------------------------------------------------
@@ -176,21 +260,18 @@ namespace
   //
   //---------------------------------------------------------
 
-  tcl::list dlist_not(const tcl::list& source_list)
+  tcl::numvec dlist_not(const tcl::obj& source_list)
   {
-    const tcl::obj one = tcl::convert_from<int>(1);
-    const tcl::obj zero = tcl::convert_from<int>(0);
-    tcl::list result;
+    const tcl::numvec src = tcl::numvec::ints_from_obj(source_list.get());
+    const size_t n = src.size();
 
-    for (const int i: source_list.view_of<int>())
-      {
-        if ( i == 0 )
-          result.append(one);
-        else
-          result.append(zero);
-      }
+    tcl::numvec result = tcl::numvec::ints(n);
 
-    GVX_ASSERT(result.length() == source_list.length());
+    const tcl::numvec::int_type* sp = src.int_data();
+    tcl::numvec::int_type* rp = result.int_data();
+
+    for (size_t i = 0; i < n; ++i)
+      rp[i] = (sp[i] == 0);
 
     return result;
   }
@@ -202,10 +283,10 @@ namespace
   //
   //---------------------------------------------------------
 
-  tcl::list dlist_ones(unsigned int num_ones)
+  tcl::numvec dlist_ones(unsigned int num_ones)
   {
-    tcl::list result;
-    result.append(1, num_ones);
+    tcl::numvec result = tcl::numvec::ints(num_ones);
+    std::fill_n(result.int_data(), num_ones, 1);
 
     return result;
   }
@@ -217,14 +298,17 @@ namespace
   //
   //---------------------------------------------------------
 
-  tcl::obj dlist_pickone(const tcl::list& source_list)
+  tcl::obj dlist_pickone(const tcl::obj& source_list)
   {
-    if (source_list.length() == 0)
+    const size_t len = length_of(source_list);
+
+    if (len == 0)
       {
         throw rutz::error("source_list is empty", SRC_POS);
       }
 
-    return source_list.at(rutz::rand_range(0u, source_list.length()));
+    return dlist_index(source_list,
+                       rutz::rand_range(0u, static_cast<unsigned int>(len)));
   }
 
   //---------------------------------------------------------
@@ -234,9 +318,11 @@ namespace
   //
   //---------------------------------------------------------
 
-  tcl::list dlist_range(int begin, int end, int step)
+  tcl::numvec dlist_range(int begin, int end, int step)
   {
-    tcl::list result;
+    typedef tcl::numvec::int_type int_type;
+
+    size_t n = 0;
 
     if (step == 0)
       {
@@ -244,19 +330,18 @@ namespace
       }
     else if (step > 0)
       {
-        for (int i = begin; i <= end; i += step)
-          {
-            result.append(i);
-          }
+        if (end >= begin)
+          n = size_t((int_type(end) - begin) / step + 1);
       }
     else // step < 0
       {
-        for (int i = begin; i >= end; i += step)
-          {
-            result.append(i);
-          }
+        if (end <= begin)
+          n = size_t((int_type(begin) - end) / -int_type(step) + 1);
       }
 
+    tcl::numvec result = tcl::numvec::ints(n);
+    tcl::packed_range(result.int_data(), n, begin, step);
+
     return result;
   }
 
@@ -267,10 +352,8 @@ namespace
   //
   //---------------------------------------------------------
 
-  tcl::list dlist_linspace(double begin, double end, unsigned int npts)
+  tcl::numvec dlist_linspace(double begin, double end, unsigned int npts)
   {
-    tcl::list result;
-
     if (npts < 2)
       {
         throw rutz::error("npts must be at least 2", SRC_POS);
@@ -281,29 +364,35 @@ namespace
     bool integer_mode = (skip - int(skip) == 0.0) && (begin - int(begin) == 0.0);
 
     if (integer_mode)
-      for (unsigned int i = 0; i < npts; ++i)
-        {
-          result.append(int(begin + i*skip));
-        }
-    else
-      for (unsigned int i = 0; i < npts; ++i)
-        {
-          result.append(begin + i*skip);
-        }
+      {
+        tcl::numvec result = tcl::numvec::ints(npts);
+        tcl::numvec::int_type* rp = result.int_data();
+        for (unsigned int i = 0; i < npts; ++i)
+          {
+            rp[i] = int(begin + i*skip);
+          }
+        return result;
+      }
 
+    tcl::numvec result = tcl::numvec::doubles(npts);
+    double* rp = result.double_data();
+    for (unsigned int i = 0; i < npts; ++i)
+      {
+        rp[i] = begin + i*skip;
+      }
     return result;
   }
 
-  double dlist_perm_distance(const tcl::list& src)
+  double dlist_perm_distance(const tcl::obj& src)
   {
-    return perm_distance_aux(src.begin<unsigned int>(),
-                             src.end<unsigned int>());
+    const tcl::numvec v = tcl::numvec::ints_from_obj(src.get());
+    return perm_distance_aux(v.int_data(), v.int_data() + v.size());
   }
 
-  double dlist_perm_distance2(const tcl::list& src, double power)
+  double dlist_perm_distance2(const tcl::obj& src, double power)
   {
-    return perm_distance2_aux(src.begin<unsigned int>(),
-                              src.end<unsigned int>(),
+    const tcl::numvec v = tcl::numvec::ints_from_obj(src.get());
+    return perm_distance2_aux(v.int_data(), v.int_data() + v.size(),
                               power);
   }
 
@@ -321,7 +410,7 @@ namespace
   //
   //---------------------------------------------------------
 
-  tcl::list dlist_permute_maximal(unsigned int N)
+  tcl::numvec dlist_permute_maximal(unsigned int N)
   {
     if (N < 2)
       throw rutz::error("N must be at least 2 to make a permutation",
@@ -383,12 +472,8 @@ namespace
 
             dbg_eval_nl(3, c);
 
-            tcl::list result;
-
-            for (unsigned int k = 0; k < slots.size(); ++k)
-              {
-                result.append(slots[k]);
-              }
+            tcl::numvec result = tcl::numvec::ints(slots.size());
+            std::copy(slots.begin(), slots.end(), result.int_data());
 
             return result;
           }
@@ -405,7 +490,7 @@ namespace
   //
   //---------------------------------------------------------
 
-  tcl::list dlist_permute_moveall(unsigned int N)
+  tcl::numvec dlist_permute_moveall(unsigned int N)
   {
     if (N < 2)
       throw rutz::error("N must be at least 2 to make a permutation", SRC_POS);
@@ -450,12 +535,8 @@ namespace
         slots[N-1] = lastslot;
       }
 
-    tcl::list result;
-
-    for (unsigned int i = 0; i < slots.size(); ++i)
-      {
-        result.append(slots[i]);
-      }
+    tcl::numvec result = tcl::numvec::ints(slots.size());
+    std::copy(slots.begin(), slots.end(), result.int_data());
 
     return result;
   }
@@ -467,16 +548,15 @@ namespace
   //
   //---------------------------------------------------------
 
-  tcl::list dlist_rand(double min, double max, unsigned int N)
+  tcl::numvec dlist_rand(double min, double max, unsigned int N)
   {
-    tcl::list result;
+    tcl::numvec result = tcl::numvec::doubles(N);
+    double* rp = result.double_data();
 
-    static rutz::urand generator;
+    static rutz::rng generator;
 
-    for (unsigned int i = 0; i < N; ++i)
-      {
-        result.append(generator.fdraw_range(min, max));
-      }
+    generator.follow_default_engine();
+    generator.fill_fdraw_range(rp, N, min, max);
 
     return result;
   }
@@ -495,20 +575,43 @@ namespace
   //
   //---------------------------------------------------------
 
-  tcl::list dlist_repeat(tcl::list source_list, tcl::list times_list)
+  tcl::obj dlist_repeat(const tcl::obj& source, const tcl::obj& times)
   {
+    const tcl::numvec times_vec = tcl::numvec::ints_from_obj(times.get());
+    const tcl::numvec::int_type* tp = times_vec.int_data();
+
     // find the minimum of the two lists' lengths
-    unsigned int min_len = std::min(source_list.length(), times_list.length());
+    const size_t min_len = std::min(length_of(source), times_vec.size());
+
+    size_t total = 0;
+    for (size_t t = 0; t < min_len; ++t)
+      {
+        if (tp[t] < 0)
+          throw rutz::error(rutz::sfmt("expected integer but got \"%lld\" "
+                                       "(value was negative)", tp[t]),
+                            SRC_POS);
+        total += size_t(tp[t]);
+      }
 
+    if (tcl::numvec::is_packed(source.get()))
+      {
+        tcl::numvec index = tcl::numvec::ints(total);
+        tcl::numvec::int_type* ip = index.int_data();
+        for (size_t t = 0; t < min_len; ++t)
+          ip = std::fill_n(ip, tp[t], tcl::numvec::int_type(t));
+        return choose_aux(source, index);
+      }
+
+    const tcl::list source_list(source);
     tcl::list result;
 
-    for (unsigned int t = 0; t < min_len; ++t)
+    for (size_t t = 0; t < min_len; ++t)
       {
-        result.append(source_list.at(t),
-                      times_list.get<unsigned int>(t));
+        result.append(source_list.at(static_cast<unsigned int>(t)),
+                      static_cast<unsigned int>(tp[t]));
       }
 
-    return result;
+    return result.as_obj();
   }
 
   //---------------------------------------------------------
@@ -518,15 +621,25 @@ namespace
   //
   //---------------------------------------------------------
 
-  tcl::list dlist_reverse(tcl::list src)
+  tcl::obj dlist_reverse(const tcl::obj& source)
   {
-    if (src.length() < 2)
-      return src;
+    const size_t len = length_of(source);
+
+    if (len < 2)
+      return source;
+
+    if (tcl::numvec::is_packed(source.get()))
+      {
+        tcl::numvec index = tcl::numvec::ints(len);
+        tcl::packed_range(index.int_data(), len, len - 1, -1);
+        return choose_aux(source, index);
+      }
 
+    const tcl::list src(source);
     tcl::list result;
     for (unsigned int i = 0; i < src.length(); ++i)
       result.append(src.at(src.length()-i-1));
-    return result;
+    return result.as_obj();
   }
 
   //---------------------------------------------------------
@@ -537,30 +650,50 @@ namespace
   //
   //---------------------------------------------------------
 
-  tcl::list dlist_select(const tcl::list& source_list, const tcl::list& flags_list)
+  tcl::obj dlist_select(const tcl::obj& source, const tcl::obj& flags_list)
   {
-    unsigned int src_len = source_list.length();
-    unsigned int flg_len = flags_list.length();
+    const size_t src_len = length_of(source);
 
-    if (flg_len < src_len)
+    const tcl::numvec flags = tcl::numvec::ints_from_obj(flags_list.get());
+
+    if (flags.size() < src_len)
       {
         throw rutz::error("flags list must be as long as source_list",
                           SRC_POS);
       }
 
+    const tcl::numvec::int_type* fp = flags.int_data();
+
+    if (tcl::numvec::is_packed(source.get()))
+      {
+        const tcl::numvec src = tcl::numvec::from_obj(source.get());
+
+        tcl::numvec result = src.is_int()
+          ? tcl::numvec::ints(src_len) : tcl::numvec::doubles(src_len);
+
+        const size_t n = src.is_int()
+          ? tcl::packed_select(src.int_data(), fp, src_len, result.int_data())
+          : tcl::packed_select(src.double_data(), fp, src_len,
+                               result.double_data());
+
+        result.resize(n);
+        return result.as_obj();
+      }
+
+    const tcl::list source_list(source);
     tcl::list result;
 
-    for (unsigned int i = 0; i < src_len; ++i)
+    for (size_t i = 0; i < src_len; ++i)
       {
         // if the flag is true, add the corresponding source_list
         // element to the result list
-        if ( flags_list.get<int>(i) )
+        if ( fp[i] )
           {
-            result.append(source_list.at(i));
+            result.append(source_list.at(static_cast<unsigned int>(i)));
           }
       }
 
-    return result;
+    return result.as_obj();
   }
 
   //---------------------------------------------------------
@@ -569,11 +702,27 @@ namespace
   //
   //---------------------------------------------------------
 
-  tcl::list dlist_shuffle(const tcl::list& src, unsigned long seed)
+  tcl::obj dlist_shuffle(const tcl::obj& source, unsigned long seed)
   {
+    if (tcl::numvec::is_packed(source.get()))
+      {
+        // shuffling the indices makes the same permutation as
+        // shuffling the elements themselves
+        tcl::numvec index = iota_ints(length_of(source));
+
+        rutz::rng generator(seed);
+
+        std::random_shuffle(index.int_data(),
+                            index.int_data() + index.size(), generator);
+
+        return choose_aux(source, index);
+      }
+
+    const tcl::list src(source);
+
     std::vector<tcl::obj> objs(src.begin<tcl::obj>(), src.end<tcl::obj>());
 
-    rutz::urand generator(seed);
+    rutz::rng generator(seed);
 
     std::random_shuffle(objs.begin(), objs.end(), generator);
 
@@ -584,7 +733,7 @@ namespace
         result.append(objs[i]);
       }
 
-    return result;
+    return result.as_obj();
   }
 
   //---------------------------------------------------------
@@ -594,10 +743,11 @@ namespace
   //
   //---------------------------------------------------------
 
-  tcl::list dlist_shuffle_moveall(const tcl::list& src)
+  tcl::obj dlist_shuffle_moveall(const tcl::obj& src)
   {
-    tcl::list permutation = dlist_permute_moveall(src.length());
-    return dlist_choose(src, permutation);
+    const tcl::numvec permutation =
+      dlist_permute_moveall(static_cast<unsigned int>(length_of(src)));
+    return choose_aux(src, permutation);
   }
 
   //---------------------------------------------------------
@@ -606,10 +756,11 @@ namespace
   //
   //---------------------------------------------------------
 
-  tcl::list dlist_shuffle_maximal(const tcl::list& src)
+  tcl::obj dlist_shuffle_maximal(const tcl::obj& src)
   {
-    tcl::list permutation = dlist_permute_maximal(src.length());
-    return dlist_choose(src, permutation);
+    const tcl::numvec permutation =
+      dlist_permute_maximal(static_cast<unsigned int>(length_of(src)));
+    return choose_aux(src, permutation);
   }
 
   //---------------------------------------------------------
@@ -639,41 +790,22 @@ namespace
   // result if possible, but returning a double result if any doubles
   // are found in the source list
   //
+  // NOTE: an all-int list is summed in 64 bits, and a list with any
+  // doubles is summed entirely as doubles with compensated summation
+  // (see tcl::packed_sum()). So this no longer matches adding the
+  // values one by one: {2147483647 1} gives 2147483648 rather than
+  // overflowing, and {1e16 1 -1e16} gives 1 rather than 0.
+  //
   //---------------------------------------------------------
 
-  tcl::obj dlist_sum(const tcl::list& source_list)
+  tcl::obj dlist_sum(const tcl::numvec& source_list)
   {
-    int isum=0;
-    double dsum=0.0;
-    bool seen_double=false;
-
-    for (unsigned int i = 0; i < source_list.length(); /* incr in loop body*/)
-      {
-        if ( !seen_double )
-          {
-            try
-              {
-                isum += source_list.get<int>(i);
-              }
-            catch(rutz::error&)
-              {
-                seen_double = true;
-                dsum = isum;
-                continue; // skip the increment
-              }
-          }
-        else
-          {
-            dsum += source_list.get<double>(i);
-          }
-
-        ++i; // here's the increment
-      }
-
-    if ( !seen_double )
-      return tcl::convert_from(isum);
+    if (source_list.is_int())
+      return tcl::convert_from(tcl::packed_sum(source_list.int_data(),
+                                               source_list.size()));
     else
-      return tcl::convert_from(dsum);
+      return tcl::convert_from(tcl::packed_sum(source_list.double_data(),
+                                               source_list.size()));
   }
 
   //---------------------------------------------------------
@@ -683,10 +815,10 @@ namespace
   //
   //---------------------------------------------------------
 
-  tcl::list dlist_zeros(unsigned int num_zeros)
+  tcl::numvec dlist_zeros(unsigned int num_zeros)
   {
-    tcl::list result;
-    result.append(0, num_zeros);
+    tcl::numvec result = tcl::numvec::ints(num_zeros);
+    std::fill_n(result.int_data(), num_zeros, 0);
 
     return result;
   }
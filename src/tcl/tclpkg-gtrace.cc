@@ -31,13 +31,19 @@
 
 #include "tcl/tclpkg-gtrace.h"
 
+#include "tcl/list.h"
 #include "tcl/pkg.h"
 
 #include "rutz/error.h"
 #include "rutz/fstring.h"
+#include "rutz/profgraph.h"
 #include "rutz/sfmt.h"
+#include "rutz/tracerecorder.h"
 
+#include <fstream>
+#include <map>
 #include <sstream>
+#include <string>
 
 #include "rutz/debug.h"
 GVX_DBG_REGISTER
@@ -52,6 +58,110 @@ namespace
     return rutz::fstring(oss.str().c_str());
   }
 
+  // Named snapshots taken with Prof::snapshot
+  std::map<std::string, rutz::prof_snapshot> g_snapshots;
+
+  const rutz::prof_snapshot& getSnapshot(const char* name)
+  {
+    auto itr = g_snapshots.find(name);
+    if (itr == g_snapshots.end())
+      throw rutz::error(rutz::sfmt("no profile snapshot named '%s'", name),
+                        SRC_POS);
+    return itr->second;
+  }
+
+  // The profile data since the named snapshot was taken
+  rutz::prof_snapshot sinceSnapshot(const char* name)
+  {
+    return rutz::prof_snapshot::take().diff(getSnapshot(name));
+  }
+
+  void takeSnapshot(const char* name)
+  {
+    g_snapshots[name] = rutz::prof_snapshot::take();
+  }
+
+  void forgetSnapshot(const char* name)
+  {
+    getSnapshot(name);
+    g_snapshots.erase(name);
+  }
+
+  tcl::list snapshotNames()
+  {
+    tcl::list result;
+    for (const auto& s: g_snapshots)
+      result.append(s.first.c_str());
+    return result;
+  }
+
+  tcl::list entryList(const rutz::prof_snapshot& snap)
+  {
+    tcl::list result;
+    for (const auto& e: snap.entries())
+      {
+        tcl::list item;
+        item.append(e.name.c_str());
+        item.append(e.count);
+        item.append(e.self_usec);
+        item.append(e.total_usec);
+        result.append(item);
+      }
+    return result;
+  }
+
+  tcl::list edgeList(const rutz::prof_snapshot& snap)
+  {
+    tcl::list result;
+    for (const auto& e: snap.edges())
+      {
+        tcl::list item;
+        item.append(e.parent.c_str());
+        item.append(e.child.c_str());
+        item.append(e.count);
+        item.append(e.total_usec);
+        result.append(item);
+      }
+    return result;
+  }
+
+  rutz::fstring summaryText(const rutz::prof_snapshot& snap)
+  {
+    std::ostringstream oss;
+    snap.print(oss);
+    return rutz::fstring(oss.str().c_str());
+  }
+
+  void writeFile(const char* fname, const rutz::prof_snapshot& snap,
+                 void (rutz::prof_snapshot::* writer)(std::ostream&) const)
+  {
+    std::ofstream ofs(fname);
+    if (!ofs.is_open())
+      throw rutz::error(rutz::sfmt("couldn't open '%s' for writing", fname),
+                        SRC_POS);
+    (snap.*writer)(ofs);
+    if (!ofs)
+      throw rutz::error(rutz::sfmt("error while writing '%s'", fname),
+                        SRC_POS);
+  }
+
+  tcl::list recordStats()
+  {
+    tcl::list result;
+    result.append((long long) rutz::trace_recorder::num_written());
+    result.append((long long) rutz::trace_recorder::num_dropped());
+    return result;
+  }
+
+  void recordToChrome(const char* trace_fname, const char* json_fname)
+  {
+    std::ofstream ofs(json_fname);
+    if (!ofs.is_open())
+      throw rutz::error(rutz::sfmt("couldn't open '%s' for writing",
+                                   json_fname), SRC_POS);
+    rutz::trace_recorder::write_chrome_trace(trace_fname, ofs);
+  }
+
   void setOneLevel(int key, int level)
   {
     if (!rutz::debug::is_valid_key(key))
@@ -91,6 +201,12 @@ GVX_TRACE("Gtrace_Init");
       pkg->def("::dbglevel", "key level", &setOneLevel, SRC_POS);
       pkg->def("::dbglevelc", "filename level", &setOneLevelc, SRC_POS);
       pkg->def("::dbgkey", "filename", &rutz::debug::lookup_key, SRC_POS);
+
+      pkg->def("recordStart", "filename", &rutz::trace_recorder::start, SRC_POS);
+      pkg->def("recordStop", "", &rutz::trace_recorder::stop, SRC_POS);
+      pkg->def("recording", "", &rutz::trace_recorder::is_recording, SRC_POS);
+      pkg->def("recordStats", "", &recordStats, SRC_POS);
+      pkg->def("recordToChrome", "trace_filename json_filename", &recordToChrome, SRC_POS);
     });
 }
 
@@ -103,6 +219,56 @@ GVX_TRACE("Prof_Init");
     (interp, "Prof", "4.0",
      [](tcl::pkg* pkg) {
       pkg->def("summary", "", &profSummary, SRC_POS);
+      pkg->def("summary", "since_snapshot",
+               [](const char* n) { return summaryText(sinceSnapshot(n)); },
+               SRC_POS);
       pkg->def("reset", "", &rutz::prof::reset_all_prof_data, SRC_POS);
+
+      pkg->def("callGraph", "", &rutz::call_graph::is_enabled, SRC_POS);
+      pkg->def("callGraph", "on_off", &rutz::call_graph::set_enabled, SRC_POS);
+
+      pkg->def("snapshot", "name", &takeSnapshot, SRC_POS);
+      pkg->def("forget", "name", &forgetSnapshot, SRC_POS);
+      pkg->def("snapshots", "", &snapshotNames, SRC_POS);
+
+      pkg->def("data", "",
+               []() { return entryList(rutz::prof_snapshot::take()); },
+               SRC_POS);
+      pkg->def("data", "since_snapshot",
+               [](const char* n) { return entryList(sinceSnapshot(n)); },
+               SRC_POS);
+      pkg->def("diff", "from_snapshot to_snapshot",
+               [](const char* from, const char* to)
+               { return entryList(getSnapshot(to).diff(getSnapshot(from))); },
+               SRC_POS);
+
+      pkg->def("edges", "",
+               []() { return edgeList(rutz::prof_snapshot::take()); },
+               SRC_POS);
+      pkg->def("edges", "since_snapshot",
+               [](const char* n) { return edgeList(sinceSnapshot(n)); },
+               SRC_POS);
+
+      pkg->def("flamegraph", "filename",
+               [](const char* f)
+               { writeFile(f, rutz::prof_snapshot::take(),
+                           &rutz::prof_snapshot::write_collapsed); },
+               SRC_POS);
+      pkg->def("flamegraph", "filename since_snapshot",
+               [](const char* f, const char* n)
+               { writeFile(f, sinceSnapshot(n),
+                           &rutz::prof_snapshot::write_collapsed); },
+               SRC_POS);
+
+      pkg->def("chromeTrace", "filename",
+               [](const char* f)
+               { writeFile(f, rutz::prof_snapshot::take(),
+                           &rutz::prof_snapshot::write_chrome_trace); },
+               SRC_POS);
+      pkg->def("chromeTrace", "filename since_snapshot",
+               [](const char* f, const char* n)
+               { writeFile(f, sinceSnapshot(n),
+                           &rutz::prof_snapshot::write_chrome_trace); },
+               SRC_POS);
     });
 }
@@ -52,7 +52,7 @@
 
 namespace
 {
-  rutz::urand generator;
+  rutz::rng generator;
 
   void usleepr(unsigned int usecs, unsigned int reps)
   {
@@ -84,6 +84,16 @@ namespace
   unsigned long get_default_seed() { return rutz::default_rand_seed; }
   void set_default_seed(unsigned long x) { rutz::default_rand_seed = x; }
 
+  const char* get_default_engine()
+  {
+    return rutz::rand_engine_name(rutz::default_rand_engine);
+  }
+
+  void set_default_engine(const char* name)
+  {
+    rutz::default_rand_engine = rutz::rand_engine_from_name(name);
+  }
+
   rutz::fstring tcl_valuetype(const tcl::obj& obj)
   {
     return obj.tcltype_name();
@@ -91,6 +101,7 @@ namespace
 
   double rand_draw(double min, double max)
   {
+    generator.follow_default_engine();
     return generator.fdraw_range(min, max);
   }
 
@@ -124,7 +135,7 @@ GVX_TRACE("Misc_Init");
       pkg->def( "::rand", "min max", &rand_draw, SRC_POS);
       pkg->def( "::rand", "min max ?n=1?", &rand_draw_n, SRC_POS);
       pkg->def( "::srand", "seed",
-                [](unsigned long s){generator.seed(s);}, SRC_POS );
+                [](unsigned long s){generator = rutz::rng(s);}, SRC_POS );
 
       // use the standard library sleep() to sleep a specified # of
       // seconds
@@ -157,6 +168,8 @@ GVX_TRACE("Misc_Init");
 
       pkg->def( "::default_rand_seed", "", &get_default_seed, SRC_POS );
       pkg->def( "::default_rand_seed", "seed", &set_default_seed, SRC_POS );
+      pkg->def( "::default_rand_engine", "", &get_default_engine, SRC_POS );
+      pkg->def( "::default_rand_engine", "engine", &set_default_engine, SRC_POS );
 
       pkg->def( "::tcl_valuetype", "value", &tcl_valuetype, SRC_POS );
 
@@ -32,10 +32,13 @@
 #include "tcl/vecdispatch.h"
 
 #include "tcl/command.h"
+#include "tcl/interp.h"
 #include "tcl/list.h"
+#include "tcl/obj.h"
 
 #include "rutz/error.h"
 
+#include <tcl.h>
 #include <vector>
 
 #include "rutz/trace.h"
@@ -180,7 +183,133 @@ GVX_TRACE("tcl::vec_dispatcher::dispatch");
 }
 
 
+///////////////////////////////////////////////////////////////////////
+//
+// tcl::batch_context member definitions
+//
+///////////////////////////////////////////////////////////////////////
+
+tcl::batch_context::batch_context(tcl::interpreter& interp,
+                                  unsigned int ncalls,
+                                  unsigned int objc,
+                                  Tcl_Obj* const objv[]) :
+  m_interp(interp),
+  m_ncalls(ncalls),
+  m_objc(objc),
+  m_objv(objv)
+{}
+
+tcl::batch_context::~batch_context() noexcept {}
+
+Tcl_Obj* const* tcl::batch_context::elements(unsigned int argn,
+                                              unsigned int& count) const
+{
+GVX_TRACE("tcl::batch_context::elements");
+
+  if (argn >= m_objc)
+    throw rutz::error("argument number out of range", SRC_POS);
+
+  int n = 0;
+  Tcl_Obj** elems = nullptr;
+  if (Tcl_ListObjGetElements(0, m_objv[argn], &n, &elems) != TCL_OK)
+    throw rutz::error("couldn't split Tcl list", SRC_POS);
+
+  if (n <= 0)
+    throw rutz::error("argument was empty", SRC_POS);
+
+  count = static_cast<unsigned int>(n);
+  return elems;
+}
+
+void tcl::batch_context::set_result(const tcl::obj& result)
+{
+GVX_TRACE("tcl::batch_context::set_result");
+
+  m_interp.set_result(result);
+}
+
+void tcl::batch_context::set_results(const std::vector<tcl::obj>& results)
+{
+GVX_TRACE("tcl::batch_context::set_results");
+
+  std::vector<Tcl_Obj*> objs(results.size());
+  for (size_t i = 0; i < results.size(); ++i)
+    objs[i] = results[i].get();
+
+  m_interp.set_result(tcl::obj(Tcl_NewListObj(int(objs.size()),
+                                              objs.empty() ? nullptr
+                                              : &objs[0])));
+}
+
+namespace tcl
+{
+  class batch_vec_dispatcher;
+}
+
+///////////////////////////////////////////////////////////////////////
+/**
+ *
+ * \c tcl::batch_vec_dispatcher is like \c tcl::vec_dispatcher, except
+ * that a vector of calls is handed to a batched callable all at once,
+ * through a \c tcl::batch_context.
+ *
+ **/
+///////////////////////////////////////////////////////////////////////
+
+class tcl::batch_vec_dispatcher : public tcl::arg_dispatcher
+{
+public:
+  batch_vec_dispatcher(unsigned int key_argn,
+                       std::function<void(tcl::batch_context&)> batch) :
+    m_key_argn(key_argn),
+    m_batch(std::move(batch))
+  {}
+
+  virtual ~batch_vec_dispatcher() noexcept {}
+
+  virtual void dispatch(tcl::interpreter& interp,
+                        unsigned int objc, Tcl_Obj* const objv[],
+                        const std::function<void(tcl::call_context&)>& callback) override;
+
+private:
+  unsigned int m_key_argn;
+  std::function<void(tcl::batch_context&)> m_batch;
+};
+
+void tcl::batch_vec_dispatcher::dispatch(tcl::interpreter& interp,
+                                         unsigned int objc,
+                                         Tcl_Obj* const objv[],
+                                         const std::function<void(tcl::call_context&)>& callback)
+{
+GVX_TRACE("tcl::batch_vec_dispatcher::dispatch");
+
+  const unsigned int ncalls
+    = tcl::list::get_obj_list_length(objv[m_key_argn]);
+
+  if (ncalls > 1)
+    {
+      tcl::batch_context bx(interp, ncalls, objc, objv);
+      m_batch(bx);
+    }
+  else if (ncalls == 1)
+    {
+      tcl::call_context cx(interp, objc, objv);
+      callback(cx);
+    }
+  else // (ncalls == 0)
+    {
+      ;// do nothing, so we gracefully handle empty lists
+    }
+}
+
 std::unique_ptr<tcl::arg_dispatcher> tcl::get_vec_dispatcher(unsigned int key_argn)
 {
   return std::make_unique<vec_dispatcher>(key_argn);
 }
+
+std::unique_ptr<tcl::arg_dispatcher>
+tcl::get_batch_vec_dispatcher(unsigned int key_argn,
+                              std::function<void(tcl::batch_context&)> batch)
+{
+  return std::make_unique<batch_vec_dispatcher>(key_argn, std::move(batch));
+}
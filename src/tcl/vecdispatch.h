@@ -32,13 +32,79 @@
 #ifndef GROOVX_TCL_VECDISPATCH_H_UTC20050628162421_DEFINED
 #define GROOVX_TCL_VECDISPATCH_H_UTC20050628162421_DEFINED
 
+#include <functional>
 #include <memory>
+#include <vector>
+
+typedef struct Tcl_Obj Tcl_Obj;
 
 namespace tcl
 {
   class arg_dispatcher;
+  class batch_context;
+  class interpreter;
+  class obj;
 
   std::unique_ptr<arg_dispatcher> get_vec_dispatcher(unsigned int key_argn);
+
+  /// Get a vectorized dispatcher that makes one batched call.
+  /** When the key argument holds more than one element, \a batch is
+      called once for the whole vector, instead of calling the
+      command's callback once per element. */
+  std::unique_ptr<arg_dispatcher>
+  get_batch_vec_dispatcher(unsigned int key_argn,
+                           std::function<void(tcl::batch_context&)> batch);
 }
 
+///////////////////////////////////////////////////////////////////////
+/**
+ *
+ * \c tcl::batch_context gives a batched callable direct access to the
+ * elements of each list argument of a vectorized command, so that it
+ * can convert each argument into a C++ array in one pass, and then
+ * loop over those arrays without going through a tcl::call_context
+ * for every element.
+ *
+ **/
+///////////////////////////////////////////////////////////////////////
+
+class tcl::batch_context
+{
+public:
+  batch_context(tcl::interpreter& interp, unsigned int ncalls,
+                unsigned int objc, Tcl_Obj* const objv[]);
+
+  ~batch_context() noexcept;
+
+  /// Get the Tcl interpreter of the current invocation.
+  tcl::interpreter& interp() const noexcept { return m_interp; }
+
+  /// Return the number of arguments in the current invocation.
+  unsigned int objc() const noexcept { return m_objc; }
+
+  /// Return the number of calls in the batch.
+  unsigned int ncalls() const noexcept { return m_ncalls; }
+
+  /// Get the elements of list argument \a argn.
+  /** The number of elements is returned in \a count. As with the
+      unbatched vectorized dispatch, a list shorter than ncalls()
+      stands for itself followed by repeats of its last element. */
+  Tcl_Obj* const* elements(unsigned int argn, unsigned int& count) const;
+
+  /// Set the command's result to \a result.
+  void set_result(const tcl::obj& result);
+
+  /// Set the command's result to the list of \a results.
+  void set_results(const std::vector<tcl::obj>& results);
+
+private:
+  batch_context(const batch_context&);
+  batch_context& operator=(const batch_context&);
+
+  tcl::interpreter& m_interp;
+  unsigned int const m_ncalls;
+  unsigned int const m_objc;
+  Tcl_Obj* const* const m_objv;
+};
+
 #endif // !GROOVX_TCL_VECDISPATCH_H_UTC20050628162421_DEFINED
@@ -34,3 +34,7 @@
 Element::~Element() noexcept {}
 
 void Element::vxEndTrialHook() { /* no-op */ }
+
+void Element::vxPreload(const nub::soft_ref<Toglet>&) { /* no-op */ }
+
+void Element::vxPreloadNext(const nub::soft_ref<Toglet>&) { /* no-op */ }
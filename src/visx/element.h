@@ -91,6 +91,17 @@ public:
       such as timekeeping, autosaving, etc. Default version is a no-op. */
   virtual void vxEndTrialHook();
 
+  /// Pre-render whatever this element will draw when it next runs.
+  /** This is meant to be called ahead of time (e.g. during the
+      inter-trial interval), so that drawing at event time costs no
+      more than copying pixels and swapping buffers. Default version
+      is a no-op. */
+  virtual void vxPreload(const nub::soft_ref<Toglet>& widget);
+
+  /// Called by a child to preload whichever element will run after it.
+  /** Default version is a no-op. */
+  virtual void vxPreloadNext(const nub::soft_ref<Toglet>& widget);
+
   /// Called when an element's child finishes running.
   virtual void vxReturn(ChildStatus s) = 0;
 
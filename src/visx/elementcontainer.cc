@@ -40,11 +40,14 @@
 #include "nub/ref.h"
 
 #include "rutz/error.h"
+#include "rutz/fstring.h"
 #include "rutz/iter.h"
 #include "rutz/rand.h"
 #include "rutz/sfmt.h"
 
 #include <algorithm>
+#include <deque>
+#include <utility>
 #include <vector>
 
 #include "rutz/debug.h"
@@ -52,17 +55,153 @@ GVX_DBG_REGISTER
 #include "rutz/trace.h"
 
 using nub::ref;
+using nub::soft_ref;
+
+namespace
+{
+  const io::version_id ELEMENTCONTAINER_SVID = 2;
+}
 
 class ElementContainer::Impl
 {
 public:
-  Impl() : elements(), randSeed(0), sequencePos(0) {}
-
-  std::vector<ref<Element> > elements;
+  Impl() :
+    done(), todo(), randSeed(0), numChanges(0), rng(0), numDraws(0),
+    lastEdit(noEdit())
+  {}
+
+  // The element sequence is done followed by todo. Keeping the
+  // remaining elements in a deque means that both moving on to the
+  // next element and sending the current one to the back of the
+  // sequence take constant time.
+  std::vector<ref<Element> > done; // Completed elements, in order
+  std::deque<ref<Element> > todo;  // The current element, then the rest
 
   unsigned long randSeed;       // Random seed used to create element sequence
-  unsigned int sequencePos;     // Index of the current element
-                                // Also functions as # of completed elements
+  unsigned int numChanges;      // Bumped when the sequence is rearranged
+  rutz::rng rng;                // Seeded from randSeed; used for shuffles
+                                // and for reinserting repeated elements
+  unsigned long numDraws;       // Draws from rng since it was seeded
+  SequenceEdit lastEdit;        // The edit behind the last numChanges bump
+
+  static SequenceEdit noEdit()
+  {
+    SequenceEdit e = { SequenceEdit::NONE, 0, 0 };
+    return e;
+  }
+
+  // Note a change to the sequence other than a single edit.
+  void changed()
+  {
+    ++numChanges;
+    lastEdit = noEdit();
+  }
+
+  void apply(const SequenceEdit& e)
+  {
+    switch (e.kind)
+      {
+      case SequenceEdit::RETRY:
+        {
+          GVX_ASSERT(e.from < size());
+          const size_t saved = sequencePos();
+          seek(e.from);
+          todo.push_back(todo.front());
+          todo.pop_front();
+          seek(saved);
+        }
+        break;
+
+      case SequenceEdit::REPEAT:
+        {
+          GVX_ASSERT(e.from < size() && e.to <= size());
+          const ref<Element> copy = at(e.from);
+          todo.push_back(copy);
+          if (e.to != size() - 1)
+            std::swap(at(size() - 1), at(e.to));
+        }
+        break;
+
+      default:
+        GVX_ASSERT(false);
+      }
+
+    ++numChanges;
+    lastEdit = e;
+  }
+
+  // Draw a uniformly random position in [lo, hi).
+  size_t drawPos(size_t lo, size_t hi)
+  {
+    GVX_ASSERT(lo < hi);
+    ++numDraws;
+    return lo + size_t(rng.idraw(int(hi - lo)));
+  }
+
+  /// Iterates over done, then todo.
+  class const_iterator
+  {
+  public:
+    const_iterator(const Impl* impl, size_t i) : itsImpl(impl), itsPos(i) {}
+
+    const ref<Element>& operator*() const { return itsImpl->at(itsPos); }
+    const_iterator& operator++() { ++itsPos; return *this; }
+
+    bool operator==(const const_iterator& x) const { return itsPos == x.itsPos; }
+    bool operator!=(const const_iterator& x) const { return itsPos != x.itsPos; }
+
+  private:
+    const Impl* itsImpl;
+    size_t itsPos;
+  };
+
+  size_t size() const { return done.size() + todo.size(); }
+
+  unsigned int sequencePos() const { return unsigned(done.size()); }
+
+  ref<Element>& at(size_t i)
+  { return i < done.size() ? done[i] : todo.at(i - done.size()); }
+
+  const ref<Element>& at(size_t i) const
+  { return i < done.size() ? done[i] : todo.at(i - done.size()); }
+
+  const_iterator begin() const { return const_iterator(this, 0); }
+  const_iterator end() const { return const_iterator(this, size()); }
+
+  // Move the boundary between done and todo to pos.
+  void seek(size_t pos)
+  {
+    GVX_ASSERT(pos <= size());
+    while (done.size() > pos)
+      {
+        todo.push_front(done.back());
+        done.pop_back();
+      }
+    while (done.size() < pos)
+      {
+        done.push_back(todo.front());
+        todo.pop_front();
+      }
+  }
+
+  void seed(unsigned long s, rutz::rand_engine e)
+  {
+    randSeed = s;
+    rng.seed(s, e);
+    numDraws = 0;
+  }
+
+  // Swap the element at position i with one at a uniformly random
+  // position in [lo, hi). This is a single step of a Fisher-Yates
+  // shuffle, so if the elements in [lo, hi) were in a random order
+  // beforehand, they still are afterwards.
+  void swapWithRandom(size_t i, size_t lo, size_t hi)
+  {
+    GVX_ASSERT(hi <= size());
+    const size_t j = drawPos(lo, hi);
+    if (i != j)
+      std::swap(at(i), at(j));
+  }
 };
 
 ///////////////////////////////////////////////////////////////////////
@@ -83,31 +222,65 @@ GVX_TRACE("ElementContainer::~ElementContainer");
   delete rep;
 }
 
+io::version_id ElementContainer::class_version_id() const
+{
+GVX_TRACE("ElementContainer::class_version_id");
+  return ELEMENTCONTAINER_SVID;
+}
+
 void ElementContainer::read_from(io::reader& reader)
 {
 GVX_TRACE("ElementContainer::read_from");
   clearElements();
 
+  const io::version_id svid = reader.input_version_id();
+
   io::read_utils::read_object_seq<Element>
-    (reader, "trialSeq", std::back_inserter(rep->elements));
+    (reader, "trialSeq", std::back_inserter(rep->todo));
+
+  unsigned long seed = 0;
+  reader.read_value("randSeed", seed);
+
+  // Files from before randEngine was saved used the legacy engine.
+  rutz::rand_engine engine = rutz::rand_engine::LEGACY;
+  if (svid >= 1)
+    {
+      rutz::fstring name;
+      reader.read_value("randEngine", name);
+      engine = rutz::rand_engine_from_name(name.c_str());
+    }
+  rep->seed(seed, engine);
 
-  reader.read_value("randSeed", rep->randSeed);
-  reader.read_value("curTrialSeqdx", rep->sequencePos);
-  if (rep->sequencePos > rep->elements.size())
+  // Pick up the generator where it left off, so that a resumed
+  // session doesn't replay the draws it has already made.
+  if (svid >= 2)
+    {
+      unsigned long draws = 0;
+      reader.read_value("randDraws", draws);
+      rep->rng.discard_fdraws(draws);
+      rep->numDraws = draws;
+    }
+
+  unsigned int pos = 0;
+  reader.read_value("curTrialSeqdx", pos);
+  if (pos > rep->size())
     {
       throw rutz::error("ElementContainer", SRC_POS);
     }
+  rep->seek(pos);
 }
 
 void ElementContainer::write_to(io::writer& writer) const
 {
 GVX_TRACE("ElementContainer::write_to");
   io::write_utils::write_object_seq(writer, "trialSeq",
-                                    rep->elements.begin(),
-                                    rep->elements.end());
+                                    rep->begin(), rep->end());
 
   writer.write_value("randSeed", rep->randSeed);
-  writer.write_value("curTrialSeqdx", int(rep->sequencePos));
+  writer.write_value("randEngine",
+                     rutz::fstring(rutz::rand_engine_name(rep->rng.engine())));
+  writer.write_value("randDraws", rep->numDraws);
+  writer.write_value("curTrialSeqdx", int(rep->sequencePos()));
 }
 
 ///////////////////////////////////////////////////////////////////////
@@ -129,13 +302,12 @@ GVX_TRACE("ElementContainer::trialType");
 int ElementContainer::lastResponse() const
 {
 GVX_TRACE("ElementContainer::lastResponse");
-  dbg_eval(9, rep->sequencePos);
-  dbg_eval_nl(9, rep->elements.size());
+  dbg_eval(9, rep->sequencePos());
+  dbg_eval_nl(9, rep->size());
 
-  if (rep->sequencePos == 0 ||
-      rep->elements.size() == 0) return -1;
+  if (rep->done.empty()) return -1;
 
-  ref<Element> prev_element = rep->elements.at(rep->sequencePos-1);
+  ref<Element> prev_element = rep->done.back();
 
   return prev_element->lastResponse();
 }
@@ -169,36 +341,41 @@ GVX_TRACE("ExptDriver::vxReturn");
     {
     case Element::ChildStatus::OK:
       // Move on to the next element.
-      ++rep->sequencePos;
+      rep->seek(rep->sequencePos() + 1);
       break;
 
     case Element::ChildStatus::REPEAT:
       {
-        // Add a repeat of the current element to the sequence and reshuffle
-        addElement(currentElement(), 1);
-        std::random_shuffle
-          (rep->elements.begin()+rep->sequencePos+1, rep->elements.end());
+        // Add a repeat of the current element to the back of the
+        // sequence, then swap it to a random position among the
+        // remaining elements (constant time, rather than reshuffling
+        // the whole remainder).
+        const unsigned int pos = rep->sequencePos();
+        const SequenceEdit e = { SequenceEdit::REPEAT, pos,
+                                 unsigned(rep->drawPos(pos + 1,
+                                                       rep->size() + 1)) };
+        rep->apply(e);
 
         // Move on to the next element.
-        ++rep->sequencePos;
+        rep->seek(rep->sequencePos() + 1);
       }
       break;
 
     case Element::ChildStatus::ABORTED:
       {
-        // Remember the element that we are about to abort so we can
-        // store it at the end of the sequence.
-        ref<Element> aborted_element = currentElement();
-
-        // Erase the aborted element from the sequence. Subsequent elements
-        // will slide up to fill in the gap.
-        rep->elements.erase(rep->elements.begin()+rep->sequencePos);
-
-        // Add the aborted element to the back of the sequence.
-        rep->elements.push_back(aborted_element);
-
-        // Don't need to increment sequencePos here since the new trial
-        // has "slid into place" by the reshuffling we've just done.
+        // Move the aborted element to the back of the sequence, to be
+        // retried once the rest have run; the order of the rest is
+        // unchanged.
+        if (rep->todo.size() > 1)
+          {
+            const SequenceEdit e = { SequenceEdit::RETRY,
+                                     rep->sequencePos(),
+                                     unsigned(rep->size() - 1) };
+            rep->apply(e);
+          }
+
+        // Don't need to increment sequencePos here since the next
+        // element has slid into place.
       }
       break;
 
@@ -227,18 +404,18 @@ GVX_TRACE("ExptDriver::vxReturn");
 void ElementContainer::vxUndo()
 {
 GVX_TRACE("ElementContainer::vxUndo");
-  dbg_eval(3, rep->sequencePos);
+  dbg_eval(3, rep->sequencePos());
 
   // FIXME how to know whether we should back up our own sequence, or
   // whether our child just backs up in its own sequence?
 
   // Check to make sure we've completed at least one element
-  if (rep->sequencePos < 1) return;
+  if (rep->sequencePos() < 1) return;
 
   // Move the counter back to the previous element...
-  --rep->sequencePos;
+  rep->seek(rep->sequencePos() - 1);
 
-  GVX_ASSERT(rep->sequencePos < rep->elements.size());
+  GVX_ASSERT(rep->sequencePos() < rep->size());
 
   // ...and undo that element
   currentElement()->vxUndo();
@@ -251,13 +428,27 @@ GVX_TRACE("ElementContainer::vxReset");
 
   nub::log("ElementContainer::vxReset");
 
-  for (unsigned int i = 0; i < rep->elements.size(); ++i)
+  for (unsigned int i = 0; i < rep->size(); ++i)
     {
       nub::log(rutz::sfmt("resetting element %u", i));
-      rep->elements[i]->vxReset();
+      rep->at(i)->vxReset();
     }
 
-  rep->sequencePos = 0;
+  rep->seek(0);
+}
+
+void ElementContainer::vxPreload(const soft_ref<Toglet>& widget)
+{
+GVX_TRACE("ElementContainer::vxPreload");
+  if ( !isComplete() )
+    currentElement()->vxPreload(widget);
+}
+
+void ElementContainer::vxPreloadNext(const soft_ref<Toglet>& widget)
+{
+GVX_TRACE("ElementContainer::vxPreloadNext");
+  if (rep->todo.size() > 1)
+    rep->todo[1]->vxPreload(widget);
 }
 
 
@@ -273,14 +464,16 @@ GVX_TRACE("ElementContainer::addElement");
 
   for (unsigned int i = 0; i < repeat; ++i)
     {
-      rep->elements.push_back(element);
+      rep->todo.push_back(element);
     }
+
+  rep->changed();
 }
 
 void ElementContainer::setRandSeed(unsigned long s)
 {
 GVX_TRACE("ElementContainer::setRandSeed");
-  rep->randSeed = s;
+  rep->seed(s, rutz::default_rand_engine);
 }
 
 unsigned long ElementContainer::getRandSeed() const
@@ -289,17 +482,43 @@ GVX_TRACE("ElementContainer::getRandSeed");
   return rep->randSeed;
 }
 
+unsigned long ElementContainer::numRandDraws() const
+{
+GVX_TRACE("ElementContainer::numRandDraws");
+  return rep->numDraws;
+}
+
+void ElementContainer::setRandDraws(unsigned long n)
+{
+GVX_TRACE("ElementContainer::setRandDraws");
+
+  // Only restart the generator if we have to go backwards
+  if (n < rep->numDraws)
+    rep->seed(rep->randSeed, rep->rng.engine());
+
+  rep->rng.discard_fdraws(n - rep->numDraws);
+  rep->numDraws = n;
+}
+
+rutz::rand_engine ElementContainer::getRandEngine() const
+{
+GVX_TRACE("ElementContainer::getRandEngine");
+  return rep->rng.engine();
+}
+
 void ElementContainer::shuffle(unsigned long seed)
 {
 GVX_TRACE("ElementContainer::shuffle");
 
   setRandSeed(seed);
 
-  rutz::urand generator(rep->randSeed);
+  // Fisher-Yates, drawing from the container's generator in the same
+  // order as std::random_shuffle did, so that a given seed still
+  // gives the same sequence as before.
+  for (size_t i = 1; i < rep->size(); ++i)
+    rep->swapWithRandom(i, 0, i + 1);
 
-  std::random_shuffle(rep->elements.begin(),
-                      rep->elements.end(),
-                      generator);
+  rep->changed();
 }
 
 void ElementContainer::clearElements()
@@ -307,29 +526,30 @@ void ElementContainer::clearElements()
 GVX_TRACE("ElementContainer::clearElements");
   vxHalt();
 
-  rep->elements.clear();
-  rep->sequencePos = 0;
+  rep->done.clear();
+  rep->todo.clear();
+  rep->changed();
 }
 
 nub::soft_ref<Element> ElementContainer::currentElement() const
 {
 GVX_TRACE("ElementContainer::currentElement");
-  if (rep->sequencePos >= rep->elements.size())
+  if (rep->todo.empty())
     return nub::soft_ref<Element>();
 
-  return rep->elements.at(rep->sequencePos);
+  return rep->todo.front();
 }
 
 size_t ElementContainer::numElements() const
 {
 GVX_TRACE("ElementContainer::numElements");
-  return rep->elements.size();
+  return rep->size();
 }
 
 unsigned int ElementContainer::numCompleted() const
 {
 GVX_TRACE("ElementContainer::numCompleted");
-  return rep->sequencePos;
+  return rep->sequencePos();
 }
 
 rutz::fwd_iter<const nub::ref<Element> >
@@ -338,15 +558,62 @@ ElementContainer::getElements() const
 GVX_TRACE("ElementContainer::getElements");
 
   return rutz::fwd_iter<const nub::ref<Element> >
-    (rep->elements.begin(), rep->elements.end());
+    (rep->begin(), rep->end());
 }
 
 bool ElementContainer::isComplete() const
 {
 GVX_TRACE("ElementContainer::isComplete");
 
-  dbg_eval(9, rep->sequencePos);
-  dbg_eval_nl(9, rep->elements.size());
+  dbg_eval(9, rep->sequencePos());
+  dbg_eval_nl(9, rep->size());
+
+  return rep->todo.empty();
+}
+
+unsigned int ElementContainer::numSequenceChanges() const
+{
+GVX_TRACE("ElementContainer::numSequenceChanges");
+  return rep->numChanges;
+}
+
+ElementContainer::SequenceEdit ElementContainer::lastSequenceEdit() const
+{
+GVX_TRACE("ElementContainer::lastSequenceEdit");
+  return rep->lastEdit;
+}
+
+void ElementContainer::applySequenceEdit(const SequenceEdit& e)
+{
+GVX_TRACE("ElementContainer::applySequenceEdit");
+
+  const bool ok =
+    (e.kind == SequenceEdit::RETRY && e.from < rep->size()) ||
+    (e.kind == SequenceEdit::REPEAT && e.from < rep->size()
+     && e.to <= rep->size());
+
+  if (!ok)
+    {
+      throw rutz::error(rutz::sfmt("invalid sequence edit (%u, %u) "
+                                   "(%zu elements)",
+                                   e.from, e.to, rep->size()), SRC_POS);
+    }
+
+  rep->apply(e);
+}
+
+void ElementContainer::setSequencePos(unsigned int pos)
+{
+GVX_TRACE("ElementContainer::setSequencePos");
+
+  if (pos > rep->size())
+    {
+      throw rutz::error(rutz::sfmt("invalid sequence position %u "
+                                   "(only %zu elements)",
+                                   pos, rep->size()), SRC_POS);
+    }
+
+  vxHalt();
 
-  return (rep->sequencePos >= rep->elements.size());
+  rep->seek(pos);
 }
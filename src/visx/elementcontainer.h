@@ -40,6 +40,7 @@
 namespace rutz
 {
   template <class T> class fwd_iter;
+  enum class rand_engine;
 }
 
 namespace nub
@@ -59,6 +60,8 @@ public:
   /// Virtual destructor.
   virtual ~ElementContainer() noexcept;
 
+  virtual io::version_id class_version_id() const override;
+
   virtual void read_from(io::reader& reader) override;
 
   virtual void write_to(io::writer& writer) const override;
@@ -81,6 +84,13 @@ public:
   virtual void vxHalt() const override;
 
   /// Delegates partially on to vxAllChildrenFinished().
+  /** On REPEAT, a repeat of the current element is inserted at a
+      random position among the remaining elements, using the
+      container's own random generator (see setRandSeed()). On
+      ABORTED, the current element moves to the end of the sequence,
+      to be retried after the rest, whose order is unchanged. Both
+      take constant (amortized) time regardless of the length of the
+      sequence. */
   virtual void vxReturn(ChildStatus s) override;
 
   /// Undo the previous element.
@@ -95,6 +105,15 @@ public:
   /// Reset all of the contained child elements.
   virtual void vxReset() override;
 
+  /// Preload the current element.
+  virtual void vxPreload(const nub::soft_ref<Toglet>& widget) override;
+
+  /// Preload the element after the current one, if there is one.
+  /** Since a REPEAT status may place a repeat of the current element
+      next, the preloaded element may not be the one that actually
+      runs next; in that case the preload is just wasted. */
+  virtual void vxPreloadNext(const nub::soft_ref<Toglet>& widget) override;
+
   //
   // Container interface
   //
@@ -103,11 +122,29 @@ public:
   void addElement(nub::ref<Element> element, unsigned int repeat = 1);
 
   /// Set the random seed for shuffling child elements.
+  /** This also reseeds the generator used to place repeated
+      elements, so that a whole session can be reproduced. The
+      generator is bound to the current rutz::default_rand_engine,
+      which is saved along with the seed, as is the number of draws
+      made since seeding; so a session that is saved and reloaded
+      carries on with the same random stream. */
   void setRandSeed(unsigned long s);
 
   /// Get the current random seed used for shuffling child elements.
   unsigned long getRandSeed() const;
 
+  /// Get the number of draws made from the random generator since it was seeded.
+  unsigned long numRandDraws() const;
+
+  /// Put the random generator at the position it had after \a n draws.
+  /** This is used to restore a previously recorded state, e.g. when
+      replaying an autosave journal, since replaying an edit with
+      applySequenceEdit() doesn't itself draw from the generator. */
+  void setRandDraws(unsigned long n);
+
+  /// Get the random engine that was bound by the last setRandSeed().
+  rutz::rand_engine getRandEngine() const;
+
   /// Randomly permute the sequence of elements.
   /** @param seed used as the random seed for the shuffle. */
   void shuffle(unsigned long seed=0);
@@ -132,6 +169,44 @@ public:
   /// Returns true if the all child elements are complete, false otherwise.
   bool isComplete() const;
 
+  /// Returns a count of the changes made so far to the element sequence.
+  /** This is bumped whenever elements are added, removed or reordered
+      (but not when the current position simply advances), so it can
+      be used to cheaply detect that the sequence needs to be saved
+      again. */
+  unsigned int numSequenceChanges() const;
+
+  /// A single rearrangement of the element sequence.
+  /** A RETRY edit moves the element at position \a from to the end of
+      the sequence (as for an ABORTED element); a REPEAT edit appends
+      a copy of the element at position \a from, then swaps it with
+      the element at position \a to (as for a REPEAT element). */
+  struct SequenceEdit
+  {
+    enum Kind { NONE, RETRY, REPEAT };
+
+    Kind kind;
+    unsigned int from;
+    unsigned int to;
+  };
+
+  /// Returns the edit that made the most recent sequence change.
+  /** The kind is NONE if the most recent change wasn't a single edit
+      (e.g. a shuffle, or elements being added). Together with
+      numSequenceChanges(), this lets a journal record just the edit
+      rather than the whole sequence. */
+  SequenceEdit lastSequenceEdit() const;
+
+  /// Apply a single edit, as returned by lastSequenceEdit().
+  /** The current position stays the same. Throws if the positions are
+      out of range. */
+  void applySequenceEdit(const SequenceEdit& edit);
+
+  /// Jump directly to position \a pos in the element sequence.
+  /** This is used to restore a previously recorded sequencing state,
+      e.g. when replaying an autosave journal. */
+  void setSequencePos(unsigned int pos);
+
 protected:
   /// Hook function to be called when all children have been run.
   virtual void vxAllChildrenFinished() = 0;
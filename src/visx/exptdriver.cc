@@ -52,10 +52,12 @@
 #include "rutz/timeformat.h"
 #include "rutz/unixcall.h"
 
+#include "visx/exptjournal.h"
 #include "visx/tlistutils.h"
 
 #include <cstdlib> // for getenv()
 #include <cstring> // for strncmp()
+#include <memory>
 #include <string>
 #include <sys/stat.h> // for mode_t constants S_IRUSR etc.
 #include <unistd.h> // for sleep()
@@ -77,7 +79,7 @@ rutz::tracer ExptDriver::tracer;
 
 namespace
 {
-  const io::version_id EXPTDRIVER_SVID = 6;
+  const io::version_id EXPTDRIVER_SVID = 7;
 }
 
 ///////////////////////////////////////////////////////////////////////
@@ -104,6 +106,8 @@ public:
     filePrefix("expt"),
     infoLog(),
     autosavePeriod(10),
+    autosaveJournal(false),
+    journal(),
     doWhenComplete(new tcl::ProcWrapper(interp)),
     numTrialsCompleted(0),
     createTime(rutz::time::wall_clock_now()),
@@ -140,6 +144,9 @@ public:
 
   unsigned int autosavePeriod;
 
+  bool autosaveJournal; // Whether to autosave with an append-only journal
+  std::unique_ptr<ExptJournal> journal; // Current journal, if any
+
   nub::ref<tcl::ProcWrapper> doWhenComplete;
 
   unsigned int numTrialsCompleted;
@@ -178,9 +185,12 @@ void ExptDriver::read_from(io::reader& reader)
 {
 GVX_TRACE("ExptDriver::read_from");
 
-  reader.ensure_version_id("ExptDriver", 6,
-                           "Try cvs tag xml_conversion_20040526",
-                           SRC_POS);
+  const io::version_id svid =
+    reader.ensure_version_id("ExptDriver", 6,
+                             "Try cvs tag xml_conversion_20040526",
+                             SRC_POS);
+
+  rep->journal.reset();
 
   reader.read_value("hostname", rep->hostname);
   reader.read_value("subject", rep->subject);
@@ -188,6 +198,10 @@ GVX_TRACE("ExptDriver::read_from");
   reader.read_value("endDate", rep->endDate);
   reader.read_value("autosaveFile", rep->autosaveFile);
   reader.read_value("autosavePeriod", rep->autosavePeriod);
+  if (svid >= 7)
+    reader.read_value("autosaveJournal", rep->autosaveJournal);
+  else
+    rep->autosaveJournal = false;
   {
     rutz::fstring tmp;
     reader.read_value("infoLog", tmp);
@@ -213,6 +227,7 @@ GVX_TRACE("ExptDriver::write_to");
   writer.write_value("endDate", rep->endDate);
   writer.write_value("autosaveFile", rep->autosaveFile);
   writer.write_value("autosavePeriod", rep->autosavePeriod);
+  writer.write_value("autosaveJournal", rep->autosaveJournal);
   writer.write_value("infoLog", rutz::fstring(rep->infoLog.c_str()));
   writer.write_owned_object("doWhenComplete", rep->doWhenComplete);
   writer.write_value("filePrefix", rep->filePrefix);
@@ -250,14 +265,43 @@ GVX_TRACE("ExptDriver::vxEndTrialHook");
   // requested only if the autosave period is positive, and the number of
   // completed trials is evenly divisible by the autosave period.
   if ( rep->autosavePeriod <= 0 ||
-       (rep->numTrialsCompleted % rep->autosavePeriod) != 0 ||
        rep->autosaveFile.is_empty() )
     return;
 
+  // In journal mode, every trial is autosaved: the first one by
+  // writing a full base snapshot, and subsequent ones by appending a
+  // short record to the journal, which costs the same no matter how
+  // big the experiment is.
+  if (rep->autosaveJournal)
+    {
+      if (rep->journal.get() == nullptr)
+        rep->journal.reset
+          (new ExptJournal(*this, rep->autosaveFile,
+                           ExptJournal::journalFileFor(rep->autosaveFile)));
+      else
+        rep->journal->appendTrial();
+
+      return;
+    }
+
+  if ( (rep->numTrialsCompleted % rep->autosavePeriod) != 0 )
+    return;
+
   dbg_eval_nl(3, rep->autosaveFile.c_str());
   io::save_gvx(nub::ref<io::serializable>(this), rep->autosaveFile);
 }
 
+void ExptDriver::vxReset()
+{
+GVX_TRACE("ExptDriver::vxReset");
+
+  // The journal can't describe a reset, so start over with a new base
+  // snapshot at the next autosave.
+  rep->journal.reset();
+
+  ElementContainer::vxReset();
+}
+
 void ExptDriver::vxAllChildrenFinished()
 {
 GVX_TRACE("ExptDriver::vxAllChildrenFinished");
@@ -293,6 +337,7 @@ void ExptDriver::setAutosaveFile(const fstring& str)
 {
 GVX_TRACE("ExptDriver::setAutosaveFile");
   rep->autosaveFile = str;
+  rep->journal.reset();
 }
 
 const fstring& ExptDriver::getFilePrefix() const
@@ -328,6 +373,25 @@ GVX_TRACE("ExptDriver::setAutosavePeriod");
   rep->autosavePeriod = period;
 }
 
+bool ExptDriver::getAutosaveJournal() const
+{
+GVX_TRACE("ExptDriver::getAutosaveJournal");
+  return rep->autosaveJournal;
+}
+
+void ExptDriver::setAutosaveJournal(bool on)
+{
+GVX_TRACE("ExptDriver::setAutosaveJournal");
+  rep->autosaveJournal = on;
+  rep->journal.reset();
+}
+
+unsigned int ExptDriver::numJournalRecords() const
+{
+GVX_TRACE("ExptDriver::numJournalRecords");
+  return rep->journal.get() ? rep->journal->numRecords() : 0;
+}
+
 const char* ExptDriver::getInfoLog() const
 {
 GVX_TRACE("ExptDriver::getInfoLog");
@@ -370,6 +434,7 @@ GVX_TRACE("ExptDriver::edBeginExpt");
   rep->hostname = getenv("HOSTNAME");
   rep->subject = cwd;
   rep->numTrialsCompleted = 0;
+  rep->journal.reset();
 
   nub::logging::reset(); // to clear any existing timer scopes
   nub::logging::add_obj_scope(*this);
@@ -103,6 +103,9 @@ public:
   /// End the current trial normally, and move on to the next trial.
   virtual void vxEndTrialHook() override;
 
+  /// Reset all child elements, and discard any autosave journal.
+  virtual void vxReset() override;
+
   /// Stop the experiment since all child elements are finished.
   virtual void vxAllChildrenFinished() override;
 
@@ -121,6 +124,21 @@ public:
   /// Change the autosave period to \a period.
   void setAutosavePeriod(unsigned int period);
 
+  /// Query whether autosaves are journaled (see setAutosaveJournal()).
+  bool getAutosaveJournal() const;
+
+  /// Turn journaled autosaves on or off.
+  /** When on, the autosave period only acts as an on/off switch
+      (zero means no autosaves); every completed trial is saved, by
+      appending a record to the file named by
+      ExptJournal::journalFileFor(getAutosaveFile()), after a full
+      base snapshot is written to the autosave file for the first
+      trial. Use ExptJournal::recover() to rebuild the experiment. */
+  void setAutosaveJournal(bool on);
+
+  /// Returns the number of records in the current autosave journal.
+  unsigned int numJournalRecords() const;
+
   /// Get the string used as a prefix for output files generated by the experiment.
   const rutz::fstring& getFilePrefix() const;
 
@@ -0,0 +1,534 @@
+/** @file visx/exptjournal.cc append-only journal of completed trials,
+    for cheap per-trial autosaves of an ExptDriver */
+
+///////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026-2026 Rob Peters
+// Rob Peters <https://github.com/rjpcal/>
+//
+// created: Mon Oct 19 14:21:37 2026
+//
+// --------------------------------------------------------------------
+//
+// This file is part of GroovX.
+//   [https://github.com/rjpcal/groovx]
+//
+// GroovX is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// GroovX is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GroovX; if not, write to the Free Software Foundation,
+// Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include "visx/exptjournal.h"
+
+#include "io/ioutil.h"
+#include "io/xmlreader.h"
+
+#include "nub/ref.h"
+
+#include "rutz/error.h"
+#include "rutz/fstring.h"
+#include "rutz/iter.h"
+#include "rutz/sfmt.h"
+
+#include "visx/exptdriver.h"
+#include "visx/response.h"
+#include "visx/trial.h"
+
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#define GVX_TRACE_EXPR ExptDriver::tracer.status()
+#include "rutz/trace.h"
+#include "rutz/debug.h"
+GVX_DBG_REGISTER
+
+using rutz::fstring;
+using nub::ref;
+
+namespace
+{
+  const char* const JOURNAL_HEADER = "GVX-JOURNAL 1 ;";
+
+  typedef std::vector<unsigned int> Path;
+
+  void writePath(std::ostream& os, const Path& path)
+  {
+    os << path.size();
+    for (unsigned int i: path)
+      os << ' ' << i;
+  }
+
+  // What the journal has recorded so far about one container
+  struct ContainerState
+  {
+    Path path;                  // path from the root to this container
+    std::map<const Element*, unsigned int> baseIndex;
+    unsigned int pos;           // last journaled sequence position
+    unsigned int numChanges;    // last journaled numSequenceChanges()
+  };
+}
+
+///////////////////////////////////////////////////////////////////////
+//
+// ExptJournal::Impl class definition
+//
+///////////////////////////////////////////////////////////////////////
+
+class ExptJournal::Impl
+{
+private:
+  Impl(const Impl&);
+  Impl& operator=(const Impl&);
+
+public:
+  Impl(const ExptDriver& e) :
+    expt(e), ofs(), nrecords(0), states(), lastChain()
+  {}
+
+  const ExptDriver& expt;
+  std::ofstream ofs;
+  unsigned int nrecords;
+
+  std::map<const ElementContainer*, ContainerState> states;
+
+  // The containers leading to the most recently journaled trial
+  std::vector<const ElementContainer*> lastChain;
+
+  // Look up the journal's state for container c, creating it if this
+  // is the first time we've seen c. Containers only change while they
+  // are on the path to the running trial, so the first time we see a
+  // container its sequence still matches the base snapshot.
+  ContainerState& stateOf(const ElementContainer& c, const Path& path)
+  {
+    std::map<const ElementContainer*, ContainerState>::iterator itr =
+      states.find(&c);
+
+    if (itr != states.end())
+      return itr->second;
+
+    ContainerState& s = states[&c];
+    s.path = path;
+    unsigned int i = 0;
+    for (rutz::fwd_iter<const ref<Element> > e(c.getElements());
+         e.is_valid(); e.next(), ++i)
+      {
+        // insert() keeps the first occurrence of repeated elements
+        s.baseIndex.insert(std::make_pair((*e).get(), i));
+      }
+    s.pos = c.numCompleted();
+    s.numChanges = c.numSequenceChanges();
+    return s;
+  }
+
+  // Fill chain with the containers leading from the root down to the
+  // current trial, and path with the corresponding base indices.
+  const Trial* currentTrial(std::vector<const ElementContainer*>& chain,
+                            Path& path)
+  {
+    const ElementContainer* c = &expt;
+
+    while (true)
+      {
+        chain.push_back(c);
+        const ContainerState& s = stateOf(*c, path);
+
+        nub::soft_ref<Element> e = c->currentElement();
+        if (e.is_invalid())
+          return nullptr;
+
+        std::map<const Element*, unsigned int>::const_iterator itr =
+          s.baseIndex.find(e.get());
+
+        if (itr == s.baseIndex.end())
+          throw rutz::error(rutz::sfmt("element %s is not part of the "
+                                       "autosave base snapshot",
+                                       e->unique_name().c_str()),
+                            SRC_POS);
+
+        path.push_back(itr->second);
+
+        c = dynamic_cast<const ElementContainer*>(e.get());
+
+        if (c == nullptr)
+          return dynamic_cast<const Trial*>(e.get());
+      }
+  }
+
+  // Write E, O and/or S records for container c if its sequencing
+  // state has changed since it was last journaled.
+  void journalContainer(const ElementContainer* c)
+  {
+    std::map<const ElementContainer*, ContainerState>::iterator itr =
+      states.find(c);
+
+    if (itr == states.end())
+      return;
+
+    ContainerState& s = itr->second;
+
+    const unsigned int nchanges = c->numSequenceChanges() - s.numChanges;
+    const ElementContainer::SequenceEdit edit = c->lastSequenceEdit();
+    const bool reordered = (nchanges != 0);
+
+    if (nchanges == 1 && edit.kind != ElementContainer::SequenceEdit::NONE)
+      {
+        // The usual case: a single repeat or retry, which can be
+        // recorded without listing the whole sequence
+        ofs << "E ";
+        writePath(ofs, s.path);
+        ofs << ' ' << (edit.kind == ElementContainer::SequenceEdit::RETRY
+                       ? 'A' : 'R')
+            << ' ' << edit.from << ' ' << edit.to << " ;\n";
+        ++nrecords;
+
+        s.numChanges = c->numSequenceChanges();
+      }
+    else if (reordered)
+      {
+        ofs << "O ";
+        writePath(ofs, s.path);
+        ofs << ' ' << c->numElements();
+        for (rutz::fwd_iter<const ref<Element> > e(c->getElements());
+             e.is_valid(); e.next())
+          {
+            std::map<const Element*, unsigned int>::const_iterator b =
+              s.baseIndex.find((*e).get());
+
+            if (b == s.baseIndex.end())
+              throw rutz::error(rutz::sfmt("element %s is not part of the "
+                                           "autosave base snapshot",
+                                           (*e)->unique_name().c_str()),
+                                SRC_POS);
+
+            ofs << ' ' << b->second;
+          }
+        ofs << " ;\n";
+        ++nrecords;
+
+        s.numChanges = c->numSequenceChanges();
+      }
+
+    if (reordered || c->numCompleted() != s.pos)
+      {
+        ofs << "S ";
+        writePath(ofs, s.path);
+        ofs << ' ' << c->numCompleted() << ' ' << c->numRandDraws()
+            << " ;\n";
+        ++nrecords;
+
+        s.pos = c->numCompleted();
+      }
+  }
+};
+
+///////////////////////////////////////////////////////////////////////
+//
+// ExptJournal member functions
+//
+///////////////////////////////////////////////////////////////////////
+
+ExptJournal::ExptJournal(const ExptDriver& expt,
+                         const fstring& base_file,
+                         const fstring& journal_file) :
+  rep(new Impl(expt))
+{
+GVX_TRACE("ExptJournal::ExptJournal");
+
+  try
+    {
+      // Note the current sequencing state, so that later records only
+      // need to describe what changed after the base snapshot
+      Path path;
+      rep->currentTrial(rep->lastChain, path);
+
+      io::save_gvx(nub::ref<io::serializable>
+                   (const_cast<ExptDriver*>(&expt)), base_file);
+
+      rep->ofs.open(journal_file.c_str(),
+                    std::ios::out | std::ios::trunc);
+
+      if (rep->ofs.fail())
+        throw rutz::error(rutz::sfmt("couldn't open journal file '%s' "
+                                     "for writing", journal_file.c_str()),
+                          SRC_POS);
+
+      rep->ofs << JOURNAL_HEADER << '\n';
+      rep->ofs.flush();
+    }
+  catch (...)
+    {
+      delete rep;
+      throw;
+    }
+}
+
+ExptJournal::~ExptJournal() noexcept
+{
+GVX_TRACE("ExptJournal::~ExptJournal");
+  delete rep;
+}
+
+void ExptJournal::appendTrial()
+{
+GVX_TRACE("ExptJournal::appendTrial");
+
+  std::vector<const ElementContainer*> chain;
+  Path path;
+  const Trial* trial = rep->currentTrial(chain, path);
+
+  // Only the containers on the path to the previous trial or to the
+  // current trial can have changed since the last record
+  for (const ElementContainer* c: rep->lastChain)
+    rep->journalContainer(c);
+
+  for (const ElementContainer* c: chain)
+    rep->journalContainer(c);
+
+  if (trial != nullptr)
+    {
+      const size_t total = trial->numResponses();
+      const size_t k = trial->numNewResponses();
+
+      rep->ofs << "R ";
+      writePath(rep->ofs, path);
+      rep->ofs << ' ' << total << ' ' << k;
+
+      size_t i = 0;
+      for (rutz::fwd_iter<Response> r(trial->responses());
+           r.is_valid(); r.next(), ++i)
+        {
+          if (i >= total - k)
+            rep->ofs << ' ' << r->val() << ' ' << r->msec();
+        }
+      rep->ofs << " ;\n";
+      ++rep->nrecords;
+    }
+
+  rep->ofs.flush();
+
+  if (rep->ofs.fail())
+    throw rutz::error("error while writing to autosave journal", SRC_POS);
+
+  rep->lastChain.swap(chain);
+}
+
+unsigned int ExptJournal::numRecords() const
+{
+  return rep->nrecords;
+}
+
+fstring ExptJournal::journalFileFor(const fstring& base_file)
+{
+  return rutz::sfmt("%s.journal", base_file.c_str());
+}
+
+namespace
+{
+  // The element sequences of containers as they were in the base
+  // snapshot, captured the first time each container is visited
+  typedef std::map<const ElementContainer*,
+                   std::vector<ref<Element> > > BaseSeqs;
+
+  const std::vector<ref<Element> >&
+  baseSeqOf(BaseSeqs& bases, const ElementContainer& c)
+  {
+    BaseSeqs::iterator itr = bases.find(&c);
+    if (itr != bases.end())
+      return itr->second;
+
+    std::vector<ref<Element> >& v = bases[&c];
+    for (rutz::fwd_iter<const ref<Element> > e(c.getElements());
+         e.is_valid(); e.next())
+      v.push_back(*e);
+    return v;
+  }
+
+  Element* resolvePath(std::istream& is, BaseSeqs& bases,
+                       ExptDriver& root, unsigned int lineno)
+  {
+    size_t depth = 0;
+    is >> depth;
+
+    Element* e = &root;
+
+    for (size_t i = 0; i < depth; ++i)
+      {
+        ElementContainer* c = dynamic_cast<ElementContainer*>(e);
+        if (c == nullptr)
+          throw rutz::error(rutz::sfmt("journal line %u: path goes "
+                                       "through a non-container", lineno),
+                            SRC_POS);
+
+        const std::vector<ref<Element> >& seq = baseSeqOf(bases, *c);
+
+        unsigned int idx = 0;
+        if (!(is >> idx) || idx >= seq.size())
+          throw rutz::error(rutz::sfmt("journal line %u: invalid path",
+                                       lineno), SRC_POS);
+
+        e = seq[idx].get();
+      }
+
+    return e;
+  }
+}
+
+nub::ref<ExptDriver> ExptJournal::recover(const char* base_file,
+                                          const char* journal_file,
+                                          unsigned int* nrecords)
+{
+GVX_TRACE("ExptJournal::recover");
+
+  nub::ref<ExptDriver> expt = dyn_cast<ExptDriver>(io::load_gvx(base_file));
+
+  std::ifstream ifs(journal_file);
+
+  if (ifs.fail())
+    throw rutz::error(rutz::sfmt("couldn't open journal file '%s' "
+                                 "for reading", journal_file), SRC_POS);
+
+  std::string line;
+  if (!std::getline(ifs, line) || line != JOURNAL_HEADER)
+    throw rutz::error(rutz::sfmt("'%s' is not an autosave journal",
+                                 journal_file), SRC_POS);
+
+  BaseSeqs bases;
+  unsigned int lineno = 1;
+  unsigned int n = 0;
+
+  while (std::getline(ifs, line))
+    {
+      ++lineno;
+
+      // A record without its terminator was cut short while being
+      // written; everything before it is intact, so stop here.
+      if (line.length() < 2 || line.compare(line.length()-2, 2, " ;") != 0)
+        break;
+
+      std::istringstream is(line);
+      char type = '\0';
+      is >> type;
+
+      Element* e = resolvePath(is, bases, *expt, lineno);
+
+      switch (type)
+        {
+        case 'R':
+          {
+            Trial* t = dynamic_cast<Trial*>(e);
+            size_t total = 0, k = 0;
+            if (t == nullptr || !(is >> total >> k) || k > total
+                || total - k > t->numResponses())
+              throw rutz::error(rutz::sfmt("journal line %u: invalid "
+                                           "response record", lineno),
+                                SRC_POS);
+
+            while (t->numResponses() > total - k)
+              t->vxUndo();
+
+            for (size_t i = 0; i < k; ++i)
+              {
+                int val = 0, msec = 0;
+                if (!(is >> val >> msec))
+                  throw rutz::error(rutz::sfmt("journal line %u: invalid "
+                                               "response record", lineno),
+                                    SRC_POS);
+                t->addResponse(Response(val, msec));
+              }
+          }
+          break;
+
+        case 'O':
+          {
+            ElementContainer* c = dynamic_cast<ElementContainer*>(e);
+            size_t count = 0;
+            if (c == nullptr || !(is >> count))
+              throw rutz::error(rutz::sfmt("journal line %u: invalid "
+                                           "order record", lineno),
+                                SRC_POS);
+
+            const std::vector<ref<Element> >& seq = baseSeqOf(bases, *c);
+
+            std::vector<ref<Element> > order;
+            for (size_t i = 0; i < count; ++i)
+              {
+                unsigned int idx = 0;
+                if (!(is >> idx) || idx >= seq.size())
+                  throw rutz::error(rutz::sfmt("journal line %u: invalid "
+                                               "order record", lineno),
+                                    SRC_POS);
+                order.push_back(seq[idx]);
+              }
+
+            c->clearElements();
+            for (const ref<Element>& elem: order)
+              c->addElement(elem);
+          }
+          break;
+
+        case 'E':
+          {
+            ElementContainer* c = dynamic_cast<ElementContainer*>(e);
+            char kind = '\0';
+            ElementContainer::SequenceEdit edit =
+              { ElementContainer::SequenceEdit::NONE, 0, 0 };
+            if (c == nullptr || !(is >> kind >> edit.from >> edit.to)
+                || (kind != 'A' && kind != 'R'))
+              throw rutz::error(rutz::sfmt("journal line %u: invalid "
+                                           "edit record", lineno),
+                                SRC_POS);
+
+            edit.kind = (kind == 'A'
+                         ? ElementContainer::SequenceEdit::RETRY
+                         : ElementContainer::SequenceEdit::REPEAT);
+            c->applySequenceEdit(edit);
+          }
+          break;
+
+        case 'S':
+          {
+            ElementContainer* c = dynamic_cast<ElementContainer*>(e);
+            unsigned int pos = 0;
+            if (c == nullptr || !(is >> pos))
+              throw rutz::error(rutz::sfmt("journal line %u: invalid "
+                                           "position record", lineno),
+                                SRC_POS);
+
+            c->setSequencePos(pos);
+
+            // Replayed edits don't draw from the container's random
+            // generator, so put it back where the original run had it
+            unsigned long draws = 0;
+            if (is >> draws)
+              c->setRandDraws(draws);
+          }
+          break;
+
+        default:
+          throw rutz::error(rutz::sfmt("journal line %u: unknown record "
+                                       "type '%c'", lineno, type),
+                            SRC_POS);
+        }
+
+      ++n;
+    }
+
+  if (nrecords != nullptr)
+    *nrecords = n;
+
+  return expt;
+}
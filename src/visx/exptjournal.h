@@ -0,0 +1,125 @@
+/** @file visx/exptjournal.h append-only journal of completed trials,
+    for cheap per-trial autosaves of an ExptDriver */
+
+///////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026-2026 Rob Peters
+// Rob Peters <https://github.com/rjpcal/>
+//
+// created: Mon Oct 19 14:21:37 2026
+//
+// --------------------------------------------------------------------
+//
+// This file is part of GroovX.
+//   [https://github.com/rjpcal/groovx]
+//
+// GroovX is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// GroovX is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GroovX; if not, write to the Free Software Foundation,
+// Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef GROOVX_VISX_EXPTJOURNAL_H_UTC20261019142137_DEFINED
+#define GROOVX_VISX_EXPTJOURNAL_H_UTC20261019142137_DEFINED
+
+namespace rutz
+{
+  class fstring;
+}
+
+namespace nub
+{
+  template <class T> class ref;
+}
+
+class ExptDriver;
+
+///////////////////////////////////////////////////////////////////////
+/**
+ *
+ * ExptJournal implements journaled autosaves for an ExptDriver. When
+ * the journal is created, a full base snapshot of the experiment is
+ * written with io::save_gvx(); after that, each completed trial
+ * appends just one short text record to the journal file, so the
+ * cost of an autosave no longer grows with the size of the
+ * experiment. recover() rebuilds the experiment by loading the base
+ * snapshot and replaying the journal on top of it.
+ *
+ * Each record is one line terminated by " ;", so that a record that
+ * was only partially written (e.g. due to a crash) is ignored on
+ * recovery. Elements are identified by a path of indices from the
+ * ExptDriver down through nested ElementContainers, where each index
+ * refers to the container's element sequence as it was in the base
+ * snapshot. The record types are:
+ *
+ * <pre>
+ *   R path total k val1 msec1 ... valk mseck ;   responses of a trial
+ *   E path A|R from to ;                         a single sequence edit
+ *   O path n idx1 ... idxn ;                     new element order
+ *   S path pos draws ;                           new sequence position
+ * </pre>
+ *
+ * where a path is written as a depth followed by that many indices.
+ * For an R record, the trial's response list is truncated to
+ * total-k entries, then the k listed responses are appended. An E
+ * record replays one ElementContainer::SequenceEdit, either a retry
+ * of an aborted element (A) or a repeat (R); this covers the usual
+ * reorderings at constant cost. O records list the whole sequence,
+ * and so are only written when a container was rearranged some
+ * other way, or more than once between two records. An S record
+ * also gives the number of draws that the container has made from
+ * its random generator, since replaying E and O records doesn't
+ * advance it.
+ *
+ **/
+///////////////////////////////////////////////////////////////////////
+
+class ExptJournal
+{
+public:
+  /// Write a base snapshot of \a expt and start a new journal.
+  /** Any existing \a journal_file is truncated. The base snapshot
+      reflects the state of \a expt at the time of construction. */
+  ExptJournal(const ExptDriver& expt,
+              const rutz::fstring& base_file,
+              const rutz::fstring& journal_file);
+
+  /// Destructor.
+  ~ExptJournal() noexcept;
+
+  /// Append a record for the trial that is just now ending.
+  /** This should be called from the ExptDriver's vxEndTrialHook(). */
+  void appendTrial();
+
+  /// Returns the number of records appended since the base snapshot.
+  unsigned int numRecords() const;
+
+  /// Returns the default journal filename for a given autosave file.
+  static rutz::fstring journalFileFor(const rutz::fstring& base_file);
+
+  /// Rebuild an experiment from a base snapshot plus a journal.
+  /** Returns the number of journal records that were replayed in
+      \a nrecords, if it is non-null. */
+  static nub::ref<ExptDriver> recover(const char* base_file,
+                                      const char* journal_file,
+                                      unsigned int* nrecords = nullptr);
+
+private:
+  ExptJournal(const ExptJournal&);
+  ExptJournal& operator=(const ExptJournal&);
+
+  class Impl;
+  Impl* const rep;
+};
+
+#endif // !GROOVX_VISX_EXPTJOURNAL_H_UTC20261019142137_DEFINED
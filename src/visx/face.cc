@@ -178,28 +178,29 @@ GVX_TRACE("Face::grRender");
     {
       // These parameters control the generation of the Bezier curve for
       // the face outline.
-      const int num_subdivisions = 30;
       const int nctrlsets = 2;
       const double* const ctrlpnts = getCtrlPnts();
 
+      itsCurves.begin(canvas);
+
       for (int i = 0; i < nctrlsets; ++i)
         {
           if (isItFilled)
             {
-              canvas.drawBezierFill4(vec3d(0.0, 0.0, 0.0),
-                                     vec3d(ctrlpnts+i*12+0),
-                                     vec3d(ctrlpnts+i*12+3),
-                                     vec3d(ctrlpnts+i*12+6),
-                                     vec3d(ctrlpnts+i*12+9),
-                                     num_subdivisions);
+              itsCurves.drawBezierFill4(canvas,
+                                        vec3d(0.0, 0.0, 0.0),
+                                        vec3d(ctrlpnts+i*12+0),
+                                        vec3d(ctrlpnts+i*12+3),
+                                        vec3d(ctrlpnts+i*12+6),
+                                        vec3d(ctrlpnts+i*12+9));
             }
           else
             {
-              canvas.drawBezier4(vec3d(ctrlpnts+i*12+0),
-                                 vec3d(ctrlpnts+i*12+3),
-                                 vec3d(ctrlpnts+i*12+6),
-                                 vec3d(ctrlpnts+i*12+9),
-                                 num_subdivisions);
+              itsCurves.drawBezier4(canvas,
+                                    vec3d(ctrlpnts+i*12+0),
+                                    vec3d(ctrlpnts+i*12+3),
+                                    vec3d(ctrlpnts+i*12+6),
+                                    vec3d(ctrlpnts+i*12+9));
             }
         }
     }
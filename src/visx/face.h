@@ -32,6 +32,7 @@
 #ifndef GROOVX_VISX_FACE_H_UTC20050626084017_DEFINED
 #define GROOVX_VISX_FACE_H_UTC20050626084017_DEFINED
 
+#include "gfx/curvecache.h"
 #include "gfx/gxshapekit.h"
 
 ///////////////////////////////////////////////////////////////////////
@@ -125,6 +126,9 @@ private:
   /// Whether the face is drawn as filled, or just as outlines (default false).
   bool isItFilled;
 
+  /// Tessellated outline curves, replayed while the face is unchanged.
+  mutable Gfx::CurveCache itsCurves;
+
   Face(const Face&);
   Face& operator=(const Face&);
 };
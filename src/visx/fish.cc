@@ -482,6 +482,8 @@ GVX_TRACE("Fish::grRender");
     Gfx::RgbaColor(0.0, 0.0, 0.0, 1.0)
   };
 
+  itsCurves.begin(canvas);
+
   // Loop over fish parts
   for (int i = 0; i < 4; ++i)
     {
@@ -512,7 +514,8 @@ GVX_TRACE("Fish::grRender");
           p.z() = p.z() * p.z() * swimStroke;
         }
 
-      canvas.drawNurbsCurve(&itsParts[i].itsKnots[0], &ctrlpnts[0], ctrlpnts.size());
+      itsCurves.drawNurbsCurve(canvas, &itsParts[i].itsKnots[0],
+                               &ctrlpnts[0], ctrlpnts.size());
 
       if (showControlPoints)
         {
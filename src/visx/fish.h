@@ -32,6 +32,7 @@
 #ifndef GROOVX_VISX_FISH_H_UTC20050626084015_DEFINED
 #define GROOVX_VISX_FISH_H_UTC20050626084015_DEFINED
 
+#include "gfx/curvecache.h"
 #include "gfx/gxshapekit.h"
 
 #include "rutz/tracer.h"
@@ -138,6 +139,9 @@ private:
   /// Controls the degree of the current swimming stroke.
   float swimStroke;
 
+  /// Tessellated part outlines, replayed while the fish is unchanged.
+  mutable Gfx::CurveCache itsCurves;
+
   /////////////
   // actions //
   /////////////
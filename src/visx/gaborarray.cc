@@ -84,7 +84,7 @@ namespace
     media::save_image(fname, bmap);
   }
 
-  const int GABORARRAY_SVID = 0;
+  const int GABORARRAY_SVID = 1;
 }
 
 GaborArray::GaborArray(double gaborPeriod, double gaborSigma,
@@ -114,6 +114,8 @@ GaborArray::GaborArray(double gaborPeriod, double gaborSigma,
   itsContrastSeed(0u),
   itsContrastJitter(0.0),
 
+  itsRandEngine(int(rutz::default_rand_engine)),
+
   itsArray(),
   itsBmap(),
 
@@ -122,6 +124,7 @@ GaborArray::GaborArray(double gaborPeriod, double gaborSigma,
 {
 GVX_TRACE("GaborArray::GaborArray");
 
+  setFieldMap(GaborArray::classFields());
   setAlignmentMode(GxAligner::CENTER_ON_CENTER);
   setPercentBorder(0);
 }
@@ -155,6 +158,9 @@ const FieldMap& GaborArray::classFields()
     Field("contrastSeed", &GaborArray::itsContrastSeed, 0u, 0u, 20000u, 1u),
     Field("contrastJitter", &GaborArray::itsContrastJitter, 0.0, 0.0, 2.0, 0.01),
 
+    // 0 = legacy, 1 = philox; see rutz::rand_engine
+    Field("randEngine", &GaborArray::itsRandEngine, 0, 0, 1, 1).versions(1),
+
     Field("dumpingFrames", &GaborArray::itsDumpingFrames,
           false, false, true, true, Field::BOOLEAN | Field::TRANSIENT),
     Field("frameDumpPeriod", &GaborArray::itsFrameDumpPeriod,
@@ -176,6 +182,10 @@ void GaborArray::read_from(io::reader& reader)
 {
 GVX_TRACE("GaborArray::read_from");
 
+  // Files from before randEngine was saved were generated with the
+  // legacy engine.
+  itsRandEngine.val = int(rutz::rand_engine::LEGACY);
+
   readFieldsFrom(reader, classFields());
 
   reader.read_base_class("GxShapeKit", io::make_proxy<GxShapeKit>(this));
@@ -282,22 +292,82 @@ GVX_TRACE("GaborArray::grRender");
   canvas.drawPixels(itsBmap, vec3d::zeros(), vec2d::ones());
 }
 
+GaborArray::ForegStats
+GaborArray::precomputeForeg(const std::vector<GaborArray*>& arrays,
+                            unsigned int nthreads)
+{
+GVX_TRACE("GaborArray::precomputeForeg");
+
+  std::vector<const GaborArray*> todo;
+  std::vector<Snake::Spec> specs;
+
+  for (const GaborArray* a: arrays)
+    {
+      if (a->foregOk())
+        continue;
+
+      Snake::Spec spec;
+      spec.length = a->itsForegNumber;
+      spec.spacing = a->itsForegSpacing;
+      spec.seed = a->itsForegSeed;
+      spec.engine = a->randEngine();
+
+      todo.push_back(a);
+      specs.push_back(spec);
+    }
+
+  const std::vector<Snake> snakes = Snake::makeBatch(specs, nthreads);
+
+  ForegStats result = ForegStats();
+
+  for (size_t i = 0; i < todo.size(); ++i)
+    {
+      todo[i]->installForeg(snakes[i]);
+
+      ++result.built;
+      if (!snakes[i].stats().converged)
+        ++result.failed;
+      result.jiggles += snakes[i].stats().jiggles;
+      result.tries += snakes[i].stats().tries;
+    }
+
+  return result;
+}
+
+rutz::rand_engine GaborArray::randEngine() const
+{
+  return rutz::rand_engine(int(itsRandEngine));
+}
+
+bool GaborArray::foregOk() const
+{
+  return (itsForegSeed.ok()
+          && itsRandEngine.ok()
+          && itsForegNumber.ok()
+          && itsForegSpacing.ok()
+          && itsForegPosX.ok()
+          && itsForegPosY.ok());
+}
+
 void GaborArray::updateForeg() const
 {
 GVX_TRACE("GaborArray::updateForeg");
 
-  if (itsForegSeed.ok()
-      && itsForegNumber.ok()
-      && itsForegSpacing.ok()
-      && itsForegPosX.ok()
-      && itsForegPosY.ok())
+  if (foregOk())
     return;
 
-  itsArray.resize(0);
+  rutz::rng generator(itsForegSeed, randEngine());
+
+  Snake snake(itsForegNumber, itsForegSpacing, generator);
 
-  rutz::urand urand(itsForegSeed);
+  installForeg(snake);
+}
+
+void GaborArray::installForeg(const Snake& snake) const
+{
+GVX_TRACE("GaborArray::installForeg");
 
-  Snake snake(itsForegNumber, itsForegSpacing, urand);
+  itsArray.resize(0);
 
   // pull in elements from the snake
   for (size_t n = 0; n < itsForegNumber; ++n)
@@ -314,6 +384,7 @@ GVX_TRACE("GaborArray::updateForeg");
     }
 
   itsForegSeed.save();
+  itsRandEngine.save();
   itsForegNumber.save();
   itsForegSpacing.save();
   itsForegPosX.save();
@@ -342,11 +413,11 @@ GVX_TRACE("GaborArray::updateBackg");
 
   const int diffusionCycles = 10;
 
-  rutz::urand urand(itsBackgSeed);
+  rutz::rng generator(itsBackgSeed, randEngine());
 
   for (int i = 0; i < diffusionCycles; ++i)
     {
-      backgJitter(urand);
+      backgJitter(generator);
       backgFill();
     }
 
@@ -408,9 +479,9 @@ GVX_TRACE("GaborArray::generateBmap");
 
   std::vector<double> win(npix, 0.0);
 
-  rutz::urand thetas(itsThetaSeed);
-  rutz::urand phases(itsPhaseSeed);
-  rutz::urand contrasts(itsContrastSeed);
+  rutz::rng thetas(itsThetaSeed, randEngine());
+  rutz::rng phases(itsPhaseSeed, randEngine());
+  rutz::rng contrasts(itsContrastSeed, randEngine());
 
   for (size_t i = 0; i < itsArray.size(); ++i)
     {
@@ -613,7 +684,7 @@ GVX_TRACE("GaborArray::backgFill");
   printf(" %zu elements, ave spacing %f\n", itsArray.size(), spacing);
 }
 
-void GaborArray::backgJitter(rutz::urand& urand) const
+void GaborArray::backgJitter(rutz::rng& generator) const
 {
 GVX_TRACE("GaborArray::backgJitter");
 
@@ -632,8 +703,8 @@ GVX_TRACE("GaborArray::backgJitter");
             continue;
 
           vec2d v;
-          v.x() = itsArray[n].pos.x() + jitter*(urand.fdraw_range(-1.0, 1.0));
-          v.y() = itsArray[n].pos.y() + jitter*(urand.fdraw_range(-1.0, 1.0));
+          v.x() = itsArray[n].pos.x() + jitter*(generator.fdraw_range(-1.0, 1.0));
+          v.y() = itsArray[n].pos.y() + jitter*(generator.fdraw_range(-1.0, 1.0));
 
           if (v.x() < -halfX) v.x() += itsSizeX;
           if (v.x() >  halfX) v.x() -= itsSizeX;
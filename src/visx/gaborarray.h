@@ -46,13 +46,16 @@ class Snake;
 
 namespace rutz
 {
-  class urand;
+  class rng;
+  enum class rand_engine;
 }
 
 template <class T>
 class Cached
 {
 public:
+  typedef T value_type;
+
   Cached(const T& v) noexcept : val(v), oldval(v), changed(true) {}
 
   operator       T&()       noexcept { return val; }
@@ -93,6 +96,23 @@ public:
 
   void saveContourOnlyImage(const char* filename) const;
 
+  /// Totals returned by precomputeForeg().
+  struct ForegStats
+  {
+    unsigned int built;     ///< number of contours generated
+    unsigned int failed;    ///< contours where some jiggle step gave up
+    unsigned long jiggles;  ///< jiggle steps, summed over all contours
+    unsigned long tries;    ///< trial moves, summed over all contours
+  };
+
+  /// Generate the foreground contours of several arrays in parallel.
+  /** This lets a block of trials get its contours built up front
+      rather than on the render path. Arrays whose foreground is
+      already up to date are skipped; the others end up exactly as if
+      they had built their own contour when next drawn. */
+  static ForegStats precomputeForeg(const std::vector<GaborArray*>& arrays,
+                                    unsigned int nthreads);
+
 protected:
   virtual void grGetBoundingBox(Gfx::Bbox& bbox) const override;
 
@@ -104,7 +124,10 @@ private:
 
   media::bmap_data generateBmap(bool doTagLast = false) const;
 
+  rutz::rand_engine randEngine() const;
+  bool foregOk() const;
   void updateForeg() const;
+  void installForeg(const Snake& snake) const;
   void updateBackg() const;
   void updateBmap() const;
   void update() const;
@@ -112,7 +135,7 @@ private:
   bool tooClose(const geom::vec2<double>& v, size_t except) const;
   void backgHexGrid() const;
   void backgFill() const;
-  void backgJitter(rutz::urand& urand) const;
+  void backgJitter(rutz::rng& generator) const;
 
   Cached<unsigned long> itsForegSeed;
   Cached<size_t> itsForegNumber;
@@ -135,6 +158,8 @@ private:
   Cached<unsigned long> itsContrastSeed;
   Cached<double> itsContrastJitter;
 
+  Cached<int> itsRandEngine; // a rutz::rand_engine, used with every seed
+
   mutable std::vector<GaborArrayElement> itsArray;
   mutable media::bmap_data itsBmap;
 
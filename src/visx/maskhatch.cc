@@ -72,7 +72,8 @@ GVX_TRACE("MaskHatch::make");
 MaskHatch::MaskHatch () :
   GxShapeKit(),
   itsNumLines(10),
-  itsLineWidth(1)
+  itsLineWidth(1),
+  itsLines()
 {
 GVX_TRACE("MaskHatch::MaskHatch");
 
@@ -123,6 +124,7 @@ GVX_TRACE("MaskHatch::write_to");
 
 void MaskHatch::update()
 {
+  itsLines.clear();
   setPercentBorder(itsLineWidth/2 + 2);
 }
 
@@ -143,41 +145,46 @@ GVX_TRACE("MaskHatch::grRender");
 
   canvas.setLineWidth(itsLineWidth);
 
-  Gfx::LinesBlock b(canvas);
+  if (itsLines.isEmpty())
+    {
+      using geom::vec3d;
 
-  using geom::vec2d;
+      itsLines.begin(Gfx::Canvas::VertexStyle::LINES);
 
-  for (int i = 0; i < itsNumLines; ++i)
-    {
-      double position = double(i)/itsNumLines;
+      for (int i = 0; i < itsNumLines; ++i)
+        {
+          double position = double(i)/itsNumLines;
 
-      // horizontal line
-      canvas.vertex2(vec2d(0.0, position));
-      canvas.vertex2(vec2d(1.0, position));
+          // horizontal line
+          itsLines.vertex(vec3d(0.0, position, 0.0));
+          itsLines.vertex(vec3d(1.0, position, 0.0));
 
-      // vertical line
-      canvas.vertex2(vec2d(position, 0.0));
-      canvas.vertex2(vec2d(position, 1.0));
+          // vertical line
+          itsLines.vertex(vec3d(position, 0.0, 0.0));
+          itsLines.vertex(vec3d(position, 1.0, 0.0));
 
-      // lines with slope = 1
-      canvas.vertex2(vec2d(0.0, position));
-      canvas.vertex2(vec2d(1.0-position, 1.0));
+          // lines with slope = 1
+          itsLines.vertex(vec3d(0.0, position, 0.0));
+          itsLines.vertex(vec3d(1.0-position, 1.0, 0.0));
 
-      canvas.vertex2(vec2d(position, 0.0));
-      canvas.vertex2(vec2d(1.0, 1.0-position));
+          itsLines.vertex(vec3d(position, 0.0, 0.0));
+          itsLines.vertex(vec3d(1.0, 1.0-position, 0.0));
 
-      // lines with slope = -1
-      canvas.vertex2(vec2d(0.0, 1.0-position));
-      canvas.vertex2(vec2d(1.0-position, 0.0));
+          // lines with slope = -1
+          itsLines.vertex(vec3d(0.0, 1.0-position, 0.0));
+          itsLines.vertex(vec3d(1.0-position, 0.0, 0.0));
 
-      canvas.vertex2(vec2d(position, 1.0));
-      canvas.vertex2(vec2d(1.0, position));
-    }
+          itsLines.vertex(vec3d(position, 1.0, 0.0));
+          itsLines.vertex(vec3d(1.0, position, 0.0));
+        }
 
-  // final closing lines
-  canvas.vertex2(vec2d(0.0, 1.0));
-  canvas.vertex2(vec2d(1.0, 1.0));
+      // final closing lines
+      itsLines.vertex(vec3d(0.0, 1.0, 0.0));
+      itsLines.vertex(vec3d(1.0, 1.0, 0.0));
+
+      itsLines.vertex(vec3d(1.0, 0.0, 0.0));
+      itsLines.vertex(vec3d(1.0, 1.0, 0.0));
+    }
 
-  canvas.vertex2(vec2d(1.0, 0.0));
-  canvas.vertex2(vec2d(1.0, 1.0));
+  itsLines.draw(canvas);
 }
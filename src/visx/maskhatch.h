@@ -33,6 +33,7 @@
 #define GROOVX_VISX_MASKHATCH_H_UTC20050626084016_DEFINED
 
 #include "gfx/gxshapekit.h"
+#include "gfx/mesh.h"
 
 ///////////////////////////////////////////////////////////////////////
 /**
@@ -75,6 +76,9 @@ private:
   /// The pixel-width of each line.
   int itsLineWidth;
 
+  /// The hatch lines, built on demand and cleared by update().
+  mutable Gfx::Mesh itsLines;
+
   // To connect to Signal's.
   void update();
 
@@ -309,6 +309,8 @@ GVX_TRACE("MorphyFace::grRender");
   Gfx::LineStrip ls;
   ls.lineJoin(itsLineJoin);
 
+  itsCurves.begin(canvas);
+
   //
   // Draw eyes
   //
@@ -321,8 +323,6 @@ GVX_TRACE("MorphyFace::grRender");
     vec3d( 4.0/7.0, 0.0,     0.0)
   };
 
-  const int eye_subdivisions = 20;
-
   for (int left_right = -1; left_right < 2; left_right += 2)
     {
       Gfx::MatrixSaver msaver(canvas);
@@ -348,16 +348,14 @@ GVX_TRACE("MorphyFace::grRender");
         ls.closeLoop(true);
         ls.begin(canvas, 0.01*itsStrokeWidth);
         // Two bezier curves end to end, sharing common vertices in the middle
-        ls.drawBezier4(s1*eye_ctrlpnts[3], s1*eye_ctrlpnts[2],
-                       s1*eye_ctrlpnts[1], s1*eye_ctrlpnts[0],
-                       eye_subdivisions, 1 /* skip the first vertex since
-                                              it will be wrapped around to
-                                              in the next bezier curve */);
-        ls.drawBezier4(s2*eye_ctrlpnts[0], s2*eye_ctrlpnts[1],
-                       s2*eye_ctrlpnts[2], s2*eye_ctrlpnts[3],
-                       eye_subdivisions, 1 /* skip the first vertex since
-                                              it was already covered by the
-                                              previous bezier curve */);
+        ls.vertices(itsCurves.bezier4(s1*eye_ctrlpnts[3], s1*eye_ctrlpnts[2],
+                                      s1*eye_ctrlpnts[1], s1*eye_ctrlpnts[0]),
+                    1 /* skip the first vertex since it will be wrapped
+                         around to in the next bezier curve */);
+        ls.vertices(itsCurves.bezier4(s2*eye_ctrlpnts[0], s2*eye_ctrlpnts[1],
+                                      s2*eye_ctrlpnts[2], s2*eye_ctrlpnts[3]),
+                    1 /* skip the first vertex since it was already
+                         covered by the previous bezier curve */);
         ls.end();
         ls.closeLoop(false);
       }
@@ -380,9 +378,8 @@ GVX_TRACE("MorphyFace::grRender");
                       1.0);
 
         ls.begin(canvas, 0.01*itsStrokeWidth*itsEyebrowThickness);
-        ls.drawBezier4(s*eye_ctrlpnts[0], s*eye_ctrlpnts[1],
-                       s*eye_ctrlpnts[2], s*eye_ctrlpnts[3],
-                       eye_subdivisions);
+        ls.vertices(itsCurves.bezier4(s*eye_ctrlpnts[0], s*eye_ctrlpnts[1],
+                                      s*eye_ctrlpnts[2], s*eye_ctrlpnts[3]));
         ls.end();
       }
 
@@ -411,20 +408,20 @@ GVX_TRACE("MorphyFace::grRender");
 
   ls.closeLoop(true);
   ls.begin(canvas, 0.015*itsStrokeWidth);
-  ls.drawBezier4(vec3d(itsFaceWidth, 0.0, 0.0),
-                 vec3d(itsBottomWidth*itsFaceWidth,
-                       itsBottomHeight*4.0/3.0, 0.0),
-                 vec3d(-itsBottomWidth*itsFaceWidth,
-                       itsBottomHeight*4.0/3.0, 0.0),
-                 vec3d(-itsFaceWidth, 0.0, 0.0),
-                 50, 1);
-  ls.drawBezier4(vec3d(-itsFaceWidth, 0.0, 0.0),
-                 vec3d(-itsTopWidth*itsFaceWidth,
-                       itsTopHeight*4.0/3.0, 0.0),
-                 vec3d(itsTopWidth*itsFaceWidth,
-                       itsTopHeight*4.0/3.0, 0.0),
-                 vec3d(itsFaceWidth, 0.0, 0.0),
-                 50, 1);
+  ls.vertices(itsCurves.bezier4(vec3d(itsFaceWidth, 0.0, 0.0),
+                                vec3d(itsBottomWidth*itsFaceWidth,
+                                      itsBottomHeight*4.0/3.0, 0.0),
+                                vec3d(-itsBottomWidth*itsFaceWidth,
+                                      itsBottomHeight*4.0/3.0, 0.0),
+                                vec3d(-itsFaceWidth, 0.0, 0.0)),
+              1);
+  ls.vertices(itsCurves.bezier4(vec3d(-itsFaceWidth, 0.0, 0.0),
+                                vec3d(-itsTopWidth*itsFaceWidth,
+                                      itsTopHeight*4.0/3.0, 0.0),
+                                vec3d(itsTopWidth*itsFaceWidth,
+                                      itsTopHeight*4.0/3.0, 0.0),
+                                vec3d(itsFaceWidth, 0.0, 0.0)),
+              1);
   ls.end();
   ls.closeLoop(false);
 
@@ -469,11 +466,10 @@ GVX_TRACE("MorphyFace::grRender");
     const vec3d s(itsMouthWidth, itsMouthCurvature, 1.0);
 
     ls.begin(canvas, 0.01*itsStrokeWidth);
-    ls.drawBezier4(s*vec3d(-0.5,  0.5,      0.0),
-                   s*vec3d(-0.2, -0.833333, 0.0),
-                   s*vec3d( 0.2, -0.833333, 0.0),
-                   s*vec3d( 0.5,  0.5,      0.0),
-                   30);
+    ls.vertices(itsCurves.bezier4(s*vec3d(-0.5,  0.5,      0.0),
+                                  s*vec3d(-0.2, -0.833333, 0.0),
+                                  s*vec3d( 0.2, -0.833333, 0.0),
+                                  s*vec3d( 0.5,  0.5,      0.0)));
     ls.end();
   }
 
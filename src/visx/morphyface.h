@@ -32,6 +32,7 @@
 #ifndef GROOVX_VISX_MORPHYFACE_H_UTC20050626084015_DEFINED
 #define GROOVX_VISX_MORPHYFACE_H_UTC20050626084015_DEFINED
 
+#include "gfx/curvecache.h"
 #include "gfx/gxshapekit.h"
 
 ///////////////////////////////////////////////////////////////////////
@@ -144,6 +145,9 @@ private:
   bool itsLineJoin;
     ///< Whether or not to do fancy line-joining.
 
+  mutable Gfx::CurveCache itsCurves;
+    ///< Tessellated curves, replayed while the face is unchanged.
+
 public:
   static const FieldMap& classFields();
 
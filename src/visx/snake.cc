@@ -37,9 +37,15 @@
 #include "rutz/rand.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <cstdio>
+#include <memory>
+#include <thread>
 
+// Snakes are also built on worker threads by Snake::makeBatch(), where
+// rutz::trace can't be used.
+#define GVX_NO_PROF
 #include "rutz/debug.h"
 GVX_DBG_REGISTER
 #include "rutz/trace.h"
@@ -62,23 +68,23 @@ namespace
     double arr[4];
   };
 
-  void pickRandom4(int length, size_t i[], rutz::urand& urand)
+  void pickRandom4(int length, size_t i[], rutz::rng& generator)
   {
-    i[0] = i[1] = i[2] = i[3] = size_t(urand.idraw(length));
+    i[0] = i[1] = i[2] = i[3] = size_t(generator.idraw(length));
 
     while (i[1] == i[0])
     {
-      i[1] = size_t(urand.idraw(length));
+      i[1] = size_t(generator.idraw(length));
     }
 
     while (i[2] == i[0] || i[2] == i[1])
     {
-      i[2] = size_t(urand.idraw(length));
+      i[2] = size_t(generator.idraw(length));
     }
 
     while (i[3] == i[0] || i[3] == i[1] || i[3] == i[2])
     {
-      i[3] = size_t(urand.idraw(length));
+      i[3] = size_t(generator.idraw(length));
     }
 
     std::sort(i, i+4);
@@ -233,7 +239,7 @@ namespace
   }
 
   bool acceptNewDelta(const Tuple4& newdelta, const Tuple4& olddelta,
-                      rutz::urand& urand)
+                      rutz::rng& generator)
   {
     const double energy_diff =
       newdelta[0]*newdelta[0] - olddelta[0]*olddelta[0]
@@ -244,18 +250,19 @@ namespace
     // Note, if energy_diff<0, then probability>1.
     const double probability = exp(-energy_diff/TEMPERATURE);
 
-    return urand.fdraw() <= probability;
+    return generator.fdraw() <= probability;
   }
 }
 
-Snake::Snake(size_t length, double spacing, rutz::urand& urand) :
-  itsElem(length)
+Snake::Snake(size_t length, double spacing, rutz::rng& generator) :
+  itsElem(length),
+  itsStats()
 {
 GVX_TRACE("Snake::Snake");
 
   const double radius = (itsElem.size() * spacing) / (2*M_PI);
 
-  const double alpha_start = 2 * M_PI * urand.fdraw();
+  const double alpha_start = 2 * M_PI * generator.fdraw();
 
   for (size_t n = 0; n < itsElem.size(); ++n)
     {
@@ -266,11 +273,15 @@ GVX_TRACE("Snake::Snake");
 
   const int ITERS = 400;
 
+  itsStats.converged = true;
+
   for (int count = 0; count < ITERS; ++count)
     {
-      const bool convergeOk = this->jiggle(urand);
+      const bool convergeOk = this->jiggle(generator);
+      ++itsStats.jiggles;
       if ( !convergeOk )
         {
+          itsStats.converged = false;
           printf("warning: Snake::jiggle failed to converge\n");
           break;
         }
@@ -293,6 +304,50 @@ Snake::~Snake()
 GVX_TRACE("Snake::~Snake");
 }
 
+std::vector<Snake> Snake::makeBatch(const std::vector<Spec>& specs,
+                                    unsigned int nthreads)
+{
+GVX_TRACE("Snake::makeBatch");
+
+  std::vector<std::unique_ptr<Snake> > built(specs.size());
+
+  // Snakes take very different amounts of time to converge, so rather
+  // than splitting the specs into fixed ranges, each worker claims the
+  // next unbuilt one until none are left.
+  std::atomic<size_t> next(0);
+
+  auto work = [&specs, &built, &next]()
+    {
+      for (size_t i = next++; i < specs.size(); i = next++)
+        {
+          rutz::rng generator(specs[i].seed, specs[i].engine);
+          built[i].reset(new Snake(specs[i].length, specs[i].spacing,
+                                   generator));
+        }
+    };
+
+  const size_t nworkers =
+    std::max(size_t(1), std::min(size_t(nthreads), specs.size()));
+
+  if (nworkers == 1)
+    work();
+  else
+    {
+      std::vector<std::thread> workers;
+      for (size_t w = 0; w < nworkers; ++w)
+        workers.emplace_back(work);
+      for (std::thread& t: workers)
+        t.join();
+    }
+
+  std::vector<Snake> result;
+  result.reserve(specs.size());
+  for (auto& s: built)
+    result.push_back(std::move(*s));
+
+  return result;
+}
+
 GaborArrayElement Snake::getElement(size_t n) const
 {
 GVX_TRACE("Snake::getElement");
@@ -342,12 +397,12 @@ GVX_TRACE("Snake::getElement");
 /*               \    _,-~   theta[2]                                     */
 /*              no[2]~_________                                           */
 
-bool Snake::jiggle(rutz::urand& urand)
+bool Snake::jiggle(rutz::rng& generator)
 {
 GVX_TRACE("Snake::jiggle");
 
   size_t i[4];
-  pickRandom4(int(itsElem.size()), i, urand);
+  pickRandom4(int(itsElem.size()), i, generator);
 
   const vec2d old_pos[4] =
     {
@@ -373,9 +428,9 @@ GVX_TRACE("Snake::jiggle");
 
   for (; k < MAX_ITERS; ++k)
     {
-      const double incr = urand.booldraw() ? -increment : increment;
+      const double incr = generator.booldraw() ? -increment : increment;
 
-      const int r = urand.idraw(4);
+      const int r = generator.idraw(4);
 
       const double incr_theta = old_theta[r] - incr;
 
@@ -406,12 +461,14 @@ GVX_TRACE("Snake::jiggle");
           continue;
         }
 
-      if (acceptNewDelta(new_delta, old_delta, urand))
+      if (acceptNewDelta(new_delta, old_delta, generator))
         break;
     }
 
   bool didConverge = (k < MAX_ITERS);
 
+  itsStats.tries += (unsigned long)(didConverge ? k + 1 : k);
+
   for (int n = 0; n < 4; ++n)
     this->transformPath(i[n], new_pos[n],
                         i[(n+1)%4], new_pos[(n+1)%4]);
@@ -39,7 +39,8 @@
 
 namespace rutz
 {
-  class urand;
+  class rng;
+  enum class rand_engine;
 }
 
 struct GaborArrayElement
@@ -64,13 +65,43 @@ struct GaborArrayElement
 class Snake
 {
 public:
-  Snake(size_t length, double spacing, rutz::urand& urand);
+  Snake(size_t length, double spacing, rutz::rng& generator);
+  Snake(Snake&&) = default;
+  Snake& operator=(Snake&&) = default;
   ~Snake();
 
   GaborArrayElement getElement(size_t n) const;
 
+  /// Convergence statistics from building the snake.
+  struct Stats
+  {
+    unsigned int jiggles;  ///< number of jiggle() steps taken
+    unsigned long tries;   ///< trial moves summed over all jiggle() steps
+    bool converged;        ///< false if a jiggle() step gave up early
+  };
+
+  const Stats& stats() const { return itsStats; }
+
+  /// Parameters for one snake in a batch.
+  struct Spec
+  {
+    size_t length;
+    double spacing;
+    unsigned long seed;
+    rutz::rand_engine engine;
+  };
+
+  /// Build one snake per spec, spread over up to nthreads threads.
+  /** Each snake is built from its own rutz::rng(spec.seed,
+      spec.engine), so result
+      i is bit-for-bit the same as constructing it serially with such
+      a generator, no matter how many threads are used. */
+  static std::vector<Snake> makeBatch(const std::vector<Spec>& specs,
+                                      unsigned int nthreads);
+
 private:
   std::vector<geom::vec2<double> > itsElem;
+  Stats itsStats;
 
   size_t adjust_index(size_t b, int offset) const
   {
@@ -93,7 +124,7 @@ private:
   }
 
   // Returns true if jiggling converged
-  bool jiggle(rutz::urand& urand);
+  bool jiggle(rutz::rng& generator);
   void transformPath(size_t i1, const geom::vec2<double>& new1,
                      size_t i2, const geom::vec2<double>& new2);
 };
@@ -37,6 +37,7 @@
 #include "tcl/pkg.h"
 
 #include "rutz/iter.h"
+#include "rutz/rand.h"
 
 #include "visx/elementcontainer.h"
 
@@ -52,6 +53,11 @@ namespace
         container->addElement(nub::ref<Element>(objid), repeat);
       }
   }
+
+  const char* getRandEngine(nub::ref<ElementContainer> container)
+  {
+    return rutz::rand_engine_name(container->getRandEngine());
+  }
 }
 
 extern "C"
@@ -75,6 +81,8 @@ GVX_TRACE("Elementcontainer_Init");
       pkg->def_getter("isComplete", &ElementContainer::isComplete, SRC_POS);
       pkg->def_getter("numCompleted", &ElementContainer::numCompleted, SRC_POS);
       pkg->def_getter("numElements", &ElementContainer::numElements, SRC_POS);
+      pkg->def_get_set("randSeed", &ElementContainer::getRandSeed, &ElementContainer::setRandSeed, SRC_POS);
+      pkg->def("randEngine", "objref", &getRandEngine, SRC_POS);
       pkg->def_action("clearElements", &ElementContainer::clearElements, SRC_POS);
       pkg->def_vec("shuffle", "objref(s) rand_seed", &ElementContainer::shuffle, 1, SRC_POS);
       pkg->def_getter("elements", &ElementContainer::getElements, SRC_POS);
@@ -44,6 +44,7 @@
 #include "rutz/sfmt.h"
 
 #include "visx/exptdriver.h"
+#include "visx/exptjournal.h"
 
 #include "rutz/trace.h"
 
@@ -112,6 +113,18 @@ namespace
   }
 
   void fakePause(nub::ref<ExptDriver>) {}
+
+  nub::ref<ExptDriver> recoverAutosave(const char* base_file)
+  {
+    return ExptJournal::recover
+      (base_file, ExptJournal::journalFileFor(base_file).c_str());
+  }
+
+  nub::ref<ExptDriver> recoverAutosave2(const char* base_file,
+                                        const char* journal_file)
+  {
+    return ExptJournal::recover(base_file, journal_file);
+  }
 }
 
 extern "C"
@@ -139,6 +152,16 @@ GVX_TRACE("Exptdriver_Init");
                        &ExptDriver::getAutosavePeriod,
                        &ExptDriver::setAutosavePeriod,
                        SRC_POS);
+      pkg->def_get_set("autosaveJournal",
+                       &ExptDriver::getAutosaveJournal,
+                       &ExptDriver::setAutosaveJournal,
+                       SRC_POS);
+      pkg->def_getter("numJournalRecords",
+                      &ExptDriver::numJournalRecords, SRC_POS);
+      pkg->def("recoverAutosave", "base_file",
+               &recoverAutosave, SRC_POS);
+      pkg->def("recoverAutosave", "base_file journal_file",
+               &recoverAutosave2, SRC_POS);
       pkg->def_action("claimLogFile", &ExptDriver::claimLogFile, SRC_POS);
       pkg->def_get_set("filePrefix",
                        &ExptDriver::getFilePrefix,
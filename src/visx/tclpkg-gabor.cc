@@ -36,8 +36,32 @@
 #include "visx/gabor.h"
 #include "visx/gaborarray.h"
 
+#include "tcl/list.h"
+
 #include "rutz/trace.h"
 
+namespace
+{
+  // Returns the totals as a {built N failed N jiggles N tries N} dict.
+  tcl::list precomputeForeg(const tcl::list& objs, unsigned int nthreads)
+  {
+    std::vector<GaborArray*> arrays;
+
+    for (const auto& a: objs.view_of<nub::ref<GaborArray>>())
+      arrays.push_back(a.get());
+
+    const GaborArray::ForegStats stats =
+      GaborArray::precomputeForeg(arrays, nthreads);
+
+    tcl::list result;
+    result.append("built");   result.append(stats.built);
+    result.append("failed");  result.append(stats.failed);
+    result.append("jiggles"); result.append(stats.jiggles);
+    result.append("tries");   result.append(stats.tries);
+    return result;
+  }
+}
+
 extern "C"
 int Gabor_Init(Tcl_Interp* interp)
 {
@@ -68,5 +92,7 @@ GVX_TRACE("Gaborarray_Init");
       pkg->def("saveContourOnlyImage", "objref filename",
                &GaborArray::saveContourOnlyImage,
                SRC_POS);
+      pkg->def("precomputeForeg", "objref(s) nthreads",
+               &precomputeForeg, SRC_POS);
     });
 }
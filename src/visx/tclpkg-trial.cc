@@ -36,8 +36,11 @@
 #include "nub/objfactory.h"
 
 #include "tcl/itertcl.h"
+#include "tcl/list.h"
 #include "tcl/tracertcl.h"
 
+#include "tcl-gfx/toglet.h"
+
 #include "tcl-io/fieldpkg.h"
 
 #include "visx/response.h"
@@ -53,6 +56,25 @@ namespace tcl
   struct help_convert<Response> : public help_convert<rutz::value> {};
 }
 
+namespace
+{
+  tcl::list frameStats(nub::ref<Trial> trial)
+  {
+    const Trial::FrameStats stats = trial->frameStats();
+
+    tcl::list result;
+    result.append("frames");    result.append(stats.frames);
+    result.append("preloaded"); result.append(stats.preloaded);
+    result.append("overruns");  result.append(stats.overruns);
+    return result;
+  }
+
+  void preloadFrames(nub::ref<Trial> trial)
+  {
+    trial->vxPreload(Toglet::getCurrent());
+  }
+}
+
 extern "C"
 int Trial_Init(Tcl_Interp* interp)
 {
@@ -80,11 +102,15 @@ GVX_TRACE("Trial_Init");
                        &Trial::getCurrentNode,
                        &Trial::setCurrentNode,
                        SRC_POS);
+      pkg->def("frameStats", "objref", &frameStats, SRC_POS);
+      pkg->def("framePeriod", "", &Trial::framePeriod, SRC_POS);
+      pkg->def("framePeriod", "msec", &Trial::setFramePeriod, SRC_POS);
       pkg->def_get_set("info", &Trial::vxInfo, &Trial::setInfo, SRC_POS);
       pkg->def_getter("lastResponse", &Trial::lastResponse, SRC_POS);
       pkg->def_action("nextNode", &Trial::trNextNode, SRC_POS);
       pkg->def_getter("nodes", &Trial::nodes, SRC_POS);
       pkg->def_getter("numResponses", &Trial::numResponses, SRC_POS);
+      pkg->def("preloadFrames", "objref", &preloadFrames, SRC_POS);
       pkg->def_getter("responses", &Trial::responses, SRC_POS);
       pkg->def_get_set("responseHdlr",
                        &Trial::getResponseHandler,
@@ -98,6 +98,7 @@ GVX_TRACE("Trialevent_Init");
   errors += addEventType(interp, &makeRenderFrontEvent, "RenderFrontEvent");
   errors += addEventType(interp, &makeClearBufferEvent, "ClearBufferEvent");
   errors += addEventType(interp, &makeFinishDrawingEvent, "FinishDrawingEvent");
+  errors += addEventType(interp, &makePreloadNextEvent, "PreloadNextEvent");
 
   return errors ? tcl::pkg::STATUS_ERR : tcl::pkg::STATUS_OK;
 }
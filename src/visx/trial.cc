@@ -31,18 +31,25 @@
 
 #include "trial.h"
 
+#include "geom/rect.h"
+
 #include "gfx/canvas.h"
+#include "gfx/gxcamera.h"
+#include "gfx/gxscene.h"
 #include "gfx/gxshapekit.h"
 
 #include "io/readutils.h"
 #include "io/writeutils.h"
 
+#include "media/bmapdata.h"
+
 #include "nub/log.h"
 #include "nub/ref.h"
 
 #include "rutz/fstring.h"
 #include "rutz/iter.h"
 #include "rutz/sfmt.h"
+#include "rutz/time.h"
 
 #include "tcl-gfx/toglet.h"
 
@@ -74,7 +81,20 @@ rutz::tracer Trial::tracer;
 
 namespace dummy_namespace_to_avoid_gcc411_bug_trial_cc
 {
-  const io::version_id TRIAL_SVID = 5;
+  const io::version_id TRIAL_SVID = 6;
+
+  double framePeriodMsec = 1000.0 / 60.0;
+
+  // A node pre-rendered into a pixel cache, along with the state it
+  // was rendered from, so that we can tell whether it is still good.
+  struct PreloadedFrame
+  {
+    std::unique_ptr<media::bmap_data> pixels;
+    const GxNode* node;
+    unsigned long nodeChanges;
+    const GxNode* camera;
+    unsigned long cameraChanges;
+  };
 
   struct ActiveState
   {
@@ -86,7 +106,8 @@ namespace dummy_namespace_to_avoid_gcc411_bug_trial_cc
       widget(w),
       rh(r),
       th(t),
-      status(Element::ChildStatus::OK)
+      status(Element::ChildStatus::OK),
+      firstResponse(0)
     {
       GVX_PRECONDITION(parent != nullptr);
       nub::logging::add_obj_scope(*trial);
@@ -103,6 +124,7 @@ namespace dummy_namespace_to_avoid_gcc411_bug_trial_cc
     ref<ResponseHandler> rh;
     ref<TimingHdlr> th;
     Element::ChildStatus status;
+    size_t firstResponse; // # of responses when the trial began
   };
 }
 
@@ -131,7 +153,10 @@ public:
     rh(),
     th(),
     info(),
-    activeState(nullptr)
+    activeState(nullptr),
+    preloading(false),
+    frames(),
+    frameStats()
   {}
 
   Trial* owner;
@@ -153,11 +178,17 @@ public:
 
   std::unique_ptr<ActiveState> activeState;
 
+  bool preloading;
+  std::vector<PreloadedFrame> frames; // parallel to gxNodes
+  Trial::FrameStats frameStats;
+
   bool isActive() const { return activeState.get() != nullptr; }
 
   void becomeActive(Element* parent, soft_ref<Toglet> widget)
   {
     activeState.reset(new ActiveState(owner, parent, widget, rh, th));
+    activeState->firstResponse = responses.size();
+    frameStats = Trial::FrameStats();
   }
 
   void becomeInactive()
@@ -175,6 +206,99 @@ public:
                             gxNodes[currentNode]->unique_name().c_str()));
       }
   }
+
+  bool isFrameValid(size_t i, Toglet& widget) const
+  {
+    if (i >= frames.size() || i >= gxNodes.size()
+        || frames[i].pixels.get() == nullptr)
+      return false;
+
+    const PreloadedFrame& f = frames[i];
+    const GxCamera& camera = *widget.getCamera();
+    const geom::recti viewport = widget.getCanvas()->getScreenViewport();
+
+    return f.node == gxNodes[i].get()
+      && f.nodeChanges == gxNodes[i]->numNodeChanges()
+      && f.camera == &camera
+      && f.cameraChanges == camera.numNodeChanges()
+      && f.pixels->width() == size_t(viewport.width())
+      && f.pixels->height() == size_t(viewport.height());
+  }
+
+  void preload(Toglet& widget)
+  {
+    // Pre-rendering needs a back buffer to draw in out of sight; so
+    // on a single-buffered canvas, just render frames as they come.
+    if (!widget.getCanvas()->isDoubleBuffered())
+      {
+        nub::log("not preloading frames on a single-buffered canvas");
+        return;
+      }
+
+    frames.resize(gxNodes.size());
+
+    widget.makeCurrent();
+
+    unsigned int count = 0;
+
+    for (size_t i = 0; i < gxNodes.size(); ++i)
+      {
+        if (isFrameValid(i, widget))
+          continue;
+
+        PreloadedFrame& f = frames[i];
+        f.pixels.reset(new media::bmap_data
+                       (widget.scene().preRender(*gxNodes[i])));
+        f.node = gxNodes[i].get();
+        f.nodeChanges = gxNodes[i]->numNodeChanges();
+        f.camera = widget.getCamera().get();
+        f.cameraChanges = widget.getCamera()->numNodeChanges();
+        ++count;
+      }
+
+    if (count > 0)
+      nub::log(rutz::sfmt("preloaded %u frames", count));
+  }
+
+  // Draw the current node from its pixel cache, if we have a good
+  // one; if 'full', then also swap buffers and wait for that to
+  // finish. Returns false if the caller needs to render normally.
+  bool drawPreloaded(Toglet& widget, bool full)
+  {
+    if (!preloading || !isFrameValid(currentNode, widget))
+      return false;
+
+    widget.makeCurrent();
+
+    if (full)
+      {
+        widget.scene().showFrame(*frames[currentNode].pixels);
+        widget.getCanvas()->finishDrawing();
+      }
+    else
+      {
+        widget.scene().renderFrame(*frames[currentNode].pixels);
+      }
+
+    ++frameStats.preloaded;
+    return true;
+  }
+
+  void countFrame(const rutz::time& start)
+  {
+    const double msec = (rutz::time::wall_clock_now() - start).msec();
+
+    ++frameStats.frames;
+    frameStats.overruns += (unsigned int)(msec / framePeriodMsec);
+  }
+
+  void logFrameStats() const
+  {
+    nub::log(rutz::sfmt("frames drawn: %u (%u preloaded), "
+                        "frame period overruns: %u",
+                        frameStats.frames, frameStats.preloaded,
+                        frameStats.overruns));
+  }
 };
 
 ///////////////////////////////////////////////////////////////////////
@@ -192,7 +316,9 @@ const FieldMap& Trial::classFields()
   static const Field FIELD_ARRAY[] =
   {
     Field("tType", &Trial::trialType, &Trial::setType,
-          -1, -10, 10, 1, Field::NEW_GROUP)
+          -1, -10, 10, 1, Field::NEW_GROUP),
+    Field("preload", &Trial::isPreloading, &Trial::setPreloading,
+          false, false, true, true, Field::BOOLEAN)
   };
 
   static FieldMap TRIAL_FIELDS(FIELD_ARRAY);
@@ -250,6 +376,12 @@ GVX_TRACE("Trial::read_from");
   rep->th = dyn_cast<TimingHdlr>(reader.read_weak_object("th"));
 
   reader.read_value("info", rep->info);
+
+  rep->preloading = false;
+  if (reader.input_version_id() >= 6)
+    reader.read_value("preload", rep->preloading);
+
+  rep->frames.clear();
 }
 
 void Trial::write_to(io::writer& writer) const
@@ -275,6 +407,8 @@ GVX_TRACE("Trial::write_to");
   writer.write_object("th", rep->th);
 
   writer.write_value("info", rep->info);
+
+  writer.write_value("preload", rep->preloading);
 }
 
 const soft_ref<Toglet>& Trial::getWidget() const
@@ -310,6 +444,30 @@ int Trial::trialType() const
 void Trial::setType(int t)
   { rep->trialType = t; }
 
+bool Trial::isPreloading() const
+  { return rep->preloading; }
+
+void Trial::setPreloading(bool val)
+{
+  rep->preloading = val;
+  if (!val)
+    rep->frames.clear();
+}
+
+Trial::FrameStats Trial::frameStats() const
+  { return rep->frameStats; }
+
+double Trial::framePeriod()
+  { return framePeriodMsec; }
+
+void Trial::setFramePeriod(double msec)
+{
+  if (msec <= 0.0)
+    throw rutz::error("frame period must be positive", SRC_POS);
+
+  framePeriodMsec = msec;
+}
+
 
 fstring Trial::vxInfo() const
 {
@@ -347,6 +505,18 @@ GVX_TRACE("Trial::responses");
 size_t Trial::numResponses() const
   { return rep->responses.size(); }
 
+size_t Trial::numNewResponses() const
+{
+  if (!rep->isActive() ||
+      rep->activeState->firstResponse > rep->responses.size())
+    return 0;
+
+  return rep->responses.size() - rep->activeState->firstResponse;
+}
+
+void Trial::addResponse(const Response& response)
+  { rep->responses.push_back(response); }
+
 void Trial::clearResponses()
   { rep->responses.clear(); }
 
@@ -416,6 +586,7 @@ void Trial::clearObjs()
 {
 GVX_TRACE("Trial::clearObjs");
   rep->gxNodes.clear();
+  rep->frames.clear();
 }
 
 fstring Trial::stdInfo() const
@@ -475,6 +646,9 @@ GVX_TRACE("Trial::vxRun");
 
   rep->currentNode = 0;
 
+  if (rep->preloading)
+    rep->preload(*widget);
+
   rep->activeState->rh->rhBeginTrial(widget, *this);
   rep->activeState->th->thBeginTrial(*this);
 }
@@ -519,6 +693,8 @@ GVX_TRACE("Trial::trEndTrial");
   rep->activeState->th->thEndTrial();
   rep->activeState->parent->vxEndTrialHook();
 
+  rep->logFrameStats();
+
   Element* parent = rep->activeState->parent;
   Element::ChildStatus status = rep->activeState->status;
 
@@ -541,6 +717,8 @@ GVX_TRACE("Trial::vxHalt");
   rep->activeState->rh->rhHaltExpt();
   rep->activeState->th->thHaltExpt();
 
+  rep->logFrameStats();
+
   rep->becomeInactive();
 }
 
@@ -550,6 +728,13 @@ GVX_TRACE("Trial::vxReset");
   rep->responses.clear();
 }
 
+void Trial::vxPreload(const soft_ref<Toglet>& widget)
+{
+GVX_TRACE("Trial::vxPreload");
+  if (rep->preloading && widget.is_valid())
+    rep->preload(*widget);
+}
+
 void Trial::trProcessResponse(Response& response)
 {
 GVX_TRACE("Trial::trProcessResponse");
@@ -579,9 +764,12 @@ GVX_TRACE("Trial::trDraw");
   soft_ref<Toglet> widget = getWidget();
   if (widget.is_valid())
     {
+      const rutz::time start = rutz::time::wall_clock_now();
       rep->installCurrentNode();
       widget->setVisibility(true);
-      widget->fullRender();
+      if (!rep->drawPreloaded(*widget, true))
+        widget->fullRender();
+      rep->countFrame(start);
     }
 }
 
@@ -591,9 +779,12 @@ GVX_TRACE("Trial::trRender");
   soft_ref<Toglet> widget = getWidget();
   if (widget.is_valid())
     {
+      const rutz::time start = rutz::time::wall_clock_now();
       rep->installCurrentNode();
       widget->setVisibility(true);
-      widget->render();
+      if (!rep->drawPreloaded(*widget, false))
+        widget->render();
+      rep->countFrame(start);
     }
 }
 
@@ -668,3 +859,14 @@ GVX_TRACE("Trial::trDenyResponses");
 
   rep->activeState->rh->rhDenyResponses();
 }
+
+void Trial::trPreloadNext()
+{
+GVX_TRACE("Trial::trPreloadNext");
+
+  GVX_PRECONDITION( rep->isActive() );
+
+  nub::log("trPreloadNext");
+
+  rep->activeState->parent->vxPreloadNext(rep->activeState->widget);
+}
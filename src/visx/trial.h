@@ -95,10 +95,53 @@ public:
 
   void setType(int t);
 
+  /// Query whether the trial's frames are pre-rendered before they are drawn.
+  bool isPreloading() const;
+
+  /// Set whether the trial's frames are pre-rendered before they are drawn.
+  /** When this is on, vxPreload() (or else vxRun(), if nothing was
+      preloaded) renders each of the trial's nodes into a pixel cache,
+      and trDraw() and trRender() just copy the cached pixels for the
+      current node to the screen, as long as neither the node nor the
+      camera nor the window size has changed in the meantime. On a
+      single-buffered canvas nothing is preloaded, and the frames are
+      rendered as usual. */
+  void setPreloading(bool val);
+
+  /// Counts of the frames drawn in a run of a trial.
+  struct FrameStats
+  {
+    unsigned int frames;     ///< frames drawn by trDraw() or trRender()
+    unsigned int preloaded;  ///< frames that came from the pixel cache
+    unsigned int overruns;   ///< whole frame periods spent drawing
+  };
+
+  /// Get the frame counts for the current run, or else the most recent one.
+  FrameStats frameStats() const;
+
+  /// Get the frame period (in msec) against which overruns are counted.
+  static double framePeriod();
+
+  /// Set the frame period (in msec) against which overruns are counted.
+  /** This should match the display's refresh rate; the default is
+      1000/60 msec. A frame whose drawing (including, for preloaded
+      frames, waiting for the buffer swap to complete) takes longer
+      than N frame periods counts as N overruns. This measures only
+      the time spent drawing, not whether the swap actually caught
+      the intended refresh; for that, see the swap and present times
+      in GxScene::frameLog(). */
+  static void setFramePeriod(double msec);
+
   rutz::fwd_iter<Response> responses() const;
 
   size_t numResponses() const;
 
+  /// Returns the number of responses seen since the trial last began running.
+  size_t numNewResponses() const;
+
+  /// Append a previously recorded response (e.g. from an autosave journal).
+  void addResponse(const Response& response);
+
   void clearResponses();
 
   double avgResponse() const;
@@ -150,6 +193,9 @@ public:
 
   virtual void vxReset() override;
 
+  /// Pre-render each of the trial's nodes, if isPreloading() is on.
+  virtual void vxPreload(const nub::soft_ref<Toglet>& widget) override;
+
   /////////////
   // actions //
   /////////////
@@ -167,6 +213,7 @@ public:
   void trFinishDrawing();
   void trAllowResponses();
   void trDenyResponses();
+  void trPreloadNext();
   void trAbortTrial();
   void trEndTrial();
 
@@ -243,6 +243,7 @@ MAKE_EVENT(RenderFront);
 MAKE_EVENT(SwapBuffers);
 MAKE_EVENT(ClearBuffer);
 MAKE_EVENT(FinishDrawing);
+MAKE_EVENT(PreloadNext);
 
 #undef MAKE_EVENT
 
@@ -230,6 +230,10 @@ TrialEvent* makeSwapBuffersEvent();
 TrialEvent* makeClearBufferEvent();
 /// Return a TrialMemFuncEvent bound to Trial::trFinishDrawing.
 TrialEvent* makeFinishDrawingEvent();
+/// Return a TrialMemFuncEvent bound to Trial::trPreloadNext.
+/** This may come between a render event and the swap event that shows
+    its frame; the unswapped frame is kept (see GxScene::preRender()). */
+TrialEvent* makePreloadNextEvent();
 
 
 //  #######################################################
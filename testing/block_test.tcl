@@ -102,3 +102,25 @@ test "Block::info" "normal use on empty expt" {
     Block::clearElements $::BLOCK
     Block::info $::BLOCK
 } {^complete$}
+
+### Block::randSeed ###
+test "Block::randSeed" "set and get" {
+    Block::randSeed $::BLOCK 17
+    Block::randSeed $::BLOCK
+} {^17$}
+
+test "Block::randSeed" "shuffle sets the seed" {
+    Block::shuffle $::BLOCK 42
+    Block::randSeed $::BLOCK
+} {^42$}
+
+### Block::randEngine ###
+test "Block::randEngine" "bound at seed time, and saved with the seed" {
+    set b [Obj::new Block]
+    default_rand_engine philox
+    Block::randSeed $b 17
+    default_rand_engine legacy
+    set b2 [Obj::new Block]
+    io::read_asw $b2 [io::write_asw $b]
+    list [Block::randEngine $b] [Block::randEngine $b2] [Block::randSeed $b2]
+} {^philox philox 17$}
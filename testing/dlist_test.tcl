@@ -161,6 +161,15 @@ test "Dlist-dlist::sum" "norm float" {
 test "Dlist-dlist::sum" "norm mixed" {
      dlist::sum { -4 2 -0.1 4.5 }
 } {^2\.4$}
+test "Dlist-dlist::sum" "int sum is 64-bit" {
+     dlist::sum { 2147483647 1 }
+} {^2147483648$}
+test "Dlist-dlist::sum" "compensated float sum" {
+     dlist::sum { 1e16 1 -1e16 }
+} {^1\.0$}
+test "Dlist-dlist::sum" "ints after a double" {
+     dlist::sum { 0.5 9007199254740992 1 1 }
+} {^9007199254740994\.0$}
 test "Dlist-dlist::sum" "error" {
      dlist::sum { 1 junk }
 } {expected.*but got}
@@ -178,3 +187,19 @@ test "Dlist-dlist::zeros" "norm2" {
 test "Dlist-dlist::zeros" "err1" {
     dlist::zeros 3.5
 } {expected.*but got}
+
+### packed numeric lists ###
+test "Dlist-packed" "sum of range" {
+    dlist::sum [dlist::range 1 1000]
+} {^500500$}
+test "Dlist-packed" "choose from linspace" {
+    dlist::choose [dlist::linspace 0.5 2 4] {3 0}
+} {^2\.0 0\.5$}
+test "Dlist-packed" "select from range" {
+    dlist::select [dlist::range 0 5] [dlist::not {1 0 1 0 1 0}]
+} {^1 3 5$}
+test "Dlist-packed" "string ops on packed list" {
+    set x [dlist::range 0 4]
+    lappend x 9
+    list [llength $x] [dlist::sum $x]
+} {^6 19$}
@@ -138,3 +138,61 @@ test "ExptDriver::begin" "general sanity test" {
 
     return $::DONE
 } {^1$}
+
+### ExptDriver::autosaveJournal ###
+test "ExptDriver::autosaveJournal" "journal and recover" {
+    set thid [new TimingHdlr]
+    -> $thid addStartEvent EndTrialEvent 10
+
+    set block [new Block]
+    for {set i 0} {$i < 3} {incr i} {
+        set trial [new Trial]
+        -> $trial addNode [new Face]
+        -> $trial timingHdlr $thid
+        -> $trial responseHdlr [new NullResponseHdlr]
+        -> $block addElements $trial
+    }
+
+    set expt [new ExptDriver]
+    -> $expt widget [Toglet::current]
+    -> $expt addElement $block
+    -> $expt autosaveFile __autosave_journal_test
+    -> $expt autosaveJournal 1
+
+    set ::DONE 0
+    -> $expt doWhenComplete { set ::DONE 1; set ::STOP 1 }
+    set id [after 2000 set ::STOP 1]
+    log::copy_to_stdout 0
+    -> $expt begin
+
+    vwait ::STOP
+
+    after cancel $id
+
+    # one S (block advanced) plus one R record for each trial after the
+    # first, which went into the base snapshot
+    set nrecords [-> $expt numJournalRecords]
+
+    -> $expt reset
+    log::copy_to_stdout 1
+
+    # the last autosave happens before the block advances past the
+    # final trial, so the recovered block has completed 2 of 3 trials
+    set recovered [ExptDriver::recoverAutosave __autosave_journal_test]
+    set rblock [-> $recovered currentElement]
+    set result "$::DONE $nrecords [-> $rblock numCompleted]"
+
+    file delete __autosave_journal_test __autosave_journal_test.journal
+    return $result
+} {^1 4 2$}
+test "ExptDriver::recoverAutosave" "bad journal" {
+    set expt [new ExptDriver]
+    -> $expt autosaveFile __autosave_journal_test
+    ::io::save_gvx $expt __autosave_journal_test
+    set f [open __autosave_journal_test.journal w]
+    puts $f "not a journal"
+    close $f
+    set code [catch {ExptDriver::recoverAutosave __autosave_journal_test} msg]
+    file delete __autosave_journal_test __autosave_journal_test.journal
+    return "$code $msg"
+} {^1 .*is not an autosave journal}
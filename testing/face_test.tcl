@@ -144,3 +144,57 @@ test "CloneFace" "check fields" {
     -> $cf eyeAspect 0.5
     -> $cf vertOffset 0.0
 } {^$}
+
+### getFieldBytes/setFieldBytes ###
+test "Face::setFieldBytes" "set and get packed doubles" {
+    set f1 [Obj::new Face]
+    set f2 [Obj::new Face]
+    Face::setFieldBytes "$f1 $f2" eyeHeight [binary format d* {0.25 -0.5}]
+    binary scan [Face::getFieldBytes "$f1 $f2" eyeHeight] d* vals
+    return "$vals [Face::eyeHeight $f2]"
+} {^0.25 -0.5 -0.5$}
+test "Face::setFieldBytes" "one value for many objects" {
+    set f1 [Obj::new Face]
+    set f2 [Obj::new Face]
+    Face::setFieldBytes "$f1 $f2" partsMask [binary format d 3.0]
+    Face::partsMask "$f1 $f2"
+} {^3 3$}
+test "Face::setFieldBytes" "error from wrong number of values" {
+    set f1 [Obj::new Face]
+    Face::setFieldBytes "$f1 $f1" eyeHeight [binary format d* {1 2 3}]
+} {expected 1 or 2 values, got 3}
+test "Face::getFieldBytes" "error from bad field name" {
+    set f1 [Obj::new Face]
+    Face::getFieldBytes $f1 junk
+} {no such field: 'junk'}
+
+### Face on a PSCanvas ###
+test "GxNode::savePS" "face curves are written as exact curves" {
+    set tmpname $::TEST_DIR/tmp-[pid]-Face-savePS.eps
+    set result {}
+    foreach filled {0 1} {
+        set f [new Face]
+        -> $f isFilled $filled
+        GxNode::savePS $f $tmpname
+        set fd [open $tmpname]
+        set ps [read $fd]
+        close $fd
+        lappend result [regexp -line { c$} $ps]
+        delete $f
+    }
+    file delete -force $tmpname
+    return $result
+} {^1 1$}
+
+test "GxNode::savePS" "face cached in RECORD mode is written as exact curves" {
+    set tmpname $::TEST_DIR/tmp-[pid]-Face-savePS-record.eps
+    set f [new Face]
+    GxShapeKit::renderMode $f $GxShapeKit::RECORD
+    GxNode::savePS $f $tmpname
+    set fd [open $tmpname]
+    set ps [read $fd]
+    close $fd
+    delete $f
+    file delete -force $tmpname
+    regexp -line { c$} $ps
+} {^1$}
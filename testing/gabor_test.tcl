@@ -7,7 +7,57 @@
 ##############################################################################
 
 package require Gabor
+package require Gaborarray
 
 source ${::TEST_DIR}/gxshapekit_test.tcl
 
 ::testGxshapekitSubclass Gabor
+
+### GaborArray::randEngine ###
+test "GaborArray::randEngine" "bound at creation, and saved" {
+    default_rand_engine philox
+    set g [Obj::new GaborArray]
+    default_rand_engine legacy
+    set g2 [Obj::new GaborArray]
+    set before [-> $g2 randEngine]
+    io::read_asw $g2 [io::write_asw $g]
+    list [-> $g randEngine] $before [-> $g2 randEngine]
+} {^1 0 1$}
+
+### GaborArray::precomputeForeg ###
+test "GaborArray::precomputeForeg" "contours match serial generation" {
+    set tmp1 $::TEST_DIR/tmp-[pid]-GaborArray-precomputeForeg-1.pbm
+    set tmp2 $::TEST_DIR/tmp-[pid]-GaborArray-precomputeForeg-2.pbm
+    set serial [Obj::new GaborArray]
+    -> $serial foregSeed 19
+    set batch [list]
+    foreach seed {3 11 19 27} {
+	set g [Obj::new GaborArray]
+	-> $g foregSeed $seed
+	lappend batch $g
+    }
+    set stats [GaborArray::precomputeForeg $batch 3]
+    set again [GaborArray::precomputeForeg $batch 3]
+    GaborArray::saveContourOnlyImage $serial $tmp1
+    GaborArray::saveContourOnlyImage [lindex $batch 2] $tmp2
+    set code [catch {exec cmp $tmp1 $tmp2} result]
+    file delete -force $tmp1 $tmp2
+    delete [concat $serial $batch]
+    return [list $code [dict get $stats built] [dict get $again built] \
+		[expr {[dict get $stats tries] >= [dict get $stats jiggles]}]]
+} {^0 4 0 1$}
+
+test "GaborArray::precomputeForeg" "thread count doesn't change the results" {
+    set results [list]
+    foreach nthreads {1 4} {
+	set batch [list]
+	foreach seed {5 6 7 8 9 10} {
+	    set g [Obj::new GaborArray]
+	    -> $g foregSeed $seed
+	    lappend batch $g
+	}
+	lappend results [GaborArray::precomputeForeg $batch $nthreads]
+	delete $batch
+    }
+    expr {[lindex $results 0] eq [lindex $results 1]}
+} {^1$}
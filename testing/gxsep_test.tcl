@@ -178,6 +178,52 @@ test "GxSeparator::bugfixes" "destroy after attach" {
 	 delete $fixpt
 } {}
 
+### GxNode::boundsCacheStats ###
+test "GxNode::boundsCacheStats" "cached bounds are reused and invalidated" {
+	 set canvas [-> [Toglet::current] canvas]
+	 set gxsep [Obj::new GxSeparator]
+	 set pos [Obj::new GxTransform]
+	 set face [Obj::new Face]
+	 -> $pos translation {1.0 2.0 0.0}
+	 -> $pos scaling {2.0 3.0 1.0}
+	 GxSeparator::addChild $gxsep $pos
+	 GxSeparator::addChild $gxsep $face
+	 GxNode::resetBoundsCacheStats
+	 set box1 [GxNode::boundingBox $gxsep $canvas]
+	 set misses1 [dict get [GxNode::boundsCacheStats] misses]
+	 set box2 [GxNode::boundingBox $gxsep $canvas]
+	 set hits [dict get [GxNode::boundsCacheStats] hits]
+	 set misses2 [dict get [GxNode::boundsCacheStats] misses]
+	 -> $pos translation {0.0 0.0 0.0}
+	 set box3 [GxNode::boundingBox $gxsep $canvas]
+	 set misses3 [dict get [GxNode::boundsCacheStats] misses]
+	 GxNode::boundsCaching 0
+	 set box4 [GxNode::boundingBox $gxsep $canvas]
+	 GxNode::boundsCaching 1
+	 delete [list $gxsep $pos $face]
+	 return [list [expr {$box1 eq $box2}] [expr {$hits > 0}] \
+		  [expr {$misses2 == $misses1}] [expr {$misses3 > $misses2}] \
+		  [expr {$box3 eq $box4}] [expr {$box1 ne $box3}]]
+} {^1 1 1 1 1 1$}
+
+test "GxNode::boundsCacheStats" "rotated bounds bypass the cache" {
+	 set canvas [-> [Toglet::current] canvas]
+	 set gxsep [Obj::new GxSeparator]
+	 set pos [Obj::new GxTransform]
+	 set face [Obj::new Face]
+	 -> $pos rotationAngle 30
+	 GxSeparator::addChild $gxsep $pos
+	 GxSeparator::addChild $gxsep $face
+	 GxNode::resetBoundsCacheStats
+	 set box1 [GxNode::boundingBox $gxsep $canvas]
+	 GxNode::boundsCaching 0
+	 set box2 [GxNode::boundingBox $gxsep $canvas]
+	 GxNode::boundsCaching 1
+	 set uncached [dict get [GxNode::boundsCacheStats] uncached]
+	 delete [list $gxsep $pos $face]
+	 return "[expr {$box1 eq $box2}] [expr {$uncached > 0}]"
+} {^1 1$}
+
 source ${::TEST_DIR}/io_test.tcl
 
 set ::GXSEP [Obj::new GxSeparator]
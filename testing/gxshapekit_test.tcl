@@ -64,4 +64,24 @@ proc testGxshapekitSubclass { subclass {objid -1} } {
 	-> [Toglet::current] setVisible false
 	return "[expr $pix1 == $pix2] $pix1 $pix2"
     } $objid] {^0 }
+
+    ::test ${subclass}::draw "recorded replay matches direct draw" [format {
+	glClearColor 0 0 0 0
+	glColor 1 1 1 1
+	set mode [GxShapeKit::renderMode %s]
+	GxShapeKit::renderMode %s $GxShapeKit::DIRECT
+	clearscreen
+	see %s
+	set pix1 [-> [::cv] pixelCheckSum]
+	GxShapeKit::renderMode %s $GxShapeKit::RECORD
+	clearscreen
+	see %s
+	set pix2 [-> [::cv] pixelCheckSum]
+	clearscreen
+	see %s
+	set pix3 [-> [::cv] pixelCheckSum]
+	GxShapeKit::renderMode %s $mode
+	-> [Toglet::current] setVisible false
+	return "[expr $pix1 == $pix2] [expr $pix2 == $pix3]"
+    } $objid $objid $objid $objid $objid $objid $objid] {^1 1$}
 }
@@ -50,5 +50,41 @@ test "$PACKAGE-rendering" "normal render" {
     expr {[-> [::cv] pixelCheckSum] != 0}
 } {^1$}
 
+test "$PACKAGE-rendering" "recorded text keeps its font alive" {
+    clearscreen
+    set p [new GxText]
+    -> $p text "Hi there."
+    -> $p font vector
+    GxShapeKit::renderMode $p $GxShapeKit::RECORD
+    see $p
+    set pix1 [-> [::cv] pixelCheckSum]
+    clearscreen
+    see $p
+    set pix2 [-> [::cv] pixelCheckSum]
+    delete $p
+    expr {$pix1 == $pix2 && $pix1 != 0}
+} {^1$}
+
+### GxText on a PSCanvas ###
+test "GxNode::savePS" "vector text is written as strokes" {
+    set tmpname $::TEST_DIR/tmp-[pid]-GxText-savePS.eps
+    set p [new GxText]
+    -> $p font vector
+    set result {}
+    foreach text {A AAAA} {
+        -> $p text $text
+        lappend result [lindex [lsearch -inline -index 0 \
+                                    [GxNode::savePS $p $tmpname] GxText] 1]
+    }
+    # recorded text gives the same output as direct drawing
+    GxShapeKit::renderMode $p $GxShapeKit::RECORD
+    lappend result [lindex [lsearch -inline -index 0 \
+                                [GxNode::savePS $p $tmpname] GxText] 1]
+    file delete -force $tmpname
+    delete $p
+    lassign $result n1 n4 nrec
+    return "[expr {$n1 > 0}] [expr {$n4 > 3*$n1}] [expr {$nrec == $n4}]"
+} {^1 1 1$}
+
 ### cleanup
 unset PACKAGE
@@ -11,3 +11,55 @@ package require Maskhatch
 source ${::TEST_DIR}/gxshapekit_test.tcl
 
 ::testGxshapekitSubclass MaskHatch
+
+### GxNode::savePS ###
+test "GxNode::savePS" "bytes per node type" {
+    set tmpname $::TEST_DIR/tmp-[pid]-GxNode-savePS.eps
+    set obj [new MaskHatch]
+    -> $obj numLines 10
+    file delete -force $tmpname
+    set counts [GxNode::savePS $obj $tmpname]
+    set total 0
+    foreach pair $counts { incr total [lindex $pair 1] }
+    set ok [expr {$total <= [file size $tmpname]}]
+    file delete -force $tmpname
+    delete $obj
+    return "$ok [lsort [lsearch -all -inline -index 0 $counts MaskHatch]]"
+} {^1 \{MaskHatch [0-9]+\}$}
+
+test "GxNode::savePS" "bytes per node type through a RECORD cache" {
+    set tmpname $::TEST_DIR/tmp-[pid]-GxNode-savePS.eps
+    set obj [new MaskHatch]
+    -> $obj numLines 10
+    GxShapeKit::renderMode $obj $GxShapeKit::RECORD
+    set counts [GxNode::savePS $obj $tmpname]
+    file delete -force $tmpname
+    delete $obj
+    lsearch -all -inline -index 0 $counts MaskHatch
+} {^\{MaskHatch [0-9]+\}$}
+
+test "GxNode::savePS" "hatch lines are rebuilt after a change" {
+    set tmpname $::TEST_DIR/tmp-[pid]-GxNode-savePS.eps
+    set obj [new MaskHatch]
+    -> $obj numLines 10
+    set n1 [lindex [lsearch -inline -index 0 [GxNode::savePS $obj $tmpname] MaskHatch] 1]
+    set n2 [lindex [lsearch -inline -index 0 [GxNode::savePS $obj $tmpname] MaskHatch] 1]
+    -> $obj numLines 3
+    set n3 [lindex [lsearch -inline -index 0 [GxNode::savePS $obj $tmpname] MaskHatch] 1]
+    file delete -force $tmpname
+    delete $obj
+    return "[expr {$n1 == $n2}] [expr {$n3 < $n2}]"
+} {^1 1$}
+
+test "GxNode::savePS" "spheres and cylinders" {
+    set tmpname $::TEST_DIR/tmp-[pid]-GxNode-savePS.eps
+    set sphere [new GxSphere]
+    set cylinder [new GxCylinder]
+    -> $cylinder filled 0
+    set ok1 [expr {[catch {GxNode::savePS $sphere $tmpname}] == 0}]
+    set ok2 [expr {[catch {GxNode::savePS $cylinder $tmpname}] == 0}]
+    set ok3 [expr {[file size $tmpname] > 0}]
+    file delete -force $tmpname
+    delete [list $sphere $cylinder]
+    return "$ok1 $ok2 $ok3"
+} {^1 1 1$}
@@ -46,6 +46,39 @@ test "::srand" "error from non-integral number" {
     srand 1.5
 } {expected.*but got}
 
+### default_rand_engine ###
+test "::default_rand_engine" "default is legacy" {
+    default_rand_engine
+} {^legacy$}
+test "::default_rand_engine" "legacy reproduces old sequences" {
+    default_rand_engine philox
+    default_rand_engine legacy
+    srand 10
+    expr int([rand 0 1] * 10000000000) == 1386490440
+} {^1$}
+test "::default_rand_engine" "philox is repeatable" {
+    default_rand_engine philox
+    srand 10
+    set a [rand 0 1 5]
+    srand 10
+    set b [rand 0 1 5]
+    default_rand_engine legacy
+    expr {$a eq $b && [lindex $a 0] != [lindex $a 1]}
+} {^1$}
+test "::default_rand_engine" "rand follows a switch without srand" {
+    srand 10
+    rand 0 1
+    default_rand_engine philox
+    set a [rand 0 1]
+    srand 10
+    set b [rand 0 1]
+    default_rand_engine legacy
+    expr {$a == $b}
+} {^1$}
+test "::default_rand_engine" "error from bad engine" {
+    default_rand_engine junk
+} {unknown random engine}
+
 ### sleepCmd ###
 test "::sleep" "too few args" {
     sleep
@@ -11,3 +11,45 @@ package require Morphyface
 source ${::TEST_DIR}/gxshapekit_test.tcl
 
 ::testGxshapekitSubclass MorphyFace
+
+### Canvas::curveCacheStats ###
+test "Canvas::curveCacheStats" "unchanged curves are replayed from the cache" {
+    set mf [Obj::new MorphyFace]
+    GxShapeKit::renderMode $mf $GxShapeKit::DIRECT
+    Canvas::resetCurveCacheStats
+    clearscreen
+    see $mf
+    set misses1 [dict get [Canvas::curveCacheStats] misses]
+    see $mf
+    set hits2 [dict get [Canvas::curveCacheStats] hits]
+    set misses2 [dict get [Canvas::curveCacheStats] misses]
+    -> $mf mouthCurvature -0.4
+    see $mf
+    set misses3 [dict get [Canvas::curveCacheStats] misses]
+    -> [Toglet::current] setVisible false
+    return [list [expr {$misses1 > 0}] [expr {$hits2 > 0}] \
+		 [expr {$misses2 == $misses1}] [expr {$misses3 > $misses2}]]
+} {^1 1 1 1$}
+
+test "Canvas::curveTolerance" "finer tolerance generates more vertices" {
+    set mf [Obj::new MorphyFace]
+    GxShapeKit::renderMode $mf $GxShapeKit::DIRECT
+    set tol [Canvas::curveTolerance]
+    Canvas::curveCaching 0
+    Canvas::curveTolerance 2.0
+    Canvas::resetCurveCacheStats
+    see $mf
+    set coarse [dict get [Canvas::curveCacheStats] vertices]
+    Canvas::curveTolerance 0.05
+    Canvas::resetCurveCacheStats
+    see $mf
+    set fine [dict get [Canvas::curveCacheStats] vertices]
+    Canvas::curveTolerance $tol
+    Canvas::curveCaching 1
+    -> [Toglet::current] setVisible false
+    expr {$fine > $coarse}
+} {^1$}
+
+test "Canvas::curveTolerance" "error from non-positive tolerance" {
+    Canvas::curveTolerance 0
+} {tolerance must be positive}
@@ -0,0 +1,35 @@
+##############################################################################
+###
+### mtx
+### Rob Peters
+### 19-Oct-2026
+###
+##############################################################################
+
+package require Mtx
+
+### mtx::scan ###
+test "mtx::scan" "scan and print" {
+    set m [Obj::new mtx]
+    mtx::scan $m "mrows 2 ncols 2 1 2 3 4"
+    set result [mtx::print $m 3]
+    Obj::delete $m
+    return [string map {"\n" " "} $result]
+} {^mrows 2 ncols 2 +1\.0+ +2\.0+ +3\.0+ +4\.0+ *$}
+
+### mtx::mrows ###
+test "mtx::mrows" "getters over several objects" {
+    set m1 [Obj::new mtx]
+    set m2 [Obj::new mtx]
+    mtx::scan $m1 "mrows 2 ncols 3 1 2 3 4 5 6"
+    mtx::scan $m2 "mrows 1 ncols 4 1 2 3 4"
+    set result [list [mtx::mrows [list $m1 $m2]] \
+                    [mtx::ncols [list $m1 $m2]] \
+                    [mtx::nelems [list $m1 $m2]]]
+    Obj::delete [list $m1 $m2]
+    return $result
+} {^\{2 1\} \{3 4\} \{6 4\}$}
+
+test "mtx::mrows" "error from a bad objref" {
+    mtx::mrows -1
+} {mtx::mrows: .*expected unsigned long value}
@@ -8,6 +8,8 @@
 
 package require Toglet
 package require Face
+package require Gxseparator
+package require Gxtransform
 package require Tlist
 
 ### Toglet::undrawCmd ###
@@ -57,6 +59,78 @@ test "Toglet::setVisible" "error on non-numeric input" {
     Toglet::setVisible [Toglet::current] junk
 } {expected.*but got}
 
+### Toglet::damageTracking ###
+test "Toglet::damageTracking" "get and set" {
+    set t [Toglet::current]
+    -> $t damageTracking 1
+    set on [-> $t damageTracking]
+    -> $t damageTracking 0
+    return "$on [-> $t damageTracking]"
+} {^1 0$}
+
+test "Toglet::damageStats" "a change in one child is a partial redraw" {
+    set t [Toglet::current]
+    set sep [new GxSeparator]
+    set pos [new GxTransform]
+    set face [new Face]
+    -> $pos scaling {0.4 0.4 1.0}
+    GxSeparator::addChild $sep $pos
+    GxSeparator::addChild $sep $face
+    GxSeparator::addChild $sep [new Face]
+    -> $t damageTracking 1
+    see $sep
+    Toglet::resetDamageStats $t
+    -> $face eyeHeight 0.3
+    set stats [Toglet::damageStats $t]
+    -> $t damageTracking 0
+    set viewport [-> [-> $t canvas] viewport]
+    lassign $viewport vl vt vr vb
+    set npix [expr {($vr - $vl) * ($vt - $vb)}]
+    clearscreen
+    return [list [dict get $stats frames] [dict get $stats partialFrames] \
+                [expr {[dict get $stats lastPixels] < $npix}]]
+} {^1 1 1$}
+
+### Toglet::frameLog ###
+test "Toglet::frameLogSize" "off by default" {
+    Toglet::frameLogSize [Toglet::current]
+} {^0$}
+
+test "Toglet::frameLog" "the ring buffer keeps the most recent frames" {
+    set t [Toglet::current]
+    -> $t frameLogSize 3
+    see [new Face]
+    for {set i 0} {$i < 4} {incr i} {
+        -> $t swapBuffers
+    }
+    set frames [Toglet::frameLog $t]
+    set stats [Toglet::frameLogStats $t]
+    -> $t frameLogSize 0
+    clearscreen
+    set ordered 1
+    foreach f $frames {
+        lassign $f start rendered swapped presented
+        if {!($start <= $rendered && $rendered <= $swapped
+              && $swapped <= $presented)} { set ordered 0 }
+    }
+    return [list [llength $frames] [expr {[dict get $stats frames] >= 5}] \
+                [dict get $stats held] $ordered]
+} {^3 1 3 1$}
+
+test "Toglet::frameLogMtx" "export in mtx text format" {
+    set t [Toglet::current]
+    -> $t frameLogSize 8
+    -> $t frameLogWaitPresent 1
+    see [new Face]
+    set str [Toglet::frameLogMtx $t]
+    -> $t frameLogWaitPresent 0
+    Toglet::clearFrameLog $t
+    set nheld [dict get [Toglet::frameLogStats $t] held]
+    -> $t frameLogSize 0
+    clearscreen
+    return "[lrange $str 0 3] [llength $str] $nheld"
+} {^mrows 1 ncols 4 8 0$}
+
 ### pixelsPerUnitCmd ###
 test "GxCamera-pixelsPerUnit" "args" {
     GxFixedScaleCamera::pixelsPerUnit
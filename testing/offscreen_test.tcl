@@ -0,0 +1,56 @@
+##############################################################################
+###
+### Offscreen
+### Rob Peters
+### 19-Oct-2026
+###
+##############################################################################
+
+package require Offscreen
+package require Gxshapekit
+package require Face
+
+### Offscreen::renderBatch ###
+test "Offscreen::renderBatch" "mismatched filenames" {
+    set face [Obj::new Face]
+    set code [catch {Offscreen::renderBatch [list $face $face] {a.png} 32 32 1} result]
+    return "$code $result"
+} {^1.*got 2 nodes but 1 filenames}
+
+test "Offscreen::renderBatch" "workers match in-process render" {
+    set objs [list]
+    foreach c {0.1 0.3 0.5 0.7 0.9} {
+	set face [Obj::new Face]
+	Face::eyeHeight $face $c
+	lappend objs $face
+    }
+    set serial [Offscreen::renderBatch $objs {} 64 64 1]
+    set parallel [Offscreen::renderBatch $objs {} 64 64 3]
+    return "[llength $serial] [expr {$serial eq $parallel}]"
+} {^5 1$}
+
+### Offscreen::softRender ###
+test "Offscreen::softRender" "threads don't change the image" {
+    set face [Obj::new Face]
+    set h1 [Offscreen::softRender $face {} 64 64 1]
+    set h4 [Offscreen::softRender $face {} 64 64 4]
+    return [expr {$h1 == $h4}]
+} {^1$}
+
+test "Offscreen::softRender" "fills inside a shape and nothing outside" {
+    set tmpname $::TEST_DIR/tmp-[pid]-Offscreen-softRender.pnm
+    set sphere [Obj::new GxSphere]
+    GxSphere::radius $sphere 0.2
+    Offscreen::softRender $sphere $tmpname 64 64 2
+    Obj::delete $sphere
+    set fd [open $tmpname]
+    fconfigure $fd -translation binary
+    set header [gets $fd]
+    set pixels [read $fd]
+    close $fd
+    file delete -force $tmpname
+    # one RGB triple each from the center and from a corner
+    binary scan [string range $pixels [expr {3*(32*64+32)}] end] cu3 inside
+    binary scan $pixels cu3 outside
+    return "$header / [expr {[lindex $inside 0] > 0}] / $outside"
+} {^P6 64 64 255 / 1 / 0 0 0$}
@@ -0,0 +1,103 @@
+##############################################################################
+###
+### Prof
+### Rob Peters
+### Oct-2026
+###
+##############################################################################
+
+### Prof::callGraph ###
+test "Prof::callGraph" "toggle" {
+    set old [Prof::callGraph]
+    Prof::callGraph 1
+    set r [Prof::callGraph]
+    Prof::callGraph $old
+    set r
+} {^1$}
+
+### Prof::snapshot ###
+test "Prof::snapshot" "named snapshots" {
+    Prof::snapshot prof_test_a
+    Prof::snapshot prof_test_b
+    set r [lsearch -all -inline [Prof::snapshots] prof_test_*]
+    Prof::forget prof_test_a
+    Prof::forget prof_test_b
+    set r
+} {^prof_test_a prof_test_b$}
+test "Prof::forget" "error on unknown snapshot" {
+    Prof::forget no_such_snapshot
+} {no profile snapshot named}
+
+### Prof::diff ###
+test "Prof::diff" "counts calls in between" {
+    Prof::snapshot prof_test_a
+    for {set i 0} {$i < 10} {incr i} { dlist::range 1 5 }
+    Prof::snapshot prof_test_b
+    set r [lsearch -inline -index 0 [Prof::diff prof_test_a prof_test_b] tcl/dlist::range]
+    Prof::forget prof_test_a
+    Prof::forget prof_test_b
+    lindex $r 1
+} {^10$}
+test "Prof::diff" "counts fast path calls" {
+    Prof::snapshot prof_test_a
+    for {set i 0} {$i < 10} {incr i} { dlist::sum {1 2 3} }
+    Prof::snapshot prof_test_b
+    set r [lsearch -inline -index 0 [Prof::diff prof_test_a prof_test_b] tcl/dlist::sum]
+    Prof::forget prof_test_a
+    Prof::forget prof_test_b
+    lindex $r 1
+} {^10$}
+test "Prof::data" "since snapshot" {
+    Prof::snapshot prof_test_a
+    dlist::range 1 5
+    set r [lsearch -inline -index 0 [Prof::data prof_test_a] tcl/dlist::range]
+    Prof::forget prof_test_a
+    lindex $r 1
+} {^1$}
+
+### Prof::edges ###
+test "Prof::edges" "caller/callee edges" {
+    set old [Prof::callGraph]
+    Prof::callGraph 1
+    Prof::snapshot prof_test_a
+    dlist::range 1 5
+    set e [Prof::edges prof_test_a]
+    Prof::callGraph $old
+    Prof::forget prof_test_a
+    expr {[lsearch -index 1 $e tcl/dlist::range] >= 0}
+} {^1$}
+
+### Prof::flamegraph ###
+test "Prof::flamegraph" "collapsed stacks" {
+    set old [Prof::callGraph]
+    Prof::callGraph 1
+    Prof::snapshot prof_test_a
+    for {set i 0} {$i < 10} {incr i} { dlist::range 1 1000 }
+    set fname [file join $::TEST_DIR prof_test.folded]
+    Prof::flamegraph $fname prof_test_a
+    Prof::callGraph $old
+    Prof::forget prof_test_a
+    set fd [open $fname]
+    set lines [split [string trim [read $fd]] \n]
+    close $fd
+    file delete $fname
+    expr {[llength $lines] > 0 &&
+          [regexp {^[^;]+(;[^;]+)* [0-9]+$} [lindex $lines 0]]}
+} {^1$}
+
+### Prof::chromeTrace ###
+test "Prof::chromeTrace" "trace-event json" {
+    set old [Prof::callGraph]
+    Prof::callGraph 1
+    Prof::snapshot prof_test_a
+    dlist::range 1 1000
+    set fname [file join $::TEST_DIR prof_test.json]
+    Prof::chromeTrace $fname prof_test_a
+    Prof::callGraph $old
+    Prof::forget prof_test_a
+    set fd [open $fname]
+    set text [read $fd]
+    close $fd
+    file delete $fname
+    regexp {^\{"traceEvents":\[.*"ph":"X".*\]} $text
+} {^1$}
@@ -115,3 +115,58 @@ test "TrialTcl-Trial::type" "normal use" {
     Trial::type $::TRIAL 0
     Trial::type $::TRIAL
 } {^0$}
+test "TrialTcl-Trial::type" "batched set and get" {
+    set trials [list]
+    for {set i 0} {$i < 1000} {incr i} { lappend trials [Obj::new Trial] }
+    Trial::type $trials 3
+    Trial::type [lrange $trials 0 2] {5 6}
+    set result [lrange [Trial::type $trials] 0 4]
+    lappend result [llength [lsearch -all [Trial::type $trials] 3]]
+    Obj::delete $trials
+    return $result
+} {^5 6 6 3 3 997$}
+test "TrialTcl-Trial::type" "batched set with a bad objref" {
+    set trials [list [Obj::new Trial] [Obj::new Trial]]
+    Trial::type $trials 1
+    set result [catch {Trial::type [linsert $trials 1 -1] 2} msg]
+    lappend result [Trial::type $trials]
+    Obj::delete $trials
+    return $result
+} {^1 \{1 1\}$}
+
+### Trial::preload ###
+test "TrialTcl-Trial::preload" "off by default, and survives a write/read" {
+    set tr [new Trial]
+    set before [-> $tr preload]
+    -> $tr preload 1
+    set str [io::write_asw $tr]
+    set tr2 [new Trial]
+    io::read_asw $tr2 $str
+    return "$before [-> $tr2 preload]"
+} {^0 1$}
+
+test "TrialTcl-Trial::preloadFrames" "no-op unless preloading" {
+    set tr [new Trial]
+    -> $tr addNode [new Face]
+    set code [catch {Trial::preloadFrames $tr} msg]
+    return "$code [dict get [Trial::frameStats $tr] preloaded]"
+} {^0 0$}
+
+### Trial::frameStats ###
+test "TrialTcl-Trial::frameStats" "a trial that hasn't run" {
+    Trial::frameStats [new Trial]
+} {^frames 0 preloaded 0 overruns 0$}
+
+### Trial::framePeriod ###
+test "TrialTcl-Trial::framePeriod" "set and get" {
+    set old [Trial::framePeriod]
+    Trial::framePeriod 10.0
+    set new [Trial::framePeriod]
+    Trial::framePeriod $old
+    return "[expr {abs($old - 1000.0/60) < 1e-9}] $new"
+} {^1 10.0$}
+
+test "TrialTcl-Trial::framePeriod" "error on non-positive period" {
+    catch {Trial::framePeriod 0} msg
+    return $msg
+} {frame period must be positive}
@@ -9,12 +9,19 @@
 set pkgs {
     Algotest
     Basesixfourtest
+    Fieldstest
     Fstringtest
     Geomtest
     Mtxtest
     Numtest
+    Numvectest
+    Randtest
+    Seqtest
     Signaltest
+    Tclcmdtest
     Tcltimertest
+    Texttest
+    Tracetest
     Vectwotest
 }
 